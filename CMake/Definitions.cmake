@@ -10,6 +10,8 @@ foreach(
   DISABLE_STREAMING_MUSIC
   DISABLE_STREAMING_SOUNDS
   DISABLE_DEMOMODE
+  DEVILUTIONX_FRAME_PROFILER
+  DEVILUTIONX_ALLOCATION_TRACKER
   BUILD_TESTING
   GPERF
   GPERF_HEAP_MAIN
@@ -18,6 +20,7 @@ foreach(
   DEVILUTIONX_RESAMPLER_SPEEX
   DEVILUTIONX_RESAMPLER_SDL
   DEVILUTIONX_PALETTE_TRANSPARENCY_BLACK_16_LUT
+  DEVILUTIONX_GENERIC_CLX_BLIT
   SCREEN_READER_INTEGRATION
   UNPACKED_MPQS
   UNPACKED_SAVES
@@ -38,6 +41,15 @@ foreach(
   DEFAULT_AUDIO_BUFFER_SIZE
   DEFAULT_AUDIO_RESAMPLING_QUALITY
   DEFAULT_PER_PIXEL_LIGHTING
+  DEVILUTIONX_FONT_BUDGET
+  DEVILUTIONX_CLX_CACHE_BUDGET
+  DEVILUTIONX_CLX_TRN_CACHE_BUDGET
+  DEVILUTIONX_CLX_RUN_CACHE_BUDGET
+  DEVILUTIONX_CLX_OUTLINE_CACHE_BUDGET
+  DEVILUTIONX_STREAM_READ_AHEAD_SIZE
+  DEVILUTIONX_MPQ_SECTOR_CACHE_SIZE
+  DEVILUTIONX_PLAYER_GFX_BUDGET
+  DEVILUTIONX_MONSTER_GFX_BUDGET
   SDL1_VIDEO_MODE_BPP
   SDL1_VIDEO_MODE_FLAGS
   SDL1_VIDEO_MODE_SVID_FLAGS
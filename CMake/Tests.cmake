@@ -25,6 +25,8 @@ set(tests
   effects_test
   inv_test
   items_test
+  lighting_test
+  loadsave_test
   math_test
   missiles_test
   multi_logging_test
@@ -39,6 +41,7 @@ set(tests
   writehero_test
   vendor_test
   panel_state_test
+  player_flow_field_test
   store_transaction_test
   visual_store_test
   stash_test
@@ -46,35 +49,60 @@ set(tests
   spell_ui_test
   char_panel_test
   game_menu_test
+  state_hash_test
 )
 set(standalone_tests
+  bitset2d_test
+  bump_arena_test
   codec_test
   crawl_test
   data_file_test
+  demo_stream_test
+  file_journal_test
   file_util_test
   format_int_test
   ini_test
   palette_blending_test
   parse_int_test
+  pooled_list_test
   path_test
   vision_test
   random_test
   rectangle_test
   static_vector_test
   str_cat_test
+  task_graph_test
   utf8_test
 )
 if(NOT USE_SDL1)
   list(APPEND standalone_tests text_render_integration_test)
 endif()
+if(NOT NONET)
+  list(APPEND standalone_tests frame_queue_test packet_test)
+endif()
+if(DEVILUTIONX_ALLOCATION_TRACKER)
+  list(APPEND standalone_tests allocation_tracker_test)
+endif()
+if(SUPPORTS_MPQ)
+  list(APPEND tests mpq_read_ahead_test)
+  list(APPEND standalone_tests mpq_sector_cache_test)
+endif()
 set(benchmarks
+  bilinear_scale_benchmark
   clx_render_benchmark
   crawl_benchmark
+  drlg_benchmark
   dun_render_benchmark
   light_render_benchmark
   palette_blending_benchmark
   path_benchmark
+  primitive_render_benchmark
+  save_benchmark
+  simulation_benchmark
 )
+if(SUPPORTS_MPQ OR NOT NONET)
+  list(APPEND benchmarks pkware_benchmark)
+endif()
 
 include(test/Fixtures.cmake)
 
@@ -110,6 +138,7 @@ target_sources(app_fatal_for_testing INTERFACE $<TARGET_OBJECTS:app_fatal_for_te
 add_library(language_for_testing OBJECT test/language_for_testing.cpp)
 target_sources(language_for_testing INTERFACE $<TARGET_OBJECTS:language_for_testing>)
 
+target_link_dependencies(bilinear_scale_benchmark PRIVATE libdevilutionx_sdl_bilinear_scale app_fatal_for_testing)
 target_link_dependencies(codec_test PRIVATE libdevilutionx_codec app_fatal_for_testing)
 target_link_dependencies(clx_render_benchmark
   PRIVATE
@@ -123,9 +152,12 @@ target_link_dependencies(clx_render_benchmark
   libdevilutionx_surface
 )
 target_link_dependencies(crawl_test PRIVATE libdevilutionx_crawl)
-target_link_dependencies(crawl_benchmark PRIVATE libdevilutionx_crawl)
+target_link_dependencies(crawl_benchmark PRIVATE libdevilutionx_crawl libdevilutionx_vision)
 target_link_dependencies(data_file_test PRIVATE libdevilutionx_txtdata app_fatal_for_testing language_for_testing)
+target_link_dependencies(drlg_benchmark PRIVATE libdevilutionx_so)
+target_link_dependencies(demo_stream_test PRIVATE libdevilutionx_demo_stream app_fatal_for_testing)
 target_link_dependencies(dun_render_benchmark PRIVATE libdevilutionx_so)
+target_link_dependencies(file_journal_test PRIVATE libdevilutionx_file_journal app_fatal_for_testing)
 target_link_dependencies(file_util_test PRIVATE libdevilutionx_file_util app_fatal_for_testing)
 target_link_dependencies(format_int_test PRIVATE libdevilutionx_format_int language_for_testing)
 target_link_dependencies(ini_test PRIVATE libdevilutionx_ini app_fatal_for_testing)
@@ -139,12 +171,35 @@ target_link_dependencies(palette_blending_benchmark
   app_fatal_for_testing
 )
 target_link_dependencies(parse_int_test PRIVATE libdevilutionx_parse_int)
+target_link_dependencies(primitive_render_benchmark
+  PRIVATE
+  DevilutionX::SDL
+  libdevilutionx_primitive_render
+  libdevilutionx_surface
+  app_fatal_for_testing
+)
 target_link_dependencies(path_test PRIVATE libdevilutionx_pathfinding libdevilutionx_direction app_fatal_for_testing)
 target_link_dependencies(vision_test PRIVATE libdevilutionx_vision)
 target_link_dependencies(path_benchmark PRIVATE libdevilutionx_pathfinding app_fatal_for_testing)
+target_link_dependencies(save_benchmark PRIVATE libdevilutionx_so)
+target_link_dependencies(simulation_benchmark PRIVATE libdevilutionx_so)
+if(SUPPORTS_MPQ OR NOT NONET)
+  target_link_dependencies(pkware_benchmark PRIVATE libdevilutionx_pkware_encrypt)
+endif()
+if(NOT NONET)
+  target_link_dependencies(frame_queue_test PRIVATE libdevilutionx_dvlnet_packet)
+  target_link_dependencies(packet_test PRIVATE libdevilutionx_dvlnet_packet)
+endif()
+if(DEVILUTIONX_ALLOCATION_TRACKER)
+  target_link_dependencies(allocation_tracker_test PRIVATE libdevilutionx_allocation_tracker)
+endif()
+if(SUPPORTS_MPQ)
+  target_link_dependencies(mpq_sector_cache_test PRIVATE libdevilutionx_mpq_sector_cache app_fatal_for_testing)
+endif()
 target_link_dependencies(random_test PRIVATE libdevilutionx_random)
 target_link_dependencies(static_vector_test PRIVATE libdevilutionx_random app_fatal_for_testing)
 target_link_dependencies(str_cat_test PRIVATE libdevilutionx_strings)
+target_link_dependencies(task_graph_test PRIVATE libdevilutionx_task_graph app_fatal_for_testing)
 if(DEVILUTIONX_SCREENSHOT_FORMAT STREQUAL DEVILUTIONX_SCREENSHOT_FORMAT_PNG AND NOT USE_SDL1)
   target_link_dependencies(text_render_integration_test
     PRIVATE
@@ -9,6 +9,20 @@ set(DEVILUTIONX_STATIC_LIBSODIUM ON)
 set(DEVILUTIONX_STATIC_LIBFMT ON)
 set(DISABLE_ZERO_TIER ON)
 set(MPQFS_FILE_BUFFER_SIZE 32768)
+# Font rows of CJK languages are unloaded when they take up more memory than this
+set(DEVILUTIONX_FONT_BUDGET 8388608)
+# Converting sprites on load is cheaper than reading them back from the SD card
+set(DEVILUTIONX_CLX_CACHE_BUDGET 0)
+# Copies of sprites with a TRN applied, kept for the ones drawn that way most often
+set(DEVILUTIONX_CLX_TRN_CACHE_BUDGET 262144)
+# Decoded runs of the most recently drawn sprites
+set(DEVILUTIONX_CLX_RUN_CACHE_BUDGET 262144)
+# Player animations that are not shown are unloaded when they take up more memory than this
+set(DEVILUTIONX_PLAYER_GFX_BUDGET 8388608)
+# Graphics of monsters from earlier levels are unloaded when they take up more memory than this
+set(DEVILUTIONX_MONSTER_GFX_BUDGET 8388608)
+# Share one sprite run renderer between all blit types to keep the code small
+set(DEVILUTIONX_GENERIC_CLX_BLIT ON)
 set(NOEXIT ON)
 
 # 3DS libraries and compile definitions
@@ -8,6 +8,12 @@ set(DISABLE_ZERO_TIER ON)
 set(PREFILL_PLAYER_NAME ON)
 set(DEVILUTIONX_GAMEPAD_TYPE PlayStation)
 set(NOEXIT ON)
+# Font rows of CJK languages are unloaded when they take up more memory than this
+set(DEVILUTIONX_FONT_BUDGET 16777216)
+# Player animations that are not shown are unloaded when they take up more memory than this
+set(DEVILUTIONX_PLAYER_GFX_BUDGET 16777216)
+# Graphics of monsters from earlier levels are unloaded when they take up more memory than this
+set(DEVILUTIONX_MONSTER_GFX_BUDGET 16777216)
 
 list(APPEND DEVILUTIONX_PLATFORM_SUBDIRECTORIES platform/vita)
 list(APPEND DEVILUTIONX_PLATFORM_LINK_LIBRARIES libdevilutionx_vita)
@@ -40,6 +40,8 @@ namespace {
 
 const SDL_Rect VIEWPORT = { 0, 114, 640, 251 };
 const int LINE_H = 22;
+/** @brief The text scrolls up by a pixel every this many milliseconds. */
+const Uint32 SCROLL_MS = 40;
 
 // The maximum number of visible lines is the number of whole lines
 // (VIEWPORT.h / LINE_H) rounded up, plus one extra line for when
@@ -84,7 +86,14 @@ public:
 		ArtBackground = std::nullopt;
 	}
 
-	void Render();
+	/** @return Whether the text moved and the screen was redrawn. */
+	bool Render();
+
+	/** @brief Milliseconds until the text moves again. */
+	[[nodiscard]] Uint32 TimeUntilNextStep() const
+	{
+		return SCROLL_MS - (SDL_GetTicks() - ticks_begin_) % SCROLL_MS;
+	}
 
 	[[nodiscard]] bool Finished() const
 	{
@@ -103,11 +112,11 @@ private:
 	int prev_offset_y_;
 };
 
-void CreditsRenderer::Render()
+bool CreditsRenderer::Render()
 {
-	const int offsetY = -VIEWPORT.h + ((SDL_GetTicks() - ticks_begin_) / 40);
+	const int offsetY = -VIEWPORT.h + ((SDL_GetTicks() - ticks_begin_) / SCROLL_MS);
 	if (offsetY == prev_offset_y_)
-		return;
+		return false;
 	prev_offset_y_ = offsetY;
 
 	SDL_FillSurfaceRect(DiabloUiSurface(), nullptr, 0);
@@ -122,7 +131,7 @@ void CreditsRenderer::Render()
 	if (linesBegin >= linesEnd) {
 		if (linesEnd == linesToRender.size())
 			finished_ = true;
-		return;
+		return true;
 	}
 
 	SDL_Rect viewport = VIEWPORT;
@@ -146,6 +155,7 @@ void CreditsRenderer::Render()
 		DrawString(out, lineContent.text, Point { dstRect.x, dstRect.y },
 		    { .flags = UiFlags::FontSizeDialog | UiFlags::ColorDialogWhite, .spacing = -1 });
 	}
+	return true;
 }
 
 bool TextDialog(const char *const *text, std::size_t textLines)
@@ -158,8 +168,11 @@ bool TextDialog(const char *const *text, std::size_t textLines)
 
 	SDL_Event event;
 	do {
-		creditsRenderer.Render();
-		UiFadeIn();
+		// Between scroll steps the screen is unchanged, so there is nothing to present until the next one
+		if (creditsRenderer.Render() || !UiIsFadedIn())
+			UiFadeIn();
+		else
+			SDL_Delay(creditsRenderer.TimeUntilNextStep());
 		while (PollEvent(&event)) {
 			switch (event.type) {
 			case SDL_EVENT_KEY_DOWN:
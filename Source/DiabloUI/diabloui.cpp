@@ -8,6 +8,7 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #ifdef USE_SDL3
@@ -37,6 +38,7 @@
 #include "discord/discord.h"
 #include "effects.h"
 #include "engine/clx_sprite.hpp"
+#include "engine/asset_prefetch.hpp"
 #include "engine/dx.h"
 #include "engine/load_pcx.hpp"
 #include "engine/palette.h"
@@ -63,6 +65,10 @@
 #include "utils/ui_fwd.h"
 #include "utils/utf8.hpp"
 
+#ifndef UNPACKED_MPQS
+#include "utils/pcx_to_clx.hpp"
+#endif
+
 #ifdef __SWITCH__
 // for virtual keyboard on Switch
 #include "platform/switch/keyboard.h"
@@ -759,10 +765,25 @@ bool UiLoadBlackBackground()
 	return true;
 }
 
+void PrefetchBackgroundArt(const char *pszFile)
+{
+#ifndef UNPACKED_MPQS
+	PrefetchAsset(StrCat(pszFile, DEVILUTIONX_PCX_EXT));
+#endif
+}
+
 void LoadBackgroundArt(const char *pszFile, int frames)
 {
 	ArtBackground = std::nullopt;
-	ArtBackground = LoadPcxSpriteList(pszFile, static_cast<uint16_t>(frames), /*transparentColor=*/std::nullopt, logical_palette.data());
+#ifndef UNPACKED_MPQS
+	std::optional<AssetData> prefetched = TakePrefetchedAsset(StrCat(pszFile, DEVILUTIONX_PCX_EXT));
+	// Backgrounds of the screens that weren't opened after all.
+	ClearPrefetchedAssets();
+	if (prefetched)
+		ArtBackground = PcxToClx(std::move(*prefetched), frames, /*transparentColor=*/std::nullopt, logical_palette.data());
+#endif
+	if (!ArtBackground)
+		ArtBackground = LoadPcxSpriteList(pszFile, static_cast<uint16_t>(frames), /*transparentColor=*/std::nullopt, logical_palette.data());
 	if (!ArtBackground)
 		return;
 
@@ -797,6 +818,11 @@ void UiFadeIn()
 	RenderPresent();
 }
 
+bool UiIsFadedIn()
+{
+	return fadeValue == 256;
+}
+
 namespace {
 ClxSpriteList GetListSelectorSprites(int itemHeight)
 {
@@ -99,6 +99,8 @@ bool UiProgressDialog(int (*fnfunc)());
 bool UiSelectGame(GameData *gameData, int *playerId);
 bool UiSelectProvider(GameData *gameData);
 void UiFadeIn();
+/** @brief Whether the palette has finished fading in, from then on `UiFadeIn` only presents the screen. */
+bool UiIsFadedIn();
 void UiHandleEvents(SDL_Event *event);
 bool UiItemMouseEvents(SDL_Event *event, const std::vector<UiItemBase *> &items);
 bool UiItemMouseEvents(SDL_Event *event, const std::vector<std::unique_ptr<UiItemBase>> &items);
@@ -106,6 +108,12 @@ Sint16 GetCenterOffset(Sint16 w, Sint16 bw = 0);
 void DrawMouse();
 void UiLoadDefaultPalette();
 bool UiLoadBlackBackground();
+/**
+ * @brief Starts reading the background of a screen that is likely to be opened next on a worker thread.
+ *
+ * The next `LoadBackgroundArt` drops the prefetched backgrounds it doesn't use.
+ */
+void PrefetchBackgroundArt(const char *pszFile);
 void LoadBackgroundArt(const char *pszFile, int frames = 1);
 void UiAddBackground(std::vector<std::unique_ptr<UiItemBase>> *vecDialog);
 void UiAddLogo(std::vector<std::unique_ptr<UiItemBase>> *vecDialog, int y = GetUIRectangle().position.y);
@@ -283,6 +283,8 @@ void RemoveSelHeroBackground()
 void AddSelHeroBackground()
 {
 	LoadBackgroundArt("ui_art\\selhero");
+	// Picking a hero leads to the difficulty or game selection.
+	PrefetchBackgroundArt("ui_art\\selgame");
 	vecSelHeroDialog.insert(vecSelHeroDialog.begin(),
 	    std::make_unique<UiImageClx>((*ArtBackground)[0], MakeSdlRect(0, GetUIRectangle().position.y, 0, 0), UiFlags::AlignCenter));
 }
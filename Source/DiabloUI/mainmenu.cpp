@@ -65,6 +65,8 @@ void MainmenuLoad(const char *name)
 	} else {
 		LoadBackgroundArt("ui_art\\swmmenu");
 	}
+	PrefetchBackgroundArt("ui_art\\selhero");
+	PrefetchBackgroundArt("ui_art\\selconn");
 
 	UiAddBackground(&vecMainMenuDialog);
 	UiAddLogo(&vecMainMenuDialog);
@@ -94,6 +94,7 @@ bool IsGameCompatible(const GameData &data)
 	return (data.versionMajor == PROJECT_VERSION_MAJOR
 	    && data.versionMinor == PROJECT_VERSION_MINOR
 	    && data.versionPatch == PROJECT_VERSION_PATCH
+	    && data.protocolVersion == NetProtocolVersion
 	    && data.programid == GAME_ID);
 	return false;
 }
@@ -6,14 +6,19 @@
 #include "automap.h"
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
+#include <cstring>
+#include <utility>
 
 #include <fmt/format.h>
 
 #include "control/control.hpp"
+#include "engine/clx_sprite.hpp"
 #include "engine/load_file.hpp"
 #include "engine/palette.h"
 #include "engine/render/automap_render.hpp"
+#include "engine/render/clx_render.hpp"
 #include "engine/render/primitive_render.hpp"
 #include "levels/gendung.h"
 #include "levels/setmaps.h"
@@ -21,8 +26,11 @@
 #include "player.h"
 #include "utils/attributes.h"
 #include "utils/enum_traits.h"
+#include "utils/frame_profiler.hpp"
 #include "utils/is_of.hpp"
 #include "utils/language.h"
+#include "utils/sdl_compat.h"
+#include "utils/surface_to_clx.hpp"
 #include "utils/ui_fwd.h"
 #include "utils/utf8.hpp"
 
@@ -1273,6 +1281,115 @@ Displacement GetAutomapScreen()
 	return screen;
 }
 
+/**
+ * @brief Draws the explored tiles around `Automap`.
+ * @param screen Where the top-left tile is drawn.
+ * @param cells The number of tiles drawn in each direction.
+ */
+void DrawAutomapTiles(const Surface &out, Point screen, int cells)
+{
+	Point map = { Automap.x - cells, Automap.y - 1 };
+
+	for (int i = 0; i <= cells + 1; i++) {
+		Point tile1 = screen;
+		for (int j = 0; j < cells; j++) {
+			DrawAutomapTile(out, tile1, { map.x + j, map.y - j });
+			tile1.x += AmOffset(AmWidthOffset::DoubleTileRight, AmHeightOffset::None).deltaX;
+		}
+		map.y++;
+
+		Point tile2 = screen + AmOffset(AmWidthOffset::FullTileLeft, AmHeightOffset::FullTileDown);
+		for (int j = 0; j <= cells; j++) {
+			DrawAutomapTile(out, tile2, { map.x + j, map.y - j });
+			tile2.x += AmOffset(AmWidthOffset::DoubleTileRight, AmHeightOffset::None).deltaX;
+		}
+		map.x++;
+		screen.y += AmOffset(AmWidthOffset::None, AmHeightOffset::DoubleTileDown).deltaY;
+	}
+}
+
+/**
+ * @brief The explored tiles as last drawn by `DrawAutomapLayer`, along with everything they were drawn from.
+ */
+struct AutomapLayer {
+	OptionalOwnedClxSpriteList sprite;
+
+	AutomapType type;
+	int scale;
+	dungeon_type levelType;
+	Point automap;
+	Point screen;
+	Size size;
+	std::array<AutomapTile, 256> tileTypes;
+	uint8_t view[DMAXX][DMAXY];
+	uint8_t dungeon[DMAXX][DMAXY];
+};
+
+AutomapLayer CachedAutomapLayer;
+
+/** @brief The palette index that is left out of the automap layer, none of the map colors use it. */
+constexpr uint8_t AutomapLayerTransparentColor = 1;
+
+/**
+ * @brief Whether the tiles can be drawn once and reused while nothing changes.
+ *
+ * The transparent map blends with the game view below it, which changes every frame.
+ */
+bool CanUseAutomapLayer()
+{
+#ifdef _DEBUG
+	if (DebugVision)
+		return false;
+#endif
+	return GetAutomapType() != AutomapType::Transparent;
+}
+
+bool IsAutomapLayerUpToDate(const Surface &out, Point screen, int scale)
+{
+	const AutomapLayer &layer = CachedAutomapLayer;
+	return layer.sprite && layer.type == GetAutomapType() && layer.scale == scale && layer.levelType == leveltype
+	    && layer.automap == Automap && layer.screen == screen && layer.size == Size { out.w(), out.h() }
+	    && memcmp(layer.tileTypes.data(), AutomapTypeTiles.data(), sizeof(AutomapTypeTiles)) == 0
+	    && memcmp(layer.view, AutomapView, sizeof(AutomapView)) == 0
+	    && memcmp(layer.dungeon, dungeon, sizeof(layer.dungeon)) == 0;
+}
+
+/**
+ * @brief Draws the explored tiles from a cached layer, which is only redrawn when the map, the view, or the zoom changes.
+ * @param screen Where the top-left tile is drawn while the player is standing still.
+ * @param walkOffset How far the map has moved with the player walking.
+ */
+void DrawAutomapLayer(const Surface &out, Point screen, int cells, int scale, Displacement walkOffset)
+{
+	AutomapLayer &layer = CachedAutomapLayer;
+	if (!IsAutomapLayerUpToDate(out, screen, scale)) {
+		const OwnedSurface surface { out.w(), out.h() };
+		SDL_FillSurfaceRect(surface.surface, nullptr, AutomapLayerTransparentColor);
+		// The minimap moves with the walking player, so the layer is clipped to it when it's drawn instead.
+		const Rectangle minimapRect = std::exchange(MinimapRect, Rectangle { { 0, 0 }, Size { out.w(), out.h() } });
+		DrawAutomapTiles(surface, screen, cells);
+		MinimapRect = minimapRect;
+		layer.sprite = SurfaceToClx(surface, 1, AutomapLayerTransparentColor);
+
+		layer.type = GetAutomapType();
+		layer.scale = scale;
+		layer.levelType = leveltype;
+		layer.automap = Automap;
+		layer.screen = screen;
+		layer.size = { out.w(), out.h() };
+		layer.tileTypes = AutomapTypeTiles;
+		memcpy(layer.view, AutomapView, sizeof(AutomapView));
+		memcpy(layer.dungeon, dungeon, sizeof(layer.dungeon));
+	}
+
+	if (GetAutomapType() == AutomapType::Minimap) {
+		const Surface minimap = out.subregion(MinimapRect.position.x, MinimapRect.position.y, MinimapRect.size.width, MinimapRect.size.height);
+		RenderClxSprite(minimap, (*layer.sprite)[0], Point { walkOffset.deltaX - MinimapRect.position.x, walkOffset.deltaY - MinimapRect.position.y });
+	} else {
+		RenderClxSprite(out, (*layer.sprite)[0], Point { 0, 0 } + walkOffset);
+	}
+}
+
 void SearchAutomapItem(const Surface &out, const Displacement &myPlayerOffset, int searchRadius, tl::function_ref<bool(Point position)> highlightTile)
 {
 	const Player &player = *MyPlayer;
@@ -1752,6 +1869,7 @@ void AutomapZoomOut()
 
 void DrawAutomap(const Surface &out)
 {
+	DVL_PROFILE_ZONE("DrawAutomap");
 	Automap = { (ViewPosition.x - 8) / 2, (ViewPosition.y - 8) / 2 };
 	if (leveltype != DTYPE_TOWN) {
 		Automap += { -4, -4 };
@@ -1774,13 +1892,15 @@ void DrawAutomap(const Surface &out)
 		myPlayerOffset = GetOffsetForWalking(myPlayer.AnimInfo, myPlayer._pdir, true);
 
 	const int scale = (GetAutomapType() == AutomapType::Minimap) ? MinimapScale : AutoMapScale;
+	const bool useLayer = CanUseAutomapLayer();
 	const int d = (scale * 64) / 100;
 	int cells = (2 * (gnScreenWidth / 2 / d)) + 1;
 	if (((gnScreenWidth / 2) % d) != 0)
 		cells++;
 	if (((gnScreenWidth / 2) % d) >= (scale * 32) / 100)
 		cells++;
-	if ((myPlayerOffset.deltaX + myPlayerOffset.deltaY) != 0)
+	// The layer is kept while walking, so it always covers the extra tiles.
+	if ((myPlayerOffset.deltaX + myPlayerOffset.deltaY) != 0 || useLayer)
 		cells++;
 
 	if (GetAutomapType() == AutomapType::Minimap) {
@@ -1828,8 +1948,7 @@ void DrawAutomap(const Surface &out)
 		screen.y -= AmOffset(AmWidthOffset::None, AmHeightOffset::HalfTileDown).deltaY;
 	}
 
-	screen.x += scale * myPlayerOffset.deltaX / 100 / 2;
-	screen.y += scale * myPlayerOffset.deltaY / 100 / 2;
+	const Displacement walkOffset { scale * myPlayerOffset.deltaX / 100 / 2, scale * myPlayerOffset.deltaY / 100 / 2 };
 
 	if (CanPanelsCoverView()) {
 		if (IsRightPanelOpen()) {
@@ -1840,24 +1959,10 @@ void DrawAutomap(const Surface &out)
 		}
 	}
 
-	Point map = { Automap.x - cells, Automap.y - 1 };
-
-	for (int i = 0; i <= cells + 1; i++) {
-		Point tile1 = screen;
-		for (int j = 0; j < cells; j++) {
-			DrawAutomapTile(out, tile1, { map.x + j, map.y - j });
-			tile1.x += AmOffset(AmWidthOffset::DoubleTileRight, AmHeightOffset::None).deltaX;
-		}
-		map.y++;
-
-		Point tile2 = screen + AmOffset(AmWidthOffset::FullTileLeft, AmHeightOffset::FullTileDown);
-		for (int j = 0; j <= cells; j++) {
-			DrawAutomapTile(out, tile2, { map.x + j, map.y - j });
-			tile2.x += AmOffset(AmWidthOffset::DoubleTileRight, AmHeightOffset::None).deltaX;
-		}
-		map.x++;
-		screen.y += AmOffset(AmWidthOffset::None, AmHeightOffset::DoubleTileDown).deltaY;
-	}
+	if (useLayer)
+		DrawAutomapLayer(out, screen, cells, scale, walkOffset);
+	else
+		DrawAutomapTiles(out, screen + walkOffset, cells);
 
 	for (const Player &player : Players) {
 		if (player.isOnActiveLevel() && player.plractive && !player._pLvlChanging && (&player == MyPlayer || player.friendlyMode)) {
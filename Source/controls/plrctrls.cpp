@@ -3,7 +3,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
-#include <list>
+#include <vector>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_events.h>
@@ -147,7 +147,7 @@ int GetDistance(Point destination, int maxDistance)
 
 	int8_t walkpath[MaxPathLengthPlayer];
 	Player &myPlayer = *MyPlayer;
-	const int steps = FindPath(CanStep, [&myPlayer](Point position) { return PosOkPlayer(myPlayer, position); }, myPlayer.position.future, destination, walkpath, std::min<size_t>(maxDistance, MaxPathLengthPlayer));
+	const int steps = FindPathT(CanStepPredicate {}, PlayerPosOk { myPlayer }, myPlayer.position.future, destination, walkpath, std::min<size_t>(maxDistance, MaxPathLengthPlayer));
 	if (steps > maxDistance)
 		return 0;
 
@@ -310,7 +310,9 @@ void FindMeleeTarget()
 		int x, y;
 		int steps;
 	};
-	std::list<SearchNode> queue;
+	// Nodes are never removed, the front of the queue just moves forward, so a search allocates only while the queue grows
+	std::vector<SearchNode> queue;
+	size_t queueFront = 0;
 
 	const Player &myPlayer = *MyPlayer;
 
@@ -321,9 +323,8 @@ void FindMeleeTarget()
 		queue.push_back({ startX, startY, 0 });
 	}
 
-	while (!queue.empty()) {
-		const SearchNode node = queue.front();
-		queue.pop_front();
+	while (queueFront < queue.size()) {
+		const SearchNode node = queue[queueFront++];
 
 		for (auto pathDir : PathDirs) {
 			const int dx = node.x + pathDir.deltaX;
@@ -1,5 +1,8 @@
 #include "crawl.hpp"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
 
 #include <function_ref.hpp>
@@ -8,14 +11,13 @@
 
 namespace devilution {
 
-bool DoCrawl(unsigned radius, tl::function_ref<bool(Displacement)> function)
-{
-	return DoCrawl(radius, radius, function);
-}
+namespace {
 
-bool DoCrawl(unsigned minRadius, unsigned maxRadius, tl::function_ref<bool(Displacement)> function)
+/** @brief The visiting order of `DoCrawl`, also used to build the crawl table at compile time. */
+template <typename F>
+constexpr bool CrawlRings(int minRadius, int maxRadius, F &&function)
 {
-	for (int r = static_cast<int>(minRadius); r <= static_cast<int>(maxRadius); ++r) {
+	for (int r = minRadius; r <= maxRadius; ++r) {
 		if (!function(Displacement { 0, r })) return false;
 		if (r == 0) continue;
 		if (!function(Displacement { 0, -r })) return false;
@@ -44,4 +46,46 @@ bool DoCrawl(unsigned minRadius, unsigned maxRadius, tl::function_ref<bool(Displ
 	return true;
 }
 
+struct CrawlTables {
+	std::remove_const_t<decltype(detail::CrawlTable)> displacements;
+	std::remove_const_t<decltype(detail::CrawlTableRadiusStart)> radiusStart;
+};
+
+constexpr CrawlTables BuildCrawlTables()
+{
+	CrawlTables tables {};
+	size_t size = 0;
+	for (unsigned r = 0; r <= detail::MaxCrawlTableRadius; ++r) {
+		tables.radiusStart[r] = static_cast<uint16_t>(size);
+		CrawlRings(static_cast<int>(r), static_cast<int>(r), [&](Displacement displacement) {
+			tables.displacements[size++] = { static_cast<int8_t>(displacement.deltaX), static_cast<int8_t>(displacement.deltaY) };
+			return true;
+		});
+	}
+	tables.radiusStart.back() = static_cast<uint16_t>(size);
+	return tables;
+}
+
+constexpr CrawlTables Tables = BuildCrawlTables();
+static_assert(Tables.radiusStart.back() == Tables.displacements.size());
+
+} // namespace
+
+namespace detail {
+
+const std::array<DisplacementOf<int8_t>, 4 * MaxCrawlTableRadius * (MaxCrawlTableRadius + 1) - 3> CrawlTable = Tables.displacements;
+const std::array<uint16_t, MaxCrawlTableRadius + 2> CrawlTableRadiusStart = Tables.radiusStart;
+
+} // namespace detail
+
+bool DoCrawl(unsigned radius, tl::function_ref<bool(Displacement)> function)
+{
+	return DoCrawl(radius, radius, function);
+}
+
+bool DoCrawl(unsigned minRadius, unsigned maxRadius, tl::function_ref<bool(Displacement)> function)
+{
+	return CrawlRings(static_cast<int>(minRadius), static_cast<int>(maxRadius), function);
+}
+
 } // namespace devilution
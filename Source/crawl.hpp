@@ -1,3 +1,8 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <type_traits>
 
 #include <function_ref.hpp>
@@ -6,6 +11,19 @@
 
 namespace devilution {
 
+namespace detail {
+
+/** @brief The largest radius `Crawl` looks up in `CrawlTable`, larger ones are generated by `DoCrawl`. */
+constexpr unsigned MaxCrawlTableRadius = 18;
+
+/** @brief The displacements of `DoCrawl(0, MaxCrawlTableRadius)` in the order they are visited. */
+extern const std::array<DisplacementOf<int8_t>, 4 * MaxCrawlTableRadius * (MaxCrawlTableRadius + 1) - 3> CrawlTable;
+
+/** @brief Index of the first displacement of each radius in `CrawlTable`, followed by the end of the table. */
+extern const std::array<uint16_t, MaxCrawlTableRadius + 2> CrawlTableRadiusStart;
+
+} // namespace detail
+
 /**
  * CrawlTable specifies X- and Y-coordinate deltas from a missile target coordinate.
  *
@@ -33,11 +51,29 @@ namespace devilution {
 bool DoCrawl(unsigned radius, tl::function_ref<bool(Displacement)> function);
 bool DoCrawl(unsigned minRadius, unsigned maxRadius, tl::function_ref<bool(Displacement)> function);
 
+/**
+ * @brief Calls `function` with the displacements of the rings from `minRadius` to `maxRadius`, in the same order as `DoCrawl`, until it returns a truthy value.
+ *
+ * Radii up to `detail::MaxCrawlTableRadius` are read from `detail::CrawlTable`, so that `function` can be inlined.
+ * @return The first truthy value `function` returned, or a value-initialized one.
+ */
 template <typename F>
-auto Crawl(unsigned radius, F function) -> std::invoke_result_t<decltype(function), Displacement>
+auto Crawl(unsigned minRadius, unsigned maxRadius, F function) -> std::invoke_result_t<decltype(function), Displacement>
 {
-	std::invoke_result_t<decltype(function), Displacement> result;
-	DoCrawl(radius, [&result, &function](Displacement displacement) -> bool {
+	std::invoke_result_t<decltype(function), Displacement> result {};
+	if (minRadius <= detail::MaxCrawlTableRadius) {
+		const DisplacementOf<int8_t> *it = detail::CrawlTable.data() + detail::CrawlTableRadiusStart[minRadius];
+		const DisplacementOf<int8_t> *const end = detail::CrawlTable.data() + detail::CrawlTableRadiusStart[std::min(maxRadius, detail::MaxCrawlTableRadius) + 1];
+		for (; it < end; ++it) {
+			result = function(Displacement(*it));
+			if (result)
+				return result;
+		}
+		minRadius = detail::MaxCrawlTableRadius + 1;
+	}
+	if (minRadius > maxRadius)
+		return result;
+	DoCrawl(minRadius, maxRadius, [&result, &function](Displacement displacement) -> bool {
 		result = function(displacement);
 		return !result;
 	});
@@ -45,14 +81,9 @@ auto Crawl(unsigned radius, F function) -> std::invoke_result_t<decltype(functio
 }
 
 template <typename F>
-auto Crawl(unsigned minRadius, unsigned maxRadius, F function) -> std::invoke_result_t<decltype(function), Displacement>
+auto Crawl(unsigned radius, F function) -> std::invoke_result_t<decltype(function), Displacement>
 {
-	std::invoke_result_t<decltype(function), Displacement> result;
-	DoCrawl(minRadius, maxRadius, [&result, &function](Displacement displacement) -> bool {
-		result = function(displacement);
-		return !result;
-	});
-	return result;
+	return Crawl(radius, radius, function);
 }
 
 } // namespace devilution
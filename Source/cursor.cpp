@@ -65,9 +65,30 @@ namespace {
 OptionalOwnedClxSpriteList pCursCels;
 OptionalOwnedClxSpriteList pCursCels2;
 
+/** Half-size item sprites for the stores, indexed relative to `CURSOR_FIRSTITEM` and rendered the first time they're requested */
 OptionalOwnedClxSpriteList *HalfSizeItemSprites;
 OptionalOwnedClxSpriteList *HalfSizeItemSpritesRed;
 
+/**
+ * @brief Renders an inventory item sprite at half its size.
+ * @param index Index of the item sprite, relative to `CURSOR_FIRSTITEM`
+ * @param trn Translation to apply before downscaling, or nullptr
+ */
+OwnedClxSpriteList CreateHalfSizeItemSprite(int index, const uint8_t *trn)
+{
+	const ClxSprite itemSprite = GetInvItemSprite(static_cast<int>(CURSOR_FIRSTITEM) + index);
+	const OwnedSurface itemSurface { itemSprite.width(), itemSprite.height() };
+	const OwnedSurface halfSurface { itemSprite.width() / 2, itemSprite.height() / 2 };
+
+	SDL_FillSurfaceRect(itemSurface.surface, nullptr, 1);
+	if (trn != nullptr)
+		ClxDrawTRN(itemSurface, { 0, itemSurface.h() }, itemSprite, trn);
+	else
+		ClxDraw(itemSurface, { 0, itemSurface.h() }, itemSprite);
+	BilinearDownscaleByHalf8(itemSurface.surface, paletteTransparencyLookup, halfSurface.surface, 1);
+	return SurfaceToClx(halfSurface, 1, 1);
+}
+
 bool IsValidMonsterForSelection(const Monster &monster)
 {
 	if (monster.hasNoLife())
@@ -479,12 +500,18 @@ Size GetInvItemSize(int cursId)
 
 ClxSprite GetHalfSizeItemSprite(int cursId)
 {
-	return (*HalfSizeItemSprites[cursId])[0];
+	OptionalOwnedClxSpriteList &sprite = HalfSizeItemSprites[cursId];
+	if (!sprite)
+		sprite.emplace(CreateHalfSizeItemSprite(cursId, nullptr));
+	return (*sprite)[0];
 }
 
 ClxSprite GetHalfSizeItemSpriteRed(int cursId)
 {
-	return (*HalfSizeItemSpritesRed[cursId])[0];
+	OptionalOwnedClxSpriteList &sprite = HalfSizeItemSpritesRed[cursId];
+	if (!sprite)
+		sprite.emplace(CreateHalfSizeItemSprite(cursId, GetInfravisionTRN()));
+	return (*sprite)[0];
 }
 
 void CreateHalfSizeItemSprites()
@@ -495,46 +522,6 @@ void CreateHalfSizeItemSprites()
 	    + (pCursCels2.has_value() ? pCursCels2->numSprites() : 0);
 	HalfSizeItemSprites = new OptionalOwnedClxSpriteList[numInvItems];
 	HalfSizeItemSpritesRed = new OptionalOwnedClxSpriteList[numInvItems];
-	const uint8_t *redTrn = GetInfravisionTRN();
-
-	constexpr int MaxWidth = 28 * 3;
-	constexpr int MaxHeight = 28 * 3;
-	OwnedSurface ownedItemSurface { MaxWidth, MaxHeight };
-	OwnedSurface ownedHalfSurface { MaxWidth / 2, MaxHeight / 2 };
-
-	const auto createHalfSize = [&, redTrn](const ClxSprite itemSprite, size_t outputIndex) {
-		if (itemSprite.width() <= 28 && itemSprite.height() <= 28) {
-			// Skip creating half-size sprites for 1x1 items because we always render them at full size anyway.
-			return;
-		}
-		const Surface itemSurface = ownedItemSurface.subregion(0, 0, itemSprite.width(), itemSprite.height());
-		const SDL_Rect itemSurfaceRect = MakeSdlRect(0, 0, itemSurface.w(), itemSurface.h());
-
-		SDL_SetSurfaceClipRect(itemSurface.surface, &itemSurfaceRect);
-		SDL_FillSurfaceRect(itemSurface.surface, nullptr, 1);
-		ClxDraw(itemSurface, { 0, itemSurface.h() }, itemSprite);
-
-		const Surface halfSurface = ownedHalfSurface.subregion(0, 0, itemSurface.w() / 2, itemSurface.h() / 2);
-		const SDL_Rect halfSurfaceRect = MakeSdlRect(0, 0, halfSurface.w(), halfSurface.h());
-		SDL_SetSurfaceClipRect(halfSurface.surface, &halfSurfaceRect);
-		BilinearDownscaleByHalf8(itemSurface.surface, paletteTransparencyLookup, halfSurface.surface, 1);
-		HalfSizeItemSprites[outputIndex].emplace(SurfaceToClx(halfSurface, 1, 1));
-
-		SDL_FillSurfaceRect(itemSurface.surface, nullptr, 1);
-		ClxDrawTRN(itemSurface, { 0, itemSurface.h() }, itemSprite, redTrn);
-		BilinearDownscaleByHalf8(itemSurface.surface, paletteTransparencyLookup, halfSurface.surface, 1);
-		HalfSizeItemSpritesRed[outputIndex].emplace(SurfaceToClx(halfSurface, 1, 1));
-	};
-
-	size_t outputIndex = 0;
-	for (size_t i = static_cast<int>(CURSOR_FIRSTITEM) - 1, n = pCursCels->numSprites(); i < n; ++i, ++outputIndex) {
-		createHalfSize((*pCursCels)[i], outputIndex);
-	}
-	if (pCursCels2.has_value()) {
-		for (size_t i = 0, n = pCursCels2->numSprites(); i < n; ++i, ++outputIndex) {
-			createHalfSize((*pCursCels2)[i], outputIndex);
-		}
-	}
 }
 
 void FreeHalfSizeItemSprites()
@@ -5,6 +5,9 @@
 #include <cstdint>
 #include <limits>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <expected.hpp>
 #include <fmt/format.h>
@@ -14,6 +17,19 @@
 #include "utils/language.h"
 
 namespace devilution {
+
+namespace {
+
+struct PreloadedDataFile {
+	std::string path;
+	DataFile dataFile;
+};
+
+/** @brief Only used from the main thread. */
+std::vector<PreloadedDataFile> PreloadedDataFiles;
+
+} // namespace
+
 tl::expected<DataFile, DataFile::Error> DataFile::load(std::string_view path)
 {
 	AssetRef ref = FindAsset(path);
@@ -23,7 +39,8 @@ tl::expected<DataFile, DataFile::Error> DataFile::load(std::string_view path)
 	// TODO: It should be possible to stream the data file contents instead of copying the whole thing into memory
 	std::unique_ptr<char[]> data { new char[size] };
 	{
-		AssetHandle handle = OpenAsset(std::move(ref));
+		// Data files are also loaded from the startup worker threads.
+		AssetHandle handle = OpenAsset(std::move(ref), /*threadsafe=*/true);
 		if (!handle.ok())
 			return tl::unexpected { Error::OpenFailed };
 		if (size > 0 && !handle.read(data.get(), size))
@@ -34,6 +51,13 @@ tl::expected<DataFile, DataFile::Error> DataFile::load(std::string_view path)
 
 DataFile DataFile::loadOrDie(std::string_view path)
 {
+	const auto it = c_find_if(PreloadedDataFiles, [path](const PreloadedDataFile &preloaded) { return preloaded.path == path; });
+	if (it != PreloadedDataFiles.end()) {
+		DataFile dataFile = std::move(it->dataFile);
+		PreloadedDataFiles.erase(it);
+		return dataFile;
+	}
+
 	tl::expected<DataFile, DataFile::Error> dataFileResult = DataFile::load(path);
 	if (!dataFileResult.has_value()) {
 		DataFile::reportFatalError(dataFileResult.error(), path);
@@ -41,6 +65,16 @@ DataFile DataFile::loadOrDie(std::string_view path)
 	return *std::move(dataFileResult);
 }
 
+void DataFile::addPreloaded(std::string_view path, DataFile &&dataFile)
+{
+	PreloadedDataFiles.push_back(PreloadedDataFile { std::string(path), std::move(dataFile) });
+}
+
+void DataFile::clearPreloaded()
+{
+	PreloadedDataFiles.clear();
+}
+
 void DataFile::reportFatalError(Error code, std::string_view fileName)
 {
 	switch (code) {
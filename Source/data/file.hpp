@@ -76,8 +76,21 @@ public:
 	 */
 	static tl::expected<DataFile, Error> load(std::string_view path);
 
+	/**
+	 * @brief Loads a data file and ends the game with an error message if that fails, only call this from the main thread
+	 *
+	 * Takes the file from the ones kept with `addPreloaded` if it is among them.
+	 */
 	static DataFile loadOrDie(std::string_view path);
 
+	/**
+	 * @brief Keeps a data file that was read ahead of time, e.g. on a worker thread, for the next `loadOrDie` of the same path
+	 */
+	static void addPreloaded(std::string_view path, DataFile &&dataFile);
+
+	/** @brief Drops the preloaded data files that no `loadOrDie` has taken */
+	static void clearPreloaded();
+
 	static void reportFatalError(Error code, std::string_view fileName);
 	static void reportFatalFieldError(DataFileField::Error code, std::string_view fileName, std::string_view fieldName, const DataFileField &field, std::string_view details = {});
 
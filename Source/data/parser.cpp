@@ -1,6 +1,92 @@
 #include "parser.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DEVILUTIONX_PARSER_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace devilution {
+
+namespace {
+
+#ifdef DEVILUTIONX_PARSER_SSE2
+constexpr ptrdiff_t BlockSize = 16;
+
+struct SeparatorMasks {
+	/** @brief One bit per tab in the block, lowest bit first. */
+	uint32_t tabs;
+	/** @brief One bit per cr or lf in the block. */
+	uint32_t terminators;
+};
+
+SeparatorMasks ScanBlock(const char *begin)
+{
+	const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+	const __m128i tabs = _mm_cmpeq_epi8(chars, _mm_set1_epi8('\t'));
+	const __m128i terminators = _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('\n')));
+	return { static_cast<uint32_t>(_mm_movemask_epi8(tabs)), static_cast<uint32_t>(_mm_movemask_epi8(terminators)) };
+}
+#else
+constexpr ptrdiff_t BlockSize = 8;
+
+/** @brief Returns a non-zero value if any byte of the word equals c, exact unlike the shorter (x - 0x01..) & ~x form. */
+constexpr uint64_t HasByte(uint64_t word, char c)
+{
+	constexpr uint64_t Low7 = 0x7F7F7F7F7F7F7F7FULL;
+	const uint64_t x = word ^ (0x0101010101010101ULL * static_cast<uint8_t>(c));
+	return ~(((x & Low7) + Low7) | x | Low7);
+}
+
+uint64_t LoadBlock(const char *begin)
+{
+	uint64_t word;
+	memcpy(&word, begin, sizeof(word));
+	return word;
+}
+#endif
+
+} // namespace
+
+const char *FindFieldSeparator(const char *begin, const char *end)
+{
+	while (end - begin >= BlockSize) {
+#ifdef DEVILUTIONX_PARSER_SSE2
+		const SeparatorMasks masks = ScanBlock(begin);
+		if ((masks.tabs | masks.terminators) != 0)
+			return begin + std::countr_zero(masks.tabs | masks.terminators);
+#else
+		const uint64_t word = LoadBlock(begin);
+		if ((HasByte(word, '\t') | HasByte(word, '\r') | HasByte(word, '\n')) != 0)
+			break;
+#endif
+		begin += BlockSize;
+	}
+	return std::find_if(begin, end, IsFieldSeparator);
+}
+
+const char *FindRecordTerminator(const char *begin, const char *end)
+{
+	while (end - begin >= BlockSize) {
+#ifdef DEVILUTIONX_PARSER_SSE2
+		const SeparatorMasks masks = ScanBlock(begin);
+		if (masks.terminators != 0)
+			return begin + std::countr_zero(masks.terminators);
+#else
+		const uint64_t word = LoadBlock(begin);
+		if ((HasByte(word, '\r') | HasByte(word, '\n')) != 0)
+			break;
+#endif
+		begin += BlockSize;
+	}
+	return std::find_if(begin, end, IsRecordTerminator);
+}
+
 GetFieldResult HandleRecordTerminator(const char *begin, const char *end)
 {
 	if (begin == end) {
@@ -30,6 +116,36 @@ GetFieldResult DiscardMultipleFields(const char *begin, const char *end, unsigne
 {
 	GetFieldResult result { begin };
 	unsigned skipCount = 0;
+#ifdef DEVILUTIONX_PARSER_SSE2
+	// Counts the tabs a block at a time, so runs of short fields are skipped without stopping at each one
+	while (skipCount < skipLength && end - result.next >= BlockSize) {
+		SeparatorMasks masks = ScanBlock(result.next);
+		if (masks.terminators != 0) {
+			// Only the tabs before the end of the record belong to it
+			masks.tabs &= (masks.terminators & (~masks.terminators + 1)) - 1;
+		}
+		const unsigned remaining = skipLength - skipCount;
+		const auto tabCount = static_cast<unsigned>(std::popcount(masks.tabs));
+		if (tabCount >= remaining) {
+			for (unsigned i = 1; i < remaining; ++i)
+				masks.tabs &= masks.tabs - 1;
+			skipCount = skipLength;
+			result = { result.next + std::countr_zero(masks.tabs) + 1, GetFieldResult::Status::EndOfField };
+			break;
+		}
+		skipCount += tabCount;
+		if (masks.terminators != 0) {
+			// The field that ends the record counts as skipped as well
+			++skipCount;
+			result = HandleRecordTerminator(result.next + std::countr_zero(masks.terminators), end);
+			if (fieldsSkipped != nullptr) {
+				*fieldsSkipped = skipCount;
+			}
+			return result;
+		}
+		result.next += BlockSize;
+	}
+#endif
 	while (skipCount < skipLength) {
 		++skipCount;
 		result = DiscardField(result.next, end);
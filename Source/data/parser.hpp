@@ -88,6 +88,22 @@ constexpr bool IsFieldSeparator(char c)
 	return c == '\t' || IsRecordTerminator(c);
 }
 
+/**
+ * @brief Finds the next field separator, testing a block of characters at a time
+ * @param begin first character of the stream
+ * @param end one past the last character in the stream
+ * @return a pointer to the first tab, cr, or lf character, or end if there is none
+ */
+const char *FindFieldSeparator(const char *begin, const char *end);
+
+/**
+ * @brief Finds the next record terminator, testing a block of characters at a time
+ * @param begin first character of the stream
+ * @param end one past the last character in the stream
+ * @return a pointer to the first cr or lf character, or end if there is none
+ */
+const char *FindRecordTerminator(const char *begin, const char *end);
+
 /**
  * @brief Consumes the current record terminator sequence and returns a result describing whether at least one more record is available.
  *
@@ -138,7 +154,7 @@ inline GetFieldResult HandleFieldSeparator(const char *begin, const char *end)
  */
 inline GetFieldResult DiscardField(const char *begin, const char *end)
 {
-	const char *nextSeparator = std::find_if(begin, end, IsFieldSeparator);
+	const char *nextSeparator = FindFieldSeparator(begin, end);
 
 	return HandleFieldSeparator(nextSeparator, end);
 }
@@ -176,7 +192,7 @@ GetFieldResult DiscardMultipleRecords(const char *begin, const char *end, unsign
  */
 inline GetFieldResult DiscardRemainingFields(const char *begin, const char *end)
 {
-	const char *nextSeparator = std::find_if(begin, end, IsRecordTerminator);
+	const char *nextSeparator = FindRecordTerminator(begin, end);
 
 	return HandleRecordTerminator(nextSeparator, end);
 }
@@ -198,7 +214,7 @@ inline GetFieldResult DiscardRemainingFields(const char *begin, const char *end)
  */
 inline GetFieldResult GetNextField(const char *begin, const char *end)
 {
-	const char *nextSeparator = std::find_if(begin, end, IsFieldSeparator);
+	const char *nextSeparator = FindFieldSeparator(begin, end);
 
 	// Can't use the string_view(It, It) constructor since that was only added in C++20...
 	return { { begin, static_cast<size_t>(nextSeparator - begin) }, HandleFieldSeparator(nextSeparator, end) };
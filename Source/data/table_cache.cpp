@@ -0,0 +1,140 @@
+#include "data/table_cache.hpp"
+
+#include <cstdio>
+#include <memory>
+
+#include "config.h"
+#include "engine/assets.hpp"
+#include "utils/file_util.h"
+#include "utils/log.hpp"
+#include "utils/paths.h"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+
+namespace {
+
+constexpr uint32_t TableCacheMagic = 0x43545844; // "DXTC"
+
+struct TableCacheHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t key;
+	uint64_t size;
+};
+
+class Fnv1a64 {
+public:
+	void add(const void *data, size_t size)
+	{
+		const auto *bytes = static_cast<const uint8_t *>(data);
+		for (size_t i = 0; i < size; ++i)
+			hash_ = (hash_ ^ bytes[i]) * 0x100000001B3ULL;
+	}
+
+	void add(std::string_view str)
+	{
+		add(str.data(), str.size());
+		add(&Separator, 1);
+	}
+
+	template <typename T>
+	void addValue(T value)
+	{
+		add(&value, sizeof(value));
+	}
+
+	[[nodiscard]] uint64_t value() const
+	{
+		return hash_;
+	}
+
+private:
+	static constexpr char Separator = '\0';
+	uint64_t hash_ = 0xCBF29CE484222325ULL;
+};
+
+std::string GetTableCacheDirectory()
+{
+	return StrCat(paths::ConfigPath(), "cache", DIRECTORY_SEPARATOR_STR);
+}
+
+std::string GetTableCachePath(std::string_view filename)
+{
+	// "txtdata\spells\spelldat.tsv" -> "txtdata_spells_spelldat.tsv.bin"
+	std::string name { filename };
+	for (char &c : name) {
+		if (c == '\\' || c == '/')
+			c = '_';
+	}
+	return StrCat(GetTableCacheDirectory(), name, ".bin");
+}
+
+} // namespace
+
+uint64_t GetTableCacheKey(const DataFile &dataFile, size_t recordSize)
+{
+	Fnv1a64 hash;
+	hash.addValue(TableCacheVersion);
+	// The layout of the records can change without their size changing, development builds include the commit hash.
+	hash.add(PROJECT_VERSION);
+	hash.addValue(static_cast<uint64_t>(recordSize));
+	// Mods can add records from their own files after the base file was parsed.
+	for (const std::string &overridePath : OverridePaths)
+		hash.add(overridePath);
+	hash.add(dataFile.data(), dataFile.size());
+	return hash.value();
+}
+
+std::optional<std::vector<std::byte>> ReadTableCache(std::string_view filename, uint64_t key)
+{
+	const std::string path = GetTableCachePath(filename);
+	FILE *file = OpenFile(path.c_str(), "rb");
+	if (file == nullptr)
+		return std::nullopt;
+	const std::unique_ptr<FILE, int (*)(FILE *)> fileCloser { file, &std::fclose };
+
+	TableCacheHeader header;
+	if (std::fread(&header, sizeof(header), 1, file) != 1)
+		return std::nullopt;
+	if (header.magic != TableCacheMagic || header.version != TableCacheVersion || header.key != key)
+		return std::nullopt;
+
+	std::uintmax_t fileSize;
+	if (!GetFileSize(path.c_str(), &fileSize) || fileSize != sizeof(header) + header.size)
+		return std::nullopt;
+
+	std::vector<std::byte> records(static_cast<size_t>(header.size));
+	if (!records.empty() && std::fread(records.data(), records.size(), 1, file) != 1)
+		return std::nullopt;
+	return records;
+}
+
+void WriteTableCache(std::string_view filename, uint64_t key, std::span<const std::byte> records)
+{
+	const std::string directory = GetTableCacheDirectory();
+	RecursivelyCreateDir(directory.c_str());
+
+	// Write to a temporary file first so that an interrupted write never leaves a truncated cache behind.
+	const std::string path = GetTableCachePath(filename);
+	const std::string tempPath = StrCat(path, ".tmp");
+	FILE *file = OpenFile(tempPath.c_str(), "wb");
+	if (file == nullptr) {
+		LogVerbose("Failed to create table cache {}", tempPath);
+		return;
+	}
+
+	const TableCacheHeader header { TableCacheMagic, TableCacheVersion, key, records.size() };
+	bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+	if (ok && !records.empty())
+		ok = std::fwrite(records.data(), records.size(), 1, file) == 1;
+	ok = std::fclose(file) == 0 && ok;
+	if (!ok) {
+		LogVerbose("Failed to write table cache {}", tempPath);
+		RemoveFile(tempPath.c_str());
+		return;
+	}
+	RenameFile(tempPath.c_str(), path.c_str());
+}
+
+} // namespace devilution
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "data/file.hpp"
+
+namespace devilution {
+
+/**
+ * @brief Version of the cached table layout, bump whenever a cached record type or its field list changes.
+ */
+constexpr uint32_t TableCacheVersion = 1;
+
+/**
+ * @brief Serializes table records field by field into a flat buffer without any pointers.
+ *
+ * Trivially copyable fields are stored as they are in memory, strings as a 32-bit length followed by the bytes.
+ */
+class TableCacheWriter {
+public:
+	template <typename... Ts>
+	void operator()(const Ts &...fields)
+	{
+		(write(fields), ...);
+	}
+
+	[[nodiscard]] std::span<const std::byte> data() const
+	{
+		return data_;
+	}
+
+private:
+	template <typename T>
+	void write(const T &value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		const auto *bytes = reinterpret_cast<const std::byte *>(&value);
+		data_.insert(data_.end(), bytes, bytes + sizeof(T));
+	}
+
+	void write(const std::string &value)
+	{
+		write(static_cast<uint32_t>(value.size()));
+		const auto *bytes = reinterpret_cast<const std::byte *>(value.data());
+		data_.insert(data_.end(), bytes, bytes + value.size());
+	}
+
+	std::vector<std::byte> data_;
+};
+
+/**
+ * @brief Reads back the fields written by `TableCacheWriter`, in the same order.
+ */
+class TableCacheReader {
+public:
+	explicit TableCacheReader(std::span<const std::byte> data)
+	    : data_(data)
+	{
+	}
+
+	template <typename... Ts>
+	void operator()(Ts &...fields)
+	{
+		(read(fields), ...);
+	}
+
+	/** @brief Whether all reads so far were within bounds. */
+	[[nodiscard]] bool ok() const
+	{
+		return ok_;
+	}
+
+	[[nodiscard]] bool atEnd() const
+	{
+		return data_.empty();
+	}
+
+	[[nodiscard]] size_t remaining() const
+	{
+		return data_.size();
+	}
+
+private:
+	template <typename T>
+	void read(T &value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		if (!ok_ || data_.size() < sizeof(T)) {
+			ok_ = false;
+			return;
+		}
+		std::memcpy(&value, data_.data(), sizeof(T));
+		data_ = data_.subspan(sizeof(T));
+	}
+
+	void read(std::string &value)
+	{
+		uint32_t size = 0;
+		read(size);
+		if (!ok_ || data_.size() < size) {
+			ok_ = false;
+			return;
+		}
+		value.assign(reinterpret_cast<const char *>(data_.data()), size);
+		data_ = data_.subspan(size);
+	}
+
+	std::span<const std::byte> data_;
+	bool ok_ = true;
+};
+
+/**
+ * @brief Identifies the parsed contents of a data file.
+ *
+ * Derived from the file contents, the active mods, the cache version, the build's version and the record size,
+ * so that any change to either invalidates the cached table.
+ */
+uint64_t GetTableCacheKey(const DataFile &dataFile, size_t recordSize);
+
+/**
+ * @brief Reads the cached records of a data file.
+ *
+ * @return `std::nullopt` if there is no cache or it was written for a different key.
+ */
+std::optional<std::vector<std::byte>> ReadTableCache(std::string_view filename, uint64_t key);
+
+/**
+ * @brief Saves the records of a data file to the cache directory, failures are only logged.
+ */
+void WriteTableCache(std::string_view filename, uint64_t key, std::span<const std::byte> records);
+
+/**
+ * @brief Appends the cached records of a data file to `table`.
+ *
+ * @param transfer `void(Stream &stream, T &record)`, passes all the fields of the record to `stream`.
+ * @return false if the cache is missing or stale, `table` is left as is.
+ */
+template <typename T, typename Transfer>
+bool LoadTableFromCache(std::string_view filename, uint64_t key, std::vector<T> &table, Transfer &&transfer)
+{
+	const std::optional<std::vector<std::byte>> blob = ReadTableCache(filename, key);
+	if (!blob)
+		return false;
+
+	TableCacheReader reader { *blob };
+	uint32_t numRecords = 0;
+	reader(numRecords);
+	if (!reader.ok() || numRecords > reader.remaining())
+		return false;
+
+	std::vector<T> records;
+	records.reserve(numRecords);
+	for (uint32_t i = 0; i < numRecords && reader.ok(); ++i)
+		transfer(reader, records.emplace_back());
+	if (!reader.ok() || !reader.atEnd())
+		return false;
+
+	table.insert(table.end(), std::make_move_iterator(records.begin()), std::make_move_iterator(records.end()));
+	return true;
+}
+
+/**
+ * @brief Caches the given records of a data file for `LoadTableFromCache`.
+ */
+template <typename T, typename Transfer>
+void SaveTableToCache(std::string_view filename, uint64_t key, std::span<T> records, Transfer &&transfer)
+{
+	TableCacheWriter writer;
+	writer(static_cast<uint32_t>(records.size()));
+	for (T &record : records)
+		transfer(writer, record);
+	WriteTableCache(filename, key, writer.data());
+}
+
+} // namespace devilution
@@ -5,7 +5,9 @@
  */
 #include "dead.h"
 
+#include <array>
 #include <cstdint>
+#include <optional>
 
 #include "diablo.h"
 #include "headless_mode.hpp"
@@ -31,19 +33,6 @@ void InitDeadAnimationFromMonster(Corpse &corpse, const CMonster &mon)
 	corpse.frame = animData.frames - 1;
 	corpse.width = animData.width;
 }
-
-void MoveLightToCorpse(Monster &monster)
-{
-	for (int dx = 0; dx < MAXDUNX; dx++) {
-		for (int dy = 0; dy < MAXDUNY; dy++) {
-			if ((dCorpse[dx][dy] & 0x1F) == monster.corpseId) {
-				ChangeLightXY(monster.lightId, { dx, dy });
-				return;
-			}
-		}
-	}
-	AddUnLight(monster.lightId);
-}
 } // namespace
 
 void InitCorpses()
@@ -97,11 +86,26 @@ void AddCorpse(Point tilePosition, int8_t dv, Direction ddir)
 
 void MoveLightsToCorpses()
 {
+	// Find the first tile of each corpse in a single pass over the level, instead of one per unique monster
+	std::array<std::optional<Point>, MaxCorpses + 1> corpsePositions;
+	for (int dx = 0; dx < MAXDUNX; dx++) {
+		for (int dy = 0; dy < MAXDUNY; dy++) {
+			std::optional<Point> &position = corpsePositions[dCorpse[dx][dy] & 0x1F];
+			if (!position)
+				position = Point { dx, dy };
+		}
+	}
+
 	for (size_t i = 0; i < ActiveMonsterCount; i++) {
 		auto &monster = Monsters[ActiveMonsters[i]];
 		if (!monster.isUnique())
 			continue;
-		MoveLightToCorpse(monster);
+		const auto corpseId = static_cast<uint8_t>(monster.corpseId);
+		const std::optional<Point> position = corpseId < corpsePositions.size() ? corpsePositions[corpseId] : std::nullopt;
+		if (position)
+			ChangeLightXY(monster.lightId, *position);
+		else
+			AddUnLight(monster.lightId);
 	}
 }
 
@@ -25,6 +25,7 @@ extern bool DebugInvisible;
 extern bool DebugVision;
 extern bool DebugPath;
 extern bool DebugGrid;
+extern bool DebugDirtyRegions;
 extern ankerl::unordered_dense::map<int, Point> DebugCoordsMap;
 extern bool DebugScrollViewEnabled;
 extern std::string debugTRN;
@@ -5,7 +5,10 @@
  */
 #include <array>
 #include <cstdint>
+#include <optional>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_events.h>
@@ -19,6 +22,7 @@
 #endif
 #endif
 
+#include <expected.hpp>
 #include <fmt/format.h>
 
 #include <config.h>
@@ -38,11 +42,13 @@
 #include "controls/keymapper.hpp"
 #include "controls/plrctrls.h"
 #include "controls/remap_keyboard.h"
+#include "data/file.hpp"
 #include "diablo.h"
 #include "diablo_msg.hpp"
 #include "discord/discord.h"
 #include "doom.h"
 #include "encrypt.h"
+#include "engine/asset_prefetch.hpp"
 #include "engine/backbuffer_state.hpp"
 #include "engine/clx_sprite.hpp"
 #include "engine/demomode.h"
@@ -52,7 +58,11 @@
 #include "engine/load_file.hpp"
 #include "engine/random.hpp"
 #include "engine/render/clx_render.hpp"
+#include "engine/render/scrollrt.h"
+#include "engine/render/text_render.hpp"
 #include "engine/sound.h"
+#include "engine/stress_bench.hpp"
+#include "engine/transition_bench.hpp"
 #include "game_mode.hpp"
 #include "gamemenu.h"
 #include "gmenu.h"
@@ -77,6 +87,7 @@
 #include "menu.h"
 #include "minitext.h"
 #include "missiles.h"
+#include "monsters/player_flow_field.hpp"
 #include "movie.h"
 #include "multi.h"
 #include "nthread.h"
@@ -98,6 +109,7 @@
 #include "qol/xpbar.h"
 #include "quick_messages.hpp"
 #include "restrict.h"
+#include "state_hash.hpp"
 #include "stores.h"
 #include "storm/storm_net.hpp"
 #include "storm/storm_svid.h"
@@ -105,10 +117,15 @@
 #include "tables/playerdat.hpp"
 #include "towners.h"
 #include "track.h"
+#include "utils/allocation_tracker.hpp"
 #include "utils/console.h"
 #include "utils/display.h"
+#include "utils/frame_profiler.hpp"
 #include "utils/is_of.hpp"
+#include "utils/endian_read.hpp"
 #include "utils/language.h"
+#include "utils/level_load_timings.hpp"
+#include "utils/memory_stats.hpp"
 #include "utils/parse_int.hpp"
 #include "utils/paths.h"
 #include "utils/screen_reader.hpp"
@@ -116,6 +133,8 @@
 #include "utils/sdl_thread.h"
 #include "utils/status_macros.hpp"
 #include "utils/str_cat.hpp"
+#include "utils/str_split.hpp"
+#include "utils/task_graph.hpp"
 #include "utils/utf8.hpp"
 
 #ifndef USE_SDL1
@@ -216,6 +235,7 @@ void FreeGame()
 	FreeDebugGFX();
 #endif
 	FreeGameMem();
+	ClearMonsterSpritesCache();
 	stream_stop();
 	music_stop();
 }
@@ -919,7 +939,8 @@ void RunGameLoop(interface_mode uMsg)
 
 		bool drawGame = true;
 		bool processInput = true;
-		const bool runGameLoop = demo::IsRunning() ? demo::GetRunGameLoop(drawGame, processInput) : nthread_has_500ms_passed(&drawGame);
+		// The stress benchmark times the game ticks as fast as they go, like a timedemo
+		const bool runGameLoop = demo::IsRunning() ? demo::GetRunGameLoop(drawGame, processInput) : (IsStressBenchRunning() || nthread_has_500ms_passed(&drawGame));
 		if (demo::IsRecording())
 			demo::RecordGameLoopResult(runGameLoop);
 
@@ -936,12 +957,26 @@ void RunGameLoop(interface_mode uMsg)
 			continue;
 		}
 
+		demo::NotifyTickSimulationStart();
+		StressBenchTickStart();
+#ifdef DEVILUTIONX_ALLOCATION_TRACKER
+		const AllocationCounts allocationsBeforeTick = GetThreadAllocationCounts();
+#endif
 		ProcessGameMessagePackets();
 		if (game_loop(gbGameLoopStartup))
 			diablo_color_cyc_logic();
 		gbGameLoopStartup = false;
+		TransitionBenchTick();
+		StressBenchTick();
+#ifdef DEVILUTIONX_ALLOCATION_TRACKER
+		AddTickAllocations(GetThreadAllocationCounts() - allocationsBeforeTick);
+#endif
+		LogMemoryStatsPeriodically();
+		demo::NotifyTickRenderStart();
 		if (drawGame)
 			DrawAndBlit();
+		demo::NotifyTickEnd();
+		StressBenchTickEnd();
 #ifdef GPERF_HEAP_FIRST_GAME_ITERATION
 		if (run_game_iteration++ == 0)
 			HeapProfilerDump("first_game_iteration");
@@ -949,6 +984,9 @@ void RunGameLoop(interface_mode uMsg)
 	}
 
 	demo::NotifyGameLoopEnd();
+#ifdef DEVILUTIONX_ALLOCATION_TRACKER
+	LogTickAllocations();
+#endif
 
 	if (gbIsMultiplayer) {
 		pfile_write_hero(/*writeGameData=*/false);
@@ -1003,7 +1041,10 @@ extern "C" void SdlLogToFile(void *userdata, int /*category*/, SDL_LogPriority p
 		"CRITICAL"
 	};
 	std::fprintf(file, "%s: %s\n", LogPriorityPrefixes[priority], message);
-	std::fflush(file);
+	// Flushing every line stalls the logging thread on bursts of verbose messages,
+	// so only warnings and errors are flushed right away and the rest is written as the buffer fills up.
+	if (priority >= SDL_LOG_PRIORITY_WARN)
+		std::fflush(file);
 }
 #endif
 
@@ -1027,7 +1068,15 @@ extern "C" void SdlLogToFile(void *userdata, int /*category*/, SDL_LogPriority p
 	PrintHelpOption("--record <#>", _(/* TRANSLATORS: Commandline Option */ "Record a demo file"));
 	PrintHelpOption("--demo <#>", _(/* TRANSLATORS: Commandline Option */ "Play a demo file"));
 	PrintHelpOption("--timedemo", _(/* TRANSLATORS: Commandline Option */ "Disable all frame limiting during demo playback"));
+	PrintHelpOption("--timedemo-report <path>", _(/* TRANSLATORS: Commandline Option */ "Write the frame time statistics of a timedemo as JSON"));
+	PrintHelpOption("--timedemo-warmup <#>", _(/* TRANSLATORS: Commandline Option */ "Leave the first game ticks of a timedemo out of the statistics"));
+	PrintHelpOption("--headless", _(/* TRANSLATORS: Commandline Option */ "Play back a demo as fast as possible without a window, sound or rendering"));
 #endif
+	PrintHelpOption("--bench-transitions <path>", _(/* TRANSLATORS: Commandline Option */ "Take the last hero through a list of levels and write the time of each step as JSON"));
+	PrintHelpOption("--bench-transitions-levels <#,#,...>", _(/* TRANSLATORS: Commandline Option */ "The levels of --bench-transitions, 1,2,1,2,0 by default"));
+	PrintHelpOption("--stress <scenario>", _(/* TRANSLATORS: Commandline Option */ "Build a heavy load on the deepest level with the last hero and time the game ticks: monsters, missiles, lights or items"));
+	PrintHelpOption("--stress-ticks <#>", _(/* TRANSLATORS: Commandline Option */ "The game ticks that --stress times, 1000 by default"));
+	PrintHelpOption("--stress-report <path>", _(/* TRANSLATORS: Commandline Option */ "Write the game tick times of --stress as JSON"));
 	printNewlineInConsole();
 	printInConsole(_(/* TRANSLATORS: Commandline Option */ "Game selection:"));
 	printNewlineInConsole();
@@ -1067,8 +1116,16 @@ void DiabloParseFlags(int argc, char **argv)
 	int argumentIndexOfLastCommandPart = -1;
 	std::string currentCommand;
 #endif
+	std::string_view benchTransitionsReportPath;
+	std::vector<uint8_t> benchTransitionsLevels { 1, 2, 1, 2, 0 };
+	std::optional<StressScenario> stressScenario;
+	int stressTicks = 1000;
+	std::string_view stressReportPath;
 #ifndef DISABLE_DEMOMODE
 	bool timedemo = false;
+	std::string_view timedemoReportPath;
+	int timedemoWarmupTicks = 0;
+	bool headless = false;
 	int demoNumber = -1;
 	int recordNumber = -1;
 	bool createDemoReference = false;
@@ -1122,6 +1179,25 @@ void DiabloParseFlags(int argc, char **argv)
 			gbShowIntro = false;
 		} else if (arg == "--timedemo") {
 			timedemo = true;
+		} else if (arg == "--timedemo-report") {
+			if (i + 1 == argc) {
+				PrintFlagRequiresArgument("--timedemo-report");
+				diablo_quit(64);
+			}
+			timedemoReportPath = argv[++i];
+		} else if (arg == "--timedemo-warmup") {
+			if (i + 1 == argc) {
+				PrintFlagRequiresArgument("--timedemo-warmup");
+				diablo_quit(64);
+			}
+			ParseIntResult<int> parsedParam = ParseInt<int>(argv[++i]);
+			if (!parsedParam.has_value()) {
+				PrintFlagMessage("--timedemo-warmup", " must be a number");
+				diablo_quit(64);
+			}
+			timedemoWarmupTicks = parsedParam.value();
+		} else if (arg == "--headless") {
+			headless = true;
 		} else if (arg == "--record") {
 			if (i + 1 == argc) {
 				PrintFlagRequiresArgument("--record");
@@ -1136,11 +1212,58 @@ void DiabloParseFlags(int argc, char **argv)
 		} else if (arg == "--create-reference") {
 			createDemoReference = true;
 #else
-		} else if (arg == "--demo" || arg == "--timedemo" || arg == "--record" || arg == "--create-reference") {
+		} else if (arg == "--demo" || arg == "--timedemo" || arg == "--timedemo-report" || arg == "--timedemo-warmup" || arg == "--headless" || arg == "--record" || arg == "--create-reference") {
 			printInConsole("Binary compiled without demo mode support.");
 			printNewlineInConsole();
 			diablo_quit(1);
 #endif
+		} else if (arg == "--bench-transitions") {
+			if (i + 1 == argc) {
+				PrintFlagRequiresArgument("--bench-transitions");
+				diablo_quit(64);
+			}
+			benchTransitionsReportPath = argv[++i];
+		} else if (arg == "--bench-transitions-levels") {
+			if (i + 1 == argc) {
+				PrintFlagRequiresArgument("--bench-transitions-levels");
+				diablo_quit(64);
+			}
+			benchTransitionsLevels.clear();
+			for (const std::string_view level : SplitByChar(argv[++i], ',')) {
+				ParseIntResult<uint8_t> parsedParam = ParseInt<uint8_t>(level);
+				if (!parsedParam.has_value()) {
+					PrintFlagMessage("--bench-transitions-levels", " must be a list of level numbers");
+					diablo_quit(64);
+				}
+				benchTransitionsLevels.push_back(parsedParam.value());
+			}
+		} else if (arg == "--stress") {
+			if (i + 1 == argc) {
+				PrintFlagRequiresArgument("--stress");
+				diablo_quit(64);
+			}
+			stressScenario = ParseStressScenario(argv[++i]);
+			if (!stressScenario.has_value()) {
+				PrintFlagMessage("--stress", " must be one of monsters, missiles, lights or items");
+				diablo_quit(64);
+			}
+		} else if (arg == "--stress-ticks") {
+			if (i + 1 == argc) {
+				PrintFlagRequiresArgument("--stress-ticks");
+				diablo_quit(64);
+			}
+			ParseIntResult<int> parsedParam = ParseInt<int>(argv[++i], /*min=*/1);
+			if (!parsedParam.has_value()) {
+				PrintFlagMessage("--stress-ticks", " must be a positive number");
+				diablo_quit(64);
+			}
+			stressTicks = parsedParam.value();
+		} else if (arg == "--stress-report") {
+			if (i + 1 == argc) {
+				PrintFlagRequiresArgument("--stress-report");
+				diablo_quit(64);
+			}
+			stressReportPath = argv[++i];
 		} else if (arg == "-n") {
 			gbShowIntro = false;
 		} else if (arg == "-f") {
@@ -1195,9 +1318,31 @@ void DiabloParseFlags(int argc, char **argv)
 		DebugCmdsFromCommandLine.push_back(currentCommand);
 #endif
 
+	if (!benchTransitionsReportPath.empty()) {
+		gbShowIntro = false;
+		InitTransitionBench(benchTransitionsReportPath, std::move(benchTransitionsLevels));
+	}
+	if (stressScenario.has_value()) {
+		gbShowIntro = false;
+		InitStressBench(*stressScenario, stressTicks, stressReportPath);
+	}
+
 #ifndef DISABLE_DEMOMODE
+	if (headless) {
+		// There is nothing to drive the game without a window other than a demo.
+		if (demoNumber == -1) {
+			PrintFlagMessage("--headless", " requires --demo");
+			diablo_quit(64);
+		}
+		HeadlessMode = true;
+	}
+	// Without anything to look at, pacing the ticks to real time would only slow down the benchmark.
+	if (headless)
+		timedemo = true;
 	if (demoNumber != -1)
 		demo::InitPlayBack(demoNumber, timedemo);
+	if (timedemo)
+		demo::InitTimedemoReport(timedemoReportPath, timedemoWarmupTicks);
 	if (recordNumber != -1)
 		demo::InitRecording(recordNumber, createDemoReference);
 #endif
@@ -1239,8 +1384,12 @@ void ApplicationInit()
 	if (*GetOptions().Graphics.showFPS)
 		EnableFrameCount();
 
-	init_create_window();
-	was_window_init = true;
+	if (HeadlessMode) {
+		init_create_headless();
+	} else {
+		init_create_window();
+		was_window_init = true;
+	}
 
 	InitializeScreenReader();
 	LanguageInitialize();
@@ -1250,6 +1399,54 @@ void ApplicationInit()
 	ReadOnlyTest();
 }
 
+void LoadGameData()
+{
+	// The files are read on worker threads, but only parsed on this one: parsing them ends in app_fatal on any error.
+	constexpr std::array<const char *, 14> DataFiles = {
+		"txtdata\\text\\textdat.tsv",
+		"txtdata\\Experience.tsv",
+		"txtdata\\classes\\classdat.tsv",
+		"txtdata\\spells\\spelldat.tsv",
+		"txtdata\\missiles\\missile_sprites.tsv",
+		"txtdata\\missiles\\misdat.tsv",
+		"txtdata\\monsters\\monstdat.tsv",
+		"txtdata\\monsters\\unique_monstdat.tsv",
+		"txtdata\\items\\itemdat.tsv",
+		"txtdata\\items\\unique_itemdat.tsv",
+		"txtdata\\items\\item_prefixes.tsv",
+		"txtdata\\items\\item_suffixes.tsv",
+		"txtdata\\objects\\objdat.tsv",
+		"txtdata\\quests\\questdat.tsv",
+	};
+	std::array<std::optional<tl::expected<DataFile, DataFile::Error>>, DataFiles.size()> loaded;
+	TaskGraph graph;
+	for (size_t i = 0; i < DataFiles.size(); i++)
+		graph.add(DataFiles[i], [&loaded, &DataFiles, i]() { loaded[i] = DataFile::load(DataFiles[i]); });
+	graph.run();
+	graph.logTimeline("Reading game data");
+
+	for (size_t i = 0; i < DataFiles.size(); i++) {
+		if (!loaded[i]->has_value())
+			DataFile::reportFatalError(loaded[i]->error(), DataFiles[i]);
+		DataFile::addPreloaded(DataFiles[i], *std::move(*loaded[i]));
+	}
+
+	LoadTextData();
+
+	// Load dynamic data before we go into the menu as we need to initialise player characters in memory pretty early.
+	LoadPlayerDataFiles();
+
+	// TODO: We can probably load this much later (when the game is starting).
+	LoadSpellData();
+	LoadMissileData();
+	LoadMonsterData();
+	LoadItemData();
+	LoadObjectData();
+	LoadQuestData();
+
+	DataFile::clearPreloaded();
+}
+
 void DiabloInit()
 {
 	if (forceSpawn || *GetOptions().GameMode.shareware)
@@ -1276,6 +1473,14 @@ void DiabloInit()
 		}
 	}
 
+	if (HeadlessMode) {
+		// Nothing is drawn or played, only the simulation runs.
+		gbSoundOn = false;
+		gbMusicOn = false;
+		CheckArchivesUpToDate();
+		return;
+	}
+
 #ifndef USE_SDL1
 	InitializeVirtualGamepad();
 #endif
@@ -1307,6 +1512,8 @@ void DiabloInit()
 	LoadSmallSelectionSpinner();
 
 	CheckArchivesUpToDate();
+
+	PrewarmFonts(GetTranslatedText(), GameFont12);
 }
 
 void DiabloSplash()
@@ -1336,10 +1543,12 @@ void DiabloSplash()
 
 void DiabloDeinit()
 {
+	WaitForPendingSave();
 	FreeItemGFX();
 
 	LuaShutdown();
 	ShutDownScreenReader();
+	ShutdownAssetPrefetch();
 
 	if (gbSndInited)
 		effects_cleanup_sfx();
@@ -1351,72 +1560,95 @@ void DiabloDeinit()
 	if (was_window_init)
 		dx_cleanup(); // Cleanup SDL surfaces stuff, so we have to do it before SDL_Quit().
 	UnloadFonts();
+#ifdef DEVILUTIONX_FRAME_PROFILER
+	WriteFrameProfilerTrace();
+#endif
 	if (SDL_WasInit((~0U) & ~SDL_INIT_HAPTIC) != 0)
 		SDL_Quit();
 }
 
+struct LevelGraphicsPaths {
+	const char *cel;
+	const char *til;
+	const char *special;
+};
+
+/**
+ * @brief Tile graphics for a dungeon level type, town is handled separately by the callers.
+ */
+std::optional<LevelGraphicsPaths> GetLevelGraphicsPaths(dungeon_type levelType)
+{
+	switch (levelType) {
+	case DTYPE_CATHEDRAL:
+		return LevelGraphicsPaths {
+			"levels\\l1data\\l1.cel",
+			"levels\\l1data\\l1.til",
+			"levels\\l1data\\l1s",
+		};
+	case DTYPE_CATACOMBS:
+		return LevelGraphicsPaths {
+			"levels\\l2data\\l2.cel",
+			"levels\\l2data\\l2.til",
+			"levels\\l2data\\l2s",
+		};
+	case DTYPE_CAVES:
+		return LevelGraphicsPaths {
+			"levels\\l3data\\l3.cel",
+			"levels\\l3data\\l3.til",
+			"levels\\l1data\\l1s",
+		};
+	case DTYPE_HELL:
+		return LevelGraphicsPaths {
+			"levels\\l4data\\l4.cel",
+			"levels\\l4data\\l4.til",
+			"levels\\l2data\\l2s",
+		};
+	case DTYPE_NEST:
+		return LevelGraphicsPaths {
+			"nlevels\\l6data\\l6.cel",
+			"nlevels\\l6data\\l6.til",
+			"levels\\l1data\\l1s",
+		};
+	case DTYPE_CRYPT:
+		return LevelGraphicsPaths {
+			"nlevels\\l5data\\l5.cel",
+			"nlevels\\l5data\\l5.til",
+			"nlevels\\l5data\\l5s",
+		};
+	default:
+		return std::nullopt;
+	}
+}
+
 tl::expected<void, std::string> LoadLvlGFX()
 {
 	assert(pDungeonCels == nullptr);
 	constexpr int SpecialCelWidth = 64;
 
-	const auto loadAll = [](const char *cel, const char *til, const char *special) -> tl::expected<void, std::string> {
-		ASSIGN_OR_RETURN(pDungeonCels, LoadFileInMemWithStatus(cel));
-		ASSIGN_OR_RETURN(pMegaTiles, LoadFileInMemWithStatus<MegaTile>(til));
-		ASSIGN_OR_RETURN(pSpecialCels, LoadCelWithStatus(special, SpecialCelWidth));
-		return {};
-	};
-
-	switch (leveltype) {
-	case DTYPE_TOWN: {
-		auto cel = LoadFileInMemWithStatus("nlevels\\towndata\\town.cel");
+	if (leveltype == DTYPE_TOWN) {
+		auto cel = LoadPrefetchedFileInMemWithStatus("nlevels\\towndata\\town.cel");
 		if (!cel.has_value()) {
-			ASSIGN_OR_RETURN(pDungeonCels, LoadFileInMemWithStatus("levels\\towndata\\town.cel"));
+			ASSIGN_OR_RETURN(pDungeonCels, LoadPrefetchedFileInMemWithStatus("levels\\towndata\\town.cel"));
 		} else {
 			pDungeonCels = std::move(*cel);
 		}
-		auto til = LoadFileInMemWithStatus<MegaTile>("nlevels\\towndata\\town.til");
+		auto til = LoadPrefetchedFileInMemWithStatus<MegaTile>("nlevels\\towndata\\town.til");
 		if (!til.has_value()) {
-			ASSIGN_OR_RETURN(pMegaTiles, LoadFileInMemWithStatus<MegaTile>("levels\\towndata\\town.til"));
+			ASSIGN_OR_RETURN(pMegaTiles, LoadPrefetchedFileInMemWithStatus<MegaTile>("levels\\towndata\\town.til"));
 		} else {
 			pMegaTiles = std::move(*til);
 		}
 		ASSIGN_OR_RETURN(pSpecialCels, LoadCelWithStatus("levels\\towndata\\towns", SpecialCelWidth));
 		return {};
 	}
-	case DTYPE_CATHEDRAL:
-		return loadAll(
-		    "levels\\l1data\\l1.cel",
-		    "levels\\l1data\\l1.til",
-		    "levels\\l1data\\l1s");
-	case DTYPE_CATACOMBS:
-		return loadAll(
-		    "levels\\l2data\\l2.cel",
-		    "levels\\l2data\\l2.til",
-		    "levels\\l2data\\l2s");
-	case DTYPE_CAVES:
-		return loadAll(
-		    "levels\\l3data\\l3.cel",
-		    "levels\\l3data\\l3.til",
-		    "levels\\l1data\\l1s");
-	case DTYPE_HELL:
-		return loadAll(
-		    "levels\\l4data\\l4.cel",
-		    "levels\\l4data\\l4.til",
-		    "levels\\l2data\\l2s");
-	case DTYPE_NEST:
-		return loadAll(
-		    "nlevels\\l6data\\l6.cel",
-		    "nlevels\\l6data\\l6.til",
-		    "levels\\l1data\\l1s");
-	case DTYPE_CRYPT:
-		return loadAll(
-		    "nlevels\\l5data\\l5.cel",
-		    "nlevels\\l5data\\l5.til",
-		    "nlevels\\l5data\\l5s");
-	default:
+
+	const std::optional<LevelGraphicsPaths> paths = GetLevelGraphicsPaths(leveltype);
+	if (!paths)
 		return tl::make_unexpected("LoadLvlGFX");
-	}
+	ASSIGN_OR_RETURN(pDungeonCels, LoadPrefetchedFileInMemWithStatus(paths->cel));
+	ASSIGN_OR_RETURN(pMegaTiles, LoadPrefetchedFileInMemWithStatus<MegaTile>(paths->til));
+	ASSIGN_OR_RETURN(pSpecialCels, LoadCelWithStatus(paths->special, SpecialCelWidth));
+	return {};
 }
 
 tl::expected<void, std::string> LoadAllGFX()
@@ -1438,7 +1670,7 @@ tl::expected<void, std::string> LoadAllGFX()
  */
 void CreateLevel(lvl_entry entry)
 {
-	CreateDungeon(DungeonSeeds[currlevel], entry);
+	CreateDungeonCached(DungeonSeeds[currlevel], entry);
 
 	switch (leveltype) {
 	case DTYPE_TOWN:
@@ -1520,6 +1752,7 @@ void UpdateMonsterLights()
 
 void GameLogic()
 {
+	DVL_PROFILE_ZONE("GameLogic");
 	if (!ProcessInput()) {
 		return;
 	}
@@ -1550,6 +1783,7 @@ void GameLogic()
 		ProcessMissiles();
 	}
 	gGameLogicStep = GameLogicStep::None;
+	lua::FlushMonsterDamageBatch();
 
 #ifdef _DEBUG
 	if (DebugScrollViewEnabled && (SDL_GetModState() & SDL_KMOD_SHIFT) != 0) {
@@ -1801,6 +2035,7 @@ void OptionLanguageCodeChanged()
 	UnloadFonts();
 	LanguageInitialize();
 	LoadLanguageArchive();
+	PrewarmFonts(GetTranslatedText(), GameFont12);
 	effects_cleanup_sfx(false);
 	if (gbRunGame)
 		sound_init();
@@ -1812,6 +2047,23 @@ const auto OptionChangeHandlerLanguage = (GetOptions().Language.code.SetValueCha
 
 } // namespace
 
+void PrefetchLvlGFX(dungeon_type levelType)
+{
+	if (levelType == DTYPE_TOWN) {
+		const auto prefetchTown = [](const char *hellfirePath, const char *path) {
+			PrefetchAsset(FindAsset(hellfirePath).ok() ? hellfirePath : path);
+		};
+		prefetchTown("nlevels\\towndata\\town.cel", "levels\\towndata\\town.cel");
+		prefetchTown("nlevels\\towndata\\town.til", "levels\\towndata\\town.til");
+		return;
+	}
+	const std::optional<LevelGraphicsPaths> paths = GetLevelGraphicsPaths(levelType);
+	if (!paths)
+		return;
+	PrefetchAsset(paths->cel);
+	PrefetchAsset(paths->til);
+}
+
 void InitKeymapActions()
 {
 	Options &options = GetOptions();
@@ -2645,6 +2897,8 @@ void FreeGameMem()
 	pDungeonCels = nullptr;
 	pMegaTiles = nullptr;
 	pSpecialCels = std::nullopt;
+	MemoryStatsSet(MemoryTag::DungeonCels, 0);
+	LevelArena.reset();
 
 	FreeMonsters();
 	FreeMissileGFX();
@@ -2755,18 +3009,7 @@ int DiabloMain(int argc, char **argv)
 	// Finally load game data
 	LoadGameArchives();
 
-	LoadTextData();
-
-	// Load dynamic data before we go into the menu as we need to initialise player characters in memory pretty early.
-	LoadPlayerDataFiles();
-
-	// TODO: We can probably load this much later (when the game is starting).
-	LoadSpellData();
-	LoadMissileData();
-	LoadMonsterData();
-	LoadItemData();
-	LoadObjectData();
-	LoadQuestData();
+	LoadGameData();
 
 	DiabloInit();
 #ifdef __UWP__
@@ -2778,7 +3021,8 @@ int DiabloMain(int argc, char **argv)
 	mainmenu_loop();
 	DiabloDeinit();
 
-	return 0;
+	// Lets scripts use a demo as a regression test.
+	return demo::HasDiverged() ? 1 : 0;
 }
 
 bool TryIconCurs()
@@ -3044,6 +3288,7 @@ void LoadGameLevelStopMusic(_music_id neededTrack)
 
 void LoadGameLevelStartMusic(_music_id neededTrack)
 {
+	const LevelLoadPhaseTimer timer { LevelLoadPhase::Music };
 	if (sgnMusicTrack != neededTrack)
 		music_start(neededTrack);
 
@@ -3091,6 +3336,8 @@ void LoadGameLevelStores()
 	if (leveltype == DTYPE_TOWN) {
 		SetupTownStores();
 	} else {
+		// Griswold's premium items and Wirt's item carry over, they must be spawned for the town visit that is ending
+		StockTownStores();
 		FreeStoreMem();
 	}
 }
@@ -3110,12 +3357,18 @@ tl::expected<void, std::string> LoadGameLevelDungeon(bool firstflag, lvl_entry l
 		HoldThemeRooms();
 		[[maybe_unused]] const uint32_t mid1Seed = GetLCGEngineState();
 		InitGolems();
-		InitObjects();
+		{
+			const LevelLoadPhaseTimer timer { LevelLoadPhase::Objects };
+			InitObjects();
+		}
 		[[maybe_unused]] const uint32_t mid2Seed = GetLCGEngineState();
 
 		IncProgress();
 
-		RETURN_IF_ERROR(InitMonsters());
+		{
+			const LevelLoadPhaseTimer timer { LevelLoadPhase::Monsters };
+			RETURN_IF_ERROR(InitMonsters());
+		}
 		InitItems();
 		CreateThemeRooms();
 
@@ -3136,13 +3389,19 @@ tl::expected<void, std::string> LoadGameLevelDungeon(bool firstflag, lvl_entry l
 	} else {
 		HoldThemeRooms();
 		InitGolems();
-		RETURN_IF_ERROR(InitMonsters());
+		{
+			const LevelLoadPhaseTimer timer { LevelLoadPhase::Monsters };
+			RETURN_IF_ERROR(InitMonsters());
+		}
 		InitMissiles();
 		InitCorpses();
 
 		IncProgress();
 
-		RETURN_IF_ERROR(LoadLevel());
+		{
+			const LevelLoadPhaseTimer timer { LevelLoadPhase::LoadLevel };
+			RETURN_IF_ERROR(LoadLevel());
+		}
 
 		IncProgress();
 	}
@@ -3165,8 +3424,9 @@ void LoadGameLevelSyncPlayerEntry(lvl_entry lvldir)
 
 void LoadGameLevelLightVision()
 {
+	const LevelLoadPhaseTimer timer { LevelLoadPhase::LightVision };
 	if (leveltype != DTYPE_TOWN) {
-		memcpy(dLight, dPreLight, sizeof(dLight));                                     // resets the light on entering a level to get rid of incorrect light
+		RestorePreLighting();                                                          // resets the light on entering a level to get rid of incorrect light
 		ChangeLightXY(Players[MyPlayerId].lightId, Players[MyPlayerId].position.tile); // forces player light refresh
 		ProcessLightList();
 		ProcessVisionList();
@@ -3216,8 +3476,10 @@ tl::expected<void, std::string> LoadGameLevelTown(bool firstflag, lvl_entry lvld
 
 	IncProgress();
 
-	if (!firstflag && lvldir != ENTRY_LOAD && myPlayer._pLvlVisited[currlevel] && !gbIsMultiplayer)
+	if (!firstflag && lvldir != ENTRY_LOAD && myPlayer._pLvlVisited[currlevel] && !gbIsMultiplayer) {
+		const LevelLoadPhaseTimer timer { LevelLoadPhase::LoadLevel };
 		RETURN_IF_ERROR(LoadLevel());
+	}
 	if (gbIsMultiplayer)
 		DeltaLoadLevel();
 
@@ -3231,14 +3493,24 @@ tl::expected<void, std::string> LoadGameLevelTown(bool firstflag, lvl_entry lvld
 
 tl::expected<void, std::string> LoadGameLevelSetLevel(bool firstflag, lvl_entry lvldir, const Player &myPlayer)
 {
-	LoadSetMap();
+	{
+		const LevelLoadPhaseTimer timer { LevelLoadPhase::Dungeon };
+		LoadSetMap();
+	}
 	IncProgress();
-	RETURN_IF_ERROR(GetLevelMTypes());
+	{
+		const LevelLoadPhaseTimer timer { LevelLoadPhase::MonsterTypes };
+		RETURN_IF_ERROR(GetLevelMTypes());
+	}
 	IncProgress();
 	InitGolems();
-	RETURN_IF_ERROR(InitMonsters());
+	{
+		const LevelLoadPhaseTimer timer { LevelLoadPhase::Monsters };
+		RETURN_IF_ERROR(InitMonsters());
+	}
 	IncProgress();
 	if (!HeadlessMode) {
+		const LevelLoadPhaseTimer timer { LevelLoadPhase::Sprites };
 #if !defined(USE_SDL1) && !defined(__vita__)
 		InitVirtualGamepadGFX();
 #endif
@@ -3267,6 +3539,7 @@ tl::expected<void, std::string> LoadGameLevelSetLevel(bool firstflag, lvl_entry
 		InitItems();
 		SavePreLighting();
 	} else {
+		const LevelLoadPhaseTimer timer { LevelLoadPhase::LoadLevel };
 		RETURN_IF_ERROR(LoadLevel());
 	}
 	if (gbIsMultiplayer) {
@@ -3283,18 +3556,27 @@ tl::expected<void, std::string> LoadGameLevelSetLevel(bool firstflag, lvl_entry
 
 tl::expected<void, std::string> LoadGameLevelStandardLevel(bool firstflag, lvl_entry lvldir, const Player &myPlayer)
 {
-	CreateLevel(lvldir);
+	{
+		const LevelLoadPhaseTimer timer { LevelLoadPhase::Dungeon };
+		CreateLevel(lvldir);
+	}
 
 	IncProgress();
 
 	SetRndSeedForDungeonLevel();
 
 	if (leveltype != DTYPE_TOWN) {
-		RETURN_IF_ERROR(GetLevelMTypes());
+		{
+			const LevelLoadPhaseTimer timer { LevelLoadPhase::MonsterTypes };
+			RETURN_IF_ERROR(GetLevelMTypes());
+		}
 		InitThemes();
-		if (!HeadlessMode)
+		if (!HeadlessMode) {
+			const LevelLoadPhaseTimer timer { LevelLoadPhase::Sprites };
 			RETURN_IF_ERROR(LoadAllGFX());
+		}
 	} else if (!HeadlessMode) {
+		const LevelLoadPhaseTimer timer { LevelLoadPhase::Sprites };
 		IncProgress();
 
 #if !defined(USE_SDL1) && !defined(__vita__)
@@ -3376,14 +3658,26 @@ tl::expected<void, std::string> LoadGameLevel(bool firstflag, lvl_entry lvldir)
 
 	IncProgress();
 
-	RETURN_IF_ERROR(LoadTrns());
-	MakeLightTable();
-	RETURN_IF_ERROR(LoadLevelSOLData());
+	{
+		const LevelLoadPhaseTimer timer { LevelLoadPhase::Tables };
+		RETURN_IF_ERROR(LoadTrns());
+		MakeLightTable();
+		RETURN_IF_ERROR(LoadLevelSOLData());
+	}
 
 	IncProgress();
 
-	RETURN_IF_ERROR(LoadLvlGFX());
-	SetDungeonMicros(pDungeonCels, MicroTileLen);
+	{
+		const LevelLoadPhaseTimer timer { LevelLoadPhase::TileGraphics };
+		RETURN_IF_ERROR(LoadLvlGFX());
+		SetDungeonMicros(pDungeonCels, MicroTileLen);
+		UpdateFloorOcclusion();
+	}
+	if (pDungeonCels != nullptr) {
+		// The re-encoded CELs end with the offset of the end of the last frame
+		const uint32_t numFrames = LoadLE32(pDungeonCels.get());
+		MemoryStatsSet(MemoryTag::DungeonCels, LoadLE32(&pDungeonCels[4 + numFrames * 4]));
+	}
 	ClearClxDrawCache();
 
 	IncProgress();
@@ -3446,6 +3740,10 @@ tl::expected<void, std::string> LoadGameLevel(bool firstflag, lvl_entry lvldir)
 #endif
 	LoadGameLevelStartMusic(neededTrack);
 
+	// Level generation and loading write the map directly, drop anything cached while it was being built.
+	InvalidatePlayerFlowFields();
+	InvalidateLineOfSightCache();
+
 	CompleteProgress();
 
 	LoadGameLevelCalculateCursor();
@@ -3463,6 +3761,7 @@ bool game_loop(bool bStartup)
 		}
 		TimeoutCursor(false);
 		GameLogic();
+		UpdateStateHash();
 		ClearLastSentPlayerCmd();
 
 		if (!gbRunGame || !gbIsMultiplayer || demo::IsRunning() || demo::IsRecording() || !nthread_has_500ms_passed())
@@ -100,6 +100,11 @@ void diablo_focus_unpause();
 bool PressEscKey();
 void DisableInputEventHandler(const SDL_Event &event, uint16_t modState);
 tl::expected<void, std::string> LoadGameLevel(bool firstflag, lvl_entry lvldir);
+
+/**
+ * @brief Starts reading the tile graphics of the given level type in the background.
+ */
+void PrefetchLvlGFX(dungeon_type levelType);
 bool IsDiabloAlive(bool playSFX);
 void PrintScreen(SDL_Keycode vkey);
 
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <utility>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_timer.h>
@@ -13,7 +14,9 @@
 
 #include <expected.hpp>
 
+#include "net_stats.hpp"
 #include "player.h"
+#include "utils/memory_stats.hpp"
 
 namespace devilution {
 namespace net {
@@ -179,12 +182,21 @@ tl::expected<void, PacketError> base::HandleEchoReply(packet &pkt)
 	});
 }
 
+base::~base()
+{
+	for (const message_t &message : message_queue)
+		MemoryStatsRemove(MemoryTag::NetworkQueues, message.payload.size());
+}
+
 void base::ClearMsg(plr_t plr)
 {
 	message_queue.erase(std::remove_if(message_queue.begin(),
 	                        message_queue.end(),
 	                        [&](message_t &msg) {
-		                        return msg.sender == plr;
+		                        if (msg.sender != plr)
+			                        return false;
+		                        MemoryStatsRemove(MemoryTag::NetworkQueues, msg.payload.size());
+		                        return true;
 	                        }),
 	    message_queue.end());
 }
@@ -218,6 +230,7 @@ tl::expected<void, PacketError> base::RecvLocal(packet &pkt)
 	case PT_MESSAGE:
 		return pkt.Message().transform([&](const buffer_t *message) {
 			message_queue.emplace_back(pkt.Source(), *message);
+			MemoryStatsAdd(MemoryTag::NetworkQueues, message->size());
 		});
 	case PT_TURN:
 		return HandleTurn(pkt);
@@ -251,6 +264,8 @@ bool base::SNetReceiveMessage(uint8_t *sender, void **data, size_t *size)
 		return false;
 	message_last = message_queue.front();
 	message_queue.pop_front();
+	MemoryStatsRemove(MemoryTag::NetworkQueues, message_last.payload.size());
+	NetStatsCountReceivedMessage(message_last.sender, message_last.payload.size(), message_queue.size());
 	*sender = message_last.sender;
 	*size = message_last.payload.size();
 	*data = message_last.payload.data();
@@ -261,10 +276,13 @@ bool base::SNetSendMessage(uint8_t playerId, void *data, size_t size)
 {
 	if (playerId != SNPLAYER_OTHERS && playerId >= MAX_PLRS)
 		abort();
+	NetStatsCountSentMessage(playerId, size);
 	auto *rawMessage = reinterpret_cast<unsigned char *>(data);
-	const buffer_t message(rawMessage, rawMessage + size);
-	if (playerId == plr_self)
+	buffer_t message(rawMessage, rawMessage + size);
+	if (playerId == plr_self) {
 		message_queue.emplace_back(plr_self, message);
+		MemoryStatsAdd(MemoryTag::NetworkQueues, size);
+	}
 	plr_t dest;
 	if (playerId == SNPLAYER_OTHERS)
 		dest = PLR_BROADCAST;
@@ -272,7 +290,7 @@ bool base::SNetSendMessage(uint8_t playerId, void *data, size_t size)
 		dest = playerId;
 	if (dest != plr_self) {
 		tl::expected<std::unique_ptr<packet>, PacketError> pkt
-		    = pktfty->make_packet<PT_MESSAGE>(plr_self, dest, message);
+		    = pktfty->make_packet<PT_MESSAGE>(plr_self, dest, std::move(message));
 		if (!pkt.has_value()) {
 			LogError("make_packet: {}", pkt.error().what());
 			return false;
@@ -43,7 +43,7 @@ public:
 
 	DvlNetLatencies get_latencies(uint8_t playerid) override;
 
-	~base() override = default;
+	~base() override;
 
 protected:
 	ankerl::unordered_dense::map<event_type, SEVTHANDLER> registered_handlers;
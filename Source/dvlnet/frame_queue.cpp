@@ -1,8 +1,9 @@
 #include "dvlnet/frame_queue.h"
 
+#include <algorithm>
+#include <bit>
 #include <cstring>
 
-#include "appfat.h"
 #include "dvlnet/packet.h"
 #include "utils/attributes.h"
 #include "utils/endian_read.hpp"
@@ -25,35 +26,50 @@ framesize_t frame_queue::Size() const
 	return current_size;
 }
 
+void frame_queue::Reserve(size_t size)
+{
+	if (size <= ring.size())
+		return;
+	buffer_t grown(std::bit_ceil(std::max<size_t>(size, 4096)));
+	Peek(grown.data(), current_size);
+	ring = std::move(grown);
+	head = 0;
+}
+
+void frame_queue::Peek(unsigned char *dst, size_t size) const
+{
+	const size_t first = std::min(size, ring.size() - head);
+	std::memcpy(dst, ring.data() + head, first);
+	std::memcpy(dst + first, ring.data(), size - first);
+}
+
+void frame_queue::Consume(size_t size)
+{
+	current_size -= static_cast<framesize_t>(size);
+	// Start over at the front when the queue runs empty, so most frames don't wrap
+	head = current_size == 0 ? 0 : (head + size) & (ring.size() - 1);
+}
+
 tl::expected<buffer_t, PacketError> frame_queue::Read(framesize_t s)
 {
 	if (current_size < s)
 		return tl::make_unexpected(FrameQueueError());
-	buffer_t ret;
-	while (s > 0 && s >= buffer_deque.front().size()) {
-		const auto bufferSize = static_cast<framesize_t>(buffer_deque.front().size());
-		s -= bufferSize;
-		current_size -= bufferSize;
-		ret.insert(ret.end(),
-		    buffer_deque.front().begin(),
-		    buffer_deque.front().end());
-		buffer_deque.pop_front();
-	}
-	if (s > 0) {
-		ret.insert(ret.end(),
-		    buffer_deque.front().begin(),
-		    buffer_deque.front().begin() + s);
-		buffer_deque.front().erase(buffer_deque.front().begin(),
-		    buffer_deque.front().begin() + s);
-		current_size -= s;
-	}
+	buffer_t ret(s);
+	Peek(ret.data(), s);
+	Consume(s);
 	return ret;
 }
 
-void frame_queue::Write(buffer_t buf)
+void frame_queue::Write(std::span<const unsigned char> buf)
 {
+	if (buf.empty())
+		return;
+	Reserve(current_size + buf.size());
+	const size_t tail = (head + current_size) & (ring.size() - 1);
+	const size_t first = std::min(buf.size(), ring.size() - tail);
+	std::memcpy(ring.data() + tail, buf.data(), first);
+	std::memcpy(ring.data(), buf.data() + first, buf.size() - first);
 	current_size += static_cast<framesize_t>(buf.size());
-	buffer_deque.push_back(std::move(buf));
 }
 
 tl::expected<bool, PacketError> frame_queue::PacketReady()
@@ -61,10 +77,10 @@ tl::expected<bool, PacketError> frame_queue::PacketReady()
 	if (nextsize == 0) {
 		if (Size() < sizeof(framesize_t))
 			return false;
-		tl::expected<buffer_t, PacketError> szbuf = Read(sizeof(framesize_t));
-		if (!szbuf.has_value())
-			return tl::make_unexpected(szbuf.error());
-		nextsize = LoadLE32(szbuf->data());
+		unsigned char szbuf[sizeof(framesize_t)];
+		Peek(szbuf, sizeof(szbuf));
+		Consume(sizeof(szbuf));
+		nextsize = LoadLE32(szbuf);
 		if (nextsize == 0)
 			return tl::make_unexpected(FrameQueueError());
 	}
@@ -87,13 +103,14 @@ tl::expected<buffer_t, PacketError> frame_queue::ReadPacket()
 	return ret;
 }
 
-tl::expected<buffer_t, PacketError> frame_queue::MakeFrame(buffer_t packetbuf, uint16_t flags)
+tl::expected<buffer_t, PacketError> frame_queue::MakeFrame(const buffer_t &packetbuf, uint16_t flags)
 {
 	buffer_t ret;
 	const auto size = static_cast<framesize_t>(packetbuf.size());
 	if (size > max_frame_size)
 		return tl::make_unexpected("Buffer exceeds maximum frame size");
 	static_assert(sizeof(size) == 4, "framesize_t is not 4 bytes");
+	ret.reserve(sizeof(size) + packetbuf.size());
 	unsigned char sizeBuf[4];
 	WriteLE32(sizeBuf, size | (static_cast<framesize_t>(flags) << 16));
 	ret.insert(ret.end(), sizeBuf, sizeBuf + 4);
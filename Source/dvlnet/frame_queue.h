@@ -1,8 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
-#include <deque>
 #include <exception>
+#include <span>
 #include <vector>
 
 #include <expected.hpp>
@@ -15,26 +16,41 @@ namespace net {
 typedef std::vector<unsigned char> buffer_t;
 typedef uint32_t framesize_t;
 
+/**
+ * @brief Splits a byte stream into frames.
+ *
+ * The received bytes are kept in a contiguous ring buffer that only grows,
+ * so once it fits the largest burst received no more memory is allocated
+ * apart from the buffer handed out for each packet.
+ */
 class frame_queue {
 public:
 	constexpr static framesize_t frame_size_mask = 0xFFFF;
 	constexpr static framesize_t max_frame_size = 0xFFFF;
 
 private:
+	/** @brief Ring storage, its size is always zero or a power of two. */
+	buffer_t ring;
+	/** @brief Position of the oldest byte in `ring`. */
+	size_t head = 0;
 	framesize_t current_size = 0;
-	std::deque<buffer_t> buffer_deque;
 	framesize_t nextsize = 0;
 
 	framesize_t Size() const;
+	void Reserve(size_t size);
+	/** @brief Copies the oldest bytes to `dst` without consuming them, the bytes may wrap around the end of the ring. */
+	void Peek(unsigned char *dst, size_t size) const;
+	void Consume(size_t size);
 	tl::expected<buffer_t, PacketError> Read(framesize_t s);
 
 public:
 	tl::expected<bool, PacketError> PacketReady();
 	uint16_t ReadPacketFlags();
 	tl::expected<buffer_t, PacketError> ReadPacket();
-	void Write(buffer_t buf);
+	/** @brief Appends received bytes to the queue, the caller keeps ownership of `buf`. */
+	void Write(std::span<const unsigned char> buf);
 
-	static tl::expected<buffer_t, PacketError> MakeFrame(buffer_t packetbuf, uint16_t flags = 0);
+	static tl::expected<buffer_t, PacketError> MakeFrame(const buffer_t &packetbuf, uint16_t flags = 0);
 };
 
 } // namespace net
@@ -205,14 +205,10 @@ tl::expected<void, PacketError> packet_in::Create(buffer_t buf)
 	if (buf.size() < sizeof(packet_type) + 2 * sizeof(plr_t))
 		return tl::make_unexpected(PacketError());
 
+	// TCP server implementation forwards the original data to clients,
+	// process_data leaves the buffer intact so Data() still returns it
 	decrypted_buffer = std::move(buf);
 	have_decrypted = true;
-
-	// TCP server implementation forwards the original data to clients
-	// so although we are not decrypting anything,
-	// we save a copy in encrypted_buffer anyway
-	encrypted_buffer = decrypted_buffer;
-	have_encrypted = true;
 	return {};
 }
 
@@ -257,10 +253,7 @@ tl::expected<void, PacketError> packet_out::Encrypt()
 		return {};
 
 	auto lenCleartext = decrypted_buffer.size();
-	encrypted_buffer.insert(encrypted_buffer.begin(),
-	    crypto_secretbox_NONCEBYTES, 0);
-	encrypted_buffer.insert(encrypted_buffer.end(),
-	    crypto_secretbox_MACBYTES + lenCleartext, 0);
+	encrypted_buffer.resize(crypto_secretbox_NONCEBYTES + crypto_secretbox_MACBYTES + lenCleartext);
 	randombytes_buf(encrypted_buffer.data(), crypto_secretbox_NONCEBYTES);
 	const int status = crypto_secretbox_easy(
 	    encrypted_buffer.data() + crypto_secretbox_NONCEBYTES,
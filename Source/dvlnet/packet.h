@@ -6,6 +6,7 @@
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <utility>
 
 #include <expected.hpp>
 
@@ -199,6 +200,10 @@ public:
 	template <class T>
 	tl::expected<void, PacketError> process_element(T &x);
 	tl::expected<void, PacketError> Decrypt(buffer_t buf);
+
+private:
+	/** @brief Bytes of `decrypted_buffer` already read by `process_data`, the buffer itself is kept intact. */
+	size_t decrypted_offset = 0;
 };
 
 class packet_out : public packet_proc<packet_out> {
@@ -263,8 +268,8 @@ tl::expected<void, PacketError> packet_proc<P>::process_data()
 
 inline tl::expected<void, PacketError> packet_in::process_element(buffer_t &x)
 {
-	x.insert(x.begin(), decrypted_buffer.begin(), decrypted_buffer.end());
-	decrypted_buffer.resize(0);
+	x.assign(decrypted_buffer.begin() + decrypted_offset, decrypted_buffer.end());
+	decrypted_offset = decrypted_buffer.size();
 	return {};
 }
 
@@ -273,18 +278,18 @@ tl::expected<void, PacketError> packet_in::process_element(T &x)
 {
 	static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "Unsupported T");
 	static_assert(sizeof(T) == 4 || sizeof(T) == 2 || sizeof(T) == 1, "Unsupported T");
-	if (decrypted_buffer.size() < sizeof(T)) {
+	if (decrypted_buffer.size() - decrypted_offset < sizeof(T)) {
 		return tl::make_unexpected(PacketError());
 	}
+	const unsigned char *data = decrypted_buffer.data() + decrypted_offset;
 	if (sizeof(T) == 4) {
-		x = static_cast<T>(LoadLE32(decrypted_buffer.data()));
+		x = static_cast<T>(LoadLE32(data));
 	} else if (sizeof(T) == 2) {
-		x = static_cast<T>(LoadLE16(decrypted_buffer.data()));
+		x = static_cast<T>(LoadLE16(data));
 	} else if (sizeof(T) == 1) {
-		std::memcpy(&x, decrypted_buffer.data(), sizeof(T));
+		std::memcpy(&x, data, sizeof(T));
 	}
-	decrypted_buffer.erase(decrypted_buffer.begin(),
-	    decrypted_buffer.begin() + sizeof(T));
+	decrypted_offset += sizeof(T);
 	return {};
 }
 
@@ -321,6 +326,8 @@ inline void packet_out::create<PT_MESSAGE>(plr_t s, plr_t d, buffer_t m)
 	m_src = s;
 	m_dest = d;
 	m_message = std::move(m);
+	// Type, source and destination are serialized in front of the message
+	decrypted_buffer.reserve(3 + m_message.size());
 }
 
 template <>
@@ -471,7 +478,7 @@ public:
 	packet_factory(std::string pw);
 	tl::expected<std::unique_ptr<packet>, PacketError> make_packet(buffer_t buf);
 	template <packet_type t, typename... Args>
-	tl::expected<std::unique_ptr<packet>, PacketError> make_packet(Args... args);
+	tl::expected<std::unique_ptr<packet>, PacketError> make_packet(Args &&...args);
 };
 
 inline tl::expected<std::unique_ptr<packet>, PacketError> packet_factory::make_packet(buffer_t buf)
@@ -494,10 +501,11 @@ inline tl::expected<std::unique_ptr<packet>, PacketError> packet_factory::make_p
 }
 
 template <packet_type t, typename... Args>
-tl::expected<std::unique_ptr<packet>, PacketError> packet_factory::make_packet(Args... args)
+tl::expected<std::unique_ptr<packet>, PacketError> packet_factory::make_packet(Args &&...args)
 {
 	auto ret = std::make_unique<packet_out>(key);
-	ret->create<t>(args...);
+	// Buffers passed as rvalues are moved all the way into the packet
+	ret->create<t>(std::forward<Args>(args)...);
 	if (const tl::expected<void, PacketError> result = ret->process_data(); !result.has_value()) {
 		return tl::make_unexpected(result.error());
 	}
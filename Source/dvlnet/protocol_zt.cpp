@@ -2,6 +2,7 @@
 
 #include <optional>
 #include <random>
+#include <utility>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_error.h>
@@ -131,7 +132,8 @@ tl::expected<void, PacketError> protocol_zt::send(const endpoint &peer, const bu
 	tl::expected<buffer_t, PacketError> frame = frame_queue::MakeFrame(data);
 	if (!frame.has_value())
 		return tl::make_unexpected(frame.error());
-	peer_list[peer].send_queue.push_back(*frame);
+	buffer_t &sendBuffer = peer_list[peer].send_buffer;
+	sendBuffer.insert(sendBuffer.end(), frame->begin(), frame->end());
 	return {};
 }
 
@@ -167,26 +169,29 @@ tl::expected<bool, PacketError> protocol_zt::send_queued_peer(const endpoint &pe
 		std::copy(peer.addr.begin(), peer.addr.end(), in6.sin6_addr.s6_addr);
 		lwip_connect(state.fd, (const struct sockaddr *)&in6, sizeof(in6));
 	}
-	while (!state.send_queue.empty()) {
-		auto len = state.send_queue.front().size();
-		auto r = lwip_send(state.fd, state.send_queue.front().data(), len, 0);
-		if (r < 0) {
-			// handle error
-			return false;
-		}
-		if (decltype(len)(r) < len) {
-			// partial send
-			auto it = state.send_queue.front().begin();
-			state.send_queue.front().erase(it, it + r);
-			return true;
-		}
-		if (decltype(len)(r) == len) {
-			state.send_queue.pop_front();
-		} else {
-			std::string_view format = "Impossible number of bytes sent: {} available, {} sent";
-			PacketError error = ProtocolError(format, len, decltype(len)(r));
-			return tl::make_unexpected(std::move(error));
-		}
+	if (state.send_offset == state.send_buffer.size())
+		return true;
+	// All queued frames go out in one call, rather than one per frame
+	auto len = state.send_buffer.size() - state.send_offset;
+	auto r = lwip_send(state.fd, state.send_buffer.data() + state.send_offset, len, 0);
+	if (r < 0) {
+		// handle error
+		return false;
+	}
+	if (decltype(len)(r) > len) {
+		std::string_view format = "Impossible number of bytes sent: {} available, {} sent";
+		PacketError error = ProtocolError(format, len, decltype(len)(r));
+		return tl::make_unexpected(std::move(error));
+	}
+	state.send_offset += r;
+	if (state.send_offset == state.send_buffer.size()) {
+		// Keeps the capacity, so that the next frames don't allocate
+		state.send_buffer.clear();
+		state.send_offset = 0;
+	} else if (state.send_offset >= state.send_buffer.size() / 2) {
+		// partial send, drop the sent bytes once they make up most of the buffer
+		state.send_buffer.erase(state.send_buffer.begin(), state.send_buffer.begin() + state.send_offset);
+		state.send_offset = 0;
 	}
 	return true;
 }
@@ -198,7 +203,7 @@ bool protocol_zt::recv_peer(const endpoint &peer)
 	while (true) {
 		auto len = lwip_recv(state.fd, buf, sizeof(buf), 0);
 		if (len >= 0) {
-			state.recv_queue.Write(buffer_t(buf, buf + len));
+			state.recv_queue.Write({ buf, static_cast<size_t>(len) });
 		} else {
 			return errno == EAGAIN || errno == EWOULDBLOCK;
 		}
@@ -235,17 +240,19 @@ bool protocol_zt::recv_from_peers()
 bool protocol_zt::recv_from_udp()
 {
 	unsigned char buf[PKTBUF_LEN];
-	struct sockaddr_in6 in6 {
-	};
-	socklen_t addrlen = sizeof(in6);
-	auto len = lwip_recvfrom(fd_udp, buf, sizeof(buf), 0, (struct sockaddr *)&in6, &addrlen);
-	if (len < 0)
-		return false;
-	buffer_t data(buf, buf + len);
-	endpoint ep;
-	std::copy(in6.sin6_addr.s6_addr, in6.sin6_addr.s6_addr + 16, ep.addr.begin());
-	oob_recv_queue.emplace_back(ep, std::move(data));
-	return true;
+	bool received = false;
+	while (true) {
+		struct sockaddr_in6 in6 {
+		};
+		socklen_t addrlen = sizeof(in6);
+		auto len = lwip_recvfrom(fd_udp, buf, sizeof(buf), 0, (struct sockaddr *)&in6, &addrlen);
+		if (len < 0)
+			return received;
+		endpoint ep;
+		std::copy(in6.sin6_addr.s6_addr, in6.sin6_addr.s6_addr + 16, ep.addr.begin());
+		oob_recv_queue.emplace_back(ep, buffer_t(buf, buf + len));
+		received = true;
+	}
 }
 
 bool protocol_zt::accept_all()
@@ -272,16 +279,30 @@ bool protocol_zt::accept_all()
 	return true;
 }
 
-bool protocol_zt::recv(endpoint &peer, buffer_t &data)
+void protocol_zt::poll()
 {
 	accept_all();
 	send_queued_all();
 	recv_from_peers();
 	recv_from_udp();
+}
 
+bool protocol_zt::recv(endpoint &peer, buffer_t &data)
+{
+	// The sockets are only polled once everything received before has been handed out,
+	// so draining a frame's packets costs one poll instead of one per packet.
+	// Frames queued by the caller in the meantime are sent together by that poll.
+	if (next_packet(peer, data))
+		return true;
+	poll();
+	return next_packet(peer, data);
+}
+
+bool protocol_zt::next_packet(endpoint &peer, buffer_t &data)
+{
 	if (!oob_recv_queue.empty()) {
 		peer = oob_recv_queue.front().first;
-		data = oob_recv_queue.front().second;
+		data = std::move(oob_recv_queue.front().second);
 		oob_recv_queue.pop_front();
 		return true;
 	}
@@ -300,7 +321,7 @@ bool protocol_zt::recv(endpoint &peer, buffer_t &data)
 			continue;
 		}
 		peer = p.first;
-		data = *packet;
+		data = std::move(*packet);
 		return true;
 	}
 	return false;
@@ -101,7 +101,10 @@ private:
 
 	struct peer_state {
 		int fd = -1;
-		std::deque<buffer_t> send_queue;
+		/** @brief Frames waiting to be sent, written with a single send per poll. */
+		buffer_t send_buffer;
+		/** @brief Bytes at the start of `send_buffer` that have already been sent. */
+		size_t send_offset = 0;
 		frame_queue recv_queue;
 	};
 
@@ -119,6 +122,8 @@ private:
 	static void set_nodelay(int fd);
 	static void set_reuseaddr(int fd);
 
+	void poll();
+	bool next_packet(endpoint &peer, buffer_t &data);
 	tl::expected<bool, PacketError> send_queued_peer(const endpoint &peer);
 	bool recv_peer(const endpoint &peer);
 	bool send_queued_all();
@@ -3,12 +3,12 @@
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <utility>
 
 #include <expected.hpp>
 
 #include "dvlnet/base.h"
-#include "player.h"
 #include "utils/log.hpp"
 
 namespace devilution::net {
@@ -46,7 +46,7 @@ tcp_server::scc tcp_server::MakeConnection()
 
 plr_t tcp_server::NextFree()
 {
-	for (plr_t i = 0; i < Players.size(); ++i)
+	for (plr_t i = 0; i < MAX_PLRS; ++i)
 		if (!connections[i])
 			return i;
 	return PLR_BROADCAST;
@@ -54,7 +54,7 @@ plr_t tcp_server::NextFree()
 
 bool tcp_server::Empty()
 {
-	for (plr_t i = 0; i < Players.size(); ++i)
+	for (plr_t i = 0; i < MAX_PLRS; ++i)
 		if (connections[i])
 			return false;
 	return true;
@@ -74,9 +74,7 @@ void tcp_server::HandleReceive(const scc &con, const asio::error_code &ec,
 		DropConnection(con);
 		return;
 	}
-	con->recv_buffer.resize(bytesRead);
-	con->recv_queue.Write(std::move(con->recv_buffer));
-	con->recv_buffer.resize(frame_queue::max_frame_size);
+	con->recv_queue.Write({ con->recv_buffer.data(), bytesRead });
 	while (true) {
 		tl::expected<bool, PacketError> ready = con->recv_queue.PacketReady();
 		if (!ready.has_value()) {
@@ -92,7 +90,7 @@ void tcp_server::HandleReceive(const scc &con, const asio::error_code &ec,
 			DropConnection(con);
 			return;
 		}
-		tl::expected<std::unique_ptr<packet>, PacketError> pkt = pktfty.make_packet(*pktData);
+		tl::expected<std::unique_ptr<packet>, PacketError> pkt = pktfty.make_packet(std::move(*pktData));
 		if (!pkt.has_value()) {
 			Log("make_packet: {}", pkt.error().what());
 			if (pkt.error().code() == PacketError::ErrorCode::DecryptionFailed)
@@ -133,7 +131,7 @@ tl::expected<void, PacketError> tcp_server::HandleReceiveNewPlayer(const scc &co
 		game_init_info = **pktInfo;
 	}
 
-	for (plr_t player = 0; player < Players.size(); player++) {
+	for (plr_t player = 0; player < MAX_PLRS; player++) {
 		if (connections[player]) {
 			tl::expected<void, PacketError> result
 			    = pktfty.make_packet<PT_CONNECT>(PLR_MASTER, PLR_BROADCAST, newplr)
@@ -165,12 +163,20 @@ tl::expected<void, PacketError> tcp_server::HandleReceivePacket(packet &pkt)
 tl::expected<void, PacketError> tcp_server::SendPacket(packet &pkt)
 {
 	if (pkt.Destination() == PLR_BROADCAST) {
-		for (size_t i = 0; i < Players.size(); ++i) {
+		std::optional<shared_frame> frame;
+		for (size_t i = 0; i < MAX_PLRS; ++i) {
 			if (i == pkt.Source() || !connections[i])
 				continue;
-			tl::expected<void, PacketError> result = StartSend(connections[i], pkt);
-			if (!result.has_value())
-				LogError("Failed to send packet {} to player {}: {}", static_cast<uint8_t>(pkt.Type()), i, result.error().what());
+			// Build the frame once and share it between all the recipients
+			if (!frame) {
+				tl::expected<shared_frame, PacketError> newFrame = MakeFrame(pkt.Data(), 0);
+				if (!newFrame.has_value()) {
+					LogError("Failed to send packet {}: {}", static_cast<uint8_t>(pkt.Type()), newFrame.error().what());
+					return {};
+				}
+				frame = std::move(*newFrame);
+			}
+			StartSend(connections[i], *frame);
 		}
 		return {};
 	}
@@ -183,37 +189,56 @@ tl::expected<void, PacketError> tcp_server::SendPacket(packet &pkt)
 
 tl::expected<void, PacketError> tcp_server::StartSend(const scc &con, packet &pkt)
 {
-	return StartSend(con, pkt.Data(), 0);
+	return MakeFrame(pkt.Data(), 0)
+	    .map([&](shared_frame &&frame) { StartSend(con, std::move(frame)); });
 }
 
 tl::expected<void, PacketError> tcp_server::StartSend(const scc &con, PacketError::ErrorCode errorCode)
 {
 	buffer_t pktData;
 	pktData.push_back(static_cast<unsigned char>(errorCode));
-	return StartSend(con, pktData, TcpErrorCodeFlags);
+	return MakeFrame(pktData, TcpErrorCodeFlags)
+	    .map([&](shared_frame &&frame) { StartSend(con, std::move(frame)); });
 }
 
-tl::expected<void, PacketError> tcp_server::StartSend(const scc &con, buffer_t pktData, uint16_t flags)
+tl::expected<tcp_server::shared_frame, PacketError> tcp_server::MakeFrame(const buffer_t &pktData, uint16_t flags)
 {
-	tl::expected<buffer_t, PacketError> frame = frame_queue::MakeFrame(pktData, flags);
-	if (!frame.has_value())
-		return tl::make_unexpected(frame.error());
-	std::unique_ptr<buffer_t> framePtr = std::make_unique<buffer_t>(*frame);
-	const asio::mutable_buffer buf = asio::buffer(*framePtr);
-	asio::async_write(con->socket, buf,
-	    [this, con, frame = std::move(framePtr)](const asio::error_code &ec, size_t bytesSent) {
-		    HandleSend(con, ec, bytesSent);
-	    });
-	return {};
+	return frame_queue::MakeFrame(pktData, flags)
+	    .map([](buffer_t &&frame) { return std::make_shared<const buffer_t>(std::move(frame)); });
+}
+
+void tcp_server::StartSend(const scc &con, shared_frame frame)
+{
+	con->send_queue.push_back(std::move(frame));
+	// Only one write may be in progress per socket, the rest goes out with the next one
+	if (con->sending.empty())
+		StartWrite(con);
+}
+
+void tcp_server::StartWrite(const scc &con)
+{
+	while (!con->send_queue.empty() && con->sending.size() < max_frames_per_write) {
+		con->send_buffers.push_back(asio::buffer(*con->send_queue.front()));
+		con->sending.push_back(std::move(con->send_queue.front()));
+		con->send_queue.pop_front();
+	}
+	asio::async_write(con->socket, con->send_buffers,
+	    std::bind(&tcp_server::HandleSend, this, con, std::placeholders::_1, std::placeholders::_2));
 }
 
 void tcp_server::HandleSend(const scc &con, const asio::error_code &ec,
     size_t /*bytesSent*/)
 {
+	con->sending.clear();
+	con->send_buffers.clear();
 	if (ec) {
 		Log("Network error: {}", ec.message());
+		con->send_queue.clear();
 		DropConnection(con);
+		return;
 	}
+	if (!con->send_queue.empty())
+		StartWrite(con);
 }
 
 void tcp_server::StartAccept()
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <array>
+#include <deque>
 #include <memory>
 #include <string>
+#include <vector>
 
 // This header must be included before any 3DS code
 // because 3DS SDK defines a macro with the same name
@@ -48,6 +50,11 @@ public:
 private:
 	static constexpr int timeout_connect = 30;
 	static constexpr int timeout_active = 60;
+	/** @brief Maximum number of queued frames that are sent with a single write. */
+	static constexpr size_t max_frames_per_write = 16;
+
+	/** @brief A complete frame, broadcasts share one instance between all the connections they are sent to. */
+	typedef std::shared_ptr<const buffer_t> shared_frame;
 
 	struct client_connection {
 		frame_queue recv_queue;
@@ -56,6 +63,11 @@ private:
 		asio::ip::tcp::socket socket;
 		asio::steady_timer timer;
 		int timeout;
+		/** @brief Frames waiting for the write in progress to complete */
+		std::deque<shared_frame> send_queue;
+		/** @brief Frames of the write in progress, kept alive until it completes */
+		std::vector<shared_frame> sending;
+		std::vector<asio::const_buffer> send_buffers;
 		client_connection(asio::io_context &ioc)
 		    : socket(ioc)
 		    , timer(ioc)
@@ -85,7 +97,9 @@ private:
 	tl::expected<void, PacketError> SendPacket(packet &pkt);
 	tl::expected<void, PacketError> StartSend(const scc &con, packet &pkt);
 	tl::expected<void, PacketError> StartSend(const scc &con, PacketError::ErrorCode errorCode);
-	tl::expected<void, PacketError> StartSend(const scc &con, buffer_t pktData, uint16_t flags);
+	static tl::expected<shared_frame, PacketError> MakeFrame(const buffer_t &pktData, uint16_t flags);
+	void StartSend(const scc &con, shared_frame frame);
+	void StartWrite(const scc &con);
 	void HandleSend(const scc &con, const asio::error_code &ec, size_t bytesSent);
 	void StartTimeout(const scc &con);
 	void HandleTimeout(const scc &con, const asio::error_code &ec);
@@ -164,6 +164,9 @@ void PrivSoundInit(uint8_t bLoadMask)
 
 	if (sgSFX.empty()) LoadEffectsData();
 
+	if (bLoadMask == 0)
+		return;
+
 	for (auto &sfx : sgSFX) {
 		if (sfx.bFlags == 0 || sfx.pSnd != nullptr) {
 			continue;
@@ -267,40 +270,8 @@ void effects_cleanup_sfx(bool fullUnload)
 
 void sound_init()
 {
-	uint8_t mask = sfx_MISC;
-	if (gbIsMultiplayer) {
-		mask |= (sfx_WARRIOR | sfx_MONK);
-		if (!gbIsSpawn)
-			mask |= (sfx_ROGUE | sfx_SORCERER);
-	} else {
-		switch (MyPlayer->_pClass) {
-		case HeroClass::Warrior:
-		case HeroClass::Barbarian:
-			mask |= sfx_WARRIOR;
-			break;
-		case HeroClass::Rogue:
-		case HeroClass::Bard:
-			mask |= sfx_ROGUE;
-			break;
-		case HeroClass::Sorcerer:
-			mask |= sfx_SORCERER;
-			break;
-		case HeroClass::Monk:
-			mask |= sfx_MONK;
-			break;
-		default:
-			if (static_cast<size_t>(MyPlayer->_pClass) < GetNumPlayerClasses()) {
-				// this is a custom class, so we need to add init sounds, since we can't determine which ones will be used by it
-				mask |= (sfx_WARRIOR | sfx_MONK);
-				if (!gbIsSpawn)
-					mask |= (sfx_ROGUE | sfx_SORCERER);
-			} else {
-				app_fatal("effects:1");
-			}
-		}
-	}
-
-	PrivSoundInit(mask);
+	// The sounds of the game are loaded the first time they are played, see `PlaySfxPriv`
+	PrivSoundInit(0);
 }
 
 void ui_sound_init()
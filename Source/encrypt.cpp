@@ -6,7 +6,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
-#include <memory>
+#include <vector>
 
 #include <mpqfs/mpqfs.h>
 
@@ -14,23 +14,28 @@
 
 namespace devilution {
 
-uint32_t PkwareCompress(std::byte *srcData, uint32_t size)
+namespace {
+
+/**
+ * @brief Returns a buffer of at least `size` bytes that is reused by the following calls on the same thread.
+ *
+ * Level deltas sent to joining players don't fit the stack buffers that were used before,
+ * this avoids a heap allocation for each of them.
+ */
+uint8_t *GetScratchBuffer(size_t size)
 {
-	// Stack buffer covers typical network messages and MPQ sectors (≤ 4096).
-	// Falls back to heap for larger payloads.
-	constexpr size_t StackBufSize = (4096 * 2) + 64;
-	uint8_t stackBuf[StackBufSize];
+	thread_local std::vector<uint8_t> buffer;
+	if (buffer.size() < size)
+		buffer.resize(size);
+	return buffer.data();
+}
 
-	size_t dstCap = (static_cast<size_t>(size) * 2) + 64;
-	uint8_t *dst;
-	std::unique_ptr<uint8_t[]> heapBuf;
+} // namespace
 
-	if (dstCap <= StackBufSize) {
-		dst = stackBuf;
-	} else {
-		heapBuf = std::make_unique<uint8_t[]>(dstCap);
-		dst = heapBuf.get();
-	}
+uint32_t PkwareCompress(std::byte *srcData, uint32_t size)
+{
+	const size_t dstCap = (static_cast<size_t>(size) * 2) + 64;
+	uint8_t *dst = GetScratchBuffer(dstCap);
 
 	size_t dstSize = dstCap;
 	int rc = mpqfs_pk_implode(
@@ -48,20 +53,7 @@ uint32_t PkwareCompress(std::byte *srcData, uint32_t size)
 
 uint32_t PkwareDecompress(std::byte *inBuff, uint32_t recvSize, size_t maxBytes)
 {
-	// Stack buffer covers most decompressed network payloads.
-	// Falls back to heap for larger buffers.
-	constexpr size_t StackBufSize = 8192;
-	uint8_t stackBuf[StackBufSize];
-
-	uint8_t *out;
-	std::unique_ptr<uint8_t[]> heapBuf;
-
-	if (maxBytes <= StackBufSize) {
-		out = stackBuf;
-	} else {
-		heapBuf = std::make_unique<uint8_t[]>(maxBytes);
-		out = heapBuf.get();
-	}
+	uint8_t *out = GetScratchBuffer(maxBytes);
 
 	size_t outSize = maxBytes;
 	int rc = mpqfs_pk_explode(
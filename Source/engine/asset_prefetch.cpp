@@ -0,0 +1,225 @@
+#include "engine/asset_prefetch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef USE_SDL3
+#include <SDL3/SDL_mutex.h>
+#else
+#include <SDL.h>
+#endif
+
+#include <expected.hpp>
+
+#include "appfat.h"
+#include "engine/assets.hpp"
+#include "utils/log.hpp"
+#include "utils/mpmc_queue.hpp"
+#include "utils/sdl_semaphore.h"
+#include "utils/sdl_thread.h"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+
+namespace {
+
+constexpr size_t NumPrefetchWorkers = 2;
+constexpr size_t PrefetchQueueCapacity = 32;
+constexpr size_t MaxPrefetchedAssets = 32;
+
+enum class PrefetchJobState : uint8_t {
+	Queued,
+	Loading,
+	Cancelled,
+};
+
+struct PrefetchJob {
+	std::string path;
+	/** @brief Whether to give up on files above `MaxPrefetchFileSize`. */
+	bool limitSize;
+	std::atomic<PrefetchJobState> state { PrefetchJobState::Queued };
+	std::promise<tl::expected<AssetData, std::string>> promise;
+};
+
+struct PrefetchedAsset {
+	std::shared_ptr<PrefetchJob> job;
+	std::future<tl::expected<AssetData, std::string>> future;
+};
+
+#ifndef __DJGPP__
+struct PrefetchService {
+	BoundedMpmcQueue<std::shared_ptr<PrefetchJob>, PrefetchQueueCapacity> queue;
+	SdlSemaphore pending;
+	std::atomic<bool> stopping { false };
+	std::array<SdlThread, NumPrefetchWorkers> workers;
+};
+
+std::optional<PrefetchService> Service;
+#endif
+
+/** @brief Files requested with `PrefetchAsset`, only used from the main thread. */
+std::vector<PrefetchedAsset> PrefetchedAssets;
+
+tl::expected<AssetData, std::string> ReadAsset(const PrefetchJob &job)
+{
+	AssetRef ref = FindAsset(job.path);
+	if (!ref.ok())
+		return tl::make_unexpected(StrCat("Asset not found: ", job.path));
+
+	const size_t size = ref.size();
+	if (job.limitSize && size > MaxPrefetchFileSize)
+		return tl::make_unexpected(StrCat("Asset too large to prefetch: ", job.path));
+
+	AssetHandle handle = OpenAsset(std::move(ref), /*threadsafe=*/true);
+	if (!handle.ok())
+		return tl::make_unexpected(StrCat("Failed to open asset: ", job.path, "\n", handle.error()));
+
+	std::unique_ptr<char[]> data { new char[size] };
+	if (size > 0 && !handle.read(data.get(), size))
+		return tl::make_unexpected(StrCat("Read failed: ", job.path, "\n", handle.error()));
+
+	return AssetData { std::move(data), size };
+}
+
+void RunJob(PrefetchJob &job)
+{
+	PrefetchJobState expected = PrefetchJobState::Queued;
+	if (!job.state.compare_exchange_strong(expected, PrefetchJobState::Loading)) {
+		job.promise.set_value(tl::make_unexpected("Cancelled"));
+		return;
+	}
+	job.promise.set_value(ReadAsset(job));
+}
+
+#ifndef __DJGPP__
+int SDLCALL PrefetchWorker(void *data)
+{
+	auto &service = *static_cast<PrefetchService *>(data);
+	while (true) {
+		service.pending.wait();
+		if (service.stopping.load(std::memory_order_acquire))
+			break;
+		std::optional<std::shared_ptr<PrefetchJob>> job = service.queue.tryPop();
+		if (job)
+			RunJob(**job);
+	}
+	return 0;
+}
+
+PrefetchService &GetService()
+{
+	if (!Service) {
+		Service.emplace();
+		for (SdlThread &worker : Service->workers)
+			worker = SdlThread { PrefetchWorker, &*Service };
+	}
+	return *Service;
+}
+#endif
+
+std::shared_ptr<PrefetchJob> StartJob(std::string_view path, bool limitSize)
+{
+	auto job = std::make_shared<PrefetchJob>();
+	job->path = std::string(path);
+	job->limitSize = limitSize;
+#ifndef __DJGPP__
+	PrefetchService &service = GetService();
+	std::shared_ptr<PrefetchJob> queued = job;
+	if (service.queue.tryPush(queued)) {
+		service.pending.post();
+		return job;
+	}
+#endif
+	return nullptr;
+}
+
+} // namespace
+
+std::future<tl::expected<AssetData, std::string>> LoadAssetAsync(std::string_view path)
+{
+	std::shared_ptr<PrefetchJob> job = StartJob(path, /*limitSize=*/false);
+	if (job == nullptr) {
+		std::promise<tl::expected<AssetData, std::string>> promise;
+		promise.set_value(LoadAsset(path));
+		return promise.get_future();
+	}
+	return job->promise.get_future();
+}
+
+void PrefetchAsset(std::string_view path)
+{
+	if (PrefetchedAssets.size() >= MaxPrefetchedAssets)
+		return;
+	for (const PrefetchedAsset &asset : PrefetchedAssets) {
+		if (asset.job->path == path)
+			return;
+	}
+	std::shared_ptr<PrefetchJob> job = StartJob(path, /*limitSize=*/true);
+	if (job == nullptr)
+		return;
+	std::future<tl::expected<AssetData, std::string>> future = job->promise.get_future();
+	PrefetchedAssets.push_back(PrefetchedAsset { std::move(job), std::move(future) });
+}
+
+std::optional<AssetData> TakePrefetchedAsset(std::string_view path)
+{
+	const auto it = std::find_if(PrefetchedAssets.begin(), PrefetchedAssets.end(),
+	    [path](const PrefetchedAsset &asset) { return asset.job->path == path; });
+	if (it == PrefetchedAssets.end())
+		return std::nullopt;
+	PrefetchedAsset asset = std::move(*it);
+	PrefetchedAssets.erase(it);
+
+	// Loading it on this thread is faster than waiting behind the rest of the queue.
+	PrefetchJobState expected = PrefetchJobState::Queued;
+	if (asset.job->state.compare_exchange_strong(expected, PrefetchJobState::Cancelled))
+		return std::nullopt;
+
+	tl::expected<AssetData, std::string> result = asset.future.get();
+	if (!result.has_value()) {
+		LogVerbose("Prefetch failed: {}", result.error());
+		return std::nullopt;
+	}
+	return std::move(result).value();
+}
+
+void ClearPrefetchedAssets()
+{
+	// Workers that are already reading a file finish it, the result is dropped along with the job.
+	for (PrefetchedAsset &asset : PrefetchedAssets) {
+		PrefetchJobState expected = PrefetchJobState::Queued;
+		asset.job->state.compare_exchange_strong(expected, PrefetchJobState::Cancelled);
+	}
+	PrefetchedAssets.clear();
+}
+
+void ShutdownAssetPrefetch()
+{
+#ifndef __DJGPP__
+	if (Service) {
+		Service->stopping.store(true, std::memory_order_release);
+		for (size_t i = 0; i < NumPrefetchWorkers; ++i)
+			Service->pending.post();
+		for (SdlThread &worker : Service->workers)
+			worker.join();
+		while (std::optional<std::shared_ptr<PrefetchJob>> job = Service->queue.tryPop()) {
+			(*job)->state.store(PrefetchJobState::Cancelled);
+			RunJob(**job);
+		}
+		Service = std::nullopt;
+	}
+#endif
+	PrefetchedAssets.clear();
+}
+
+} // namespace devilution
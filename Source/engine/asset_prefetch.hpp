@@ -0,0 +1,80 @@
+/**
+ * @file asset_prefetch.hpp
+ *
+ * Reads assets into memory on worker threads ahead of time,
+ * e.g. the next level's graphics and music while the player walks towards the stairs.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <expected.hpp>
+
+#include "engine/assets.hpp"
+#include "engine/load_file.hpp"
+
+namespace devilution {
+
+/** @brief Files larger than this are never prefetched. */
+constexpr size_t MaxPrefetchFileSize = 16 * 1024 * 1024;
+
+/**
+ * @brief Reads the file on a worker thread.
+ *
+ * If the queue is full, the file is read right away on the calling thread.
+ */
+std::future<tl::expected<AssetData, std::string>> LoadAssetAsync(std::string_view path);
+
+/**
+ * @brief Starts reading the file on a worker thread, to be picked up with `TakePrefetchedAsset`.
+ *
+ * Does nothing if the file is already being prefetched or too many files are pending.
+ */
+void PrefetchAsset(std::string_view path);
+
+/**
+ * @brief Hands over the contents of a prefetched file.
+ *
+ * Waits for the file if a worker is currently reading it.
+ * If the file was not prefetched, or no worker has started on it yet, returns `std::nullopt`
+ * and the caller should load the file as usual.
+ */
+std::optional<AssetData> TakePrefetchedAsset(std::string_view path);
+
+/**
+ * @brief Drops all prefetched files that haven't been taken yet.
+ */
+void ClearPrefetchedAssets();
+
+/**
+ * @brief Drops all prefetched files and stops the worker threads.
+ *
+ * Must be called before the archives are unloaded.
+ */
+void ShutdownAssetPrefetch();
+
+/**
+ * @brief Same as `LoadFileInMemWithStatus`, but uses the prefetched contents if there are any.
+ */
+template <typename T = std::byte>
+tl::expected<std::unique_ptr<T[]>, std::string> LoadPrefetchedFileInMemWithStatus(const char *path, std::size_t *numRead = nullptr)
+{
+	std::optional<AssetData> prefetched = TakePrefetchedAsset(path);
+	if (!prefetched || (prefetched->size % sizeof(T)) != 0)
+		return LoadFileInMemWithStatus<T>(path, numRead);
+
+	const size_t count = prefetched->size / sizeof(T);
+	if (numRead != nullptr)
+		*numRead = count;
+	std::unique_ptr<T[]> buf { new T[count] };
+	memcpy(buf.get(), prefetched->data.get(), prefetched->size);
+	return { std::move(buf) };
+}
+
+} // namespace devilution
@@ -1,9 +1,11 @@
 #include "engine/assets.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <functional>
+#include <optional>
 #include <vector>
 
 #ifdef USE_SDL3
@@ -21,6 +23,7 @@
 #include "utils/sdl_compat.h"
 #include "utils/str_cat.hpp"
 #include "utils/str_split.hpp"
+#include "utils/task_graph.hpp"
 
 #if defined(_WIN32) && !defined(__UWP__) && !defined(DEVILUTIONX_WINDOWS_NO_WCHAR)
 #include <find_steam_game.h>
@@ -65,8 +68,55 @@ SDL_IOStream *OpenOptionalRWops(const std::string &path)
 	return SDL_IOFromFile(path.c_str(), "rb");
 };
 
+/**
+ * @brief Maps file name hashes to the highest priority archive that contains the file.
+ *
+ * Saves hashing the name and probing the hash table of every archive in turn.
+ */
+struct MpqFileIndex {
+	struct Slot {
+		MpqArchive::FileNameHash name;
+		uint32_t hashIndex;
+		/** @brief Index into `archives`, `EmptySlot` if unused. */
+		uint16_t archive;
+	};
+
+	static constexpr uint16_t EmptySlot = 0xFFFF;
+
+	std::vector<MpqArchive *> archives;
+	std::vector<Slot> slots;
+
+	/** @brief Whether all of `MpqArchives` are indexed, otherwise lookups fall back to probing each archive. */
+	[[nodiscard]] bool valid() const
+	{
+		return !slots.empty() && archives.size() == MpqArchives.size();
+	}
+};
+
+MpqFileIndex FileIndex;
+
+size_t GetFileIndexSlot(const MpqArchive::FileNameHash &name, size_t mask)
+{
+	return (name.a ^ (name.b * 0x9E3779B1U)) & mask;
+}
+
 bool FindMpqFile(std::string_view filename, MpqArchive **archive, uint32_t *hashIndex)
 {
+	if (FileIndex.valid()) {
+		const MpqArchive::FileNameHash name = MpqArchive::HashFileName(filename);
+		const size_t mask = FileIndex.slots.size() - 1;
+		for (size_t i = GetFileIndexSlot(name, mask);; i = (i + 1) & mask) {
+			const MpqFileIndex::Slot &slot = FileIndex.slots[i];
+			if (slot.archive == MpqFileIndex::EmptySlot)
+				return false;
+			if (slot.name == name) {
+				*archive = FileIndex.archives[slot.archive];
+				*hashIndex = slot.hashIndex;
+				return true;
+			}
+		}
+	}
+
 	for (auto &[_, mpqArchive] : MpqArchives) {
 		uint32_t hash = mpqArchive.FindHash(filename);
 		if (hash != UINT32_MAX) {
@@ -213,6 +263,22 @@ AssetHandle OpenAsset(std::string_view filename, size_t &fileSize, bool threadsa
 	return OpenAsset(std::move(ref), threadsafe);
 }
 
+void ReadAssets(std::span<AssetRead> reads)
+{
+	// The SDL error is per thread, so each read keeps its own.
+	std::vector<std::optional<std::string>> errors(reads.size());
+	ParallelFor("ReadAssets", reads.size(), [&](size_t i) {
+		AssetRead &read = reads[i];
+		AssetHandle handle = OpenAsset(std::move(read.ref), /*threadsafe=*/true);
+		if (!handle.ok() || !handle.read(read.buffer, read.size))
+			errors[i] = handle.error();
+	});
+	for (size_t i = 0; i < reads.size(); ++i) {
+		if (errors[i].has_value())
+			FailedToOpenFileError(reads[i].path, *errors[i]);
+	}
+}
+
 SDL_IOStream *OpenAssetAsSdlRwOps(std::string_view filename, bool threadsafe)
 {
 #ifdef UNPACKED_MPQS
@@ -225,6 +291,20 @@ SDL_IOStream *OpenAssetAsSdlRwOps(std::string_view filename, bool threadsafe)
 #endif
 }
 
+SDL_IOStream *OpenAssetAsStreamingSdlRwOps(std::string_view filename)
+{
+#ifdef UNPACKED_MPQS
+	return OpenAssetAsSdlRwOps(filename, /*threadsafe=*/true);
+#else
+	AssetRef ref = FindAsset(filename);
+	if (!ref.ok())
+		return nullptr;
+	if (ref.archive != nullptr)
+		return SDL_RWops_FromMpqFileWithReadAhead(*ref.archive, ref.hashIndex, ref.filename);
+	return OpenAsset(std::move(ref), /*threadsafe=*/true).release();
+#endif
+}
+
 tl::expected<AssetData, std::string> LoadAsset(std::string_view path)
 {
 	AssetRef ref = FindAsset(path);
@@ -309,6 +389,8 @@ bool LoadMPQ(std::span<const std::string> paths, std::string_view mpqName, int p
 		archive = MpqArchive::Open(mpqAbsPath.c_str(), error);
 		if (archive.has_value()) {
 			LogVerbose("  Found: {} in {}", mpqName, path);
+			// Lets uncompressed files (e.g. music) be streamed straight from the mapping.
+			archive->MapIntoMemory();
 			auto [it, inserted] = MpqArchives.emplace(priority, *std::move(archive));
 			if (!inserted) {
 				LogError("MPQ with priority {} is already registered, skipping {}", priority, mpqName);
@@ -385,6 +467,58 @@ std::vector<std::string> GetMPQSearchPaths()
 
 } // namespace
 
+void RebuildAssetIndex()
+{
+#ifndef UNPACKED_MPQS
+	const auto start = std::chrono::steady_clock::now();
+	FileIndex = {};
+	if (MpqArchives.empty() || MpqArchives.size() >= MpqFileIndex::EmptySlot)
+		return;
+
+	std::vector<std::vector<MpqArchive::HashTableEntry>> entries;
+	entries.reserve(MpqArchives.size());
+	size_t numEntries = 0;
+	for (auto &[priority, archive] : MpqArchives) {
+		std::vector<MpqArchive::HashTableEntry> &archiveEntries = entries.emplace_back();
+		if (!archive.ReadHashTable(archiveEntries)) {
+			LogVerbose("Not indexing assets, unsupported MPQ layout (priority {})", priority);
+			return;
+		}
+		numEntries += archiveEntries.size();
+	}
+
+	// Keep the load factor at or below 50% so that most lookups hit on the first slot.
+	size_t numSlots = 16;
+	while (numSlots < numEntries * 2)
+		numSlots *= 2;
+	std::vector<MpqFileIndex::Slot> slots(numSlots, MpqFileIndex::Slot { {}, 0, MpqFileIndex::EmptySlot });
+	const size_t mask = numSlots - 1;
+
+	std::vector<MpqArchive *> archives;
+	archives.reserve(MpqArchives.size());
+	size_t numFiles = 0;
+	// Archives are ordered from the highest priority, files in lower priority archives are shadowed.
+	for (auto &[_, archive] : MpqArchives) {
+		const auto archiveIndex = static_cast<uint16_t>(archives.size());
+		archives.push_back(&archive);
+		for (const MpqArchive::HashTableEntry &entry : entries[archiveIndex]) {
+			size_t i = GetFileIndexSlot(entry.name, mask);
+			while (slots[i].archive != MpqFileIndex::EmptySlot && !(slots[i].name == entry.name))
+				i = (i + 1) & mask;
+			if (slots[i].archive != MpqFileIndex::EmptySlot)
+				continue;
+			slots[i] = MpqFileIndex::Slot { entry.name, entry.hashIndex, archiveIndex };
+			++numFiles;
+		}
+	}
+	FileIndex.archives = std::move(archives);
+	FileIndex.slots = std::move(slots);
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	LogVerbose("Indexed {} assets from {} MPQs in {}us", numFiles, FileIndex.archives.size(), elapsed.count());
+#endif
+}
+
 void LoadCoreArchives()
 {
 	auto paths = GetMPQSearchPaths();
@@ -399,6 +533,7 @@ void LoadCoreArchives()
 #endif
 	LoadMPQ(paths, "fonts", FontMpqPriority); // Extra fonts
 	HasHellfireMpq = FindMPQ(paths, "hellfire");
+	RebuildAssetIndex();
 }
 
 void LoadLanguageArchive()
@@ -408,6 +543,7 @@ void LoadLanguageArchive()
 	if (code != "en") {
 		LoadMPQ(GetMPQSearchPaths(), code, LangMpqPriority);
 	}
+	RebuildAssetIndex();
 }
 
 void LoadGameArchives()
@@ -448,6 +584,7 @@ void LoadGameArchives()
 	LoadMPQ(paths, "hfbard", 8110);
 	LoadMPQ(paths, "hfbarb", 8120);
 #endif
+	RebuildAssetIndex();
 }
 
 void LoadHellfireArchives()
@@ -467,6 +604,7 @@ void LoadHellfireArchives()
 	const bool hasMusic = LoadMPQ(paths, "hfmusic", 8200);
 	const bool hasVoice = LoadMPQ(paths, "hfvoice", 8500);
 #endif
+	RebuildAssetIndex();
 
 	if (!hasMonk || !hasMusic || !hasVoice)
 		DisplayFatalErrorAndExit(_("Some Hellfire MPQs are missing"), _("Not all Hellfire MPQs were found.\nPlease copy all the hf*.mpq files."));
@@ -484,6 +622,7 @@ void UnloadModArchives()
 			++it;
 		}
 	}
+	RebuildAssetIndex();
 #endif
 }
 
@@ -508,6 +647,7 @@ void LoadModArchives(std::span<const std::string_view> modnames)
 		LoadMPQ(paths, StrCat("mods" DIRECTORY_SEPARATOR_STR, modname), priority);
 		priority++;
 	}
+	RebuildAssetIndex();
 }
 
 } // namespace devilution
@@ -280,8 +280,31 @@ AssetHandle OpenAsset(AssetRef &&ref, bool threadsafe = false);
 AssetHandle OpenAsset(std::string_view filename, bool threadsafe = false);
 AssetHandle OpenAsset(std::string_view filename, size_t &fileSize, bool threadsafe = false);
 
+/** @brief A whole file for `ReadAssets` to read. */
+struct AssetRead {
+	AssetRef ref;
+	/** @brief For the error message. */
+	const char *path;
+	void *buffer;
+	size_t size;
+};
+
+/**
+ * @brief Reads whole files into their buffers, several at a time on different threads.
+ *
+ * Exits with an error if any of them can't be read.
+ */
+void ReadAssets(std::span<AssetRead> reads);
+
 SDL_IOStream *OpenAssetAsSdlRwOps(std::string_view filename, bool threadsafe = false);
 
+/**
+ * @brief Opens a file that is decoded while it plays, e.g. music, for reading from any thread.
+ *
+ * Files in an archive are read ahead of the decoder on a background thread.
+ */
+SDL_IOStream *OpenAssetAsStreamingSdlRwOps(std::string_view filename);
+
 struct AssetData {
 	std::unique_ptr<char[]> data;
 	size_t size;
@@ -307,6 +330,16 @@ constexpr int LangMpqPriority = 9100;
 constexpr int FontMpqPriority = 9200;
 extern bool HasHellfireMpq;
 
+/** @brief Directories with loose files that take precedence over the MPQ contents, i.e. the active mods. */
+extern std::vector<std::string> OverridePaths;
+
+/**
+ * @brief Rebuilds the name hash index used by `FindAsset` to look up files in `MpqArchives`.
+ *
+ * Called by the functions below, must also be called after modifying `MpqArchives` directly.
+ */
+void RebuildAssetIndex();
+
 void LoadCoreArchives();
 void LoadLanguageArchive();
 void LoadGameArchives();
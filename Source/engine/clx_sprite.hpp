@@ -28,13 +28,76 @@
 #include <cstring>
 #include <iterator>
 #include <memory>
+#include <utility>
 
 #include "appfat.h"
 #include "utils/endian_read.hpp"
 #include "utils/intrusive_optional.hpp"
+#include "utils/memory_stats.hpp"
 
 namespace devilution {
 
+/**
+ * @brief Called with the data of every owned sprite list or sheet when it is freed, on the thread that frees it.
+ *
+ * Set by the CLX renderer so that it can forget what it cached for the sprites, as their address may be reused.
+ */
+inline void (*OnClxDataFreed)(const uint8_t *data, size_t size) = nullptr;
+
+/**
+ * @brief Reports `data` to `OnClxDataFreed` when it goes away, moving it moves the report along.
+ *
+ * Meant as a member next to the buffer it reports.
+ */
+class TrackedClxData {
+public:
+	TrackedClxData() = default;
+
+	TrackedClxData(const uint8_t *data, size_t size)
+	    : data_(data)
+	    , size_(size)
+	{
+	}
+
+	TrackedClxData(TrackedClxData &&other) noexcept
+	    : data_(std::exchange(other.data_, nullptr))
+	    , size_(std::exchange(other.size_, 0))
+	{
+	}
+
+	TrackedClxData &operator=(TrackedClxData &&other) noexcept
+	{
+		if (this != &other) {
+			report();
+			data_ = std::exchange(other.data_, nullptr);
+			size_ = std::exchange(other.size_, 0);
+		}
+		return *this;
+	}
+
+	~TrackedClxData()
+	{
+		report();
+	}
+
+	/** @brief Stops reporting, for when the data is handed to another owner. */
+	void release()
+	{
+		data_ = nullptr;
+		size_ = 0;
+	}
+
+private:
+	void report() const
+	{
+		if (data_ != nullptr && OnClxDataFreed != nullptr)
+			OnClxDataFreed(data_, size_);
+	}
+
+	const uint8_t *data_ = nullptr;
+	size_t size_ = 0;
+};
+
 class OptionalClxSprite;
 
 /**
@@ -336,6 +399,8 @@ class OwnedClxSpriteList {
 public:
 	explicit OwnedClxSpriteList(std::unique_ptr<uint8_t[]> &&data)
 	    : data_(std::move(data))
+	    , tracked_(ClxSpriteList { data_.get() }.dataSize())
+	    , freed_(data_.get(), ClxSpriteList { data_.get() }.dataSize())
 	{
 		assert(data_ != nullptr);
 	}
@@ -368,6 +433,8 @@ private:
 	OwnedClxSpriteList() = default;
 
 	std::unique_ptr<uint8_t[]> data_;
+	TrackedMemory<MemoryTag::Sprites> tracked_;
+	TrackedClxData freed_;
 
 	friend class ClxSpriteList; // for implicit conversion
 	friend class OptionalOwnedClxSpriteList;
@@ -395,6 +462,8 @@ public:
 	OwnedClxSpriteSheet(std::unique_ptr<uint8_t[]> &&data, uint16_t numLists)
 	    : data_(std::move(data))
 	    , num_lists_(numLists)
+	    , tracked_(ClxSpriteSheet { data_.get(), numLists }.dataSize())
+	    , freed_(data_.get(), ClxSpriteSheet { data_.get(), numLists }.dataSize())
 	{
 		assert(data_ != nullptr);
 		assert(numLists > 0);
@@ -429,6 +498,8 @@ private:
 
 	std::unique_ptr<uint8_t[]> data_;
 	uint16_t num_lists_ = 0;
+	TrackedMemory<MemoryTag::Sprites> tracked_;
+	TrackedClxData freed_;
 
 	friend class ClxSpriteSheet; // for implicit conversion.
 	friend class OptionalOwnedClxSpriteSheet;
@@ -517,18 +588,24 @@ public:
 	explicit OwnedClxSpriteListOrSheet(std::unique_ptr<uint8_t[]> &&data, uint16_t numLists)
 	    : data_(std::move(data))
 	    , num_lists_(numLists)
+	    , tracked_(ClxSpriteListOrSheet { data_.get(), numLists }.dataSize())
+	    , freed_(data_.get(), ClxSpriteListOrSheet { data_.get(), numLists }.dataSize())
 	{
 	}
 
 	explicit OwnedClxSpriteListOrSheet(OwnedClxSpriteSheet &&sheet)
 	    : data_(std::move(sheet.data_))
 	    , num_lists_(sheet.num_lists_)
+	    , tracked_(std::move(sheet.tracked_))
+	    , freed_(std::move(sheet.freed_))
 	{
 	}
 
 	explicit OwnedClxSpriteListOrSheet(OwnedClxSpriteList &&list)
 	    : data_(std::move(list.data_))
 	    , num_lists_(0)
+	    , tracked_(std::move(list.tracked_))
+	    , freed_(std::move(list.freed_))
 	{
 	}
 
@@ -541,6 +618,9 @@ public:
 	[[nodiscard]] OwnedClxSpriteList list() &&
 	{
 		assert(num_lists_ == 0);
+		// The list counts the data from here on
+		tracked_ = {};
+		freed_.release();
 		return OwnedClxSpriteList { std::move(data_) };
 	}
 
@@ -553,6 +633,9 @@ public:
 	[[nodiscard]] OwnedClxSpriteSheet sheet() &&
 	{
 		assert(num_lists_ != 0);
+		// The sheet counts the data from here on
+		tracked_ = {};
+		freed_.release();
 		return OwnedClxSpriteSheet { std::move(data_), num_lists_ };
 	}
 
@@ -574,6 +657,8 @@ private:
 
 	std::unique_ptr<uint8_t[]> data_;
 	uint16_t num_lists_ = 0;
+	TrackedMemory<MemoryTag::Sprites> tracked_;
+	TrackedClxData freed_;
 
 	friend class ClxSpriteListOrSheet;
 	friend class OptionalOwnedClxSpriteListOrSheet;
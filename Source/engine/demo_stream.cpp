@@ -0,0 +1,147 @@
+#include "engine/demo_stream.hpp"
+
+#include "utils/endian_read.hpp"
+#include "utils/endian_stream.hpp"
+#include "utils/log.hpp"
+
+#ifdef DEMO_STREAM_COMPRESSION
+#include "encrypt.h"
+#endif
+
+namespace devilution {
+
+namespace {
+
+/** @brief Uncompressed size and stored size. */
+constexpr size_t BlockHeaderSize = 8;
+
+/** @brief Larger blocks than any writer produces are a sign of a damaged file. */
+constexpr uint32_t MaxBlockSize = 16 * DemoStreamBlockSize;
+
+} // namespace
+
+DemoStreamWriter::DemoStreamWriter(FILE *out)
+    : out_(out)
+{
+	buffer_.reserve(DemoStreamBlockSize);
+}
+
+void DemoStreamWriter::writeByte(uint8_t value)
+{
+	buffer_.push_back(static_cast<std::byte>(value));
+	if (buffer_.size() >= DemoStreamBlockSize)
+		flush();
+}
+
+void DemoStreamWriter::writeVarint(uint32_t value)
+{
+	while (value >= 0x80) {
+		writeByte(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	writeByte(static_cast<uint8_t>(value));
+}
+
+void DemoStreamWriter::writeSignedVarint(int32_t value)
+{
+	writeVarint((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+}
+
+void DemoStreamWriter::flush()
+{
+	if (buffer_.empty())
+		return;
+	const auto size = static_cast<uint32_t>(buffer_.size());
+	uint32_t storedSize = size;
+#ifdef DEMO_STREAM_COMPRESSION
+	// Returns the size unchanged if compressing didn't make the block any smaller.
+	storedSize = PkwareCompress(buffer_.data(), size);
+#endif
+	WriteLE32(out_, size);
+	WriteLE32(out_, storedSize);
+	LoggedFwrite(buffer_.data(), storedSize, out_);
+	buffer_.clear();
+}
+
+DemoStreamReader::DemoStreamReader(FILE *in)
+    : in_(in)
+{
+}
+
+bool DemoStreamReader::readBlock()
+{
+	block_.clear();
+	pos_ = 0;
+	if (corrupt_)
+		return false;
+
+	char header[BlockHeaderSize];
+	const size_t headerRead = std::fread(header, 1, sizeof(header), in_);
+	if (headerRead == 0 && std::feof(in_) != 0)
+		return false;
+	const uint32_t size = LoadLE32(&header[0]);
+	const uint32_t storedSize = LoadLE32(&header[4]);
+	if (headerRead != sizeof(header) || size == 0 || size > MaxBlockSize || storedSize > size) {
+		LogError("Demo: invalid block header");
+		corrupt_ = true;
+		return false;
+	}
+
+	block_.resize(size);
+	if (std::fread(block_.data(), storedSize, 1, in_) != 1) {
+		LogError("Demo: truncated block");
+		corrupt_ = true;
+		return false;
+	}
+	if (storedSize != size) {
+#ifdef DEMO_STREAM_COMPRESSION
+		if (PkwareDecompress(block_.data(), storedSize, size) != size) {
+			LogError("Demo: failed to decompress a block");
+			corrupt_ = true;
+			return false;
+		}
+#else
+		LogError("Demo: this build can't read compressed demos");
+		corrupt_ = true;
+		return false;
+#endif
+	}
+	return true;
+}
+
+bool DemoStreamReader::atEnd()
+{
+	if (pos_ < block_.size())
+		return false;
+	if (readBlock())
+		return false;
+	block_.clear();
+	return true;
+}
+
+uint8_t DemoStreamReader::readByte()
+{
+	if (atEnd())
+		return 0;
+	return static_cast<uint8_t>(block_[pos_++]);
+}
+
+uint32_t DemoStreamReader::readVarint()
+{
+	uint32_t value = 0;
+	for (unsigned shift = 0; shift < 32; shift += 7) {
+		const uint8_t byte = readByte();
+		value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+			break;
+	}
+	return value;
+}
+
+int32_t DemoStreamReader::readSignedVarint()
+{
+	const uint32_t value = readVarint();
+	return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+} // namespace devilution
@@ -0,0 +1,77 @@
+/**
+ * @file demo_stream.hpp
+ *
+ * The byte stream that holds the messages of a demo file from version 4 on.
+ *
+ * The stream is written in blocks, each one compressed when the build has a compressor and it helps.
+ * Integers are written with a variable length, so that the small values that make up most of a demo
+ * only take a byte.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace devilution {
+
+/** @brief Size of the uncompressed blocks written by `DemoStreamWriter`. */
+constexpr size_t DemoStreamBlockSize = 16 * 1024;
+
+class DemoStreamWriter {
+public:
+	/** @param out The file to write the blocks to, it is not closed by the writer. */
+	explicit DemoStreamWriter(FILE *out);
+
+	DemoStreamWriter(const DemoStreamWriter &) = delete;
+	DemoStreamWriter &operator=(const DemoStreamWriter &) = delete;
+
+	void writeByte(uint8_t value);
+
+	/** @brief 7 bits per byte, the high bit is set if more bytes follow. */
+	void writeVarint(uint32_t value);
+
+	/** @brief Zigzag encoded, so that small negative values are as short as small positive ones. */
+	void writeSignedVarint(int32_t value);
+
+	/** @brief Writes the buffered bytes as a block, must be called before closing the file. */
+	void flush();
+
+private:
+	FILE *out_;
+	std::vector<std::byte> buffer_;
+};
+
+class DemoStreamReader {
+public:
+	/** @param in The file to read the blocks from, it is not closed by the reader. */
+	explicit DemoStreamReader(FILE *in);
+
+	DemoStreamReader(const DemoStreamReader &) = delete;
+	DemoStreamReader &operator=(const DemoStreamReader &) = delete;
+
+	/** @brief Whether the whole stream has been read, or the rest of it can't be decoded. */
+	[[nodiscard]] bool atEnd();
+
+	/** @brief Whether reading stopped because of a block that can't be decoded. */
+	[[nodiscard]] bool isCorrupt() const
+	{
+		return corrupt_;
+	}
+
+	/** @return 0 past the end of the stream. */
+	uint8_t readByte();
+	uint32_t readVarint();
+	int32_t readSignedVarint();
+
+private:
+	bool readBlock();
+
+	FILE *in_;
+	std::vector<std::byte> block_;
+	size_t pos_ = 0;
+	bool corrupt_ = false;
+};
+
+} // namespace devilution
@@ -1,9 +1,16 @@
 #include "engine/demomode.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <cstdio>
 #include <limits>
 #include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_events.h>
@@ -19,7 +26,9 @@
 
 #include "controls/control_mode.hpp"
 #include "controls/plrctrls.h"
+#include "engine/demo_stream.hpp"
 #include "engine/events.hpp"
+#include "engine/render/scrollrt.h"
 #include "game_mode.hpp"
 #include "gmenu.h"
 #include "headless_mode.hpp"
@@ -34,6 +43,7 @@
 #include "utils/is_of.hpp"
 #include "utils/paths.h"
 #include "utils/str_cat.hpp"
+#include "utils/time_stats.hpp"
 
 namespace devilution {
 
@@ -44,7 +54,17 @@ namespace devilution {
 
 namespace {
 
-constexpr uint8_t Version = 3;
+/**
+ * @brief The version of the demos that are recorded.
+ *
+ * Version 4 stores the messages in a `DemoStreamWriter` stream, with variable length integers,
+ * mouse positions relative to the previous one and runs of the same GameTick or Rendering message
+ * stored as a `RepeatMessage`.
+ */
+constexpr uint8_t Version = 4;
+
+/** @brief Version 4 and later: the previous message is repeated the number of times that follows. */
+constexpr uint8_t RepeatMessage = 2;
 
 enum class LoadingStatus : uint8_t {
 	Success,
@@ -109,10 +129,22 @@ struct DemoMsg {
 	}
 };
 
+/** @brief The state of the version 4 encoding on either side of a stream. */
+struct CompactEncodingState {
+	uint16_t mouseX = 0;
+	uint16_t mouseY = 0;
+	/** @brief The previous message if it was a GameTick or Rendering message, which is what a repeat refers to. */
+	std::optional<DemoMsg> lastTickMessage;
+	uint32_t repeats = 0;
+};
+
 FILE *DemoFile;
 int DemoFileVersion;
 int DemoNumber = -1;
 std::optional<DemoMsg> CurrentDemoMessage;
+/** @brief The messages of version 4 and later demos. */
+std::optional<DemoStreamReader> DemoStream;
+CompactEncodingState PlaybackEncoding;
 
 bool Timedemo = false;
 int RecordNumber = -1;
@@ -146,10 +178,79 @@ struct {
 } DemoSettings;
 
 FILE *DemoRecording;
+std::optional<DemoStreamWriter> DemoRecordingStream;
+CompactEncodingState RecordingEncoding;
 uint32_t DemoModeLastTick = 0;
 
 int LogicTick = 0;
 uint32_t StartTime = 0;
+/** @brief Set when the hero at the end of playback doesn't match the reference. */
+bool Diverged = false;
+
+/** @brief Where to write the timedemo report, empty if not requested. */
+std::string TimedemoReportPath;
+/** @brief Number of game ticks at the start that are left out of the frame time statistics. */
+int TimedemoWarmupTicks = 0;
+
+struct TickTimes {
+	/** @brief From the end of the previous game tick, including input and the demo messages in between. */
+	uint32_t frameUs;
+	uint32_t simulationUs;
+	uint32_t renderUs;
+};
+
+std::vector<TickTimes> TimedemoTicks;
+std::chrono::steady_clock::time_point LastTickEnd;
+std::chrono::steady_clock::time_point TickSimulationStart;
+std::chrono::steady_clock::time_point TickRenderStart;
+
+uint32_t MicrosecondsBetween(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+{
+	return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count());
+}
+
+void ReportTimedemo(float seconds, std::string_view outcome)
+{
+	const size_t warmup = std::min(static_cast<size_t>(std::max(TimedemoWarmupTicks, 0)), TimedemoTicks.size());
+	std::vector<uint32_t> frameUs;
+	std::vector<uint32_t> simulationUs;
+	std::vector<uint32_t> renderUs;
+	for (size_t i = warmup; i < TimedemoTicks.size(); ++i) {
+		frameUs.push_back(TimedemoTicks[i].frameUs);
+		simulationUs.push_back(TimedemoTicks[i].simulationUs);
+		renderUs.push_back(TimedemoTicks[i].renderUs);
+	}
+	const TimeStats frame = ComputeTimeStats(std::move(frameUs));
+	const TimeStats simulation = ComputeTimeStats(std::move(simulationUs));
+	const TimeStats render = ComputeTimeStats(std::move(renderUs));
+	Log("Frame time: p50 {:.2f} ms, p95 {:.2f} ms, p99 {:.2f} ms, max {:.2f} ms (simulation p50 {:.2f} ms, render p50 {:.2f} ms)",
+	    frame.p50, frame.p95, frame.p99, frame.max, simulation.p50, render.p50);
+
+	if (TimedemoReportPath.empty())
+		return;
+	FILE *file = OpenFile(TimedemoReportPath.c_str(), "wb");
+	if (file == nullptr) {
+		LogError("Failed to open {} for writing", TimedemoReportPath);
+		return;
+	}
+	const std::string report = fmt::format(
+	    "{{\n"
+	    "  \"demo\": {},\n"
+	    "  \"headless\": {},\n"
+	    "  \"ticks\": {},\n"
+	    "  \"warmupTicks\": {},\n"
+	    "  \"seconds\": {:.3f},\n"
+	    "  \"fps\": {:.2f},\n"
+	    "  \"frameMs\": {},\n"
+	    "  \"simulationMs\": {},\n"
+	    "  \"renderMs\": {},\n"
+	    "  \"outcome\": \"{}\"\n"
+	    "}}\n",
+	    DemoNumber, HeadlessMode, TimedemoTicks.size(), warmup, seconds, LogicTick / seconds,
+	    FormatTimeStatsJson(frame), FormatTimeStatsJson(simulation), FormatTimeStatsJson(render), outcome);
+	std::fwrite(report.data(), 1, report.size(), file);
+	std::fclose(file);
+}
 
 uint16_t DemoGraphicsWidth = 640;
 uint16_t DemoGraphicsHeight = 480;
@@ -502,6 +603,7 @@ void LogDemoMessage(const DemoMsg &dmsg)
 
 void CloseDemoFile()
 {
+	DemoStream = std::nullopt;
 	if (DemoFile != nullptr) {
 		std::fclose(DemoFile);
 		DemoFile = nullptr;
@@ -524,12 +626,96 @@ LoadingStatus OpenDemoFile(int demoNumber)
 
 	gSaveNumber = ReadLE32(DemoFile);
 	ReadSettings(DemoFile, DemoFileVersion);
+	if (DemoFileVersion >= 4) {
+		DemoStream.emplace(DemoFile);
+		PlaybackEncoding = {};
+	}
 
 	return LoadingStatus::Success;
 }
 
+void ReadMousePosition(uint16_t &x, uint16_t &y)
+{
+	PlaybackEncoding.mouseX = static_cast<uint16_t>(PlaybackEncoding.mouseX + DemoStream->readSignedVarint());
+	PlaybackEncoding.mouseY = static_cast<uint16_t>(PlaybackEncoding.mouseY + DemoStream->readSignedVarint());
+	x = PlaybackEncoding.mouseX;
+	y = PlaybackEncoding.mouseY;
+}
+
+std::optional<DemoMsg> ReadCompactDemoMessage()
+{
+	DemoStreamReader &in = *DemoStream;
+	if (PlaybackEncoding.repeats > 0) {
+		PlaybackEncoding.repeats--;
+		DemoModeLastTick = SDL_GetTicks();
+		return PlaybackEncoding.lastTickMessage;
+	}
+	if (in.atEnd()) {
+		if (in.isCorrupt())
+			LogError("Demo: playback stopped early, the rest of the demo file is damaged");
+		CloseDemoFile();
+		return std::nullopt;
+	}
+
+	const uint8_t typeNum = in.readByte();
+	if (typeNum == RepeatMessage) {
+		PlaybackEncoding.repeats = in.readVarint();
+		if (PlaybackEncoding.repeats == 0 || PlaybackEncoding.lastTickMessage == std::nullopt)
+			app_fatal("Demo: repeat without a message to repeat");
+		PlaybackEncoding.repeats--;
+		DemoModeLastTick = SDL_GetTicks();
+		return PlaybackEncoding.lastTickMessage;
+	}
+
+	DemoModeLastTick = SDL_GetTicks();
+	if ((typeNum & 0b10000000) != 0) {
+		PlaybackEncoding.lastTickMessage = DemoMsg { DemoMsg::Rendering, static_cast<uint8_t>(typeNum & 0b01111111U), {} };
+		return PlaybackEncoding.lastTickMessage;
+	}
+	const uint8_t progressToNextGameTick = in.readByte();
+	if (typeNum == DemoMsg::GameTick || typeNum == DemoMsg::Rendering) {
+		PlaybackEncoding.lastTickMessage = DemoMsg { static_cast<DemoMsg::EventType>(typeNum), progressToNextGameTick, {} };
+		return PlaybackEncoding.lastTickMessage;
+	}
+
+	PlaybackEncoding.lastTickMessage = std::nullopt;
+	DemoMsg result { static_cast<DemoMsg::EventType>(typeNum), progressToNextGameTick, {} };
+	switch (typeNum) {
+	case DemoMsg::MouseMotionEvent:
+		ReadMousePosition(result.motion.x, result.motion.y);
+		break;
+	case DemoMsg::MouseButtonDownEvent:
+	case DemoMsg::MouseButtonUpEvent:
+		result.button.button = in.readByte();
+		ReadMousePosition(result.button.x, result.button.y);
+		result.button.mod = static_cast<uint16_t>(in.readVarint());
+		break;
+	case DemoMsg::MouseWheelEvent:
+		result.wheel.x = static_cast<int16_t>(in.readSignedVarint());
+		result.wheel.y = static_cast<int16_t>(in.readSignedVarint());
+		result.wheel.mod = static_cast<uint16_t>(in.readVarint());
+		break;
+	case DemoMsg::KeyDownEvent:
+	case DemoMsg::KeyUpEvent:
+		result.key.sym = in.readVarint();
+		result.key.mod = static_cast<uint16_t>(in.readVarint());
+		break;
+	case DemoMsg::QuitEvent:
+		break;
+	default:
+		if (typeNum < DemoMsg::MinCustomEvent) {
+			app_fatal(StrCat("Unknown event ", typeNum));
+		}
+		break;
+	}
+	return result;
+}
+
 std::optional<DemoMsg> ReadDemoMessage()
 {
+	if (DemoFileVersion >= 4)
+		return ReadCompactDemoMessage();
+
 	const uint8_t typeNum = DemoFileVersion >= 2 ? ReadByte(DemoFile) : ReadLE32(DemoFile);
 
 	if (std::feof(DemoFile) != 0) {
@@ -589,14 +775,47 @@ std::optional<DemoMsg> ReadDemoMessage()
 	}
 }
 
+void FlushRepeatedMessages()
+{
+	if (RecordingEncoding.repeats == 0)
+		return;
+	DemoRecordingStream->writeByte(RepeatMessage);
+	DemoRecordingStream->writeVarint(RecordingEncoding.repeats);
+	RecordingEncoding.repeats = 0;
+}
+
 void WriteDemoMsgHeader(DemoMsg::EventType type)
 {
+	if (type == DemoMsg::GameTick || type == DemoMsg::Rendering) {
+		const std::optional<DemoMsg> &last = RecordingEncoding.lastTickMessage;
+		// Runs of ticks without any input in between are common, e.g. while standing still or with vsync off.
+		if (last && last->type == type && last->progressToNextGameTick == ProgressToNextGameTick) {
+			RecordingEncoding.repeats++;
+			return;
+		}
+		FlushRepeatedMessages();
+		RecordingEncoding.lastTickMessage = DemoMsg { type, ProgressToNextGameTick, {} };
+	} else {
+		FlushRepeatedMessages();
+		RecordingEncoding.lastTickMessage = std::nullopt;
+	}
+
+	DemoStreamWriter &out = *DemoRecordingStream;
 	if (type == DemoMsg::Rendering && ProgressToNextGameTick <= 127) {
-		WriteByte(DemoRecording, ProgressToNextGameTick | 0b10000000);
+		out.writeByte(ProgressToNextGameTick | 0b10000000);
 		return;
 	}
-	WriteByte(DemoRecording, type);
-	WriteByte(DemoRecording, ProgressToNextGameTick);
+	out.writeByte(type);
+	out.writeByte(ProgressToNextGameTick);
+}
+
+void WriteMousePosition(uint16_t x, uint16_t y)
+{
+	// Consecutive positions are close to each other, so the differences are short.
+	DemoRecordingStream->writeSignedVarint(static_cast<int16_t>(x - RecordingEncoding.mouseX));
+	DemoRecordingStream->writeSignedVarint(static_cast<int16_t>(y - RecordingEncoding.mouseY));
+	RecordingEncoding.mouseX = x;
+	RecordingEncoding.mouseY = y;
 }
 
 } // namespace
@@ -813,8 +1032,7 @@ void RecordMessage(const SDL_Event &event, uint16_t modState)
 	case SDL_MOUSEMOTION:
 #endif
 		WriteDemoMsgHeader(DemoMsg::MouseMotionEvent);
-		WriteLE16(DemoRecording, event.motion.x);
-		WriteLE16(DemoRecording, event.motion.y);
+		WriteMousePosition(static_cast<uint16_t>(event.motion.x), static_cast<uint16_t>(event.motion.y));
 		break;
 #ifdef USE_SDL3
 	case SDL_EVENT_MOUSE_BUTTON_DOWN:
@@ -826,9 +1044,9 @@ void RecordMessage(const SDL_Event &event, uint16_t modState)
 #ifdef USE_SDL1
 		if (event.button.button == SDL_BUTTON_WHEELUP || event.button.button == SDL_BUTTON_WHEELDOWN) {
 			WriteDemoMsgHeader(DemoMsg::MouseWheelEvent);
-			WriteLE16(DemoRecording, 0);
-			WriteLE16(DemoRecording, event.button.button == SDL_BUTTON_WHEELUP ? 1 : -1);
-			WriteLE16(DemoRecording, modState);
+			DemoRecordingStream->writeSignedVarint(0);
+			DemoRecordingStream->writeSignedVarint(event.button.button == SDL_BUTTON_WHEELUP ? 1 : -1);
+			DemoRecordingStream->writeVarint(modState);
 		} else {
 #endif
 			WriteDemoMsgHeader(
@@ -839,10 +1057,9 @@ void RecordMessage(const SDL_Event &event, uint16_t modState)
 #endif
 			        ? DemoMsg::MouseButtonDownEvent
 			        : DemoMsg::MouseButtonUpEvent);
-			WriteByte(DemoRecording, event.button.button);
-			WriteLE16(DemoRecording, event.button.x);
-			WriteLE16(DemoRecording, event.button.y);
-			WriteLE16(DemoRecording, modState);
+			DemoRecordingStream->writeByte(event.button.button);
+			WriteMousePosition(static_cast<uint16_t>(event.button.x), static_cast<uint16_t>(event.button.y));
+			DemoRecordingStream->writeVarint(modState);
 #ifdef USE_SDL1
 		}
 #endif
@@ -871,8 +1088,8 @@ void RecordMessage(const SDL_Event &event, uint16_t modState)
 			app_fatal(StrCat("Mouse wheel event integer_x/y out of int16_t range. x=",
 			    wheelX, " y=", wheelY));
 		}
-		WriteLE16(DemoRecording, wheelX);
-		WriteLE16(DemoRecording, wheelY);
+		DemoRecordingStream->writeSignedVarint(wheelX);
+		DemoRecordingStream->writeSignedVarint(wheelY);
 #else
 		if (event.wheel.x < std::numeric_limits<int16_t>::min()
 		    || event.wheel.x > std::numeric_limits<int16_t>::max()
@@ -881,25 +1098,25 @@ void RecordMessage(const SDL_Event &event, uint16_t modState)
 			app_fatal(StrCat("Mouse wheel event x/y out of int16_t range. x=",
 			    event.wheel.x, " y=", event.wheel.y));
 		}
-		WriteLE16(DemoRecording, event.wheel.x);
-		WriteLE16(DemoRecording, event.wheel.y);
+		DemoRecordingStream->writeSignedVarint(event.wheel.x);
+		DemoRecordingStream->writeSignedVarint(event.wheel.y);
 #endif
-		WriteLE16(DemoRecording, modState);
+		DemoRecordingStream->writeVarint(modState);
 		break;
 #endif
 #ifdef USE_SDL3
 	case SDL_EVENT_KEY_DOWN:
 	case SDL_EVENT_KEY_UP:
 		WriteDemoMsgHeader(event.key.down ? DemoMsg::KeyDownEvent : DemoMsg::KeyUpEvent);
-		WriteLE32(DemoRecording, static_cast<uint32_t>(event.key.key));
-		WriteLE16(DemoRecording, static_cast<uint16_t>(event.key.mod));
+		DemoRecordingStream->writeVarint(static_cast<uint32_t>(event.key.key));
+		DemoRecordingStream->writeVarint(static_cast<uint16_t>(event.key.mod));
 		break;
 #else
 	case SDL_KEYDOWN:
 	case SDL_KEYUP:
 		WriteDemoMsgHeader(event.type == SDL_KEYDOWN ? DemoMsg::KeyDownEvent : DemoMsg::KeyUpEvent);
-		WriteLE32(DemoRecording, static_cast<uint32_t>(event.key.keysym.sym));
-		WriteLE16(DemoRecording, static_cast<uint16_t>(event.key.keysym.mod));
+		DemoRecordingStream->writeVarint(static_cast<uint32_t>(event.key.keysym.sym));
+		DemoRecordingStream->writeVarint(static_cast<uint16_t>(event.key.keysym.mod));
 		break;
 #endif
 #ifndef USE_SDL1
@@ -927,12 +1144,45 @@ void RecordMessage(const SDL_Event &event, uint16_t modState)
 	}
 }
 
+void InitTimedemoReport(std::string_view path, int warmupTicks)
+{
+	TimedemoReportPath = path;
+	TimedemoWarmupTicks = warmupTicks;
+}
+
+void NotifyTickSimulationStart()
+{
+	if (Timedemo)
+		TickSimulationStart = std::chrono::steady_clock::now();
+}
+
+void NotifyTickRenderStart()
+{
+	if (Timedemo)
+		TickRenderStart = std::chrono::steady_clock::now();
+}
+
+void NotifyTickEnd()
+{
+	if (!Timedemo)
+		return;
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	TimedemoTicks.push_back(TickTimes {
+	    MicrosecondsBetween(LastTickEnd, now),
+	    MicrosecondsBetween(TickSimulationStart, TickRenderStart),
+	    MicrosecondsBetween(TickRenderStart, now),
+	});
+	LastTickEnd = now;
+}
+
 void NotifyGameLoopStart()
 {
 	LogicTick = 0;
 
 	if (IsRunning()) {
 		StartTime = SDL_GetTicks();
+		TimedemoTicks.clear();
+		LastTickEnd = std::chrono::steady_clock::now();
 	}
 
 	if (IsRecording()) {
@@ -946,12 +1196,17 @@ void NotifyGameLoopStart()
 		WriteByte(DemoRecording, Version);
 		WriteLE32(DemoRecording, gSaveNumber);
 		WriteSettings(DemoRecording);
+		DemoRecordingStream.emplace(DemoRecording);
+		RecordingEncoding = {};
 	}
 }
 
 void NotifyGameLoopEnd()
 {
 	if (IsRecording()) {
+		FlushRepeatedMessages();
+		DemoRecordingStream->flush();
+		DemoRecordingStream = std::nullopt;
 		std::fclose(DemoRecording);
 		DemoRecording = nullptr;
 		if (CreateDemoReference)
@@ -961,27 +1216,68 @@ void NotifyGameLoopEnd()
 		CreateDemoReference = false;
 	}
 
-	if (IsRunning() && !HeadlessMode) {
+	if (IsRunning()) {
 		const float seconds = (SDL_GetTicks() - StartTime) / 1000.0F;
-		Log("{} frames, {:.2f} seconds: {:.1f} fps", LogicTick, seconds, LogicTick / seconds);
+		if (HeadlessMode) {
+			// Nothing was drawn, so this is the cost of the simulation alone.
+			Log("{} ticks, {:.2f} seconds: {:.1f} ticks/s", LogicTick, seconds, LogicTick / seconds);
+		} else {
+			Log("{} frames, {:.2f} seconds: {:.1f} fps", LogicTick, seconds, LogicTick / seconds);
+		}
+		const FloorCacheStats floorCacheStats = GetFloorCacheStats();
+		if (floorCacheStats.frames > 0) {
+			const uint64_t floorTiles = floorCacheStats.tilesReused + floorCacheStats.tilesRendered;
+			Log("Floor cache: {} frames ({} scrolled, {} rebuilt), {:.1f}% of floor tiles reused",
+			    floorCacheStats.frames, floorCacheStats.shiftedFrames, floorCacheStats.fullRebuilds,
+			    floorTiles > 0 ? 100.0 * floorCacheStats.tilesReused / floorTiles : 0.0);
+		}
+		const DisplayListStats displayListStats = GetDisplayListStats();
+		if (displayListStats.frames > 0) {
+			Log("Display list: {:.1f} draw commands per frame, {:.1f} drawn",
+			    static_cast<double>(displayListStats.commands) / displayListStats.frames,
+			    static_cast<double>(displayListStats.commandsDrawn) / displayListStats.frames);
+		}
+		const FloorOcclusionStats floorOcclusionStats = GetFloorOcclusionStats();
+		if (floorOcclusionStats.floorTiles > 0) {
+			Log("Floor occlusion: {:.1f}% of floor tiles hidden behind walls",
+			    100.0 * floorOcclusionStats.hiddenTiles / floorOcclusionStats.floorTiles);
+		}
+		const PanelCacheStats panelCacheStats = GetPanelCacheStats();
+		if (panelCacheStats.frames > 0) {
+			Log("Panel cache: {:.1f}% of panels restored, {:.2f} components drawn per restored panel",
+			    100.0 * panelCacheStats.restoredFrames / panelCacheStats.frames,
+			    panelCacheStats.restoredFrames > 0 ? static_cast<double>(panelCacheStats.componentsDrawn) / panelCacheStats.restoredFrames : 0.0);
+		}
 		gbRunGameResult = false;
 		gbRunGame = false;
 
 		HeroCompareResult compareResult = pfile_compare_hero_demo(DemoNumber, false);
+		std::string_view outcome;
 		switch (compareResult.status) {
 		case HeroCompareResult::ReferenceNotFound:
 			Log("Timedemo: No final comparison because reference is not present.");
+			outcome = "noReference";
 			break;
 		case HeroCompareResult::Same:
 			Log("Timedemo: Same outcome as initial run. :)");
+			outcome = "same";
 			break;
 		case HeroCompareResult::Difference:
 			Log("Timedemo: Different outcome than initial run. ;(\n{}", compareResult.message);
+			outcome = "different";
+			Diverged = true;
 			break;
 		}
+		if (Timedemo)
+			ReportTimedemo(seconds, outcome);
 	}
 }
 
+bool HasDiverged()
+{
+	return Diverged;
+}
+
 uint32_t SimulateMillisecondsSinceStartup()
 {
 	return LogicTick * 50;
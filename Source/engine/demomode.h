@@ -6,6 +6,7 @@
 #pragma once
 
 #include <cstdint>
+#include <string_view>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_events.h>
@@ -22,6 +23,13 @@ void InitPlayBack(int demoNumber, bool timedemo);
 void InitRecording(int recordNumber, bool createDemoReference);
 void OverrideOptions();
 
+/**
+ * @brief Writes the frame time statistics of a timedemo as JSON to `path` once it finishes.
+ *
+ * @param warmupTicks Number of game ticks at the start that are left out of the statistics.
+ */
+void InitTimedemoReport(std::string_view path, int warmupTicks);
+
 bool IsRunning();
 bool IsRecording();
 
@@ -33,6 +41,14 @@ void RecordMessage(const SDL_Event &event, uint16_t modState);
 void NotifyGameLoopStart();
 void NotifyGameLoopEnd();
 
+/** @brief Mark the phases of a game tick, timed during a timedemo. */
+void NotifyTickSimulationStart();
+void NotifyTickRenderStart();
+void NotifyTickEnd();
+
+/** @brief Whether a played back demo ended with a different hero than its reference. */
+bool HasDiverged();
+
 uint32_t SimulateMillisecondsSinceStartup();
 #else
 inline void OverrideOptions()
@@ -66,6 +82,19 @@ inline void NotifyGameLoopStart()
 inline void NotifyGameLoopEnd()
 {
 }
+inline void NotifyTickSimulationStart()
+{
+}
+inline void NotifyTickRenderStart()
+{
+}
+inline void NotifyTickEnd()
+{
+}
+inline bool HasDiverged()
+{
+	return false;
+}
 inline uint32_t SimulateMillisecondsSinceStartup()
 {
 	return 0;
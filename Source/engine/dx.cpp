@@ -5,7 +5,10 @@
  */
 #include "engine/dx.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <optional>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_rect.h>
@@ -19,11 +22,14 @@
 
 #include "controls/control_mode.hpp"
 #include "controls/plrctrls.h"
+#include "engine/frame_pacer.hpp"
 #include "engine/render/primitive_render.hpp"
+#include "engine/render/text_render.hpp"
 #include "headless_mode.hpp"
 #include "init.hpp"
 #include "options.h"
 #include "utils/display.h"
+#include "utils/frame_profiler.hpp"
 #include "utils/log.hpp"
 #include "utils/sdl_wrap.h"
 
@@ -42,6 +48,10 @@ SDL_Renderer *renderer;
 #ifndef USE_SDL1
 SDLTextureUniquePtr texture;
 #endif
+#ifdef USE_SDL3
+/** 8-bit renderer texture that is mapped through `Palette` by the renderer */
+SDLTextureUniquePtr IndexedTexture;
+#endif
 
 /** Currently active palette */
 SDLPaletteUniquePtr Palette;
@@ -53,6 +63,71 @@ SDLSurfaceUniquePtr RendererTextureSurface;
 SDL_Surface *PalSurface;
 namespace {
 SDLSurfaceUniquePtr PinnedPalSurface;
+
+#ifdef USE_SDL3
+/** Whether the renderer can't create `IndexedTexture`. */
+bool IndexedTextureUnsupported;
+
+/** Whether `PalSurface` is presented through `IndexedTexture`, i.e. nothing was drawn to the output surface since the last `BltFast`. */
+bool PresentIndexedTexture;
+
+/** Whether all of `IndexedTexture` must be uploaded, because something else was presented since. */
+bool IndexedTextureStale = true;
+
+/** The part of `PalSurface` that was blitted since `IndexedTexture` was last uploaded. */
+std::optional<SDL_Rect> IndexedTextureDirty;
+
+bool UseIndexedTexture()
+{
+	if (renderer == nullptr || RenderDirectlyToOutputSurface || IndexedTextureUnsupported)
+		return false;
+	if (IndexedTexture != nullptr)
+		return true;
+
+	IndexedTexture = SDLTextureUniquePtr { SDL_CreateTexture(renderer, SDL_PIXELFORMAT_INDEX8, SDL_TEXTUREACCESS_STREAMING, PalSurface->w, PalSurface->h) };
+	// The palette colors may have any alpha, the frame is opaque.
+	if (IndexedTexture == nullptr
+	    || !SDL_SetTexturePalette(IndexedTexture.get(), Palette.get())
+	    || !SDL_SetTextureBlendMode(IndexedTexture.get(), SDL_BLENDMODE_NONE)) {
+		Log("Indexed textures are not supported, converting frames on the CPU: {}", SDL_GetError());
+		SDL_ClearError();
+		IndexedTexture = nullptr;
+		IndexedTextureUnsupported = true;
+		return false;
+	}
+	IndexedTextureStale = true;
+	return true;
+}
+
+void AddIndexedTextureDirtyRect(const SDL_Rect *rect)
+{
+	const SDL_Rect bounds { 0, 0, PalSurface->w, PalSurface->h };
+	SDL_Rect clipped = bounds;
+	if (rect != nullptr && !SDL_GetRectIntersection(rect, &bounds, &clipped))
+		return;
+	if (IndexedTextureDirty) {
+		const SDL_Rect dirty = *IndexedTextureDirty;
+		SDL_GetRectUnion(&dirty, &clipped, &*IndexedTextureDirty);
+	} else {
+		IndexedTextureDirty = clipped;
+	}
+}
+
+void UploadIndexedTexture()
+{
+	if (IndexedTextureStale) {
+		IndexedTextureDirty = SDL_Rect { 0, 0, PalSurface->w, PalSurface->h };
+		IndexedTextureStale = false;
+	}
+	if (!IndexedTextureDirty)
+		return;
+	const SDL_Rect &rect = *IndexedTextureDirty;
+	const auto *pixels = static_cast<const uint8_t *>(PalSurface->pixels) + (static_cast<ptrdiff_t>(rect.y) * PalSurface->pitch) + rect.x;
+	if (!SDL_UpdateTexture(IndexedTexture.get(), &rect, pixels, PalSurface->pitch)) ErrSdl();
+	IndexedTextureDirty = std::nullopt;
+}
+#endif
+
 } // namespace
 
 /** Whether we render directly to the screen surface, i.e. `PalSurface == GetOutputSurface()` */
@@ -81,23 +156,6 @@ bool CanRenderDirectlyToOutputSurface()
 #endif
 }
 
-/**
- * @brief Limit FPS to avoid high CPU load, use when v-sync isn't available
- */
-void LimitFrameRate()
-{
-	if (*GetOptions().Graphics.frameRateControl != FrameRateControl::CPUSleep)
-		return;
-	static uint32_t frameDeadline;
-	const uint32_t tc = SDL_GetTicks() * 1000;
-	uint32_t v = 0;
-	if (frameDeadline > tc) {
-		v = tc % refreshDelay;
-		SDL_Delay((v / 1000) + 1); // ceil
-	}
-	frameDeadline = tc + v + refreshDelay;
-}
-
 } // namespace
 
 void dx_init()
@@ -130,6 +188,9 @@ void dx_cleanup()
 	RendererTextureSurface = nullptr;
 #ifndef USE_SDL1
 	texture = nullptr;
+#ifdef USE_SDL3
+	IndexedTexture = nullptr;
+#endif
 	FreeVirtualGamepadTextures();
 	if (*GetOptions().Graphics.upscale)
 		SDL_DestroyRenderer(renderer);
@@ -170,9 +231,24 @@ void BltFast(SDL_Rect *srcRect, SDL_Rect *dstRect)
 {
 	if (RenderDirectlyToOutputSurface)
 		return;
+#ifdef USE_SDL3
+	// The renderer maps the 8-bit frame through the palette, only the blitted part has to be uploaded.
+	if (!HeadlessMode && UseIndexedTexture()) {
+		PresentIndexedTexture = true;
+		AddIndexedTextureDirtyRect(srcRect);
+		return;
+	}
+#endif
 	Blit(PalSurface, srcRect, dstRect);
 }
 
+void OutputSurfaceUpdated()
+{
+#ifdef USE_SDL3
+	PresentIndexedTexture = false;
+#endif
+}
+
 void Blit(SDL_Surface *src, SDL_Rect *srcRect, SDL_Rect *dstRect)
 {
 	if (HeadlessMode)
@@ -228,40 +304,90 @@ void Blit(SDL_Surface *src, SDL_Rect *srcRect, SDL_Rect *dstRect)
 #endif
 }
 
+#ifndef USE_SDL1
+namespace {
+
+/**
+ * @brief Presents the renderer texture, scaling its colors by `colorMod / 255`.
+ */
+void PresentTexture(SDL_Surface *surface, bool updateTexture, uint8_t colorMod)
+{
+#ifdef USE_SDL3
+	SDL_Texture *frame = texture.get();
+	if (PresentIndexedTexture && UseIndexedTexture()) {
+		frame = IndexedTexture.get();
+		if (updateTexture) UploadIndexedTexture();
+	} else {
+		IndexedTextureStale = true;
+		if (updateTexture && !SDL_UpdateTexture(frame, nullptr, surface->pixels, surface->pitch)) ErrSdl();
+	}
+	if (!SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255)) ErrSdl();
+	if (!SDL_RenderClear(renderer)) ErrSdl();
+	if (!SDL_SetTextureColorMod(frame, colorMod, colorMod, colorMod)) ErrSdl();
+	if (!SDL_RenderTexture(renderer, frame, nullptr, nullptr)) ErrSdl();
+#else
+	if (SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255) <= -1) ErrSdl();
+	if (SDL_RenderClear(renderer) <= -1) ErrSdl();
+	if (updateTexture && SDL_UpdateTexture(texture.get(), nullptr, surface->pixels, surface->pitch) <= -1) ErrSdl();
+	if (SDL_SetTextureColorMod(texture.get(), colorMod, colorMod, colorMod) <= -1) ErrSdl();
+	if (SDL_RenderCopy(renderer, texture.get(), nullptr, nullptr) <= -1) ErrSdl();
+#endif
+
+	if (ControlMode == ControlTypes::VirtualGamepad) {
+		RenderVirtualGamepad(renderer);
+	}
+	SDL_RenderPresent(renderer);
+	FramePacerEndFrame();
+}
+
+} // namespace
+#endif
+
+bool CanFadeOnPresent()
+{
+#ifndef USE_SDL1
+	return !HeadlessMode && renderer != nullptr && texture != nullptr;
+#else
+	return false;
+#endif
+}
+
+bool RenderPresentFaded(unsigned fadeval, bool updateFrame)
+{
+	if (!CanFadeOnPresent())
+		return false;
+
+	if (!gbActive) {
+		FramePacerEndFrame();
+		return false;
+	}
+
+#ifndef USE_SDL1
+	PresentTexture(GetOutputSurface(), updateFrame, static_cast<uint8_t>(std::min(fadeval, 255U)));
+	return true;
+#else
+	return false;
+#endif
+}
+
 void RenderPresent()
 {
+	DVL_PROFILE_ZONE("RenderPresent");
 	if (HeadlessMode)
 		return;
 
+	TrimFonts();
+
 	SDL_Surface *surface = GetOutputSurface();
 
 	if (!gbActive) {
-		LimitFrameRate();
+		FramePacerEndFrame();
 		return;
 	}
 
 #ifndef USE_SDL1
 	if (renderer != nullptr) {
-#ifdef USE_SDL3
-		if (!SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255)) ErrSdl();
-		if (!SDL_RenderClear(renderer)) ErrSdl();
-		if (!SDL_UpdateTexture(texture.get(), nullptr, surface->pixels, surface->pitch)) ErrSdl();
-		if (!SDL_RenderTexture(renderer, texture.get(), nullptr, nullptr)) ErrSdl();
-#else
-		if (SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255) <= -1) ErrSdl();
-		if (SDL_RenderClear(renderer) <= -1) ErrSdl();
-		if (SDL_UpdateTexture(texture.get(), nullptr, surface->pixels, surface->pitch) <= -1) ErrSdl();
-		if (SDL_RenderCopy(renderer, texture.get(), nullptr, nullptr) <= -1) ErrSdl();
-#endif
-
-		if (ControlMode == ControlTypes::VirtualGamepad) {
-			RenderVirtualGamepad(renderer);
-		}
-		SDL_RenderPresent(renderer);
-
-		if (*GetOptions().Graphics.frameRateControl != FrameRateControl::VerticalSync) {
-			LimitFrameRate();
-		}
+		PresentTexture(surface, /*updateTexture=*/true, 255);
 	} else {
 		if (ControlMode == ControlTypes::VirtualGamepad) {
 			RenderVirtualGamepad(surface);
@@ -275,7 +401,7 @@ void RenderPresent()
 
 		if (RenderDirectlyToOutputSurface)
 			PalSurface = GetOutputSurface();
-		LimitFrameRate();
+		FramePacerEndFrame();
 	}
 #else
 	if (SDL_Flip(surface) <= -1) {
@@ -283,7 +409,7 @@ void RenderPresent()
 	}
 	if (RenderDirectlyToOutputSurface)
 		PalSurface = GetOutputSurface();
-	LimitFrameRate();
+	FramePacerEndFrame();
 #endif
 }
 
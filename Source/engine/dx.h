@@ -28,6 +28,25 @@ void dx_cleanup();
 void CreateBackBuffer();
 void BltFast(SDL_Rect *srcRect, SDL_Rect *dstRect);
 void Blit(SDL_Surface *src, SDL_Rect *srcRect, SDL_Rect *dstRect);
+
+/**
+ * @brief Call this after drawing to `GetOutputSurface()` directly, so that it is presented instead of `PalSurface`.
+ */
+void OutputSurfaceUpdated();
 void RenderPresent();
 
+/**
+ * @brief Whether `RenderPresentFaded` is available, i.e. the frame is presented through a renderer texture.
+ */
+bool CanFadeOnPresent();
+
+/**
+ * @brief Presents the frame with its colors scaled by `fadeval / 256` without changing the palette.
+ *
+ * @param fadeval 0 - completely black, 256 - no effect.
+ * @param updateFrame Whether to upload the output surface first, otherwise the last uploaded frame is presented again.
+ * @return Whether the frame was presented.
+ */
+bool RenderPresentFaded(unsigned fadeval, bool updateFrame);
+
 } // namespace devilution
@@ -0,0 +1,112 @@
+/**
+ * @file frame_pacer.cpp
+ *
+ * Implementation of the frame pacer.
+ */
+#include "engine/frame_pacer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#ifdef USE_SDL3
+#include <SDL3/SDL_timer.h>
+#else
+#include <SDL.h>
+#endif
+
+#include "options.h"
+#include "utils/display.h"
+
+namespace devilution {
+
+namespace {
+
+constexpr uint64_t StatsWindowUs = 1000000;
+
+/** @brief Caps the oversleep estimate, as with coarser timers than that spinning would take up most of the frame. */
+constexpr uint64_t MaxOversleepUs = 4000;
+
+uint64_t NextFrameUs;
+uint64_t OversleepUs = 1000;
+
+uint64_t LastFrameUs;
+uint64_t WindowStartUs;
+uint32_t WindowFrames;
+double WindowSumUs;
+double WindowSumSquaresUs;
+FrameTimeStats Stats;
+
+uint64_t NowUs()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void WaitUntil(uint64_t deadlineUs)
+{
+	uint64_t now = NowUs();
+	// Sleeps are only precise to the millisecond at best, the last part is spun
+	while (deadlineUs > now + OversleepUs + 1000) {
+		const auto sleepMs = static_cast<uint32_t>((deadlineUs - now - OversleepUs) / 1000);
+		SDL_Delay(sleepMs);
+		const uint64_t after = NowUs();
+		const uint64_t slept = after - now;
+		const uint64_t overslept = slept > sleepMs * 1000ULL ? slept - sleepMs * 1000ULL : 0;
+		OversleepUs = (OversleepUs * 7 + std::min(overslept, MaxOversleepUs)) / 8;
+		now = after;
+	}
+	while (now < deadlineUs)
+		now = NowUs();
+}
+
+void RecordFrameTime(uint64_t now)
+{
+	if (LastFrameUs != 0) {
+		const auto frameUs = static_cast<double>(now - LastFrameUs);
+		WindowFrames++;
+		WindowSumUs += frameUs;
+		WindowSumSquaresUs += frameUs * frameUs;
+	}
+	LastFrameUs = now;
+
+	if (now - WindowStartUs < StatsWindowUs)
+		return;
+	if (WindowFrames > 0) {
+		const double mean = WindowSumUs / WindowFrames;
+		const double variance = std::max(WindowSumSquaresUs / WindowFrames - mean * mean, 0.0);
+		Stats.meanUs = static_cast<uint32_t>(mean);
+		Stats.stdevUs = static_cast<uint32_t>(std::sqrt(variance));
+	}
+	Stats.oversleepUs = static_cast<uint32_t>(OversleepUs);
+	WindowStartUs = now;
+	WindowFrames = 0;
+	WindowSumUs = 0;
+	WindowSumSquaresUs = 0;
+}
+
+} // namespace
+
+void FramePacerEndFrame()
+{
+	if (*GetOptions().Graphics.frameRateControl == FrameRateControl::CPUSleep) {
+		const uint64_t now = NowUs();
+		const auto frameUs = static_cast<uint64_t>(refreshDelay);
+		NextFrameUs += frameUs;
+		if (NextFrameUs <= now) {
+			// Late, the next frame gets a whole frame rather than trying to catch up
+			NextFrameUs = now;
+		} else {
+			// A deadline left from before the refresh rate went up is at most a frame away
+			NextFrameUs = std::min(NextFrameUs, now + frameUs);
+			WaitUntil(NextFrameUs);
+		}
+	}
+	RecordFrameTime(NowUs());
+}
+
+FrameTimeStats GetFrameTimeStats()
+{
+	return Stats;
+}
+
+} // namespace devilution
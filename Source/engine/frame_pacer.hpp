@@ -0,0 +1,33 @@
+/**
+ * @file frame_pacer.hpp
+ *
+ * Paces the frames to the refresh rate by sleeping, for when v-sync isn't available,
+ * and measures how evenly the frames are presented.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace devilution {
+
+struct FrameTimeStats {
+	/** @brief Mean time between presented frames over the last second, in microseconds. */
+	uint32_t meanUs;
+	/** @brief Standard deviation of the time between presented frames over the last second, in microseconds. */
+	uint32_t stdevUs;
+	/** @brief How much longer than asked for a sleep currently takes, in microseconds. */
+	uint32_t oversleepUs;
+};
+
+/**
+ * @brief Called after each present. With `FrameRateControl::CPUSleep`, waits until the next frame is due.
+ *
+ * Sleeps for as long as it can without missing the deadline, based on how much the sleeps have overshot so far,
+ * and spins for the rest.
+ */
+void FramePacerEndFrame();
+
+/** @brief The frame times of the last complete second. */
+FrameTimeStats GetFrameTimeStats();
+
+} // namespace devilution
@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 
 #ifdef DEBUG_CEL_TO_CL2_SIZE
@@ -21,6 +22,7 @@
 #else
 #include "engine/load_file.hpp"
 #include "utils/cel_to_clx.hpp"
+#include "utils/clx_cache.hpp"
 #endif
 
 namespace devilution {
@@ -37,7 +39,14 @@ tl::expected<OwnedClxSpriteListOrSheet, std::string> LoadCelListOrSheetWithStatu
 #ifdef DEBUG_CEL_TO_CL2_SIZE
 	std::cout << path;
 #endif
-	return CelToClx(data.get(), size, widthOrWidths);
+	if (widthOrWidths.HoldsPointer())
+		return CelToClx(data.get(), size, widthOrWidths);
+	const ClxCacheKey key = GetClxCacheKey(path, data.get(), size, ClxConverter::Cel, widthOrWidths.AsValue());
+	if (std::optional<OwnedClxSpriteListOrSheet> cached = LoadCachedClx(key); cached)
+		return *std::move(cached);
+	OwnedClxSpriteListOrSheet result = CelToClx(data.get(), size, widthOrWidths);
+	StoreCachedClx(key, result);
+	return result;
 #endif
 }
 
@@ -1,8 +1,11 @@
 #include "engine/load_cl2.hpp"
 
 #include <cstdint>
+#include <cstring>
 #include <memory>
+#include <optional>
 #include <utility>
+#include <vector>
 
 #include <expected.hpp>
 
@@ -15,10 +18,67 @@
 #else
 #include "engine/load_file.hpp"
 #include "utils/cl2_to_clx.hpp"
+#include "utils/clx_cache.hpp"
+#include "utils/endian_read.hpp"
+#include "utils/endian_write.hpp"
+#include "utils/task_graph.hpp"
 #endif
 
 namespace devilution {
 
+#ifndef UNPACKED_MPQS
+namespace {
+
+/** @brief Smaller sheets are converted on one thread, starting more would take longer than they save. */
+constexpr size_t MinParallelCl2SheetSize = 256 * 1024;
+
+/**
+ * @brief Converts the lists of a sheet on different threads, each into a buffer of its own, and then joins them.
+ */
+OwnedClxSpriteListOrSheet Cl2ToClxParallel(std::unique_ptr<uint8_t[]> &&data, size_t size, uint16_t width)
+{
+	const uint16_t numLists = GetCl2SheetListCount(data.get(), size);
+	if (numLists <= 1 || size < MinParallelCl2SheetSize)
+		return Cl2ToClx(std::move(data), size, PointerOrValue<uint16_t> { width });
+
+	std::vector<std::vector<uint8_t>> lists(numLists);
+	ParallelFor("Cl2ToClx", numLists, [&](size_t i) {
+		std::vector<uint8_t> pixels;
+		pixels.reserve(4096);
+		Cl2ListToClx(&data[LoadLE32(&data[4 * i])], PointerOrValue<uint16_t> { width }, lists[i], pixels);
+	});
+
+	const size_t headerSize = 4 * static_cast<size_t>(numLists);
+	size_t clxSize = headerSize;
+	for (const std::vector<uint8_t> &list : lists)
+		clxSize += list.size();
+	data = nullptr;
+	data = std::unique_ptr<uint8_t[]>(new uint8_t[clxSize]);
+	size_t offset = headerSize;
+	for (size_t i = 0; i < numLists; ++i) {
+		WriteLE32(&data[4 * i], static_cast<uint32_t>(offset));
+		memcpy(&data[offset], lists[i].data(), lists[i].size());
+		offset += lists[i].size();
+	}
+	return OwnedClxSpriteListOrSheet { std::move(data), numLists };
+}
+
+} // namespace
+
+OwnedClxSpriteListOrSheet Cl2ToClxCached(std::string_view path, std::unique_ptr<uint8_t[]> &&data, size_t size, PointerOrValue<uint16_t> widthOrWidths)
+{
+	// The number of frames, and thus of widths, is only known after conversion.
+	if (widthOrWidths.HoldsPointer())
+		return Cl2ToClx(std::move(data), size, widthOrWidths);
+	const ClxCacheKey key = GetClxCacheKey(path, data.get(), size, ClxConverter::Cl2, widthOrWidths.AsValue());
+	if (std::optional<OwnedClxSpriteListOrSheet> cached = LoadCachedClx(key); cached)
+		return *std::move(cached);
+	OwnedClxSpriteListOrSheet result = Cl2ToClxParallel(std::move(data), size, widthOrWidths.AsValue());
+	StoreCachedClx(key, result);
+	return result;
+}
+#endif
+
 tl::expected<OwnedClxSpriteListOrSheet, std::string> LoadCl2ListOrSheetWithStatus(const char *pszName, PointerOrValue<uint16_t> widthOrWidths)
 {
 	char path[MaxMpqPathSize];
@@ -28,7 +88,7 @@ tl::expected<OwnedClxSpriteListOrSheet, std::string> LoadCl2ListOrSheetWithStatu
 #else
 	size_t size;
 	ASSIGN_OR_RETURN(std::unique_ptr<uint8_t[]> data, LoadFileInMemWithStatus<uint8_t>(path, &size));
-	return Cl2ToClx(std::move(data), size, widthOrWidths);
+	return Cl2ToClxCached(path, std::move(data), size, widthOrWidths);
 #endif
 }
 
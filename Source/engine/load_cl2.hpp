@@ -22,6 +22,9 @@
 #ifdef UNPACKED_MPQS
 #define DEVILUTIONX_CL2_EXT ".clx"
 #else
+#include <memory>
+#include <string_view>
+
 #include "utils/cl2_to_clx.hpp"
 
 #define DEVILUTIONX_CL2_EXT ".cl2"
@@ -32,12 +35,18 @@ namespace devilution {
 tl::expected<OwnedClxSpriteListOrSheet, std::string> LoadCl2ListOrSheetWithStatus(const char *pszName, PointerOrValue<uint16_t> widthOrWidths);
 OwnedClxSpriteListOrSheet LoadCl2ListOrSheet(const char *pszName, PointerOrValue<uint16_t> widthOrWidths);
 
+#ifndef UNPACKED_MPQS
+/**
+ * @brief Converts CL2 data to CLX, reusing the result of an earlier conversion of the same data if it is cached on disk.
+ */
+OwnedClxSpriteListOrSheet Cl2ToClxCached(std::string_view path, std::unique_ptr<uint8_t[]> &&data, size_t size, PointerOrValue<uint16_t> widthOrWidths);
+#endif
+
 template <size_t MaxCount>
 tl::expected<OwnedClxSpriteSheet, std::string> LoadMultipleCl2Sheet(tl::function_ref<const char *(size_t)> filenames, size_t count, uint16_t width)
 {
 	StaticVector<std::array<char, MaxMpqPathSize>, MaxCount> paths;
-	StaticVector<AssetRef, MaxCount> files;
-	StaticVector<size_t, MaxCount> fileSizes;
+	StaticVector<AssetRead, MaxCount> files;
 	const size_t sheetHeaderSize = 4 * count;
 	size_t totalSize = sheetHeaderSize;
 	for (size_t i = 0; i < count; ++i) {
@@ -47,13 +56,12 @@ tl::expected<OwnedClxSpriteSheet, std::string> LoadMultipleCl2Sheet(tl::function
 			memcpy(paths.back().data(), path, strlen(path) + 1);
 		}
 		const char *path = paths.back().data();
-		files.emplace_back(FindAsset(path));
-		if (!files.back().ok()) {
-			FailedToOpenFileError(path, files.back().error());
+		files.emplace_back(AssetRead { FindAsset(path), path, nullptr, 0 });
+		if (!files.back().ref.ok()) {
+			FailedToOpenFileError(path, files.back().ref.error());
 		}
-		const size_t size = files.back().size();
-		fileSizes.emplace_back(size);
-		totalSize += size;
+		files.back().size = files.back().ref.size();
+		totalSize += files.back().size;
 	}
 	auto data = std::unique_ptr<uint8_t[]> { new uint8_t[totalSize] };
 #ifndef UNPACKED_MPQS
@@ -61,18 +69,15 @@ tl::expected<OwnedClxSpriteSheet, std::string> LoadMultipleCl2Sheet(tl::function
 #endif
 	size_t accumulatedSize = sheetHeaderSize;
 	for (size_t i = 0; i < count; ++i) {
-		const size_t size = fileSizes[i];
-		AssetHandle handle = OpenAsset(std::move(files[i]));
-		if (!handle.ok() || !handle.read(&data[accumulatedSize], size)) {
-			FailedToOpenFileError(paths[i].data(), handle.error());
-		}
+		files[i].buffer = &data[accumulatedSize];
 		WriteLE32(&data[i * 4], static_cast<uint32_t>(accumulatedSize));
-		accumulatedSize += size;
+		accumulatedSize += files[i].size;
 	}
+	ReadAssets({ files.data(), files.size() });
 #ifdef UNPACKED_MPQS
 	return OwnedClxSpriteSheet { std::move(data), static_cast<uint16_t>(count) };
 #else
-	return Cl2ToClx(std::move(data), accumulatedSize, frameWidth).sheet();
+	return Cl2ToClxCached(paths[0].data(), std::move(data), accumulatedSize, frameWidth).sheet();
 #endif
 }
 
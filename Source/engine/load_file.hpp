@@ -12,6 +12,7 @@
 #include "engine/assets.hpp"
 #include "headless_mode.hpp"
 #include "mpq/mpq_common.hpp"
+#include "utils/bump_arena.hpp"
 #include "utils/static_vector.hpp"
 #include "utils/str_cat.hpp"
 
@@ -120,7 +121,35 @@ std::unique_ptr<T[]> LoadFileInMem(const char *path, std::size_t *numRead = null
 }
 
 /**
- * @brief Reads multiple files into a single buffer
+ * @brief Load a file in to memory taken from an arena
+ * @param path Path of file
+ * @param arena The arena that owns the buffer until it is reset
+ * @param numRead Number of T elements read
+ * @return Buffer with content of file
+ */
+template <typename T>
+T *LoadFileInArena(const char *path, BumpArena &arena, std::size_t *numRead = nullptr)
+{
+	size_t size;
+	AssetHandle handle = OpenAsset(path, size);
+	if (!handle.ok()) {
+		if (HeadlessMode) return nullptr;
+		app_fatal(FailedToOpenFileErrorMessage(path, handle.error()));
+	}
+	if ((size % sizeof(T)) != 0)
+		app_fatal(StrCat("File size does not align with type\n", path));
+
+	if (numRead != nullptr)
+		*numRead = size / sizeof(T);
+
+	T *buf = arena.allocate<T>(size / sizeof(T));
+	if (!handle.read(buf, size))
+		app_fatal("handle.read failed");
+	return buf;
+}
+
+/**
+ * @brief Reads multiple files into a single buffer, several at a time
  *
  * @tparam MaxFiles maximum number of files
  */
@@ -145,8 +174,7 @@ struct MultiFileLoader {
 	    FilterFn filterFn = DefaultFilterFn {})
 	{
 		StaticVector<std::array<char, MaxMpqPathSize>, MaxFiles> paths;
-		StaticVector<AssetRef, MaxFiles> files;
-		StaticVector<uint32_t, MaxFiles> sizes;
+		StaticVector<AssetRead, MaxFiles> files;
 		size_t totalSize = 0;
 		for (size_t i = 0, j = 0; i < numFiles; ++i) {
 			if (!filterFn(i))
@@ -157,27 +185,20 @@ struct MultiFileLoader {
 				memcpy(paths.back().data(), path, strlen(path) + 1);
 			}
 			const char *path = paths.back().data();
-			files.emplace_back(FindAsset(path));
-			if (!ValidatAssetRef(path, files.back()))
+			files.emplace_back(AssetRead { FindAsset(path), path, nullptr, 0 });
+			if (!ValidatAssetRef(path, files.back().ref))
 				return nullptr;
 
-			const size_t size = files.back().size();
-			sizes.emplace_back(static_cast<uint32_t>(size));
+			files.back().size = files.back().ref.size();
 			outOffsets[j] = static_cast<uint32_t>(totalSize);
-			totalSize += size;
+			totalSize += files.back().size;
 			++j;
 		}
 		outOffsets[files.size()] = static_cast<uint32_t>(totalSize);
 		std::unique_ptr<std::byte[]> buf { new std::byte[totalSize] };
-		for (size_t i = 0, j = 0; i < numFiles; ++i) {
-			if (!filterFn(i))
-				continue;
-			AssetHandle handle = OpenAsset(std::move(files[j]));
-			if (!handle.ok() || !handle.read(&buf[outOffsets[j]], sizes[j])) {
-				FailedToOpenFileError(paths[j].data(), handle.error());
-			}
-			++j;
-		}
+		for (size_t j = 0; j < files.size(); ++j)
+			files[j].buffer = &buf[outOffsets[j]];
+		ReadAssets({ files.data(), files.size() });
 		return buf;
 	}
 };
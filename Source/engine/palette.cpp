@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <span>
@@ -26,6 +27,7 @@
 #include "headless_mode.hpp"
 #include "hwcursor.hpp"
 #include "options.h"
+#include "utils/algorithm/rotate.hpp"
 #include "utils/display.h"
 #include "utils/palette_blending.hpp"
 #include "utils/sdl_compat.h"
@@ -48,25 +50,25 @@ void LoadBrightness()
 	GetOptions().Graphics.brightness.SetValue(brightnessValue - (brightnessValue % 5));
 }
 
+/** @brief The colors cycled since the last `FlushPaletteCycling`, none when `CycledFrom > CycledTo`. */
+int CycledFrom = 256;
+int CycledTo = -1;
+
 /**
  * @brief Cycle the given range of colors in the palette
  * @param from First color index of the range
- * @param to First color index of the range
+ * @param to Last color index of the range
  */
 void CycleColors(int from, int to)
 {
-	std::rotate(logical_palette.begin() + from, logical_palette.begin() + from + 1, logical_palette.begin() + to + 1);
-	std::rotate(system_palette.begin() + from, system_palette.begin() + from + 1, system_palette.begin() + to + 1);
-
-	for (auto &palette : paletteTransparencyLookup) {
-		std::rotate(std::begin(palette) + from, std::begin(palette) + from + 1, std::begin(palette) + to + 1);
-	}
+	const auto count = static_cast<size_t>(to - from + 1);
+	RotateLeftByOne(std::span(logical_palette).subspan(from, count));
+	RotateLeftByOne(std::span(system_palette).subspan(from, count));
 
-	std::rotate(&paletteTransparencyLookup[from][0], &paletteTransparencyLookup[from + 1][0], &paletteTransparencyLookup[to + 1][0]);
+	CycleBlendedLookupTable(from, to, /*reverse=*/false);
 
-#if DEVILUTIONX_PALETTE_TRANSPARENCY_BLACK_16_LUT
-	UpdateTransparencyLookupBlack16(from, to);
-#endif
+	CycledFrom = std::min(CycledFrom, from);
+	CycledTo = std::max(CycledTo, to);
 }
 
 /**
@@ -76,18 +78,14 @@ void CycleColors(int from, int to)
  */
 void CycleColorsReverse(int from, int to)
 {
-	std::rotate(logical_palette.begin() + from, logical_palette.begin() + to, logical_palette.begin() + to + 1);
-	std::rotate(system_palette.begin() + from, system_palette.begin() + to, system_palette.begin() + to + 1);
-
-	for (auto &palette : paletteTransparencyLookup) {
-		std::rotate(std::begin(palette) + from, std::begin(palette) + to, std::begin(palette) + to + 1);
-	}
+	const auto count = static_cast<size_t>(to - from + 1);
+	RotateRightByOne(std::span(logical_palette).subspan(from, count));
+	RotateRightByOne(std::span(system_palette).subspan(from, count));
 
-	std::rotate(&paletteTransparencyLookup[from][0], &paletteTransparencyLookup[to][0], &paletteTransparencyLookup[to + 1][0]);
+	CycleBlendedLookupTable(from, to, /*reverse=*/true);
 
-#if DEVILUTIONX_PALETTE_TRANSPARENCY_BLACK_16_LUT
-	UpdateTransparencyLookupBlack16(from, to);
-#endif
+	CycledFrom = std::min(CycledFrom, from);
+	CycledTo = std::max(CycledTo, to);
 }
 
 // When brightness==0, then a==0 (identity mapping)
@@ -107,27 +105,37 @@ constexpr uint8_t MapTone(float a, uint8_t color)
 	return static_cast<uint8_t>((y * 255.0F) + 0.5F);
 }
 
+/** @brief The tone map for `ToneMapBrightness`, only rebuilt when the brightness setting changes. */
+std::array<uint8_t, 256> ToneMap;
+int ToneMapBrightness = -1;
+
+const std::array<uint8_t, 256> &GetToneMap()
+{
+	// Get the brightness slider value (0 = neutral, 100 = max brightening)
+	const int brightnessSlider = *GetOptions().Graphics.brightness;
+	if (brightnessSlider != ToneMapBrightness) {
+		const float a = CalculateToneMappingParameter(brightnessSlider);
+		for (int i = 0; i < 256; i++) {
+			ToneMap[i] = MapTone(a, i);
+		}
+		ToneMapBrightness = brightnessSlider;
+	}
+	return ToneMap;
+}
+
 void ApplyGlobalBrightnessSingleColor(SDL_Color &dst, const SDL_Color &src)
 {
-	const float a = CalculateToneMappingParameter(*GetOptions().Graphics.brightness);
-	dst.r = MapTone(a, src.r);
-	dst.g = MapTone(a, src.g);
-	dst.b = MapTone(a, src.b);
+	const std::array<uint8_t, 256> &toneMap = GetToneMap();
+	dst.r = toneMap[src.r];
+	dst.g = toneMap[src.g];
+	dst.b = toneMap[src.b];
 }
 
 } // namespace
 
 void ApplyGlobalBrightness(SDL_Color *dst, const SDL_Color *src)
 {
-	// Get the brightness slider value (0 = neutral, 100 = max brightening)
-	const int brightnessSlider = *GetOptions().Graphics.brightness;
-
-	// Precompute a lookup table for speed.
-	const float a = CalculateToneMappingParameter(brightnessSlider);
-	uint8_t toneMap[256];
-	for (int i = 0; i < 256; i++) {
-		toneMap[i] = MapTone(a, i);
-	}
+	const std::array<uint8_t, 256> &toneMap = GetToneMap();
 
 	// Apply the lookup table to each color channel in the palette.
 	for (int i = 0; i < 256; i++) {
@@ -139,10 +147,15 @@ void ApplyGlobalBrightness(SDL_Color *dst, const SDL_Color *src)
 
 void ApplyFadeLevel(unsigned fadeval, SDL_Color *dst, const SDL_Color *src)
 {
+	uint8_t fadeMap[256];
+	for (unsigned i = 0; i < 256; i++) {
+		fadeMap[i] = static_cast<uint8_t>((fadeval * i) / 256);
+	}
+
 	for (int i = 0; i < 256; i++) {
-		dst[i].r = (fadeval * src[i].r) / 256;
-		dst[i].g = (fadeval * src[i].g) / 256;
-		dst[i].b = (fadeval * src[i].b) / 256;
+		dst[i].r = fadeMap[src[i].r];
+		dst[i].g = fadeMap[src[i].g];
+		dst[i].b = fadeMap[src[i].b];
 	}
 }
 
@@ -162,6 +175,16 @@ void SystemPaletteUpdated(int first, int ncolor)
 		return;
 
 	assert(Palette);
+#ifndef USE_SDL1
+	// Changing the palette colors makes SDL rebuild its blit mapping, skip it if the colors are the same.
+#ifdef USE_SDL3
+	const bool surfaceUsesPalette = PalSurface != nullptr && SDL_GetSurfacePalette(PalSurface) == Palette.get();
+#else
+	const bool surfaceUsesPalette = PalSurface != nullptr && PalSurface->format->palette == Palette.get();
+#endif
+	if (surfaceUsesPalette && std::memcmp(Palette->colors + first, system_palette.data() + first, ncolor * sizeof(SDL_Color)) == 0)
+		return;
+#endif
 	if (!SDLC_SetSurfaceAndPaletteColors(PalSurface, Palette.get(), system_palette.data() + first, first, ncolor)) {
 		ErrSdl();
 	}
@@ -285,7 +308,24 @@ void PaletteFadeIn(int fr, const std::array<SDL_Color, 256> &srcPalette)
 
 	ApplyGlobalBrightness(palette.data(), srcPalette.data());
 
-	if (fr > 0) {
+	if (fr > 0 && CanFadeOnPresent()) {
+		// Convert the frame once with the final palette and let the renderer fade it.
+		system_palette = palette;
+		SystemPaletteUpdated();
+		BltFast(nullptr, nullptr);
+		const uint32_t tc = SDL_GetTicks();
+		fr *= 3;
+		uint32_t prevFadeValue = 255;
+		bool frameUploaded = false;
+		for (uint32_t i = 0; i < 256; i = fr * (SDL_GetTicks() - tc) / 50) {
+			if (i == prevFadeValue) {
+				SDL_Delay(1);
+				continue;
+			}
+			prevFadeValue = i;
+			frameUploaded = RenderPresentFaded(i, !frameUploaded) || frameUploaded;
+		}
+	} else if (fr > 0) {
 		const uint32_t tc = SDL_GetTicks();
 		fr *= 3;
 		uint32_t prevFadeValue = 255;
@@ -328,7 +368,25 @@ void PaletteFadeOut(int fr, const std::array<SDL_Color, 256> &srcPalette)
 	if (demo::IsRunning())
 		fr = 0;
 
-	if (fr > 0) {
+	const bool fadeOnPresent = fr > 0 && CanFadeOnPresent();
+	if (fadeOnPresent) {
+		// Convert the frame once and let the renderer fade it.
+		ApplyGlobalBrightness(system_palette.data(), srcPalette.data());
+		SystemPaletteUpdated();
+		BltFast(nullptr, nullptr);
+		const uint32_t tc = SDL_GetTicks();
+		fr *= 3;
+		uint32_t prevFadeValue = 0;
+		bool frameUploaded = false;
+		for (uint32_t i = 0; i < 256; i = fr * (SDL_GetTicks() - tc) / 50) {
+			if (i == prevFadeValue) {
+				SDL_Delay(1);
+				continue;
+			}
+			prevFadeValue = i;
+			frameUploaded = RenderPresentFaded(256 - i, !frameUploaded) || frameUploaded;
+		}
+	} else if (fr > 0) {
 		SDL_Color palette[256];
 		ApplyGlobalBrightness(palette, srcPalette.data());
 
@@ -352,7 +410,8 @@ void PaletteFadeOut(int fr, const std::array<SDL_Color, 256> &srcPalette)
 	BlackPalette();
 	if (IsHardwareCursor()) ReinitializeHardwareCursor();
 
-	if (fr <= 0) {
+	// The output surface still holds the unfaded frame when the renderer faded it.
+	if (fr <= 0 || fadeOnPresent) {
 		BltFast(nullptr, nullptr);
 		RenderPresent();
 	}
@@ -363,7 +422,6 @@ void PaletteFadeOut(int fr, const std::array<SDL_Color, 256> &srcPalette)
 void palette_update_caves()
 {
 	CycleColors(1, 31);
-	SystemPaletteUpdated(1, 31);
 }
 
 /**
@@ -380,7 +438,6 @@ void palette_update_crypt()
 	}
 
 	CycleColorsReverse(16, 31);
-	SystemPaletteUpdated(1, 31);
 	delayLava = !delayLava;
 }
 
@@ -399,10 +456,18 @@ void palette_update_hive()
 
 	CycleColorsReverse(1, 8);
 	CycleColorsReverse(9, 15);
-	SystemPaletteUpdated(1, 15);
 	delay = 0;
 }
 
+void FlushPaletteCycling()
+{
+	if (CycledFrom > CycledTo)
+		return;
+	SystemPaletteUpdated(CycledFrom, CycledTo - CycledFrom + 1);
+	CycledFrom = 256;
+	CycledTo = -1;
+}
+
 void SetLogicalPaletteColor(unsigned i, const SDL_Color &color)
 {
 	logical_palette[i] = color;
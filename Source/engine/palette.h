@@ -143,4 +143,11 @@ void palette_update_caves();
 void palette_update_crypt();
 void palette_update_hive();
 
+/**
+ * @brief Uploads the colors cycled since the last call.
+ *
+ * Called once per frame before drawing, so that several cycles in between cost a single upload.
+ */
+void FlushPaletteCycling();
+
 } // namespace devilution
@@ -10,17 +10,20 @@
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <memory>
 #include <optional>
+#include <span>
 #include <utility>
+#include <vector>
 
 #include <function_ref.hpp>
 
 #include "appfat.h"
 #include "crawl.hpp"
 #include "engine/displacement.hpp"
+#include "engine/path_impl.hpp"
 #include "engine/point.hpp"
-#include "utils/algorithm/container.hpp"
-#include "utils/static_vector.hpp"
 
 namespace devilution {
 
@@ -32,124 +35,15 @@ namespace devilution {
 const int PathAxisAlignedStepCost = 100;
 const int PathDiagonalStepCost = 101;
 
-namespace {
-
-constexpr size_t MaxPathNodes = 1024;
-
-using NodeIndexType = uint16_t;
-using CoordType = uint8_t;
-using CostType = uint16_t;
-using PointT = PointOf<CoordType>;
-
-struct FrontierNode {
-	PointT position;
-
-	// Current best guess of the cost of the path to destination
-	// if it goes through this node.
-	CostType f;
-};
-
-struct ExploredNode {
-	// Preceding node (needed to reconstruct the path at the end).
-	PointT prev;
-
-	// The current lowest cost from start to this node (0 for the start node).
-	CostType g;
-};
-
-// A simple map with a fixed number of buckets and static storage.
-class ExploredNodes {
-	static const size_t NumBuckets = 64;
-	static const size_t BucketCapacity = 3 * MaxPathNodes / NumBuckets;
-	using Entry = std::pair<uint16_t, ExploredNode>;
-	using Bucket = StaticVector<Entry, BucketCapacity>;
-
-public:
-	using value_type = Entry;
-	using iterator = value_type *;
-	using const_iterator = const value_type *;
-
-	[[nodiscard]] const_iterator find(const PointT &point) const
-	{
-		const Bucket &b = bucket(point);
-		const auto *const it = c_find_if(b, [r = repr(point)](const Entry &e) { return e.first == r; });
-		if (it == b.end()) return nullptr;
-		return it;
-	}
-	[[nodiscard]] iterator find(const PointT &point)
-	{
-		Bucket &b = bucket(point);
-		auto *it = c_find_if(b, [r = repr(point)](const Entry &e) { return e.first == r; });
-		if (it == b.end()) return nullptr;
-		return it;
-	}
-
-	// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
-	[[nodiscard]] const_iterator end() const { return nullptr; }
-	// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
-	[[nodiscard]] iterator end() { return nullptr; }
-
-	void emplace(const PointT &point, const ExploredNode &exploredNode)
-	{
-		bucket(point).emplace_back(repr(point), exploredNode);
-	}
-
-	[[nodiscard]] bool canInsert(const PointT &point) const
-	{
-		return bucket(point).size() < BucketCapacity;
-	}
-
-private:
-	[[nodiscard]] const Bucket &bucket(const PointT &point) const { return buckets_[bucketIndex(point)]; }
-	[[nodiscard]] Bucket &bucket(const PointT &point) { return buckets_[bucketIndex(point)]; }
-	[[nodiscard]] static size_t bucketIndex(const PointT &point)
-	{
-		return ((point.x & 0b111) << 3) | (point.y & 0b111);
-	}
-
-	[[nodiscard]] static uint16_t repr(const PointT &point)
-	{
-		return (point.x << 8) | point.y;
-	}
-
-	std::array<Bucket, NumBuckets> buckets_;
-};
+namespace detail {
 
-bool IsDiagonalStep(const Point &a, const Point &b)
+PathWorkspace &GetPathWorkspace()
 {
-	return a.x != b.x && a.y != b.y;
-}
-
-/**
- * @brief Returns the distance between 2 adjacent nodes.
- */
-CostType GetDistance(PointT startPosition, PointT destinationPosition)
-{
-	return IsDiagonalStep(startPosition, destinationPosition)
-	    ? PathDiagonalStepCost
-	    : PathAxisAlignedStepCost;
-}
-
-/**
- * @brief heuristic, estimated cost from startPosition to destinationPosition.
- */
-CostType GetHeuristicCost(PointT startPosition, PointT destinationPosition)
-{
-	// This function needs to be admissible, i.e. it should never over-estimate
-	// the distance.
-	//
-	// This calculation assumes we can take diagonal steps until we reach
-	// the same row or column and then take the remaining axis-aligned steps.
-	const int dx = std::abs(static_cast<int>(startPosition.x) - static_cast<int>(destinationPosition.x));
-	const int dy = std::abs(static_cast<int>(startPosition.y) - static_cast<int>(destinationPosition.y));
-	const int diagSteps = std::min(dx, dy);
-
-	// After we've taken `diagSteps`, the remaining steps in one coordinate
-	// will be zero, and in the other coordinate it will be reduced by `diagSteps`.
-	// We then still need to take the remaining steps:
-	//   max(dx, dy) - diagSteps = max(dx, dy) - min(dx, dy) = abs(dx - dy)
-	const int axisAlignedSteps = std::abs(dx - dy);
-	return (diagSteps * PathDiagonalStepCost) + (axisAlignedSteps * PathAxisAlignedStepCost);
+	// Heap allocated so that threads which never search for a path don't pay for it.
+	thread_local std::unique_ptr<PathWorkspace> workspace;
+	if (workspace == nullptr)
+		workspace = std::make_unique<PathWorkspace>();
+	return *workspace;
 }
 
 int ReconstructPath(const ExploredNodes &explored, PointT dest, int8_t *path, size_t maxPathLength)
@@ -173,6 +67,80 @@ int ReconstructPath(const ExploredNodes &explored, PointT dest, int8_t *path, si
 	return static_cast<int>(len);
 }
 
+} // namespace detail
+
+namespace {
+
+using detail::CostType;
+using detail::FrontierNode;
+using detail::GetDistance;
+using detail::GetHeuristicCost;
+using detail::PointT;
+
+struct FlowFieldCell {
+	uint32_t generation;
+	// The lowest cost from this node to the destination.
+	CostType cost;
+	// The next node on the shortest path to the destination.
+	PointT next;
+	// Number of start positions on this node.
+	uint16_t startCount;
+	bool settled;
+};
+
+/**
+ * @brief Costs towards a single destination, for the tiles within `radius` steps of it.
+ */
+class FlowField {
+public:
+	void reset(PointT center, size_t radius)
+	{
+		center_ = center;
+		radius_ = static_cast<int>(radius);
+		const size_t size = (2 * radius) + 1;
+		if (cells_.size() < size * size)
+			cells_.resize(size * size, FlowFieldCell {});
+		if (++generation_ == 0) {
+			// The generation wrapped around, old cells could look current again.
+			for (FlowFieldCell &cell : cells_)
+				cell.generation = 0;
+			generation_ = 1;
+		}
+		frontier.clear();
+	}
+
+	[[nodiscard]] bool contains(PointT point) const
+	{
+		return std::abs(point.x - center_.x) <= radius_ && std::abs(point.y - center_.y) <= radius_;
+	}
+
+	/** @brief The cell for a position for which `contains` is true, initialized as unreached if it hasn't been used yet. */
+	FlowFieldCell &operator[](PointT point)
+	{
+		const int width = (2 * radius_) + 1;
+		FlowFieldCell &cell = cells_[((point.y - center_.y + radius_) * width) + (point.x - center_.x + radius_)];
+		if (cell.generation != generation_)
+			cell = FlowFieldCell { .generation = generation_, .cost = Unreached, .next = {}, .startCount = 0, .settled = false };
+		return cell;
+	}
+
+	static constexpr CostType Unreached = std::numeric_limits<CostType>::max();
+
+	std::vector<FrontierNode> frontier;
+
+private:
+	std::vector<FlowFieldCell> cells_;
+	uint32_t generation_ = 0;
+	PointT center_;
+	int radius_ = 0;
+};
+
+FlowField &GetFlowField()
+{
+	thread_local FlowField flowField;
+	return flowField;
+}
+
 } // namespace
 
 int8_t GetPathDirection(Point startPosition, Point destinationPosition)
@@ -183,103 +151,89 @@ int8_t GetPathDirection(Point startPosition, Point destinationPosition)
 
 int FindPath(tl::function_ref<bool(Point, Point)> canStep, tl::function_ref<bool(Point)> posOk, Point startPosition, Point destinationPosition, int8_t *path, size_t maxPathLength)
 {
-	const PointT start { startPosition };
+	return FindPathT(canStep, posOk, startPosition, destinationPosition, path, maxPathLength);
+}
+
+void FindPaths(tl::function_ref<bool(Point, Point)> canStep, tl::function_ref<bool(Point)> posOk, std::span<const Point> startPositions, Point destinationPosition, int8_t *paths, int *pathLengths, size_t maxPathLength)
+{
+	assert(maxPathLength <= MaxPathLengthPlayer);
 	const PointT dest { destinationPosition };
+	const size_t maxCost = PathDiagonalStepCost * maxPathLength;
 
-	const CostType initialHeuristicCost = GetHeuristicCost(start, dest);
-	if (initialHeuristicCost > PathDiagonalStepCost * maxPathLength) {
-		// Heuristic cost never underestimates the true cost, so we can give up early.
-		return 0;
-	}
+	FlowField &field = GetFlowField();
+	field.reset(dest, maxPathLength);
 
-	StaticVector<FrontierNode, MaxPathNodes> frontier;
-	ExploredNodes explored;
-	{
-		frontier.emplace_back(FrontierNode { .position = start, .f = initialHeuristicCost });
-		explored.emplace(start, ExploredNode { .prev = {}, .g = 0 });
+	size_t unsettledStarts = 0;
+	for (const Point startPosition : startPositions) {
+		const PointT start { startPosition };
+		if (field.contains(start) && GetHeuristicCost(start, dest) <= maxCost) {
+			++field[start].startCount;
+			++unsettledStarts;
+		}
 	}
 
-	const auto frontierComparator = [&explored, &dest](const FrontierNode &a, const FrontierNode &b) {
-		// We use heap functions from <algorithm> which form a max-heap.
-		// We reverse the comparison sign here to get a min-heap.
+	// We use heap functions from <algorithm> which form a max-heap.
+	// We reverse the comparison sign here to get a min-heap, ties are broken by coordinate.
+	const auto frontierComparator = [](const FrontierNode &a, const FrontierNode &b) {
 		if (a.f != b.f) return a.f > b.f;
-
-		// For nodes with the same f-score, prefer the ones with lower
-		// heuristic cost (likely to be closer to the goal).
-		const CostType hA = GetHeuristicCost(a.position, dest);
-		const CostType hB = GetHeuristicCost(b.position, dest);
-		if (hA != hB) return hA > hB;
-
-		// Prefer diagonal steps first.
-		const ExploredNode &aInfo = explored.find(a.position)->second;
-		const ExploredNode &bInfo = explored.find(b.position)->second;
-		const bool isDiagonalA = IsDiagonalStep(aInfo.prev, a.position);
-		const bool isDiagonalB = IsDiagonalStep(bInfo.prev, b.position);
-		if (isDiagonalA != isDiagonalB) return isDiagonalB;
-
-		// Finally, disambiguate by coordinate:
 		if (a.position.x != b.position.x) return a.position.x > b.position.x;
 		return a.position.y > b.position.y;
 	};
 
-	while (!frontier.empty()) {
-		const FrontierNode cur = frontier.front(); // argmin(node.f) for node in openSet
-
-		if (cur.position == destinationPosition) {
-			return ReconstructPath(explored, cur.position, path, maxPathLength);
-		}
+	// Search backwards from the destination, so that a single search finds the paths from all the start positions.
+	std::vector<FrontierNode> &frontier = field.frontier;
+	field[dest].cost = 0;
+	frontier.push_back(FrontierNode { .position = dest, .f = 0 });
 
+	while (!frontier.empty() && unsettledStarts > 0) {
 		std::pop_heap(frontier.begin(), frontier.end(), frontierComparator);
+		const FrontierNode cur = frontier.back();
 		frontier.pop_back();
-		const CostType curG = explored.find(cur.position)->second.g;
 
-		// Discard invalid nodes.
+		FlowFieldCell &curCell = field[cur.position];
+		if (curCell.settled || curCell.cost != cur.f) continue;
+		curCell.settled = true;
+		unsettledStarts -= curCell.startCount;
 
-		// If this node is already at the maximum number of steps, we can skip processing it.
-		// We don't keep track of the maximum number of steps, so we approximate it.
-		if (curG >= PathDiagonalStepCost * maxPathLength) continue;
+		if (cur.f >= maxCost) continue;
 
-		// When we discover a better path to a node, we push the node to the heap
-		// with the new `f` value even if the node is already in the heap.
-		if (curG + GetHeuristicCost(cur.position, dest) > cur.f) continue;
+		// Paths may only pass through valid positions, but are allowed to end on a non-walkable destination.
+		const bool ok = posOk(cur.position);
+		if (!ok && cur.position != dest) continue;
 
 		for (const DisplacementOf<int8_t> d : PathDirs) {
 			// We're using `uint8_t` for coordinates. Avoid underflow:
 			if ((cur.position.x == 0 && d.deltaX < 0) || (cur.position.y == 0 && d.deltaY < 0)) continue;
 			const PointT neighborPos = cur.position + d;
-			const bool ok = posOk(neighborPos);
-			if (ok) {
-				if (!canStep(cur.position, neighborPos)) continue;
-			} else {
-				// We allow targeting a non-walkable node if it is the destination.
-				if (neighborPos != dest) continue;
-			}
-			const CostType g = curG + GetDistance(cur.position, neighborPos);
-			if (curG >= PathDiagonalStepCost * maxPathLength) continue;
-			bool improved = false;
-			if (auto *it = explored.find(neighborPos); it == explored.end()) {
-				if (explored.canInsert(neighborPos)) {
-					explored.emplace(neighborPos, ExploredNode { .prev = cur.position, .g = g });
-					improved = true;
-				}
-			} else if (it->second.g > g) {
-				it->second.prev = cur.position;
-				it->second.g = g;
-				improved = true;
-			}
-			if (improved) {
-				const CostType f = g + GetHeuristicCost(neighborPos, dest);
-				if (frontier.size() < MaxPathNodes) {
-					// We always push the node to the heap, even if the same position already exists in it.
-					// When popping from the heap, we discard invalid nodes by checking that `g + h <= f`.
-					frontier.emplace_back(FrontierNode { .position = neighborPos, .f = f });
-					std::push_heap(frontier.begin(), frontier.end(), frontierComparator);
+			if (!field.contains(neighborPos)) continue;
+			if (ok && !canStep(neighborPos, cur.position)) continue;
+			const CostType cost = cur.f + GetDistance(neighborPos, cur.position);
+			FlowFieldCell &neighbor = field[neighborPos];
+			if (neighbor.settled || neighbor.cost <= cost) continue;
+			neighbor.cost = cost;
+			neighbor.next = cur.position;
+			frontier.push_back(FrontierNode { .position = neighborPos, .f = cost });
+			std::push_heap(frontier.begin(), frontier.end(), frontierComparator);
+		}
+	}
+
+	for (size_t i = 0; i < startPositions.size(); ++i) {
+		int8_t *path = paths + (i * maxPathLength);
+		const PointT start { startPositions[i] };
+		size_t len = 0;
+		if (field.contains(start) && field[start].settled) {
+			for (PointT cur = start; cur != dest; cur = field[cur].next) {
+				if (len == maxPathLength) {
+					// Path too long.
+					len = 0;
+					break;
 				}
+				path[len++] = GetPathDirection(cur, field[cur].next);
 			}
 		}
+		std::fill(path + len, path + maxPathLength, -1);
+		pathLengths[i] = static_cast<int>(len);
 	}
-
-	return 0; // no path
 }
 
 std::optional<Point> FindClosestValidPosition(tl::function_ref<bool(Point)> posOk, Point startingPosition, unsigned int minimumRadius, unsigned int maximumRadius)
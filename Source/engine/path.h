@@ -8,6 +8,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <span>
 
 #include <function_ref.hpp>
 
@@ -38,6 +39,32 @@ extern const int PathDiagonalStepCost;
  */
 int FindPath(tl::function_ref<bool(Point, Point)> canStep, tl::function_ref<bool(Point)> posOk, Point startPosition, Point destinationPosition, int8_t *path, size_t maxPathLength);
 
+/**
+ * @brief `FindPath` with the predicates called directly, so that they can be inlined into the search.
+ *
+ * Defined in "engine/path_impl.hpp". The hot predicate sets are instantiated next to their predicates,
+ * see `PlayerPosOk`, everything else goes through the `tl::function_ref` overload.
+ */
+template <typename CanStep, typename PosOk>
+int FindPathT(const CanStep &canStep, const PosOk &posOk, Point startPosition, Point destinationPosition, int8_t *path, size_t maxPathLength);
+
+/**
+ * @brief Find the shortest paths from each of `startPositions` to `destinationPosition`.
+ *
+ * Runs a single search backwards from the destination, which is cheaper than calling `FindPath` for each start
+ * position when many of them head for the same place. The paths are as short as the ones from `FindPath`,
+ * but where several shortest paths exist a different one may be chosen.
+ *
+ * @param canStep specifies whether a step between two adjacent points is allowed.
+ * @param posOk specifies whether a position can be stepped on.
+ * @param startPositions
+ * @param destinationPosition
+ * @param paths Resulting paths, the path for `startPositions[i]` starts at `paths + i * maxPathLength`. Must have room for `startPositions.size() * maxPathLength` steps.
+ * @param pathLengths Resulting path lengths, 0 if there is no valid path. Must have room for `startPositions.size()` values.
+ * @param maxPathLength The maximum allowed length of the resulting paths, at most `MaxPathLengthPlayer`.
+ */
+void FindPaths(tl::function_ref<bool(Point, Point)> canStep, tl::function_ref<bool(Point)> posOk, std::span<const Point> startPositions, Point destinationPosition, int8_t *paths, int *pathLengths, size_t maxPathLength);
+
 /** For iterating over the 8 possible movement directions */
 const Displacement PathDirs[8] = {
 	// clang-format off
@@ -5,10 +5,14 @@
  */
 #include "engine/render/automap_render.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 
 #include "automap.h"
 #include "engine/render/primitive_render.hpp"
+#include "utils/attributes.h"
+#include "utils/palette_blending.hpp"
 
 namespace devilution {
 namespace {
@@ -23,18 +27,119 @@ enum class DirectionY : int8_t {
 	NORTH = -1,
 };
 
+/** @brief The area map pixels may be drawn to, the right and bottom edges are exclusive. */
+struct MapClip {
+	int left;
+	int top;
+	int right;
+	int bottom;
+};
+
+MapClip GetMapClip(const Surface &out)
+{
+	MapClip clip { 0, 0, out.w(), out.h() };
+	if (GetAutomapType() == AutomapType::Minimap) {
+		clip.left = std::max(clip.left, MinimapRect.position.x);
+		clip.top = std::max(clip.top, MinimapRect.position.y);
+		clip.right = std::min(clip.right, MinimapRect.position.x + MinimapRect.size.width);
+		clip.bottom = std::min(clip.bottom, MinimapRect.position.y + MinimapRect.size.height);
+	}
+	return clip;
+}
+
+int FloorDiv(int a, int b)
+{
+	return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+/**
+ * @brief Narrows the steps `[begin, end)` to those where `lo <= start + step * i < hi`.
+ */
+void ClipSteps(int start, int step, int lo, int hi, int &begin, int &end)
+{
+	if (step == 0) {
+		if (start < lo || start >= hi)
+			end = begin;
+		return;
+	}
+	if (step > 0) {
+		begin = std::max(begin, FloorDiv(lo - start + step - 1, step));
+		end = std::min(end, FloorDiv(hi - start + step - 1, step));
+	} else {
+		begin = std::max(begin, FloorDiv(start - hi, -step) + 1);
+		end = std::min(end, FloorDiv(start - lo, -step) + 1);
+	}
+}
+
+/**
+ * @brief Writes a map pixel that is known to be within the clip area.
+ */
+template <bool Transparent>
+DVL_ALWAYS_INLINE void SetClippedMapPixel(uint8_t *dst, uint8_t color)
+{
+	if constexpr (Transparent) {
+		*dst = paletteTransparencyLookup[color][*dst];
+	} else {
+		*dst = color;
+	}
+}
+
+/**
+ * @brief Draws the steps of a 2:1 line that are entirely within the clip area without checking each pixel.
+ *
+ * Each step draws two pixels in a row with a shadow below them, the same as `DrawMapLine`.
+ */
+template <DirectionX DirX, DirectionY DirY, bool Transparent>
+void DrawClippedMapLineSteps(const Surface &out, Point from, int begin, int end, std::uint8_t colorIndex)
+{
+	const int pitch = out.pitch();
+	uint8_t *dst = out.at(from.x + (2 * static_cast<int>(DirX) * begin), from.y + (static_cast<int>(DirY) * begin));
+	const int stepOffset = (2 * static_cast<int>(DirX)) + (static_cast<int>(DirY) * pitch);
+	for (int i = begin; i < end; ++i, dst += stepOffset) {
+		SetClippedMapPixel<Transparent>(dst + pitch, 0);
+		SetClippedMapPixel<Transparent>(dst, colorIndex);
+		SetClippedMapPixel<Transparent>(dst + static_cast<int>(DirX) + pitch, 0);
+		SetClippedMapPixel<Transparent>(dst + static_cast<int>(DirX), colorIndex);
+	}
+}
+
+template <DirectionX DirX, DirectionY DirY>
+void DrawMapLineStep(const Surface &out, Point from, std::uint8_t colorIndex)
+{
+	SetMapPixel(out, { from.x, from.y + 1 }, 0);
+	SetMapPixel(out, from, colorIndex);
+	from.x += static_cast<int>(DirX);
+	SetMapPixel(out, { from.x, from.y + 1 }, 0);
+	SetMapPixel(out, from, colorIndex);
+}
+
 template <DirectionX DirX, DirectionY DirY>
 void DrawMapLine(const Surface &out, Point from, int height, std::uint8_t colorIndex)
 {
-	while (height-- > 0) {
-		SetMapPixel(out, { from.x, from.y + 1 }, 0);
-		SetMapPixel(out, from, colorIndex);
-		from.x += static_cast<int>(DirX);
-		SetMapPixel(out, { from.x, from.y + 1 }, 0);
-		SetMapPixel(out, from, colorIndex);
-		from.x += static_cast<int>(DirX);
-		from.y += static_cast<int>(DirY);
+	// Find the steps where both pixels and their shadows are within the clip area, once for the whole line.
+	const MapClip clip = GetMapClip(out);
+	int begin = 0;
+	int end = height;
+	const int firstX = std::min(from.x, from.x + static_cast<int>(DirX));
+	ClipSteps(firstX, 2 * static_cast<int>(DirX), clip.left, clip.right - 1, begin, end);
+	ClipSteps(from.y, static_cast<int>(DirY), clip.top, clip.bottom - 1, begin, end);
+	if (begin >= end) {
+		begin = 0;
+		end = 0;
 	}
+
+	for (int i = 0; i < begin; ++i) {
+		DrawMapLineStep<DirX, DirY>(out, from + Displacement { 2 * static_cast<int>(DirX) * i, static_cast<int>(DirY) * i }, colorIndex);
+	}
+	if (GetAutomapType() == AutomapType::Transparent)
+		DrawClippedMapLineSteps<DirX, DirY, true>(out, from, begin, end, colorIndex);
+	else
+		DrawClippedMapLineSteps<DirX, DirY, false>(out, from, begin, end, colorIndex);
+	for (int i = end; i < height; ++i) {
+		DrawMapLineStep<DirX, DirY>(out, from + Displacement { 2 * static_cast<int>(DirX) * i, static_cast<int>(DirY) * i }, colorIndex);
+	}
+
+	from += Displacement { 2 * static_cast<int>(DirX) * height, static_cast<int>(DirY) * height };
 	SetMapPixel(out, { from.x, from.y + 1 }, 0);
 	SetMapPixel(out, from, colorIndex);
 }
@@ -59,37 +164,41 @@ void DrawMapLineSteep(const Surface &out, Point from, int width, std::uint8_t co
 
 void DrawMapLineNS(const Surface &out, Point from, int height, std::uint8_t colorIndex)
 {
-	if (from.x < 0 || from.x >= out.w() || from.y >= out.h() || height <= 0 || from.y + height <= 0)
+	const MapClip clip = GetMapClip(out);
+	if (from.x < clip.left || from.x >= clip.right)
+		return;
+	const int top = std::max(from.y, clip.top);
+	const int bottom = std::min(from.y + height, clip.bottom);
+	if (top >= bottom)
 		return;
 
-	if (from.y < 0) {
-		height += from.y;
-		from.y = 0;
-	}
-
-	if (from.y + height > out.h())
-		height = out.h() - from.y;
-
-	for (int i = 0; i < height; ++i) {
-		SetMapPixel(out, { from.x, from.y + i }, colorIndex);
+	const int pitch = out.pitch();
+	uint8_t *dst = out.at(from.x, top);
+	if (GetAutomapType() == AutomapType::Transparent) {
+		for (int y = top; y < bottom; ++y, dst += pitch)
+			SetClippedMapPixel<true>(dst, colorIndex);
+	} else {
+		for (int y = top; y < bottom; ++y, dst += pitch)
+			SetClippedMapPixel<false>(dst, colorIndex);
 	}
 }
 
 void DrawMapLineWE(const Surface &out, Point from, int width, std::uint8_t colorIndex)
 {
-	if (from.y < 0 || from.y >= out.h() || from.x >= out.w() || width <= 0 || from.x + width <= 0)
+	const MapClip clip = GetMapClip(out);
+	if (from.y < clip.top || from.y >= clip.bottom)
+		return;
+	const int left = std::max(from.x, clip.left);
+	const int right = std::min(from.x + width, clip.right);
+	if (left >= right)
 		return;
 
-	if (from.x < 0) {
-		width += from.x;
-		from.x = 0;
-	}
-
-	if (from.x + width > out.w())
-		width = out.w() - from.x;
-
-	for (int i = 0; i < width; ++i) {
-		SetMapPixel(out, { from.x + i, from.y }, colorIndex);
+	uint8_t *dst = out.at(left, from.y);
+	if (GetAutomapType() == AutomapType::Transparent) {
+		for (int x = left; x < right; ++x, ++dst)
+			SetClippedMapPixel<true>(dst, colorIndex);
+	} else {
+		std::memset(dst, colorIndex, static_cast<size_t>(right - left));
 	}
 }
 
@@ -5,6 +5,7 @@
 #include <execution>
 #include <version>
 
+#include "engine/render/blit_kernels.hpp"
 #include "engine/render/light_render.hpp"
 #include "utils/attributes.h"
 #include "utils/palette_blending.hpp"
@@ -46,18 +47,29 @@ DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitFillWithMap(uint8_t *dst, unsigned
 	std::memset(dst, colorMap[color], length);
 }
 
-DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitPixelsWithMap(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const uint8_t *DVL_RESTRICT colorMap)
+DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitPixelsWithMap(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const uint8_t *DVL_RESTRICT colorMap,
+    BlitPixelsWithMapKernel kernel = ActiveBlitKernels.pixelsWithMap)
 {
 	DVL_ASSUME(length != 0);
+	if (length >= BlitKernelMinLength && kernel != nullptr) {
+		kernel(dst, src, length, colorMap);
+		return;
+	}
 	std::transform(DEVILUTIONX_BLIT_EXECUTION_POLICY src, src + length, dst, [colorMap](uint8_t srcColor) { return colorMap[srcColor]; });
 }
 
+/**
+ * The blit functors read the kernels when they are created, i.e. once per sprite.
+ * Any write through `dst` may alias `ActiveBlitKernels`, so reading it for every run
+ * would reload it from memory each time.
+ */
 struct BlitWithMap {
 	const uint8_t *DVL_RESTRICT colorMap;
+	BlitPixelsWithMapKernel kernel = ActiveBlitKernels.pixelsWithMap;
 
 	DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void operator()(unsigned length, uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src) const
 	{
-		BlitPixelsWithMap(dst, src, length, colorMap);
+		BlitPixelsWithMap(dst, src, length, colorMap, kernel);
 	}
 	DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void operator()(unsigned length, uint8_t color, uint8_t *DVL_RESTRICT dst) const
 	{
@@ -74,10 +86,15 @@ DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitFillWithLightmap(uint8_t *dst, unsi
 	});
 }
 
-DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitPixelsWithLightmap(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const Lightmap &lightmap)
+DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitPixelsWithLightmap(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const Lightmap &lightmap,
+    BlitPixelsWithLightmapKernel kernel = ActiveBlitKernels.pixelsWithLightmap)
 {
 	DVL_ASSUME(length != 0);
 	const uint8_t *light = lightmap.getLightingAt(dst);
+	if (length >= BlitKernelMinLength && kernel != nullptr) {
+		kernel(dst, src, light, length, lightmap.lightTablesData());
+		return;
+	}
 	std::transform(DEVILUTIONX_BLIT_EXECUTION_POLICY src, src + length, light, dst, [&lightmap](uint8_t srcColor, uint8_t lightLevel) {
 		return lightmap.adjustColor(srcColor, lightLevel);
 	});
@@ -85,10 +102,11 @@ DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitPixelsWithLightmap(uint8_t *DVL_RES
 
 struct BlitWithLightmap {
 	const Lightmap &lightmap;
+	BlitPixelsWithLightmapKernel kernel = ActiveBlitKernels.pixelsWithLightmap;
 
 	DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void operator()(unsigned length, uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src) const
 	{
-		BlitPixelsWithLightmap(dst, src, length, lightmap);
+		BlitPixelsWithLightmap(dst, src, length, lightmap, kernel);
 	}
 	DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void operator()(unsigned length, uint8_t color, uint8_t *DVL_RESTRICT dst) const
 	{
@@ -96,36 +114,54 @@ struct BlitWithLightmap {
 	}
 };
 
-DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitFillBlended(uint8_t *dst, unsigned length, uint8_t color)
+DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitFillBlended(uint8_t *dst, unsigned length, uint8_t color,
+    BlitFillBlendedKernel kernel = ActiveBlitKernels.fillBlended)
 {
 	DVL_ASSUME(length != 0);
+	if (length >= BlitKernelMinLength && kernel != nullptr) {
+		kernel(dst, length, paletteTransparencyLookup[color]);
+		return;
+	}
 	std::for_each(DEVILUTIONX_BLIT_EXECUTION_POLICY dst, dst + length, [tbl = paletteTransparencyLookup[color]](uint8_t &dstColor) {
 		dstColor = tbl[dstColor];
 	});
 }
 
-DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitPixelsBlended(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length)
+DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitPixelsBlended(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length,
+    BlitPixelsBlendedKernel kernel = ActiveBlitKernels.pixelsBlended)
 {
 	DVL_ASSUME(length != 0);
+	if (length >= BlitKernelMinLength && kernel != nullptr) {
+		kernel(dst, src, length);
+		return;
+	}
 	std::transform(DEVILUTIONX_BLIT_EXECUTION_POLICY src, src + length, dst, dst, [pal = paletteTransparencyLookup](uint8_t srcColor, uint8_t dstColor) {
 		return pal[srcColor][dstColor];
 	});
 }
 
 struct BlitBlended {
+	BlitPixelsBlendedKernel kernel = ActiveBlitKernels.pixelsBlended;
+	BlitFillBlendedKernel fillKernel = ActiveBlitKernels.fillBlended;
+
 	DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void operator()(unsigned length, uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src) const
 	{
-		BlitPixelsBlended(dst, src, length);
+		BlitPixelsBlended(dst, src, length, kernel);
 	}
 	DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void operator()(unsigned length, uint8_t color, uint8_t *DVL_RESTRICT dst) const
 	{
-		BlitFillBlended(dst, length, color);
+		BlitFillBlended(dst, length, color, fillKernel);
 	}
 };
 
-DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitPixelsBlendedWithMap(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const uint8_t *DVL_RESTRICT colorMap)
+DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitPixelsBlendedWithMap(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const uint8_t *DVL_RESTRICT colorMap,
+    BlitPixelsBlendedWithMapKernel kernel = ActiveBlitKernels.pixelsBlendedWithMap)
 {
 	DVL_ASSUME(length != 0);
+	if (length >= BlitKernelMinLength && kernel != nullptr) {
+		kernel(dst, src, length, colorMap);
+		return;
+	}
 	std::transform(DEVILUTIONX_BLIT_EXECUTION_POLICY src, src + length, dst, dst, [colorMap, pal = paletteTransparencyLookup](uint8_t srcColor, uint8_t dstColor) {
 		return pal[dstColor][colorMap[srcColor]];
 	});
@@ -133,14 +169,16 @@ DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitPixelsBlendedWithMap(uint8_t *DVL_R
 
 struct BlitBlendedWithMap {
 	const uint8_t *DVL_RESTRICT colorMap;
+	BlitPixelsBlendedWithMapKernel kernel = ActiveBlitKernels.pixelsBlendedWithMap;
+	BlitFillBlendedKernel fillKernel = ActiveBlitKernels.fillBlended;
 
 	DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void operator()(unsigned length, uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src) const
 	{
-		BlitPixelsBlendedWithMap(dst, src, length, colorMap);
+		BlitPixelsBlendedWithMap(dst, src, length, colorMap, kernel);
 	}
 	DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void operator()(unsigned length, uint8_t color, uint8_t *DVL_RESTRICT dst) const
 	{
-		BlitFillBlended(dst, length, colorMap[color]);
+		BlitFillBlended(dst, length, colorMap[color], fillKernel);
 	}
 };
 
@@ -154,10 +192,15 @@ DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitFillBlendedWithLightmap(uint8_t *ds
 	});
 }
 
-DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitPixelsBlendedWithLightmap(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const Lightmap &lightmap)
+DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitPixelsBlendedWithLightmap(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const Lightmap &lightmap,
+    BlitPixelsBlendedWithLightmapKernel kernel = ActiveBlitKernels.pixelsBlendedWithLightmap)
 {
 	DVL_ASSUME(length != 0);
 	const uint8_t *light = lightmap.getLightingAt(dst);
+	if (length >= BlitKernelMinLength && kernel != nullptr) {
+		kernel(dst, src, light, length, lightmap.lightTablesData());
+		return;
+	}
 
 	if (length < 1024) {
 		uint8_t litSrc[1024];
@@ -181,10 +224,11 @@ DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitPixelsBlendedWithLightmap(uint8_t *
 
 struct BlitBlendedWithLightmap {
 	const Lightmap &lightmap;
+	BlitPixelsBlendedWithLightmapKernel kernel = ActiveBlitKernels.pixelsBlendedWithLightmap;
 
 	DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void operator()(unsigned length, uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src) const
 	{
-		BlitPixelsBlendedWithLightmap(dst, src, length, lightmap);
+		BlitPixelsBlendedWithLightmap(dst, src, length, lightmap, kernel);
 	}
 	DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void operator()(unsigned length, uint8_t color, uint8_t *DVL_RESTRICT dst) const
 	{
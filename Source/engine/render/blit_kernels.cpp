@@ -0,0 +1,309 @@
+#include "engine/render/blit_kernels.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "utils/attributes.h"
+#include "utils/palette_blending.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define DEVILUTIONX_BLIT_KERNELS_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define DEVILUTIONX_BLIT_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace devilution {
+
+namespace {
+
+constexpr BlitKernels ScalarKernels {};
+
+#ifdef DEVILUTIONX_BLIT_KERNELS_AVX2
+
+#define DVL_TARGET_AVX2 __attribute__((target("avx2")))
+
+/**
+ * @brief Looks up 8 bytes at the given byte offsets from `table`.
+ *
+ * AVX2 can only gather 32-bit values, so we gather the aligned dword that contains
+ * each byte and shift the byte into place. Aligned reads never cross a page boundary,
+ * so this never reads from memory that is not mapped even for the last table entry.
+ */
+DVL_TARGET_AVX2 DVL_ALWAYS_INLINE __m256i GatherBytes(const uint8_t *table, __m256i offsets)
+{
+	const auto misalignment = static_cast<int>(reinterpret_cast<uintptr_t>(table) & 3);
+	const auto *base = reinterpret_cast<const int *>(table - misalignment);
+	const __m256i three = _mm256_set1_epi32(3);
+	offsets = _mm256_add_epi32(offsets, _mm256_set1_epi32(misalignment));
+	const __m256i aligned = _mm256_andnot_si256(three, offsets);
+	const __m256i shift = _mm256_slli_epi32(_mm256_and_si256(offsets, three), 3);
+	const __m256i dwords = _mm256_i32gather_epi32(base, aligned, 1);
+	return _mm256_and_si256(_mm256_srlv_epi32(dwords, shift), _mm256_set1_epi32(0xFF));
+}
+
+/** @brief Loads 8 bytes and zero-extends them to 32 bits. */
+DVL_TARGET_AVX2 DVL_ALWAYS_INLINE __m256i Load8(const uint8_t *src)
+{
+	return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src)));
+}
+
+/** @brief Stores the low byte of each of the 8 dwords. */
+DVL_TARGET_AVX2 DVL_ALWAYS_INLINE void Store8(uint8_t *dst, __m256i bytes)
+{
+	const __m256i shuffle = _mm256_setr_epi8(
+	    0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	    0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m256i packed = _mm256_shuffle_epi8(bytes, shuffle);
+	const auto lo = static_cast<uint32_t>(_mm256_extract_epi32(packed, 0));
+	const auto hi = static_cast<uint32_t>(_mm256_extract_epi32(packed, 4));
+	std::memcpy(dst, &lo, 4);
+	std::memcpy(dst + 4, &hi, 4);
+}
+
+DVL_TARGET_AVX2 void Avx2PixelsWithMap(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const uint8_t *DVL_RESTRICT colorMap)
+{
+	unsigned i = 0;
+	for (; i + 8 <= length; i += 8) {
+		Store8(dst + i, GatherBytes(colorMap, Load8(src + i)));
+	}
+	for (; i < length; ++i) {
+		dst[i] = colorMap[src[i]];
+	}
+}
+
+DVL_TARGET_AVX2 void Avx2PixelsWithLightmap(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, const uint8_t *DVL_RESTRICT light, unsigned length, const uint8_t *DVL_RESTRICT lightTables)
+{
+	unsigned i = 0;
+	for (; i + 8 <= length; i += 8) {
+		const __m256i offsets = _mm256_or_si256(_mm256_slli_epi32(Load8(light + i), 8), Load8(src + i));
+		Store8(dst + i, GatherBytes(lightTables, offsets));
+	}
+	for (; i < length; ++i) {
+		dst[i] = lightTables[(light[i] << 8) | src[i]];
+	}
+}
+
+DVL_TARGET_AVX2 void Avx2PixelsBlended(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length)
+{
+	const uint8_t *pal = &paletteTransparencyLookup[0][0];
+	unsigned i = 0;
+	for (; i + 8 <= length; i += 8) {
+		const __m256i offsets = _mm256_or_si256(_mm256_slli_epi32(Load8(src + i), 8), Load8(dst + i));
+		Store8(dst + i, GatherBytes(pal, offsets));
+	}
+	for (; i < length; ++i) {
+		dst[i] = paletteTransparencyLookup[src[i]][dst[i]];
+	}
+}
+
+DVL_TARGET_AVX2 void Avx2PixelsBlendedWithMap(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const uint8_t *DVL_RESTRICT colorMap)
+{
+	const uint8_t *pal = &paletteTransparencyLookup[0][0];
+	unsigned i = 0;
+	for (; i + 8 <= length; i += 8) {
+		const __m256i mapped = GatherBytes(colorMap, Load8(src + i));
+		const __m256i offsets = _mm256_or_si256(_mm256_slli_epi32(Load8(dst + i), 8), mapped);
+		Store8(dst + i, GatherBytes(pal, offsets));
+	}
+	for (; i < length; ++i) {
+		dst[i] = paletteTransparencyLookup[dst[i]][colorMap[src[i]]];
+	}
+}
+
+DVL_TARGET_AVX2 void Avx2PixelsBlendedWithLightmap(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, const uint8_t *DVL_RESTRICT light, unsigned length, const uint8_t *DVL_RESTRICT lightTables)
+{
+	const uint8_t *pal = &paletteTransparencyLookup[0][0];
+	unsigned i = 0;
+	for (; i + 8 <= length; i += 8) {
+		const __m256i lit = GatherBytes(lightTables, _mm256_or_si256(_mm256_slli_epi32(Load8(light + i), 8), Load8(src + i)));
+		const __m256i offsets = _mm256_or_si256(_mm256_slli_epi32(Load8(dst + i), 8), lit);
+		Store8(dst + i, GatherBytes(pal, offsets));
+	}
+	for (; i < length; ++i) {
+		dst[i] = paletteTransparencyLookup[dst[i]][lightTables[(light[i] << 8) | src[i]]];
+	}
+}
+
+DVL_TARGET_AVX2 void Avx2FillBlended(uint8_t *DVL_RESTRICT dst, unsigned length, const uint8_t *DVL_RESTRICT colorMap)
+{
+	unsigned i = 0;
+	for (; i + 8 <= length; i += 8) {
+		Store8(dst + i, GatherBytes(colorMap, Load8(dst + i)));
+	}
+	for (; i < length; ++i) {
+		dst[i] = colorMap[dst[i]];
+	}
+}
+
+#undef DVL_TARGET_AVX2
+
+constexpr BlitKernels Avx2Kernels {
+	/*.pixelsWithMap=*/Avx2PixelsWithMap,
+	/*.pixelsWithLightmap=*/Avx2PixelsWithLightmap,
+	/*.pixelsBlended=*/Avx2PixelsBlended,
+	/*.pixelsBlendedWithMap=*/Avx2PixelsBlendedWithMap,
+	/*.pixelsBlendedWithLightmap=*/Avx2PixelsBlendedWithLightmap,
+	/*.fillBlended=*/Avx2FillBlended,
+};
+
+bool CpuSupportsAvx2()
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+}
+#endif // DEVILUTIONX_BLIT_KERNELS_AVX2
+
+#ifdef DEVILUTIONX_BLIT_KERNELS_NEON
+/**
+ * @brief A 256-entry byte lookup table held in NEON registers.
+ *
+ * `vqtbl4q_u8` covers 64 entries, out-of-range indices are handled by
+ * the following `vqtbx4q_u8` on the next 64 entries.
+ */
+struct NeonLut {
+	uint8x16x4_t parts[4];
+
+	explicit NeonLut(const uint8_t *table)
+	{
+		for (int i = 0; i < 4; ++i) {
+			parts[i] = vld1q_u8_x4(table + (i * 64));
+		}
+	}
+
+	[[nodiscard]] DVL_ALWAYS_INLINE uint8x16_t lookup(uint8x16_t index) const
+	{
+		const uint8x16_t step = vdupq_n_u8(64);
+		uint8x16_t result = vqtbl4q_u8(parts[0], index);
+		index = vsubq_u8(index, step);
+		result = vqtbx4q_u8(result, parts[1], index);
+		index = vsubq_u8(index, step);
+		result = vqtbx4q_u8(result, parts[2], index);
+		index = vsubq_u8(index, step);
+		return vqtbx4q_u8(result, parts[3], index);
+	}
+};
+
+void NeonPixelsWithMap(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const uint8_t *DVL_RESTRICT colorMap)
+{
+	const NeonLut lut { colorMap };
+	unsigned i = 0;
+	for (; i + 16 <= length; i += 16) {
+		vst1q_u8(dst + i, lut.lookup(vld1q_u8(src + i)));
+	}
+	for (; i < length; ++i) {
+		dst[i] = colorMap[src[i]];
+	}
+}
+
+void NeonFillBlended(uint8_t *DVL_RESTRICT dst, unsigned length, const uint8_t *DVL_RESTRICT colorMap)
+{
+	const NeonLut lut { colorMap };
+	unsigned i = 0;
+	for (; i + 16 <= length; i += 16) {
+		vst1q_u8(dst + i, lut.lookup(vld1q_u8(dst + i)));
+	}
+	for (; i < length; ++i) {
+		dst[i] = colorMap[dst[i]];
+	}
+}
+
+// The 2D lookups (per-pixel lighting and blending) have a different table for every pixel,
+// which NEON has no instruction for, so only the single-table kernels are vectorized.
+constexpr BlitKernels NeonKernels {
+	/*.pixelsWithMap=*/NeonPixelsWithMap,
+	/*.pixelsWithLightmap=*/nullptr,
+	/*.pixelsBlended=*/nullptr,
+	/*.pixelsBlendedWithMap=*/nullptr,
+	/*.pixelsBlendedWithLightmap=*/nullptr,
+	/*.fillBlended=*/NeonFillBlended,
+};
+#endif // DEVILUTIONX_BLIT_KERNELS_NEON
+
+const BlitKernels &GetKernels(BlitIsa isa)
+{
+	switch (isa) {
+#ifdef DEVILUTIONX_BLIT_KERNELS_AVX2
+	case BlitIsa::AVX2:
+		return Avx2Kernels;
+#endif
+#ifdef DEVILUTIONX_BLIT_KERNELS_NEON
+	case BlitIsa::NEON:
+		return NeonKernels;
+#endif
+	default:
+		return ScalarKernels;
+	}
+}
+
+BlitIsa CurrentBlitIsa = DetectBlitIsa();
+
+} // namespace
+
+BlitKernels ActiveBlitKernels = GetKernels(CurrentBlitIsa);
+
+BlitIsa DetectBlitIsa()
+{
+#ifdef DEVILUTIONX_BLIT_KERNELS_AVX2
+	if (CpuSupportsAvx2()) return BlitIsa::AVX2;
+#endif
+#ifdef DEVILUTIONX_BLIT_KERNELS_NEON
+	return BlitIsa::NEON;
+#else
+	return BlitIsa::Scalar;
+#endif
+}
+
+bool IsBlitIsaSupported(BlitIsa isa)
+{
+	switch (isa) {
+	case BlitIsa::Scalar:
+		return true;
+	case BlitIsa::AVX2:
+#ifdef DEVILUTIONX_BLIT_KERNELS_AVX2
+		return CpuSupportsAvx2();
+#else
+		return false;
+#endif
+	case BlitIsa::NEON:
+#ifdef DEVILUTIONX_BLIT_KERNELS_NEON
+		return true;
+#else
+		return false;
+#endif
+	}
+	return false;
+}
+
+bool SetBlitIsa(BlitIsa isa)
+{
+	if (!IsBlitIsaSupported(isa)) return false;
+	CurrentBlitIsa = isa;
+	ActiveBlitKernels = GetKernels(isa);
+	return true;
+}
+
+BlitIsa GetBlitIsa()
+{
+	return CurrentBlitIsa;
+}
+
+std::string_view BlitIsaToString(BlitIsa isa)
+{
+	switch (isa) {
+	case BlitIsa::Scalar:
+		return "Scalar";
+	case BlitIsa::AVX2:
+		return "AVX2";
+	case BlitIsa::NEON:
+		return "NEON";
+	}
+	return "";
+}
+
+} // namespace devilution
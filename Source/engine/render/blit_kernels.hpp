@@ -0,0 +1,85 @@
+/**
+ * @file blit_kernels.hpp
+ *
+ * Vectorized span kernels for the palette-lookup blits in `blit_impl.hpp`,
+ * selected at startup based on the CPU features.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "utils/attributes.h"
+
+namespace devilution {
+
+enum class BlitIsa : uint8_t {
+	/** @brief Plain C++ (auto-vectorized where the compiler can). */
+	Scalar,
+
+	/** @brief x86 AVX2 gathers for the table lookups. */
+	AVX2,
+
+	/** @brief AArch64 NEON 256-entry table lookups. */
+	NEON,
+};
+
+/** @brief dst[i] = colorMap[src[i]] */
+using BlitPixelsWithMapKernel = void (*)(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const uint8_t *DVL_RESTRICT colorMap);
+
+/** @brief dst[i] = lightTables[light[i]][src[i]] */
+using BlitPixelsWithLightmapKernel = void (*)(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, const uint8_t *DVL_RESTRICT light, unsigned length, const uint8_t *DVL_RESTRICT lightTables);
+
+/** @brief dst[i] = paletteTransparencyLookup[src[i]][dst[i]] */
+using BlitPixelsBlendedKernel = void (*)(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length);
+
+/** @brief dst[i] = paletteTransparencyLookup[dst[i]][colorMap[src[i]]] */
+using BlitPixelsBlendedWithMapKernel = void (*)(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const uint8_t *DVL_RESTRICT colorMap);
+
+/** @brief dst[i] = paletteTransparencyLookup[dst[i]][lightTables[light[i]][src[i]]] */
+using BlitPixelsBlendedWithLightmapKernel = void (*)(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, const uint8_t *DVL_RESTRICT light, unsigned length, const uint8_t *DVL_RESTRICT lightTables);
+
+/** @brief dst[i] = colorMap[dst[i]] */
+using BlitFillBlendedKernel = void (*)(uint8_t *DVL_RESTRICT dst, unsigned length, const uint8_t *DVL_RESTRICT colorMap);
+
+/**
+ * @brief Span kernels for the current ISA.
+ *
+ * A `nullptr` entry means there is no vectorized kernel for that operation
+ * and the scalar implementation from `blit_impl.hpp` is used.
+ */
+struct BlitKernels {
+	BlitPixelsWithMapKernel pixelsWithMap;
+	BlitPixelsWithLightmapKernel pixelsWithLightmap;
+	BlitPixelsBlendedKernel pixelsBlended;
+	BlitPixelsBlendedWithMapKernel pixelsBlendedWithMap;
+	BlitPixelsBlendedWithLightmapKernel pixelsBlendedWithLightmap;
+	BlitFillBlendedKernel fillBlended;
+};
+
+/**
+ * @brief Spans shorter than this are always handled by the scalar code,
+ * the call overhead is not worth it for them.
+ */
+constexpr unsigned BlitKernelMinLength = 16;
+
+extern DVL_API_FOR_TEST BlitKernels ActiveBlitKernels;
+
+/** @brief The best ISA supported by this CPU and build. */
+BlitIsa DetectBlitIsa();
+
+/** @brief Whether the given ISA can be used on this CPU and build. */
+bool IsBlitIsaSupported(BlitIsa isa);
+
+/**
+ * @brief Switches the active kernels, e.g. for benchmarking.
+ *
+ * @return false if the ISA is not supported (the active kernels are left as is).
+ */
+bool SetBlitIsa(BlitIsa isa);
+
+BlitIsa GetBlitIsa();
+
+std::string_view BlitIsaToString(BlitIsa isa);
+
+} // namespace devilution
@@ -6,13 +6,36 @@
 #include "clx_render.hpp"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef DEVILUTIONX_GENERIC_CLX_BLIT
+#include <variant>
+#endif
+
+#include <ankerl/unordered_dense.h>
 
 #include "engine/point.hpp"
 #include "engine/render/blit_impl.hpp"
 #include "engine/surface.hpp"
 #include "utils/attributes.h"
 #include "utils/clx_decode.hpp"
+#include "utils/clx_encode.hpp"
+#include "utils/endian_write.hpp"
+#include "utils/sdl_mutex.h"
+#include "utils/sdl_thread.h"
 #include "utils/static_vector.hpp"
 
 #ifdef DEBUG_CLX
@@ -233,18 +256,351 @@ void DoRenderBackwards(
 	}
 }
 
+/** @brief A single opaque run of a CLX sprite, already split at line boundaries. */
+struct ClxRun {
+	/** @brief Offset of the first pixel (or of the fill color) in the sprite's pixel data. */
+	uint32_t srcOffset;
+	uint16_t x;
+	uint8_t length;
+	bool fill;
+};
+
+struct ClxRunCacheEntry {
+	const uint8_t *spriteData;
+	uint32_t pixelDataSize;
+	uint16_t width;
+	uint16_t height;
+	std::vector<ClxRun> runs;
+
+	/**
+	 * @brief Index of the first run of each line, plus one element for the end.
+	 *
+	 * Lines are in the source order, i.e. line 0 is the bottom line.
+	 */
+	std::vector<uint32_t> lineBegin;
+
+	[[nodiscard]] size_t bytes() const
+	{
+		return sizeof(*this) + runs.capacity() * sizeof(ClxRun) + lineBegin.capacity() * sizeof(uint32_t);
+	}
+
+	/** @brief Guards against a different sprite that was loaded where a freed one used to be, for data that isn't owned by an `OwnedClxSprite*` class. */
+	[[nodiscard]] bool matches(ClxSprite clx) const
+	{
+		return clx.pixelDataSize() == pixelDataSize && clx.width() == width && clx.height() == height;
+	}
+};
+
+#ifdef DEVILUTIONX_CLX_RUN_CACHE_BUDGET
+/** @brief How much memory the decoded runs of the most recently drawn sprites may take up, 0 disables the cache. */
+constexpr size_t ClxRunCacheBudget = DEVILUTIONX_CLX_RUN_CACHE_BUDGET;
+#else
+constexpr size_t ClxRunCacheBudget = 2 * 1024 * 1024;
+#endif
+
+void ForgetFreedClxData(const uint8_t *data, size_t size);
+
+/**
+ * @brief LRU cache of decoded CLX runs, keyed by the sprite's pixel data.
+ *
+ * Runs only store offsets into the sprite's pixel data, so the entries remain valid
+ * when the colors are changed in-place (e.g. by `ClxApplyTrans`).
+ * The entries of owned sprite data are dropped once it is freed, see `OnClxDataFreed`.
+ */
+class ClxRunCache {
+public:
+	ClxRunCache()
+	    : budget_(ClxRunCacheBudget)
+	    , owner_(this_sdl_thread::get_id())
+	{
+		OnClxDataFreed = &ForgetFreedClxData;
+	}
+
+	~ClxRunCache()
+	{
+		// Sprites that outlive the cache are freed after it during shutdown
+		OnClxDataFreed = nullptr;
+	}
+
+	const ClxRunCacheEntry *get(ClxSprite clx)
+	{
+		if (this_sdl_thread::get_id() != owner_) return nullptr;
+		if (hasFreed_.load(std::memory_order_acquire)) eraseFreed();
+		if (budget_ == 0) return nullptr;
+		const auto it = index_.find(clx.pixelData());
+		if (it != index_.end()) {
+			if (it->second->matches(clx)) {
+				++stats_.hits;
+				entries_.splice(entries_.begin(), entries_, it->second);
+				return &*it->second;
+			}
+			erase(clx.pixelData());
+		}
+		++stats_.misses;
+		ClxRunCacheEntry entry = Decode(clx);
+		const size_t entryBytes = entry.bytes();
+		if (entryBytes > budget_) return nullptr;
+		while (stats_.bytes + entryBytes > budget_) {
+			evictOne();
+		}
+		entries_.push_front(std::move(entry));
+		index_.emplace(clx.pixelData(), entries_.begin());
+		stats_.bytes += entryBytes;
+		++stats_.entries;
+		return &entries_.front();
+	}
+
+	void setBudget(size_t bytes)
+	{
+		budget_ = bytes;
+		owner_ = this_sdl_thread::get_id();
+		while (stats_.bytes > budget_) {
+			evictOne();
+		}
+	}
+
+	void clear()
+	{
+		entries_.clear();
+		index_.clear();
+		stats_.entries = 0;
+		stats_.bytes = 0;
+		const std::lock_guard<SdlMutex> lock(freedMutex_);
+		freed_.clear();
+		hasFreed_.store(false, std::memory_order_relaxed);
+	}
+
+	/** @brief Can be called from any thread, the runs of the data are dropped before the next draw that uses the cache. */
+	void markFreed(const uint8_t *data, size_t size)
+	{
+		const std::lock_guard<SdlMutex> lock(freedMutex_);
+		freed_.emplace_back(data, data + size);
+		hasFreed_.store(true, std::memory_order_release);
+	}
+
+	/** @brief Drops the runs of sprite data that is about to be freed. */
+	void erase(const uint8_t *pixelData)
+	{
+		const auto it = index_.find(pixelData);
+		if (it == index_.end()) return;
+		stats_.bytes -= it->second->bytes();
+		--stats_.entries;
+		entries_.erase(it->second);
+		index_.erase(it);
+	}
+
+	[[nodiscard]] const ClxRunCacheStats &stats() const { return stats_; }
+
+private:
+	static ClxRunCacheEntry Decode(ClxSprite clx)
+	{
+		ClxRunCacheEntry entry;
+		entry.spriteData = clx.pixelData();
+		entry.pixelDataSize = clx.pixelDataSize();
+		entry.width = clx.width();
+		entry.height = clx.height();
+		const unsigned width = clx.width();
+		const unsigned height = clx.height();
+		entry.lineBegin.reserve(height + 1);
+		entry.lineBegin.push_back(0);
+
+		const uint8_t *const begin = clx.pixelData();
+		const uint8_t *const end = begin + clx.pixelDataSize();
+		const uint8_t *src = begin;
+		unsigned x = 0;
+		const auto advance = [&](unsigned length) {
+			x += length;
+			while (x >= width) {
+				x -= width;
+				entry.lineBegin.push_back(static_cast<uint32_t>(entry.runs.size()));
+			}
+		};
+		while (src < end) {
+			const uint8_t control = *src;
+			if (!IsClxOpaque(control)) {
+				advance(control);
+				++src;
+				continue;
+			}
+			const bool fill = IsClxOpaqueFill(control);
+			unsigned length = fill ? GetClxOpaqueFillWidth(control) : GetClxOpaquePixelsWidth(control);
+			auto srcOffset = static_cast<uint32_t>(src + 1 - begin);
+			src += fill ? 2 : 1 + length;
+			while (length > 0) {
+				const unsigned lineLength = std::min(length, width - x);
+				entry.runs.push_back(ClxRun { srcOffset, static_cast<uint16_t>(x), static_cast<uint8_t>(lineLength), fill });
+				if (!fill) srcOffset += lineLength;
+				length -= lineLength;
+				advance(lineLength);
+			}
+		}
+		entry.lineBegin.resize(height + 1, static_cast<uint32_t>(entry.runs.size()));
+		entry.runs.shrink_to_fit();
+		return entry;
+	}
+
+	void eraseFreed()
+	{
+		std::vector<std::pair<const uint8_t *, const uint8_t *>> freed;
+		{
+			const std::lock_guard<SdlMutex> lock(freedMutex_);
+			freed.swap(freed_);
+			hasFreed_.store(false, std::memory_order_relaxed);
+		}
+
+		// Merge overlapping ranges (an address can be freed, reused and freed again), so each entry has to be checked against one range only.
+		std::sort(freed.begin(), freed.end());
+		size_t numRanges = 0;
+		for (const auto &range : freed) {
+			if (numRanges > 0 && range.first < freed[numRanges - 1].second) {
+				freed[numRanges - 1].second = std::max(freed[numRanges - 1].second, range.second);
+			} else {
+				freed[numRanges++] = range;
+			}
+		}
+		freed.resize(numRanges);
+
+		for (auto it = entries_.begin(); it != entries_.end();) {
+			const uint8_t *data = it->spriteData;
+			const auto range = std::upper_bound(freed.begin(), freed.end(), data,
+			    [](const uint8_t *value, const auto &r) { return value < r.first; });
+			if (range == freed.begin() || data >= std::prev(range)->second) {
+				++it;
+				continue;
+			}
+			stats_.bytes -= it->bytes();
+			--stats_.entries;
+			index_.erase(data);
+			it = entries_.erase(it);
+		}
+	}
+
+	void evictOne()
+	{
+		const ClxRunCacheEntry &last = entries_.back();
+		stats_.bytes -= last.bytes();
+		--stats_.entries;
+		++stats_.evictions;
+		index_.erase(last.spriteData);
+		entries_.pop_back();
+	}
+
+	size_t budget_;
+	/** @brief The cache is not thread-safe, it is only used on the thread that set the budget. */
+	decltype(this_sdl_thread::get_id()) owner_;
+	std::list<ClxRunCacheEntry> entries_;
+	ankerl::unordered_dense::map<const uint8_t *, std::list<ClxRunCacheEntry>::iterator> index_;
+	ClxRunCacheStats stats_ {};
+
+	/** @brief Sprite data freed since the last draw, possibly on other threads. */
+	SdlMutex freedMutex_;
+	std::vector<std::pair<const uint8_t *, const uint8_t *>> freed_;
+	std::atomic<bool> hasFreed_ = false;
+};
+
+ClxRunCache RunCache;
+
+void ForgetFreedClxData(const uint8_t *data, size_t size)
+{
+	RunCache.markFreed(data, size);
+}
+
+template <bool ClippedX, typename BlitFn>
+void DoRenderRunLines(const Surface &out, Point position, const uint8_t *pixelData, const ClxRunCacheEntry &entry,
+    int lineBegin, int lineEnd, int xBegin, int xEnd, BlitFn &&blitFn)
+{
+	for (int line = lineBegin; line < lineEnd; ++line) {
+		uint8_t *dstLine = out.at(position.x, position.y - line);
+		const ClxRun *run = &entry.runs[entry.lineBegin[line]];
+		const ClxRun *const runsEnd = entry.runs.data() + entry.lineBegin[line + 1];
+		for (; run != runsEnd; ++run) {
+			int runBegin = run->x;
+			int runEnd = runBegin + run->length;
+			if constexpr (ClippedX) {
+				runBegin = std::max(runBegin, xBegin);
+				runEnd = std::min(runEnd, xEnd);
+				if (runBegin >= runEnd) continue;
+			}
+			const auto length = static_cast<unsigned>(runEnd - runBegin);
+			if (run->fill) {
+				blitFn(length, pixelData[run->srcOffset], dstLine + runBegin);
+			} else {
+				blitFn(length, dstLine + runBegin, pixelData + run->srcOffset + (runBegin - run->x));
+			}
+		}
+	}
+}
+
+template <typename BlitFn>
+void DoRenderRuns(const Surface &out, Point position, const uint8_t *pixelData, const ClxRunCacheEntry &entry,
+    unsigned srcWidth, unsigned srcHeight, BlitFn &&blitFn)
+{
+	if (position.y < 0 || position.y + 1 >= static_cast<int>(out.h() + srcHeight))
+		return;
+	const ClipX clipX = CalculateClipX(position.x, srcWidth, out);
+	if (clipX.width <= 0)
+		return;
+
+	const int lineBegin = std::max(0, position.y - (out.h() - 1));
+	const int lineEnd = std::min(static_cast<int>(srcHeight), position.y + 1);
+	if (static_cast<unsigned>(clipX.width) == srcWidth) {
+		DoRenderRunLines</*ClippedX=*/false>(out, position, pixelData, entry, lineBegin, lineEnd,
+		    0, static_cast<int>(srcWidth), std::forward<BlitFn>(blitFn));
+	} else {
+		DoRenderRunLines</*ClippedX=*/true>(out, position, pixelData, entry, lineBegin, lineEnd,
+		    static_cast<int>(clipX.left), static_cast<int>(srcWidth - clipX.right), std::forward<BlitFn>(blitFn));
+	}
+}
+
+template <typename BlitFn>
+void DoRenderClx(const Surface &out, Point position, ClxSprite clx, BlitFn &&blitFn)
+{
+	if (const ClxRunCacheEntry *entry = RunCache.get(clx); entry != nullptr) {
+		DoRenderRuns(out, position, clx.pixelData(), *entry, clx.width(), clx.height(), std::forward<BlitFn>(blitFn));
+		return;
+	}
+	DoRenderBackwards(out, position, clx.pixelData(), clx.pixelDataSize(), clx.width(), clx.height(), std::forward<BlitFn>(blitFn));
+}
+
+#ifdef DEVILUTIONX_GENERIC_CLX_BLIT
+/**
+ * @brief Picks the blit for every run, so that the run renderers are only compiled once
+ * rather than once per blit type.
+ */
+struct BlitAny {
+	std::variant<BlitDirect, BlitWithMap, BlitWithLightmap, BlitBlended, BlitBlendedWithMap, BlitBlendedWithLightmap> blit;
+
+	DVL_NO_INLINE void operator()(unsigned length, uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src) const
+	{
+		std::visit([&](const auto &blitFn) { blitFn(length, dst, src); }, blit);
+	}
+	DVL_NO_INLINE void operator()(unsigned length, uint8_t color, uint8_t *DVL_RESTRICT dst) const
+	{
+		std::visit([&](const auto &blitFn) { blitFn(length, color, dst); }, blit);
+	}
+};
+#endif
+
+/**
+ * @brief Renders the sprite with a run renderer specialized for the blit type.
+ *
+ * Builds with `DEVILUTIONX_GENERIC_CLX_BLIT` share a single run renderer between all blit types instead.
+ */
+template <typename BlitFn>
+void RenderClxWith(const Surface &out, Point position, ClxSprite clx, BlitFn blitFn)
+{
+#ifdef DEVILUTIONX_GENERIC_CLX_BLIT
+	DoRenderClx(out, position, clx, BlitAny { blitFn });
+#else
+	DoRenderClx(out, position, clx, blitFn);
+#endif
+}
+
 constexpr size_t MaxOutlinePixels = 4096;
 constexpr size_t MaxOutlineSpriteWidth = 253;
 using OutlinePixels = StaticVector<PointOf<uint8_t>, MaxOutlinePixels>;
 using OutlineRowSolidRuns = StaticVector<std::pair<uint8_t, uint8_t>, (MaxOutlineSpriteWidth / 2) + 1>;
 
-struct OutlinePixelsCacheEntry {
-	OutlinePixels outlinePixels;
-	const void *spriteData = nullptr;
-	bool skipColorIndexZero;
-};
-OutlinePixelsCacheEntry OutlinePixelsCache;
-
 void PopulateOutlinePixelsForRow(
     const OutlineRowSolidRuns &runs,
     const bool *DVL_RESTRICT below,
@@ -388,32 +744,158 @@ void GetOutline(ClxSprite sprite, OutlinePixels &result) // NOLINT(readability-f
 	}
 }
 
-template <bool SkipColorIndexZero>
-void UpdateOutlinePixelsCache(ClxSprite sprite)
-{
-	if (OutlinePixelsCache.spriteData == sprite.pixelData()
-	    && OutlinePixelsCache.skipColorIndexZero == SkipColorIndexZero) {
-		return;
+#ifdef DEVILUTIONX_CLX_OUTLINE_CACHE_BUDGET
+/** @brief How much memory the outlines cached by each drawing thread may take up. */
+constexpr size_t ClxOutlineCacheBudget = DEVILUTIONX_CLX_OUTLINE_CACHE_BUDGET;
+#else
+constexpr size_t ClxOutlineCacheBudget = 256 * 1024;
+#endif
+
+std::atomic<size_t> OutlineCacheBudget { ClxOutlineCacheBudget };
+
+/** @brief Bumped by `ClearClxDrawCache`, each thread's cache is emptied when it sees a new value. */
+std::atomic<uint32_t> OutlineCacheGeneration;
+
+struct {
+	std::atomic<size_t> hits;
+	std::atomic<size_t> misses;
+	std::atomic<size_t> evictions;
+	std::atomic<size_t> entries;
+	std::atomic<size_t> bytes;
+} OutlineCacheStats;
+
+struct OutlineCacheKey {
+	const uint8_t *pixelData;
+	bool skipColorIndexZero;
+
+	bool operator==(const OutlineCacheKey &other) const = default;
+};
+
+struct OutlineCacheKeyHash {
+	using is_avalanching = void;
+
+	[[nodiscard]] uint64_t operator()(const OutlineCacheKey &key) const noexcept
+	{
+		return ankerl::unordered_dense::hash<uint64_t> {}((static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key.pixelData)) << 1) | (key.skipColorIndexZero ? 1 : 0));
 	}
-	OutlinePixelsCache.skipColorIndexZero = SkipColorIndexZero;
-	OutlinePixelsCache.spriteData = sprite.pixelData();
-	OutlinePixelsCache.outlinePixels.clear();
-	GetOutline<SkipColorIndexZero>(sprite, OutlinePixelsCache.outlinePixels);
-}
+};
+
+struct OutlineCacheEntry {
+	OutlineCacheKey key;
+	uint32_t pixelDataSize;
+	uint16_t width;
+	uint16_t height;
+	std::vector<PointOf<uint8_t>> pixels;
+
+	[[nodiscard]] size_t bytes() const
+	{
+		return sizeof(OutlineCacheEntry) + pixels.capacity() * sizeof(PointOf<uint8_t>);
+	}
+
+	[[nodiscard]] bool matches(ClxSprite sprite) const
+	{
+		return sprite.pixelDataSize() == pixelDataSize && sprite.width() == width && sprite.height() == height;
+	}
+};
+
+/**
+ * @brief LRU cache of sprite outlines, so that the outlines of the hovered item, the highlighted
+ * monster and the other players are not traced again every frame.
+ *
+ * The most recently drawn outline is always kept, even with a budget of 0.
+ */
+class ClxOutlineCache {
+public:
+	~ClxOutlineCache()
+	{
+		clear();
+	}
+
+	template <bool SkipColorIndexZero>
+	std::span<const PointOf<uint8_t>> get(ClxSprite sprite)
+	{
+		if (const uint32_t generation = OutlineCacheGeneration.load(std::memory_order_relaxed); generation != generation_) {
+			clear();
+			generation_ = generation;
+		}
+
+		const OutlineCacheKey key { sprite.pixelData(), SkipColorIndexZero };
+		if (const auto it = index_.find(key); it != index_.end()) {
+			if (it->second->matches(sprite)) {
+				OutlineCacheStats.hits.fetch_add(1, std::memory_order_relaxed);
+				entries_.splice(entries_.begin(), entries_, it->second);
+				return it->second->pixels;
+			}
+			erase(it);
+		}
+		OutlineCacheStats.misses.fetch_add(1, std::memory_order_relaxed);
+
+		scratch_.clear();
+		GetOutline<SkipColorIndexZero>(sprite, scratch_);
+		entries_.push_front(OutlineCacheEntry { key, sprite.pixelDataSize(), sprite.width(), sprite.height(), { scratch_.begin(), scratch_.end() } });
+		index_.emplace(key, entries_.begin());
+		add(entries_.front().bytes(), 1);
+
+		const size_t budget = OutlineCacheBudget.load(std::memory_order_relaxed);
+		while (bytes_ > budget && entries_.size() > 1) {
+			OutlineCacheStats.evictions.fetch_add(1, std::memory_order_relaxed);
+			erase(index_.find(entries_.back().key));
+		}
+		return entries_.front().pixels;
+	}
+
+private:
+	using Index = ankerl::unordered_dense::map<OutlineCacheKey, std::list<OutlineCacheEntry>::iterator, OutlineCacheKeyHash>;
+
+	void add(size_t bytes, size_t entries)
+	{
+		bytes_ += bytes;
+		OutlineCacheStats.bytes.fetch_add(bytes, std::memory_order_relaxed);
+		OutlineCacheStats.entries.fetch_add(entries, std::memory_order_relaxed);
+	}
+
+	void erase(Index::iterator it)
+	{
+		const size_t bytes = it->second->bytes();
+		bytes_ -= bytes;
+		OutlineCacheStats.bytes.fetch_sub(bytes, std::memory_order_relaxed);
+		OutlineCacheStats.entries.fetch_sub(1, std::memory_order_relaxed);
+		entries_.erase(it->second);
+		index_.erase(it);
+	}
+
+	void clear()
+	{
+		OutlineCacheStats.bytes.fetch_sub(bytes_, std::memory_order_relaxed);
+		OutlineCacheStats.entries.fetch_sub(entries_.size(), std::memory_order_relaxed);
+		bytes_ = 0;
+		entries_.clear();
+		index_.clear();
+	}
+
+	uint32_t generation_ = OutlineCacheGeneration.load(std::memory_order_relaxed);
+	size_t bytes_ = 0;
+	std::list<OutlineCacheEntry> entries_;
+	Index index_;
+	OutlinePixels scratch_;
+};
+
+// Outlines are also drawn by the world render band threads.
+thread_local ClxOutlineCache OutlineCache;
 
 template <bool SkipColorIndexZero>
 void RenderClxOutline(const Surface &out, Point position, ClxSprite sprite, uint8_t color)
 {
-	UpdateOutlinePixelsCache<SkipColorIndexZero>(sprite);
+	const std::span<const PointOf<uint8_t>> outlinePixels = OutlineCache.get<SkipColorIndexZero>(sprite);
 	--position.x;
 	position.y -= sprite.height();
 	if (position.x >= 0 && position.x + sprite.width() + 2 < out.w()
 	    && position.y >= 0 && position.y + sprite.height() + 2 < out.h()) {
-		for (const auto &[x, y] : OutlinePixelsCache.outlinePixels) {
+		for (const auto &[x, y] : outlinePixels) {
 			*out.at(position.x + x, position.y + y) = color;
 		}
 	} else {
-		for (const auto &[x, y] : OutlinePixelsCache.outlinePixels) {
+		for (const auto &[x, y] : outlinePixels) {
 			out.SetPixel(Point(position.x + x, position.y + y), color);
 		}
 	}
@@ -423,7 +905,7 @@ void ClxApplyTrans(ClxSprite sprite, const uint8_t *trn)
 {
 	// A bit of a hack but this is the only place in the code where we need mutable sprites.
 	auto *dst = const_cast<uint8_t *>(sprite.pixelData());
-	uint16_t remaining = sprite.pixelDataSize();
+	uint32_t remaining = sprite.pixelDataSize();
 	while (remaining != 0) {
 		uint8_t val = *dst++;
 		--remaining;
@@ -444,6 +926,185 @@ void ClxApplyTrans(ClxSprite sprite, const uint8_t *trn)
 	}
 }
 
+#ifdef DEVILUTIONX_CLX_TRN_CACHE_BUDGET
+/** @brief How much memory the sprites with a TRN applied may take up, 0 disables the cache. */
+constexpr size_t ClxTrnCacheBudget = DEVILUTIONX_CLX_TRN_CACHE_BUDGET;
+#else
+constexpr size_t ClxTrnCacheBudget = 1024 * 1024;
+#endif
+
+/** @brief A sprite is translated once it has been drawn this many times with the same TRN. */
+constexpr uint8_t ClxTrnCacheAdmitDraws = 2;
+
+/** @brief The draw counts of pairs that aren't cached yet are forgotten when there are more. */
+constexpr size_t ClxTrnCacheMaxCandidates = 4096;
+
+struct ClxTrnCacheKey {
+	const uint8_t *pixelData;
+	const uint8_t *trn;
+
+	bool operator==(const ClxTrnCacheKey &other) const = default;
+};
+
+struct ClxTrnCacheKeyHash {
+	using is_avalanching = void;
+
+	[[nodiscard]] uint64_t operator()(const ClxTrnCacheKey &key) const noexcept
+	{
+		return ankerl::unordered_dense::hash<std::string_view> {}(std::string_view { reinterpret_cast<const char *>(&key), sizeof(key) });
+	}
+};
+
+struct ClxTrnCacheEntry {
+	ClxTrnCacheKey key;
+	/** @brief The TRN and the pixels the sprite was translated from, the entry is only used while they are unchanged. */
+	std::array<uint8_t, 256> trn;
+	std::unique_ptr<uint8_t[]> source;
+	/** @brief A sprite with the same size as the source and the TRN applied. */
+	std::unique_ptr<uint8_t[]> translated;
+	uint32_t pixelDataSize;
+
+	[[nodiscard]] static size_t Bytes(uint32_t pixelDataSize)
+	{
+		return sizeof(ClxTrnCacheEntry) + ClxFrameHeaderSize + 2 * static_cast<size_t>(pixelDataSize);
+	}
+
+	[[nodiscard]] size_t bytes() const
+	{
+		return Bytes(pixelDataSize);
+	}
+
+	[[nodiscard]] ClxSprite sprite() const
+	{
+		return ClxSprite { translated.get(), static_cast<uint32_t>(ClxFrameHeaderSize + pixelDataSize) };
+	}
+
+	[[nodiscard]] bool matches(ClxSprite clx, const uint8_t *trnNow) const
+	{
+		const ClxSprite cached = sprite();
+		return clx.pixelDataSize() == pixelDataSize && clx.width() == cached.width() && clx.height() == cached.height()
+		    && std::memcmp(trn.data(), trnNow, trn.size()) == 0
+		    && std::memcmp(source.get(), clx.pixelData(), pixelDataSize) == 0;
+	}
+};
+
+/**
+ * @brief LRU cache of sprites with a TRN applied, so that sprites drawn again and again
+ * with the same TRN (unique monsters, petrified monsters, infravision, ...) use the plain blits.
+ *
+ * Entries are checked against the sprite and the TRN on every draw, so sprites that are
+ * translated in-place or freed and TRNs that are rewritten never draw stale colors.
+ */
+class ClxTrnCache {
+public:
+	ClxTrnCache()
+	    : budget_(ClxTrnCacheBudget)
+	    , owner_(this_sdl_thread::get_id())
+	{
+	}
+
+	/** @return The sprite with the TRN applied, if the pair is drawn often enough to be cached. */
+	std::optional<ClxSprite> get(ClxSprite clx, const uint8_t *trn)
+	{
+		if (budget_ == 0 || this_sdl_thread::get_id() != owner_) return std::nullopt;
+		const ClxTrnCacheKey key { clx.pixelData(), trn };
+		if (const auto it = index_.find(key); it != index_.end()) {
+			if (it->second->matches(clx, trn)) {
+				++stats_.hits;
+				entries_.splice(entries_.begin(), entries_, it->second);
+				return it->second->sprite();
+			}
+			// The pair was drawn before, so it is translated again right away.
+			erase(it);
+		} else {
+			if (candidates_.size() >= ClxTrnCacheMaxCandidates)
+				candidates_.clear();
+			if (++candidates_[key] < ClxTrnCacheAdmitDraws) {
+				++stats_.misses;
+				return std::nullopt;
+			}
+			candidates_.erase(key);
+		}
+		++stats_.misses;
+
+		const uint32_t pixelDataSize = clx.pixelDataSize();
+		const size_t entryBytes = ClxTrnCacheEntry::Bytes(pixelDataSize);
+		if (entryBytes > budget_) return std::nullopt;
+		while (stats_.bytes + entryBytes > budget_) {
+			evictOne();
+		}
+
+		ClxTrnCacheEntry entry { key, {}, std::unique_ptr<uint8_t[]> { new uint8_t[pixelDataSize] },
+			std::unique_ptr<uint8_t[]> { new uint8_t[ClxFrameHeaderSize + pixelDataSize] }, pixelDataSize };
+		std::memcpy(entry.trn.data(), trn, entry.trn.size());
+		std::memcpy(entry.source.get(), clx.pixelData(), pixelDataSize);
+		WriteLE16(&entry.translated[0], ClxFrameHeaderSize);
+		WriteLE16(&entry.translated[2], clx.width());
+		WriteLE16(&entry.translated[4], clx.height());
+		std::memcpy(&entry.translated[ClxFrameHeaderSize], clx.pixelData(), pixelDataSize);
+		ClxApplyTrans(entry.sprite(), trn);
+
+		entries_.push_front(std::move(entry));
+		index_.emplace(key, entries_.begin());
+		stats_.bytes += entryBytes;
+		++stats_.entries;
+		return entries_.front().sprite();
+	}
+
+	void setBudget(size_t bytes)
+	{
+		budget_ = bytes;
+		owner_ = this_sdl_thread::get_id();
+		while (stats_.bytes > budget_) {
+			evictOne();
+		}
+	}
+
+	void clear()
+	{
+		for (const ClxTrnCacheEntry &entry : entries_)
+			RunCache.erase(entry.sprite().pixelData());
+		entries_.clear();
+		index_.clear();
+		candidates_.clear();
+		stats_.entries = 0;
+		stats_.bytes = 0;
+	}
+
+	[[nodiscard]] const ClxTrnCacheStats &stats() const { return stats_; }
+
+private:
+	using Index = ankerl::unordered_dense::map<ClxTrnCacheKey, std::list<ClxTrnCacheEntry>::iterator, ClxTrnCacheKeyHash>;
+
+	void erase(Index::iterator it)
+	{
+		const ClxTrnCacheEntry &entry = *it->second;
+		// The run cache is keyed by the pixel data, which is about to be freed.
+		RunCache.erase(entry.sprite().pixelData());
+		stats_.bytes -= entry.bytes();
+		--stats_.entries;
+		entries_.erase(it->second);
+		index_.erase(it);
+	}
+
+	void evictOne()
+	{
+		++stats_.evictions;
+		erase(index_.find(entries_.back().key));
+	}
+
+	size_t budget_;
+	/** @brief The cache is not thread-safe, it is only used on the thread that set the budget. */
+	decltype(this_sdl_thread::get_id()) owner_;
+	std::list<ClxTrnCacheEntry> entries_;
+	Index index_;
+	/** @brief How often the pairs that aren't cached yet have been drawn. */
+	ankerl::unordered_dense::map<ClxTrnCacheKey, uint8_t, ClxTrnCacheKeyHash> candidates_;
+	ClxTrnCacheStats stats_ {};
+};
+
+ClxTrnCache TrnCache;
+
 } // namespace
 
 void ClxApplyTrans(ClxSpriteList list, const uint8_t *trn)
@@ -580,32 +1241,40 @@ std::string ClxDescribe(ClxSprite clx)
 
 void ClxDraw(const Surface &out, Point position, ClxSprite clx)
 {
-	DoRenderBackwards(out, position, clx.pixelData(), clx.pixelDataSize(), clx.width(), clx.height(), BlitDirect {});
+	RenderClxWith(out, position, clx, BlitDirect {});
 }
 
 void ClxDrawTRN(const Surface &out, Point position, ClxSprite clx, const uint8_t *trn)
 {
-	DoRenderBackwards(out, position, clx.pixelData(), clx.pixelDataSize(), clx.width(), clx.height(), BlitWithMap { trn });
+	if (const std::optional<ClxSprite> translated = TrnCache.get(clx, trn); translated) {
+		RenderClxWith(out, position, *translated, BlitDirect {});
+		return;
+	}
+	RenderClxWith(out, position, clx, BlitWithMap { trn });
 }
 
 void ClxDrawWithLightmap(const Surface &out, Point position, ClxSprite clx, const Lightmap &lightmap)
 {
-	DoRenderBackwards(out, position, clx.pixelData(), clx.pixelDataSize(), clx.width(), clx.height(), BlitWithLightmap { lightmap });
+	RenderClxWith(out, position, clx, BlitWithLightmap { lightmap });
 }
 
 void ClxDrawBlended(const Surface &out, Point position, ClxSprite clx)
 {
-	DoRenderBackwards(out, position, clx.pixelData(), clx.pixelDataSize(), clx.width(), clx.height(), BlitBlended {});
+	RenderClxWith(out, position, clx, BlitBlended {});
 }
 
 void ClxDrawBlendedTRN(const Surface &out, Point position, ClxSprite clx, const uint8_t *trn)
 {
-	DoRenderBackwards(out, position, clx.pixelData(), clx.pixelDataSize(), clx.width(), clx.height(), BlitBlendedWithMap { trn });
+	if (const std::optional<ClxSprite> translated = TrnCache.get(clx, trn); translated) {
+		RenderClxWith(out, position, *translated, BlitBlended {});
+		return;
+	}
+	RenderClxWith(out, position, clx, BlitBlendedWithMap { trn });
 }
 
 void ClxDrawBlendedWithLightmap(const Surface &out, Point position, ClxSprite clx, const Lightmap &lightmap)
 {
-	DoRenderBackwards(out, position, clx.pixelData(), clx.pixelDataSize(), clx.width(), clx.height(), BlitBlendedWithLightmap { lightmap });
+	RenderClxWith(out, position, clx, BlitBlendedWithLightmap { lightmap });
 }
 
 void ClxDrawOutline(const Surface &out, uint8_t col, Point position, ClxSprite clx)
@@ -620,7 +1289,45 @@ void ClxDrawOutlineSkipColorZero(const Surface &out, uint8_t col, Point position
 
 void ClearClxDrawCache()
 {
-	OutlinePixelsCache.spriteData = nullptr;
+	OutlineCacheGeneration.fetch_add(1, std::memory_order_relaxed);
+	TrnCache.clear();
+	RunCache.clear();
+}
+
+void SetClxRunCacheBudget(size_t bytes)
+{
+	RunCache.setBudget(bytes);
+}
+
+ClxRunCacheStats GetClxRunCacheStats()
+{
+	return RunCache.stats();
+}
+
+void SetClxTrnCacheBudget(size_t bytes)
+{
+	TrnCache.setBudget(bytes);
+}
+
+ClxTrnCacheStats GetClxTrnCacheStats()
+{
+	return TrnCache.stats();
+}
+
+void SetClxOutlineCacheBudget(size_t bytes)
+{
+	OutlineCacheBudget.store(bytes, std::memory_order_relaxed);
+}
+
+ClxOutlineCacheStats GetClxOutlineCacheStats()
+{
+	return ClxOutlineCacheStats {
+		OutlineCacheStats.hits.load(std::memory_order_relaxed),
+		OutlineCacheStats.misses.load(std::memory_order_relaxed),
+		OutlineCacheStats.evictions.load(std::memory_order_relaxed),
+		OutlineCacheStats.entries.load(std::memory_order_relaxed),
+		OutlineCacheStats.bytes.load(std::memory_order_relaxed),
+	};
 }
 
 } // namespace devilution
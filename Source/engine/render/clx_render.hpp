@@ -5,6 +5,7 @@
  */
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <utility>
 
@@ -124,6 +125,78 @@ std::pair<int, int> ClxMeasureSolidHorizontalBounds(ClxSprite clx);
  */
 void ClearClxDrawCache();
 
+struct ClxRunCacheStats {
+	size_t hits;
+	size_t misses;
+	size_t evictions;
+	size_t entries;
+
+	/** @brief Memory used by the cached runs. */
+	size_t bytes;
+};
+
+/**
+ * @brief Sets the memory budget of the decoded-run cache.
+ *
+ * When enabled, the CLX draw functions decode each sprite's commands into
+ * per-line runs once and reuse them on subsequent draws.
+ * The least recently drawn sprites are evicted when the budget is exceeded.
+ * Only draws on the calling thread use the cache.
+ *
+ * The cache is enabled on the main thread with a budget of `DEVILUTIONX_CLX_RUN_CACHE_BUDGET` bytes.
+ *
+ * @param bytes Memory budget, 0 disables the cache.
+ */
+void SetClxRunCacheBudget(size_t bytes);
+
+ClxRunCacheStats GetClxRunCacheStats();
+
+struct ClxTrnCacheStats {
+	size_t hits;
+	size_t misses;
+	size_t evictions;
+	size_t entries;
+
+	/** @brief Memory used by the translated sprites and the copies they are checked against. */
+	size_t bytes;
+};
+
+/**
+ * @brief Sets the memory budget of the cache of sprites with a TRN applied.
+ *
+ * `ClxDrawTRN` and `ClxDrawBlendedTRN` translate a sprite that is drawn repeatedly
+ * with the same TRN once and draw the copy with the plain blits afterwards.
+ * Only draws on the calling thread use the cache.
+ *
+ * @param bytes Memory budget, 0 disables the cache.
+ */
+void SetClxTrnCacheBudget(size_t bytes);
+
+ClxTrnCacheStats GetClxTrnCacheStats();
+
+struct ClxOutlineCacheStats {
+	size_t hits;
+	size_t misses;
+	size_t evictions;
+	size_t entries;
+
+	/** @brief Memory used by the cached outlines of all threads. */
+	size_t bytes;
+};
+
+/**
+ * @brief Sets the memory budget of the outline cache of each drawing thread.
+ *
+ * `ClxDrawOutline` and `ClxDrawOutlineSkipColorZero` keep the outlines of the
+ * sprites they draw, the least recently drawn ones are evicted when a thread's
+ * outlines take up more memory than this. The last outline is always kept.
+ *
+ * @param bytes Memory budget per thread.
+ */
+void SetClxOutlineCacheBudget(size_t bytes);
+
+ClxOutlineCacheStats GetClxOutlineCacheStats();
+
 #ifdef DEBUG_CLX
 std::string ClxDescribe(ClxSprite clx);
 #endif
@@ -1,8 +1,10 @@
 #include "engine/render/light_render.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
+#include <cstdlib>
 #include <cstdint>
 #include <cstring>
 #include <span>
@@ -420,53 +422,71 @@ void RenderCell(uint8_t quad[4], Point position, uint8_t lightLevel, uint8_t *li
 	}
 }
 
-void BuildLightmap(Point tilePosition, Point targetBufferPosition, uint16_t viewportWidth, uint16_t viewportHeight,
-    int rows, int columns, const uint8_t tileLights[MAXDUNX][MAXDUNY], uint_fast8_t microTileLen)
-{
-	// Since light may need to bleed up to the top of wall tiles,
-	// expand the buffer space to include the full base diamond of the tallest tile graphics
-	const uint16_t bufferHeight = viewportHeight + (TILE_HEIGHT * (microTileLen / 2 + 1));
-	rows += microTileLen + 2;
+/** @brief Pixel bounds of a part of the lightmap, the end coordinates are exclusive. */
+struct LightmapRect {
+	int x0;
+	int y0;
+	int x1;
+	int y1;
 
-	const size_t totalPixels = static_cast<size_t>(viewportWidth) * bufferHeight;
-	LightmapBuffer.resize(totalPixels);
+	[[nodiscard]] bool intersects(const LightmapRect &other) const
+	{
+		return x0 < other.x1 && other.x0 < x1 && y0 < other.y1 && other.y0 < y1;
+	}
+};
+
+/**
+ * @brief What the lightmap buffer was last built from.
+ *
+ * Tiles whose light level hasn't changed produce the same pixels as in the previous frame,
+ * so only the cells around changed tiles need to be rendered again.
+ */
+struct LightmapCacheState {
+	bool valid = false;
+	uint16_t viewportWidth;
+	uint16_t bufferHeight;
+	int rows;
+	int columns;
+	/** @brief Buffer position of the cell for tile (0, 0), used to shift the buffer when the view scrolls. */
+	Displacement worldOrigin;
+	uint8_t tileLights[MAXDUNX][MAXDUNY];
+};
+
+LightmapCacheState LightmapCache;
+
+std::vector<LightmapRect> LightmapDirtyRects;
+
+/** @brief If more than this fraction of the cells has changed, the whole lightmap is rebuilt. */
+constexpr int LightmapMaxDirtyCellsPercent = 50;
+
+Displacement GetLightmapWorldOrigin(Point tilePosition, Point targetBufferPosition)
+{
+	const Point center0 = targetBufferPosition + Displacement { TILE_WIDTH / 2, -TILE_HEIGHT / 2 };
+	return Displacement {
+		center0.x - (tilePosition.x - tilePosition.y) * (TILE_WIDTH / 2),
+		center0.y - (tilePosition.x + tilePosition.y) * (TILE_HEIGHT / 2),
+	};
+}
 
-	// Since rendering occurs in cells between quads,
-	// expand the rendering space to include tiles outside the viewport
-	tilePosition += Displacement(Direction::NorthWest) * 2;
-	targetBufferPosition -= Displacement { TILE_WIDTH, TILE_HEIGHT };
-	rows += 3;
-	columns++;
+LightmapRect GetCellBounds(Point center0)
+{
+	return LightmapRect {
+		center0.x - TILE_WIDTH / 2,
+		center0.y,
+		center0.x + TILE_WIDTH / 2,
+		center0.y + TILE_HEIGHT,
+	};
+}
 
-	uint8_t *lightmap = LightmapBuffer.data();
-	memset(lightmap, LightsMax, totalPixels);
+/**
+ * @brief Calls `fn(tile, center0)` for every cell of the lightmap, in rendering order.
+ */
+template <typename F>
+void ForEachLightmapCell(Point tilePosition, Point targetBufferPosition, int rows, int columns, F &&fn)
+{
 	for (int i = 0; i < rows; i++) {
 		for (int j = 0; j < columns; j++, tilePosition += Direction::East, targetBufferPosition.x += TILE_WIDTH) {
-			const Point center0 = targetBufferPosition + Displacement { TILE_WIDTH / 2, -TILE_HEIGHT / 2 };
-
-			const Point tile0 = tilePosition;
-			const Point tile1 = tilePosition + Displacement { 1, 0 };
-			const Point tile2 = tilePosition + Displacement { 1, 1 };
-			const Point tile3 = tilePosition + Displacement { 0, 1 };
-
-			uint8_t quad[] = {
-				GetLightLevel(tileLights, tile0),
-				GetLightLevel(tileLights, tile1),
-				GetLightLevel(tileLights, tile2),
-				GetLightLevel(tileLights, tile3)
-			};
-
-			const uint8_t maxLight = std::max({ quad[0], quad[1], quad[2], quad[3] });
-			const uint8_t minLight = std::min({ quad[0], quad[1], quad[2], quad[3] });
-
-			for (uint8_t i = 0; i < LightsMax; i++) {
-				const uint8_t lightLevel = LightsMax - i - 1;
-				if (lightLevel > maxLight)
-					continue;
-				if (lightLevel < minLight)
-					break;
-				RenderCell(quad, center0, lightLevel, lightmap, viewportWidth, bufferHeight);
-			}
+			fn(tilePosition, targetBufferPosition + Displacement { TILE_WIDTH / 2, -TILE_HEIGHT / 2 });
 		}
 
 		// Return to start of row
@@ -487,6 +507,180 @@ void BuildLightmap(Point tilePosition, Point targetBufferPosition, uint16_t view
 	}
 }
 
+std::array<uint8_t, 4> GetQuad(const uint8_t tileLights[MAXDUNX][MAXDUNY], Point tile)
+{
+	return {
+		GetLightLevel(tileLights, tile),
+		GetLightLevel(tileLights, tile + Displacement { 1, 0 }),
+		GetLightLevel(tileLights, tile + Displacement { 1, 1 }),
+		GetLightLevel(tileLights, tile + Displacement { 0, 1 }),
+	};
+}
+
+void RenderCellLevels(const uint8_t tileLights[MAXDUNX][MAXDUNY], Point tile, Point center0, uint8_t *lightmap, uint16_t pitch, uint16_t scanLines)
+{
+	std::array<uint8_t, 4> quad = GetQuad(tileLights, tile);
+
+	const uint8_t maxLight = std::max({ quad[0], quad[1], quad[2], quad[3] });
+	const uint8_t minLight = std::min({ quad[0], quad[1], quad[2], quad[3] });
+
+	for (uint8_t i = 0; i < LightsMax; i++) {
+		const uint8_t lightLevel = LightsMax - i - 1;
+		if (lightLevel > maxLight)
+			continue;
+		if (lightLevel < minLight)
+			break;
+		RenderCell(quad.data(), center0, lightLevel, lightmap, pitch, scanLines);
+	}
+}
+
+void ClearLightmapRect(uint8_t *lightmap, uint16_t pitch, uint16_t scanLines, LightmapRect rect)
+{
+	const int x0 = std::max(rect.x0, 0);
+	const int x1 = std::min<int>(rect.x1, pitch);
+	const int y0 = std::max(rect.y0, 0);
+	const int y1 = std::min<int>(rect.y1, scanLines);
+	if (x0 >= x1) return;
+	for (int y = y0; y < y1; y++)
+		memset(&lightmap[static_cast<size_t>(y) * pitch + x0], LightsMax, x1 - x0);
+}
+
+/**
+ * @brief Moves the contents of the lightmap by the given amount of pixels.
+ *
+ * The exposed edges keep stale data and have to be rendered again.
+ */
+void ShiftLightmap(uint8_t *lightmap, uint16_t pitch, uint16_t scanLines, Displacement delta)
+{
+	const int width = pitch - std::abs(delta.deltaX);
+	const int srcX = std::max(0, -delta.deltaX);
+	const int dstX = std::max(0, delta.deltaX);
+	const auto moveRow = [&](int y) {
+		memmove(&lightmap[static_cast<size_t>(y) * pitch + dstX], &lightmap[static_cast<size_t>(y - delta.deltaY) * pitch + srcX], width);
+	};
+	if (delta.deltaY > 0) {
+		for (int y = scanLines - 1; y >= delta.deltaY; y--)
+			moveRow(y);
+	} else {
+		for (int y = 0; y < scanLines + delta.deltaY; y++)
+			moveRow(y);
+	}
+}
+
+/**
+ * @brief Works out which parts of the lightmap are out of date.
+ *
+ * @return false if the whole lightmap needs to be rebuilt.
+ */
+bool UpdateLightmapCache(Point tilePosition, Point targetBufferPosition, uint16_t viewportWidth, uint16_t bufferHeight,
+    int rows, int columns, const uint8_t tileLights[MAXDUNX][MAXDUNY])
+{
+	LightmapCacheState &cache = LightmapCache;
+	LightmapDirtyRects.clear();
+
+	const Displacement worldOrigin = GetLightmapWorldOrigin(tilePosition, targetBufferPosition);
+	const bool sameLayout = cache.valid && cache.viewportWidth == viewportWidth && cache.bufferHeight == bufferHeight
+	    && cache.rows == rows && cache.columns == columns;
+	const Displacement delta = worldOrigin - cache.worldOrigin;
+
+	const bool canReuse = sameLayout
+	    && std::abs(delta.deltaX) < viewportWidth / 2 && std::abs(delta.deltaY) < bufferHeight / 2;
+
+	cache.valid = true;
+	cache.viewportWidth = viewportWidth;
+	cache.bufferHeight = bufferHeight;
+	cache.rows = rows;
+	cache.columns = columns;
+	cache.worldOrigin = worldOrigin;
+
+	if (!canReuse) {
+		memcpy(cache.tileLights, tileLights, sizeof(cache.tileLights));
+		return false;
+	}
+
+	if (delta != Displacement { 0, 0 }) {
+		ShiftLightmap(LightmapBuffer.data(), viewportWidth, bufferHeight, delta);
+
+		// The edges of the area covered by the cells move along with the view,
+		// so also redo a tile's worth of pixels next to the exposed edges.
+		if (delta.deltaX > 0)
+			LightmapDirtyRects.push_back({ 0, 0, delta.deltaX + TILE_WIDTH, bufferHeight });
+		else if (delta.deltaX < 0)
+			LightmapDirtyRects.push_back({ viewportWidth + delta.deltaX - TILE_WIDTH, 0, viewportWidth, bufferHeight });
+		if (delta.deltaY > 0)
+			LightmapDirtyRects.push_back({ 0, 0, viewportWidth, delta.deltaY + TILE_HEIGHT });
+		else if (delta.deltaY < 0)
+			LightmapDirtyRects.push_back({ 0, bufferHeight + delta.deltaY - TILE_HEIGHT, viewportWidth, bufferHeight });
+	}
+
+	int totalCells = 0;
+	int dirtyCells = 0;
+	ForEachLightmapCell(tilePosition, targetBufferPosition, rows, columns, [&](Point tile, Point center0) {
+		totalCells++;
+		if (GetQuad(tileLights, tile) == GetQuad(cache.tileLights, tile))
+			return;
+		dirtyCells++;
+		const LightmapRect bounds = GetCellBounds(center0);
+		if (!LightmapDirtyRects.empty()) {
+			// Cells along a row are adjacent, merge them into a single rectangle
+			LightmapRect &last = LightmapDirtyRects.back();
+			if (last.y0 == bounds.y0 && last.y1 == bounds.y1 && last.x1 == bounds.x0) {
+				last.x1 = bounds.x1;
+				return;
+			}
+		}
+		LightmapDirtyRects.push_back(bounds);
+	});
+
+	memcpy(cache.tileLights, tileLights, sizeof(cache.tileLights));
+	return dirtyCells * 100 <= totalCells * LightmapMaxDirtyCellsPercent;
+}
+
+void BuildLightmap(Point tilePosition, Point targetBufferPosition, uint16_t viewportWidth, uint16_t viewportHeight,
+    int rows, int columns, const uint8_t tileLights[MAXDUNX][MAXDUNY], uint_fast8_t microTileLen)
+{
+	// Since light may need to bleed up to the top of wall tiles,
+	// expand the buffer space to include the full base diamond of the tallest tile graphics
+	const uint16_t bufferHeight = viewportHeight + (TILE_HEIGHT * (microTileLen / 2 + 1));
+	rows += microTileLen + 2;
+
+	const size_t totalPixels = static_cast<size_t>(viewportWidth) * bufferHeight;
+	LightmapBuffer.resize(totalPixels);
+
+	// Since rendering occurs in cells between quads,
+	// expand the rendering space to include tiles outside the viewport
+	tilePosition += Displacement(Direction::NorthWest) * 2;
+	targetBufferPosition -= Displacement { TILE_WIDTH, TILE_HEIGHT };
+	rows += 3;
+	columns++;
+
+	uint8_t *lightmap = LightmapBuffer.data();
+	if (!UpdateLightmapCache(tilePosition, targetBufferPosition, viewportWidth, bufferHeight, rows, columns, tileLights)) {
+		memset(lightmap, LightsMax, totalPixels);
+		ForEachLightmapCell(tilePosition, targetBufferPosition, rows, columns, [&](Point tile, Point center0) {
+			RenderCellLevels(tileLights, tile, center0, lightmap, viewportWidth, bufferHeight);
+		});
+		return;
+	}
+
+	if (LightmapDirtyRects.empty())
+		return;
+
+	// Clear everything first, since the cells overlapping a dirty rectangle draw outside of it,
+	// then render them in the usual order so the result matches a full rebuild.
+	for (const LightmapRect &rect : LightmapDirtyRects)
+		ClearLightmapRect(lightmap, viewportWidth, bufferHeight, rect);
+	ForEachLightmapCell(tilePosition, targetBufferPosition, rows, columns, [&](Point tile, Point center0) {
+		const LightmapRect bounds = GetCellBounds(center0);
+		for (const LightmapRect &rect : LightmapDirtyRects) {
+			if (bounds.intersects(rect)) {
+				RenderCellLevels(tileLights, tile, center0, lightmap, viewportWidth, bufferHeight);
+				break;
+			}
+		}
+	});
+}
+
 } // namespace
 
 Lightmap::Lightmap(const uint8_t *outBuffer, uint16_t outPitch,
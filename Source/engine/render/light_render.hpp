@@ -46,6 +46,17 @@ public:
 		return lightmapBuffer.data() + row * lightmapPitch + rowOffset;
 	}
 
+	/** @brief All the light tables as a single contiguous `NumLightingLevels * LightTableSize` array. */
+	[[nodiscard]] const uint8_t *lightTablesData() const { return lightTables.data()->data(); }
+
+	/**
+	 * @brief The same lighting for rendering to another buffer with the same dimensions as the original output buffer.
+	 */
+	[[nodiscard]] Lightmap withOutBuffer(const uint8_t *buffer, uint16_t pitch) const
+	{
+		return Lightmap(buffer, pitch, lightmapBuffer, lightmapPitch, lightTables, fullyLitLightTable_, fullyDarkLightTable_);
+	}
+
 	[[nodiscard]] bool isFullyLitLightTable(const uint8_t *lightTable) const { return lightTable == fullyLitLightTable_; }
 	[[nodiscard]] bool isFullyDarkLightTable(const uint8_t *lightTable) const { return lightTable == fullyDarkLightTable_; }
 
@@ -1,10 +1,12 @@
 #include "engine/render/primitive_render.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cstring>
 
 #include "engine/point.hpp"
+#include "engine/render/blit_kernels.hpp"
 #include "engine/size.hpp"
 #include "engine/surface.hpp"
 #include "utils/palette_blending.hpp"
@@ -12,20 +14,34 @@
 namespace devilution {
 namespace {
 
+/**
+ * @brief Blends a span of pixels with a color of the transparency lookup table.
+ *
+ * Spans long enough for it go through the vectorized kernel of the current ISA.
+ */
+void BlendSpan(uint8_t *dst, unsigned width, const uint8_t *lookupTable, BlitFillBlendedKernel kernel)
+{
+	if (width >= BlitKernelMinLength && kernel != nullptr) {
+		kernel(dst, width, lookupTable);
+		return;
+	}
+	for (uint8_t *const end = dst + width; dst != end; ++dst) {
+		*dst = lookupTable[*dst];
+	}
+}
+
 void DrawHalfTransparentUnalignedBlendedRectTo(const Surface &out, unsigned sx, unsigned sy, unsigned width, unsigned height, uint8_t color)
 {
 	uint8_t *pix = out.at(static_cast<int>(sx), static_cast<int>(sy));
 	const uint8_t *const lookupTable = paletteTransparencyLookup[color];
-	const unsigned skipX = out.pitch() - width;
-	for (unsigned y = 0; y < height; ++y) {
-		for (unsigned x = 0; x < width; ++x, ++pix) {
-			*pix = lookupTable[*pix];
-		}
-		pix += skipX;
+	const BlitFillBlendedKernel kernel = ActiveBlitKernels.fillBlended;
+	for (unsigned y = 0; y < height; ++y, pix += out.pitch()) {
+		BlendSpan(pix, width, lookupTable, kernel);
 	}
 }
 
 #if DEVILUTIONX_PALETTE_TRANSPARENCY_BLACK_16_LUT
+// Two pixels per lookup, faster than the vectorized kernels' per-pixel gathers.
 // Expects everything to be 4-byte aligned.
 void DrawHalfTransparentAligned32BlendedRectTo(const Surface &out, unsigned sx, unsigned sy, unsigned width, unsigned height)
 {
@@ -54,10 +70,12 @@ void DrawHalfTransparentBlendedRectTo(const Surface &out, unsigned sx, unsigned
 
 	// First, draw the leading unaligned part.
 	if (sx % 4 != 0) {
-		const unsigned w = 4 - (sx % 4);
+		const unsigned w = std::min(4 - (sx % 4), width);
 		DrawHalfTransparentUnalignedBlendedRectTo(out, sx, sy, w, height, 0);
 		sx += w;
 		width -= w;
+		if (width == 0)
+			return;
 	}
 
 	if (static_cast<int>(sx + width) == out.w()) {
@@ -74,15 +92,38 @@ void DrawHalfTransparentBlendedRectTo(const Surface &out, unsigned sx, unsigned
 	DrawHalfTransparentAligned32BlendedRectTo(out, sx, sy, width, height);
 }
 #else
-#define DrawHalfTransparentBlendedRectTo DrawHalfTransparentUnalignedBlendedRectTo
+void DrawHalfTransparentBlendedRectTo(const Surface &out, unsigned sx, unsigned sy, unsigned width, unsigned height)
+{
+	DrawHalfTransparentUnalignedBlendedRectTo(out, sx, sy, width, height, 0);
+}
 #endif
 
 } // namespace
 
 void FillRect(const Surface &out, int x, int y, int width, int height, uint8_t colorIndex)
 {
-	for (int j = 0; j < height; j++) {
-		DrawHorizontalLine(out, { x, y + j }, width, colorIndex);
+	if (width <= 0 || height <= 0 || x >= out.w() || y >= out.h() || x + width <= 0 || y + height <= 0)
+		return;
+	if (x < 0) {
+		width += x;
+		x = 0;
+	}
+	if (y < 0) {
+		height += y;
+		y = 0;
+	}
+	width = std::min(width, out.w() - x);
+	height = std::min(height, out.h() - y);
+
+	uint8_t *dst = out.at(x, y);
+	const int pitch = out.pitch();
+	if (width == pitch) {
+		// The rows are contiguous, e.g. when clearing a whole buffer.
+		std::memset(dst, colorIndex, static_cast<size_t>(width) * height);
+		return;
+	}
+	for (int j = 0; j < height; ++j, dst += pitch) {
+		std::memset(dst, colorIndex, width);
 	}
 }
 
@@ -136,9 +177,7 @@ void DrawHalfTransparentHorizontalLine(const Surface &out, Point from, int width
 	const int x0 = std::max(0, from.x);
 	const int x1 = std::min(out.w(), from.x + width);
 
-	for (int x = x0; x < x1; ++x) {
-		SetHalfTransparentPixel(out, { x, from.y }, colorIndex);
-	}
+	BlendSpan(out.at(x0, from.y), static_cast<unsigned>(x1 - x0), paletteTransparencyLookup[colorIndex], ActiveBlitKernels.fillBlended);
 }
 
 // Draw a half-transparent vertical line of `height` pixels starting at `from`.
@@ -5,9 +5,16 @@
  */
 #include "engine/render/scrollrt.h"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_keyboard.h>
@@ -30,11 +37,15 @@
 #include "engine/backbuffer_state.hpp"
 #include "engine/displacement.hpp"
 #include "engine/dx.h"
+#include "engine/frame_pacer.hpp"
+#include "engine/palette.h"
 #include "engine/point.hpp"
 #include "engine/render/clx_render.hpp"
 #include "engine/render/dun_render.hpp"
 #include "engine/render/light_render.hpp"
+#include "engine/render/primitive_render.hpp"
 #include "engine/render/text_render.hpp"
+#include "engine/size.hpp"
 #include "engine/trn.hpp"
 #include "engine/world_tile.hpp"
 #include "game_mode.hpp"
@@ -69,10 +80,15 @@
 #include "towners.h"
 #include "utils/attributes.h"
 #include "utils/display.h"
+#include "utils/enum_traits.h"
+#include "utils/frame_profiler.hpp"
 #include "utils/is_of.hpp"
 #include "utils/log.hpp"
+#include "utils/palette_blending.hpp"
 #include "utils/sdl_compat.h"
+#include "utils/static_vector.hpp"
 #include "utils/str_cat.hpp"
+#include "utils/task_graph.hpp"
 
 #ifndef USE_SDL1
 #include "controls/touch/renderers.h"
@@ -86,6 +102,14 @@
 #include "utils/format_int.hpp"
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DEVILUTIONX_ZOOM_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define DEVILUTIONX_ZOOM_NEON
+#include <arm_neon.h>
+#endif
+
 namespace devilution {
 
 enum OutlineColors : uint8_t {
@@ -120,9 +144,96 @@ constexpr auto RightFrameDisplacement = Displacement { DunFrameWidth, 0 };
 }
 
 /**
- * @brief Contains all Missile at rendering position
+ * @brief Contains all Missile, grouped by rendering position and in the order of Missiles within a position
+ */
+std::vector<Missile *> MissilesByRenderingTile;
+
+/** @brief A range of MissilesByRenderingTile. */
+struct MissileRange {
+	uint32_t begin;
+	uint32_t count;
+};
+
+/**
+ * @brief The missiles at each rendering position, kept in MissilesByRenderingTile so that rebuilding them every frame doesn't allocate
+ */
+ankerl::unordered_dense::map<WorldTilePosition, MissileRange> MissilesAtRenderingTile;
+
+std::span<Missile *const> GetMissilesAtRenderingTile(WorldTilePosition tilePosition)
+{
+	const auto it = MissilesAtRenderingTile.find(tilePosition);
+	if (it == MissilesAtRenderingTile.end())
+		return {};
+	return { MissilesByRenderingTile.data() + it->second.begin, it->second.count };
+}
+
+/**
+ * @brief The level state of a tile that the world passes read, packed into one record.
+ *
+ * The passes walk the view diagonally, so reading each of the level arrays directly
+ * touches a separate cache line per array for every tile.
  */
-ankerl::unordered_dense::map<WorldTilePosition, std::vector<Missile *>> MissilesAtRenderingTile;
+struct RenderTile {
+	uint16_t piece;
+	int16_t monster;
+	uint8_t light;
+	DungeonFlag flags;
+	int8_t transVal;
+	int8_t special;
+	int8_t corpse;
+	int8_t object;
+	int8_t item;
+	int8_t player;
+};
+
+/**
+ * @brief A copy of the level state of the tiles in view, taken once per frame before anything is drawn.
+ *
+ * Covers the bounding box of the view plus a tile on every side, for the neighbours the passes look at.
+ * The tiles are kept in the same column order as the level arrays, so that filling it reads them sequentially.
+ */
+struct RenderTileView {
+	Point origin;
+	Size size;
+	std::vector<RenderTile> tiles;
+
+	[[nodiscard]] const RenderTile &at(Point tilePosition) const
+	{
+		const Displacement local = tilePosition - origin;
+		assert(local.deltaX >= 0 && local.deltaX < size.width && local.deltaY >= 0 && local.deltaY < size.height);
+		return tiles[static_cast<size_t>(local.deltaX) * size.height + local.deltaY];
+	}
+};
+
+RenderTileView RenderTiles;
+
+/**
+ * @brief Whether the first wall micros of a piece are opaque squares.
+ *
+ * These cover the whole floor of the tile behind the piece, the tile at {-1, -1}, unless the wall is see-through.
+ */
+std::array<bool, MAXTILES> PieceCoversFloorBehind;
+
+struct VisibleTile {
+	Point tilePosition;
+	/** @brief Viewport coordinates of the tile. */
+	Point bufferPosition;
+	/** @brief The tile is a floor tile that isn't hidden behind the wall in front of it. */
+	bool drawFloor;
+};
+
+/** @brief The tiles in view of the floor passes, built once per frame after `RenderTiles`. */
+std::vector<VisibleTile> VisibleTiles;
+
+FloorOcclusionStats VisibleFloorStats;
+
+/**
+ * @brief Screen position of the surface the world is rendered to, relative to the viewport.
+ *
+ * Non-zero while only a part of the viewport is being redrawn.
+ * Anything that depends on the absolute screen position of a tile has to add it back.
+ */
+thread_local Displacement RenderOrigin;
 
 /**
  * @brief Could the missile (at the next game tick) collide? This method is a simplified version of CheckMissileCol (for example without random).
@@ -200,9 +311,21 @@ void UpdateMissilesRendererData()
 {
 	MissilesAtRenderingTile.clear();
 
+	// Count the missiles at each position, then hand out the ranges and fill them in list order
 	for (auto &m : Missiles) {
 		UpdateMissileRendererData(m);
-		MissilesAtRenderingTile[m.position.tileForRendering].push_back(&m);
+		MissilesAtRenderingTile[m.position.tileForRendering].count++;
+	}
+	uint32_t begin = 0;
+	for (auto &[position, range] : MissilesAtRenderingTile) {
+		range.begin = begin;
+		begin += range.count;
+		range.count = 0;
+	}
+	MissilesByRenderingTile.resize(begin);
+	for (auto &m : Missiles) {
+		MissileRange &range = MissilesAtRenderingTile.find(m.position.tileForRendering)->second;
+		MissilesByRenderingTile[range.begin + range.count++] = &m;
 	}
 }
 
@@ -241,35 +364,130 @@ bool ShouldShowCursor()
 	return false;
 }
 
-/**
- * @brief Blit CL2 sprite, and apply lighting, to the given buffer at the given coordinates
- * @param out Output buffer
- * @param position Target buffer coordinate
- * @param clx CLX frame
- */
-inline void ClxDrawLight(const Surface &out, Point position, ClxSprite clx, int lightTableIndex)
-{
-	if (lightTableIndex != 0) {
-		ClxDrawTRN(out, position, clx, LightTables[lightTableIndex].data());
-	} else {
-		ClxDraw(out, position, clx);
+enum class DrawCommandType : uint8_t {
+	/** @brief The micro tiles of a dungeon piece, see DrawCell. */
+	Cell,
+	BlackTile,
+	Sprite,
+	SpriteTrn,
+	SpriteBlended,
+	SpriteBlendedTrn,
+	SpriteOutline,
+	/** @brief A wall sprite lit by the per-pixel lightmap, with the light bled up the wall. */
+	SpriteWithLightmap,
+	SpriteBlendedWithLightmap,
+};
+
+/** @brief A single draw call of the world passes. */
+struct DrawCommand {
+	DrawCommandType type;
+	uint8_t lightTableIndex;
+	uint8_t outlineColor;
+	/** @brief Viewport coordinates of the bottom left corner of the sprite or tile. */
+	Point position;
+	/** @brief dPiece coordinates, only used by cells. */
+	Point tilePosition;
+	/** @brief Empty for cells and black tiles. */
+	OptionalClxSprite sprite;
+	const uint8_t *trn;
+
+	/** @brief The part of the viewport that the command can draw to. */
+	[[nodiscard]] Rectangle bounds() const
+	{
+		switch (type) {
+		case DrawCommandType::Cell:
+			return { { position.x, position.y - (MicroTileLen / 2) * TILE_HEIGHT }, { TILE_WIDTH, (MicroTileLen / 2) * TILE_HEIGHT + 1 } };
+		case DrawCommandType::BlackTile:
+			return { { position.x, position.y - TILE_HEIGHT }, { TILE_WIDTH, TILE_HEIGHT + 1 } };
+		default:
+			// One extra pixel on every side for the outlines
+			return { { position.x - 1, position.y - sprite->height() - 1 }, { sprite->width() + 2, sprite->height() + 3 } };
+		}
 	}
-}
+};
 
 /**
- * @brief Blit CL2 sprite, and apply lighting and transparency blending, to the given buffer at the given coordinates
- * @param out Output buffer
- * @param position Target buffer coordinate
- * @param clx CLX frame
+ * @brief The draw calls of the world passes for one frame, in painter's order.
+ *
+ * The tiles in view are walked once on the main thread to record the commands, which
+ * also takes care of the side effects of drawing such as queueing the item labels.
+ * Executing the list only reads the level, so it can be done for several bands of the
+ * viewport at once, and commands that miss the part being drawn are skipped.
  */
-inline void ClxDrawLightBlended(const Surface &out, Point position, ClxSprite clx, int lightTableIndex)
-{
-	if (lightTableIndex != 0) {
-		ClxDrawBlendedTRN(out, position, clx, LightTables[lightTableIndex].data());
-	} else {
-		ClxDrawBlended(out, position, clx);
+class DisplayList {
+public:
+	void clear()
+	{
+		commands_.clear();
 	}
-}
+
+	void cell(Point tilePosition, Point position, int lightTableIndex)
+	{
+		commands_.push_back({ .type = DrawCommandType::Cell, .lightTableIndex = static_cast<uint8_t>(lightTableIndex), .position = position, .tilePosition = tilePosition });
+	}
+
+	void blackTile(Point position)
+	{
+		commands_.push_back({ .type = DrawCommandType::BlackTile, .position = position });
+	}
+
+	void draw(Point position, ClxSprite sprite)
+	{
+		addSprite(DrawCommandType::Sprite, position, sprite);
+	}
+
+	void trn(Point position, ClxSprite sprite, const uint8_t *trn)
+	{
+		addSprite(DrawCommandType::SpriteTrn, position, sprite, trn);
+	}
+
+	/** @brief Draws the sprite with lighting applied. */
+	void light(Point position, ClxSprite sprite, int lightTableIndex)
+	{
+		if (lightTableIndex != 0)
+			trn(position, sprite, LightTables[lightTableIndex].data());
+		else
+			draw(position, sprite);
+	}
+
+	/** @brief Draws the sprite with lighting and transparency blending applied. */
+	void lightBlended(Point position, ClxSprite sprite, int lightTableIndex)
+	{
+		if (lightTableIndex != 0)
+			addSprite(DrawCommandType::SpriteBlendedTrn, position, sprite, LightTables[lightTableIndex].data());
+		else
+			addSprite(DrawCommandType::SpriteBlended, position, sprite);
+	}
+
+	/** @brief Draws the outline of the sprite, see ClxDrawOutlineSkipColorZero. */
+	void outline(uint8_t color, Point position, ClxSprite sprite)
+	{
+		addSprite(DrawCommandType::SpriteOutline, position, sprite, nullptr, color);
+	}
+
+	void withLightmap(Point position, ClxSprite sprite, bool blended)
+	{
+		addSprite(blended ? DrawCommandType::SpriteBlendedWithLightmap : DrawCommandType::SpriteWithLightmap, position, sprite);
+	}
+
+	[[nodiscard]] std::span<const DrawCommand> commands() const
+	{
+		return commands_;
+	}
+
+private:
+	void addSprite(DrawCommandType type, Point position, ClxSprite sprite, const uint8_t *trn = nullptr, uint8_t outlineColor = 0)
+	{
+		DrawCommand &command = commands_.emplace_back(DrawCommand { .type = type, .outlineColor = outlineColor, .position = position, .trn = trn });
+		command.sprite = sprite;
+	}
+
+	std::vector<DrawCommand> commands_;
+};
+
+DisplayList WorldDisplayList;
+
+DisplayListStats WorldDisplayListStats;
 
 /**
  * @brief Save the content behind the cursor to a temporary buffer, then draw the cursor.
@@ -329,12 +547,12 @@ void DrawCursor(const Surface &out)
 
 /**
  * @brief Render a missile sprite
- * @param out Output buffer
+ * @param list Display list to record the draw commands in
  * @param missile Pointer to Missile struct
  * @param targetBufferPosition Output buffer coordinate
  * @param pre Is the sprite in the background
  */
-void DrawMissilePrivate(const Surface &out, const Missile &missile, Point targetBufferPosition, bool pre, int lightTableIndex)
+void DrawMissilePrivate(DisplayList &list, const Missile &missile, Point targetBufferPosition, bool pre, int lightTableIndex)
 {
 	if (missile._miPreFlag != pre || !missile._miDrawFlag)
 		return;
@@ -342,38 +560,36 @@ void DrawMissilePrivate(const Surface &out, const Missile &missile, Point target
 	const Point missileRenderPosition { targetBufferPosition + missile.position.offsetForRendering - Displacement { missile._miAnimWidth2, 0 } };
 	const ClxSprite sprite = (*missile._miAnimData)[missile._miAnimFrame - 1];
 	if (missile._miUniqTrans != 0) {
-		ClxDrawTRN(out, missileRenderPosition, sprite, Monsters[missile._misource].uniqueMonsterTRN.get());
+		list.trn(missileRenderPosition, sprite, Monsters[missile._misource].uniqueMonsterTRN.get());
 	} else if (missile._miLightFlag) {
-		ClxDrawLight(out, missileRenderPosition, sprite, lightTableIndex);
+		list.light(missileRenderPosition, sprite, lightTableIndex);
 	} else {
-		ClxDraw(out, missileRenderPosition, sprite);
+		list.draw(missileRenderPosition, sprite);
 	}
 }
 
 /**
  * @brief Render a missile sprites for a given tile
- * @param out Output buffer
+ * @param list Display list to record the draw commands in
  * @param tilePosition dPiece coordinates
  * @param targetBufferPosition Output buffer coordinates
  * @param pre Is the sprite in the background
  */
-void DrawMissile(const Surface &out, WorldTilePosition tilePosition, Point targetBufferPosition, bool pre, int lightTableIndex)
+void DrawMissile(DisplayList &list, WorldTilePosition tilePosition, Point targetBufferPosition, bool pre, int lightTableIndex)
 {
-	const auto it = MissilesAtRenderingTile.find(tilePosition);
-	if (it == MissilesAtRenderingTile.end()) return;
-	for (Missile *missile : it->second) {
-		DrawMissilePrivate(out, *missile, targetBufferPosition, pre, lightTableIndex);
+	for (Missile *missile : GetMissilesAtRenderingTile(tilePosition)) {
+		DrawMissilePrivate(list, *missile, targetBufferPosition, pre, lightTableIndex);
 	}
 }
 
 /**
  * @brief Render a monster sprite
- * @param out Output buffer
+ * @param list Display list to record the draw commands in
  * @param tilePosition dPiece coordinates
  * @param targetBufferPosition Output buffer coordinates
  * @param monster Monster reference
  */
-void DrawMonster(const Surface &out, Point tilePosition, Point targetBufferPosition, const Monster &monster, int lightTableIndex)
+void DrawMonster(DisplayList &list, Point tilePosition, Point targetBufferPosition, const Monster &monster, int lightTableIndex)
 {
 	if (!monster.animInfo.sprites) {
 		Log("Draw Monster \"{}\": NULL Cel Buffer", monster.name());
@@ -383,7 +599,7 @@ void DrawMonster(const Surface &out, Point tilePosition, Point targetBufferPosit
 	const ClxSprite sprite = monster.animInfo.currentSprite();
 
 	if (!IsTileLit(tilePosition)) {
-		ClxDrawTRN(out, targetBufferPosition, sprite, GetInfravisionTRN());
+		list.trn(targetBufferPosition, sprite, GetInfravisionTRN());
 		return;
 	}
 	uint8_t *trn = nullptr;
@@ -394,15 +610,15 @@ void DrawMonster(const Surface &out, Point tilePosition, Point targetBufferPosit
 	if (MyPlayer->_pInfraFlag && lightTableIndex > 8)
 		trn = GetInfravisionTRN();
 	if (trn != nullptr)
-		ClxDrawTRN(out, targetBufferPosition, sprite, trn);
+		list.trn(targetBufferPosition, sprite, trn);
 	else
-		ClxDrawLight(out, targetBufferPosition, sprite, lightTableIndex);
+		list.light(targetBufferPosition, sprite, lightTableIndex);
 }
 
 /**
  * @brief Helper for rendering a specific player icon (Mana Shield or Reflect)
  */
-void DrawPlayerIconHelper(const Surface &out, MissileGraphicID missileGraphicId, Point position, const Player &player, bool infraVision, int lightTableIndex)
+void DrawPlayerIconHelper(DisplayList &list, MissileGraphicID missileGraphicId, Point position, const Player &player, bool infraVision, int lightTableIndex)
 {
 	const bool lighting = &player != MyPlayer;
 
@@ -414,31 +630,31 @@ void DrawPlayerIconHelper(const Surface &out, MissileGraphicID missileGraphicId,
 	const ClxSprite sprite = (*GetMissileSpriteData(missileGraphicId).sprites).list()[0];
 
 	if (!lighting) {
-		ClxDraw(out, position, sprite);
+		list.draw(position, sprite);
 		return;
 	}
 
 	if (infraVision) {
-		ClxDrawTRN(out, position, sprite, GetInfravisionTRN());
+		list.trn(position, sprite, GetInfravisionTRN());
 		return;
 	}
 
-	ClxDrawLight(out, position, sprite, lightTableIndex);
+	list.light(position, sprite, lightTableIndex);
 }
 
 /**
  * @brief Helper for rendering player icons (Mana Shield and Reflect)
- * @param out Output buffer
+ * @param list Display list to record the draw commands in
  * @param player Player reference
  * @param position Output buffer coordinates
  * @param infraVision Should infravision be applied
  */
-void DrawPlayerIcons(const Surface &out, const Player &player, Point position, bool infraVision, int lightTableIndex)
+void DrawPlayerIcons(DisplayList &list, const Player &player, Point position, bool infraVision, int lightTableIndex)
 {
 	if (player.pManaShield)
-		DrawPlayerIconHelper(out, MissileGraphicID::ManaShield, position, player, infraVision, lightTableIndex);
+		DrawPlayerIconHelper(list, MissileGraphicID::ManaShield, position, player, infraVision, lightTableIndex);
 	if (player.wReflections > 0)
-		DrawPlayerIconHelper(out, MissileGraphicID::Reflect, position + Displacement { 0, 16 }, player, infraVision, lightTableIndex);
+		DrawPlayerIconHelper(list, MissileGraphicID::Reflect, position + Displacement { 0, 16 }, player, infraVision, lightTableIndex);
 }
 
 uint8_t GetPlayerOutlineColor(int id)
@@ -458,12 +674,12 @@ uint8_t GetPlayerOutlineColor(int id)
 
 /**
  * @brief Render a player sprite
- * @param out Output buffer
+ * @param list Display list to record the draw commands in
  * @param player Player reference
  * @param tilePosition dPiece coordinates
  * @param targetBufferPosition Output buffer coordinates
  */
-void DrawPlayer(const Surface &out, const Player &player, Point tilePosition, Point targetBufferPosition, int lightTableIndex)
+void DrawPlayer(DisplayList &list, const Player &player, Point tilePosition, Point targetBufferPosition, int lightTableIndex)
 {
 	if (!IsTileLit(tilePosition) && !MyPlayer->_pInfraFlag && !MyPlayer->isOnArenaLevel() && leveltype != DTYPE_TOWN) {
 		return;
@@ -473,70 +689,84 @@ void DrawPlayer(const Surface &out, const Player &player, Point tilePosition, Po
 	const Point spriteBufferPosition = targetBufferPosition + player.getRenderingOffset(sprite);
 
 	if (&player == PlayerUnderCursor)
-		ClxDrawOutlineSkipColorZero(out, GetPlayerOutlineColor(player.getId()), spriteBufferPosition, sprite);
+		list.outline(GetPlayerOutlineColor(player.getId()), spriteBufferPosition, sprite);
 
 	if (&player == MyPlayer && IsNoneOf(leveltype, DTYPE_NEST, DTYPE_CRYPT)) {
-		ClxDraw(out, spriteBufferPosition, sprite);
-		DrawPlayerIcons(out, player, targetBufferPosition, /*infraVision=*/false, lightTableIndex);
+		list.draw(spriteBufferPosition, sprite);
+		DrawPlayerIcons(list, player, targetBufferPosition, /*infraVision=*/false, lightTableIndex);
 		return;
 	}
 
 	if (!IsTileLit(tilePosition) || ((MyPlayer->_pInfraFlag || MyPlayer->isOnArenaLevel()) && lightTableIndex > 8)) {
-		ClxDrawTRN(out, spriteBufferPosition, sprite, GetInfravisionTRN());
-		DrawPlayerIcons(out, player, targetBufferPosition, /*infraVision=*/true, lightTableIndex);
+		list.trn(spriteBufferPosition, sprite, GetInfravisionTRN());
+		DrawPlayerIcons(list, player, targetBufferPosition, /*infraVision=*/true, lightTableIndex);
 		return;
 	}
 
 	lightTableIndex = std::max(lightTableIndex - 5, 0);
-	ClxDrawLight(out, spriteBufferPosition, sprite, lightTableIndex);
-	DrawPlayerIcons(out, player, targetBufferPosition, /*infraVision=*/false, lightTableIndex);
+	list.light(spriteBufferPosition, sprite, lightTableIndex);
+	DrawPlayerIcons(list, player, targetBufferPosition, /*infraVision=*/false, lightTableIndex);
 }
 
 /**
  * @brief Render a player sprite
- * @param out Output buffer
+ * @param list Display list to record the draw commands in
  * @param tilePosition dPiece coordinates
  * @param targetBufferPosition Output buffer coordinates
  */
-void DrawDeadPlayer(const Surface &out, Point tilePosition, Point targetBufferPosition, int lightTableIndex)
+bool IsDeadPlayerAt(const Player &player, Point tilePosition)
 {
-	dFlags[tilePosition.x][tilePosition.y] &= ~DungeonFlag::DeadPlayer;
+	return player.plractive && player.hasNoLife() && player.isOnActiveLevel() && player.position.tile == tilePosition;
+}
 
+/**
+ * @brief Clears the dead player flag of a tile if the corpse is gone.
+ */
+void UpdateDeadPlayerFlag(Point tilePosition)
+{
+	dFlags[tilePosition.x][tilePosition.y] &= ~DungeonFlag::DeadPlayer;
 	for (const Player &player : Players) {
-		if (player.plractive && player.hasNoLife() && player.isOnActiveLevel() && player.position.tile == tilePosition) {
+		if (IsDeadPlayerAt(player, tilePosition))
 			dFlags[tilePosition.x][tilePosition.y] |= DungeonFlag::DeadPlayer;
+	}
+}
+
+void DrawDeadPlayer(DisplayList &list, Point tilePosition, Point targetBufferPosition, int lightTableIndex)
+{
+	UpdateDeadPlayerFlag(tilePosition);
+
+	for (const Player &player : Players) {
+		if (IsDeadPlayerAt(player, tilePosition)) {
 			const Point playerRenderPosition { targetBufferPosition };
-			DrawPlayer(out, player, tilePosition, playerRenderPosition, lightTableIndex);
+			DrawPlayer(list, player, tilePosition, playerRenderPosition, lightTableIndex);
 		}
 	}
 }
 
 /**
  * @brief Render an object sprite
- * @param out Output buffer
+ * @param list Display list to record the draw commands in
  * @param objectToDraw Dungeone object to draw
  * @param tilePosition dPiece coordinates
  * @param targetBufferPosition Output buffer coordinates
  * @param pre Is the sprite in the background
  */
-void DrawObject(const Surface &out, const Object &objectToDraw, Point tilePosition, Point targetBufferPosition, int lightTableIndex)
+void DrawObject(DisplayList &list, const Object &objectToDraw, Point tilePosition, Point targetBufferPosition, int lightTableIndex)
 {
 	const ClxSprite sprite = objectToDraw.currentSprite();
 
 	const Point screenPosition = targetBufferPosition + objectToDraw.getRenderingOffset(sprite, tilePosition);
 
 	if (&objectToDraw == ObjectUnderCursor) {
-		ClxDrawOutlineSkipColorZero(out, OutlineColorsObject, screenPosition, sprite);
+		list.outline(OutlineColorsObject, screenPosition, sprite);
 	}
 	if (objectToDraw.applyLighting) {
-		ClxDrawLight(out, screenPosition, sprite, lightTableIndex);
+		list.light(screenPosition, sprite, lightTableIndex);
 	} else {
-		ClxDraw(out, screenPosition, sprite);
+		list.draw(screenPosition, sprite);
 	}
 }
 
-static void DrawDungeon(const Surface & /*out*/, const Lightmap & /*lightmap*/, Point /*tilePosition*/, Point /*targetBufferPosition*/);
-
 /**
  * @brief Render a cell
  * @param out Target buffer
@@ -546,8 +776,8 @@ static void DrawDungeon(const Surface & /*out*/, const Lightmap & /*lightmap*/,
  */
 void DrawCell(const Surface &out, const Lightmap lightmap, Point tilePosition, Point targetBufferPosition, int lightTableIndex)
 {
-	const uint16_t levelPieceId = dPiece[tilePosition.x][tilePosition.y];
-	const MICROS *pMap = &DPieceMicros[levelPieceId];
+	const RenderTile &tile = RenderTiles.at(tilePosition);
+	const MICROS *pMap = &DPieceMicros[tile.piece];
 
 	const uint8_t *tbl = LightTables[lightTableIndex].data();
 	const uint8_t *foliageTbl = tbl;
@@ -563,7 +793,7 @@ void DrawCell(const Surface &out, const Lightmap lightmap, Point tilePosition, P
 	}
 #endif
 
-	bool transparency = TileHasAny(tilePosition, TileProperties::Transparent) && TransList[dTransVal[tilePosition.x][tilePosition.y]];
+	bool transparency = HasAnyOf(SOLData[tile.piece], TileProperties::Transparent) && TransList[tile.transVal];
 #ifdef _DEBUG
 	if ((SDL_GetModState() & SDL_KMOD_ALT) != 0) {
 		transparency = false;
@@ -606,7 +836,7 @@ void DrawCell(const Surface &out, const Lightmap lightmap, Point tilePosition, P
 
 	// Create a special lightmap buffer to bleed light up walls
 	uint8_t lightmapBuffer[TILE_WIDTH * TILE_HEIGHT];
-	const Lightmap bleedLightmap = Lightmap::bleedUp(*GetOptions().Graphics.perPixelLighting, lightmap, targetBufferPosition, lightmapBuffer);
+	const Lightmap bleedLightmap = Lightmap::bleedUp(*GetOptions().Graphics.perPixelLighting, lightmap, targetBufferPosition + RenderOrigin, lightmapBuffer);
 
 	// If the first micro tile is a floor tile, it may be followed
 	// by foliage which should be rendered now.
@@ -677,15 +907,14 @@ void DrawCell(const Surface &out, const Lightmap lightmap, Point tilePosition, P
  */
 void DrawFloorTile(const Surface &out, const Lightmap &lightmap, Point tilePosition, Point targetBufferPosition)
 {
-	const int lightTableIndex = dLight[tilePosition.x][tilePosition.y];
-
-	const uint8_t *tbl = LightTables[lightTableIndex].data();
+	const RenderTile &tile = RenderTiles.at(tilePosition);
+	const uint8_t *tbl = LightTables[tile.light].data();
 #ifdef _DEBUG
 	if (DebugPath && MyPlayer->GetPositionPathIndex(tilePosition) != -1)
 		tbl = GetPauseTRN();
 #endif
 
-	const uint16_t levelPieceId = dPiece[tilePosition.x][tilePosition.y];
+	const uint16_t levelPieceId = tile.piece;
 	{
 		const LevelCelBlock levelCelBlock { DPieceMicros[levelPieceId].mt[0] };
 		if (levelCelBlock.hasValue()) {
@@ -704,31 +933,31 @@ void DrawFloorTile(const Surface &out, const Lightmap &lightmap, Point tilePosit
 
 /**
  * @brief Draw item for a given tile
- * @param out Output buffer
+ * @param list Display list to record the draw commands in
  * @param tilePosition dPiece coordinates
  * @param targetBufferPosition Output buffer coordinates
  * @param pre Is the sprite in the background
  */
-void DrawItem(const Surface &out, int8_t itemIndex, Point targetBufferPosition, int lightTableIndex)
+void DrawItem(DisplayList &list, int8_t itemIndex, Point targetBufferPosition, int lightTableIndex)
 {
 	const Item &item = Items[itemIndex];
 	const ClxSprite sprite = item.AnimInfo.currentSprite();
 	const Point position = targetBufferPosition + item.getRenderingOffset(sprite);
 	if (!IsPlayerInStore() && (itemIndex == pcursitem || AutoMapShowItems)) {
-		ClxDrawOutlineSkipColorZero(out, GetOutlineColor(item, false), position, sprite);
+		list.outline(GetOutlineColor(item, false), position, sprite);
 	}
-	ClxDrawLight(out, position, sprite, lightTableIndex);
+	list.light(position, sprite, lightTableIndex);
 	if (item.AnimInfo.isLastFrame() || item._iCurs == ICURS_MAGIC_ROCK)
 		AddItemToLabelQueue(itemIndex, position);
 }
 
 /**
  * @brief Check if and how a monster should be rendered
- * @param out Output buffer
+ * @param list Display list to record the draw commands in
  * @param tilePosition dPiece coordinates
  * @param targetBufferPosition Output buffer coordinates
  */
-void DrawMonsterHelper(const Surface &out, Point tilePosition, Point targetBufferPosition, int lightTableIndex)
+void DrawMonsterHelper(DisplayList &list, Point tilePosition, Point targetBufferPosition, int lightTableIndex)
 {
 	int mi = dMonster[tilePosition.x][tilePosition.y];
 
@@ -739,9 +968,9 @@ void DrawMonsterHelper(const Surface &out, Point tilePosition, Point targetBuffe
 		const Point position = targetBufferPosition + towner.getRenderingOffset();
 		const ClxSprite sprite = towner.currentSprite();
 		if (mi == pcursmonst) {
-			ClxDrawOutlineSkipColorZero(out, OutlineColorsTowner, position, sprite);
+			list.outline(OutlineColorsTowner, position, sprite);
 		}
-		ClxDraw(out, position, sprite);
+		list.draw(position, sprite);
 		return;
 	}
 
@@ -764,36 +993,36 @@ void DrawMonsterHelper(const Surface &out, Point tilePosition, Point targetBuffe
 
 	const Point monsterRenderPosition = targetBufferPosition + offset;
 	if (mi == pcursmonst) {
-		ClxDrawOutlineSkipColorZero(out, OutlineColorsMonster, monsterRenderPosition, sprite);
+		list.outline(OutlineColorsMonster, monsterRenderPosition, sprite);
 	}
-	DrawMonster(out, tilePosition, monsterRenderPosition, monster, lightTableIndex);
+	DrawMonster(list, tilePosition, monsterRenderPosition, monster, lightTableIndex);
 }
 
 /**
  * @brief Render object sprites
- * @param out Target buffer
- * @param lightmap Per-pixel light buffer
+ * @param list Display list to record the draw commands in
  * @param tilePosition dPiece coordinates
  * @param targetBufferPosition Target buffer coordinates
  */
-void DrawDungeon(const Surface &out, const Lightmap &lightmap, Point tilePosition, Point targetBufferPosition)
+void DrawDungeon(DisplayList &list, Point tilePosition, Point targetBufferPosition)
 {
 	assert(InDungeonBounds(tilePosition));
-	const int lightTableIndex = dLight[tilePosition.x][tilePosition.y];
+	const RenderTile &tile = RenderTiles.at(tilePosition);
+	const int lightTableIndex = tile.light;
 
-	DrawCell(out, lightmap, tilePosition, targetBufferPosition, lightTableIndex);
+	list.cell(tilePosition, targetBufferPosition, lightTableIndex);
 
-	const int8_t bDead = dCorpse[tilePosition.x][tilePosition.y];
-	const int8_t bMap = dTransVal[tilePosition.x][tilePosition.y];
+	const int8_t bDead = tile.corpse;
+	const int8_t bMap = tile.transVal;
 
 #ifdef _DEBUG
 	if (DebugVision && IsTileLit(tilePosition)) {
-		ClxDraw(out, targetBufferPosition, (*pSquareCel)[0]);
+		list.draw(targetBufferPosition, (*pSquareCel)[0]);
 	}
 #endif
 
 	if (MissilePreFlag) {
-		DrawMissile(out, tilePosition, targetBufferPosition, true, lightTableIndex);
+		DrawMissile(list, tilePosition, targetBufferPosition, true, lightTableIndex);
 	}
 
 	if (lightTableIndex < LightsMax && bDead != 0) {
@@ -802,25 +1031,25 @@ void DrawDungeon(const Surface &out, const Lightmap &lightmap, Point tilePositio
 		const ClxSprite sprite = corpse.spritesForDirection(static_cast<Direction>((bDead >> 5) & 7))[corpse.frame];
 		if (corpse.translationPaletteIndex != 0) {
 			const uint8_t *trn = Monsters[corpse.translationPaletteIndex - 1].uniqueMonsterTRN.get();
-			ClxDrawTRN(out, position, sprite, trn);
+			list.trn(position, sprite, trn);
 		} else {
-			ClxDrawLight(out, position, sprite, lightTableIndex);
+			list.light(position, sprite, lightTableIndex);
 		}
 	}
 
-	const int8_t bItem = dItem[tilePosition.x][tilePosition.y];
+	const int8_t bItem = tile.item;
 	const Object *object = lightTableIndex < LightsMax
 	    ? FindObjectAtPosition(tilePosition)
 	    : nullptr;
 	if (object != nullptr && object->_oPreFlag) {
-		DrawObject(out, *object, tilePosition, targetBufferPosition, lightTableIndex);
+		DrawObject(list, *object, tilePosition, targetBufferPosition, lightTableIndex);
 	}
 	if (bItem > 0 && !Items[bItem - 1]._iPostDraw) {
-		DrawItem(out, static_cast<int8_t>(bItem - 1), targetBufferPosition, lightTableIndex);
+		DrawItem(list, static_cast<int8_t>(bItem - 1), targetBufferPosition, lightTableIndex);
 	}
 
 	if (TileContainsDeadPlayer(tilePosition)) {
-		DrawDeadPlayer(out, tilePosition, targetBufferPosition, lightTableIndex);
+		DrawDeadPlayer(list, tilePosition, targetBufferPosition, lightTableIndex);
 	}
 	Player *player = PlayerAtPosition(tilePosition);
 	if (player != nullptr) {
@@ -831,7 +1060,7 @@ void DrawDungeon(const Surface &out, const Lightmap &lightmap, Point tilePositio
 		// This respests the order that tiles are drawn. By using the negative id, we ensure that the sprite is drawn with priority
 		if (player->_pmode == PM_WALK_SOUTHWARDS || (player->_pmode == PM_WALK_SIDEWAYS && player->_pdir == Direction::East))
 			playerId = -playerId;
-		if (dPlayer[tilePosition.x][tilePosition.y] == playerId) {
+		if (tile.player == playerId) {
 			auto tempTilePosition = tilePosition;
 			auto tempTargetBufferPosition = targetBufferPosition;
 
@@ -855,7 +1084,7 @@ void DrawDungeon(const Surface &out, const Lightmap &lightmap, Point tilePositio
 				tempTargetBufferPosition += { -TILE_WIDTH, 0 };
 				tempTilePosition += Opposite(player->_pdir);
 			}
-			DrawPlayer(out, *player, tempTilePosition, tempTargetBufferPosition, lightTableIndex);
+			DrawPlayer(list, *player, tempTilePosition, tempTargetBufferPosition, lightTableIndex);
 		}
 	}
 
@@ -868,7 +1097,7 @@ void DrawDungeon(const Surface &out, const Lightmap &lightmap, Point tilePositio
 		// This respests the order that tiles are drawn. By using the negative id, we ensure that the sprite is drawn with priority
 		if (monster->mode == MonsterMode::MoveSouthwards || (monster->mode == MonsterMode::MoveSideways && monster->direction == Direction::East))
 			monsterId = -monsterId;
-		if (dMonster[tilePosition.x][tilePosition.y] == monsterId) {
+		if (tile.monster == monsterId) {
 			auto tempTilePosition = tilePosition;
 			auto tempTargetBufferPosition = targetBufferPosition;
 
@@ -892,22 +1121,22 @@ void DrawDungeon(const Surface &out, const Lightmap &lightmap, Point tilePositio
 				tempTargetBufferPosition += { -TILE_WIDTH, 0 };
 				tempTilePosition += Opposite(monster->direction);
 			}
-			DrawMonsterHelper(out, tempTilePosition, tempTargetBufferPosition, lightTableIndex);
+			DrawMonsterHelper(list, tempTilePosition, tempTargetBufferPosition, lightTableIndex);
 		}
 	}
 
-	DrawMissile(out, tilePosition, targetBufferPosition, false, lightTableIndex);
+	DrawMissile(list, tilePosition, targetBufferPosition, false, lightTableIndex);
 
 	if (object != nullptr && !object->_oPreFlag) {
-		DrawObject(out, *object, tilePosition, targetBufferPosition, lightTableIndex);
+		DrawObject(list, *object, tilePosition, targetBufferPosition, lightTableIndex);
 	}
 	if (bItem > 0 && Items[bItem - 1]._iPostDraw) {
-		DrawItem(out, static_cast<int8_t>(bItem - 1), targetBufferPosition, lightTableIndex);
+		DrawItem(list, static_cast<int8_t>(bItem - 1), targetBufferPosition, lightTableIndex);
 	}
 
 	if (leveltype != DTYPE_TOWN) {
 		const bool perPixelLighting = *GetOptions().Graphics.perPixelLighting;
-		const int8_t bArch = dSpecial[tilePosition.x][tilePosition.y] - 1;
+		const int8_t bArch = tile.special - 1;
 		if (bArch >= 0) {
 			bool transparency = TransList[bMap];
 #ifdef _DEBUG
@@ -915,18 +1144,11 @@ void DrawDungeon(const Surface &out, const Lightmap &lightmap, Point tilePositio
 			transparency = transparency && (SDL_GetModState() & SDL_KMOD_ALT) == 0;
 #endif
 			if (perPixelLighting) {
-				// Create a special lightmap buffer to bleed light up walls
-				uint8_t lightmapBuffer[TILE_WIDTH * TILE_HEIGHT];
-				const Lightmap bleedLightmap = Lightmap::bleedUp(*GetOptions().Graphics.perPixelLighting, lightmap, targetBufferPosition, lightmapBuffer);
-
-				if (transparency)
-					ClxDrawBlendedWithLightmap(out, targetBufferPosition, (*pSpecialCels)[bArch], bleedLightmap);
-				else
-					ClxDrawWithLightmap(out, targetBufferPosition, (*pSpecialCels)[bArch], bleedLightmap);
+				list.withLightmap(targetBufferPosition, (*pSpecialCels)[bArch], transparency);
 			} else if (transparency) {
-				ClxDrawLightBlended(out, targetBufferPosition, (*pSpecialCels)[bArch], lightTableIndex);
+				list.lightBlended(targetBufferPosition, (*pSpecialCels)[bArch], lightTableIndex);
 			} else {
-				ClxDrawLight(out, targetBufferPosition, (*pSpecialCels)[bArch], lightTableIndex);
+				list.light(targetBufferPosition, (*pSpecialCels)[bArch], lightTableIndex);
 			}
 		}
 	} else {
@@ -934,61 +1156,30 @@ void DrawDungeon(const Surface &out, const Lightmap &lightmap, Point tilePositio
 		// So delay the rendering until after the next row is being drawn.
 		// This could probably have been better solved by sprites in screen space.
 		if (tilePosition.x > 0 && tilePosition.y > 0 && targetBufferPosition.y > TILE_HEIGHT) {
-			const int8_t bArch = dSpecial[tilePosition.x - 1][tilePosition.y - 1] - 1;
+			const int8_t bArch = RenderTiles.at(tilePosition + Displacement { -1, -1 }).special - 1;
 			if (bArch >= 0)
-				ClxDraw(out, targetBufferPosition + Displacement { 0, -TILE_HEIGHT }, (*pSpecialCels)[bArch]);
+				list.draw(targetBufferPosition + Displacement { 0, -TILE_HEIGHT }, (*pSpecialCels)[bArch]);
 		}
 	}
 }
 
-/**
- * @brief Render a row of tiles
- * @param out Buffer to render to
- * @param lightmap Per-pixel light buffer
- * @param tilePosition dPiece coordinates
- * @param targetBufferPosition Target buffer coordinates
- * @param rows Number of rows
- * @param columns Tile in a row
- */
-void DrawFloor(const Surface &out, const Lightmap &lightmap, Point tilePosition, Point targetBufferPosition, int rows, int columns)
+/** @brief The part of the viewport that the floor of the tile can draw to. */
+Rectangle FloorTileBounds(const VisibleTile &tile)
 {
-	for (int i = 0; i < rows; i++) {
-		for (int j = 0; j < columns; j++, tilePosition += Direction::East, targetBufferPosition.x += TILE_WIDTH) {
-			if (!InDungeonBounds(tilePosition))
-				continue;
-			if (IsFloor(tilePosition)) {
-				DrawFloorTile(out, lightmap, tilePosition, targetBufferPosition);
-			}
-		}
-		// Return to start of row
-		tilePosition += Displacement(Direction::West) * columns;
-		targetBufferPosition.x -= columns * TILE_WIDTH;
-
-		// Jump to next row
-		targetBufferPosition.y += TILE_HEIGHT / 2;
-		if ((i & 1) != 0) {
-			tilePosition.x++;
-			columns--;
-			targetBufferPosition.x += TILE_WIDTH / 2;
-		} else {
-			tilePosition.y++;
-			columns++;
-			targetBufferPosition.x -= TILE_WIDTH / 2;
-		}
-	}
+	return { { tile.bufferPosition.x, tile.bufferPosition.y - TILE_HEIGHT }, { TILE_WIDTH, TILE_HEIGHT + 1 } };
 }
 
 /**
  * @brief Renders the floor tiles
- * @param out Output buffer
- * @param lightmap Per-pixel light buffer
+ * @param list Display list to record the draw commands in
  * @param tilePosition dPiece coordinates
  * @param targetBufferPosition Buffer coordinates
  * @param rows Number of rows
  * @param columns Tile in a row
  */
-void DrawTileContent(const Surface &out, const Lightmap &lightmap, Point tilePosition, Point targetBufferPosition, int rows, int columns)
+void DrawTileContent(DisplayList &list, Point tilePosition, Point targetBufferPosition, int rows, int columns)
 {
+	DVL_PROFILE_ZONE("DrawTileContent");
 	// Keep evaluating until MicroTiles can't affect screen
 	rows += MicroTileLen;
 
@@ -1011,13 +1202,13 @@ void DrawTileContent(const Surface &out, const Lightmap &lightmap, Point tilePos
 					// sprite screen position rather than tile position.
 					if (IsWall(tilePosition) && (IsWall(tilePosition + Displacement { 1, 0 }) || (tilePosition.x > 0 && IsWall(tilePosition + Displacement { -1, 0 })))) { // Part of a wall aligned on the x-axis
 						if (IsTileNotSolid(tilePosition + Displacement { 1, -1 }) && IsTileNotSolid(tilePosition + Displacement { 0, -1 })) {                              // Has walkable area behind it
-							DrawDungeon(out, lightmap, tilePosition + Direction::East, { targetBufferPosition.x + TILE_WIDTH, targetBufferPosition.y });
+							DrawDungeon(list, tilePosition + Direction::East, { targetBufferPosition.x + TILE_WIDTH, targetBufferPosition.y });
 							skipNext = true;
 						}
 					}
 				}
 				if (!skip) {
-					DrawDungeon(out, lightmap, tilePosition, targetBufferPosition);
+					DrawDungeon(list, tilePosition, targetBufferPosition);
 				}
 				skip = skipNext;
 			}
@@ -1042,7 +1233,7 @@ void DrawTileContent(const Surface &out, const Lightmap &lightmap, Point tilePos
 	}
 }
 
-void DrawDirtTile(const Surface &out, const Lightmap &lightmap, Point tilePosition, Point targetBufferPosition)
+void DrawDirtTile(DisplayList &list, Point tilePosition, Point targetBufferPosition)
 {
 	// This should be the *top-left* of the 2×2 dirt pattern in the actual dungeon.
 	// You might need to tweak these to where your dirt patch actually lives.
@@ -1064,34 +1255,33 @@ void DrawDirtTile(const Surface &out, const Lightmap &lightmap, Point tilePositi
 
 	if (!InDungeonBounds(sample) || dPiece[sample.x][sample.y] == 0) {
 		// Failsafe: if our sample somehow isn't valid, fall back to black
-		world_draw_black_tile(out, targetBufferPosition.x, targetBufferPosition.y);
+		list.blackTile(targetBufferPosition);
 		return;
 	}
 
 	const int lightTableIndex = dLight[sample.x][sample.y];
 
 	// Let the normal dungeon tile renderer compose the full tile
-	DrawCell(out, lightmap, sample, targetBufferPosition, lightTableIndex);
+	list.cell(sample, targetBufferPosition, lightTableIndex);
 }
 
 /**
  * @brief Render a row of tiles
- * @param out Buffer to render to
- * @param lightmap Per-pixel light buffer
+ * @param list Display list to record the draw commands in
  * @param tilePosition dPiece coordinates
  * @param targetBufferPosition Target buffer coordinates
  * @param rows Number of rows
  * @param columns Tile in a row
  */
-void DrawOOB(const Surface &out, const Lightmap &lightmap, Point tilePosition, Point targetBufferPosition, int rows, int columns)
+void DrawOOB(DisplayList &list, Point tilePosition, Point targetBufferPosition, int rows, int columns)
 {
 	for (int i = 0; i < rows + 5; i++) { // 5 extra rows needed to make sure everything gets rendered at the bottom half of the screen
 		for (int j = 0; j < columns; j++, tilePosition += Direction::East, targetBufferPosition.x += TILE_WIDTH) {
 			if (!InDungeonBounds(tilePosition)) {
 				if (leveltype == DTYPE_TOWN) {
-					world_draw_black_tile(out, targetBufferPosition.x, targetBufferPosition.y);
+					list.blackTile(targetBufferPosition);
 				} else {
-					DrawDirtTile(out, lightmap, tilePosition, targetBufferPosition);
+					DrawDirtTile(list, tilePosition, targetBufferPosition);
 				}
 			}
 		}
@@ -1113,6 +1303,31 @@ void DrawOOB(const Surface &out, const Lightmap &lightmap, Point tilePosition, P
 	}
 }
 
+/**
+ * @brief Writes each of the `srcLength` pixels of `src` twice to `dst`.
+ */
+void DoublePixels(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, int srcLength)
+{
+	int i = 0;
+#if defined(DEVILUTIONX_ZOOM_SSE2)
+	for (; i + 16 <= srcLength; i += 16) {
+		const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + (2 * i)), _mm_unpacklo_epi8(pixels, pixels));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + (2 * i) + 16), _mm_unpackhi_epi8(pixels, pixels));
+	}
+#elif defined(DEVILUTIONX_ZOOM_NEON)
+	for (; i + 16 <= srcLength; i += 16) {
+		const uint8x16_t pixels = vld1q_u8(src + i);
+		// Storing the same register as both halves of a pair interleaves it with itself.
+		vst2q_u8(dst + (2 * i), (uint8x16x2_t { { pixels, pixels } }));
+	}
+#endif
+	for (; i < srcLength; ++i) {
+		dst[2 * i] = src[i];
+		dst[(2 * i) + 1] = src[i];
+	}
+}
+
 /**
  * @brief Scale up the top left part of the buffer 2x.
  */
@@ -1130,41 +1345,38 @@ void Zoom(const Surface &out)
 	}
 
 	// We round to even for the source width and height.
-	// If the width / height was odd, we copy just one extra pixel / row later on.
-	const int srcWidth = (viewportWidth + 1) / 2;
+	// If the width / height was odd, we copy just one extra pixel / row.
 	const int doubleableWidth = viewportWidth / 2;
 	const int srcHeight = (out.h() + 1) / 2;
 	const int doubleableHeight = out.h() / 2;
-
-	uint8_t *src = out.at(srcWidth - 1, srcHeight - 1);
-	uint8_t *dst = out.at(viewportOffsetX + viewportWidth - 1, out.h() - 1);
 	const bool oddViewportWidth = (viewportWidth % 2) == 1;
 
+	// Every destination row is below its source row, so going from the bottom up
+	// never overwrites a source row that is still needed.
 	for (int hgt = 0; hgt < doubleableHeight; hgt++) {
-		// Double the pixels in the line.
-		for (int i = 0; i < doubleableWidth; i++) {
-			*dst-- = *src;
-			*dst-- = *src;
-			--src;
-		}
+		const uint8_t *src = out.at(0, srcHeight - 1 - hgt);
+		const int dstY = out.h() - 1 - (2 * hgt);
+		uint8_t *dst = out.at(viewportOffsetX, dstY);
 
 		// Copy a single extra pixel if the output width is odd.
-		if (oddViewportWidth) {
-			*dst-- = *src;
-			--src;
-		}
+		if (oddViewportWidth)
+			*dst++ = *src++;
 
-		// Skip the rest of the source line.
-		src -= (out.pitch() - srcWidth);
+		// Double the pixels in the line.
+		DoublePixels(dst, src, doubleableWidth);
 
 		// Double the line.
-		memcpy(dst - out.pitch() + 1, dst + 1, viewportWidth);
-
-		// Skip the rest of the destination line.
-		dst -= 2 * out.pitch() - viewportWidth;
+		memcpy(out.at(viewportOffsetX, dstY - 1), out.at(viewportOffsetX, dstY), viewportWidth);
 	}
+
+	// The top row of an odd height is its own source, so it is doubled in place from right to left.
 	if ((out.h() % 2) == 1) {
-		memcpy(dst - out.pitch() + 1, dst + 1, viewportWidth);
+		const uint8_t *src = out.at(0, 0);
+		uint8_t *dst = out.at(viewportOffsetX, 0);
+		const int oddOffset = oddViewportWidth ? 1 : 0;
+		for (int x = viewportWidth - 1; x >= 0; --x) {
+			dst[x] = src[(x + oddOffset) / 2];
+		}
 	}
 }
 
@@ -1218,6 +1430,749 @@ void CalcFirstTilePosition(Point &position, Displacement &offset)
 	}
 }
 
+/** @brief A simple FNV-1a style hash of the state that affects how the world is drawn. */
+class RenderSignature {
+public:
+	void add(uint32_t value)
+	{
+		hash_ = (hash_ ^ value) * 16777619U;
+	}
+
+	void add(const void *ptr)
+	{
+		const auto value = reinterpret_cast<uintptr_t>(ptr);
+		add(static_cast<uint32_t>(value));
+		if constexpr (sizeof(uintptr_t) > sizeof(uint32_t))
+			add(static_cast<uint32_t>(static_cast<uint64_t>(value) >> 32));
+	}
+
+	void add(Displacement displacement)
+	{
+		add(static_cast<uint32_t>(displacement.deltaX));
+		add(static_cast<uint32_t>(displacement.deltaY));
+	}
+
+	[[nodiscard]] uint32_t value() const
+	{
+		return hash_;
+	}
+
+private:
+	uint32_t hash_ = 2166136261U;
+};
+
+/**
+ * @brief State of the incremental viewport redraw.
+ *
+ * Every frame the visible tiles are hashed. Tiles whose hash differs from the previous frame
+ * mark the part of the viewport that their sprites can reach as dirty, and only the bounding
+ * rectangle of those parts is rendered again. The rest of the world is restored from a copy
+ * that was taken before the overlays (labels, panels, etc.) were drawn on top of it.
+ */
+struct IncrementalRedrawState {
+	/** @brief Whether `world` and `tileSignatures` describe the previous frame. */
+	bool valid = false;
+	uint32_t viewSignature = 0;
+	std::vector<uint32_t> tileSignatures;
+	/** @brief Copy of the viewport with only the world drawn to it. */
+	std::vector<uint8_t> world;
+	/** @brief Copy of the rows of the back buffer that were blitted in the previous frame. */
+	std::vector<uint8_t> previousFrame;
+	int previousFrameHeight = 0;
+	/** @brief Part of the viewport that was rendered in the last frame. */
+	Rectangle dirtyRect;
+	/** @brief Number of viewport pixels rendered in the last frame. */
+	size_t pixelsRedrawn = 0;
+};
+
+IncrementalRedrawState IncrementalRedraw;
+
+/** @brief How far sprites standing on a tile may reach outside of its column. */
+constexpr int DirtyMarginX = 2 * TILE_WIDTH;
+constexpr int DirtyMarginBottom = 2 * TILE_HEIGHT;
+
+bool IsIncrementalRedrawEnabled()
+{
+	return *GetOptions().Graphics.incrementalRedraw && !*GetOptions().Graphics.zoom && !RenderDirectlyToOutputSurface;
+}
+
+/** @brief Hashes everything global that changes the appearance of many tiles at once. */
+uint32_t ViewSignature(Point position, Displacement offset, int rows, int columns)
+{
+	RenderSignature signature;
+	signature.add(static_cast<uint32_t>(position.x));
+	signature.add(static_cast<uint32_t>(position.y));
+	signature.add(offset);
+	signature.add(static_cast<uint32_t>(rows));
+	signature.add(static_cast<uint32_t>(columns));
+	signature.add(static_cast<uint32_t>(gnScreenWidth));
+	signature.add(static_cast<uint32_t>(gnViewportHeight));
+	signature.add(static_cast<uint32_t>(leveltype));
+	signature.add(static_cast<uint32_t>(currlevel));
+	signature.add(static_cast<uint32_t>(setlevel));
+	signature.add(static_cast<uint32_t>(pcursmonst));
+	signature.add(static_cast<uint32_t>(pcursitem));
+	signature.add(ObjectUnderCursor);
+	signature.add(PlayerUnderCursor);
+	signature.add(static_cast<uint32_t>(AutoMapShowItems));
+	signature.add(static_cast<uint32_t>(IsPlayerInStore()));
+	signature.add(static_cast<uint32_t>(MissilePreFlag));
+	signature.add(static_cast<uint32_t>(MyPlayer->_pInfraFlag));
+	signature.add(static_cast<uint32_t>(*GetOptions().Graphics.perPixelLighting));
+	// Palette cycling rotates the tables, which changes the indices of lit and blended pixels
+	signature.add(LightTablesGeneration);
+	signature.add(GetBlendedLookupTableGeneration());
+	signature.add(FullyLitLightTable);
+	signature.add(FullyDarkLightTable);
+	for (const bool transparent : TransList)
+		signature.add(static_cast<uint32_t>(transparent));
+#ifdef _DEBUG
+	signature.add(static_cast<uint32_t>(DebugVision));
+	signature.add(static_cast<uint32_t>(DebugPath));
+	signature.add(static_cast<uint32_t>(DisableLighting));
+	signature.add(static_cast<uint32_t>((SDL_GetModState() & SDL_KMOD_ALT) != 0));
+	if (DebugPath) {
+		for (const int8_t step : MyPlayer->walkpath)
+			signature.add(static_cast<uint32_t>(step));
+	}
+#endif
+	return signature.value();
+}
+
+/** @brief Hashes everything that is drawn by `DrawDungeon` for the given tile. */
+uint32_t TileSignature(Point tilePosition)
+{
+	const RenderTile &tile = RenderTiles.at(tilePosition);
+
+	RenderSignature signature;
+	signature.add(tile.piece);
+	signature.add(tile.light);
+	signature.add(static_cast<uint32_t>(tile.flags));
+	signature.add(static_cast<uint32_t>(tile.transVal));
+	signature.add(static_cast<uint32_t>(tile.special));
+	signature.add(static_cast<uint32_t>(tile.corpse));
+	signature.add(static_cast<uint32_t>(tile.object));
+	signature.add(static_cast<uint32_t>(tile.item));
+	signature.add(static_cast<uint32_t>(tile.player));
+	signature.add(static_cast<uint32_t>(tile.monster));
+
+	if (tile.item > 0) {
+		const Item &item = Items[tile.item - 1];
+		signature.add(static_cast<uint32_t>(item.AnimInfo.currentFrame));
+		signature.add(static_cast<uint32_t>(item._iPostDraw));
+	}
+
+	if (tile.object != 0) {
+		const Object *object = FindObjectAtPosition(tilePosition);
+		if (object != nullptr) {
+			signature.add(object->currentSprite().pixelData());
+			signature.add(static_cast<uint32_t>(object->_oPreFlag));
+		}
+	}
+
+	if (tile.player != 0) {
+		const Player *player = PlayerAtPosition(tilePosition);
+		if (player != nullptr) {
+			const ClxSprite sprite = player->currentSprite();
+			signature.add(sprite.pixelData());
+			signature.add(player->getRenderingOffset(sprite));
+			signature.add(static_cast<uint32_t>(player->_pmode));
+			signature.add(static_cast<uint32_t>(player->_pdir));
+			signature.add(static_cast<uint32_t>(player->pManaShield));
+			signature.add(static_cast<uint32_t>(player->wReflections > 0));
+		}
+	}
+
+	if (tile.monster != 0) {
+		const size_t mi = static_cast<size_t>(std::abs(tile.monster) - 1);
+		if (leveltype == DTYPE_TOWN) {
+			if (mi < Towners.size()) {
+				const Towner &towner = Towners[mi];
+				signature.add(towner.currentSprite().pixelData());
+				signature.add(towner.getRenderingOffset());
+			}
+		} else if (mi < MaxMonsters && Monsters[mi].animInfo.sprites) {
+			const Monster &monster = Monsters[mi];
+			const ClxSprite sprite = monster.animInfo.currentSprite();
+			signature.add(sprite.pixelData());
+			signature.add(monster.getRenderingOffset(sprite));
+			signature.add(static_cast<uint32_t>(monster.mode));
+			signature.add(static_cast<uint32_t>(monster.direction));
+			signature.add(static_cast<uint32_t>(monster.flags));
+		}
+	}
+
+	for (const Missile *missile : GetMissilesAtRenderingTile(tilePosition)) {
+		signature.add(missile);
+		if (missile->_miAnimData && missile->_miAnimFrame > 0)
+			signature.add((*missile->_miAnimData)[missile->_miAnimFrame - 1].pixelData());
+		signature.add(missile->position.offsetForRendering);
+		signature.add(static_cast<uint32_t>(missile->_miPreFlag));
+		signature.add(static_cast<uint32_t>(missile->_miDrawFlag));
+	}
+
+	return signature.value();
+}
+
+/**
+ * @brief Calls `fn(tilePosition, targetBufferPosition)` for every tile of the view, in the order they are drawn in.
+ *
+ * Pass `rows + MicroTileLen` to visit the same tiles as `DrawTileContent`.
+ */
+template <typename Fn>
+void ForEachTileInView(Point tilePosition, Point targetBufferPosition, int rows, int columns, Fn &&fn)
+{
+	for (int i = 0; i < rows; i++) {
+		for (int j = 0; j < columns; j++, tilePosition += Direction::East, targetBufferPosition.x += TILE_WIDTH) {
+			fn(tilePosition, targetBufferPosition);
+		}
+		tilePosition += Displacement(Direction::West) * columns;
+		targetBufferPosition.x -= columns * TILE_WIDTH;
+
+		targetBufferPosition.y += TILE_HEIGHT / 2;
+		if ((i & 1) != 0) {
+			tilePosition.x++;
+			columns--;
+			targetBufferPosition.x += TILE_WIDTH / 2;
+		} else {
+			tilePosition.y++;
+			columns++;
+			targetBufferPosition.x -= TILE_WIDTH / 2;
+		}
+	}
+}
+
+/**
+ * @brief Copies the level state of the tiles visited by `DrawTileContent` into `RenderTiles`.
+ * @param tilePosition First tile of the view
+ * @param targetBufferPosition Buffer coordinates of the first tile
+ * @param rows Rows of the view, not counting the extra rows for micro tiles
+ */
+void UpdateRenderTiles(Point tilePosition, Point targetBufferPosition, int rows, int columns)
+{
+	Point topLeft { MAXDUNX, MAXDUNY };
+	Point bottomRight { -1, -1 };
+	ForEachTileInView(tilePosition, targetBufferPosition, rows + MicroTileLen, columns, [&](Point tile, Point) {
+		topLeft = { std::min(topLeft.x, tile.x - 1), std::min(topLeft.y, tile.y - 1) };
+		bottomRight = { std::max(bottomRight.x, tile.x + 1), std::max(bottomRight.y, tile.y + 1) };
+	});
+	topLeft = { std::max(topLeft.x, 0), std::max(topLeft.y, 0) };
+	bottomRight = { std::min(bottomRight.x, MAXDUNX - 1), std::min(bottomRight.y, MAXDUNY - 1) };
+
+	RenderTileView &view = RenderTiles;
+	view.origin = topLeft;
+	view.size = { std::max(bottomRight.x - topLeft.x + 1, 0), std::max(bottomRight.y - topLeft.y + 1, 0) };
+	view.tiles.resize(static_cast<size_t>(view.size.width) * view.size.height);
+
+	RenderTile *tile = view.tiles.data();
+	for (int x = topLeft.x; x <= bottomRight.x; x++) {
+		for (int y = topLeft.y; y <= bottomRight.y; y++) {
+			*tile++ = {
+				.piece = dPiece[x][y],
+				.monster = dMonster[x][y],
+				.light = dLight[x][y],
+				.flags = dFlags[x][y],
+				.transVal = dTransVal[x][y],
+				.special = dSpecial[x][y],
+				.corpse = dCorpse[x][y],
+				.object = dObject[x][y],
+				.item = dItem[x][y],
+				.player = dPlayer[x][y],
+			};
+		}
+	}
+}
+
+/**
+ * @brief Is the floor of the tile completely covered by the wall of the tile in front of it?
+ *
+ * The wall is drawn after the floor and after anything standing on the tile, so the floor would never be seen.
+ */
+bool IsFloorHiddenByWall(Point tilePosition)
+{
+	const Point front = tilePosition + Displacement { 1, 1 };
+	if (!InDungeonBounds(front))
+		return false;
+	const RenderTile &tile = RenderTiles.at(front);
+	if (!PieceCoversFloorBehind[tile.piece])
+		return false;
+	// See-through walls are drawn with holes in them, see DrawCell
+	return !(HasAnyOf(SOLData[tile.piece], TileProperties::Transparent) && TransList[tile.transVal]);
+}
+
+/**
+ * @brief Fills `VisibleTiles` with the tiles in view of the floor passes.
+ * @param tilePosition First tile of the view
+ * @param targetBufferPosition Buffer coordinates of the first tile
+ */
+void UpdateVisibleTiles(Point tilePosition, Point targetBufferPosition, int rows, int columns)
+{
+	VisibleTiles.clear();
+	++VisibleFloorStats.frames;
+	ForEachTileInView(tilePosition, targetBufferPosition, rows, columns, [&](Point tile, Point bufferPosition) {
+		if (!InDungeonBounds(tile))
+			return;
+		bool drawFloor = IsFloor(tile);
+		if (drawFloor) {
+			++VisibleFloorStats.floorTiles;
+			if (IsFloorHiddenByWall(tile)) {
+				++VisibleFloorStats.hiddenTiles;
+				drawFloor = false;
+			}
+		}
+		VisibleTiles.push_back({ tile, bufferPosition, drawFloor });
+	});
+}
+
+/**
+ * @brief Hashes the visible tiles and returns the part of the viewport that has to be rendered again.
+ */
+Rectangle UpdateTileSignatures(Point tilePosition, Point targetBufferPosition, int rows, int columns, const Surface &out, bool fullRedraw)
+{
+	std::vector<uint32_t> &signatures = IncrementalRedraw.tileSignatures;
+	if (fullRedraw)
+		signatures.clear();
+
+	int left = out.w();
+	int right = 0;
+	int bottom = 0;
+
+	size_t index = 0;
+	ForEachTileInView(tilePosition, targetBufferPosition, rows + MicroTileLen, columns, [&](Point tile, Point bufferPosition) {
+		const uint32_t signature = InDungeonBounds(tile) ? TileSignature(tile) : 0;
+		const size_t i = index++;
+		if (i >= signatures.size()) {
+			signatures.push_back(signature);
+		} else if (signatures[i] != signature) {
+			signatures[i] = signature;
+		} else {
+			return;
+		}
+		if (fullRedraw)
+			return;
+		left = std::min(left, bufferPosition.x - DirtyMarginX);
+		right = std::max(right, bufferPosition.x + TILE_WIDTH + DirtyMarginX);
+		bottom = std::max(bottom, bufferPosition.y + DirtyMarginBottom);
+	});
+
+	if (fullRedraw)
+		return { { 0, 0 }, { out.w(), out.h() } };
+
+	left = std::max(left, 0);
+	right = std::min(right, out.w());
+	bottom = std::min(bottom, out.h());
+	if (left >= right || bottom <= 0)
+		return {};
+	return { { left, 0 }, { right - left, bottom } };
+}
+
+void CopyRows(const Surface &out, std::vector<uint8_t> &buffer, bool toSurface, int top, int height)
+{
+	const size_t width = static_cast<size_t>(out.w());
+	for (int y = top; y < top + height; y++) {
+		uint8_t *row = &buffer[static_cast<size_t>(y) * width];
+		if (toSurface)
+			memcpy(out.at(0, y), row, width);
+		else
+			memcpy(row, out.at(0, y), width);
+	}
+}
+
+/**
+ * @brief Offscreen copy of the floor tiles of the viewport.
+ *
+ * Floor tiles only change when the lighting around them does, so they are kept
+ * between frames and only re-rendered when one of the lights of the tile or its
+ * neighbours changed, or when they scroll into view.
+ */
+struct FloorLayerCache {
+	struct TileEntry {
+		uint32_t signature;
+		/** @brief The frame in which the tile was last rendered to or verified in the cache. */
+		uint32_t frame;
+	};
+
+	std::optional<OwnedSurface> surface;
+	/** @brief Screen position of dungeon tile {0, 0} in the last frame. */
+	Point worldOrigin;
+	uint32_t levelSignature = 0;
+	/** @brief Current frame, entries from the frame before are valid. Starts at 1, 0 marks a tile as not cached. */
+	uint32_t frame = 1;
+	std::array<TileEntry, MAXDUNX * MAXDUNY> tiles {};
+	FloorCacheStats stats {};
+};
+
+FloorLayerCache FloorCache;
+
+bool IsFloorCacheEnabled()
+{
+	return *GetOptions().Graphics.floorCache;
+}
+
+uint32_t FloorLevelSignature()
+{
+	RenderSignature signature;
+	signature.add(pDungeonCels.get());
+	signature.add(static_cast<uint32_t>(leveltype));
+	signature.add(static_cast<uint32_t>(currlevel));
+	signature.add(static_cast<uint32_t>(setlevel));
+	signature.add(static_cast<uint32_t>(*GetOptions().Graphics.perPixelLighting));
+	signature.add(LightTablesGeneration);
+#ifdef _DEBUG
+	signature.add(static_cast<uint32_t>(DebugPath));
+	signature.add(static_cast<uint32_t>(DisableLighting));
+	if (DebugPath) {
+		for (const int8_t step : MyPlayer->walkpath)
+			signature.add(static_cast<uint32_t>(step));
+	}
+#endif
+	return signature.value();
+}
+
+/**
+ * @brief Hashes what the floor of a tile looks like.
+ *
+ * With per-pixel lighting the light of a tile is interpolated with its neighbours.
+ */
+uint32_t FloorTileSignature(Point tilePosition, bool drawFloor)
+{
+	RenderSignature signature;
+	signature.add(RenderTiles.at(tilePosition).piece);
+	signature.add(static_cast<uint32_t>(drawFloor));
+	for (int dy = -1; dy <= 1; dy++) {
+		for (int dx = -1; dx <= 1; dx++) {
+			const Point neighbour = tilePosition + Displacement { dx, dy };
+			signature.add(InDungeonBounds(neighbour) ? RenderTiles.at(neighbour).light : LightsMax);
+		}
+	}
+	// 0 marks tiles that are not cached
+	return signature.value() | 1;
+}
+
+/**
+ * @brief Brings the floor cache up to date with the current view.
+ * @param out The viewport
+ */
+void UpdateFloorCache(const Surface &out, const Lightmap &lightmap, Point position, Displacement offset)
+{
+	FloorLayerCache &cache = FloorCache;
+	FloorCacheStats &stats = cache.stats;
+	++stats.frames;
+
+	const Point worldOrigin = Point {} + offset
+	    - Displacement { (position.x - position.y) * TILE_WIDTH / 2, (position.x + position.y) * TILE_HEIGHT / 2 };
+	const Displacement shift = worldOrigin - cache.worldOrigin;
+	const uint32_t levelSignature = FloorLevelSignature();
+
+	bool rebuild = !cache.surface || cache.surface->w() != out.w() || cache.surface->h() != out.h()
+	    || cache.levelSignature != levelSignature
+	    || std::abs(shift.deltaX) >= out.w() || std::abs(shift.deltaY) >= out.h();
+	if (!cache.surface || cache.surface->w() != out.w() || cache.surface->h() != out.h()) {
+		cache.surface.emplace(out.w(), out.h());
+	}
+	const Surface &layer = *cache.surface;
+
+	if (rebuild) {
+		++stats.fullRebuilds;
+		// Nothing from the previous frames can be reused
+		cache.frame += 2;
+	} else if (shift != Displacement { 0, 0 }) {
+		++stats.shiftedFrames;
+		const int width = layer.w() - std::abs(shift.deltaX);
+		const int srcX = std::max(0, -shift.deltaX);
+		const int dstX = std::max(0, shift.deltaX);
+		const auto moveRow = [&](int y) {
+			memmove(layer.at(dstX, y + shift.deltaY), layer.at(srcX, y), width);
+		};
+		if (shift.deltaY > 0) {
+			for (int y = layer.h() - shift.deltaY - 1; y >= 0; y--)
+				moveRow(y);
+		} else {
+			for (int y = -shift.deltaY; y < layer.h(); y++)
+				moveRow(y);
+		}
+	}
+	cache.levelSignature = levelSignature;
+	cache.worldOrigin = worldOrigin;
+
+	const uint32_t frame = ++cache.frame;
+	const Lightmap layerLightmap = lightmap.withOutBuffer(layer.at(0, 0), layer.pitch());
+	for (const VisibleTile &visibleTile : VisibleTiles) {
+		const Point tile = visibleTile.tilePosition;
+		const Point bufferPosition = visibleTile.bufferPosition;
+		FloorLayerCache::TileEntry &entry = cache.tiles[tile.x + tile.y * MAXDUNX];
+		const uint32_t signature = FloorTileSignature(tile, visibleTile.drawFloor);
+		// Only tiles that fit in the layer completely can be reused after it is shifted.
+		// The per-pixel light of a tile also depends on its neighbours, so they have to be in view as well.
+		const bool reusable = bufferPosition.x >= TILE_WIDTH / 2 && bufferPosition.x + TILE_WIDTH + TILE_WIDTH / 2 <= layer.w()
+		    && bufferPosition.y - TILE_HEIGHT - TILE_HEIGHT / 2 >= 0 && bufferPosition.y + TILE_HEIGHT / 2 <= layer.h();
+		if (reusable && entry.frame == frame - 1 && entry.signature == signature) {
+			++stats.tilesReused;
+			entry.frame = frame;
+			continue;
+		}
+		if (visibleTile.drawFloor) {
+			DrawFloorTile(layer, layerLightmap, tile, bufferPosition);
+			++stats.tilesRendered;
+		}
+		entry = { signature, reusable ? frame : 0 };
+	}
+}
+
+/**
+ * @brief Records the draw commands of the tile content and out of bounds passes in `WorldDisplayList`.
+ */
+void RecordWorld(Point position, Displacement offset, int rows, int columns)
+{
+	DisplayList &list = WorldDisplayList;
+	list.clear();
+	DrawTileContent(list, position, Point {} + offset, rows, columns);
+	DrawOOB(list, position, Point {} + offset, rows, columns);
+
+	const auto commands = static_cast<uint32_t>(list.commands().size());
+	++WorldDisplayListStats.frames;
+	WorldDisplayListStats.lastFrameCommands = commands;
+	WorldDisplayListStats.commands += commands;
+}
+
+/**
+ * @brief Draws a command of `WorldDisplayList`.
+ * @param out The part of the viewport to draw to
+ * @param origin Position of `out` in the viewport
+ */
+void DrawDisplayListCommand(const Surface &out, const Lightmap &lightmap, const DrawCommand &command, Displacement origin)
+{
+	const Point position = command.position - origin;
+	switch (command.type) {
+	case DrawCommandType::Cell:
+		DrawCell(out, lightmap, command.tilePosition, position, command.lightTableIndex);
+		break;
+	case DrawCommandType::BlackTile:
+		world_draw_black_tile(out, position.x, position.y);
+		break;
+	case DrawCommandType::Sprite:
+		ClxDraw(out, position, *command.sprite);
+		break;
+	case DrawCommandType::SpriteTrn:
+		ClxDrawTRN(out, position, *command.sprite, command.trn);
+		break;
+	case DrawCommandType::SpriteBlended:
+		ClxDrawBlended(out, position, *command.sprite);
+		break;
+	case DrawCommandType::SpriteBlendedTrn:
+		ClxDrawBlendedTRN(out, position, *command.sprite, command.trn);
+		break;
+	case DrawCommandType::SpriteOutline:
+		ClxDrawOutlineSkipColorZero(out, command.outlineColor, position, *command.sprite);
+		break;
+	case DrawCommandType::SpriteWithLightmap:
+	case DrawCommandType::SpriteBlendedWithLightmap: {
+		// Create a special lightmap buffer to bleed light up walls
+		uint8_t lightmapBuffer[TILE_WIDTH * TILE_HEIGHT];
+		const Lightmap bleedLightmap = Lightmap::bleedUp(/*perPixelLighting=*/true, lightmap, command.position, lightmapBuffer);
+		if (command.type == DrawCommandType::SpriteBlendedWithLightmap)
+			ClxDrawBlendedWithLightmap(out, position, *command.sprite, bleedLightmap);
+		else
+			ClxDrawWithLightmap(out, position, *command.sprite, bleedLightmap);
+		break;
+	}
+	}
+}
+
+/** @brief Upper bound for `GraphicsOptions::renderThreads`. */
+constexpr int MaxRenderThreads = 8;
+
+/** @brief Don't split the world into bands that are shorter than this. */
+constexpr int MinRenderBandHeight = 2 * TILE_HEIGHT;
+
+/** @brief A horizontal band of the viewport that is rendered on one thread. */
+struct RenderBand {
+	Rectangle rect;
+	/** @brief Indices into `VisibleTiles` of the floor tiles that reach into the band. */
+	std::vector<uint32_t> floorTiles;
+	/** @brief Indices into `WorldDisplayList` of the commands that reach into the band, in the recorded order. */
+	std::vector<uint32_t> commands;
+};
+
+/** @brief Kept between frames, so that the index lists keep their memory. */
+std::array<RenderBand, MaxRenderThreads> RenderBands;
+
+int GetRenderThreadCount(int height)
+{
+#if defined(DUN_RENDER_STATS) || defined(__DJGPP__)
+	return 1;
+#else
+	return std::clamp(std::min(*GetOptions().Graphics.renderThreads, height / MinRenderBandHeight), 1, MaxRenderThreads);
+#endif
+}
+
+/**
+ * @brief Adds the index to the lists of all the bands that the bounds reach into.
+ * @param bands Bands from top to bottom, all with the same horizontal extent
+ */
+void AddToRenderBands(std::span<RenderBand> bands, Rectangle bounds, uint32_t index, std::vector<uint32_t> RenderBand::*list)
+{
+	const Rectangle &first = bands.front().rect;
+	if (bounds.position.x >= first.position.x + first.size.width || bounds.position.x + bounds.size.width <= first.position.x)
+		return;
+	const int top = bounds.position.y;
+	const int bottom = top + bounds.size.height;
+	for (RenderBand &band : bands) {
+		if (band.rect.position.y >= bottom)
+			break;
+		if (band.rect.position.y + band.rect.size.height > top)
+			(band.*list).push_back(index);
+	}
+}
+
+/**
+ * @brief Splits the part of the viewport into horizontal bands and hands the floor tiles
+ * and the commands of `WorldDisplayList` to the bands they reach into.
+ */
+std::span<RenderBand> AssignRenderBands(Rectangle rect, int count)
+{
+	const std::span<RenderBand> bands { RenderBands.data(), static_cast<size_t>(count) };
+	int bandTop = rect.position.y;
+	for (int i = 0; i < count; i++) {
+		const int bandBottom = rect.position.y + rect.size.height * (i + 1) / count;
+		RenderBand &band = bands[i];
+		band.rect = { { rect.position.x, bandTop }, { rect.size.width, bandBottom - bandTop } };
+		band.floorTiles.clear();
+		band.commands.clear();
+		bandTop = bandBottom;
+	}
+
+	if (!IsFloorCacheEnabled()) {
+		for (size_t i = 0; i < VisibleTiles.size(); i++) {
+			if (VisibleTiles[i].drawFloor)
+				AddToRenderBands(bands, FloorTileBounds(VisibleTiles[i]), static_cast<uint32_t>(i), &RenderBand::floorTiles);
+		}
+	}
+	const std::span<const DrawCommand> commands = WorldDisplayList.commands();
+	for (size_t i = 0; i < commands.size(); i++)
+		AddToRenderBands(bands, commands[i].bounds(), static_cast<uint32_t>(i), &RenderBand::commands);
+	return bands;
+}
+
+/**
+ * @brief Renders the floor tiles and the commands of the band on the current thread.
+ * @param out The viewport
+ */
+void DrawRenderBand(const Surface &out, const Lightmap &lightmap, const RenderBand &band)
+{
+	const Rectangle &rect = band.rect;
+	const Surface target = out.subregion(rect.position.x, rect.position.y, rect.size.width, rect.size.height);
+	const Displacement origin { rect.position.x, rect.position.y };
+	RenderOrigin = origin;
+
+	if (IsFloorCacheEnabled()) {
+		target.BlitFrom(*FloorCache.surface, MakeSdlRect(rect), { 0, 0 });
+	} else {
+		DVL_PROFILE_ZONE("DrawFloor");
+		for (const uint32_t index : band.floorTiles) {
+			const VisibleTile &tile = VisibleTiles[index];
+			DrawFloorTile(target, lightmap, tile.tilePosition, tile.bufferPosition - origin);
+		}
+	}
+	const std::span<const DrawCommand> commands = WorldDisplayList.commands();
+	for (const uint32_t index : band.commands)
+		DrawDisplayListCommand(target, lightmap, commands[index], origin);
+
+	RenderOrigin = {};
+}
+
+/**
+ * @brief Renders the world passes to the given part of the viewport.
+ *
+ * The draw commands are recorded once for the whole view. The area is then split into
+ * horizontal bands, one per render thread, and every floor tile and command is handed to
+ * the bands it reaches into. The bands are drawn in parallel by the threads of `ParallelFor`.
+ * Every band draws its commands in the recorded order and clips to its own rows, so sprites
+ * crossing a seam come out exactly as in a serial render.
+ *
+ * @param out The viewport
+ * @param rect Part of the viewport to render to
+ */
+void DrawWorld(const Surface &out, const Lightmap &lightmap, Point position, Displacement offset, int rows, int columns, Rectangle rect)
+{
+	if (IsFloorCacheEnabled())
+		UpdateFloorCache(out, lightmap, position, offset);
+
+	RecordWorld(position, offset, rows, columns);
+
+	const std::span<RenderBand> bands = AssignRenderBands(rect, GetRenderThreadCount(rect.size.height));
+	ParallelFor("RenderBand", bands.size(), [&](size_t i) { DrawRenderBand(out, lightmap, bands[i]); });
+	for (const RenderBand &band : bands)
+		WorldDisplayListStats.commandsDrawn += band.commands.size();
+}
+
+/**
+ * @brief Returns the range of rows of the back buffer that differ from the previous frame
+ * and remembers the current frame for the next comparison.
+ *
+ * The rows outside of the range are known to be identical to what is already on the screen,
+ * as long as the same number of rows was blitted in the previous frame.
+ */
+std::pair<int, int> UpdateChangedRows(const Surface &out, int height)
+{
+	std::vector<uint8_t> &previous = IncrementalRedraw.previousFrame;
+	const size_t width = static_cast<size_t>(out.w());
+	const size_t size = width * static_cast<size_t>(out.h());
+	if (previous.size() != size || IncrementalRedraw.previousFrameHeight != height) {
+		previous.resize(size);
+		CopyRows(out, previous, /*toSurface=*/false, 0, height);
+		IncrementalRedraw.previousFrameHeight = height;
+		return { 0, height };
+	}
+
+	int first = height;
+	int last = 0;
+	for (int y = 0; y < height; y++) {
+		uint8_t *row = &previous[static_cast<size_t>(y) * width];
+		if (memcmp(row, out.at(0, y), width) == 0)
+			continue;
+		memcpy(row, out.at(0, y), width);
+		first = std::min(first, y);
+		last = y + 1;
+	}
+	if (first >= last)
+		return { 0, 0 };
+	return { first, last };
+}
+
+/**
+ * @brief Renders the parts of the world that changed since the previous frame.
+ * @param out The viewport
+ */
+void DrawGameIncremental(const Surface &out, const Lightmap &lightmap, Point position, Displacement offset, int rows, int columns)
+{
+	const size_t viewportSize = static_cast<size_t>(out.w()) * static_cast<size_t>(out.h());
+	const uint32_t viewSignature = ViewSignature(position, offset, rows, columns);
+	const bool fullRedraw = !IncrementalRedraw.valid
+	    || IsRedrawEverything()
+	    || IncrementalRedraw.viewSignature != viewSignature
+	    || IncrementalRedraw.world.size() != viewportSize;
+
+	const Rectangle rect = UpdateTileSignatures(position, Point {} + offset, rows, columns, out, fullRedraw);
+
+	std::vector<uint8_t> &world = IncrementalRedraw.world;
+	if (fullRedraw) {
+		world.resize(viewportSize);
+	} else {
+		// Erase the overlays of the previous frame
+		CopyRows(out, world, /*toSurface=*/true, 0, out.h());
+	}
+
+	// The world is drawn even if nothing changed, as drawing also queues the item labels
+	DrawWorld(out, lightmap, position, offset, rows, columns, rect);
+	CopyRows(out, world, /*toSurface=*/false, rect.position.y, rect.size.height);
+
+	IncrementalRedraw.valid = true;
+	IncrementalRedraw.viewSignature = viewSignature;
+	IncrementalRedraw.dirtyRect = rect;
+	IncrementalRedraw.pixelsRedrawn = static_cast<size_t>(rect.size.width) * static_cast<size_t>(rect.size.height);
+}
+
 /**
  * @brief Configure render and process screen rows
  * @param fullOut Buffer to render to
@@ -1226,6 +2181,7 @@ void CalcFirstTilePosition(Point &position, Displacement &offset)
  */
 void DrawGame(const Surface &fullOut, Point position, Displacement offset)
 {
+	DVL_PROFILE_ZONE("DrawGame");
 	// Limit rendering to the view area
 	const Surface &out = !*GetOptions().Graphics.zoom
 	    ? fullOut.subregionY(0, gnViewportHeight)
@@ -1271,14 +2227,21 @@ void DrawGame(const Surface &fullOut, Point position, Displacement offset)
 	DunRenderStats.clear();
 #endif
 
+	UpdateRenderTiles(position, Point {} + offset, rows, columns);
+	UpdateVisibleTiles(position, Point {} + offset, rows, columns);
+
 	Lightmap lightmap = Lightmap::build(*GetOptions().Graphics.perPixelLighting, position, Point {} + offset,
 	    gnScreenWidth, gnViewportHeight, rows, columns,
 	    out.at(0, 0), out.pitch(), LightTables, FullyLitLightTable, FullyDarkLightTable,
 	    dLight, MicroTileLen);
 
-	DrawFloor(out, lightmap, position, Point {} + offset, rows, columns);
-	DrawTileContent(out, lightmap, position, Point {} + offset, rows, columns);
-	DrawOOB(out, lightmap, position, Point {} + offset, rows, columns);
+	if (IsIncrementalRedrawEnabled()) {
+		DrawGameIncremental(out, lightmap, position, offset, rows, columns);
+	} else {
+		IncrementalRedraw.valid = false;
+		IncrementalRedraw.pixelsRedrawn = static_cast<size_t>(out.w()) * static_cast<size_t>(out.h());
+		DrawWorld(out, lightmap, position, offset, rows, columns, { { 0, 0 }, { out.w(), out.h() } });
+	}
 
 	if (*GetOptions().Graphics.zoom) {
 		Zoom(fullOut.subregionY(0, gnViewportHeight));
@@ -1316,6 +2279,18 @@ void DrawView(const Surface &out, Point startPosition)
 	Displacement offset = {};
 	CalcFirstTilePosition(startPosition, offset);
 	DrawGame(out, startPosition, offset);
+#ifdef _DEBUG
+	if (DebugDirtyRegions && IncrementalRedraw.valid) {
+		const Rectangle &rect = IncrementalRedraw.dirtyRect;
+		if (rect.size.width > 0 && rect.size.height > 0) {
+			const uint8_t col = PAL16_RED + 4;
+			DrawHorizontalLine(out, rect.position, rect.size.width, col);
+			DrawHorizontalLine(out, rect.position + Displacement { 0, rect.size.height - 1 }, rect.size.width, col);
+			DrawVerticalLine(out, rect.position, rect.size.height, col);
+			DrawVerticalLine(out, rect.position + Displacement { rect.size.width - 1, 0 }, rect.size.height, col);
+		}
+	}
+#endif
 	if (AutomapActive) {
 		DrawAutomap(out.subregionY(0, gnViewportHeight));
 	}
@@ -1480,6 +2455,39 @@ void DrawFPS(const Surface &out)
 		formatted = { buf, static_cast<std::string_view::size_type>(end - buf) };
 	};
 	DrawString(out, formatted, Point { 8, 8 }, { .flags = UiFlags::ColorRed });
+	int lineY = 24;
+	const FrameTimeStats frameTimes = GetFrameTimeStats();
+	DrawString(out, StrCat(frameTimes.meanUs / 1000, ".", frameTimes.meanUs / 100 % 10, " ms per frame, ", frameTimes.stdevUs / 1000, ".", frameTimes.stdevUs / 100 % 10, " ms stdev"),
+	    Point { 8, lineY }, { .flags = UiFlags::ColorRed });
+	lineY += 16;
+	if (IsIncrementalRedrawEnabled()) {
+		DrawString(out, StrCat(IncrementalRedraw.pixelsRedrawn, " px redrawn"), Point { 8, lineY }, { .flags = UiFlags::ColorRed });
+		lineY += 16;
+	}
+	DrawString(out, StrCat(WorldDisplayListStats.lastFrameCommands, " draw commands"), Point { 8, lineY }, { .flags = UiFlags::ColorRed });
+	lineY += 16;
+	if (gbIsMultiplayer) {
+		const TurnPacing pacing = nthread_get_turn_pacing();
+		DrawString(out, StrCat(pacing.delayMs, " ms turn delay, ", pacing.jitterMs, " ms jitter"), Point { 8, lineY }, { .flags = UiFlags::ColorRed });
+		lineY += 16;
+	}
+#ifdef DEVILUTIONX_FRAME_PROFILER
+	const std::span<const FrameProfilerZoneStats> zones = GetFrameProfilerZones();
+	if (!zones.empty()) {
+		DrawString(out, StrCat("us per frame: last / avg / max of ", FrameProfilerWindow), Point { 8, lineY }, { .flags = UiFlags::ColorRed });
+		lineY += 16;
+	}
+	for (const FrameProfilerZoneStats &zone : zones) {
+#ifdef DEVILUTIONX_ALLOCATION_TRACKER
+		DrawString(out, StrCat(zone.name, ": ", zone.lastUs, " / ", zone.averageUs, " / ", zone.maxUs, ", ", zone.lastAllocations, " allocations"),
+		    Point { 8 + (zone.depth * 12), lineY }, { .flags = UiFlags::ColorRed });
+#else
+		DrawString(out, StrCat(zone.name, ": ", zone.lastUs, " / ", zone.averageUs, " / ", zone.maxUs),
+		    Point { 8 + (zone.depth * 12), lineY }, { .flags = UiFlags::ColorRed });
+#endif
+		lineY += 16;
+	}
+#endif
 }
 
 /**
@@ -1500,6 +2508,90 @@ void DoBlitScreen(Rectangle area)
 	BltFast(&srcRect, &dstRect);
 }
 
+/**
+ * @brief The areas of the main panel, relative to it, that a panel component is drawn to.
+ */
+std::span<const Rectangle> GetPanelComponentAreas(PanelDrawComponent component)
+{
+	static constexpr Rectangle HealthAreas[] = { { { 96, 0 }, { 88, 72 } } };
+	// The mana flask and the spell icon below it
+	static constexpr Rectangle ManaAreas[] = { { { 460, 0 }, { 92, 72 } }, { { 564, 64 }, { 56, 56 } } };
+	// The multiplayer buttons come last
+	static constexpr Rectangle ControlButtonAreas[] = {
+		{ { 8, 7 }, { 74, 114 } },
+		{ { 559, 7 }, { 74, 48 } },
+		{ { 86, 91 }, { 34, 32 } },
+		{ { 526, 91 }, { 34, 32 } },
+	};
+	static constexpr Rectangle BeltAreas[] = { { { 204, 5 }, { 232, 28 } } };
+
+	switch (component) {
+	case PanelDrawComponent::Health:
+		return HealthAreas;
+	case PanelDrawComponent::Mana:
+		return ManaAreas;
+	case PanelDrawComponent::ControlButtons:
+		return std::span(ControlButtonAreas).first(gbIsMultiplayer ? 4 : 2);
+	case PanelDrawComponent::Belt:
+		return BeltAreas;
+	}
+	return {};
+}
+
+/**
+ * @brief Copy of the composed main panel, for layouts where the world is drawn beneath it.
+ *
+ * The world is drawn over the panel area every frame, the panel is then restored
+ * from this copy and only the components flagged with `RedrawComponent` are drawn again.
+ */
+struct MainPanelCache {
+	std::optional<OwnedSurface> surface;
+	PanelCacheStats stats {};
+};
+
+MainPanelCache PanelCache;
+
+bool IsPanelCacheUsable()
+{
+	const Size panelSize = GetMainPanel().size;
+	return PanelCache.surface && PanelCache.surface->w() == panelSize.width && PanelCache.surface->h() == panelSize.height;
+}
+
+/**
+ * @brief Restores the panel as it was composed in the previous frame, apart from the info box that changes all the time.
+ */
+void RestoreMainPanel(const Surface &out)
+{
+	++PanelCache.stats.restoredFrames;
+	out.BlitFrom(*PanelCache.surface, MakeSdlRect(0, 0, PanelCache.surface->w(), PanelCache.surface->h()), GetMainPanel().position);
+	DrawInfoBox(out);
+}
+
+/**
+ * @brief Copies the panel components that were drawn this frame to the panel cache.
+ * @param out Output surface.
+ * @param drawnPanel The whole panel was drawn
+ * @param drawnComponents The components that were drawn over the panel
+ */
+void UpdatePanelCache(const Surface &out, bool drawnPanel, std::span<const PanelDrawComponent> drawnComponents)
+{
+	const Rectangle &mainPanel = GetMainPanel();
+	++PanelCache.stats.frames;
+	if (drawnPanel) {
+		if (!IsPanelCacheUsable())
+			PanelCache.surface.emplace(mainPanel.size);
+		PanelCache.surface->BlitFrom(out, MakeSdlRect(mainPanel), { 0, 0 });
+		return;
+	}
+	for (const PanelDrawComponent component : drawnComponents) {
+		++PanelCache.stats.componentsDrawn;
+		for (const Rectangle &area : GetPanelComponentAreas(component)) {
+			const Point position = mainPanel.position + Displacement { area.position.x, area.position.y };
+			PanelCache.surface->BlitFrom(out, MakeSdlRect(position.x, position.y, area.size.width, area.size.height), area.position);
+		}
+	}
+}
+
 /**
  * @brief Check render pipeline and update individual screen parts
  * @param out Output surface.
@@ -1523,8 +2615,12 @@ void DrawMain(int dwHgt, bool drawDesc, bool drawHp, bool drawMana, bool drawSba
 	}
 	if (dwHgt < gnScreenHeight) {
 		const Point mainPanelPosition = GetMainPanel().position;
+		const auto blitComponent = [&](PanelDrawComponent component) {
+			for (const Rectangle &area : GetPanelComponentAreas(component))
+				DoBlitScreen({ mainPanelPosition + Displacement { area.position.x, area.position.y }, area.size });
+		};
 		if (drawSbar) {
-			DoBlitScreen({ mainPanelPosition + Displacement { 204, 5 }, { 232, 28 } });
+			blitComponent(PanelDrawComponent::Belt);
 		}
 		if (drawDesc) {
 			if (ChatFlag) {
@@ -1535,19 +2631,13 @@ void DrawMain(int dwHgt, bool drawDesc, bool drawHp, bool drawMana, bool drawSba
 			}
 		}
 		if (drawMana) {
-			DoBlitScreen({ mainPanelPosition + Displacement { 460, 0 }, { 88, 72 } });
-			DoBlitScreen({ mainPanelPosition + Displacement { 564, 64 }, { 56, 56 } });
+			blitComponent(PanelDrawComponent::Mana);
 		}
 		if (drawHp) {
-			DoBlitScreen({ mainPanelPosition + Displacement { 96, 0 }, { 88, 72 } });
+			blitComponent(PanelDrawComponent::Health);
 		}
 		if (drawBtn) {
-			DoBlitScreen({ mainPanelPosition + Displacement { 8, 7 }, { 74, 114 } });
-			DoBlitScreen({ mainPanelPosition + Displacement { 559, 7 }, { 74, 48 } });
-			if (gbIsMultiplayer) {
-				DoBlitScreen({ mainPanelPosition + Displacement { 86, 91 }, { 34, 32 } });
-				DoBlitScreen({ mainPanelPosition + Displacement { 526, 91 }, { 34, 32 } });
-			}
+			blitComponent(PanelDrawComponent::ControlButtons);
 		}
 		if (PrevCursorRect.size.width != 0 && PrevCursorRect.size.height != 0) {
 			DoBlitScreen(PrevCursorRect);
@@ -1570,6 +2660,36 @@ const auto OptionChangeHandlerShowFPS = (GetOptions().Graphics.showFPS.SetValueC
 
 } // namespace
 
+FloorCacheStats GetFloorCacheStats()
+{
+	return FloorCache.stats;
+}
+
+DisplayListStats GetDisplayListStats()
+{
+	return WorldDisplayListStats;
+}
+
+void UpdateFloorOcclusion()
+{
+	for (size_t i = 0; i < MAXTILES; i++) {
+		const LevelCelBlock left { DPieceMicros[i].mt[2] };
+		const LevelCelBlock right { DPieceMicros[i].mt[3] };
+		PieceCoversFloorBehind[i] = left.hasValue() && left.type() == TileType::Square
+		    && right.hasValue() && right.type() == TileType::Square;
+	}
+}
+
+FloorOcclusionStats GetFloorOcclusionStats()
+{
+	return VisibleFloorStats;
+}
+
+PanelCacheStats GetPanelCacheStats()
+{
+	return PanelCache.stats;
+}
+
 Displacement GetOffsetForWalking(const AnimationInfo &animationInfo, const Direction dir, bool cameraMode /*= false*/)
 {
 	// clang-format off
@@ -1835,6 +2955,8 @@ void DrawAndBlit()
 		return;
 	}
 
+	FlushPaletteCycling();
+
 	int hgt = 0;
 	bool drawHealth = IsRedrawComponent(PanelDrawComponent::Health);
 	bool drawMana = IsRedrawComponent(PanelDrawComponent::Mana);
@@ -1845,8 +2967,14 @@ void DrawAndBlit()
 	bool drawCtrlPan = false;
 
 	const Rectangle &mainPanel = GetMainPanel();
+	// The world is drawn beneath panels that don't span the whole screen
+	const bool panelOverWorld = gnScreenWidth > mainPanel.size.width;
+	bool restorePanel = false;
 
-	if (gnScreenWidth > mainPanel.size.width || IsRedrawEverything()) {
+	if (panelOverWorld && !IsRedrawEverything() && IsPanelCacheUsable()) {
+		restorePanel = true;
+		hgt = gnScreenHeight;
+	} else if (panelOverWorld || IsRedrawEverything()) {
 		drawHealth = true;
 		drawMana = true;
 		drawControlButtons = true;
@@ -1866,6 +2994,9 @@ void DrawAndBlit()
 	nthread_UpdateProgressToNextGameTick();
 
 	DrawView(out, ViewPosition);
+	if (restorePanel) {
+		RestoreMainPanel(out);
+	}
 	if (drawCtrlPan) {
 		DrawMainPanel(out);
 	}
@@ -1883,6 +3014,18 @@ void DrawAndBlit()
 	if (drawBelt) {
 		DrawInvBelt(out);
 	}
+	if (panelOverWorld) {
+		StaticVector<PanelDrawComponent, enum_size<PanelDrawComponent>::value> drawnComponents;
+		if (drawHealth)
+			drawnComponents.push_back(PanelDrawComponent::Health);
+		if (drawMana)
+			drawnComponents.push_back(PanelDrawComponent::Mana);
+		if (drawControlButtons)
+			drawnComponents.push_back(PanelDrawComponent::ControlButtons);
+		if (drawBelt)
+			drawnComponents.push_back(PanelDrawComponent::Belt);
+		UpdatePanelCache(out, drawCtrlPan, drawnComponents);
+	}
 	if (drawChatInput) {
 		DrawChatBox(out);
 	}
@@ -1905,6 +3048,18 @@ void DrawAndBlit()
 
 	lua::GameDrawComplete();
 
+	if (gbActive && IsIncrementalRedrawEnabled() && hgt > 0) {
+		// The screen may have been recreated, in which case nothing on it can be relied on
+		if (IsRedrawEverything())
+			IncrementalRedraw.previousFrameHeight = 0;
+		const auto [first, last] = UpdateChangedRows(out, hgt);
+		if (last > first)
+			DoBlitScreen({ { 0, first }, { gnScreenWidth, last - first } });
+		hgt = 0;
+	} else {
+		IncrementalRedraw.previousFrameHeight = 0;
+	}
+
 	DrawMain(hgt, drawInfoBox, drawHealth, drawMana, drawBelt, drawControlButtons);
 
 #ifdef _DEBUG
@@ -1919,6 +3074,9 @@ void DrawAndBlit()
 	}
 
 	RenderPresent();
+#ifdef DEVILUTIONX_FRAME_PROFILER
+	FrameProfilerEndFrame();
+#endif
 }
 
 } // namespace devilution
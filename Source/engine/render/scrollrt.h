@@ -5,6 +5,8 @@
  */
 #pragma once
 
+#include <cstdint>
+
 #include "engine/animationinfo.h"
 #include "engine/direction.hpp"
 #include "engine/displacement.hpp"
@@ -90,4 +92,59 @@ void scrollrt_draw_game_screen();
  */
 void DrawAndBlit();
 
+struct FloorCacheStats {
+	/** @brief Frames rendered with the floor cache enabled. */
+	uint32_t frames;
+	/** @brief Frames in which the cached floor was scrolled. */
+	uint32_t shiftedFrames;
+	/** @brief Frames in which nothing could be reused, e.g. after a level change. */
+	uint32_t fullRebuilds;
+	uint64_t tilesReused;
+	uint64_t tilesRendered;
+};
+
+FloorCacheStats GetFloorCacheStats();
+
+struct DisplayListStats {
+	/** @brief Frames in which the world was drawn. */
+	uint32_t frames;
+	/** @brief Draw commands recorded for the last frame. */
+	uint32_t lastFrameCommands;
+	/** @brief Draw commands recorded over all frames. */
+	uint64_t commands;
+	/** @brief Draw commands executed, commands that reach into several render bands count once per band. */
+	uint64_t commandsDrawn;
+};
+
+DisplayListStats GetDisplayListStats();
+
+/**
+ * @brief Finds the dungeon pieces whose walls hide the floor behind them.
+ *
+ * Has to be called whenever `DPieceMicros` changed.
+ */
+void UpdateFloorOcclusion();
+
+struct FloorOcclusionStats {
+	/** @brief Frames in which the visible tiles were collected. */
+	uint32_t frames;
+	/** @brief Floor tiles in view over all frames. */
+	uint64_t floorTiles;
+	/** @brief Floor tiles that weren't drawn as a wall covers them. */
+	uint64_t hiddenTiles;
+};
+
+FloorOcclusionStats GetFloorOcclusionStats();
+
+struct PanelCacheStats {
+	/** @brief Frames in which the main panel was drawn over the world. */
+	uint32_t frames;
+	/** @brief Frames in which the panel was restored from the cache instead of drawn from scratch. */
+	uint32_t restoredFrames;
+	/** @brief Panel components drawn over a restored panel. */
+	uint64_t componentsDrawn;
+};
+
+PanelCacheStats GetPanelCacheStats();
+
 } // namespace devilution
@@ -13,6 +13,7 @@
 #include <string_view>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include <ankerl/unordered_dense.h>
 #include <fmt/core.h>
@@ -34,6 +35,7 @@
 #include "utils/is_of.hpp"
 #include "utils/language.h"
 #include "utils/log.hpp"
+#include "utils/memory_stats.hpp"
 #include "utils/str_cat.hpp"
 #include "utils/utf8.hpp"
 
@@ -45,9 +47,26 @@ namespace {
 
 constexpr char32_t ZWSP = U'\u200B'; // Zero-width space
 
+#ifdef DEVILUTIONX_FONT_BUDGET
+/** @brief How much memory the loaded font rows may take up, CJK languages have hundreds of them. */
+constexpr size_t FontBudget = DEVILUTIONX_FONT_BUDGET;
+#else
+constexpr size_t FontBudget = 32 * 1024 * 1024;
+#endif
+
+/** @brief At most this many rows are loaded ahead of time by `PrewarmFonts`. */
+constexpr size_t MaxPrewarmedFontRows = 8;
+
 struct OwnedFontStack {
 	OptionalOwnedClxSpriteList baseFont;
 	OptionalOwnedClxSpriteList overrideFont;
+	/** @brief The value of `FontFrame` when this row was last used. */
+	uint32_t lastUsedFrame = 0;
+
+	[[nodiscard]] size_t dataSize() const
+	{
+		return (baseFont ? baseFont->dataSize() : 0) + (overrideFont ? overrideFont->dataSize() : 0);
+	}
 };
 
 struct FontStack {
@@ -79,6 +98,12 @@ struct FontStack {
 
 ankerl::unordered_dense::map<uint32_t, OwnedFontStack> Fonts;
 
+/** @brief The memory taken up by all of `Fonts`. */
+size_t FontsSize = 0;
+
+/** @brief Counts the calls to `TrimFonts`, the rows used since the last one are never unloaded. */
+uint32_t FontFrame = 1;
+
 std::array<int, 6> FontSizes = { 12, 24, 30, 42, 46, 22 };
 constexpr std::array<int, 6> LineHeights = { 12, 26, 38, 42, 50, 22 };
 constexpr int SmallFontTallLineHeight = 16;
@@ -112,6 +137,57 @@ std::array<const char *, 19> ColorTranslations = {
 
 std::array<std::optional<std::array<uint8_t, 256>>, 19> ColorTranslationsData;
 
+/** @brief A glyph of a laid out string, positioned relative to the top-left corner of its rectangle. */
+struct LayoutGlyph {
+	ClxSprite sprite;
+	Displacement offset;
+};
+
+/**
+ * @brief The glyphs that `DrawString` drew for a string, so that it can be drawn again without decoding,
+ * measuring and wrapping it.
+ *
+ * Everything the layout depends on is stored alongside it, positions are relative to the rectangle.
+ */
+struct TextLayout {
+	std::string text;
+	UiFlags flags;
+	int spacing;
+	int lineHeight;
+	Size size;
+	int bottomMargin;
+
+	std::vector<LayoutGlyph> glyphs;
+	/** @brief The line height after resolving the default of -1. */
+	int resolvedLineHeight;
+	/** @brief Where the line of the PentaCursor starts. */
+	int initialX;
+	/** @brief The position after the last glyph. */
+	Displacement end;
+	uint32_t bytesDrawn;
+
+	[[nodiscard]] bool matches(std::string_view otherText, const TextRenderOptions &opts, Size otherSize, int otherBottomMargin) const
+	{
+		return flags == opts.flags && spacing == opts.spacing && lineHeight == opts.lineHeight
+		    && size == otherSize && bottomMargin == otherBottomMargin && text == otherText;
+	}
+};
+
+/** @brief The cache is dropped as a whole when it grows past this, e.g. from text that changes every frame. */
+constexpr size_t MaxTextLayouts = 1024;
+
+/** @brief Laid out strings by `TextLayoutHash`, these point into `Fonts` so they are cleared with it. */
+ankerl::unordered_dense::map<uint64_t, TextLayout> TextLayouts;
+
+uint64_t TextLayoutHash(std::string_view text, const TextRenderOptions &opts, Size size, int bottomMargin)
+{
+	uint64_t hash = ankerl::unordered_dense::hash<std::string_view> {}(text);
+	for (const int value : { static_cast<int>(opts.flags), opts.spacing, opts.lineHeight, size.width, size.height, bottomMargin }) {
+		hash = (hash ^ static_cast<uint32_t>(value)) * 0x100000001B3;
+	}
+	return hash;
+}
+
 text_color GetColorFromFlags(UiFlags flags)
 {
 	if (HasAnyOf(flags, UiFlags::ColorWhite))
@@ -195,10 +271,12 @@ FontStack LoadFont(GameFontTables size, text_color color, uint16_t row)
 	const uint32_t fontId = GetFontId(size, row);
 	auto hotFont = Fonts.find(fontId);
 	if (hotFont != Fonts.end()) {
+		hotFont->second.lastUsedFrame = FontFrame;
 		return FontStack(hotFont->second);
 	}
 
 	OwnedFontStack &font = Fonts[fontId];
+	font.lastUsedFrame = FontFrame;
 	char path[32];
 
 	// Load language-specific glyphs:
@@ -230,6 +308,8 @@ FontStack LoadFont(GameFontTables size, text_color color, uint16_t row)
 		LogError("Error loading font: {}", path);
 	}
 
+	FontsSize += font.dataSize();
+	MemoryStatsSet(MemoryTag::Fonts, FontsSize);
 	return FontStack(font);
 }
 
@@ -449,7 +529,8 @@ void DrawLine(
     bool outline,
     const TextRenderOptions &opts,
     size_t lineStartPos,
-    int totalWidth)
+    int totalWidth,
+    std::vector<LayoutGlyph> *glyphsOut)
 {
 	CurrentFont currentFont;
 
@@ -509,6 +590,8 @@ void DrawLine(
 		}
 
 		DrawFont(out, characterPosition, glyph, color, outline);
+		if (glyphsOut != nullptr)
+			glyphsOut->push_back({ glyph, characterPosition - rect.position });
 		maybeDrawCursor();
 
 		// Move to the next position
@@ -522,7 +605,7 @@ void DrawLine(
 
 uint32_t DoDrawString(const Surface &out, std::string_view text, Rectangle rect, Point &characterPosition,
     int lineWidth, int charactersInLine, int rightMargin, int bottomMargin, GameFontTables size, text_color color, bool outline,
-    TextRenderOptions &opts)
+    TextRenderOptions &opts, std::vector<LayoutGlyph> *glyphsOut)
 {
 	CurrentFont currentFont;
 	int curSpacing = opts.spacing;
@@ -557,7 +640,8 @@ uint32_t DoDrawString(const Surface &out, std::string_view text, Rectangle rect,
 			    outline,
 			    opts,
 			    lineStartPos,
-			    lineWidth);
+			    lineWidth,
+			    glyphsOut);
 		}
 	};
 
@@ -630,7 +714,62 @@ void LoadSmallSelectionSpinner()
 
 void UnloadFonts()
 {
+	TextLayouts.clear();
 	Fonts.clear();
+	FontsSize = 0;
+	MemoryStatsSet(MemoryTag::Fonts, FontsSize);
+}
+
+void TrimFonts()
+{
+	const uint32_t currentFrame = FontFrame++;
+	if (FontsSize <= FontBudget)
+		return;
+
+	std::vector<std::pair<uint32_t, uint32_t>> rowsByLastUse;
+	for (const auto &[fontId, font] : Fonts) {
+		if (font.lastUsedFrame != currentFrame)
+			rowsByLastUse.emplace_back(font.lastUsedFrame, fontId);
+	}
+	if (rowsByLastUse.empty())
+		return;
+	c_sort(rowsByLastUse);
+
+	// The cached layouts point into the unloaded glyphs.
+	TextLayouts.clear();
+	for (const auto &[lastUsedFrame, fontId] : rowsByLastUse) {
+		if (FontsSize <= FontBudget)
+			break;
+		const auto it = Fonts.find(fontId);
+		FontsSize -= it->second.dataSize();
+		Fonts.erase(it);
+	}
+	MemoryStatsSet(MemoryTag::Fonts, FontsSize);
+}
+
+void PrewarmFonts(std::string_view text, GameFontTables size)
+{
+	ankerl::unordered_dense::map<uint16_t, size_t> rowUses;
+	while (!text.empty()) {
+		const char32_t next = ConsumeFirstUtf8CodePoint(&text);
+		if (next == Utf8DecodeError)
+			break;
+		if (next == U'\0' || next == ZWSP)
+			continue;
+		++rowUses[GetUnicodeRow(next)];
+	}
+
+	std::vector<std::pair<uint16_t, size_t>> rows(rowUses.begin(), rowUses.end());
+	c_sort(rows, [](const auto &a, const auto &b) { return a.second > b.second; });
+	if (rows.size() > MaxPrewarmedFontRows)
+		rows.resize(MaxPrewarmedFontRows);
+
+	for (const auto &[row, uses] : rows) {
+		// Leave room for the rows that are drawn.
+		if (FontsSize > FontBudget / 2)
+			break;
+		LoadFont(size, text_color::ColorDialogWhite, row);
+	}
 }
 
 int GetLineWidth(std::string_view text, GameFontTables size, int spacing, int *charactersInLine)
@@ -836,6 +975,51 @@ uint32_t DrawString(const Surface &out, std::string_view text, const Rectangle &
 	const GameFontTables size = GetFontSizeFromUiFlags(opts.flags);
 	const text_color color = GetColorFromFlags(opts.flags);
 
+	const int rightMargin = rect.position.x + rect.size.width;
+	const int bottomMargin = rect.size.height != 0 ? std::min(rect.position.y + rect.size.height + BaseLineOffset[size], out.h()) : out.h();
+
+	const bool outlined = HasAnyOf(opts.flags, UiFlags::Outlined);
+
+	const Surface clippedOut = ClipSurface(out, rect);
+
+	// Only draw the PentaCursor if the cursor is not at the end.
+	if (HasAnyOf(opts.flags, UiFlags::PentaCursor) && static_cast<size_t>(opts.cursorPosition) == text.size()) {
+		opts.cursorPosition = -1;
+	}
+
+	// The text cursor blinks and the highlight is edited, only strings without either are cached.
+	const bool cacheLayout = (opts.cursorPosition < 0 || static_cast<size_t>(opts.cursorPosition) > text.size())
+	    && opts.highlightRange.begin >= opts.highlightRange.end;
+	const int relativeBottomMargin = bottomMargin - rect.position.y;
+	uint64_t layoutHash = 0;
+	if (cacheLayout) {
+		layoutHash = TextLayoutHash(text, opts, rect.size, relativeBottomMargin);
+		const auto it = TextLayouts.find(layoutHash);
+		if (it != TextLayouts.end() && it->second.matches(text, opts, rect.size, relativeBottomMargin)) {
+			const TextLayout &layout = it->second;
+			for (const LayoutGlyph &glyph : layout.glyphs) {
+				DrawFont(clippedOut, rect.position + glyph.offset, glyph.sprite, color, outlined);
+			}
+			if (HasAnyOf(opts.flags, UiFlags::PentaCursor)) {
+				Point characterPosition = rect.position + layout.end;
+				const ClxSprite sprite = (*pSPentSpn2Cels)[PentSpn2Spin()];
+				MaybeWrap(characterPosition, sprite.width(), rightMargin, rect.position.x + layout.initialX, layout.resolvedLineHeight);
+				ClxDraw(clippedOut, characterPosition + Displacement { 0, layout.resolvedLineHeight - BaseLineOffset[size] }, sprite);
+			}
+			return layout.bytesDrawn;
+		}
+	}
+
+	TextLayout layout;
+	if (cacheLayout) {
+		layout.text = std::string(text);
+		layout.flags = opts.flags;
+		layout.spacing = opts.spacing;
+		layout.lineHeight = opts.lineHeight;
+		layout.size = rect.size;
+		layout.bottomMargin = relativeBottomMargin;
+	}
+
 	int charactersInLine = 0;
 	int lineWidth = 0;
 	if (HasAnyOf(opts.flags, (UiFlags::AlignCenter | UiFlags::AlignRight | UiFlags::KerningFitSpacing)))
@@ -844,9 +1028,6 @@ uint32_t DrawString(const Surface &out, std::string_view text, const Rectangle &
 	Point characterPosition { GetLineStartX(opts.flags, rect, lineWidth), rect.position.y };
 	const int initialX = characterPosition.x;
 
-	const int rightMargin = rect.position.x + rect.size.width;
-	const int bottomMargin = rect.size.height != 0 ? std::min(rect.position.y + rect.size.height + BaseLineOffset[size], out.h()) : out.h();
-
 	if (opts.lineHeight == -1)
 		opts.lineHeight = GetLineHeight(text, size);
 
@@ -857,17 +1038,19 @@ uint32_t DrawString(const Surface &out, std::string_view text, const Rectangle &
 
 	characterPosition.y += BaseLineOffset[size];
 
-	const bool outlined = HasAnyOf(opts.flags, UiFlags::Outlined);
-
-	const Surface clippedOut = ClipSurface(out, rect);
-
-	// Only draw the PentaCursor if the cursor is not at the end.
-	if (HasAnyOf(opts.flags, UiFlags::PentaCursor) && static_cast<size_t>(opts.cursorPosition) == text.size()) {
-		opts.cursorPosition = -1;
-	}
-
 	const uint32_t bytesDrawn = DoDrawString(clippedOut, text, rect, characterPosition,
-	    lineWidth, charactersInLine, rightMargin, bottomMargin, size, color, outlined, opts);
+	    lineWidth, charactersInLine, rightMargin, bottomMargin, size, color, outlined, opts,
+	    cacheLayout ? &layout.glyphs : nullptr);
+
+	if (cacheLayout) {
+		if (TextLayouts.size() >= MaxTextLayouts)
+			TextLayouts.clear();
+		layout.initialX = initialX - rect.position.x;
+		layout.end = characterPosition - rect.position;
+		layout.bytesDrawn = bytesDrawn;
+		layout.resolvedLineHeight = opts.lineHeight;
+		TextLayouts.insert_or_assign(layoutHash, std::move(layout));
+	}
 
 	if (HasAnyOf(opts.flags, UiFlags::PentaCursor)) {
 		const ClxSprite sprite = (*pSPentSpn2Cels)[PentSpn2Spin()];
@@ -266,6 +266,18 @@ inline void DrawStringWithColors(const Surface &out, std::string_view fmt, std::
 uint8_t PentSpn2Spin();
 void UnloadFonts();
 
+/**
+ * @brief Unloads the least recently drawn font rows while they take up more memory than the font budget.
+ *
+ * Rows drawn since the last call are kept, so this must be called between frames.
+ */
+void TrimFonts();
+
+/**
+ * @brief Loads the font rows that the given text uses the most, e.g. all the translated strings.
+ */
+void PrewarmFonts(std::string_view text, GameFontTables size);
+
 /** @brief Whether this character can be substituted by a newline when word-wrapping. */
 bool IsBreakableWhitespace(char32_t c);
 
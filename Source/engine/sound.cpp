@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <list>
 #include <memory>
 #include <mutex>
@@ -26,11 +27,13 @@
 #include <expected.hpp>
 
 #include "appfat.h"
+#include "engine/asset_prefetch.hpp"
 #include "engine/assets.hpp"
 #include "game_mode.hpp"
 #include "options.h"
 #include "utils/log.hpp"
 #include "utils/math.h"
+#include "utils/memory_stats.hpp"
 #include "utils/sdl_mutex.h"
 #include "utils/status_macros.hpp"
 #include "utils/stdcompat/shared_ptr_array.hpp"
@@ -64,7 +67,20 @@ std::string GetMp3Path(const char *path)
 	return mp3Path;
 }
 
-tl::expected<void, std::string> LoadAudioFile(const char *path, bool stream, SoundSample &result)
+/** @brief A buffer for a sound file, counted in the memory stats for as long as a sample holds on to it. */
+ArraySharedPtr<std::uint8_t> AllocateSoundFile(size_t size)
+{
+	MemoryStatsAdd(MemoryTag::Sounds, size);
+	return ArraySharedPtr<std::uint8_t>(new std::uint8_t[size], [size](std::uint8_t *data) {
+		MemoryStatsRemove(MemoryTag::Sounds, size);
+		delete[] data;
+	});
+}
+
+/**
+ * @param decode Whether to decode a sample that isn't streamed when loading it rather than every time it's played
+ */
+tl::expected<void, std::string> LoadAudioFile(const char *path, bool stream, SoundSample &result, bool decode = false)
 {
 	bool isMp3 = true;
 	std::string foundPath = GetMp3Path(path);
@@ -94,6 +110,13 @@ tl::expected<void, std::string> LoadAudioFile(const char *path, bool stream, Sou
 		if (result.SetChunkStream(foundPath, isMp3, /*logErrors=*/true) != 0) {
 			return tl::make_unexpected(StrCat("Failed to load audio file\n", foundPath, "\n", SDL_GetError(), "\n" __FILE__ ":", __LINE__));
 		}
+	} else if (std::optional<AssetData> prefetched = TakePrefetchedAsset(foundPath); prefetched) {
+		auto waveFile = AllocateSoundFile(prefetched->size);
+		memcpy(waveFile.get(), prefetched->data.get(), prefetched->size);
+		const int error = decode ? result.SetChunkDecoded(waveFile, prefetched->size, isMp3) : result.SetChunk(waveFile, prefetched->size, isMp3);
+		if (error != 0) {
+			return tl::make_unexpected(SDL_GetError());
+		}
 	} else {
 #if !defined(STREAM_ALL_AUDIO_MIN_FILE_SIZE) || STREAM_ALL_AUDIO_MIN_FILE_SIZE == 0
 		const size_t size = ref.size();
@@ -102,11 +125,11 @@ tl::expected<void, std::string> LoadAudioFile(const char *path, bool stream, Sou
 		if (!handle.ok()) {
 			return tl::make_unexpected(StrCat("Failed to load audio file\n", foundPath, "\n", SDL_GetError(), "\n" __FILE__ ":", __LINE__));
 		}
-		auto waveFile = MakeArraySharedPtr<std::uint8_t>(size);
+		auto waveFile = AllocateSoundFile(size);
 		if (!handle.read(waveFile.get(), size)) {
 			return tl::make_unexpected(StrCat("Failed to read file\n", foundPath, ": ", SDL_GetError(), __FILE__ ":", __LINE__));
 		}
-		const int error = result.SetChunk(waveFile, size, isMp3);
+		const int error = decode ? result.SetChunkDecoded(waveFile, size, isMp3) : result.SetChunk(waveFile, size, isMp3);
 		if (error != 0) {
 			return tl::make_unexpected(SDL_GetError());
 		}
@@ -114,26 +137,79 @@ tl::expected<void, std::string> LoadAudioFile(const char *path, bool stream, Sou
 	return {};
 }
 
-std::list<std::unique_ptr<SoundSample>> duplicateSounds;
+/**
+ * @brief How many copies of sounds that are already playing can play at the same time.
+ *
+ * Together with the sounds themselves this bounds the number of streams the mixer has to mix.
+ */
+constexpr size_t MaxDuplicateSounds = 32;
+
+struct DuplicateSoundEntry {
+	std::unique_ptr<SoundSample> sample;
+	/** @brief The volume it was played with, lower for sounds further away. */
+	int volume;
+};
+
+std::list<DuplicateSoundEntry> duplicateSounds;
 std::optional<SdlMutex> duplicateSoundsMutex;
 
-SoundSample *DuplicateSound(const SoundSample &sound)
+/**
+ * @brief Makes room for another duplicate by taking the place of the quietest one, if it's quieter than `volume`.
+ * @return The sample that was replaced, to be destroyed without holding the lock, or nullptr if the new sound is the quietest.
+ *
+ * Requires holding the duplicateSoundsMutex.
+ */
+std::unique_ptr<SoundSample> StealDuplicateSound(int volume, bool &hasRoom)
+{
+#ifdef USE_SDL3
+	// SDL_mixer has no finish callback, drop the duplicates that have finished first
+	duplicateSounds.remove_if([](DuplicateSoundEntry &entry) { return !entry.sample->IsPlaying(); });
+#endif
+	hasRoom = true;
+	if (duplicateSounds.size() < MaxDuplicateSounds)
+		return nullptr;
+	auto quietest = std::min_element(duplicateSounds.begin(), duplicateSounds.end(), [](const DuplicateSoundEntry &a, const DuplicateSoundEntry &b) {
+		return a.volume < b.volume;
+	});
+	if (quietest->volume >= volume) {
+		hasRoom = false;
+		return nullptr;
+	}
+	std::unique_ptr<SoundSample> stolen = std::move(quietest->sample);
+	duplicateSounds.erase(quietest);
+	return stolen;
+}
+
+SoundSample *DuplicateSound(const SoundSample &sound, int volume)
 {
+	std::unique_ptr<SoundSample> stolen;
+	{
+		const std::lock_guard<SdlMutex> lock(*duplicateSoundsMutex);
+		bool hasRoom;
+		stolen = StealDuplicateSound(volume, hasRoom);
+		if (!hasRoom)
+			return nullptr;
+	}
+	// Destroyed here rather than while holding the lock, see `ClearDuplicateSounds`
+	stolen = nullptr;
+
 	auto duplicate = std::make_unique<SoundSample>();
 	if (duplicate->DuplicateFrom(sound) != 0)
 		return nullptr;
 	auto *result = duplicate.get();
-	decltype(duplicateSounds.begin()) it;
 	{
 		const std::lock_guard<SdlMutex> lock(*duplicateSoundsMutex);
-		duplicateSounds.push_back(std::move(duplicate));
-		it = duplicateSounds.end();
-		--it;
+		duplicateSounds.push_back({ std::move(duplicate), volume });
 	}
 #ifndef USE_SDL3
-	result->SetFinishCallback([it]([[maybe_unused]] Aulib::Stream &stream) {
+	// Looked up by address, it may have been stolen or cleared by now
+	result->SetFinishCallback([result]([[maybe_unused]] Aulib::Stream &stream) {
 		const std::lock_guard<SdlMutex> lock(*duplicateSoundsMutex);
-		duplicateSounds.erase(it);
+		auto it = std::find_if(duplicateSounds.begin(), duplicateSounds.end(), [result](const DuplicateSoundEntry &entry) {
+			return entry.sample.get() == result;
+		});
+		if (it != duplicateSounds.end())
+			duplicateSounds.erase(it);
 	});
 #endif
 	return result;
@@ -162,6 +238,28 @@ const char *const MusicTracks[NUM_MUSIC] = {
 	"music\\dintro.wav",
 };
 
+const char *GetMusicTrackPath(_music_id nTrack)
+{
+	return HaveFullMusic() ? MusicTracks[nTrack] : SpawnMusicTracks[nTrack];
+}
+
+/**
+ * @brief Plays the track from memory if it has been prefetched, see `PrefetchMusic`.
+ */
+bool LoadPrefetchedMusic(const char *path, SoundSample &result)
+{
+	for (const bool isMp3 : { true, false }) {
+		const std::string foundPath = isMp3 ? GetMp3Path(path) : std::string(path);
+		std::optional<AssetData> prefetched = TakePrefetchedAsset(foundPath);
+		if (!prefetched)
+			continue;
+		auto fileData = AllocateSoundFile(prefetched->size);
+		memcpy(fileData.get(), prefetched->data.get(), prefetched->size);
+		return result.SetChunk(fileData, prefetched->size, isMp3) == 0;
+	}
+	return false;
+}
+
 int CapVolume(int volume)
 {
 	return std::clamp(volume, VOLUME_MIN, VOLUME_MAX);
@@ -194,7 +292,7 @@ void ClearDuplicateSounds()
 	// Move sound samples to a temporary list,
 	// avoiding a deadlock that involves SDL's
 	// mixer lock being taken by finalizers
-	std::list<std::unique_ptr<SoundSample>> drain;
+	std::list<DuplicateSoundEntry> drain;
 	{
 		const std::lock_guard<SdlMutex> lock(*duplicateSoundsMutex);
 		drain = std::move(duplicateSounds);
@@ -215,7 +313,7 @@ void snd_play_snd(TSnd *pSnd, int lVolume, int lPan, int userVolume)
 
 	SoundSample *sound = &pSnd->DSB;
 	if (sound->IsPlaying()) {
-		sound = DuplicateSound(*sound);
+		sound = DuplicateSound(*sound, lVolume);
 		if (sound == nullptr)
 			return;
 	}
@@ -224,12 +322,21 @@ void snd_play_snd(TSnd *pSnd, int lVolume, int lPan, int userVolume)
 	pSnd->start_tc = tc;
 }
 
+void PrefetchSoundFile(const char *path)
+{
+	const std::string mp3Path = GetMp3Path(path);
+	if (FindAsset(mp3Path).ok())
+		PrefetchAsset(mp3Path);
+	else
+		PrefetchAsset(path);
+}
+
 tl::expected<std::unique_ptr<TSnd>, std::string> SoundFileLoadWithStatus(const char *path, bool stream)
 {
 	auto snd = std::make_unique<TSnd>();
 	snd->start_tc = SDL_GetTicks() - 80 - 1;
 #ifndef NOSOUND
-	RETURN_IF_ERROR(LoadAudioFile(path, stream, snd->DSB));
+	RETURN_IF_ERROR(LoadAudioFile(path, stream, snd->DSB, /*decode=*/true));
 #endif
 	return snd;
 }
@@ -335,25 +442,33 @@ void music_stop()
 	sgnMusicTrack = NUM_MUSIC;
 }
 
-void music_start(_music_id nTrack)
+void PrefetchMusic(_music_id nTrack)
 {
-	const char *trackPath;
+	assert(nTrack < NUM_MUSIC);
+	if (!gbMusicOn || nTrack == sgnMusicTrack)
+		return;
+	const char *trackPath = GetMusicTrackPath(nTrack);
+	const std::string mp3Path = GetMp3Path(trackPath);
+	if (FindAsset(mp3Path).ok())
+		PrefetchAsset(mp3Path);
+	else
+		PrefetchAsset(trackPath);
+}
 
+void music_start(_music_id nTrack)
+{
 	assert(nTrack < NUM_MUSIC);
 	music_stop();
 	if (!gbMusicOn)
 		return;
-	if (HaveFullMusic())
-		trackPath = MusicTracks[nTrack];
-	else
-		trackPath = SpawnMusicTracks[nTrack];
+	const char *trackPath = GetMusicTrackPath(nTrack);
 
 #ifdef DISABLE_STREAMING_MUSIC
 	const bool stream = false;
 #else
 	const bool stream = true;
 #endif
-	if (!LoadAudioFile(trackPath, stream, music).has_value()) {
+	if (!LoadPrefetchedMusic(trackPath, music) && !LoadAudioFile(trackPath, stream, music).has_value()) {
 		music_stop();
 		return;
 	}
@@ -66,6 +66,10 @@ extern _music_id sgnMusicTrack;
 
 void ClearDuplicateSounds();
 void snd_play_snd(TSnd *pSnd, int lVolume, int lPan, int userVolume);
+/**
+ * @brief Starts reading the sound in the background, so that `sound_file_load` doesn't have to wait for it.
+ */
+void PrefetchSoundFile(const char *path);
 std::unique_ptr<TSnd> sound_file_load(const char *path, bool stream = false);
 tl::expected<std::unique_ptr<TSnd>, std::string> SoundFileLoadWithStatus(const char *path, bool stream = false);
 void snd_init();
@@ -73,6 +77,11 @@ void snd_deinit();
 _music_id GetLevelMusic(dungeon_type dungeonType);
 void music_stop();
 void music_start(_music_id nTrack);
+
+/**
+ * @brief Starts reading the track in the background, so that `music_start` can play it from memory.
+ */
+void PrefetchMusic(_music_id nTrack);
 void sound_disable_music(bool disable);
 int sound_get_or_set_music_volume(int volume);
 int sound_get_or_set_sound_volume(int volume);
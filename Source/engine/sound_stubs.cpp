@@ -10,6 +10,7 @@ _music_id sgnMusicTrack = NUM_MUSIC;
 
 void ClearDuplicateSounds() { }
 void snd_play_snd(TSnd *pSnd, int lVolume, int lPan, int userVolume) { }
+void PrefetchSoundFile(const char *path) { }
 std::unique_ptr<TSnd> sound_file_load(const char *path, bool stream) { return nullptr; }
 tl::expected<std::unique_ptr<TSnd>, std::string> SoundFileLoadWithStatus(const char *path, bool stream) { return nullptr; }
 TSnd::~TSnd() { }
@@ -17,6 +18,7 @@ void snd_init() { }
 void snd_deinit() { }
 void music_stop() { }
 void music_start(_music_id nTrack) { }
+void PrefetchMusic(_music_id nTrack) { }
 void sound_disable_music(bool disable) { }
 int sound_get_or_set_music_volume(int volume) { return 0; }
 int sound_get_or_set_sound_volume(int volume) { return 0; }
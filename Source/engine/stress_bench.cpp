@@ -0,0 +1,310 @@
+/**
+ * @file stress_bench.cpp
+ *
+ * Implementation of the stress scenarios and their benchmark.
+ */
+#include "engine/stress_bench.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "crawl.hpp"
+#include "diablo.h"
+#include "engine/point.hpp"
+#include "engine/random.hpp"
+#include "game_mode.hpp"
+#include "interfac.h"
+#include "items.h"
+#include "levels/gendung.h"
+#include "levels/tile_properties.hpp"
+#include "lighting.h"
+#include "missiles.h"
+#include "monster.h"
+#include "options.h"
+#include "player.h"
+#include "qol/itemlabels.h"
+#include "utils/file_util.h"
+#include "utils/log.hpp"
+#include "utils/static_vector.hpp"
+#include "utils/time_stats.hpp"
+
+namespace devilution {
+
+namespace {
+
+/** @brief The scenarios are built with the same random numbers every time. */
+constexpr uint32_t StressSeed = 0x5EED;
+
+constexpr size_t StressMonsterCount = 200;
+constexpr size_t StressMissileCount = 500;
+constexpr size_t StressLightCount = 100;
+constexpr size_t StressItemCount = 300;
+
+/** @brief Far enough from the hero for the monsters to find room on any level. */
+constexpr unsigned StressCrawlRadius = 40;
+
+constexpr std::array<std::pair<StressScenario, std::string_view>, 4> ScenarioNames { {
+    { StressScenario::Monsters, "monsters" },
+    { StressScenario::Missiles, "missiles" },
+    { StressScenario::Lights, "lights" },
+    { StressScenario::Items, "items" },
+} };
+
+std::vector<int> StressLights;
+/** @brief The lights move back and forth by this many tiles. */
+int StressLightStep = 1;
+
+enum class BenchState : uint8_t {
+	EnterLevel,
+	WaitForLevel,
+	Measure,
+};
+
+bool Running = false;
+StressScenario BenchScenario;
+int BenchTicks;
+std::string ReportPath;
+BenchState State;
+bool MeasuringTick;
+std::chrono::steady_clock::time_point TickStart;
+std::chrono::steady_clock::time_point RenderStart;
+std::vector<uint32_t> SimulationUs;
+std::vector<uint32_t> RenderUs;
+
+uint32_t MicrosecondsSince(std::chrono::steady_clock::time_point begin)
+{
+	return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count());
+}
+
+size_t SpawnStressMonsters()
+{
+	StaticVector<size_t, MaxLvlMTypes> scatterTypes;
+	for (size_t i = 0; i < LevelMonsterTypeCount; i++) {
+		if ((LevelMonsterTypes[i].placeFlags & PLACE_SCATTER) != 0)
+			scatterTypes.push_back(i);
+	}
+	if (scatterTypes.empty())
+		return 0;
+
+	const Point center = MyPlayer->position.tile;
+	size_t spawned = 0;
+	Crawl(1, StressCrawlRadius, [&](Displacement displacement) {
+		if (spawned == StressMonsterCount || ActiveMonsterCount >= MaxMonsters)
+			return true;
+		const Point position = center + displacement;
+		if (!InDungeonBounds(position) || !IsTileWalkable(position) || IsTileOccupied(position))
+			return false;
+		// Every type in turn, so that all of the level's AIs are in the mix
+		SpawnMonster(position, GetDirection(position, center), scatterTypes[spawned % scatterTypes.size()]);
+		spawned++;
+		return false;
+	});
+	return spawned;
+}
+
+void AddStressMissiles()
+{
+	const Point source = MyPlayer->position.tile;
+	for (size_t i = Missiles.size(); i < StressMissileCount; i++) {
+		const auto direction = static_cast<Direction>(i % 8);
+		const MissileID type = i % 2 == 0 ? MissileID::Firebolt : MissileID::LightningControl;
+		AddMissile(source, source + Displacement(direction) * 8, direction, type, TARGET_MONSTERS, *MyPlayer, 1, 1);
+	}
+}
+
+size_t AddStressLights()
+{
+	const Point center = MyPlayer->position.tile;
+	for (size_t i = StressLights.size(); i < StressLightCount; i++) {
+		const int id = AddLight(center + Displacement { static_cast<int>(i % 10) * 3 - 15, static_cast<int>(i / 10) * 3 - 15 }, 6);
+		if (id == NO_LIGHT)
+			break;
+		StressLights.push_back(id);
+	}
+	return StressLights.size();
+}
+
+void MoveStressLights()
+{
+	for (const int id : StressLights)
+		ChangeLightXY(id, Lights[id].position.tile + Displacement { StressLightStep, 0 });
+	StressLightStep = -StressLightStep;
+}
+
+size_t AddStressItems()
+{
+	const size_t before = ActiveItemCount;
+	for (size_t i = 0; i < StressItemCount && ActiveItemCount < MAXITEMS; i++)
+		CreateRndItem(MyPlayer->position.tile, /*onlygood=*/false, /*sendmsg=*/false, /*delta=*/false);
+	// Shows the labels without changing the option
+	if (!IsHighlightingLabelsEnabled())
+		HighlightKeyPressed(!*GetOptions().Gameplay.showItemLabels);
+	return ActiveItemCount - before;
+}
+
+/** @brief Keeps the load of the scenarios that wear off up. */
+void UpdateStressScenario()
+{
+	switch (BenchScenario) {
+	case StressScenario::Missiles:
+		AddStressMissiles();
+		break;
+	case StressScenario::Lights:
+		MoveStressLights();
+		break;
+	default:
+		break;
+	}
+}
+
+void WriteReport(const TimeStats &simulation, const TimeStats &render)
+{
+	FILE *file = OpenFile(ReportPath.c_str(), "wb");
+	if (file == nullptr) {
+		LogError("Failed to open {} for writing", ReportPath);
+		return;
+	}
+	const std::string report = fmt::format(
+	    "{{\n"
+	    "  \"scenario\": \"{}\",\n"
+	    "  \"level\": {},\n"
+	    "  \"ticks\": {},\n"
+	    "  \"monsters\": {},\n"
+	    "  \"missiles\": {},\n"
+	    "  \"lights\": {},\n"
+	    "  \"items\": {},\n"
+	    "  \"simulationMs\": {},\n"
+	    "  \"renderMs\": {}\n"
+	    "}}\n",
+	    StressScenarioName(BenchScenario), currlevel, SimulationUs.size(), ActiveMonsterCount, Missiles.size(), ActiveLightCount, ActiveItemCount,
+	    FormatTimeStatsJson(simulation), FormatTimeStatsJson(render));
+	std::fwrite(report.data(), 1, report.size(), file);
+	std::fclose(file);
+}
+
+void EndStressBench()
+{
+	const TimeStats simulation = ComputeTimeStats(SimulationUs);
+	const TimeStats render = ComputeTimeStats(RenderUs);
+	Log("Stress {}: {} ticks, simulation p50 {:.2f} ms, p99 {:.2f} ms, render p50 {:.2f} ms, p99 {:.2f} ms",
+	    StressScenarioName(BenchScenario), SimulationUs.size(), simulation.p50, simulation.p99, render.p50, render.p99);
+	if (!ReportPath.empty())
+		WriteReport(simulation, render);
+	Running = false;
+	gbRunGameResult = false;
+	gbRunGame = false;
+}
+
+} // namespace
+
+std::optional<StressScenario> ParseStressScenario(std::string_view name)
+{
+	for (const auto &[scenario, scenarioName] : ScenarioNames) {
+		if (scenarioName == name)
+			return scenario;
+	}
+	return std::nullopt;
+}
+
+std::string_view StressScenarioName(StressScenario scenario)
+{
+	for (const auto &[candidate, name] : ScenarioNames) {
+		if (candidate == scenario)
+			return name;
+	}
+	return "";
+}
+
+std::string BuildStressScenario(StressScenario scenario)
+{
+	if (leveltype == DTYPE_TOWN)
+		return "Stress scenarios need a dungeon level";
+
+	SetRndSeed(StressSeed);
+	switch (scenario) {
+	case StressScenario::Monsters:
+		return fmt::format("Spawned {} monsters", SpawnStressMonsters());
+	case StressScenario::Missiles:
+		AddStressMissiles();
+		return fmt::format("{} missiles in flight", Missiles.size());
+	case StressScenario::Lights:
+		StressLights.clear();
+		return fmt::format("Added {} lights", AddStressLights());
+	case StressScenario::Items:
+		return fmt::format("Dropped {} items", AddStressItems());
+	}
+	return "";
+}
+
+void InitStressBench(StressScenario scenario, int ticks, std::string_view reportPath)
+{
+	Running = true;
+	BenchScenario = scenario;
+	BenchTicks = ticks;
+	ReportPath = reportPath;
+	State = BenchState::EnterLevel;
+}
+
+bool IsStressBenchRunning()
+{
+	return Running;
+}
+
+void StressBenchTickStart()
+{
+	if (!Running || State != BenchState::Measure)
+		return;
+	MeasuringTick = true;
+	TickStart = std::chrono::steady_clock::now();
+}
+
+void StressBenchTick()
+{
+	if (!Running)
+		return;
+
+	Player &myPlayer = *MyPlayer;
+	switch (State) {
+	case BenchState::EnterLevel: {
+		// spawn.mpq only has the first two levels
+		const uint8_t level = gbIsSpawn ? 2 : 16;
+		State = BenchState::WaitForLevel;
+		if (setlevel || !myPlayer.isOnLevel(level))
+			StartNewLvl(myPlayer, WM_DIABNEXTLVL, level);
+		break;
+	}
+	case BenchState::WaitForLevel:
+		if (myPlayer._pLvlChanging)
+			break;
+		// Keeps the hero alive however long the monsters attack
+		myPlayer._pInvincible = true;
+		Log("Stress {}: {}", StressScenarioName(BenchScenario), BuildStressScenario(BenchScenario));
+		State = BenchState::Measure;
+		break;
+	case BenchState::Measure:
+		if (!MeasuringTick)
+			break;
+		SimulationUs.push_back(MicrosecondsSince(TickStart));
+		UpdateStressScenario();
+		RenderStart = std::chrono::steady_clock::now();
+		break;
+	}
+}
+
+void StressBenchTickEnd()
+{
+	if (!Running || !MeasuringTick)
+		return;
+	MeasuringTick = false;
+	RenderUs.push_back(MicrosecondsSince(RenderStart));
+	if (SimulationUs.size() >= static_cast<size_t>(BenchTicks))
+		EndStressBench();
+}
+
+} // namespace devilution
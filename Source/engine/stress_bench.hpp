@@ -0,0 +1,54 @@
+/**
+ * @file stress_bench.hpp
+ *
+ * Builds reproducible heavy loads, e.g. a level full of monsters, and times the game ticks that follow.
+ */
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace devilution {
+
+enum class StressScenario : uint8_t {
+	/** @brief 200 monsters of the types of the level around the hero. */
+	Monsters,
+	/** @brief 500 firebolts and lightnings in flight, topped up every game tick. */
+	Missiles,
+	/** @brief As many lights as there is room for, all of them moving every game tick. */
+	Lights,
+	/** @brief The floor around the hero full of items, with the item labels shown. */
+	Items,
+};
+
+std::optional<StressScenario> ParseStressScenario(std::string_view name);
+
+std::string_view StressScenarioName(StressScenario scenario);
+
+/**
+ * @brief Builds the scenario around the hero on the current level, always the same way for the same level.
+ * @return A description of what was built, or why nothing was.
+ */
+std::string BuildStressScenario(StressScenario scenario);
+
+/**
+ * @brief Loads the last single player hero as soon as the game starts, takes them to the deepest level,
+ * builds the scenario there and then ends the game after timing `ticks` game ticks.
+ * @param reportPath Where to write the tick times as JSON, nothing is written if empty.
+ */
+void InitStressBench(StressScenario scenario, int ticks, std::string_view reportPath);
+
+bool IsStressBenchRunning();
+
+/** @brief Called before the game logic of each game tick. */
+void StressBenchTickStart();
+
+/** @brief Called after the game logic of each game tick, takes the next step of the benchmark. */
+void StressBenchTick();
+
+/** @brief Called after each game tick has been drawn. */
+void StressBenchTickEnd();
+
+} // namespace devilution
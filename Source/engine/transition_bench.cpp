@@ -0,0 +1,105 @@
+/**
+ * @file transition_bench.cpp
+ *
+ * Implementation of the level transition benchmark.
+ */
+#include "engine/transition_bench.hpp"
+
+#include <cstdio>
+#include <string>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "diablo.h"
+#include "game_mode.hpp"
+#include "interfac.h"
+#include "player.h"
+#include "utils/file_util.h"
+#include "utils/level_load_timings.hpp"
+#include "utils/log.hpp"
+
+namespace devilution {
+
+namespace {
+
+bool Running = false;
+std::string ReportPath;
+std::vector<uint8_t> Levels;
+size_t NextLevel;
+bool TransitionPending;
+std::vector<LevelLoadTimings> Transitions;
+
+void WriteReport()
+{
+	FILE *file = OpenFile(ReportPath.c_str(), "wb");
+	if (file == nullptr) {
+		LogError("Failed to open {} for writing", ReportPath);
+		return;
+	}
+	std::string report = fmt::format("{{\n  \"levels\": [{}],\n  \"transitions\": [", fmt::join(Levels, ", "));
+	for (size_t i = 0; i < Transitions.size(); i++)
+		report += fmt::format("{}\n    {}", i == 0 ? "" : ",", FormatLevelLoadTimingsJson(Transitions[i]));
+	report += "\n  ]\n}\n";
+	std::fwrite(report.data(), 1, report.size(), file);
+	std::fclose(file);
+}
+
+void EndTransitionBench()
+{
+	uint32_t totalUs = 0;
+	for (const LevelLoadTimings &timings : Transitions)
+		totalUs += timings.totalUs;
+	Log("{} level transitions, {:.1f} ms", Transitions.size(), totalUs / 1000.0);
+	WriteReport();
+	Running = false;
+	gbRunGameResult = false;
+	gbRunGame = false;
+}
+
+} // namespace
+
+void InitTransitionBench(std::string_view reportPath, std::vector<uint8_t> levels)
+{
+	Running = true;
+	ReportPath = reportPath;
+	Levels = std::move(levels);
+}
+
+bool IsTransitionBenchRunning()
+{
+	return Running;
+}
+
+void TransitionBenchTick()
+{
+	if (!Running)
+		return;
+
+	Player &myPlayer = *MyPlayer;
+	if (TransitionPending) {
+		// The level change is done once the hero has joined the level
+		if (myPlayer._pLvlChanging)
+			return;
+		Transitions.push_back(GetLastLevelLoadTimings());
+		TransitionPending = false;
+	}
+
+	if (NextLevel == Levels.size()) {
+		EndTransitionBench();
+		return;
+	}
+	const uint8_t level = Levels[NextLevel++];
+	if (level > (gbIsHellfire ? 24 : 16)) {
+		LogError("Level {} does not exist", level);
+		EndTransitionBench();
+		return;
+	}
+	if (!setlevel && myPlayer.isOnLevel(level))
+		return;
+	TransitionPending = true;
+	// The crypt is entered from town, the other levels are entered as if by the stairs
+	StartNewLvl(myPlayer, level != 21 ? WM_DIABNEXTLVL : WM_DIABTOWNWARP, level);
+}
+
+} // namespace devilution
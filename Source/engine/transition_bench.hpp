@@ -0,0 +1,26 @@
+/**
+ * @file transition_bench.hpp
+ *
+ * Times the level transitions of a hero that is walked through a list of levels.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace devilution {
+
+/**
+ * @brief Loads the last single player hero as soon as the game starts, takes them to each of `levels` in turn
+ * and then ends the game.
+ * @param reportPath Where to write the timings of the transitions as JSON.
+ */
+void InitTransitionBench(std::string_view reportPath, std::vector<uint8_t> levels);
+
+bool IsTransitionBenchRunning();
+
+/** @brief Records the transition that just finished and starts the next one, called after each game tick. */
+void TransitionBenchTick();
+
+} // namespace devilution
@@ -5,7 +5,9 @@
 namespace devilution {
 
 /**
- * @brief Don't load UI or show Messageboxes or other user-interaction. Needed for unit tests.
+ * @brief Don't load UI or show Messageboxes or other user-interaction.
+ *
+ * Needed for unit tests, and set by `--headless` to play back demos without a window, sound or rendering.
  */
 extern DVL_API_FOR_TEST bool HeadlessMode;
 
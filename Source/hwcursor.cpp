@@ -1,7 +1,12 @@
 #include "hwcursor.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <tuple>
+#include <vector>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_error.h>
@@ -36,13 +41,50 @@ namespace {
 CursorInfo CurrentCursorInfo;
 
 #if SDL_VERSION_ATLEAST(2, 0, 0)
-SDLCursorUniquePtr CurrentCursor;
-
 enum class HotpointPosition : uint8_t {
 	TopLeft,
 	Center,
 };
 
+/** @brief A cursor created from an 8-bit surface, kept so that switching back to it doesn't scale and create it again. */
+struct CachedCursor {
+	std::vector<uint8_t> pixels;
+	Size size;
+	Size scaledSize;
+	uint32_t paletteGeneration;
+	HotpointPosition hotpointPosition;
+	uint8_t transparentColor;
+	bool bilinear;
+	SDLCursorUniquePtr cursor;
+};
+
+/** @brief Most recently used first, the first entry is the cursor that is set. */
+std::vector<CachedCursor> CursorCache;
+constexpr size_t CursorCacheSize = 8;
+
+std::array<SDL_Color, 256> CursorCachePalette;
+/** @brief Changes whenever the palette changes, so that cursors rendered with an older palette are never reused. */
+uint32_t CursorCachePaletteGeneration = 0;
+
+void UpdateCursorCachePalette()
+{
+	const SDL_Palette *palette = Palette.get();
+	const size_t size = std::min<size_t>(palette->ncolors, CursorCachePalette.size()) * sizeof(SDL_Color);
+	if (std::memcmp(CursorCachePalette.data(), palette->colors, size) != 0) {
+		std::memcpy(CursorCachePalette.data(), palette->colors, size);
+		CursorCachePaletteGeneration++;
+	}
+}
+
+std::vector<uint8_t> GetSurfacePixels(const SDL_Surface &surface)
+{
+	std::vector<uint8_t> pixels(static_cast<size_t>(surface.w) * surface.h);
+	for (int y = 0; y < surface.h; y++) {
+		std::memcpy(&pixels[static_cast<size_t>(y) * surface.w], static_cast<const uint8_t *>(surface.pixels) + static_cast<ptrdiff_t>(y) * surface.pitch, surface.w);
+	}
+	return pixels;
+}
+
 Size ScaledSize(Size size)
 {
 	if (renderer != nullptr) {
@@ -109,12 +151,48 @@ bool ShouldUseBilinearScaling()
 	return *GetOptions().Graphics.scaleQuality != ScalingQuality::NearestPixel;
 }
 
-bool SetHardwareCursorFromSurface(SDL_Surface *surface, HotpointPosition hotpointPosition)
+bool SetCursor(SDL_Cursor *cursor)
+{
+#ifdef USE_SDL3
+	if (!SDL_SetCursor(cursor)) {
+		LogError("SDL_SetCursor: {}", SDL_GetError());
+		SDL_ClearError();
+		return false;
+	}
+#else
+	SDL_SetCursor(cursor);
+#endif
+	return true;
+}
+
+/**
+ * @param surface An 8-bit surface.
+ * @param transparentColor The color key of the surface.
+ */
+bool SetHardwareCursorFromSurface(SDL_Surface *surface, HotpointPosition hotpointPosition, uint8_t transparentColor)
 {
-	SDLCursorUniquePtr newCursor;
 	const Size size { surface->w, surface->h };
 	const Size scaledSize = ScaledSize(size);
+	const bool bilinear = ShouldUseBilinearScaling();
+	UpdateCursorCachePalette();
+	std::vector<uint8_t> pixels = GetSurfacePixels(*surface);
+
+	const auto cached = std::find_if(CursorCache.begin(), CursorCache.end(), [&](const CachedCursor &entry) {
+		return entry.size == size && entry.scaledSize == scaledSize && entry.paletteGeneration == CursorCachePaletteGeneration
+		    && entry.hotpointPosition == hotpointPosition && entry.transparentColor == transparentColor
+		    && (entry.bilinear == bilinear || size == scaledSize) && entry.pixels == pixels;
+	});
+	if (cached != CursorCache.end()) {
+#if LOG_HWCURSOR
+		Log("hwcursor: SetHardwareCursorFromSurface {}x{} from cache", size.width, size.height);
+#endif
+		if (!SetCursor(cached->cursor.get()))
+			return false;
+		std::rotate(CursorCache.begin(), cached, cached + 1);
+		return true;
+	}
 
+	SDLCursorUniquePtr newCursor;
 	if (size == scaledSize) {
 #if LOG_HWCURSOR
 		Log("hwcursor: SetHardwareCursorFromSurface {}x{}", size.width, size.height);
@@ -132,7 +210,7 @@ bool SetHardwareCursorFromSurface(SDL_Surface *surface, HotpointPosition hotpoin
 		};
 
 		const SDLSurfaceUniquePtr scaledSurface = SDLWrap::CreateRGBSurfaceWithFormat(0, scaledSize.width, scaledSize.height, 32, SDL_PIXELFORMAT_ARGB8888);
-		if (ShouldUseBilinearScaling()) {
+		if (bilinear) {
 #if LOG_HWCURSOR
 			Log("hwcursor: SetHardwareCursorFromSurface {}x{} scaled to {}x{} using bilinear scaling",
 			    size.width, size.height, scaledSize.width, scaledSize.height);
@@ -157,16 +235,12 @@ bool SetHardwareCursorFromSurface(SDL_Surface *surface, HotpointPosition hotpoin
 		SDL_ClearError();
 		return false;
 	}
-#ifdef USE_SDL3
-	if (!SDL_SetCursor(newCursor.get())) {
-		LogError("SDL_SetCursor: {}", SDL_GetError());
-		SDL_ClearError();
+	if (!SetCursor(newCursor.get()))
 		return false;
-	}
-#else
-	SDL_SetCursor(newCursor.get());
-#endif
-	CurrentCursor = std::move(newCursor);
+	// The least recently used cursor is never the one that is set, so it can be freed
+	if (CursorCache.size() == CursorCacheSize)
+		CursorCache.pop_back();
+	CursorCache.insert(CursorCache.begin(), CachedCursor { std::move(pixels), size, scaledSize, CursorCachePaletteGeneration, hotpointPosition, transparentColor, bilinear, std::move(newCursor) });
 	return true;
 }
 
@@ -184,7 +258,7 @@ bool SetHardwareCursorFromClxSprite(ClxSprite sprite, HotpointPosition hotpointP
 		return false;
 	}
 	RenderClxSprite(surface, sprite, { 0, 0 });
-	return SetHardwareCursorFromSurface(surface.surface, hotpointPosition);
+	return SetHardwareCursorFromSurface(surface.surface, hotpointPosition, 0);
 }
 
 bool SetHardwareCursorFromSprite(int pcurs)
@@ -221,7 +295,7 @@ bool SetHardwareCursorFromSprite(int pcurs)
 	DrawSoftwareCursor(out, { outlineWidth, size.height - outlineWidth - 1 }, pcurs);
 
 	const bool result = SetHardwareCursorFromSurface(
-	    out.surface, isItem ? HotpointPosition::Center : HotpointPosition::TopLeft);
+	    out.surface, isItem ? HotpointPosition::Center : HotpointPosition::TopLeft, TransparentColor);
 	return result;
 }
 #endif
@@ -11,6 +11,7 @@
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_events.h>
+#include <SDL3/SDL_init.h>
 #include <SDL3/SDL_video.h>
 #else
 #include <SDL.h>
@@ -19,6 +20,7 @@
 #include <config.h>
 
 #include "DiabloUI/diabloui.h"
+#include "appfat.h"
 #include "engine/assets.hpp"
 #include "engine/backbuffer_state.hpp"
 #include "engine/dx.h"
@@ -26,6 +28,7 @@
 #include "game_mode.hpp"
 #include "headless_mode.hpp"
 #include "hwcursor.hpp"
+#include "interfac.h"
 #include "options.h"
 #include "pfile.h"
 #include "utils/file_util.h"
@@ -38,6 +41,7 @@
 
 #ifndef UNPACKED_MPQS
 #include "mpq/mpq_reader.hpp"
+#include "mpq/mpq_sdl_rwops.hpp"
 #endif
 
 #ifdef __vita__
@@ -120,7 +124,11 @@ void init_cleanup()
 		sfile_write_stash();
 	}
 
+#ifndef UNPACKED_MPQS
+	ShutdownMpqReadAhead();
+#endif
 	MpqArchives.clear();
+	RebuildAssetIndex();
 	HasHellfireMpq = false;
 
 	NetClose();
@@ -137,6 +145,23 @@ void init_create_window()
 #endif
 }
 
+void init_create_headless()
+{
+	if (
+#ifdef USE_SDL3
+	    !SDL_Init(SDL_INIT_EVENTS)
+#elif !defined(USE_SDL1)
+	    SDL_Init(SDL_INIT_EVENTS) < 0
+#else
+	    SDL_Init(0) < 0
+#endif
+	) {
+		ErrSdl();
+	}
+	RegisterCustomEvents();
+	gbActive = true;
+}
+
 void MainWndProc(const SDL_Event &event)
 {
 #ifndef USE_SDL1
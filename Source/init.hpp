@@ -38,6 +38,10 @@ bool AreExtraFontsOutOfDate(MpqArchive &archive);
 
 void init_cleanup();
 void init_create_window();
+/**
+ * @brief Initializes only the SDL subsystems the game loop needs when running without a window, see `HeadlessMode`.
+ */
+void init_create_headless();
 void MainWndProc(const SDL_Event &event);
 
 } // namespace devilution
@@ -39,6 +39,7 @@
 #include "multi.h"
 #include "pfile.h"
 #include "plrmsg.h"
+#include "utils/level_load_timings.hpp"
 #include "utils/log.hpp"
 #include "utils/sdl_compat.h"
 #include "utils/sdl_geometry.h"
@@ -309,8 +310,19 @@ bool HandleProgressBarUpdate()
 	return true;
 }
 
+void SaveLevelBeingLeft()
+{
+	const LevelLoadPhaseTimer timer { LevelLoadPhase::SaveLevel };
+	if (!gbIsMultiplayer) {
+		pfile_save_level();
+	} else {
+		DeltaSaveLevel();
+	}
+}
+
 void DoLoad(interface_mode uMsg)
 {
+	BeginLevelLoadTimings();
 	IncProgress();
 	sound_init();
 	IncProgress();
@@ -335,11 +347,7 @@ void DoLoad(interface_mode uMsg)
 		break;
 	case WM_DIABNEXTLVL:
 		IncProgress();
-		if (!gbIsMultiplayer) {
-			pfile_save_level();
-		} else {
-			DeltaSaveLevel();
-		}
+		SaveLevelBeingLeft();
 		IncProgress();
 		FreeGameMem();
 		setlevel = false;
@@ -351,11 +359,7 @@ void DoLoad(interface_mode uMsg)
 		break;
 	case WM_DIABPREVLVL:
 		IncProgress();
-		if (!gbIsMultiplayer) {
-			pfile_save_level();
-		} else {
-			DeltaSaveLevel();
-		}
+		SaveLevelBeingLeft();
 		IncProgress();
 		FreeGameMem();
 		currlevel--;
@@ -371,11 +375,7 @@ void DoLoad(interface_mode uMsg)
 		ReturnLevelType = GetLevelType(ReturnLevel);
 		ReturnLvlPosition = GetMapReturnPosition();
 		IncProgress();
-		if (!gbIsMultiplayer) {
-			pfile_save_level();
-		} else {
-			DeltaSaveLevel();
-		}
+		SaveLevelBeingLeft();
 		IncProgress();
 		setlevel = true;
 		leveltype = setlvltype;
@@ -387,11 +387,7 @@ void DoLoad(interface_mode uMsg)
 		break;
 	case WM_DIABRTNLVL:
 		IncProgress();
-		if (!gbIsMultiplayer) {
-			pfile_save_level();
-		} else {
-			DeltaSaveLevel();
-		}
+		SaveLevelBeingLeft();
 		IncProgress();
 		setlevel = false;
 		FreeGameMem();
@@ -403,11 +399,7 @@ void DoLoad(interface_mode uMsg)
 		break;
 	case WM_DIABWARPLVL:
 		IncProgress();
-		if (!gbIsMultiplayer) {
-			pfile_save_level();
-		} else {
-			DeltaSaveLevel();
-		}
+		SaveLevelBeingLeft();
 		IncProgress();
 		FreeGameMem();
 		GetPortalLevel();
@@ -417,11 +409,7 @@ void DoLoad(interface_mode uMsg)
 		break;
 	case WM_DIABTOWNWARP:
 		IncProgress();
-		if (!gbIsMultiplayer) {
-			pfile_save_level();
-		} else {
-			DeltaSaveLevel();
-		}
+		SaveLevelBeingLeft();
 		IncProgress();
 		FreeGameMem();
 		setlevel = false;
@@ -433,11 +421,7 @@ void DoLoad(interface_mode uMsg)
 		break;
 	case WM_DIABTWARPUP:
 		IncProgress();
-		if (!gbIsMultiplayer) {
-			pfile_save_level();
-		} else {
-			DeltaSaveLevel();
-		}
+		SaveLevelBeingLeft();
 		IncProgress();
 		FreeGameMem();
 		currlevel = myPlayer.plrlevel;
@@ -448,11 +432,7 @@ void DoLoad(interface_mode uMsg)
 		break;
 	case WM_DIABRETOWN:
 		IncProgress();
-		if (!gbIsMultiplayer) {
-			pfile_save_level();
-		} else {
-			DeltaSaveLevel();
-		}
+		SaveLevelBeingLeft();
 		IncProgress();
 		FreeGameMem();
 		setlevel = false;
@@ -480,6 +460,7 @@ void DoLoad(interface_mode uMsg)
 #endif
 		return;
 	}
+	EndLevelLoadTimings();
 
 	SDL_Event event;
 	CustomEventToSdlEvent(event, WM_DONE);
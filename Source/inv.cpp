@@ -650,32 +650,46 @@ std::optional<inv_xy_slot> FindSlotUnderCursor(Point cursorPosition)
 }
 
 /**
- * @brief Checks whether an item of the given size can be placed on the specified player's inventory slot.
+ * @brief Builds a mask of the occupied cells of the player's inventory grid, bit (10 * y) + x stands for the cell in column x and row y.
  * @param player The player whose inventory will be checked.
- * @param slotIndex The 0-based index of the slot to put the item on.
- * @param itemSize The size of the item to be checked.
  * @param itemIndexToIgnore can be used to check if an item of the given size would fit if the item with the given (positive) ID was removed.
- * @return 'True' in case the item can be placed on the specified player's inventory slot and 'False' otherwise.
  */
-bool CheckItemFitsInInventorySlot(const Player &player, int slotIndex, const Size &itemSize, int itemIndexToIgnore)
+uint64_t GetInventoryOccupancyMask(const Player &player, int itemIndexToIgnore)
 {
-	int yy = (slotIndex > 0) ? (10 * (slotIndex / 10)) : 0;
-
-	for (int j = 0; j < itemSize.height; j++) {
-		if (yy >= InventoryGridCells) {
-			return false;
-		}
-		int xx = (slotIndex > 0) ? (slotIndex % 10) : 0;
-		for (int i = 0; i < itemSize.width; i++) {
-			if (xx >= 10 || (player.InvGrid[xx + yy] != 0 && std::abs(player.InvGrid[xx + yy]) - 1 != itemIndexToIgnore)) {
-				// The item is too wide to fit in the specified column, or one of the cells is occupied (and not by the item we're planning on removing)
-				return false;
-			}
-			xx++;
-		}
-		yy += 10;
+	uint64_t occupied = 0;
+	for (int i = 0; i < InventoryGridCells; i++) {
+		if (player.InvGrid[i] != 0 && std::abs(player.InvGrid[i]) - 1 != itemIndexToIgnore)
+			occupied |= uint64_t { 1 } << i;
 	}
-	return true;
+	return occupied;
+}
+
+/**
+ * @brief Builds the mask of the cells an item of the given size covers when placed on the first inventory slot.
+ */
+uint64_t GetItemShapeMask(const Size &itemSize)
+{
+	const uint64_t row = (uint64_t { 1 } << itemSize.width) - 1;
+	uint64_t shape = 0;
+	for (int j = 0; j < itemSize.height; j++)
+		shape |= row << (10 * j);
+	return shape;
+}
+
+/**
+ * @brief Checks whether an item of the given size can be placed on the specified inventory slot.
+ * @param occupied The occupied cells of the inventory, see GetInventoryOccupancyMask.
+ * @param slotIndex The 0-based index of the slot to put the item on.
+ * @param itemSize The size of the item to be checked.
+ * @param shape The cells covered by the item, see GetItemShapeMask.
+ * @return 'True' in case the item can be placed on the specified inventory slot and 'False' otherwise.
+ */
+bool CheckItemFitsInInventorySlot(uint64_t occupied, int slotIndex, const Size &itemSize, uint64_t shape)
+{
+	// The item is too wide to fit in the specified column or too tall for the specified row
+	if (slotIndex % 10 + itemSize.width > 10 || slotIndex / 10 + itemSize.height > InventoryGridCells / 10)
+		return false;
+	return (occupied & (shape << slotIndex)) == 0;
 }
 
 /**
@@ -687,14 +701,18 @@ bool CheckItemFitsInInventorySlot(const Player &player, int slotIndex, const Siz
  */
 std::optional<int> FindSlotForItem(const Player &player, const Size &itemSize, int itemIndexToIgnore = -1)
 {
+	const uint64_t occupied = GetInventoryOccupancyMask(player, itemIndexToIgnore);
+	const uint64_t shape = GetItemShapeMask(itemSize);
+	const auto fits = [&](int slotIndex) { return CheckItemFitsInInventorySlot(occupied, slotIndex, itemSize, shape); };
+
 	if (itemSize.height == 1) {
 		for (int i = 30; i <= 39; i++) {
-			if (CheckItemFitsInInventorySlot(player, i, itemSize, itemIndexToIgnore))
+			if (fits(i))
 				return i;
 		}
 		for (int x = 9; x >= 0; x--) {
 			for (int y = 2; y >= 0; y--) {
-				if (CheckItemFitsInInventorySlot(player, (10 * y) + x, itemSize, itemIndexToIgnore))
+				if (fits((10 * y) + x))
 					return (10 * y) + x;
 			}
 		}
@@ -704,7 +722,7 @@ std::optional<int> FindSlotForItem(const Player &player, const Size &itemSize, i
 	if (itemSize.height == 2) {
 		for (int x = 10 - itemSize.width; x >= 0; x--) {
 			for (int y = 0; y < 3; y++) {
-				if (CheckItemFitsInInventorySlot(player, (10 * y) + x, itemSize, itemIndexToIgnore))
+				if (fits((10 * y) + x))
 					return (10 * y) + x;
 			}
 		}
@@ -713,7 +731,7 @@ std::optional<int> FindSlotForItem(const Player &player, const Size &itemSize, i
 
 	if (itemSize == Size { 1, 3 }) {
 		for (int i = 0; i < 20; i++) {
-			if (CheckItemFitsInInventorySlot(player, i, itemSize, itemIndexToIgnore))
+			if (fits(i))
 				return i;
 		}
 		return {};
@@ -721,12 +739,12 @@ std::optional<int> FindSlotForItem(const Player &player, const Size &itemSize, i
 
 	if (itemSize == Size { 2, 3 }) {
 		for (int i = 0; i < 9; i++) {
-			if (CheckItemFitsInInventorySlot(player, i, itemSize, itemIndexToIgnore))
+			if (fits(i))
 				return i;
 		}
 
 		for (int i = 10; i < 19; i++) {
-			if (CheckItemFitsInInventorySlot(player, i, itemSize, itemIndexToIgnore))
+			if (fits(i))
 				return i;
 		}
 		return {};
@@ -1559,15 +1577,11 @@ void CheckInvSwap(Player &player, inv_body_loc bLoc)
 	} else if (bLoc == INVLOC_HAND_RIGHT && player.GetItemLocation(item) == ILOC_TWOHAND) {
 		player.InvBody[INVLOC_HAND_LEFT].clear();
 	}
-
-	CalcPlrInv(player, true);
 }
 
 void inv_update_rem_item(Player &player, inv_body_loc iv)
 {
 	player.InvBody[iv].clear();
-
-	CalcPlrInv(player, player._pmode != PM_DEATH);
 }
 
 void CheckInvSwap(Player &player, const Item &item, int invGridIndex)
@@ -1609,7 +1623,9 @@ void CheckInvSwap(Player &player, const Item &item, int invGridIndex)
 		}
 	}
 
-	CalcPlrInv(player, true);
+	// Only the equipped items count towards the stats of other players, their backpack only matters to themselves
+	if (&player == MyPlayer)
+		CalcPlrInv(player, true);
 }
 
 void CheckInvRemove(Player &player, int invGridIndex)
@@ -187,7 +187,13 @@ int RoomForGold();
  */
 int AddGoldToInventory(Player &player, int value);
 bool GoldAutoPlace(Player &player, Item &goldStack);
+/**
+ * @brief Equips a remote player's item that was received over the network, the caller recalculates the player's stats.
+ */
 void CheckInvSwap(Player &player, inv_body_loc bLoc);
+/**
+ * @brief Unequips a remote player's item, the caller recalculates the player's stats.
+ */
 void inv_update_rem_item(Player &player, inv_body_loc iv);
 void CheckInvSwap(Player &player, const Item &item, int invGridIndex);
 void CheckInvRemove(Player &player, int invGridIndex);
@@ -13,6 +13,7 @@
 #include <cstdint>
 #include <cstring>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -25,6 +26,7 @@
 #include <SDL.h>
 #endif
 
+#include <ankerl/unordered_dense.h>
 #include <fmt/core.h>
 
 #include "DiabloUI/ui_flags.hpp"
@@ -69,6 +71,7 @@
 #include "panels/ui_panels.hpp"
 #include "player.h"
 #include "qol/stash.h"
+#include "qol/visual_store.h"
 #include "quests.h"
 #include "sound_effect_enums.h"
 #include "spells.h"
@@ -86,7 +89,6 @@
 #include "utils/log.hpp"
 #include "utils/math.h"
 #include "utils/sdl_geometry.h"
-#include "utils/static_vector.hpp"
 #include "utils/str_cat.hpp"
 #include "utils/str_split.hpp"
 #include "utils/string_or_view.hpp"
@@ -191,14 +193,23 @@ enum class PlayerArmorGraphic : uint8_t {
 
 Item curruitem;
 
-/** Holds item get records, tracking items being recently looted. This is in an effort to prevent items being picked up more than once. */
+/**
+ * Holds item get records, tracking items being recently looted. This is in an effort to prevent items being picked up more than once.
+ * The records are a ring in the order they were added, so the ones that expire first are at the front.
+ */
 ItemGetRecordStruct itemrecord[MAXITEMS];
 
 bool itemhold[3][3];
 
+/** Index in `itemrecord` of the oldest item get record. */
+int firstItemRecord;
+
 /** Specifies the number of active item get records. */
 int gnNumGetRecords;
 
+/** Item get records are kept for 6 seconds. */
+constexpr uint32_t ItemRecordLifetimeMs = 6000;
+
 int OilLevels[] = { 1, 10, 1, 10, 4, 1, 5, 17, 1, 10 };
 int OilValues[] = { 500, 2500, 500, 2500, 1500, 100, 2500, 15000, 500, 2500 };
 item_misc_id OilMagic[] = {
@@ -1068,29 +1079,38 @@ std::optional<const PLStruct *> SelectAffix(
     goodorevil goe,
     bool excludeChargesForStaffs)
 {
-	StaticVector<const PLStruct *, 256> eligibleAffixes;
-
-	for (const PLStruct &affix : affixList) {
-		if (!HasAnyOf(type, affix.PLIType))
-			continue;
+	const auto isEligible = [&](const PLStruct &affix) {
 		if (affix.PLMinLvl < minlvl || affix.PLMinLvl > maxlvl)
-			continue;
+			return false;
 		if (onlygood && !affix.PLOk)
-			continue;
+			return false;
 		if ((goe == GOE_GOOD && affix.PLGOE == GOE_EVIL) || (goe == GOE_EVIL && affix.PLGOE == GOE_GOOD))
-			continue;
+			return false;
 		if (excludeChargesForStaffs && type == AffixItemType::Staff && affix.power.type == IPL_CHARGES)
-			continue;
+			return false;
+		return true;
+	};
 
-		for (int i = 0; i < affix.PLChance; ++i) {
-			eligibleAffixes.push_back(&affix);
-		}
+	// Each affix is as likely as if it was in a list PLChance times, in table order
+	const std::span<const PLStruct *const> candidates = GetAffixesForItemType(affixList, type);
+	int totalChance = 0;
+	for (const PLStruct *affix : candidates) {
+		if (isEligible(*affix))
+			totalChance += affix->PLChance;
 	}
 
-	if (eligibleAffixes.empty())
+	if (totalChance == 0)
 		return std::nullopt;
 
-	return eligibleAffixes[GenerateRnd(static_cast<int>(eligibleAffixes.size()))];
+	int pick = GenerateRnd(totalChance);
+	for (const PLStruct *affix : candidates) {
+		if (!isEligible(*affix))
+			continue;
+		if (pick < affix->PLChance)
+			return affix;
+		pick -= affix->PLChance;
+	}
+	return std::nullopt;
 }
 
 std::optional<const PLStruct *> GetStaffPrefix(int maxlvl, bool onlygood)
@@ -1350,9 +1370,37 @@ struct WeightedItemIndex {
 	unsigned cumulativeWeight;
 };
 
-_item_indexes GetItemIndexForDroppableItem(bool considerDropRate, tl::function_ref<bool(const ItemData &item)> isItemOkay)
+/** @brief The drops whose filter only depends on a few numbers, see `DropTableKey`. */
+enum class DropTableKind : uint8_t {
+	UniqueItem,
+	AllItems,
+	TypeItems,
+	UniqueBaseItem,
+	MonsterLevel,
+};
+
+/**
+ * @brief Tables of the items that a drop picks from, built the first time a drop with the same key happens.
+ *
+ * Cleared by `InvalidateDropTables` whenever items are added to `AllItemsList`.
+ */
+ankerl::unordered_dense::map<uint64_t, std::vector<WeightedItemIndex>> DropTables;
+
+/**
+ * @brief Identifies a drop table by the filter, its parameters and the game mode settings that `IsItemAvailable` depends on.
+ */
+uint64_t DropTableKey(DropTableKind kind, int param1, int param2 = 0, int param3 = 0)
+{
+	uint64_t key = static_cast<uint8_t>(kind);
+	key = (key << 4) | (gbIsSpawn ? 1 : 0) | (gbIsHellfire ? 2 : 0) | (gbIsMultiplayer ? 4 : 0) | (*GetOptions().Gameplay.testBard ? 8 : 0);
+	key = (key << 16) | static_cast<uint16_t>(param1);
+	key = (key << 8) | static_cast<uint8_t>(param2);
+	key = (key << 16) | static_cast<uint16_t>(param3);
+	return key;
+}
+
+void BuildDropTable(std::vector<WeightedItemIndex> &ril, bool considerDropRate, tl::function_ref<bool(const ItemData &item)> isItemOkay)
 {
-	static std::vector<WeightedItemIndex> ril;
 	ril.clear();
 
 	unsigned cumulativeWeight = 0;
@@ -1369,16 +1417,42 @@ _item_indexes GetItemIndexForDroppableItem(bool considerDropRate, tl::function_r
 		cumulativeWeight += considerDropRate ? item.dropRate : 1;
 		ril.push_back({ static_cast<_item_indexes>(i), cumulativeWeight });
 	}
+}
+
+_item_indexes PickDroppableItem(const std::vector<WeightedItemIndex> &ril)
+{
+	const unsigned cumulativeWeight = ril.empty() ? 0 : ril.back().cumulativeWeight;
 	const auto targetWeight = static_cast<unsigned>(RandomIntLessThan(static_cast<int>(cumulativeWeight)));
 	return std::upper_bound(ril.begin(), ril.end(), targetWeight, [](unsigned target, const WeightedItemIndex &value) { return target < value.cumulativeWeight; })->index;
 }
 
+/**
+ * @brief Picks a drop from the items that pass the filter, for filters that can't be described by a table key.
+ */
+_item_indexes GetItemIndexForDroppableItem(bool considerDropRate, tl::function_ref<bool(const ItemData &item)> isItemOkay)
+{
+	static std::vector<WeightedItemIndex> ril;
+	BuildDropTable(ril, considerDropRate, isItemOkay);
+	return PickDroppableItem(ril);
+}
+
+/**
+ * @brief Picks a drop like the uncached overload, `isItemOkay` is only called when the table for `tableKey` is built.
+ */
+_item_indexes GetItemIndexForDroppableItem(uint64_t tableKey, bool considerDropRate, tl::function_ref<bool(const ItemData &item)> isItemOkay)
+{
+	const auto [it, inserted] = DropTables.try_emplace(tableKey);
+	if (inserted)
+		BuildDropTable(it->second, considerDropRate, isItemOkay);
+	return PickDroppableItem(it->second);
+}
+
 _item_indexes RndUItem(Monster *monster)
 {
 	int itemMaxLevel = ItemsGetCurrlevel() * 2;
 	if (monster != nullptr)
 		itemMaxLevel = monster->level(sgGameInitInfo.nDifficulty);
-	return GetItemIndexForDroppableItem(false, [&itemMaxLevel](const ItemData &item) {
+	return GetItemIndexForDroppableItem(DropTableKey(DropTableKind::UniqueItem, itemMaxLevel), false, [&itemMaxLevel](const ItemData &item) {
 		if (item.itype == ItemType::Misc && item.iMiscId == IMISC_BOOK)
 			return true;
 		if (itemMaxLevel < item.iMinMLvl)
@@ -1395,7 +1469,7 @@ _item_indexes RndAllItems()
 		return IDI_GOLD;
 
 	int itemMaxLevel = ItemsGetCurrlevel() * 2;
-	return GetItemIndexForDroppableItem(false, [&itemMaxLevel](const ItemData &item) {
+	return GetItemIndexForDroppableItem(DropTableKey(DropTableKind::AllItems, itemMaxLevel), false, [&itemMaxLevel](const ItemData &item) {
 		return itemMaxLevel >= item.iMinMLvl;
 	});
 }
@@ -1403,7 +1477,7 @@ _item_indexes RndAllItems()
 _item_indexes RndTypeItems(ItemType itemType, int imid, int lvl)
 {
 	int itemMaxLevel = lvl * 2;
-	return GetItemIndexForDroppableItem(false, [&itemMaxLevel, &itemType, &imid](const ItemData &item) {
+	return GetItemIndexForDroppableItem(DropTableKey(DropTableKind::TypeItems, itemMaxLevel, static_cast<int>(itemType), imid), false, [&itemMaxLevel, &itemType, &imid](const ItemData &item) {
 		if (itemMaxLevel < item.iMinMLvl)
 			return false;
 		if (item.itype != itemType)
@@ -1414,17 +1488,9 @@ _item_indexes RndTypeItems(ItemType itemType, int imid, int lvl)
 	});
 }
 
-std::vector<uint8_t> GetValidUniques(int lvl, unique_base_item baseItemId)
+bool IsValidUnique(int32_t uid, int lvl)
 {
-	std::vector<uint8_t> validUniques;
-	int index = 0;
-	for (const UniqueItem &itemData : UniqueItems) {
-		if (itemData.UIItemId == baseItemId && lvl >= itemData.UIMinLvl) {
-			validUniques.push_back(index);
-		}
-		index++;
-	}
-	return validUniques;
+	return lvl >= UniqueItems[uid].UIMinLvl;
 }
 
 _unique_items CheckUnique(Item &item, int lvl, int uper, int uidOffset = 0)
@@ -1432,21 +1498,26 @@ _unique_items CheckUnique(Item &item, int lvl, int uper, int uidOffset = 0)
 	if (GenerateRnd(100) > uper)
 		return UITEM_INVALID;
 
-	auto validUniques = GetValidUniques(lvl, AllItemsList[item.IDidx].iItemId);
+	const std::span<const int32_t> uniques = GetUniqueItemsOfBase(AllItemsList[item.IDidx].iItemId);
+	const auto numValidUniques = static_cast<size_t>(std::count_if(uniques.begin(), uniques.end(), [lvl](int32_t uid) { return IsValidUnique(uid, lvl); }));
 
-	if (validUniques.empty())
+	if (numValidUniques == 0)
 		return UITEM_INVALID;
 
 	DiscardRandomValues(1);
 
 	// Check if uidOffset is out of bounds
-	if (static_cast<size_t>(uidOffset) >= validUniques.size()) {
+	if (static_cast<size_t>(uidOffset) >= numValidUniques) {
 		return UITEM_INVALID;
 	}
 
-	const uint8_t selectedUniqueIndex = validUniques[validUniques.size() - 1 - uidOffset];
-
-	return static_cast<_unique_items>(selectedUniqueIndex);
+	// The offset counts the valid uniques from the last one
+	int remaining = uidOffset;
+	for (auto it = uniques.rbegin(); it != uniques.rend(); ++it) {
+		if (IsValidUnique(*it, lvl) && remaining-- == 0)
+			return static_cast<_unique_items>(*it);
+	}
+	return UITEM_INVALID;
 }
 
 void GetUniqueItem(const Player &player, Item &item, _unique_items uid)
@@ -2194,18 +2265,28 @@ void CreateMagicItem(Point position, int lvl, ItemType itemType, int imid, int i
 		NetSendCmdPItem(false, CMD_SPAWNITEM, item.position, item);
 }
 
-void NextItemRecord(int i)
+/** @param i The age rank of the record, 0 is the oldest. */
+ItemGetRecordStruct &GetItemRecordAt(int i)
 {
-	gnNumGetRecords--;
+	return itemrecord[(firstItemRecord + i) % MAXITEMS];
+}
 
-	if (gnNumGetRecords == 0) {
-		return;
+void ExpireItemRecords(uint32_t ticks)
+{
+	while (gnNumGetRecords > 0 && ticks - itemrecord[firstItemRecord].dwTimestamp > ItemRecordLifetimeMs) {
+		firstItemRecord = (firstItemRecord + 1) % MAXITEMS;
+		gnNumGetRecords--;
 	}
+}
 
-	itemrecord[i].dwTimestamp = itemrecord[gnNumGetRecords].dwTimestamp;
-	itemrecord[i].nSeed = itemrecord[gnNumGetRecords].nSeed;
-	itemrecord[i].wCI = itemrecord[gnNumGetRecords].wCI;
-	itemrecord[i].nIndex = itemrecord[gnNumGetRecords].nIndex;
+int FindItemRecord(uint32_t nSeed, uint16_t wCI, int nIndex)
+{
+	for (int i = 0; i < gnNumGetRecords; i++) {
+		const ItemGetRecordStruct &record = GetItemRecordAt(i);
+		if (nSeed == record.nSeed && wCI == record.wCI && nIndex == record.nIndex)
+			return i;
+	}
+	return -1;
 }
 
 StringOrView GetTranslatedItemName(const Item &item)
@@ -2400,6 +2481,11 @@ bool IsItemAvailable(int i)
 	        *GetOptions().Gameplay.testBard && IsAnyOf(i, IDI_BARDSWORD, IDI_BARDDAGGER));
 }
 
+void InvalidateDropTables()
+{
+	DropTables.clear();
+}
+
 uint8_t GetOutlineColor(const Item &item, bool checkReq)
 {
 	if (checkReq && !item._iStatFlag)
@@ -2923,6 +3009,8 @@ void CalcPlrInv(Player &player, bool loadgfx)
 			// If stash is open, ensure the items are displayed correctly
 			Stash.RefreshItemStatFlags();
 		}
+		if (IsVisualStoreOpen)
+			RefreshVisualStoreItemStatFlags();
 		if (!player.HoldItem.isEmpty())
 			player.HoldItem.updateRequiredStatsCacheForPlayer(player);
 	}
@@ -3219,7 +3307,7 @@ Item *SpawnUnique(_unique_items uid, Point position, std::optional<int> level /*
 		if (level)
 			curlv = *level;
 		const ItemData &uniqueItemData = AllItemsList[idx];
-		const _item_indexes dropIdx = GetItemIndexForDroppableItem(false, [&uniqueItemData](const ItemData &item) {
+		const _item_indexes dropIdx = GetItemIndexForDroppableItem(DropTableKey(DropTableKind::UniqueBaseItem, static_cast<int>(uniqueItemData.itype)), false, [&uniqueItemData](const ItemData &item) {
 			return item.itype == uniqueItemData.itype;
 		});
 		SetupAllItems(*MyPlayer, item, dropIdx, AdvanceRndSeed(), curlv * 2, 15, true, false);
@@ -3261,7 +3349,7 @@ _item_indexes RndItemForMonsterLevel(int8_t monsterLevel)
 	if (GenerateRnd(100) > 25)
 		return IDI_GOLD;
 
-	return GetItemIndexForDroppableItem(true, [&monsterLevel](const ItemData &item) {
+	return GetItemIndexForDroppableItem(DropTableKey(DropTableKind::MonsterLevel, monsterLevel), true, [&monsterLevel](const ItemData &item) {
 		return item.iMinMLvl <= monsterLevel;
 	});
 }
@@ -3325,10 +3413,10 @@ void TryRandomUniqueItem(Item &item, _item_indexes idx, int8_t mLevel, int uper,
 	const int blvl = GetItemBLevel(mLevel, item._iMiscId, onlygood, uper == 15);
 
 	// Gather all potential unique items. uid is the index into UniqueItems.
-	auto validUniques = GetValidUniques(blvl, AllItemsList[static_cast<size_t>(idx)].iItemId);
-	assert(!validUniques.empty());
 	std::vector<int> uids;
-	for (auto &possibleUid : validUniques) {
+	for (const int32_t possibleUid : GetUniqueItemsOfBase(AllItemsList[static_cast<size_t>(idx)].iItemId)) {
+		if (!IsValidUnique(possibleUid, blvl))
+			continue;
 		// Verify item hasn't been dropped yet. We set this to true in MP, since uniques previously dropping shouldn't prevent further identical uniques from dropping.
 		if (!UniqueItemFlags[possibleUid] || gbIsMultiplayer) {
 			uids.emplace_back(possibleUid);
@@ -4307,6 +4395,8 @@ void UseItem(Player &player, item_misc_id mid, SpellID spellID, int spellFrom)
 			if (IsStashOpen) {
 				Stash.RefreshItemStatFlags();
 			}
+			if (IsVisualStoreOpen)
+				RefreshVisualStoreItemStatFlags();
 		}
 		RedrawComponent(PanelDrawComponent::Mana);
 	} break;
@@ -4752,49 +4842,39 @@ void CreateMagicWeapon(Point position, ItemType itemType, int icurs, bool sendms
 
 bool GetItemRecord(uint32_t nSeed, uint16_t wCI, int nIndex)
 {
-	const uint32_t ticks = SDL_GetTicks();
-
-	for (int i = 0; i < gnNumGetRecords; i++) {
-		if (ticks - itemrecord[i].dwTimestamp > 6000) {
-			// BUGFIX: loot actions for multiple quest items with same seed (e.g. blood stone) performed within less than 6 seconds will be ignored.
-			NextItemRecord(i);
-			i--;
-		} else if (nSeed == itemrecord[i].nSeed && wCI == itemrecord[i].wCI && nIndex == itemrecord[i].nIndex) {
-			return false;
-		}
-	}
-
-	return true;
+	// BUGFIX: loot actions for multiple quest items with same seed (e.g. blood stone) performed within less than 6 seconds will be ignored.
+	ExpireItemRecords(SDL_GetTicks());
+	return FindItemRecord(nSeed, wCI, nIndex) == -1;
 }
 
 void SetItemRecord(uint32_t nSeed, uint16_t wCI, int nIndex)
 {
 	const uint32_t ticks = SDL_GetTicks();
+	ExpireItemRecords(ticks);
 
 	if (gnNumGetRecords == MAXITEMS) {
 		return;
 	}
 
-	itemrecord[gnNumGetRecords].dwTimestamp = ticks;
-	itemrecord[gnNumGetRecords].nSeed = nSeed;
-	itemrecord[gnNumGetRecords].wCI = wCI;
-	itemrecord[gnNumGetRecords].nIndex = nIndex;
+	ItemGetRecordStruct &record = GetItemRecordAt(gnNumGetRecords);
+	record.dwTimestamp = ticks;
+	record.nSeed = nSeed;
+	record.wCI = wCI;
+	record.nIndex = nIndex;
 	gnNumGetRecords++;
 }
 
 void PutItemRecord(uint32_t nSeed, uint16_t wCI, int nIndex)
 {
-	const uint32_t ticks = SDL_GetTicks();
+	ExpireItemRecords(SDL_GetTicks());
 
-	for (int i = 0; i < gnNumGetRecords; i++) {
-		if (ticks - itemrecord[i].dwTimestamp > 6000) {
-			NextItemRecord(i);
-			i--;
-		} else if (nSeed == itemrecord[i].nSeed && wCI == itemrecord[i].wCI && nIndex == itemrecord[i].nIndex) {
-			NextItemRecord(i);
-			break;
-		}
-	}
+	const int i = FindItemRecord(nSeed, wCI, nIndex);
+	if (i == -1)
+		return;
+	// Keeps the records in the order they expire in
+	for (int j = i; j < gnNumGetRecords - 1; j++)
+		GetItemRecordAt(j) = GetItemRecordAt(j + 1);
+	gnNumGetRecords--;
 }
 
 bool Item::isUsable() const
@@ -4864,6 +4944,7 @@ bool CornerStoneStruct::isAvailable()
 void initItemGetRecords()
 {
 	memset(itemrecord, 0, sizeof(itemrecord));
+	firstItemRecord = 0;
 	gnNumGetRecords = 0;
 }
 
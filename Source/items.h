@@ -494,6 +494,10 @@ extern DVL_API_FOR_TEST bool UniqueItemFlags[128];
 
 uint8_t GetOutlineColor(const Item &item, bool checkReq);
 bool IsItemAvailable(int i);
+/**
+ * @brief Forgets the precomputed drop tables, must be called whenever `AllItemsList` changes.
+ */
+void InvalidateDropTables();
 void ClearUniqueItemFlags();
 void InitItemGFX();
 void InitItems();
@@ -6,6 +6,7 @@
 
 #include "items/validation.h"
 
+#include <array>
 #include <cstdint>
 
 #include "items.h"
@@ -25,6 +26,91 @@ bool hasMultipleFlags(uint16_t flags)
 	return (flags & (flags - 1)) > 0;
 }
 
+bool IsUniqueMonsterItemLevel(uint8_t level)
+{
+	// Check all unique monster levels to see if they match the item level
+	for (const UniqueMonsterData &uniqueMonsterData : UniqueMonstersData) {
+		if (IsAnyOf(uniqueMonsterData.mtype, MT_DEFILER, MT_NAKRUL, MT_HORKDMN)) {
+			// These monsters don't use their mlvl for item generation
+			continue;
+		}
+
+		const auto &uniqueMonsterLevel = static_cast<uint8_t>(MonstersData[uniqueMonsterData.mtype].level);
+
+		if (level == uniqueMonsterLevel) {
+			// If the ilvl matches the mlvl, we confirm the item is legitimate
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool IsDungeonItemLevel(uint8_t level, bool isHellfireItem)
+{
+	// Check all monster levels to see if they match the item level
+	int type = -1;
+	for (const MonsterData &monsterData : MonstersData) {
+		type++;
+		auto monsterLevel = static_cast<uint8_t>(monsterData.level);
+
+		if (type != MT_DIABLO && monsterData.availability == MonsterAvailability::Never) {
+			// Skip monsters that are unable to appear in the game
+			continue;
+		}
+
+		if (type == MT_DIABLO && isHellfireItem) {
+			// Adjust The Dark Lord's mlvl if the item is a Hellfire item to match the Diablo mlvl
+			monsterLevel += 15;
+		}
+
+		if (level == monsterLevel) {
+			// If the ilvl matches the mlvl, we confirm the item is legitimate
+			return true;
+		}
+	}
+
+	if (isHellfireItem) {
+		uint8_t hellfireMaxDungeonLevel = 24;
+
+		// Hellfire adjusts the currlevel minus 7 in dungeon levels 20-24 for generating items
+		hellfireMaxDungeonLevel -= 7;
+		return level <= (hellfireMaxDungeonLevel * 2);
+	}
+
+	uint8_t diabloMaxDungeonLevel = 16;
+
+	// Diablo doesn't have containers that drop items in dungeon level 16, therefore we decrement by 1
+	diabloMaxDungeonLevel--;
+	return level <= (diabloMaxDungeonLevel * 2);
+}
+
+/**
+ * @brief Which item levels monsters drop items of, worked out once per monster data rather than for each item,
+ * as a hero joining a game has all of their items validated.
+ */
+struct ItemLevelTable {
+	uint32_t monsterDataGeneration = 0;
+	std::array<bool, CF_LEVEL + 1> uniqueMonster;
+	std::array<bool, CF_LEVEL + 1> dungeon;
+	std::array<bool, CF_LEVEL + 1> hellfireDungeon;
+};
+
+const ItemLevelTable &GetItemLevelTable()
+{
+	static ItemLevelTable table;
+	const uint32_t generation = GetMonsterDataGeneration();
+	if (table.monsterDataGeneration == generation)
+		return table;
+	for (uint8_t level = 0; level <= CF_LEVEL; level++) {
+		table.uniqueMonster[level] = IsUniqueMonsterItemLevel(level);
+		table.dungeon[level] = IsDungeonItemLevel(level, false);
+		table.hellfireDungeon[level] = IsDungeonItemLevel(level, true);
+	}
+	table.monsterDataGeneration = generation;
+	return table;
+}
+
 } // namespace
 
 bool IsCreationFlagComboValid(uint16_t iCreateInfo)
@@ -77,66 +163,14 @@ bool IsShopPriceValid(const Item &item)
 
 bool IsUniqueMonsterItemValid(uint16_t iCreateInfo, uint32_t /*dwBuff*/)
 {
-	const uint8_t level = iCreateInfo & CF_LEVEL;
-
-	// Check all unique monster levels to see if they match the item level
-	for (const UniqueMonsterData &uniqueMonsterData : UniqueMonstersData) {
-		if (IsAnyOf(uniqueMonsterData.mtype, MT_DEFILER, MT_NAKRUL, MT_HORKDMN)) {
-			// These monsters don't use their mlvl for item generation
-			continue;
-		}
-
-		const auto &uniqueMonsterLevel = static_cast<uint8_t>(MonstersData[uniqueMonsterData.mtype].level);
-
-		if (level == uniqueMonsterLevel) {
-			// If the ilvl matches the mlvl, we confirm the item is legitimate
-			return true;
-		}
-	}
-
-	return false;
+	return GetItemLevelTable().uniqueMonster[iCreateInfo & CF_LEVEL];
 }
 
 bool IsDungeonItemValid(uint16_t iCreateInfo, uint32_t dwBuff)
 {
-	const uint8_t level = iCreateInfo & CF_LEVEL;
+	const ItemLevelTable &table = GetItemLevelTable();
 	const bool isHellfireItem = (dwBuff & CF_HELLFIRE) != 0;
-
-	// Check all monster levels to see if they match the item level
-	int type = -1;
-	for (const MonsterData &monsterData : MonstersData) {
-		type++;
-		auto monsterLevel = static_cast<uint8_t>(monsterData.level);
-
-		if (type != MT_DIABLO && monsterData.availability == MonsterAvailability::Never) {
-			// Skip monsters that are unable to appear in the game
-			continue;
-		}
-
-		if (type == MT_DIABLO && isHellfireItem) {
-			// Adjust The Dark Lord's mlvl if the item is a Hellfire item to match the Diablo mlvl
-			monsterLevel += 15;
-		}
-
-		if (level == monsterLevel) {
-			// If the ilvl matches the mlvl, we confirm the item is legitimate
-			return true;
-		}
-	}
-
-	if (isHellfireItem) {
-		uint8_t hellfireMaxDungeonLevel = 24;
-
-		// Hellfire adjusts the currlevel minus 7 in dungeon levels 20-24 for generating items
-		hellfireMaxDungeonLevel -= 7;
-		return level <= (hellfireMaxDungeonLevel * 2);
-	}
-
-	uint8_t diabloMaxDungeonLevel = 16;
-
-	// Diablo doesn't have containers that drop items in dungeon level 16, therefore we decrement by 1
-	diabloMaxDungeonLevel--;
-	return level <= (diabloMaxDungeonLevel * 2);
+	return (isHellfireItem ? table.hellfireDungeon : table.dungeon)[iCreateInfo & CF_LEVEL];
 }
 
 bool IsHellfireSpellBookValid(const Item &spellBook)
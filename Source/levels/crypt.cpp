@@ -687,22 +687,22 @@ void SetCryptRoom()
 	IsUberRoomOpened = false;
 	IsUberLeverActivated = false;
 
-	auto dunData = LoadFileInMem<uint16_t>("nlevels\\l5data\\uberroom.dun");
+	const uint16_t *dunData = LoadFileInArena<uint16_t>("nlevels\\l5data\\uberroom.dun", LevelArena);
 
-	SetPiece = { position, GetDunSize(dunData.get()) };
+	SetPiece = { position, GetDunSize(dunData) };
 
-	PlaceDunTiles(dunData.get(), position, 0);
+	PlaceDunTiles(dunData, position, 0);
 }
 
 void SetCornerRoom()
 {
 	const Point position = SelectChamber();
 
-	auto dunData = LoadFileInMem<uint16_t>("nlevels\\l5data\\cornerstone.dun");
+	const uint16_t *dunData = LoadFileInArena<uint16_t>("nlevels\\l5data\\cornerstone.dun", LevelArena);
 
-	SetPiece = { position, GetDunSize(dunData.get()) };
+	SetPiece = { position, GetDunSize(dunData) };
 
-	PlaceDunTiles(dunData.get(), position, 0);
+	PlaceDunTiles(dunData, position, 0);
 }
 
 void FixCryptDirtTiles()
@@ -380,20 +380,20 @@ void FillFloor()
 
 void InitSetPiece()
 {
-	std::unique_ptr<uint16_t[]> setPieceData;
+	const uint16_t *setPieceData = nullptr;
 	if (Quests[Q_BUTCHER].IsAvailable()) {
-		setPieceData = LoadFileInMem<uint16_t>("levels\\l1data\\rnd6.dun");
+		setPieceData = LoadFileInArena<uint16_t>("levels\\l1data\\rnd6.dun", LevelArena);
 	} else if (Quests[Q_SKELKING].IsAvailable() && !UseMultiplayerQuests()) {
-		setPieceData = LoadFileInMem<uint16_t>("levels\\l1data\\skngdo.dun");
+		setPieceData = LoadFileInArena<uint16_t>("levels\\l1data\\skngdo.dun", LevelArena);
 	} else if (Quests[Q_LTBANNER].IsAvailable()) {
-		setPieceData = LoadFileInMem<uint16_t>("levels\\l1data\\banner2.dun");
+		setPieceData = LoadFileInArena<uint16_t>("levels\\l1data\\banner2.dun", LevelArena);
 	} else {
 		return; // no setpiece needed for this level
 	}
 
 	const WorldTilePosition setPiecePosition = SelectChamber();
-	PlaceDunTiles(setPieceData.get(), setPiecePosition, Floor);
-	SetPiece = { setPiecePosition, GetDunSize(setPieceData.get()) };
+	PlaceDunTiles(setPieceData, setPiecePosition, Floor);
+	SetPiece = { setPiecePosition, GetDunSize(setPieceData) };
 }
 
 void InitDungeonPieces()
@@ -430,27 +430,18 @@ void InitDungeonFlags()
 
 void MapRoom(Rectangle room)
 {
-	for (int y = 0; y < room.size.height; y++) {
-		for (int x = 0; x < room.size.width; x++) {
-			DungeonMask.set(room.position.x + x, room.position.y + y);
-		}
-	}
+	if (room.size.width <= 0 || room.size.height <= 0)
+		return;
+	DungeonMask.fillRect(room.position.x, room.position.y, room.size.width, room.size.height);
 }
 
 bool CheckRoom(Rectangle room)
 {
-	for (int j = 0; j < room.size.height; j++) {
-		for (int i = 0; i < room.size.width; i++) {
-			if (i + room.position.x < 0 || i + room.position.x >= DMAXX || j + room.position.y < 0 || j + room.position.y >= DMAXY) {
-				return false;
-			}
-			if (DungeonMask.test(i + room.position.x, j + room.position.y)) {
-				return false;
-			}
-		}
-	}
-
-	return true;
+	if (room.size.width <= 0 || room.size.height <= 0)
+		return true;
+	if (room.position.x < 0 || room.position.x + room.size.width > DMAXX || room.position.y < 0 || room.position.y + room.size.height > DMAXY)
+		return false;
+	return !DungeonMask.anyInRect(room.position.x, room.position.y, room.size.width, room.size.height);
 }
 
 void GenerateRoom(Rectangle area, bool verticalLayout)
@@ -1313,8 +1304,8 @@ void LoadPreL1Dungeon(const char *path)
 {
 	InitDungeonFlags();
 
-	auto dunData = LoadFileInMem<uint16_t>(path);
-	PlaceDunTiles(dunData.get(), { 0, 0 }, Floor);
+	const uint16_t *dunData = LoadFileInArena<uint16_t>(path, LevelArena);
+	PlaceDunTiles(dunData, { 0, 0 }, Floor);
 
 	if (setlvltype == DTYPE_CATHEDRAL)
 		FillFloor();
@@ -1632,21 +1632,21 @@ void PlaceMiniSetRandom1x1(uint8_t search, uint8_t replace, int rndper)
 
 void InitSetPiece()
 {
-	std::unique_ptr<uint16_t[]> setPieceData;
+	const uint16_t *setPieceData = nullptr;
 
 	if (Quests[Q_BLIND].IsAvailable()) {
-		setPieceData = LoadFileInMem<uint16_t>("levels\\l2data\\blind1.dun");
+		setPieceData = LoadFileInArena<uint16_t>("levels\\l2data\\blind1.dun", LevelArena);
 	} else if (Quests[Q_BLOOD].IsAvailable()) {
-		setPieceData = LoadFileInMem<uint16_t>("levels\\l2data\\blood1.dun");
+		setPieceData = LoadFileInArena<uint16_t>("levels\\l2data\\blood1.dun", LevelArena);
 	} else if (Quests[Q_SCHAMB].IsAvailable()) {
-		setPieceData = LoadFileInMem<uint16_t>("levels\\l2data\\bonestr2.dun");
+		setPieceData = LoadFileInArena<uint16_t>("levels\\l2data\\bonestr2.dun", LevelArena);
 	} else {
 		return; // no setpiece needed for this level
 	}
 
 	const WorldTilePosition setPiecePosition = SetPieceRoom.position;
-	PlaceDunTiles(setPieceData.get(), setPiecePosition, 3);
-	SetPiece = { setPiecePosition, GetDunSize(setPieceData.get()) };
+	PlaceDunTiles(setPieceData, setPiecePosition, 3);
+	SetPiece = { setPiecePosition, GetDunSize(setPieceData) };
 }
 
 void InitDungeonPieces()
@@ -2835,8 +2835,8 @@ void LoadPreL2Dungeon(const char *path)
 {
 	memset(dungeon, 12, sizeof(dungeon));
 
-	auto dunData = LoadFileInMem<uint16_t>(path);
-	PlaceDunTiles(dunData.get(), { 0, 0 }, 3);
+	const uint16_t *dunData = LoadFileInArena<uint16_t>(path, LevelArena);
+	PlaceDunTiles(dunData, { 0, 0 }, 3);
 
 	memcpy(pdungeon, dungeon, sizeof(pdungeon));
 }
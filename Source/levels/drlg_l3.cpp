@@ -1796,9 +1796,9 @@ void Fence()
 
 bool PlaceAnvil()
 {
-	const std::unique_ptr<uint16_t[]> setPieceData = LoadFileInMem<uint16_t>("levels\\l3data\\anvil.dun");
+	const uint16_t *setPieceData = LoadFileInArena<uint16_t>("levels\\l3data\\anvil.dun", LevelArena);
 	// growing the size by 2 to allow a 1 tile border on all sides
-	const WorldTileSize areaSize = GetDunSize(setPieceData.get()) + 2;
+	const WorldTileSize areaSize = GetDunSize(setPieceData) + 2;
 	WorldTileCoord sx = GenerateRnd(DMAXX - areaSize.width);
 	WorldTileCoord sy = GenerateRnd(DMAXY - areaSize.height);
 
@@ -1825,7 +1825,7 @@ bool PlaceAnvil()
 			break;
 	}
 
-	PlaceDunTiles(setPieceData.get(), { sx + 1, sy + 1 }, 7);
+	PlaceDunTiles(setPieceData, { sx + 1, sy + 1 }, 7);
 	SetPiece = { { sx, sy }, areaSize };
 
 	for (const WorldTilePosition tile : PointsInRectangle(SetPiece)) {
@@ -2195,8 +2195,8 @@ void LoadPreL3Dungeon(const char *path)
 {
 	memset(dungeon, 8, sizeof(dungeon));
 
-	auto dunData = LoadFileInMem<uint16_t>(path);
-	PlaceDunTiles(dunData.get(), { 0, 0 }, 7);
+	const uint16_t *dunData = LoadFileInArena<uint16_t>(path, LevelArena);
+	PlaceDunTiles(dunData, { 0, 0 }, 7);
 
 	memcpy(pdungeon, dungeon, sizeof(pdungeon));
 }
@@ -162,19 +162,19 @@ void ApplyShadowsPatterns()
 
 void InitSetPiece()
 {
-	std::unique_ptr<uint16_t[]> setPieceData;
+	const uint16_t *setPieceData = nullptr;
 
 	if (Quests[Q_WARLORD].IsAvailable()) {
-		setPieceData = LoadFileInMem<uint16_t>("levels\\l4data\\warlord.dun");
+		setPieceData = LoadFileInArena<uint16_t>("levels\\l4data\\warlord.dun", LevelArena);
 	} else if (currlevel == 15 && UseMultiplayerQuests()) {
-		setPieceData = LoadFileInMem<uint16_t>("levels\\l4data\\vile1.dun");
+		setPieceData = LoadFileInArena<uint16_t>("levels\\l4data\\vile1.dun", LevelArena);
 	} else {
 		return; // no setpiece needed for this level
 	}
 
 	const WorldTilePosition setPiecePosition = SetPieceRoom.position;
-	PlaceDunTiles(setPieceData.get(), setPiecePosition, 6);
-	SetPiece = { setPiecePosition, GetDunSize(setPieceData.get()) };
+	PlaceDunTiles(setPieceData, setPiecePosition, 6);
+	SetPiece = { setPiecePosition, GetDunSize(setPieceData) };
 }
 
 void InitDungeonFlags()
@@ -186,11 +186,12 @@ void InitDungeonFlags()
 
 void MapRoom(WorldTileRectangle room)
 {
-	for (WorldTileCoord y = 0; y < room.size.height && y + room.position.y < DMAXY / 2; y++) {
-		for (WorldTileCoord x = 0; x < room.size.width && x + room.position.x < DMAXX / 2; x++) {
-			DungeonMask.set(room.position.x + x, room.position.y + y);
-		}
-	}
+	// Only the first quadrant is generated, it is mirrored to the rest of the map.
+	const int width = std::min<int>(room.size.width, DMAXX / 2 - room.position.x);
+	const int height = std::min<int>(room.size.height, DMAXY / 2 - room.position.y);
+	if (width <= 0 || height <= 0)
+		return;
+	DungeonMask.fillRect(room.position.x, room.position.y, width, height);
 }
 
 bool CheckRoom(WorldTileRectangle room)
@@ -198,19 +199,14 @@ bool CheckRoom(WorldTileRectangle room)
 	if (room.position.x <= 0 || room.position.y <= 0) {
 		return false;
 	}
-
-	for (int y = 0; y < room.size.height; y++) {
-		for (int x = 0; x < room.size.width; x++) {
-			if (x + room.position.x < 0 || x + room.position.x >= DMAXX / 2 || y + room.position.y < 0 || y + room.position.y >= DMAXY / 2) {
-				return false;
-			}
-			if (DungeonMask.test(room.position.x + x, room.position.y + y)) {
-				return false;
-			}
-		}
+	if (room.size.width <= 0 || room.size.height <= 0) {
+		return true;
+	}
+	if (room.position.x + room.size.width > DMAXX / 2 || room.position.y + room.size.height > DMAXY / 2) {
+		return false;
 	}
 
-	return true;
+	return !DungeonMask.anyInRect(room.position.x, room.position.y, room.size.width, room.size.height);
 }
 
 void GenerateRoom(WorldTileRectangle area, bool verticalLayout)
@@ -947,37 +943,34 @@ inline size_t FindArea()
 
 void ProtectQuads()
 {
-	for (int y = 0; y < 14; y++) {
-		for (int x = 0; x < 14; x++) {
-			Protected.set(L4Hold.x + x, L4Hold.y + y);
-			Protected.set(DMAXX - 1 - x - L4Hold.x, L4Hold.y + y);
-			Protected.set(L4Hold.x + x, DMAXY - 1 - y - L4Hold.y);
-			Protected.set(DMAXX - 1 - x - L4Hold.x, DMAXY - 1 - y - L4Hold.y);
-		}
-	}
+	constexpr int Size = 14;
+	Protected.fillRect(L4Hold.x, L4Hold.y, Size, Size);
+	Protected.fillRect(DMAXX - Size - L4Hold.x, L4Hold.y, Size, Size);
+	Protected.fillRect(L4Hold.x, DMAXY - Size - L4Hold.y, Size, Size);
+	Protected.fillRect(DMAXX - Size - L4Hold.x, DMAXY - Size - L4Hold.y, Size, Size);
 }
 
 void LoadDiabQuads(bool preflag)
 {
 	{
-		auto dunData = LoadFileInMem<uint16_t>("levels\\l4data\\diab1.dun");
+		const uint16_t *dunData = LoadFileInArena<uint16_t>("levels\\l4data\\diab1.dun", LevelArena);
 		DiabloQuad1 = L4Hold + WorldTileDisplacement { 4, 4 };
-		PlaceDunTiles(dunData.get(), DiabloQuad1, 6);
+		PlaceDunTiles(dunData, DiabloQuad1, 6);
 	}
 	{
-		auto dunData = LoadFileInMem<uint16_t>(preflag ? "levels\\l4data\\diab2b.dun" : "levels\\l4data\\diab2a.dun");
+		const uint16_t *dunData = LoadFileInArena<uint16_t>(preflag ? "levels\\l4data\\diab2b.dun" : "levels\\l4data\\diab2a.dun", LevelArena);
 		DiabloQuad2 = WorldTilePosition(27 - L4Hold.x, 1 + L4Hold.y);
-		PlaceDunTiles(dunData.get(), DiabloQuad2, 6);
+		PlaceDunTiles(dunData, DiabloQuad2, 6);
 	}
 	{
-		auto dunData = LoadFileInMem<uint16_t>(preflag ? "levels\\l4data\\diab3b.dun" : "levels\\l4data\\diab3a.dun");
+		const uint16_t *dunData = LoadFileInArena<uint16_t>(preflag ? "levels\\l4data\\diab3b.dun" : "levels\\l4data\\diab3a.dun", LevelArena);
 		DiabloQuad3 = WorldTilePosition(1 + L4Hold.x, 27 - L4Hold.y);
-		PlaceDunTiles(dunData.get(), DiabloQuad3, 6);
+		PlaceDunTiles(dunData, DiabloQuad3, 6);
 	}
 	{
-		auto dunData = LoadFileInMem<uint16_t>(preflag ? "levels\\l4data\\diab4b.dun" : "levels\\l4data\\diab4a.dun");
+		const uint16_t *dunData = LoadFileInArena<uint16_t>(preflag ? "levels\\l4data\\diab4b.dun" : "levels\\l4data\\diab4a.dun", LevelArena);
 		DiabloQuad4 = WorldTilePosition(28 - L4Hold.x, 28 - L4Hold.y);
-		PlaceDunTiles(dunData.get(), DiabloQuad4, 6);
+		PlaceDunTiles(dunData, DiabloQuad4, 6);
 	}
 }
 
@@ -1234,8 +1227,8 @@ void LoadPreL4Dungeon(const char *path)
 {
 	memset(dungeon, 30, sizeof(dungeon));
 
-	auto dunData = LoadFileInMem<uint16_t>(path);
-	PlaceDunTiles(dunData.get(), { 0, 0 }, 6);
+	const uint16_t *dunData = LoadFileInArena<uint16_t>(path, LevelArena);
+	PlaceDunTiles(dunData, { 0, 0 }, 6);
 
 	memcpy(pdungeon, dungeon, sizeof(pdungeon));
 }
@@ -0,0 +1,121 @@
+#include "levels/dun_cels_cache.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <ankerl/unordered_dense.h>
+#include <fmt/format.h>
+
+#include "utils/endian_read.hpp"
+#include "utils/file_util.h"
+#include "utils/log.hpp"
+#include "utils/paths.h"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+
+namespace {
+
+/** @brief Bump this whenever `ReencodeDungeonCels` or the layout of `MICROS` changes. */
+constexpr uint32_t DunCelsCacheVersion = 1;
+
+struct DunCelsCacheHeader {
+	char magic[4];
+	uint32_t version;
+	uint64_t key;
+	uint32_t numMicros;
+	uint32_t celsSize;
+};
+
+constexpr char DunCelsCacheMagic[4] = { 'D', 'X', 'D', 'C' };
+
+uint64_t HashBytes(const void *data, size_t size)
+{
+	return ankerl::unordered_dense::hash<std::string_view> {}(std::string_view { static_cast<const char *>(data), size });
+}
+
+/** @brief The size of a CEL file, which is stored as the offset past its last frame. */
+uint32_t GetCelSize(const std::byte *cels)
+{
+	const auto *data = reinterpret_cast<const uint8_t *>(cels);
+	return LoadLE32(&data[4 * (LoadLE32(data) + 1)]);
+}
+
+std::string DunCelsCachePath(uint64_t key)
+{
+	return StrCat(paths::PrefPath(), "cache" DIRECTORY_SEPARATOR_STR, fmt::format("{:016x}", key), ".dun");
+}
+
+} // namespace
+
+uint64_t GetDunCelsCacheKey(dungeon_type levelType, const std::byte *dungeonCels, std::span<const uint16_t> levelPieces, std::span<const TileProperties> solData)
+{
+	const uint64_t parts[] = {
+		HashBytes(dungeonCels, GetCelSize(dungeonCels)),
+		HashBytes(levelPieces.data(), levelPieces.size_bytes()),
+		HashBytes(solData.data(), solData.size_bytes()),
+		static_cast<uint64_t>(levelType),
+		DunCelsCacheVersion,
+	};
+	return HashBytes(parts, sizeof(parts));
+}
+
+bool LoadCachedDunCels(uint64_t key, std::unique_ptr<std::byte[]> &dungeonCels, std::span<MICROS> micros)
+{
+	FILE *file = OpenFile(DunCelsCachePath(key).c_str(), "rb");
+	if (file == nullptr)
+		return false;
+
+	bool loaded = false;
+	DunCelsCacheHeader header;
+	if (std::fread(&header, sizeof(header), 1, file) == 1
+	    && std::memcmp(header.magic, DunCelsCacheMagic, sizeof(DunCelsCacheMagic)) == 0
+	    && header.version == DunCelsCacheVersion
+	    && header.key == key
+	    && header.numMicros == micros.size()
+	    && header.celsSize != 0) {
+		std::unique_ptr<std::byte[]> cels { new std::byte[header.celsSize] };
+		// Read the sub-tiles last, so that they are only modified when the whole entry is valid.
+		if (std::fread(cels.get(), header.celsSize, 1, file) == 1
+		    && std::fread(micros.data(), micros.size_bytes(), 1, file) == 1) {
+			dungeonCels = std::move(cels);
+			loaded = true;
+		}
+	}
+	std::fclose(file);
+	if (!loaded)
+		LogVerbose("Ignoring invalid dungeon CELs cache entry {:016x}", key);
+	return loaded;
+}
+
+void StoreCachedDunCels(uint64_t key, const std::byte *dungeonCels, std::span<const MICROS> micros)
+{
+	const std::string path = DunCelsCachePath(key);
+	const std::string tempPath = StrCat(path, ".tmp");
+	RecursivelyCreateDir(StrCat(paths::PrefPath(), "cache").c_str());
+	FILE *file = OpenFile(tempPath.c_str(), "wb");
+	if (file == nullptr)
+		return;
+
+	DunCelsCacheHeader header {};
+	std::memcpy(header.magic, DunCelsCacheMagic, sizeof(DunCelsCacheMagic));
+	header.version = DunCelsCacheVersion;
+	header.key = key;
+	header.numMicros = static_cast<uint32_t>(micros.size());
+	header.celsSize = GetCelSize(dungeonCels);
+	const bool written = std::fwrite(&header, sizeof(header), 1, file) == 1
+	    && std::fwrite(dungeonCels, header.celsSize, 1, file) == 1
+	    && std::fwrite(micros.data(), micros.size_bytes(), 1, file) == 1;
+	if (std::fclose(file) != 0 || !written) {
+		LogVerbose("Failed to write the dungeon CELs cache entry {:016x}", key);
+		RemoveFile(tempPath.c_str());
+		return;
+	}
+	RenameFile(tempPath.c_str(), path.c_str());
+}
+
+} // namespace devilution
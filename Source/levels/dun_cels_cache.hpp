@@ -0,0 +1,39 @@
+/**
+ * @file dun_cels_cache.hpp
+ *
+ * On-disk cache of the re-encoded dungeon CELs and the sub-tile tables that reference them.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include "levels/dun_tile.hpp"
+#include "levels/gendung_defs.hpp"
+
+namespace devilution {
+
+/**
+ * @brief Computes the cache key of a tileset from everything that the re-encoding depends on.
+ *
+ * @param dungeonCels The CEL data as loaded from the assets, before re-encoding.
+ * @param levelPieces The contents of the MIN file.
+ * @param solData The properties of each sub-tile.
+ */
+uint64_t GetDunCelsCacheKey(dungeon_type levelType, const std::byte *dungeonCels, std::span<const uint16_t> levelPieces, std::span<const TileProperties> solData);
+
+/**
+ * @brief Loads the results of an earlier re-encoding of the same tileset.
+ *
+ * @return Whether `dungeonCels` and `micros` were replaced with the cached data.
+ */
+bool LoadCachedDunCels(uint64_t key, std::unique_ptr<std::byte[]> &dungeonCels, std::span<MICROS> micros);
+
+/**
+ * @brief Stores the re-encoded CELs and sub-tile tables for the next time the tileset is loaded.
+ */
+void StoreCachedDunCels(uint64_t key, const std::byte *dungeonCels, std::span<const MICROS> micros);
+
+} // namespace devilution
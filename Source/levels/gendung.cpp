@@ -1,8 +1,12 @@
 #include "levels/gendung.h"
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
+#include <optional>
 #include <stack>
 #include <string>
 #include <utility>
@@ -18,15 +22,20 @@
 #include "engine/world_tile.hpp"
 #include "game_mode.hpp"
 #include "items.h"
+#include "levels/crypt.h"
 #include "levels/drlg_l1.h"
 #include "levels/drlg_l2.h"
 #include "levels/drlg_l3.h"
 #include "levels/drlg_l4.h"
+#include "levels/dun_cels_cache.hpp"
 #include "levels/reencode_dun_cels.hpp"
 #include "levels/town.h"
 #include "lighting.h"
 #include "monster.h"
+#include "multi.h"
 #include "objects.h"
+#include "player.h"
+#include "quests.h"
 #include "utils/algorithm/container.hpp"
 #include "utils/bitset2d.hpp"
 #include "utils/endian_swap.hpp"
@@ -43,6 +52,7 @@ Bitset2d<DMAXX, DMAXY> Protected;
 WorldTileRectangle SetPieceRoom;
 WorldTileRectangle SetPiece;
 OptionalOwnedClxSpriteList pSpecialCels;
+BumpArena LevelArena { 64 * 1024 };
 std::unique_ptr<MegaTile[]> pMegaTiles;
 std::unique_ptr<std::byte[]> pDungeonCels;
 TileProperties SOLData[MAXTILES];
@@ -381,6 +391,140 @@ void InitGlobals()
 	SetPiece = { { 0, 0 }, { 0, 0 } };
 }
 
+
+/**
+ * @brief Everything the level generators leave behind for loading the rest of the level.
+ *
+ * Together with the inputs that generation depends on, so a result is only reused for the same level.
+ */
+struct DungeonGenContext {
+	uint8_t level;
+	uint32_t seed;
+	lvl_entry entry;
+	bool hellfire;
+	bool originalCathedral;
+	std::array<quest_state, MAXQUESTS> questStates;
+
+	uint8_t dungeon[DMAXX][DMAXY];
+	uint8_t pdungeon[DMAXX][DMAXY];
+	Bitset2d<DMAXX, DMAXY> protectedTiles;
+	Bitset2d<DMAXX, DMAXY> dungeonMask;
+	uint16_t dPiece[MAXDUNX][MAXDUNY];
+	int8_t dTransVal[MAXDUNX][MAXDUNY];
+	DungeonFlag dFlags[MAXDUNX][MAXDUNY];
+	int8_t dSpecial[MAXDUNX][MAXDUNY];
+	int8_t transVal;
+	std::array<bool, 256> transList;
+	WorldTilePosition dminPosition;
+	WorldTilePosition dmaxPosition;
+	WorldTileRectangle setPieceRoom;
+	WorldTileRectangle setPiece;
+	Point viewPosition;
+	int themeCount;
+	THEME_LOC themeLoc[MAXTHEMES];
+	std::array<Point, MAXQUESTS> questPositions;
+	WorldTilePosition diabloQuads[4];
+	int uberRow;
+	int uberCol;
+	bool isUberRoomOpened;
+	bool isUberLeverActivated;
+	/** @brief RNG state generation left behind, later draws (such as the level palette) depend on it */
+	uint32_t rngState;
+
+	bool Matches(uint32_t rseed, lvl_entry lvlEntry) const
+	{
+		if (level != currlevel || seed != rseed || entry != lvlEntry || hellfire != gbIsHellfire || originalCathedral != MyPlayer->pOriginalCathedral)
+			return false;
+		for (size_t i = 0; i < MAXQUESTS; i++) {
+			if (questStates[i] != Quests[i]._qactive)
+				return false;
+		}
+		return true;
+	}
+
+	void Save(uint32_t rseed, lvl_entry lvlEntry)
+	{
+		level = currlevel;
+		seed = rseed;
+		entry = lvlEntry;
+		hellfire = gbIsHellfire;
+		originalCathedral = MyPlayer->pOriginalCathedral;
+		for (size_t i = 0; i < MAXQUESTS; i++) {
+			questStates[i] = Quests[i]._qactive;
+			questPositions[i] = Quests[i].position;
+		}
+
+		memcpy(this->dungeon, ::devilution::dungeon, sizeof(this->dungeon));
+		memcpy(this->pdungeon, ::devilution::pdungeon, sizeof(this->pdungeon));
+		protectedTiles = Protected;
+		dungeonMask = DungeonMask;
+		memcpy(this->dPiece, ::devilution::dPiece, sizeof(this->dPiece));
+		memcpy(this->dTransVal, ::devilution::dTransVal, sizeof(this->dTransVal));
+		memcpy(this->dFlags, ::devilution::dFlags, sizeof(this->dFlags));
+		memcpy(this->dSpecial, ::devilution::dSpecial, sizeof(this->dSpecial));
+		transVal = TransVal;
+		transList = TransList;
+		this->dminPosition = ::devilution::dminPosition;
+		this->dmaxPosition = ::devilution::dmaxPosition;
+		setPieceRoom = SetPieceRoom;
+		setPiece = SetPiece;
+		viewPosition = ViewPosition;
+		this->themeCount = ::devilution::themeCount;
+		std::copy(std::begin(::devilution::themeLoc), std::end(::devilution::themeLoc), std::begin(this->themeLoc));
+		diabloQuads[0] = DiabloQuad1;
+		diabloQuads[1] = DiabloQuad2;
+		diabloQuads[2] = DiabloQuad3;
+		diabloQuads[3] = DiabloQuad4;
+		uberRow = UberRow;
+		uberCol = UberCol;
+		isUberRoomOpened = IsUberRoomOpened;
+		isUberLeverActivated = IsUberLeverActivated;
+		rngState = GetLCGEngineState();
+	}
+
+	void Restore() const
+	{
+		// Only the quests of this level have their positions set by its generation
+		for (size_t i = 0; i < MAXQUESTS; i++) {
+			if (Quests[i]._qlevel == level)
+				Quests[i].position = questPositions[i];
+		}
+
+		memcpy(::devilution::dungeon, this->dungeon, sizeof(this->dungeon));
+		memcpy(::devilution::pdungeon, this->pdungeon, sizeof(this->pdungeon));
+		Protected = protectedTiles;
+		DungeonMask = dungeonMask;
+		memcpy(::devilution::dPiece, this->dPiece, sizeof(this->dPiece));
+		memcpy(::devilution::dTransVal, this->dTransVal, sizeof(this->dTransVal));
+		memcpy(::devilution::dFlags, this->dFlags, sizeof(this->dFlags));
+		memcpy(::devilution::dSpecial, this->dSpecial, sizeof(this->dSpecial));
+		TransVal = transVal;
+		TransList = transList;
+		::devilution::dminPosition = this->dminPosition;
+		::devilution::dmaxPosition = this->dmaxPosition;
+		SetPieceRoom = setPieceRoom;
+		SetPiece = setPiece;
+		ViewPosition = viewPosition;
+		::devilution::themeCount = this->themeCount;
+		std::copy(std::begin(this->themeLoc), std::end(this->themeLoc), std::begin(::devilution::themeLoc));
+		DiabloQuad1 = diabloQuads[0];
+		DiabloQuad2 = diabloQuads[1];
+		DiabloQuad3 = diabloQuads[2];
+		DiabloQuad4 = diabloQuads[3];
+		UberRow = uberRow;
+		UberCol = uberCol;
+		IsUberRoomOpened = isUberRoomOpened;
+		IsUberLeverActivated = isUberLeverActivated;
+		SetRndSeed(rngState);
+	}
+};
+
+/** @brief How many generated levels are kept, enough for going back and forth between a few levels. */
+constexpr size_t MaxCachedDungeons = 4;
+
+/** @brief The most recently generated levels of this game, the most recent one last. */
+std::vector<std::unique_ptr<DungeonGenContext>> CachedDungeons;
+
 } // namespace
 
 #ifdef BUILD_TESTING
@@ -412,6 +556,7 @@ dungeon_type GetLevelType(int level)
 
 void CreateDungeon(uint32_t rseed, lvl_entry entry)
 {
+	LevelArena.reset();
 	InitGlobals();
 
 	switch (leveltype) {
@@ -439,6 +584,41 @@ void CreateDungeon(uint32_t rseed, lvl_entry entry)
 	Make_SetPC(SetPiece);
 }
 
+void CreateDungeonCached(uint32_t rseed, lvl_entry entry)
+{
+	// The town is loaded rather than generated and depends on more than the quests
+	if (leveltype == DTYPE_TOWN || gbIsMultiplayer) {
+		CreateDungeon(rseed, entry);
+		return;
+	}
+
+	for (auto it = CachedDungeons.begin(); it != CachedDungeons.end(); ++it) {
+		if (!(*it)->Matches(rseed, entry))
+			continue;
+		InitGlobals();
+		(*it)->Restore();
+		std::rotate(it, it + 1, CachedDungeons.end());
+		return;
+	}
+
+	CreateDungeon(rseed, entry);
+
+	std::unique_ptr<DungeonGenContext> context;
+	if (CachedDungeons.size() >= MaxCachedDungeons) {
+		context = std::move(CachedDungeons.front());
+		CachedDungeons.erase(CachedDungeons.begin());
+	} else {
+		context = std::make_unique<DungeonGenContext>();
+	}
+	context->Save(rseed, entry);
+	CachedDungeons.push_back(std::move(context));
+}
+
+void ClearDungeonCache()
+{
+	CachedDungeons.clear();
+}
+
 tl::expected<void, std::string> LoadLevelSOLData()
 {
 	switch (leveltype) {
@@ -521,10 +701,19 @@ void SetDungeonMicros(std::unique_ptr<std::byte[]> &dungeonCels, uint_fast8_t &m
 
 	size_t tileCount;
 	const std::unique_ptr<uint16_t[]> levelPieces = LoadMinData(tileCount);
+	const size_t pieceCount = tileCount / blocks;
+
+	// The re-encoding only depends on the tileset's assets, so it is reused for as long as they don't change.
+	std::optional<uint64_t> cacheKey;
+	if (dungeonCels != nullptr) {
+		cacheKey = GetDunCelsCacheKey(leveltype, dungeonCels.get(), { levelPieces.get(), tileCount }, { SOLData, pieceCount });
+		if (LoadCachedDunCels(*cacheKey, dungeonCels, { DPieceMicros, pieceCount }))
+			return;
+	}
 
 	ankerl::unordered_dense::map<uint16_t, DunFrameInfo> frameToTypeMap;
 	frameToTypeMap.reserve(4096);
-	for (size_t levelPieceId = 0; levelPieceId < tileCount / blocks; levelPieceId++) {
+	for (size_t levelPieceId = 0; levelPieceId < pieceCount; levelPieceId++) {
 		uint16_t *pieces = &levelPieces[blocks * levelPieceId];
 		for (uint32_t block = 0; block < blocks; block++) {
 			const LevelCelBlock levelCelBlock { Swap16LE(pieces[blocks - 2 + (block & 1) - (block & 0xE)]) };
@@ -543,20 +732,24 @@ void SetDungeonMicros(std::unique_ptr<std::byte[]> &dungeonCels, uint_fast8_t &m
 	});
 	ReencodeDungeonCels(dungeonCels, frameToTypeList);
 
-	std::vector<std::pair<uint16_t, uint16_t>> celBlockAdjustments = ComputeCelBlockAdjustments(frameToTypeList);
-	if (celBlockAdjustments.size() == 0) return;
-	for (size_t levelPieceId = 0; levelPieceId < tileCount / blocks; levelPieceId++) {
-		for (uint32_t block = 0; block < blocks; block++) {
-			LevelCelBlock &levelCelBlock = DPieceMicros[levelPieceId].mt[block];
-			const uint16_t frame = levelCelBlock.frame();
-			const auto pair = std::make_pair(frame, frame);
-			const auto it = std::upper_bound(celBlockAdjustments.begin(), celBlockAdjustments.end(), pair,
-			    [](std::pair<uint16_t, uint16_t> p1, std::pair<uint16_t, uint16_t> p2) { return p1.first < p2.first; });
-			if (it != celBlockAdjustments.end()) {
-				levelCelBlock.data -= it->second;
+	const std::vector<std::pair<uint16_t, uint16_t>> celBlockAdjustments = ComputeCelBlockAdjustments(frameToTypeList);
+	if (!celBlockAdjustments.empty()) {
+		for (size_t levelPieceId = 0; levelPieceId < pieceCount; levelPieceId++) {
+			for (uint32_t block = 0; block < blocks; block++) {
+				LevelCelBlock &levelCelBlock = DPieceMicros[levelPieceId].mt[block];
+				const uint16_t frame = levelCelBlock.frame();
+				const auto pair = std::make_pair(frame, frame);
+				const auto it = std::upper_bound(celBlockAdjustments.begin(), celBlockAdjustments.end(), pair,
+				    [](std::pair<uint16_t, uint16_t> p1, std::pair<uint16_t, uint16_t> p2) { return p1.first < p2.first; });
+				if (it != celBlockAdjustments.end()) {
+					levelCelBlock.data -= it->second;
+				}
 			}
 		}
 	}
+
+	if (cacheKey)
+		StoreCachedDunCels(*cacheKey, dungeonCels.get(), { DPieceMicros, pieceCount });
 }
 
 void DRLG_InitTrans()
@@ -622,13 +815,13 @@ void LoadDungeonBase(const char *path, Point spawn, int floorId, int dirtId)
 
 	memset(dungeon, dirtId, sizeof(dungeon));
 
-	auto dunData = LoadFileInMem<uint16_t>(path);
-	PlaceDunTiles(dunData.get(), { 0, 0 }, floorId);
-	LoadTransparency(dunData.get());
+	const uint16_t *dunData = LoadFileInArena<uint16_t>(path, LevelArena);
+	PlaceDunTiles(dunData, { 0, 0 }, floorId);
+	LoadTransparency(dunData);
 
-	SetMapMonsters(dunData.get(), Point(0, 0).megaToWorld());
+	SetMapMonsters(dunData, Point(0, 0).megaToWorld());
 	InitAllMonsterGFX();
-	SetMapObjects(dunData.get(), 0, 0);
+	SetMapObjects(dunData, 0, 0);
 }
 
 void Make_SetPC(WorldTileRectangle area)
@@ -815,6 +1008,7 @@ void InitLevels()
 	currlevel = 0;
 	leveltype = DTYPE_TOWN;
 	setlevel = false;
+	ClearDungeonCache();
 }
 
 void FloodTransparencyValues(uint8_t floorID)
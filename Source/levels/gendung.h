@@ -23,6 +23,7 @@
 #include "levels/gendung_defs.hpp"
 #include "utils/attributes.h"
 #include "utils/bitset2d.hpp"
+#include "utils/bump_arena.hpp"
 #include "utils/enum_traits.h"
 
 namespace devilution {
@@ -120,6 +121,12 @@ extern WorldTileRectangle SetPieceRoom;
 /** Specifies the active set quest piece in coordinate. */
 extern WorldTileRectangle SetPiece;
 extern OptionalOwnedClxSpriteList pSpecialCels;
+/**
+ * @brief Holds the files that are only read to set up a level, such as set pieces and maps.
+ *
+ * Reset when a level is generated and when the level is left, the memory is kept for the next level.
+ */
+extern BumpArena LevelArena;
 /** Specifies the tile definitions of the active dungeon type; (e.g. levels/l1data/l1.til). */
 extern DVL_API_FOR_TEST std::unique_ptr<MegaTile[]> pMegaTiles;
 extern DVL_API_FOR_TEST std::unique_ptr<std::byte[]> pDungeonCels;
@@ -155,9 +162,9 @@ extern DVL_API_FOR_TEST int8_t dTransVal[MAXDUNX][MAXDUNY];
 /** Current realtime lighting. Per tile. */
 extern DVL_API_FOR_TEST uint8_t dLight[MAXDUNX][MAXDUNY];
 /** Precalculated static lights. dLight uses this as a base before applying lights. Per tile. */
-extern uint8_t dPreLight[MAXDUNX][MAXDUNY];
+extern DVL_API_FOR_TEST uint8_t dPreLight[MAXDUNX][MAXDUNY];
 /** Holds various information about dungeon tiles, @see DungeonFlag */
-extern DungeonFlag dFlags[MAXDUNX][MAXDUNY];
+extern DVL_API_FOR_TEST DungeonFlag dFlags[MAXDUNX][MAXDUNY];
 /** Contains the player numbers (players array indices) of the map. negative id indicates player moving. */
 extern int8_t dPlayer[MAXDUNX][MAXDUNY];
 /**
@@ -194,6 +201,16 @@ std::optional<WorldTileSize> GetSizeForThemeRoom();
 
 dungeon_type GetLevelType(int level);
 void CreateDungeon(uint32_t rseed, lvl_entry entry);
+/**
+ * @brief Creates the dungeon like CreateDungeon, but reuses the result if the same level was recently generated.
+ *
+ * Only single player dungeon levels are reused, going back up the stairs then skips generating the level again.
+ */
+void CreateDungeonCached(uint32_t rseed, lvl_entry entry);
+/**
+ * @brief Forgets the levels kept by CreateDungeonCached.
+ */
+void ClearDungeonCache();
 
 DVL_ALWAYS_INLINE constexpr bool InDungeonBounds(Point position)
 {
@@ -268,12 +285,12 @@ struct Miniset {
 	 */
 	bool matches(WorldTilePosition position, bool respectProtected = true) const
 	{
+		if (respectProtected && Protected.anyInRect(position.x, position.y, size.width, size.height))
+			return false;
 		for (WorldTileCoord yy = 0; yy < size.height; yy++) {
 			for (WorldTileCoord xx = 0; xx < size.width; xx++) {
 				if (search[yy][xx] != 0 && dungeon[xx + position.x][yy + position.y] != search[yy][xx])
 					return false;
-				if (respectProtected && Protected.test(xx + position.x, yy + position.y))
-					return false;
 			}
 		}
 		return true;
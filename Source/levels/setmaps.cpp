@@ -66,8 +66,8 @@ void AddVileObjs()
 
 void SetMapTransparency(const char *path)
 {
-	auto dunData = LoadFileInMem<uint16_t>(path);
-	LoadTransparency(dunData.get());
+	const uint16_t *dunData = LoadFileInArena<uint16_t>(path, LevelArena);
+	LoadTransparency(dunData);
 }
 
 void LoadCustomMap(const char *path, Point viewPosition)
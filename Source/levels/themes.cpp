@@ -5,6 +5,7 @@
  */
 #include "levels/themes.h"
 
+#include <array>
 #include <cstdint>
 
 #include <fmt/core.h>
@@ -301,42 +302,57 @@ bool SpecialThemeFit(int i, theme_id t)
 	return rv;
 }
 
-bool CheckThemeRoom(int8_t tv)
+/** @brief What `CheckThemeRoom` needs to know about the tiles of one transparency region. */
+struct ThemeRoomSummary {
+	int area = 0;
+	bool containsTrigger = false;
+	bool containsSetPiece = false;
+	/** @brief Whether a walkable tile of the region borders a walkable tile of another region. */
+	bool isOpen = false;
+};
+
+/**
+ * @brief Summarizes every transparency region of the level in a single pass, instead of scanning the level for each candidate room.
+ * @return The summaries indexed by the region id.
+ */
+std::array<ThemeRoomSummary, 256> SummarizeThemeRooms()
 {
+	std::array<ThemeRoomSummary, 256> rooms {};
+	const auto roomAt = [&rooms](Point position) -> ThemeRoomSummary & {
+		return rooms[static_cast<uint8_t>(dTransVal[position.x][position.y])];
+	};
+
 	for (int i = 0; i < numtrigs; i++) {
-		if (dTransVal[trigs[i].position.x][trigs[i].position.y] == tv)
-			return false;
+		roomAt(trigs[i].position).containsTrigger = true;
 	}
 
-	int tarea = 0;
-	for (int j = 0; j < MAXDUNY; j++) {
-		for (int i = 0; i < MAXDUNX; i++) {
-			if (dTransVal[i][j] != tv)
-				continue;
-			if (TileContainsSetPiece({ i, j }))
-				return false;
-
-			tarea++;
+	for (const Point position : PointsInRectangle(Rectangle { { 0, 0 }, { MAXDUNX, MAXDUNY } })) {
+		ThemeRoomSummary &room = roomAt(position);
+		room.area++;
+		if (TileContainsSetPiece(position))
+			room.containsSetPiece = true;
+		if (room.isOpen || TileHasAny(position, TileProperties::Solid))
+			continue;
+		const int8_t tv = dTransVal[position.x][position.y];
+		for (const Direction direction : { Direction::NorthWest, Direction::SouthEast, Direction::NorthEast, Direction::SouthWest }) {
+			const Point neighbour = position + direction;
+			if (IsTileNotSolid(neighbour) && dTransVal[neighbour.x][neighbour.y] != tv) {
+				room.isOpen = true;
+				break;
+			}
 		}
 	}
 
-	if (leveltype == DTYPE_CATHEDRAL && (tarea < 9 || tarea > 100))
+	return rooms;
+}
+
+bool CheckThemeRoom(const ThemeRoomSummary &room)
+{
+	if (room.containsTrigger || room.containsSetPiece || room.isOpen)
 		return false;
 
-	for (int j = 0; j < MAXDUNY; j++) {
-		for (int i = 0; i < MAXDUNX; i++) {
-			if (dTransVal[i][j] != tv || TileHasAny({ i, j }, TileProperties::Solid))
-				continue;
-			if (dTransVal[i - 1][j] != tv && IsTileNotSolid({ i - 1, j }))
-				return false;
-			if (dTransVal[i + 1][j] != tv && IsTileNotSolid({ i + 1, j }))
-				return false;
-			if (dTransVal[i][j - 1] != tv && IsTileNotSolid({ i, j - 1 }))
-				return false;
-			if (dTransVal[i][j + 1] != tv && IsTileNotSolid({ i, j + 1 }))
-				return false;
-		}
-	}
+	if (leveltype == DTYPE_CATHEDRAL && (room.area < 9 || room.area > 100))
+		return false;
 
 	return true;
 }
@@ -845,8 +861,10 @@ void InitThemes()
 	constexpr theme_id ThemeGood[4] = { THEME_GOATSHRINE, THEME_SHRINE, THEME_SKELROOM, THEME_LIBRARY };
 
 	if (leveltype == DTYPE_CATHEDRAL) {
+		// Placing the themes only reads the level, so the rooms can be summarized up front
+		const std::array<ThemeRoomSummary, 256> rooms = SummarizeThemeRooms();
 		for (int8_t i = 0; numthemes < MAXTHEMES; i++) {
-			if (CheckThemeRoom(i)) {
+			if (CheckThemeRoom(rooms[static_cast<uint8_t>(i)])) {
 				themes[numthemes].ttval = i;
 				theme_id j = ThemeGood[GenerateRnd(4)];
 				while (!SpecialThemeFit(numthemes, j)) {
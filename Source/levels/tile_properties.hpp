@@ -29,4 +29,12 @@ namespace devilution {
  */
 [[nodiscard]] bool CanStep(Point startPosition, Point destinationPosition);
 
+/** @brief `CanStep` as a function object, for `FindPathT`. */
+struct CanStepPredicate {
+	bool operator()(Point startPosition, Point destinationPosition) const
+	{
+		return CanStep(startPosition, destinationPosition);
+	}
+};
+
 } // namespace devilution
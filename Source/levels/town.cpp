@@ -25,9 +25,9 @@ namespace {
  */
 void FillSector(const char *path, int xi, int yy)
 {
-	auto dunData = LoadFileInMem<uint16_t>(path);
+	const uint16_t *dunData = LoadFileInArena<uint16_t>(path, LevelArena);
 
-	const WorldTileSize size = GetDunSize(dunData.get());
+	const WorldTileSize size = GetDunSize(dunData);
 	const uint16_t *tileLayer = &dunData[2];
 
 	for (WorldTileCoord j = 0; j < size.height; j++) {
@@ -204,8 +204,8 @@ void DrlgTPass3()
 	FillSector("levels\\towndata\\sector3s.dun", 0, 46);
 	FillSector("levels\\towndata\\sector4s.dun", 0, 0);
 
-	auto dunData = LoadFileInMem<uint16_t>("levels\\towndata\\automap.dun");
-	PlaceDunTiles(dunData.get(), { 0, 0 });
+	const uint16_t *dunData = LoadFileInArena<uint16_t>("levels\\towndata\\automap.dun", LevelArena);
+	PlaceDunTiles(dunData, { 0, 0 });
 
 	if (!IsWarpOpen(DTYPE_CATACOMBS)) {
 		dungeon[20][7] = 10;
@@ -7,6 +7,7 @@
 
 #include <cmath>
 #include <cstdint>
+#include <optional>
 
 #include <fmt/format.h>
 
@@ -14,7 +15,10 @@
 #include "controls/control_mode.hpp"
 #include "controls/plrctrls.h"
 #include "cursor.h"
+#include "diablo.h"
 #include "diablo_msg.hpp"
+#include "engine/asset_prefetch.hpp"
+#include "engine/sound.h"
 #include "game_mode.hpp"
 #include "multi.h"
 #include "utils/algorithm/container.hpp"
@@ -66,6 +70,64 @@ const uint16_t L5DownList[] = { 124, 125, 128, 130, 131, 134, 135, 139, 141 };
 const uint16_t L6TWarpUpList[] = { 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91 };
 const uint16_t L6UpList[] = { 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77 };
 const uint16_t L6DownList[] = { 56, 57, 58, 59, 60, 61, 62, 63 };
+
+/** Specifies how close the player has to get to a trigger before the assets of the level behind it are prefetched. */
+constexpr int TriggerPrefetchDistance = 6;
+
+struct TriggerPrefetchKey {
+	uint8_t level;
+	bool isSetLevel;
+	dungeon_type destination;
+
+	bool operator==(const TriggerPrefetchKey &other) const = default;
+};
+
+/** Specifies which destination the assets were last prefetched for. */
+std::optional<TriggerPrefetchKey> PrefetchedTrigger;
+
+std::optional<dungeon_type> GetTriggerDestinationType(const TriggerStruct &trigger)
+{
+	switch (trigger._tmsg) {
+	case WM_DIABNEXTLVL:
+		return GetLevelType(currlevel + 1);
+	case WM_DIABPREVLVL:
+		return GetLevelType(currlevel - 1);
+	case WM_DIABRTNLVL:
+		return ReturnLevelType;
+	case WM_DIABTOWNWARP:
+		return GetLevelType(trigger._tlvl);
+	case WM_DIABTWARPUP:
+		return DTYPE_TOWN;
+	default:
+		return std::nullopt;
+	}
+}
+
+/**
+ * @brief Starts loading the graphics and music of the level behind the closest trigger,
+ * so the level transition doesn't have to wait for them.
+ */
+void PrefetchNearbyTriggerDestination(const Player &player)
+{
+	for (int i = 0; i < numtrigs; i++) {
+		if (player.position.tile.WalkingDistance(trigs[i].position) > TriggerPrefetchDistance)
+			continue;
+		const std::optional<dungeon_type> destination = GetTriggerDestinationType(trigs[i]);
+		if (!destination || *destination == DTYPE_NONE)
+			continue;
+
+		const TriggerPrefetchKey key { currlevel, setlevel, *destination };
+		if (PrefetchedTrigger == key)
+			return;
+		PrefetchedTrigger = key;
+
+		ClearPrefetchedAssets();
+		PrefetchLvlGFX(*destination);
+		PrefetchMusic(GetLevelMusic(*destination));
+		return;
+	}
+}
+
 } // namespace
 
 void InitNoTriggers()
@@ -866,6 +928,8 @@ void CheckTriggers()
 {
 	Player &myPlayer = *MyPlayer;
 
+	PrefetchNearbyTriggerDestination(myPlayer);
+
 	if (myPlayer._pmode != PM_STAND)
 		return;
 
@@ -6,9 +6,11 @@
 #include "lighting.h"
 
 #include <algorithm>
+#include <bitset>
 #include <cstdint>
 #include <cstring>
 #include <numeric>
+#include <span>
 #include <string>
 
 #include <expected.hpp>
@@ -23,8 +25,11 @@
 #include "levels/tile_properties.hpp"
 #include "objects.h"
 #include "player.h"
+#include "utils/algorithm/rotate.hpp"
 #include "utils/attributes.h"
+#include "utils/frame_profiler.hpp"
 #include "utils/is_of.hpp"
+#include "utils/static_vector.hpp"
 #include "utils/status_macros.hpp"
 #include "vision.hpp"
 
@@ -38,6 +43,7 @@ int ActiveLightCount;
 std::array<std::array<uint8_t, LightTableSize>, NumLightingLevels> LightTables;
 uint8_t *FullyLitLightTable = nullptr;
 uint8_t *FullyDarkLightTable = nullptr;
+uint32_t LightTablesGeneration;
 std::array<uint8_t, 256> InfravisionTable;
 std::array<uint8_t, 256> StoneTable;
 std::array<uint8_t, 256> PauseTable;
@@ -50,11 +56,135 @@ namespace {
 
 /** @brief Number of supported light radiuses (first radius starts with 0) */
 constexpr size_t NumLightRadiuses = 16;
-/** Falloff tables for the light cone */
-uint8_t LightFalloffs[NumLightRadiuses][128];
+
+using LightFalloffTable = std::array<std::array<uint8_t, 128>, NumLightRadiuses>;
+
+/**
+ * @brief Generates the falloff tables for the light cone.
+ * @param overExposure Quadratic falloff that is brighter near the light, used in the crypt and nest
+ */
+constexpr LightFalloffTable MakeLightFalloffs(bool overExposure)
+{
+	LightFalloffTable falloffs {};
+	const float maxDarkness = 15;
+	const float maxBrightness = 0;
+	for (unsigned radius = 0; radius < NumLightRadiuses; radius++) {
+		const unsigned maxDistance = (radius + 1) * 8;
+		for (unsigned distance = 0; distance < 128; distance++) {
+			if (distance > maxDistance) {
+				falloffs[radius][distance] = 15;
+			} else {
+				const float factor = static_cast<float>(distance) / static_cast<float>(maxDistance);
+				float scaled;
+				if (overExposure) {
+					const float brightness = static_cast<float>(radius) * 1.25F;
+					scaled = factor * factor * brightness + (maxDarkness - brightness);
+					scaled = std::max(maxBrightness, scaled);
+				} else {
+					scaled = factor * maxDarkness;
+				}
+				scaled += 0.5F; // Round up
+				falloffs[radius][distance] = static_cast<uint8_t>(scaled);
+			}
+		}
+	}
+	return falloffs;
+}
+
+constexpr LightFalloffTable LinearLightFalloffs = MakeLightFalloffs(false);
+constexpr LightFalloffTable OverExposedLightFalloffs = MakeLightFalloffs(true);
+
+/** Falloff tables for the light cone of the current level */
+std::span<const std::array<uint8_t, 128>> LightFalloffs = LinearLightFalloffs;
 bool UpdateVision;
-/** interpolations of a 32x32 (16x16 mirrored) light circle moving between tiles in steps of 1/8 of a tile */
-uint8_t LightConeInterpolations[8][8][16][16];
+
+using LightConeTable = std::array<std::array<std::array<std::array<uint8_t, 16>, 16>, 8>, 8>;
+
+LightConeTable MakeLightConeInterpolations()
+{
+	LightConeTable interpolations;
+	for (int offsetY = 0; offsetY < 8; offsetY++) {
+		for (int offsetX = 0; offsetX < 8; offsetX++) {
+			for (int y = 0; y < 16; y++) {
+				for (int x = 0; x < 16; x++) {
+					const int a = ((8 * x) - offsetX);
+					const int b = ((8 * y) - offsetY);
+					interpolations[offsetX][offsetY][x][y] = static_cast<uint8_t>(sqrt((a * a) + (b * b)));
+				}
+			}
+		}
+	}
+	return interpolations;
+}
+
+/**
+ * interpolations of a 32x32 (16x16 mirrored) light circle moving between tiles in steps of 1/8 of a tile
+ *
+ * Generated once on startup, the 16K square roots are more than some compilers allow in a constant expression.
+ */
+const LightConeTable LightConeInterpolations = MakeLightConeInterpolations();
+
+using LightTableArray = std::array<std::array<uint8_t, LightTableSize>, NumLightingLevels>;
+
+/** @brief Generates 16 gradually darker translation tables, the last one pitch black. */
+constexpr LightTableArray MakeBaseLightTables()
+{
+	LightTableArray lightTables {};
+	constexpr uint8_t Black = 0;
+	constexpr uint8_t White = 255;
+	for (size_t shade = 0; shade < LightsMax; shade++) {
+		std::array<uint8_t, LightTableSize> &lightTable = lightTables[shade];
+		size_t colorIndex = 0;
+		for (const unsigned steps : { 16, 16, 16, 16, 16, 16, 16, 16, 8, 8, 8, 8, 16, 16, 16, 16, 16, 16 }) {
+			const unsigned shading = static_cast<unsigned>(shade) * steps / 16;
+			const unsigned shadeStart = static_cast<unsigned>(colorIndex);
+			const unsigned shadeEnd = shadeStart + steps - 1;
+			for (unsigned step = 0; step < steps; step++) {
+				if (colorIndex == Black) {
+					lightTable[colorIndex++] = Black;
+					continue;
+				}
+				unsigned color = shadeStart + step + shading;
+				if (color > shadeEnd || color == White)
+					color = Black;
+				lightTable[colorIndex++] = static_cast<uint8_t>(color);
+			}
+		}
+	}
+	return lightTables;
+}
+
+constexpr LightTableArray BaseLightTables = MakeBaseLightTables();
+
+/** @brief How far `DoLighting` can reach from the tile of a light, including the shift for negative offsets. */
+constexpr int LightReach = 16;
+
+struct LightArea {
+	int minX;
+	int minY;
+	int maxX;
+	int maxY;
+
+	[[nodiscard]] bool intersects(const LightArea &other) const
+	{
+		return minX <= other.maxX && other.minX <= maxX && minY <= other.maxY && other.minY <= maxY;
+	}
+};
+
+LightArea GetLightArea(Point position, int radius)
+{
+	return { position.x - radius, position.y - radius, position.x + radius, position.y + radius };
+}
+
+/**
+ * @brief Whether `ProcessLightList` has to redo every light, e.g. after `dLight` was reset.
+ *
+ * Otherwise `dLight` holds the darkest of `dPreLight` and all active lights for every tile,
+ * and only the lights that changed or overlap the tiles restored by `DoUnLight` have to be redone.
+ */
+bool RelightAllLights = true;
+/** @brief Lights that were added or changed since the last `ProcessLightList`. */
+std::bitset<MAXLIGHTS> PendingLights;
 
 void RotateRadius(DisplacementOf<int8_t> &offset, DisplacementOf<int8_t> &dist, DisplacementOf<int8_t> &light, DisplacementOf<int8_t> &block)
 {
@@ -218,7 +348,9 @@ void DoVision(Point position, uint8_t radius, MapExplorationType doAutomap, bool
 		return InDungeonBounds(rayPoint);
 	};
 
-	DoVision(position, radius, markVisibleFn, markTransparentFn, passesLightFn, inBoundsFn);
+	DoVisionFlags(position, doAutomap, visible);
+	for (int octant = 0; octant < NumVisionOctants; octant++)
+		DoVisionOctant(position, radius, octant, markVisibleFn, markTransparentFn, passesLightFn, inBoundsFn);
 }
 
 tl::expected<void, std::string> LoadTrns()
@@ -230,31 +362,9 @@ tl::expected<void, std::string> LoadTrns()
 
 void MakeLightTable()
 {
-	// Generate 16 gradually darker translation tables for doing lighting
-	uint8_t shade = 0;
-	constexpr uint8_t Black = 0;
-	constexpr uint8_t White = 255;
-	for (auto &lightTable : LightTables) {
-		uint8_t colorIndex = 0;
-		for (const uint8_t steps : { 16, 16, 16, 16, 16, 16, 16, 16, 8, 8, 8, 8, 16, 16, 16, 16, 16, 16 }) {
-			const uint8_t shading = shade * steps / 16;
-			const uint8_t shadeStart = colorIndex;
-			const uint8_t shadeEnd = shadeStart + steps - 1;
-			for (uint8_t step = 0; step < steps; step++) {
-				if (colorIndex == Black) {
-					lightTable[colorIndex++] = Black;
-					continue;
-				}
-				int color = shadeStart + step + shading;
-				if (color > shadeEnd || color == White)
-					color = Black;
-				lightTable[colorIndex++] = color;
-			}
-		}
-		shade++;
-	}
-
-	LightTables[15] = {}; // Make last shade pitch black
+	// Only the level specific colors are patched after the generated tables are copied
+	LightTables = BaseLightTables;
+	++LightTablesGeneration;
 	FullyLitLightTable = LightTables[0].data();
 	FullyDarkLightTable = LightTables[LightsMax].data();
 
@@ -287,44 +397,8 @@ void MakeLightTable()
 	assert((FullyLitLightTable != nullptr) == (LightTables[0][0] == 0 && std::adjacent_find(LightTables[0].begin(), LightTables[0].end() - 1, [](auto x, auto y) { return (x + 1) != y; }) == LightTables[0].end() - 1));
 	assert((FullyDarkLightTable != nullptr) == (std::all_of(LightTables[LightsMax].begin(), LightTables[LightsMax].end(), [](auto x) { return x == 0; })));
 
-	// Generate light falloffs ranges
-	const float maxDarkness = 15;
-	const float maxBrightness = 0;
-	for (unsigned radius = 0; radius < NumLightRadiuses; radius++) {
-		const unsigned maxDistance = (radius + 1) * 8;
-		for (unsigned distance = 0; distance < 128; distance++) {
-			if (distance > maxDistance) {
-				LightFalloffs[radius][distance] = 15;
-			} else {
-				const float factor = static_cast<float>(distance) / static_cast<float>(maxDistance);
-				float scaled;
-				if (IsAnyOf(leveltype, DTYPE_NEST, DTYPE_CRYPT)) {
-					// quardratic falloff with over exposure
-					const float brightness = static_cast<float>(radius) * 1.25F;
-					scaled = factor * factor * brightness + (maxDarkness - brightness);
-					scaled = std::max(maxBrightness, scaled);
-				} else {
-					// Leaner falloff
-					scaled = factor * maxDarkness;
-				}
-				scaled += 0.5F; // Round up
-				LightFalloffs[radius][distance] = static_cast<uint8_t>(scaled);
-			}
-		}
-	}
-
-	// Generate the light cone interpolations
-	for (int offsetY = 0; offsetY < 8; offsetY++) {
-		for (int offsetX = 0; offsetX < 8; offsetX++) {
-			for (int y = 0; y < 16; y++) {
-				for (int x = 0; x < 16; x++) {
-					const int a = ((8 * x) - offsetX);
-					const int b = ((8 * y) - offsetY);
-					LightConeInterpolations[offsetX][offsetY][x][y] = static_cast<uint8_t>(sqrt((a * a) + (b * b)));
-				}
-			}
-		}
-	}
+	// Quadratic falloff with over exposure in the crypt and nest, linear everywhere else
+	LightFalloffs = IsAnyOf(leveltype, DTYPE_NEST, DTYPE_CRYPT) ? OverExposedLightFalloffs : LinearLightFalloffs;
 }
 
 #ifdef _DEBUG
@@ -337,7 +411,7 @@ void ToggleLighting()
 		return;
 	}
 
-	memcpy(dLight, dPreLight, sizeof(dLight));
+	RestorePreLighting();
 	for (const Player &player : Players) {
 		if (player.plractive && player.isOnActiveLevel()) {
 			DoLighting(player.position.tile, player._pLightRad, {});
@@ -358,6 +432,14 @@ void InitLighting()
 	std::iota(ActiveLights.begin(), ActiveLights.end(), uint8_t { 0 });
 	VisionActive = {};
 	TransList = {};
+	RelightAllLights = true;
+	PendingLights.reset();
+}
+
+void RestorePreLighting()
+{
+	memcpy(dLight, dPreLight, sizeof(dLight));
+	RelightAllLights = true;
 }
 
 int AddLight(Point position, uint8_t radius)
@@ -376,6 +458,7 @@ int AddLight(Point position, uint8_t radius)
 	light.position.offset = { 0, 0 };
 	light.isInvalid = false;
 	light.hasChanged = false;
+	PendingLights.set(lid);
 
 	UpdateLighting = true;
 
@@ -474,35 +557,52 @@ void ChangeLight(int i, Point position, uint8_t radius)
 
 void ProcessLightList()
 {
+	DVL_PROFILE_ZONE("ProcessLightList");
 #ifdef _DEBUG
 	if (DisableLighting)
 		return;
 #endif
 	if (!UpdateLighting)
 		return;
+
+	// Tiles restored to `dPreLight` lose the contributions of all lights, not only the ones that changed.
+	StaticVector<LightArea, MAXLIGHTS * 2> restoredAreas;
 	for (int i = 0; i < ActiveLightCount; i++) {
-		Light &light = Lights[ActiveLights[i]];
+		const uint8_t lid = ActiveLights[i];
+		Light &light = Lights[lid];
 		if (light.isInvalid) {
 			DoUnLight(light.position.tile, light.radius);
+			restoredAreas.push_back(GetLightArea(light.position.tile, light.radius + 2));
 		}
 		if (light.hasChanged) {
 			DoUnLight(light.position.old, light.oldRadius);
+			restoredAreas.push_back(GetLightArea(light.position.old, light.oldRadius + 2));
 			light.hasChanged = false;
+			PendingLights.set(lid);
 		}
 	}
 	for (int i = 0; i < ActiveLightCount; i++) {
-		const Light &light = Lights[ActiveLights[i]];
+		const uint8_t lid = ActiveLights[i];
+		const Light &light = Lights[lid];
 		if (light.isInvalid) {
 			ActiveLightCount--;
 			std::swap(ActiveLights[ActiveLightCount], ActiveLights[i]);
 			i--;
 			continue;
 		}
+		if (!RelightAllLights && !PendingLights.test(lid)) {
+			// Lighting only ever darkens tiles to the minimum, so redoing an unchanged light only matters where tiles were restored.
+			const LightArea reach = GetLightArea(light.position.tile, LightReach);
+			if (std::none_of(restoredAreas.begin(), restoredAreas.end(), [&reach](const LightArea &area) { return area.intersects(reach); }))
+				continue;
+		}
 		if (TileHasAny(light.position.tile, TileProperties::Solid))
 			continue; // Monster hidden in a wall, don't spoil the surprise
 		DoLighting(light.position.tile, light.radius, light.position.offset);
 	}
 
+	RelightAllLights = false;
+	PendingLights.reset();
 	UpdateLighting = false;
 }
 
@@ -587,8 +687,9 @@ void lighting_color_cycling()
 {
 	for (auto &lightTable : LightTables) {
 		// shift elements between indexes 1-31 to left
-		std::rotate(lightTable.begin() + 1, lightTable.begin() + 2, lightTable.begin() + 32);
+		RotateLeftByOne(std::span(lightTable).subspan(1, 31));
 	}
+	++LightTablesGeneration;
 }
 
 } // namespace devilution
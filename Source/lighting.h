@@ -37,14 +37,16 @@ struct Light {
 
 extern Light VisionList[MAXVISION];
 extern std::array<bool, MAXVISION> VisionActive;
-extern Light Lights[MAXLIGHTS];
-extern std::array<uint8_t, MAXLIGHTS> ActiveLights;
-extern int ActiveLightCount;
+extern DVL_API_FOR_TEST Light Lights[MAXLIGHTS];
+extern DVL_API_FOR_TEST std::array<uint8_t, MAXLIGHTS> ActiveLights;
+extern DVL_API_FOR_TEST int ActiveLightCount;
 extern DVL_API_FOR_TEST std::array<std::array<uint8_t, LightTableSize>, NumLightingLevels> LightTables;
 /** @brief Contains a pointer to a light table that is fully lit (no color mapping is required). Can be null in hell. */
 extern DVL_API_FOR_TEST uint8_t *FullyLitLightTable;
 /** @brief Contains a pointer to a light table that is fully dark (every color result to 0/black). Can be null in hellfire levels. */
 extern DVL_API_FOR_TEST uint8_t *FullyDarkLightTable;
+/** @brief Incremented whenever `LightTables` are rebuilt or cycled. */
+extern uint32_t LightTablesGeneration;
 extern std::array<uint8_t, 256> InfravisionTable;
 extern std::array<uint8_t, 256> StoneTable;
 extern std::array<uint8_t, 256> PauseTable;
@@ -63,6 +65,10 @@ void MakeLightTable();
 void ToggleLighting();
 #endif
 void InitLighting();
+/**
+ * @brief Resets `dLight` to the static lighting of the level, the next `ProcessLightList` redoes all lights.
+ */
+void RestorePreLighting();
 int AddLight(Point position, uint8_t radius);
 void AddUnLight(int i);
 void ChangeLightRadius(int i, uint8_t radius);
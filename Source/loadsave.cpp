@@ -5,12 +5,19 @@
  */
 #include "loadsave.h"
 
+#include <algorithm>
 #include <climits>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <numeric>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include <ankerl/unordered_dense.h>
 #include <expected.hpp>
@@ -21,6 +28,7 @@
 #include "cursor.h"
 #include "dead.h"
 #include "doom.h"
+#include "engine/demomode.h"
 #include "engine/point.hpp"
 #include "engine/random.hpp"
 #include "game_mode.hpp"
@@ -42,7 +50,10 @@
 #include "utils/endian_swap.hpp"
 #include "utils/is_of.hpp"
 #include "utils/language.h"
+#include "utils/memory_stats.hpp"
 #include "utils/status_macros.hpp"
+#include "utils/str_cat.hpp"
+#include "utils/task_graph.hpp"
 
 namespace devilution {
 
@@ -95,10 +106,24 @@ void TerminateUtf8(char *str, size_t maxLength)
 	str[utf8Length] = '\0';
 }
 
+template <class T, bool BigEndian>
+T LoadValue(const std::byte *src)
+{
+	if constexpr (sizeof(T) == 1) {
+		return static_cast<T>(src[0]);
+	} else if constexpr (sizeof(T) == 2) {
+		return static_cast<T>(BigEndian ? LoadBE16(src) : LoadLE16(src));
+	} else {
+		static_assert(sizeof(T) == 4, "Unsupported value size");
+		return static_cast<T>(BigEndian ? LoadBE32(src) : LoadLE32(src));
+	}
+}
+
 class LoadHelper {
 	std::unique_ptr<std::byte[]> m_buffer_;
 	size_t m_cur_ = 0;
 	size_t m_size_;
+	TrackedMemory<MemoryTag::SaveBuffers> m_tracked_;
 
 	template <class T>
 	T Next()
@@ -114,6 +139,45 @@ class LoadHelper {
 		return value;
 	}
 
+	/**
+	 * @brief Consumes `size` bytes at once.
+	 * @return The start of the bytes, or nullptr if the file ends before them.
+	 */
+	const std::byte *NextBlock(size_t size)
+	{
+		if (!IsValid(size))
+			return nullptr;
+
+		const std::byte *block = &m_buffer_[m_cur_];
+		m_cur_ += size;
+		return block;
+	}
+
+	template <class T, bool BigEndian, class Fn>
+	void NextValues(size_t count, Fn &&fn)
+	{
+		const std::byte *block = NextBlock(sizeof(T) * count);
+		if (block == nullptr) {
+			for (size_t i = 0; i < count; i++)
+				fn(i, T { 0 });
+			return;
+		}
+		for (size_t i = 0; i < count; i++)
+			fn(i, LoadValue<T, BigEndian>(block + i * sizeof(T)));
+	}
+
+	template <class T, bool BigEndian, class TDest, size_t Width, size_t Height, class Convert>
+	void NextLayer(TDest (&layer)[Width][Height], Convert &&convert)
+	{
+		// Layers are saved row by row, while they are indexed by column first in memory
+		const std::byte *block = NextBlock(sizeof(T) * Width * Height);
+		for (size_t j = 0; j < Height; j++) {
+			const std::byte *row = block != nullptr ? block + j * Width * sizeof(T) : nullptr;
+			for (size_t i = 0; i < Width; i++)
+				layer[i][j] = convert(row != nullptr ? LoadValue<T, BigEndian>(row + i * sizeof(T)) : T { 0 });
+		}
+	}
+
 public:
 	LoadHelper(std::optional<SaveReader> archive, const char *szFileName)
 	{
@@ -121,6 +185,42 @@ public:
 			m_buffer_ = ReadArchive(*archive, szFileName, &m_size_);
 		else
 			m_buffer_ = nullptr;
+		if (m_buffer_ != nullptr)
+			m_tracked_ = TrackedMemory<MemoryTag::SaveBuffers>(m_size_);
+	}
+
+	LoadHelper(SaveReader &archive, const char *szFileName)
+	    : m_buffer_(ReadArchive(archive, szFileName, &m_size_))
+	{
+		if (m_buffer_ != nullptr)
+			m_tracked_ = TrackedMemory<MemoryTag::SaveBuffers>(m_size_);
+	}
+
+	/** @brief Reads from file contents that `ReadArchive` already decoded. */
+	LoadHelper(std::unique_ptr<std::byte[]> buffer, size_t size)
+	    : m_buffer_(std::move(buffer))
+	    , m_size_(size)
+	{
+		if (m_buffer_ != nullptr)
+			m_tracked_ = TrackedMemory<MemoryTag::SaveBuffers>(m_size_);
+	}
+
+	/** @brief Reads from a copy of already decoded file contents. */
+	explicit LoadHelper(std::span<const std::byte> contents)
+	    : m_buffer_(new std::byte[contents.size()])
+	    , m_size_(contents.size())
+	    , m_tracked_(contents.size())
+	{
+		std::memcpy(m_buffer_.get(), contents.data(), contents.size());
+	}
+
+	/**
+	 * @brief Hash of the whole file, matches the one `SaveHelper` compares with when writing the same contents.
+	 */
+	[[nodiscard]] uint64_t ContentHash() const
+	{
+		return ankerl::unordered_dense::hash<std::string_view> {}(
+		    std::string_view(reinterpret_cast<const char *>(m_buffer_.get()), m_buffer_ != nullptr ? m_size_ : 0));
 	}
 
 	bool IsValid(size_t size = 1)
@@ -174,6 +274,17 @@ public:
 		return static_cast<TDesired>(std::clamp<TSource>(value, std::numeric_limits<TDesired>::min(), std::numeric_limits<TDesired>::max()));
 	}
 
+	/**
+	 * @brief Consumes the next 4 bytes only if they are the given magic number.
+	 */
+	bool NextMagic(uint32_t magic)
+	{
+		if (!IsValid(sizeof(magic)) || LoadLE32(&m_buffer_[m_cur_]) != magic)
+			return false;
+		m_cur_ += sizeof(magic);
+		return true;
+	}
+
 	bool NextBool8()
 	{
 		return Next<uint8_t>() != 0;
@@ -183,6 +294,47 @@ public:
 	{
 		return Next<uint32_t>() != 0;
 	}
+
+	/**
+	 * @brief Reads `count` consecutive values with a single bounds check.
+	 *
+	 * Values past the end of the file read as 0, as with `NextLE`.
+	 * @param fn `void(size_t index, T value)`, called for each value in order.
+	 */
+	template <class T, class Fn>
+	void NextLEValues(size_t count, Fn &&fn)
+	{
+		NextValues<T, false>(count, std::forward<Fn>(fn));
+	}
+
+	template <class T, class Fn>
+	void NextBEValues(size_t count, Fn &&fn)
+	{
+		NextValues<T, true>(count, std::forward<Fn>(fn));
+	}
+
+	/**
+	 * @brief Reads a whole dungeon layer with a single bounds check.
+	 *
+	 * @param convert `TDest(T value)`, maps the saved value to the layer's type.
+	 */
+	template <class T, class TDest, size_t Width, size_t Height, class Convert>
+	void NextLELayer(TDest (&layer)[Width][Height], Convert &&convert)
+	{
+		NextLayer<T, false>(layer, std::forward<Convert>(convert));
+	}
+
+	template <class T, class TDest, size_t Width, size_t Height>
+	void NextLELayer(TDest (&layer)[Width][Height])
+	{
+		NextLayer<T, false>(layer, [](T value) { return static_cast<TDest>(value); });
+	}
+
+	template <class T, class TDest, size_t Width, size_t Height, class Convert>
+	void NextBELayer(TDest (&layer)[Width][Height], Convert &&convert)
+	{
+		NextLayer<T, true>(layer, std::forward<Convert>(convert));
+	}
 };
 
 class SaveHelper {
@@ -191,13 +343,20 @@ class SaveHelper {
 	std::unique_ptr<std::byte[]> m_buffer_;
 	size_t m_cur_ = 0;
 	size_t m_capacity_;
+	std::optional<uint64_t> *m_lastHash_;
+	TrackedMemory<MemoryTag::SaveBuffers> m_tracked_;
 
 public:
-	SaveHelper(SaveWriter &mpqWriter, const char *szFileName, size_t bufferLen)
+	/**
+	 * @param lastHash If given, the file is only written if its contents hash differently, the hash is updated.
+	 */
+	SaveHelper(SaveWriter &mpqWriter, const char *szFileName, size_t bufferLen, std::optional<uint64_t> *lastHash = nullptr)
 	    : m_mpqWriter(mpqWriter)
 	    , m_szFileName_(szFileName)
 	    , m_buffer_(new std::byte[codec_get_encoded_len(bufferLen)])
 	    , m_capacity_(bufferLen)
+	    , m_lastHash_(lastHash)
+	    , m_tracked_(codec_get_encoded_len(bufferLen))
 	{
 	}
 
@@ -245,8 +404,21 @@ public:
 		WriteBytes(&value, sizeof(value));
 	}
 
+	/** @brief What has been written so far, before it is encoded. */
+	[[nodiscard]] std::span<const std::byte> Contents() const
+	{
+		return { m_buffer_.get(), m_cur_ };
+	}
+
 	~SaveHelper()
 	{
+		if (m_lastHash_ != nullptr) {
+			const uint64_t hash = ankerl::unordered_dense::hash<std::string_view> {}(
+			    std::string_view(reinterpret_cast<const char *>(m_buffer_.get()), m_cur_));
+			if (*m_lastHash_ == hash)
+				return;
+			*m_lastHash_ = hash;
+		}
 		const auto encodedLen = codec_get_encoded_len(m_cur_);
 		const char *const password = pfile_get_password();
 		codec_encode(m_buffer_.get(), m_cur_, encodedLen, password);
@@ -782,8 +954,7 @@ bool gbSkipSync = false;
 
 void LoadMonsters(LoadHelper &file, ankerl::unordered_dense::set<unsigned> &removedMonsterIds, const bool applyLight, LevelConversionData *levelConversionData)
 {
-	for (unsigned &monsterId : ActiveMonsters)
-		monsterId = file.NextBE<uint32_t>();
+	file.NextBEValues<uint32_t>(MaxMonsters, [](size_t i, uint32_t monsterId) { ActiveMonsters[i] = monsterId; });
 
 	for (size_t i = 0; i < ActiveMonsterCount;) {
 		Monster &monster = Monsters[ActiveMonsters[i]];
@@ -1064,6 +1235,68 @@ void GetPermLevelNames(char *szPerm)
 	return GetLevelNames("perm", szPerm);
 }
 
+/**
+ * @brief Hashes of the level files last written to the current save, by level name without the temp/perm prefix.
+ *
+ * A level is read back from its temp file if there is one and from its perm file otherwise.
+ * `RenameTempToPerm` only moves the contents from one to the other, so the hashes stay valid across it.
+ */
+ankerl::unordered_dense::map<std::string, std::optional<uint64_t>> SavedLevelHashes;
+
+std::optional<uint64_t> &GetSavedLevelHash()
+{
+	char szName[MaxMpqPathSize];
+	GetLevelNames("", szName);
+	return SavedLevelHashes[szName];
+}
+
+struct LevelInMemory {
+	std::string name;
+	std::vector<std::byte> contents;
+};
+
+/**
+ * @brief The decoded contents of the level files last written to the current save, most recent first, named like `SavedLevelHashes`.
+ *
+ * Two levels are kept, so that a trip to town and back through a portal reads both levels from here,
+ * without waiting for the save to be written and decoding the file again.
+ * Like the hashes, they are valid as long as the level files aren't removed from the save.
+ */
+std::vector<LevelInMemory> LevelsInMemory;
+constexpr size_t MaxLevelsInMemory = 2;
+
+void KeepLevelInMemory(std::span<const std::byte> contents)
+{
+	char szName[MaxMpqPathSize];
+	GetLevelNames("", szName);
+	auto it = c_find_if(LevelsInMemory, [&](const LevelInMemory &level) { return level.name == szName; });
+	if (it == LevelsInMemory.end()) {
+		if (LevelsInMemory.size() == MaxLevelsInMemory)
+			LevelsInMemory.pop_back();
+		it = LevelsInMemory.insert(LevelsInMemory.begin(), LevelInMemory { szName, {} });
+	} else {
+		std::rotate(LevelsInMemory.begin(), it, it + 1);
+		it = LevelsInMemory.begin();
+	}
+	it->contents.assign(contents.begin(), contents.end());
+}
+
+LoadHelper OpenLevelFile()
+{
+	char szName[MaxMpqPathSize];
+	GetLevelNames("", szName);
+	for (const LevelInMemory &level : LevelsInMemory) {
+		if (level.name == szName)
+			return LoadHelper(level.contents);
+	}
+
+	std::optional<SaveReader> archive = OpenSaveArchive(gSaveNumber);
+	GetTempLevelNames(szName);
+	if (!archive || !archive->HasFile(szName))
+		GetPermLevelNames(szName);
+	return LoadHelper(std::move(archive), szName);
+}
+
 bool LevelFileExists(SaveWriter &archive)
 {
 	char szName[MaxMpqPathSize];
@@ -1857,6 +2090,144 @@ void SaveDroppedItemLocations(SaveHelper &file, const ankerl::unordered_dense::m
 	}
 }
 
+/**
+ * @brief Magic number at the start of level files in the compact format.
+ *
+ * Level files in the original format start with either the corpse of the top left tile, which is outside
+ * of the playable area, or with the big-endian monster count, so their first byte is always 0.
+ */
+constexpr uint32_t CompactLevelMagic = LoadLE32("DLVL");
+constexpr uint8_t CompactLevelVersion = 0;
+
+/**
+ * @brief Version of the save format, it replaces the last character of the game file's magic number.
+ *
+ * Version 0 is the vanilla format. Version 1 may have level files in the compact format, so builds
+ * that only know the vanilla format reject it in `IsHeaderValid` rather than misreading its levels.
+ */
+constexpr uint8_t SaveVersion = 1;
+
+uint32_t GetSaveMagic(uint32_t vanillaMagic, uint8_t version)
+{
+	if (version == 0)
+		return vanillaMagic;
+	return (vanillaMagic & 0x00FFFFFF) | (static_cast<uint32_t>('0' + version) << 24);
+}
+
+/**
+ * @brief Demos compare their saves byte for byte with references recorded in the vanilla format, so they keep writing it.
+ */
+bool SaveInVanillaFormat()
+{
+	return demo::IsRunning() || demo::IsRecording();
+}
+
+template <class T, class TSource, size_t Width, size_t Height, class Convert>
+void SaveLayer(SaveHelper &file, const TSource (&layer)[Width][Height], Convert &&convert)
+{
+	for (size_t j = 0; j < Height; j++) {
+		for (size_t i = 0; i < Width; i++)
+			file.WriteLE<T>(convert(layer[i][j]));
+	}
+}
+
+template <class T, class TSource, size_t Width, size_t Height>
+void SaveLayer(SaveHelper &file, const TSource (&layer)[Width][Height])
+{
+	SaveLayer<T>(file, layer, [](TSource value) { return static_cast<T>(value); });
+}
+
+/**
+ * @brief Minimum number of empty cells that end a run of a sparse layer, shorter gaps are cheaper to save as part of the run.
+ */
+constexpr size_t MinSparseLayerGap = 4;
+
+/**
+ * @brief Saves a dungeon layer as the runs of non-empty cells, in the order of the original format.
+ *
+ * Each run is saved as the number of empty cells before it, its length and its values.
+ * The layer ends with the run that reaches its last cell, which may be empty.
+ *
+ * @param convert `T(TSource)`, maps the cell to the saved value, 0 is empty.
+ */
+template <class T, class TSource, size_t Width, size_t Height, class Convert>
+void SaveSparseLayer(SaveHelper &file, const TSource (&layer)[Width][Height], Convert &&convert)
+{
+	constexpr size_t NumCells = Width * Height;
+	static_assert(NumCells <= std::numeric_limits<uint16_t>::max());
+	const auto cell = [&](size_t k) -> T { return convert(layer[k % Width][k / Width]); };
+
+	size_t k = 0;
+	while (k < NumCells) {
+		size_t start = k;
+		while (start < NumCells && cell(start) == 0)
+			start++;
+		size_t end = start;
+		for (size_t c = start, gap = 0; c < NumCells && gap < MinSparseLayerGap; c++) {
+			if (cell(c) == 0) {
+				gap++;
+			} else {
+				gap = 0;
+				end = c + 1;
+			}
+		}
+		file.WriteLE<uint16_t>(static_cast<uint16_t>(start - k));
+		file.WriteLE<uint16_t>(static_cast<uint16_t>(end - start));
+		for (size_t c = start; c < end; c++)
+			file.WriteLE<T>(cell(c));
+		k = end;
+	}
+}
+
+template <class T, class TSource, size_t Width, size_t Height>
+void SaveSparseLayer(SaveHelper &file, const TSource (&layer)[Width][Height])
+{
+	SaveSparseLayer<T>(file, layer, [](TSource value) { return static_cast<T>(value); });
+}
+
+/**
+ * @brief Loads a dungeon layer saved by `SaveSparseLayer`.
+ *
+ * Cells that are missing from a truncated or corrupt layer are left empty.
+ * @param convert `TDest(T)`, maps the saved value to the layer's type.
+ */
+template <class T, class TDest, size_t Width, size_t Height, class Convert>
+void LoadSparseLayer(LoadHelper &file, TDest (&layer)[Width][Height], Convert &&convert)
+{
+	constexpr size_t NumCells = Width * Height;
+	std::fill_n(&layer[0][0], NumCells, convert(T { 0 }));
+
+	size_t k = 0;
+	while (k < NumCells && file.IsValid()) {
+		const size_t gap = file.NextLE<uint16_t>();
+		const size_t length = file.NextLE<uint16_t>();
+		if (gap + length > NumCells - k)
+			break;
+		k += gap;
+		file.NextLEValues<T>(length, [&](size_t i, T value) {
+			layer[(k + i) % Width][(k + i) / Width] = convert(value);
+		});
+		k += length;
+	}
+}
+
+template <class T, class TDest, size_t Width, size_t Height>
+void LoadSparseLayer(LoadHelper &file, TDest (&layer)[Width][Height])
+{
+	LoadSparseLayer<T>(file, layer, [](T value) { return static_cast<TDest>(value); });
+}
+
+DungeonFlag LoadSavedFlags(uint8_t flags)
+{
+	return static_cast<DungeonFlag>(flags) & DungeonFlag::LoadedFlags;
+}
+
+uint8_t LoadAutomapView(uint8_t view)
+{
+	const auto automapView = static_cast<MapExplorationType>(view);
+	return automapView == MAP_EXP_OLD ? MAP_EXP_SELF : automapView;
+}
+
 constexpr uint32_t VersionAdditionalMissiles = 0;
 
 void SaveAdditionalMissiles(SaveWriter &saveWriter)
@@ -1870,7 +2241,7 @@ void SaveAdditionalMissiles(SaveWriter &saveWriter)
 
 	if (missileCountAdditional > 0) {
 		auto it = Missiles.cbegin();
-		// std::list::const_iterator doesn't provide operator+() :/ using std::advance to get past the missiles we've already saved
+		// Missiles only provides forward iterators, using std::advance to get past the missiles we've already saved
 		std::advance(it, MaxMissilesForSaveGame);
 		for (; it != Missiles.cend(); it++) {
 			SaveMissile(&file, *it);
@@ -1936,13 +2307,21 @@ void SaveLevel(SaveWriter &saveWriter, LevelConversionData *levelConversionData)
 
 	char szName[MaxMpqPathSize];
 	GetTempLevelNames(szName);
-	SaveHelper file(saveWriter, szName, 256 * 1024);
+	// Leaving a level that didn't change since it was last saved, e.g. walking through it again, doesn't need a write.
+	// Converted levels are always written, they must replace the old format.
+	SaveHelper file(saveWriter, szName, 256 * 1024, levelConversionData == nullptr ? &GetSavedLevelHash() : nullptr);
+
+	const bool vanilla = SaveInVanillaFormat();
+	if (!vanilla) {
+		file.WriteLE<uint32_t>(CompactLevelMagic);
+		file.WriteLE<uint8_t>(CompactLevelVersion);
+	}
 
 	if (leveltype != DTYPE_TOWN) {
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				file.WriteLE<int8_t>(dCorpse[i][j]);
-		}
+		if (vanilla)
+			SaveLayer<int8_t>(file, dCorpse);
+		else
+			SaveSparseLayer<int8_t>(file, dCorpse);
 	}
 
 	file.WriteBE(static_cast<int32_t>(ActiveMonsterCount));
@@ -1967,36 +2346,33 @@ void SaveLevel(SaveWriter &saveWriter, LevelConversionData *levelConversionData)
 		}
 	}
 
-	auto itemIndexes = SaveDroppedItems(file);
-
-	for (int j = 0; j < MAXDUNY; j++) {
-		for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-			file.WriteLE<uint8_t>(static_cast<uint8_t>(dFlags[i][j] & DungeonFlag::SavedFlags));
-	}
-	SaveDroppedItemLocations(file, itemIndexes);
+	const auto itemIndexes = SaveDroppedItems(file);
 
-	if (leveltype != DTYPE_TOWN) {
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				file.WriteBE<int32_t>(dMonster[i][j]);
-		}
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				file.WriteLE<int8_t>(dObject[i][j]);
-		}
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				file.WriteLE<uint8_t>(dLight[i][j]);
-		}
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				file.WriteLE<uint8_t>(dPreLight[i][j]);
+	const auto savedFlags = [](DungeonFlag flags) { return static_cast<uint8_t>(flags & DungeonFlag::SavedFlags); };
+	if (vanilla) {
+		SaveLayer<uint8_t>(file, dFlags, savedFlags);
+		SaveDroppedItemLocations(file, itemIndexes);
+		if (leveltype != DTYPE_TOWN) {
+			for (int j = 0; j < MAXDUNY; j++) {
+				for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
+					file.WriteBE<int32_t>(dMonster[i][j]);
+			}
+			SaveLayer<int8_t>(file, dObject);
+			SaveLayer<uint8_t>(file, dLight);
+			SaveLayer<uint8_t>(file, dPreLight);
+			SaveLayer<uint8_t>(file, AutomapView);
 		}
-		for (int j = 0; j < DMAXY; j++) {
-			for (int i = 0; i < DMAXX; i++) // NOLINT(modernize-loop-convert)
-				file.WriteLE<uint8_t>(AutomapView[i][j]);
+	} else {
+		// The item indexes and dLight are not saved, they are recreated from the items and lights when loading
+		SaveSparseLayer<uint8_t>(file, dFlags, savedFlags);
+		if (leveltype != DTYPE_TOWN) {
+			SaveSparseLayer<int16_t>(file, dMonster);
+			SaveSparseLayer<int8_t>(file, dObject);
+			SaveSparseLayer<uint8_t>(file, dPreLight);
+			SaveSparseLayer<uint8_t>(file, AutomapView);
 		}
 	}
+	KeepLevelInMemory(file.Contents());
 
 	if (!setlevel)
 		myPlayer._pLvlVisited[currlevel] = true;
@@ -2004,22 +2380,20 @@ void SaveLevel(SaveWriter &saveWriter, LevelConversionData *levelConversionData)
 		myPlayer._pSLvlVisited[setlvlnum] = true;
 }
 
-tl::expected<void, std::string> LoadLevel(LevelConversionData *levelConversionData)
+tl::expected<void, std::string> LoadLevel(LoadHelper &file, LevelConversionData *levelConversionData)
 {
-	char szName[MaxMpqPathSize];
-	std::optional<SaveReader> archive = OpenSaveArchive(gSaveNumber);
-	GetTempLevelNames(szName);
-	if (!archive || !archive->HasFile(szName))
-		GetPermLevelNames(szName);
-	LoadHelper file(std::move(archive), szName);
 	if (!file.IsValid())
 		return tl::make_unexpected(std::string(_("Unable to open save file archive")));
 
+	const bool compact = file.NextMagic(CompactLevelMagic);
+	if (compact && file.NextLE<uint8_t>() > CompactLevelVersion)
+		return tl::make_unexpected(std::string(_("Invalid save file")));
+
 	if (leveltype != DTYPE_TOWN) {
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dCorpse[i][j] = file.NextLE<int8_t>();
-		}
+		if (compact)
+			LoadSparseLayer<int8_t>(file, dCorpse);
+		else
+			file.NextLELayer<int8_t>(dCorpse);
 		MoveLightsToCorpses();
 	}
 
@@ -2036,12 +2410,11 @@ tl::expected<void, std::string> LoadLevel(LevelConversionData *levelConversionDa
 			for (size_t i = 0; i < ActiveMonsterCount; i++)
 				RETURN_IF_ERROR(SyncMonsterAnim(Monsters[ActiveMonsters[i]]));
 		}
-		for (int &objectId : ActiveObjects)
-			objectId = file.NextLE<int8_t>();
-		for (int &objectId : AvailableObjects)
-			objectId = file.NextLE<int8_t>();
+		file.NextLEValues<int8_t>(MAXOBJECTS, [](size_t i, int8_t objectId) { ActiveObjects[i] = objectId; });
+		file.NextLEValues<int8_t>(MAXOBJECTS, [](size_t i, int8_t objectId) { AvailableObjects[i] = objectId; });
 		for (int i = 0; i < ActiveObjectCount; i++)
 			LoadObject(file, Objects[ActiveObjects[i]]);
+		WakeObjects();
 		if (!gbSkipSync) {
 			for (int i = 0; i < ActiveObjectCount; i++)
 				SyncObjectAnim(Objects[ActiveObjects[i]]);
@@ -2050,42 +2423,33 @@ tl::expected<void, std::string> LoadLevel(LevelConversionData *levelConversionDa
 
 	LoadDroppedItems(file, savedItemCount);
 
-	for (int j = 0; j < MAXDUNY; j++) {
-		for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-			dFlags[i][j] = static_cast<DungeonFlag>(file.NextLE<uint8_t>()) & DungeonFlag::LoadedFlags;
+	if (compact) {
+		LoadSparseLayer<uint8_t>(file, dFlags, LoadSavedFlags);
+	} else {
+		file.NextLELayer<uint8_t>(dFlags, LoadSavedFlags);
+		// skip dItem indexes, this gets populated in LoadDroppedItems
+		file.Skip<uint8_t>(MAXDUNX * MAXDUNY);
 	}
 
-	// skip dItem indexes, this gets populated in LoadDroppedItems
-	file.Skip<uint8_t>(MAXDUNX * MAXDUNY);
-
 	if (leveltype != DTYPE_TOWN) {
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-			{
-				dMonster[i][j] = file.NextBE<int32_t>();
-				if (dMonster[i][j] > 0 && removedMonsterIds.contains(std::abs(dMonster[i][j]) - 1)) {
-					dMonster[i][j] = 0;
-				}
-			}
-		}
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dObject[i][j] = file.NextLE<int8_t>();
-		}
-		file.Skip<uint8_t>(MAXDUNY * MAXDUNX); // dLight
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dPreLight[i][j] = file.NextLE<uint8_t>();
-		}
-		for (int j = 0; j < DMAXY; j++) {
-			for (int i = 0; i < DMAXX; i++) { // NOLINT(modernize-loop-convert)
-				const auto automapView = static_cast<MapExplorationType>(file.NextLE<uint8_t>());
-				AutomapView[i][j] = automapView == MAP_EXP_OLD ? MAP_EXP_SELF : automapView;
-			}
+		const auto loadMonsterId = [&](int16_t monsterId) -> int16_t {
+			return monsterId > 0 && removedMonsterIds.contains(std::abs(monsterId) - 1) ? 0 : monsterId;
+		};
+		if (compact) {
+			LoadSparseLayer<int16_t>(file, dMonster, loadMonsterId);
+			LoadSparseLayer<int8_t>(file, dObject);
+			LoadSparseLayer<uint8_t>(file, dPreLight);
+			LoadSparseLayer<uint8_t>(file, AutomapView, LoadAutomapView);
+		} else {
+			file.NextBELayer<int32_t>(dMonster, [&](int32_t monsterId) { return loadMonsterId(static_cast<int16_t>(monsterId)); });
+			file.NextLELayer<int8_t>(dObject);
+			file.Skip<uint8_t>(MAXDUNY * MAXDUNX); // dLight
+			file.NextLELayer<uint8_t>(dPreLight);
+			file.NextLELayer<uint8_t>(AutomapView, LoadAutomapView);
 		}
 
 		// No need to load dLight, we can recreate it accurately from LightList
-		memcpy(dLight, dPreLight, sizeof(dLight));                                     // resets the light on entering a level to get rid of incorrect light
+		RestorePreLighting();                                                          // resets the light on entering a level to get rid of incorrect light
 		ChangeLightXY(Players[MyPlayerId].lightId, Players[MyPlayerId].position.tile); // forces player light refresh
 	} else {
 		memset(dLight, 0, sizeof(dLight));
@@ -2108,6 +2472,26 @@ tl::expected<void, std::string> LoadLevel(LevelConversionData *levelConversionDa
 const int DiabloItemSaveSize = 368;
 const int HellfireItemSaveSize = 372;
 
+constexpr size_t StashGridSaveSize = 10 * 10 * sizeof(uint16_t);
+
+/**
+ * @brief Hashes of the stash pages as they were last loaded or saved, by page.
+ *
+ * Only pages whose contents changed are written, so the time it takes to save the stash
+ * depends on how many pages were touched rather than on how many there are.
+ */
+ankerl::unordered_dense::map<unsigned, std::optional<uint64_t>> SavedStashPageHashes;
+
+const char *GetStashFileName()
+{
+	return gbIsMultiplayer ? "mpstashitems" : "spstashitems";
+}
+
+std::string GetStashPageFileName(unsigned page)
+{
+	return StrCat(gbIsMultiplayer ? "mpstashpage" : "spstashpage", page);
+}
+
 bool IsStashSizeValid(size_t stashSize, uint32_t pages, uint32_t itemCount)
 {
 	const size_t itemSize = (gbIsHellfire ? HellfireItemSaveSize : DiabloItemSaveSize);
@@ -2123,10 +2507,48 @@ bool IsStashSizeValid(size_t stashSize, uint32_t pages, uint32_t itemCount)
 	return stashSize == expectedSize;
 }
 
+tl::expected<void, std::string> LoadLevel(LevelConversionData *levelConversionData)
+{
+	LoadHelper file = OpenLevelFile();
+	return LoadLevel(file, levelConversionData);
+}
+
+/** @brief A saved level that `ConvertLevels` rewrites in the current format. */
+struct LevelToConvert {
+	bool isSetLevel;
+	/** @brief `currlevel` of a regular level, `setlvlnum` of a quest level. */
+	int level;
+	dungeon_type type;
+	/** @brief Only open while the batch of the level is read. */
+	std::optional<SaveReader> archive;
+	char fileName[MaxMpqPathSize];
+	std::unique_ptr<std::byte[]> contents;
+	size_t size;
+};
+
+/** @brief Makes `level` the current level, so that the level name and loading functions use it. */
+void SelectLevel(const LevelToConvert &level)
+{
+	setlevel = level.isSetLevel;
+	if (level.isSetLevel)
+		setlvlnum = static_cast<_setlevels>(level.level);
+	else
+		currlevel = static_cast<uint8_t>(level.level);
+	leveltype = level.type;
+}
+
 } // namespace
 
+void ForgetSavedLevelHashes()
+{
+	SavedLevelHashes.clear();
+	LevelsInMemory.clear();
+}
+
 tl::expected<void, std::string> ConvertLevels(SaveWriter &saveWriter)
 {
+	ForgetSavedLevelHashes();
+
 	// Backup current level state
 	const bool tmpSetlevel = setlevel;
 	const _setlevels tmpSetlvlnum = setlvlnum;
@@ -2135,37 +2557,56 @@ tl::expected<void, std::string> ConvertLevels(SaveWriter &saveWriter)
 
 	gbSkipSync = true;
 
-	setlevel = false; // Convert regular levels
-	for (int i = 0; i < giNumberOfLevels; i++) {
-		currlevel = i;
-		if (!LevelFileExists(saveWriter))
-			continue;
-
-		leveltype = GetLevelType(currlevel);
+	std::vector<LevelToConvert> levels;
+	const auto addLevel = [&](LevelToConvert &&level) {
+		SelectLevel(level);
+		if (LevelFileExists(saveWriter))
+			levels.emplace_back(std::move(level));
+	};
 
-		LevelConversionData levelConversionData;
-		RETURN_IF_ERROR(LoadLevel(&levelConversionData));
-		SaveLevel(saveWriter, &levelConversionData);
+	for (int i = 0; i < giNumberOfLevels; i++) { // Convert regular levels
+		addLevel({ false, i, GetLevelType(i) });
 	}
 
-	setlevel = true; // Convert quest levels
-	for (auto &quest : Quests) {
-		if (quest._qactive == QUEST_NOTAVAIL) {
+	for (auto &quest : Quests) { // Convert quest levels
+		if (quest._qactive == QUEST_NOTAVAIL || quest._qlvltype == DTYPE_NONE)
 			continue;
-		}
+		addLevel({ true, quest._qslvl, quest._qlvltype });
+	}
 
-		leveltype = quest._qlvltype;
-		if (leveltype == DTYPE_NONE) {
-			continue;
+	// The levels are read in batches of one per thread, so that only a few archives are open and decoded levels are held at once
+	const size_t batchSize = GetParallelForThreadCount();
+	for (size_t batchBegin = 0; batchBegin < levels.size(); batchBegin += batchSize) {
+		const std::span<LevelToConvert> batch = std::span(levels).subspan(batchBegin, std::min(batchSize, levels.size() - batchBegin));
+
+		// Opening an archive waits for a pending save and mustn't happen on a worker thread
+		for (LevelToConvert &level : batch) {
+			SelectLevel(level);
+			level.archive = OpenSaveArchive(gSaveNumber);
+			GetTempLevelNames(level.fileName);
+			if (!level.archive || !level.archive->HasFile(level.fileName))
+				GetPermLevelNames(level.fileName);
 		}
 
-		setlvlnum = quest._qslvl;
-		if (!LevelFileExists(saveWriter))
-			continue;
+		// Decoding only touches the level's own buffer, loading it into the level globals and saving it stays on this thread
+		ParallelFor("DecodeLevels", batch.size(), [&](size_t i) {
+			LevelToConvert &level = batch[i];
+			if (level.archive)
+				level.contents = ReadArchive(*level.archive, level.fileName, &level.size);
+		});
+
+		for (LevelToConvert &level : batch)
+			level.archive = std::nullopt;
 
-		LevelConversionData levelConversionData;
-		RETURN_IF_ERROR(LoadLevel(&levelConversionData));
-		SaveLevel(saveWriter, &levelConversionData);
+		for (LevelToConvert &level : batch) {
+			SelectLevel(level);
+			// The decoded level is freed along with the helper once it is written
+			LoadHelper file(std::move(level.contents), level.size);
+
+			LevelConversionData levelConversionData;
+			RETURN_IF_ERROR(LoadLevel(file, &levelConversionData));
+			SaveLevel(saveWriter, &levelConversionData);
+		}
 	}
 
 	gbSkipSync = false;
@@ -2304,19 +2745,21 @@ _item_indexes RemapItemIdxToSpawn(_item_indexes i)
 bool IsHeaderValid(uint32_t magicNumber)
 {
 	gbIsHellfireSaveGame = false;
-	if (magicNumber == LoadLE32("SHAR")) {
-		return true;
-	}
-	if (magicNumber == LoadLE32("SHLF")) {
-		gbIsHellfireSaveGame = true;
-		return true;
-	}
-	if (!gbIsSpawn && magicNumber == LoadLE32("RETL")) {
-		return true;
-	}
-	if (!gbIsSpawn && magicNumber == LoadLE32("HELF")) {
-		gbIsHellfireSaveGame = true;
-		return true;
+	for (uint8_t version = 0; version <= SaveVersion; version++) {
+		if (magicNumber == GetSaveMagic(LoadLE32("SHAR"), version)) {
+			return true;
+		}
+		if (magicNumber == GetSaveMagic(LoadLE32("SHLF"), version)) {
+			gbIsHellfireSaveGame = true;
+			return true;
+		}
+		if (!gbIsSpawn && magicNumber == GetSaveMagic(LoadLE32("RETL"), version)) {
+			return true;
+		}
+		if (!gbIsSpawn && magicNumber == GetSaveMagic(LoadLE32("HELF"), version)) {
+			gbIsHellfireSaveGame = true;
+			return true;
+		}
 	}
 
 	return false;
@@ -2406,19 +2849,66 @@ void LoadHeroItems(Player &player)
 	gbIsHellfireSaveGame = gbIsHellfire;
 }
 
-constexpr uint8_t StashVersion = 0;
+/**
+ * @brief Version 0 stores the whole stash in one file, version 1 stores each page with its items in a file of its own.
+ */
+constexpr uint8_t StashVersion = 1;
+
+/**
+ * @brief Loads the pages of a paged stash, the items of each page are appended to `stashList`.
+ */
+bool LoadStashPages(SaveReader &archive, LoadHelper &file)
+{
+	const size_t itemSize = (gbIsHellfire ? HellfireItemSaveSize : DiabloItemSaveSize);
+
+	const auto pages = file.NextLE<uint32_t>();
+	const auto currentPage = file.NextLE<uint32_t>();
+	for (unsigned i = 0; i < pages && file.IsValid(); i++) {
+		const auto page = file.NextLE<uint32_t>();
+		const std::string pageFileName = GetStashPageFileName(page);
+		LoadHelper pageFile(archive, pageFileName.c_str());
+
+		StashStruct::StashGrid &grid = Stash.stashGrids[page];
+		for (auto &row : grid) {
+			for (uint16_t &cell : row) {
+				cell = pageFile.NextLE<uint16_t>();
+			}
+		}
+		const auto itemCount = pageFile.NextLE<uint32_t>();
+		if (pageFile.Size() != StashGridSaveSize + sizeof(uint32_t) + itemSize * itemCount)
+			return false;
+
+		// Pages refer to their items by their position on the page
+		const auto firstItem = static_cast<uint16_t>(Stash.stashList.size());
+		for (auto &row : grid) {
+			for (uint16_t &cell : row) {
+				if (cell > itemCount)
+					return false;
+				if (cell > 0)
+					cell += firstItem;
+			}
+		}
+		Stash.stashList.resize(Stash.stashList.size() + itemCount);
+		for (unsigned j = 0; j < itemCount; j++)
+			LoadAndValidateItemData(pageFile, Stash.stashList[firstItem + j]);
+
+		SavedStashPageHashes[page] = pageFile.ContentHash();
+	}
+	Stash.SetPage(currentPage);
+	return true;
+}
 
 void LoadStash()
 {
-	const char *filename;
-	if (!gbIsMultiplayer)
-		filename = "spstashitems";
-	else
-		filename = "mpstashitems";
+	const char *filename = GetStashFileName();
 
 	Stash = {};
+	SavedStashPageHashes.clear();
 
-	LoadHelper file(OpenStashArchive(), filename);
+	std::optional<SaveReader> archive = OpenStashArchive();
+	if (!archive)
+		return;
+	LoadHelper file(*archive, filename);
 	if (!file.IsValid())
 		return;
 
@@ -2430,6 +2920,15 @@ void LoadStash()
 
 	Stash.gold = file.NextLE<uint32_t>();
 
+	if (version >= 1) {
+		if (!LoadStashPages(*archive, file)) {
+			Stash = {};
+			SavedStashPageHashes.clear();
+			EventPlrMsg(_("Stash size invalid. If you attempt to access your stash, data will be overwritten!!"), UiFlags::ColorRed);
+		}
+		return;
+	}
+
 	auto pages = file.NextLE<uint32_t>();
 	for (unsigned i = 0; i < pages; i++) {
 		auto page = file.NextLE<uint32_t>();
@@ -2541,10 +3040,7 @@ tl::expected<void, std::string> LoadGame(bool firstflag)
 	ActiveMonsterCount = tmpNummonsters;
 	ActiveObjectCount = tmpNobjects;
 
-	for (size_t i = 0; i < MonstersData.size(); ++i) {
-		int &monstkill = MonsterKillCounts[i];
-		monstkill = file.NextBE<int32_t>();
-	}
+	file.NextBEValues<int32_t>(MonstersData.size(), [](size_t i, int32_t monstkill) { MonsterKillCounts[i] = monstkill; });
 
 	ankerl::unordered_dense::set<unsigned> removedMonsterIds;
 
@@ -2565,19 +3061,17 @@ tl::expected<void, std::string> LoadGame(bool firstflag)
 		// load the appropriate animation data for the monster in missile.var2
 		for (size_t i = 0; i < ActiveMonsterCount; i++)
 			RETURN_IF_ERROR(SyncMonsterAnim(Monsters[ActiveMonsters[i]]));
-		for (int &objectId : ActiveObjects)
-			objectId = file.NextLE<int8_t>();
-		for (int &objectId : AvailableObjects)
-			objectId = file.NextLE<int8_t>();
+		file.NextLEValues<int8_t>(MAXOBJECTS, [](size_t i, int8_t objectId) { ActiveObjects[i] = objectId; });
+		file.NextLEValues<int8_t>(MAXOBJECTS, [](size_t i, int8_t objectId) { AvailableObjects[i] = objectId; });
 		for (int i = 0; i < ActiveObjectCount; i++)
 			LoadObject(file, Objects[ActiveObjects[i]]);
+		WakeObjects();
 		for (int i = 0; i < ActiveObjectCount; i++)
 			SyncObjectAnim(Objects[ActiveObjects[i]]);
 
 		ActiveLightCount = file.NextBE<int32_t>();
 
-		for (uint8_t &lightId : ActiveLights)
-			lightId = file.NextLE<uint8_t>();
+		file.NextLEValues<uint8_t>(MAXLIGHTS, [](size_t i, uint8_t lightId) { ActiveLights[i] = lightId; });
 		for (int i = 0; i < ActiveLightCount; i++)
 			LoadLighting(&file, &Lights[ActiveLights[i]]);
 
@@ -2594,55 +3088,29 @@ tl::expected<void, std::string> LoadGame(bool firstflag)
 
 	LoadAdditionalMissiles();
 
-	for (bool &uniqueItemFlag : UniqueItemFlags)
-		uniqueItemFlag = file.NextBool8();
+	file.NextLEValues<uint8_t>(std::size(UniqueItemFlags), [](size_t i, uint8_t flag) { UniqueItemFlags[i] = flag != 0; });
 
 	file.Skip<uint8_t>(MAXDUNY * MAXDUNX); // dLight
-	for (int j = 0; j < MAXDUNY; j++) {
-		for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-			dFlags[i][j] = static_cast<DungeonFlag>(file.NextLE<uint8_t>()) & DungeonFlag::LoadedFlags;
-	}
-	for (int j = 0; j < MAXDUNY; j++) {
-		for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-			dPlayer[i][j] = file.NextLE<int8_t>();
-	}
+	file.NextLELayer<uint8_t>(dFlags, LoadSavedFlags);
+	file.NextLELayer<int8_t>(dPlayer);
 
 	// skip dItem indexes, this gets populated in LoadDroppedItems
 	file.Skip<uint8_t>(MAXDUNX * MAXDUNY);
 
 	if (leveltype != DTYPE_TOWN) {
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-			{
-				dMonster[i][j] = file.NextBE<int32_t>();
-				if (dMonster[i][j] > 0 && removedMonsterIds.contains(std::abs(dMonster[i][j]) - 1)) {
-					dMonster[i][j] = 0;
-				}
-			}
-		}
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dCorpse[i][j] = file.NextLE<int8_t>();
-		}
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dObject[i][j] = file.NextLE<int8_t>();
-		}
+		file.NextBELayer<int32_t>(dMonster, [&](int32_t value) {
+			const auto monsterId = static_cast<int16_t>(value);
+			return monsterId > 0 && removedMonsterIds.contains(std::abs(monsterId) - 1) ? int16_t { 0 } : monsterId;
+		});
+		file.NextLELayer<int8_t>(dCorpse);
+		file.NextLELayer<int8_t>(dObject);
 		file.Skip<uint8_t>(MAXDUNY * MAXDUNX); // dLight
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dPreLight[i][j] = file.NextLE<uint8_t>();
-		}
-		for (int j = 0; j < DMAXY; j++) {
-			for (int i = 0; i < DMAXX; i++) { // NOLINT(modernize-loop-convert)
-				const auto automapView = static_cast<MapExplorationType>(file.NextLE<uint8_t>());
-				AutomapView[i][j] = automapView == MAP_EXP_OLD ? MAP_EXP_SELF : automapView;
-			}
-		}
+		file.NextLELayer<uint8_t>(dPreLight);
+		file.NextLELayer<uint8_t>(AutomapView, LoadAutomapView);
 		file.Skip(MAXDUNX * MAXDUNY); // dMissile
 
 		// No need to load dLight, we can recreate it accurately from LightList
-		memcpy(dLight, dPreLight, sizeof(dLight));               // resets the light on entering a level to get rid of incorrect light
+		RestorePreLighting();                                    // resets the light on entering a level to get rid of incorrect light
 		ChangeLightXY(myPlayer.lightId, myPlayer.position.tile); // forces player light refresh
 	} else {
 		memset(dLight, 0, sizeof(dLight));
@@ -2704,73 +3172,85 @@ void SaveHeroItems(SaveWriter &saveWriter, Player &player)
 
 void SaveStash(SaveWriter &stashWriter)
 {
-	const char *filename;
-	if (!gbIsMultiplayer)
-		filename = "spstashitems";
-	else
-		filename = "mpstashitems";
-
 	const int itemSize = (gbIsHellfire ? HellfireItemSaveSize : DiabloItemSaveSize);
 
+	std::vector<unsigned> pagesToSave;
+	std::vector<StashStruct::StashCell> pageItems;
+	for (const auto &[page, grid] : Stash.stashGrids) {
+		// The items of a page are saved in the order of the stash list, removing an item from another page doesn't change it
+		pageItems.clear();
+		for (const auto &row : grid) {
+			for (const StashStruct::StashCell cell : row) {
+				if (cell > 0)
+					pageItems.push_back(cell - 1);
+			}
+		}
+		if (pageItems.empty())
+			continue;
+		c_sort(pageItems);
+		pageItems.erase(std::unique(pageItems.begin(), pageItems.end()), pageItems.end());
+		pagesToSave.push_back(page);
+
+		const std::string pageFileName = GetStashPageFileName(page);
+		SaveHelper file(stashWriter, pageFileName.c_str(), StashGridSaveSize + sizeof(uint32_t) + (itemSize * pageItems.size()), &SavedStashPageHashes[page]);
+		for (const auto &row : grid) {
+			for (const StashStruct::StashCell cell : row) {
+				if (cell == 0) {
+					file.WriteLE<uint16_t>(0);
+					continue;
+				}
+				const auto index = std::lower_bound(pageItems.begin(), pageItems.end(), cell - 1) - pageItems.begin();
+				file.WriteLE<uint16_t>(static_cast<uint16_t>(index + 1));
+			}
+		}
+		file.WriteLE<uint32_t>(static_cast<uint32_t>(pageItems.size()));
+		for (const StashStruct::StashCell itemId : pageItems)
+			SaveItem(file, Stash.stashList[itemId]);
+	}
+	c_sort(pagesToSave);
+
+	for (auto it = SavedStashPageHashes.begin(); it != SavedStashPageHashes.end();) {
+		if (std::binary_search(pagesToSave.begin(), pagesToSave.end(), it->first)) {
+			++it;
+			continue;
+		}
+		const std::string pageFileName = GetStashPageFileName(it->first);
+		if (stashWriter.HasFile(pageFileName.c_str()))
+			stashWriter.RemoveHashEntry(pageFileName.c_str());
+		it = SavedStashPageHashes.erase(it);
+	}
+
 	SaveHelper file(
 	    stashWriter,
-	    filename,
+	    GetStashFileName(),
 	    sizeof(uint8_t)
 	        + sizeof(uint32_t)
 	        + sizeof(uint32_t)
-	        + ((sizeof(uint32_t) + 10 * 10 * sizeof(uint16_t)) * Stash.stashGrids.size())
 	        + sizeof(uint32_t)
-	        + (itemSize * Stash.stashList.size())
-	        + sizeof(uint32_t));
+	        + (sizeof(uint32_t) * pagesToSave.size()));
 
 	file.WriteLE<uint8_t>(StashVersion);
-
 	file.WriteLE<uint32_t>(Stash.gold);
-
-	std::vector<unsigned> pagesToSave;
-	for (const auto &[page, grid] : Stash.stashGrids) {
-		if (c_any_of(grid, [](const auto &row) {
-			    return c_any_of(row, [](StashStruct::StashCell cell) {
-				    return cell > 0;
-			    });
-		    })) {
-			// found a page that contains at least one item
-			pagesToSave.push_back(page);
-		}
-	};
-
 	// Current stash size is 100 pages. Will definitely fit in a 32 bit value.
 	file.WriteLE<uint32_t>(static_cast<uint32_t>(pagesToSave.size()));
-	for (const auto &page : pagesToSave) {
-		file.WriteLE<uint32_t>(page);
-		for (const auto &row : Stash.stashGrids[page]) {
-			for (const uint16_t cell : row) {
-				file.WriteLE<uint16_t>(cell);
-			}
-		}
-	}
-
-	// 100 pages of 100 items is still only 10 000, as with the page count will definitely fit in 32 bits even in the worst case.
-	file.WriteLE<uint32_t>(static_cast<uint32_t>(Stash.stashList.size()));
-	for (const Item &item : Stash.stashList) {
-		SaveItem(file, item);
-	}
-
 	file.WriteLE<uint32_t>(static_cast<uint32_t>(Stash.GetPage()));
+	for (const unsigned page : pagesToSave)
+		file.WriteLE<uint32_t>(page);
 }
 
 void SaveGameData(SaveWriter &saveWriter)
 {
 	SaveHelper file(saveWriter, "game", 320 * 1024);
 
+	const uint8_t version = SaveInVanillaFormat() ? 0 : SaveVersion;
 	if (gbIsSpawn && !gbIsHellfire)
-		file.WriteLE<uint32_t>(LoadLE32("SHAR"));
+		file.WriteLE<uint32_t>(GetSaveMagic(LoadLE32("SHAR"), version));
 	else if (gbIsSpawn && gbIsHellfire)
-		file.WriteLE<uint32_t>(LoadLE32("SHLF"));
+		file.WriteLE<uint32_t>(GetSaveMagic(LoadLE32("SHLF"), version));
 	else if (!gbIsSpawn && gbIsHellfire)
-		file.WriteLE<uint32_t>(LoadLE32("HELF"));
+		file.WriteLE<uint32_t>(GetSaveMagic(LoadLE32("HELF"), version));
 	else if (!gbIsSpawn && !gbIsHellfire)
-		file.WriteLE<uint32_t>(LoadLE32("RETL"));
+		file.WriteLE<uint32_t>(GetSaveMagic(LoadLE32("RETL"), version));
 	else
 		app_fatal(_("Invalid game state"));
 
@@ -2913,6 +3393,7 @@ void SaveGameData(SaveWriter &saveWriter)
 		}
 	}
 
+	StockTownStores();
 	file.WriteBE<int32_t>(PremiumItemCount);
 	file.WriteBE<int32_t>(PremiumItemLevel);
 
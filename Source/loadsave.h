@@ -44,6 +44,12 @@ void SaveGame();
 void SaveLevel(SaveWriter &saveWriter);
 tl::expected<void, std::string> LoadLevel();
 tl::expected<void, std::string> ConvertLevels(SaveWriter &saveWriter);
+/**
+ * @brief Makes the next `SaveLevel` of every level write its file, call whenever level files are removed from the save.
+ *
+ * Also drops the levels kept in memory, so that the next `LoadLevel` reads the save.
+ */
+void ForgetSavedLevelHashes();
 void LoadStash();
 void SaveStash(SaveWriter &stashWriter);
 
@@ -149,64 +149,139 @@ struct UserdataQuery {
 	bool colonAccess;
 };
 
-void SuggestionsFromTable(const sol::table &table, std::string_view prefix,
-    size_t maxSuggestions, ankerl::unordered_dense::set<LuaAutocompleteSuggestion> &out,
-    std::optional<UserdataQuery> userdataQuery = std::nullopt)
+struct IndexedMember {
+	std::string key;
+	ValueInfo info;
+	std::optional<LuaUserdataMemberType> memberType;
+	/** @brief Whether a userdata member is accessed with `:` rather than `.`. */
+	bool requiresColonAccess = false;
+};
+
+/**
+ * @brief The string keys of a table, or of the metatable of a userdata, sorted so that the keys
+ * with a prefix are found with a binary search, with their signatures and docstrings.
+ */
+struct MemberIndex {
+	/** @brief Keeps the table alive, so that its address isn't reused by another table while indexed. */
+	sol::table table;
+	std::vector<IndexedMember> members;
+	std::optional<sol::table> fallback;
+};
+
+/**
+ * @brief The indices of the tables that suggestions were asked for, by the address of the table.
+ *
+ * Walking a table and getting the signatures of its functions is slow with large mod APIs, so it's
+ * only done once until the environment may have changed, see `ClearLuaAutocompleteIndex`.
+ */
+ankerl::unordered_dense::map<const void *, MemberIndex> TableIndices;
+ankerl::unordered_dense::map<const void *, MemberIndex> UserdataIndices;
+
+std::optional<sol::table> GetFallbackTable(const sol::table &table)
+{
+	const auto fallback = table.get<std::optional<sol::object>>(sol::metatable_key);
+	if (!fallback.has_value() || fallback->get_type() != sol::type::table)
+		return std::nullopt;
+	return fallback->as<sol::table>();
+}
+
+MemberIndex BuildMemberIndex(const sol::table &table, const sol::userdata *userdata)
 {
+	MemberIndex index { table, {}, GetFallbackTable(table) };
 	for (const auto &[key, value] : table) {
-		if (key.get_type() == sol::type::string) {
-			std::string keyStr = key.as<std::string>();
-			if (!keyStr.starts_with(prefix) || keyStr.size() == prefix.size())
-				continue;
-			if (keyStr.starts_with("__") && !prefix.starts_with("__"))
-				continue;
-			// sol-internal keys -- we don't have fonts for these so skip them.
-			if (keyStr.find("♻") != std::string::npos
-			    || keyStr.find("☢") != std::string::npos
-			    || keyStr.find("🔩") != std::string::npos)
-				continue;
-			ValueInfo info;
-			std::optional<LuaUserdataMemberType> memberType;
-			if (userdataQuery.has_value()) {
-				memberType = GetLuaUserdataMemberType(*userdataQuery->obj, keyStr, value);
-				const bool requiresColonAccess = memberType.has_value()
-				    ? *memberType == LuaUserdataMemberType::MemberFunction
-				    : value.get_type() == sol::type::function;
-				if (userdataQuery->colonAccess != requiresColonAccess) {
-					continue;
-				}
-				info = GetValueInfoForUserdata(*userdataQuery->obj, keyStr, value, memberType);
-			} else {
-				info = GetValueInfo(table, keyStr, value);
-			}
-			std::string completionText = keyStr.substr(prefix.size());
-			LuaAutocompleteSuggestion suggestion { std::move(keyStr), std::move(completionText) };
-			if (info.callable) {
-				suggestion.completionText.append("()");
-				suggestion.cursorAdjust = -1;
-			}
-			if (!info.signature.empty()) {
-				if (memberType.has_value() && memberType != LuaUserdataMemberType::MemberFunction) {
-					StrAppend(suggestion.displayText, ": ");
-				}
-				StrAppend(suggestion.displayText, info.signature);
-			}
-			if (!info.docstring.empty()) {
-				std::string_view firstLine = info.docstring;
-				if (const size_t newlinePos = firstLine.find('\n'); newlinePos != std::string_view::npos) {
-					firstLine = firstLine.substr(0, newlinePos);
-				}
-				StrAppend(suggestion.displayText, " - ", firstLine);
-			}
-			out.insert(std::move(suggestion));
-			if (out.size() == maxSuggestions)
-				break;
+		if (key.get_type() != sol::type::string)
+			continue;
+		std::string keyStr = key.as<std::string>();
+		// sol-internal keys -- we don't have fonts for these so skip them.
+		if (keyStr.find("♻") != std::string::npos
+		    || keyStr.find("☢") != std::string::npos
+		    || keyStr.find("🔩") != std::string::npos)
+			continue;
+		IndexedMember member;
+		if (userdata != nullptr) {
+			member.memberType = GetLuaUserdataMemberType(*userdata, keyStr, value);
+			member.requiresColonAccess = member.memberType.has_value()
+			    ? *member.memberType == LuaUserdataMemberType::MemberFunction
+			    : value.get_type() == sol::type::function;
+			member.info = GetValueInfoForUserdata(*userdata, keyStr, value, member.memberType);
+		} else {
+			member.info = GetValueInfo(table, keyStr, value);
 		}
+		member.key = std::move(keyStr);
+		index.members.push_back(std::move(member));
 	}
-	const auto fallback = table.get<std::optional<sol::object>>(sol::metatable_key);
-	if (fallback.has_value() && fallback->get_type() == sol::type::table) {
-		SuggestionsFromTable(fallback->as<sol::table>(), prefix, maxSuggestions, out);
+	c_sort(index.members, [](const IndexedMember &a, const IndexedMember &b) { return a.key < b.key; });
+	return index;
+}
+
+const MemberIndex &GetTableIndex(const sol::table &table)
+{
+	auto it = TableIndices.find(table.pointer());
+	if (it == TableIndices.end())
+		it = TableIndices.emplace(table.pointer(), BuildMemberIndex(table, nullptr)).first;
+	return it->second;
+}
+
+const MemberIndex &GetUserdataIndex(const sol::table &metatable, const sol::userdata &obj)
+{
+	// Userdata of the same type share their metatable, so the members are indexed once per type.
+	auto it = UserdataIndices.find(metatable.pointer());
+	if (it == UserdataIndices.end())
+		it = UserdataIndices.emplace(metatable.pointer(), BuildMemberIndex(metatable, &obj)).first;
+	return it->second;
+}
+
+LuaAutocompleteSuggestion MakeSuggestion(const IndexedMember &member, std::string_view prefix)
+{
+	LuaAutocompleteSuggestion suggestion { member.key, member.key.substr(prefix.size()) };
+	const ValueInfo &info = member.info;
+	if (info.callable) {
+		suggestion.completionText.append("()");
+		suggestion.cursorAdjust = -1;
+	}
+	if (!info.signature.empty()) {
+		if (member.memberType.has_value() && member.memberType != LuaUserdataMemberType::MemberFunction) {
+			StrAppend(suggestion.displayText, ": ");
+		}
+		StrAppend(suggestion.displayText, info.signature);
+	}
+	if (!info.docstring.empty()) {
+		std::string_view firstLine = info.docstring;
+		if (const size_t newlinePos = firstLine.find('\n'); newlinePos != std::string_view::npos) {
+			firstLine = firstLine.substr(0, newlinePos);
+		}
+		StrAppend(suggestion.displayText, " - ", firstLine);
 	}
+	return suggestion;
+}
+
+void SuggestionsFromIndex(const MemberIndex &index, std::string_view prefix,
+    size_t maxSuggestions, ankerl::unordered_dense::set<LuaAutocompleteSuggestion> &out,
+    std::optional<bool> colonAccess = std::nullopt)
+{
+	auto it = std::lower_bound(index.members.begin(), index.members.end(), prefix,
+	    [](const IndexedMember &member, std::string_view key) { return member.key < key; });
+	for (; it != index.members.end() && it->key.starts_with(prefix); ++it) {
+		const IndexedMember &member = *it;
+		if (member.key.size() == prefix.size())
+			continue;
+		if (member.key.starts_with("__") && !prefix.starts_with("__"))
+			continue;
+		if (colonAccess.has_value() && *colonAccess != member.requiresColonAccess)
+			continue;
+		out.insert(MakeSuggestion(member, prefix));
+		if (out.size() == maxSuggestions)
+			break;
+	}
+	if (index.fallback.has_value()) {
+		SuggestionsFromIndex(GetTableIndex(*index.fallback), prefix, maxSuggestions, out);
+	}
+}
+
+void SuggestionsFromTable(const sol::table &table, std::string_view prefix,
+    size_t maxSuggestions, ankerl::unordered_dense::set<LuaAutocompleteSuggestion> &out)
+{
+	SuggestionsFromIndex(GetTableIndex(table), prefix, maxSuggestions, out);
 }
 
 void SuggestionsFromUserdata(UserdataQuery query, std::string_view prefix,
@@ -214,7 +289,7 @@ void SuggestionsFromUserdata(UserdataQuery query, std::string_view prefix,
 {
 	const auto &meta = query.obj->get<std::optional<sol::object>>(sol::metatable_key);
 	if (meta.has_value() && meta->get_type() == sol::type::table) {
-		SuggestionsFromTable(meta->as<sol::table>(), prefix, maxSuggestions, out, query);
+		SuggestionsFromIndex(GetUserdataIndex(meta->as<sol::table>(), *query.obj), prefix, maxSuggestions, out, query.colonAccess);
 	}
 }
 
@@ -292,5 +367,11 @@ void GetLuaAutocompleteSuggestions(std::string_view text, size_t cursorPos, cons
 	c_sort(out);
 }
 
+void ClearLuaAutocompleteIndex()
+{
+	TableIndices.clear();
+	UserdataIndices.clear();
+}
+
 } // namespace devilution
 #endif // _DEBUG
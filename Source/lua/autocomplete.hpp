@@ -29,6 +29,14 @@ void GetLuaAutocompleteSuggestions(
     std::string_view text, size_t cursorPos, const sol::environment &lua,
     size_t maxSuggestions, std::vector<LuaAutocompleteSuggestion> &out);
 
+/**
+ * @brief Forgets the members of the Lua tables indexed for the suggestions.
+ *
+ * Must be called whenever the tables may have changed, i.e. after running console input and
+ * after loading the mods, and before the Lua state is destroyed.
+ */
+void ClearLuaAutocompleteIndex();
+
 } // namespace devilution
 
 namespace std {
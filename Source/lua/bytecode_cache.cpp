@@ -0,0 +1,121 @@
+#include "lua/bytecode_cache.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include <ankerl/unordered_dense.h>
+
+#include "utils/file_util.h"
+#include "utils/log.hpp"
+#include "utils/paths.h"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+
+namespace {
+
+/** @brief Bump this whenever scripts are compiled differently, so that older entries are not used. */
+constexpr uint32_t LuaBytecodeCacheVersion = 1;
+
+struct LuaBytecodeCacheHeader {
+	char magic[4];
+	uint32_t version;
+	uint64_t key;
+	uint64_t size;
+	/** @brief Detects a damaged entry, loading broken bytecode can crash the interpreter. */
+	uint64_t checksum;
+};
+
+constexpr char LuaBytecodeCacheMagic[4] = { 'D', 'X', 'L', 'C' };
+
+uint64_t HashBytes(const void *data, size_t size)
+{
+	return ankerl::unordered_dense::hash<std::string_view> {}(std::string_view { static_cast<const char *>(data), size });
+}
+
+const std::string &LuaBytecodeCacheDir()
+{
+	static const std::string Dir = StrCat(paths::PrefPath(), "cache" DIRECTORY_SEPARATOR_STR "lua" DIRECTORY_SEPARATOR_STR);
+	return Dir;
+}
+
+std::string LuaBytecodeCachePath(std::string_view path)
+{
+	// "lua\mods\Hellfire\init.lua" -> "lua_mods_Hellfire_init.lua.luac"
+	std::string name { path };
+	for (char &c : name) {
+		if (c == '\\' || c == '/')
+			c = '_';
+	}
+	return StrCat(LuaBytecodeCacheDir(), name, ".luac");
+}
+
+} // namespace
+
+uint64_t GetLuaBytecodeCacheKey(std::string_view path, std::string_view source, uint32_t luaVersion)
+{
+	const uint64_t parts[] = {
+		HashBytes(source.data(), source.size()),
+		HashBytes(path.data(), path.size()),
+		source.size(),
+		(static_cast<uint64_t>(luaVersion) << 8) | sizeof(void *),
+		LuaBytecodeCacheVersion,
+	};
+	return HashBytes(parts, sizeof(parts));
+}
+
+std::optional<std::string> LoadCachedLuaBytecode(std::string_view path, uint64_t key)
+{
+	FILE *file = OpenFile(LuaBytecodeCachePath(path).c_str(), "rb");
+	if (file == nullptr)
+		return std::nullopt;
+	const std::unique_ptr<FILE, int (*)(FILE *)> fileCloser { file, &std::fclose };
+
+	LuaBytecodeCacheHeader header;
+	if (std::fread(&header, sizeof(header), 1, file) != 1
+	    || std::memcmp(header.magic, LuaBytecodeCacheMagic, sizeof(LuaBytecodeCacheMagic)) != 0
+	    || header.version != LuaBytecodeCacheVersion
+	    || header.key != key
+	    || header.size == 0) {
+		return std::nullopt;
+	}
+
+	std::string bytecode(static_cast<size_t>(header.size), '\0');
+	if (std::fread(bytecode.data(), bytecode.size(), 1, file) != 1
+	    || HashBytes(bytecode.data(), bytecode.size()) != header.checksum) {
+		LogVerbose("Ignoring invalid Lua bytecode cache entry for {}", path);
+		return std::nullopt;
+	}
+	return bytecode;
+}
+
+void StoreCachedLuaBytecode(std::string_view path, uint64_t key, std::string_view bytecode)
+{
+	RecursivelyCreateDir(LuaBytecodeCacheDir().c_str());
+	const std::string cachePath = LuaBytecodeCachePath(path);
+	const std::string tempPath = StrCat(cachePath, ".tmp");
+	FILE *file = OpenFile(tempPath.c_str(), "wb");
+	if (file == nullptr)
+		return;
+
+	LuaBytecodeCacheHeader header {};
+	std::memcpy(header.magic, LuaBytecodeCacheMagic, sizeof(LuaBytecodeCacheMagic));
+	header.version = LuaBytecodeCacheVersion;
+	header.key = key;
+	header.size = bytecode.size();
+	header.checksum = HashBytes(bytecode.data(), bytecode.size());
+	const bool written = std::fwrite(&header, sizeof(header), 1, file) == 1
+	    && std::fwrite(bytecode.data(), bytecode.size(), 1, file) == 1;
+	if (std::fclose(file) != 0 || !written) {
+		LogVerbose("Failed to write the Lua bytecode cache entry for {}", path);
+		RemoveFile(tempPath.c_str());
+		return;
+	}
+	// Renamed into place only once complete, so that an interrupted write is never read back.
+	RenameFile(tempPath.c_str(), cachePath.c_str());
+}
+
+} // namespace devilution
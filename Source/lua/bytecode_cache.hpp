@@ -0,0 +1,36 @@
+/**
+ * @file bytecode_cache.hpp
+ *
+ * On-disk cache of compiled Lua scripts.
+ */
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace devilution {
+
+/**
+ * @brief Identifies the bytecode of a script.
+ *
+ * @param path The chunk name of the script, which is part of the bytecode.
+ * @param source The script as it is loaded, from the assets or a mod.
+ * @param luaVersion The release number of the Lua runtime, bytecode is not portable between releases.
+ */
+uint64_t GetLuaBytecodeCacheKey(std::string_view path, std::string_view source, uint32_t luaVersion);
+
+/**
+ * @brief Loads the bytecode stored for the script at `path`, if it was compiled from the same source.
+ */
+std::optional<std::string> LoadCachedLuaBytecode(std::string_view path, uint64_t key);
+
+/**
+ * @brief Stores the bytecode of a script, replacing the bytecode of any other version of it.
+ *
+ * Failing to write the cache is not an error, the script is then compiled again the next time.
+ */
+void StoreCachedLuaBytecode(std::string_view path, uint64_t key, std::string_view bytecode);
+
+} // namespace devilution
@@ -1,12 +1,16 @@
 #include "lua/lua_event.hpp"
 
+#include <cstdint>
 #include <optional>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include <sol/sol.hpp>
 
 #include "lua/lua_global.hpp"
+#include "lua/lua_profiler.hpp"
+#include "lua/modules/render.hpp"
 #include "monster.h"
 #include "player.h"
 #include "utils/log.hpp"
@@ -15,90 +19,192 @@ namespace devilution {
 
 namespace lua {
 
-template <typename... Args>
-void CallLuaEvent(std::string_view name, Args &&...args)
-{
-	sol::table *events = GetLuaEvents();
-	if (events == nullptr) {
-		return;
+namespace {
+
+/** @brief Incremented whenever the events table or any of its handlers change. */
+uint32_t EventsGeneration = 1;
+
+/**
+ * @brief The trigger of an event, resolved from the events table when it is first called
+ * after the events changed.
+ */
+struct EventTrigger {
+	std::string_view name;
+	uint32_t generation = 0;
+	bool hasHandlers = false;
+	sol::protected_function trigger;
+
+	explicit EventTrigger(std::string_view eventName)
+	    : name(eventName)
+	{
+	}
+
+	/** @brief Whether calling the trigger can have any effect. */
+	bool isActive()
+	{
+		if (generation != EventsGeneration)
+			resolve();
+		return hasHandlers;
 	}
 
-	const auto trigger = events->traverse_get<std::optional<sol::object>>(name, "trigger");
-	if (!trigger.has_value() || !trigger->is<sol::protected_function>()) {
-		LogError("events.{}.trigger is not a function", name);
+	void resolve()
+	{
+		generation = EventsGeneration;
+		hasHandlers = false;
+		trigger = sol::protected_function {};
+		sol::table *events = GetLuaEvents();
+		if (events == nullptr) {
+			return;
+		}
+
+		const auto event = events->get<std::optional<sol::table>>(name);
+		const auto fn = event.has_value() ? event->get<std::optional<sol::protected_function>>("trigger") : std::nullopt;
+		if (!fn.has_value()) {
+			LogError("events.{}.trigger is not a function", name);
+			return;
+		}
+		trigger = *fn;
+		// Events that were replaced by a mod may not keep their handlers in `__handlers`.
+		const auto handlers = event->get<std::optional<sol::table>>("__handlers");
+		hasHandlers = !handlers.has_value() || handlers->size() != 0;
+	}
+};
+
+EventTrigger MonsterDataLoadedEvent { "MonsterDataLoaded" };
+EventTrigger UniqueMonsterDataLoadedEvent { "UniqueMonsterDataLoaded" };
+EventTrigger ItemDataLoadedEvent { "ItemDataLoaded" };
+EventTrigger UniqueItemDataLoadedEvent { "UniqueItemDataLoaded" };
+EventTrigger StoreOpenedEvent { "StoreOpened" };
+EventTrigger OnMonsterTakeDamageEvent { "OnMonsterTakeDamage" };
+EventTrigger OnMonsterTakeDamageBatchEvent { "OnMonsterTakeDamageBatch" };
+EventTrigger OnPlayerGainExperienceEvent { "OnPlayerGainExperience" };
+EventTrigger OnPlayerTakeDamageEvent { "OnPlayerTakeDamage" };
+EventTrigger LoadModsCompleteEvent { "LoadModsComplete" };
+EventTrigger GameDrawCompleteEvent { "GameDrawComplete" };
+EventTrigger GameStartEvent { "GameStart" };
+
+EventTrigger *const AllEvents[] = {
+	&MonsterDataLoadedEvent,
+	&UniqueMonsterDataLoadedEvent,
+	&ItemDataLoadedEvent,
+	&UniqueItemDataLoadedEvent,
+	&StoreOpenedEvent,
+	&OnMonsterTakeDamageEvent,
+	&OnMonsterTakeDamageBatchEvent,
+	&OnPlayerGainExperienceEvent,
+	&OnPlayerTakeDamageEvent,
+	&LoadModsCompleteEvent,
+	&GameDrawCompleteEvent,
+	&GameStartEvent,
+};
+
+template <typename... Args>
+void CallLuaEvent(EventTrigger &event, Args &&...args)
+{
+	if (!event.isActive()) {
 		return;
 	}
-	const sol::protected_function fn = trigger->as<sol::protected_function>();
-	SafeCallResult(fn(std::forward<Args>(args)...), /*optional=*/true);
+	const ProfiledLuaCall profiled;
+	SafeCallResult(event.trigger(std::forward<Args>(args)...), /*optional=*/true);
 }
 
 template <typename T, typename... Args>
-T CallLuaEventReturn(T defaultValue, std::string_view name, Args &&...args)
+T CallLuaEventReturn(T defaultValue, EventTrigger &event, Args &&...args)
 {
-	sol::table *events = GetLuaEvents();
-	if (events == nullptr) {
-		return defaultValue;
-	}
-
-	const auto trigger = events->traverse_get<std::optional<sol::object>>(name, "trigger");
-	if (!trigger.has_value() || !trigger->is<sol::protected_function>()) {
+	if (!event.isActive()) {
 		return defaultValue;
 	}
-	const sol::protected_function fn = trigger->as<sol::protected_function>();
-	sol::object result = SafeCallResult(fn(std::forward<Args>(args)...), /*optional=*/true);
+	const ProfiledLuaCall profiled;
+	sol::object result = SafeCallResult(event.trigger(std::forward<Args>(args)...), /*optional=*/true);
 	if (result.is<T>()) {
 		return result.as<T>();
 	}
 	return defaultValue;
 }
 
+/** @brief Damage for `OnMonsterTakeDamageBatch`, only collected while the event has handlers. */
+std::vector<MonsterDamageRecord> MonsterDamageRecords;
+
+} // namespace
+
+void EventsChanged()
+{
+	++EventsGeneration;
+}
+
+void ClearEventTriggers()
+{
+	for (EventTrigger *event : AllEvents) {
+		event->trigger = sol::protected_function {};
+		event->hasHandlers = false;
+		event->generation = 0;
+	}
+	++EventsGeneration;
+	MonsterDamageRecords.clear();
+}
+
 void MonsterDataLoaded()
 {
-	CallLuaEvent("MonsterDataLoaded");
+	CallLuaEvent(MonsterDataLoadedEvent);
 }
 void UniqueMonsterDataLoaded()
 {
-	CallLuaEvent("UniqueMonsterDataLoaded");
+	CallLuaEvent(UniqueMonsterDataLoadedEvent);
 }
 void ItemDataLoaded()
 {
-	CallLuaEvent("ItemDataLoaded");
+	CallLuaEvent(ItemDataLoadedEvent);
 }
 void UniqueItemDataLoaded()
 {
-	CallLuaEvent("UniqueItemDataLoaded");
+	CallLuaEvent(UniqueItemDataLoadedEvent);
 }
 
 void StoreOpened(std::string_view name)
 {
-	CallLuaEvent("StoreOpened", name);
+	CallLuaEvent(StoreOpenedEvent, name);
 }
 
 void OnMonsterTakeDamage(const Monster *monster, int damage, int damageType)
 {
-	CallLuaEvent("OnMonsterTakeDamage", monster, damage, damageType);
+	CallLuaEvent(OnMonsterTakeDamageEvent, monster, damage, damageType);
+	if (OnMonsterTakeDamageBatchEvent.isActive()) {
+		MonsterDamageRecords.push_back(MonsterDamageRecord { monster, damage, damageType });
+	}
+}
+
+void FlushMonsterDamageBatch()
+{
+	if (MonsterDamageRecords.empty()) {
+		return;
+	}
+	const MonsterDamageBatch batch { MonsterDamageRecords };
+	CallLuaEvent(OnMonsterTakeDamageBatchEvent, &batch);
+	MonsterDamageRecords.clear();
 }
 
 void OnPlayerGainExperience(const Player *player, uint32_t exp)
 {
-	CallLuaEvent("OnPlayerGainExperience", player, exp);
+	CallLuaEvent(OnPlayerGainExperienceEvent, player, exp);
 }
 void OnPlayerTakeDamage(const Player *player, int damage, int damageType)
 {
-	CallLuaEvent("OnPlayerTakeDamage", player, damage, damageType);
+	CallLuaEvent(OnPlayerTakeDamageEvent, player, damage, damageType);
 }
 
 void LoadModsComplete()
 {
-	CallLuaEvent("LoadModsComplete");
+	CallLuaEvent(LoadModsCompleteEvent);
 }
 void GameDrawComplete()
 {
-	CallLuaEvent("GameDrawComplete");
+	CallLuaEvent(GameDrawCompleteEvent);
+	DrawLuaRetainedStrings();
+	LuaProfilerEndFrame();
 }
 void GameStart()
 {
-	CallLuaEvent("GameStart");
+	CallLuaEvent(GameStartEvent);
 }
 
 } // namespace lua
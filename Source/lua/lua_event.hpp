@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 #include <string_view>
 
 namespace devilution {
@@ -10,6 +11,27 @@ struct Monster;
 
 namespace lua {
 
+struct MonsterDamageRecord {
+	const Monster *monster;
+	int damage;
+	int damageType;
+};
+
+/**
+ * @brief The damage that monsters took during a game tick, passed to `OnMonsterTakeDamageBatch`.
+ *
+ * Only valid during the call to the event handlers.
+ */
+struct MonsterDamageBatch {
+	std::span<const MonsterDamageRecord> records;
+};
+
+/** @brief Makes the events re-read their triggers, called when the events table or its handlers change. */
+void EventsChanged();
+
+/** @brief Releases the cached triggers, must be called before the Lua state is destroyed. */
+void ClearEventTriggers();
+
 void MonsterDataLoaded();
 void UniqueMonsterDataLoaded();
 void ItemDataLoaded();
@@ -19,6 +41,9 @@ void StoreOpened(std::string_view name);
 
 void OnMonsterTakeDamage(const Monster *monster, int damage, int damageType);
 
+/** @brief Triggers `OnMonsterTakeDamageBatch` with the damage collected since the previous call, called at the end of each game tick. */
+void FlushMonsterDamageBatch();
+
 void OnPlayerGainExperience(const Player *player, uint32_t exp);
 void OnPlayerTakeDamage(const Player *player, int damage, int damageType);
 
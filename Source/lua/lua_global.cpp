@@ -1,6 +1,7 @@
 #include "lua/lua_global.hpp"
 
 #include <algorithm>
+#include <cstdlib>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -24,8 +25,11 @@
 
 #include "appfat.h"
 #include "effects.h"
+#include "engine/asset_prefetch.hpp"
 #include "engine/assets.hpp"
+#include "lua/bytecode_cache.hpp"
 #include "lua/lua_event.hpp"
+#include "lua/lua_profiler.hpp"
 #include "lua/modules/audio.hpp"
 #include "lua/modules/floatingnumbers.hpp"
 #include "lua/modules/hellfire.hpp"
@@ -42,9 +46,11 @@
 #include "stores.h"
 #include "utils/console.h"
 #include "utils/log.hpp"
+#include "utils/memory_stats.hpp"
 #include "utils/str_cat.hpp"
 
 #ifdef _DEBUG
+#include "lua/autocomplete.hpp"
 #include "lua/modules/dev.hpp"
 #include "lua/repl.hpp"
 #endif
@@ -59,15 +65,35 @@ void LuaPanic(const std::optional<std::string> &message)
 	    message.value_or("unknown error"));
 }
 
+/** @brief The default Lua allocator, counting the memory of the scripts. */
+void *LuaAllocate(void * /*userData*/, void *ptr, size_t oldSize, size_t newSize)
+{
+	// When `ptr` is null, `oldSize` is the type of the new object rather than a size
+	if (ptr == nullptr)
+		oldSize = 0;
+	if (newSize == 0) {
+		free(ptr);
+		MemoryStatsRemove(MemoryTag::Lua, oldSize);
+		return nullptr;
+	}
+	void *result = realloc(ptr, newSize);
+	if (result != nullptr) {
+		MemoryStatsRemove(MemoryTag::Lua, oldSize);
+		MemoryStatsAdd(MemoryTag::Lua, newSize);
+	}
+	return result;
+}
+
 struct LuaState {
 	sol::state sol;
 	sol::table commonPackages;
-	ankerl::unordered_dense::segmented_map<std::string, sol::bytecode> compiledScripts;
+	/** @brief Bytecode by `GetLuaBytecodeCacheKey`, so that a script overridden by a mod is compiled again. */
+	ankerl::unordered_dense::segmented_map<uint64_t, std::string> compiledScripts;
 	sol::environment sandbox;
 	sol::table events;
 
 	LuaState()
-	    : sol(sol::c_call<decltype(&LuaPanic), &LuaPanic>)
+	    : sol(sol::c_call<decltype(&LuaPanic), &LuaPanic>, &LuaAllocate)
 	{
 	}
 };
@@ -108,24 +134,37 @@ sol::object LuaLoadScriptFromAssets(std::string_view packageName)
 	StrAppend(path, PathPrefix, packageName, PathSuffix);
 	std::replace(path.begin() + PathPrefix.size(), path.end() - PathSuffix.size(), '.', '\\');
 
-	auto iter = luaState.compiledScripts.find(path);
-	if (iter != luaState.compiledScripts.end()) {
-		return luaState.sol.load(iter->second.as_string_view(), path, sol::load_mode::binary);
-	}
-
 	tl::expected<AssetData, std::string> assetData = LoadAsset(path);
 	if (!assetData.has_value()) {
 		sol::stack::push(luaState.sol.lua_state(), assetData.error());
 		return sol::stack_object(luaState.sol.lua_state(), -1);
 	}
-	const sol::load_result result = luaState.sol.load(std::string_view(*assetData), path, sol::load_mode::text);
+	const std::string_view source { *assetData };
+	const uint64_t key = GetLuaBytecodeCacheKey(path, source, LUA_VERSION_RELEASE_NUM);
+
+	auto iter = luaState.compiledScripts.find(key);
+	if (iter != luaState.compiledScripts.end()) {
+		return luaState.sol.load(iter->second, path, sol::load_mode::binary);
+	}
+	if (std::optional<std::string> bytecode = LoadCachedLuaBytecode(path, key); bytecode.has_value()) {
+		sol::load_result cached = luaState.sol.load(*bytecode, path, sol::load_mode::binary);
+		if (cached.valid()) {
+			luaState.compiledScripts[key] = *std::move(bytecode);
+			return cached;
+		}
+		LogVerbose("Ignoring Lua bytecode cache entry for {}: {}", path, cached.get<std::string>());
+	}
+
+	const sol::load_result result = luaState.sol.load(source, path, sol::load_mode::text);
 	if (!result.valid()) {
 		sol::stack::push(luaState.sol.lua_state(),
 		    StrCat("Lua error when loading ", path, ": ", result.get<std::string>()));
 		return sol::stack_object(luaState.sol.lua_state(), -1);
 	}
 	const sol::function fn = result;
-	luaState.compiledScripts[path] = fn.dump();
+	const sol::bytecode bytecode = fn.dump();
+	StoreCachedLuaBytecode(path, key, bytecode.as_string_view());
+	luaState.compiledScripts[key] = std::string(bytecode.as_string_view());
 	return result;
 }
 
@@ -241,11 +280,15 @@ void LuaReloadActiveMods()
 {
 	// Loaded without a sandbox.
 	CurrentLuaState->events = RunScript(/*env=*/std::nullopt, "devilutionx.events", /*optional=*/false);
+	CurrentLuaState->events["__onChanged"] = [] { lua::EventsChanged(); };
 	CurrentLuaState->commonPackages["devilutionx.events"] = CurrentLuaState->events;
+	lua::EventsChanged();
+	lua::ResetLuaProfiler();
 
 	ClearTownerDialogOptions();
 
 	gbIsHellfire = false;
+	ShutdownAssetPrefetch();
 	UnloadModArchives();
 
 	std::vector<std::string_view> modnames = GetOptions().Mods.GetActiveModList();
@@ -278,6 +321,9 @@ void LuaReloadActiveMods()
 	LoadQuestData();
 
 	lua::LoadModsComplete();
+#ifdef _DEBUG
+	ClearLuaAutocompleteIndex();
+#endif
 }
 
 void LuaInitialize()
@@ -332,11 +378,14 @@ void LuaInitialize()
 void LuaShutdown()
 {
 #ifdef _DEBUG
+	ClearLuaAutocompleteIndex();
 	LuaReplShutdown();
 #endif
 	// Must clear before destroying the Lua state: registered callbacks
 	// capture sol::function handles that reference CurrentLuaState.
 	ClearTownerDialogOptions();
+	ClearLuaRetainedStrings();
+	lua::ClearEventTriggers();
 	CurrentLuaState = std::nullopt;
 }
 
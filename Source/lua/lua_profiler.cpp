@@ -0,0 +1,268 @@
+#include "lua/lua_profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <sol/sol.hpp>
+
+#include "lua/lua_global.hpp"
+#include "utils/log.hpp"
+
+#ifdef _DEBUG
+#include "panels/console.hpp"
+#endif
+
+namespace devilution {
+namespace lua {
+
+namespace {
+
+/** @brief Number of VM instructions between two samples. */
+constexpr int InstructionsPerSample = 1000;
+
+/** @brief Minimum time between two budget warnings for the same mod. */
+constexpr std::chrono::seconds BudgetWarningInterval { 5 };
+
+using Clock = std::chrono::steady_clock;
+
+struct ModStats {
+	std::string name;
+	uint64_t frameUs = 0;
+	uint64_t totalUs = 0;
+	uint64_t maxFrameUs = 0;
+	uint32_t framesOverBudget = 0;
+	Clock::time_point lastWarning = {};
+};
+
+struct FunctionStats {
+	std::string location;
+	size_t mod;
+	uint64_t samples = 0;
+};
+
+struct Profiler {
+	bool enabled = false;
+	uint32_t budgetUs = 0;
+	bool throttle = false;
+	bool hookInstalled = false;
+
+	/** @brief Index 0 collects the time spent outside of mods, e.g. in the event dispatcher. */
+	std::vector<ModStats> mods = { ModStats { .name = "(engine)" } };
+	/** @brief The mod of each chunk, keyed by the chunk name, which Lua interns for the lifetime of the chunk. */
+	std::map<const char *, size_t> modBySource;
+	std::map<std::pair<const char *, int>, FunctionStats> functions;
+	uint64_t totalSamples = 0;
+	uint64_t frames = 0;
+
+	int callDepth = 0;
+	Clock::time_point lastSample;
+	size_t lastMod = 0;
+};
+
+Profiler TheProfiler;
+
+uint64_t ElapsedUs(Clock::time_point from, Clock::time_point to)
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+}
+
+/** @brief Mods are loaded as `lua\mods\<name>\...`, anything else belongs to the engine. */
+size_t ModForSource(const char *source)
+{
+	const auto it = TheProfiler.modBySource.find(source);
+	if (it != TheProfiler.modBySource.end())
+		return it->second;
+
+	size_t mod = 0;
+	constexpr std::string_view ModsPrefix = "lua\\mods\\";
+	const std::string_view path = source;
+	if (path.starts_with(ModsPrefix)) {
+		const std::string_view rest = path.substr(ModsPrefix.size());
+		const std::string_view name = rest.substr(0, rest.find('\\'));
+		const auto existing = std::find_if(TheProfiler.mods.begin(), TheProfiler.mods.end(),
+		    [&](const ModStats &stats) { return stats.name == name; });
+		mod = static_cast<size_t>(existing - TheProfiler.mods.begin());
+		if (existing == TheProfiler.mods.end())
+			TheProfiler.mods.push_back(ModStats { .name = std::string(name) });
+	}
+	TheProfiler.modBySource.emplace(source, mod);
+	return mod;
+}
+
+void Charge(size_t mod, Clock::time_point now)
+{
+	ModStats &stats = TheProfiler.mods[mod];
+	stats.frameUs += ElapsedUs(TheProfiler.lastSample, now);
+	TheProfiler.lastSample = now;
+	TheProfiler.lastMod = mod;
+}
+
+void ProfilerHook(lua_State *state, lua_Debug *ar)
+{
+	if (TheProfiler.callDepth == 0 || lua_getinfo(state, "S", ar) == 0)
+		return;
+
+	const size_t mod = ModForSource(ar->source);
+	Charge(mod, Clock::now());
+
+	if (TheProfiler.enabled) {
+		FunctionStats &function = TheProfiler.functions[{ ar->source, ar->linedefined }];
+		if (function.location.empty()) {
+			function.location = fmt::format("{}:{}", ar->short_src, ar->linedefined);
+			function.mod = mod;
+		}
+		++function.samples;
+		++TheProfiler.totalSamples;
+	}
+
+	if (mod != 0 && TheProfiler.throttle && TheProfiler.budgetUs != 0 && TheProfiler.mods[mod].frameUs > TheProfiler.budgetUs) {
+		luaL_error(state, "%s exceeded its Lua budget of %d us for this frame", TheProfiler.mods[mod].name.c_str(), static_cast<int>(TheProfiler.budgetUs));
+	}
+}
+
+void UpdateHook()
+{
+	const bool wanted = TheProfiler.enabled || TheProfiler.budgetUs != 0;
+	if (wanted == TheProfiler.hookInstalled)
+		return;
+	lua_sethook(GetLuaState().lua_state(), wanted ? ProfilerHook : nullptr, wanted ? LUA_MASKCOUNT : 0, InstructionsPerSample);
+	TheProfiler.hookInstalled = wanted;
+}
+
+void WarnOverBudget(ModStats &stats, Clock::time_point now)
+{
+	++stats.framesOverBudget;
+	if (stats.lastWarning != Clock::time_point {} && now - stats.lastWarning < BudgetWarningInterval)
+		return;
+	const std::string message = fmt::format("Lua mod {} used {} us in one frame, over its budget of {} us ({} frames over budget)",
+	    stats.name, stats.frameUs, TheProfiler.budgetUs, stats.framesOverBudget);
+	LogWarn("{}", message);
+#ifdef _DEBUG
+	PrintWarningToConsole(message);
+#endif
+	stats.lastWarning = now;
+	stats.framesOverBudget = 0;
+}
+
+} // namespace
+
+ProfiledLuaCall::ProfiledLuaCall()
+    : active_(TheProfiler.hookInstalled)
+{
+	if (!active_)
+		return;
+	if (TheProfiler.callDepth++ == 0) {
+		TheProfiler.lastSample = Clock::now();
+		TheProfiler.lastMod = 0;
+	}
+}
+
+ProfiledLuaCall::~ProfiledLuaCall()
+{
+	if (!active_)
+		return;
+	// The time since the last sample most likely belongs to the function that was sampled last.
+	if (--TheProfiler.callDepth == 0)
+		Charge(TheProfiler.lastMod, Clock::now());
+}
+
+bool IsLuaProfilingEnabled()
+{
+	return TheProfiler.enabled;
+}
+
+void SetLuaProfilingEnabled(bool enabled)
+{
+	if (enabled && !TheProfiler.enabled) {
+		TheProfiler.functions.clear();
+		TheProfiler.totalSamples = 0;
+		TheProfiler.frames = 0;
+		for (ModStats &stats : TheProfiler.mods) {
+			stats.totalUs = 0;
+			stats.maxFrameUs = 0;
+		}
+	}
+	TheProfiler.enabled = enabled;
+	UpdateHook();
+}
+
+void SetLuaFrameBudget(uint32_t microseconds, bool throttle)
+{
+	TheProfiler.budgetUs = microseconds;
+	TheProfiler.throttle = throttle;
+	UpdateHook();
+}
+
+void LuaProfilerEndFrame()
+{
+	if (!TheProfiler.hookInstalled)
+		return;
+	const Clock::time_point now = Clock::now();
+	for (size_t i = 0; i < TheProfiler.mods.size(); ++i) {
+		ModStats &stats = TheProfiler.mods[i];
+		if (i != 0 && TheProfiler.budgetUs != 0 && stats.frameUs > TheProfiler.budgetUs)
+			WarnOverBudget(stats, now);
+		if (TheProfiler.enabled) {
+			stats.totalUs += stats.frameUs;
+			stats.maxFrameUs = std::max(stats.maxFrameUs, stats.frameUs);
+		}
+		stats.frameUs = 0;
+	}
+	if (TheProfiler.enabled)
+		++TheProfiler.frames;
+}
+
+void ResetLuaProfiler()
+{
+	// The chunk names are owned by the chunks of the previous mods.
+	TheProfiler.modBySource.clear();
+	TheProfiler.functions.clear();
+	TheProfiler.totalSamples = 0;
+	TheProfiler.callDepth = 0;
+	// A new Lua state doesn't have the hook yet.
+	TheProfiler.hookInstalled = false;
+	UpdateHook();
+}
+
+std::string LuaProfilerReport(size_t topFunctions)
+{
+	if (!TheProfiler.enabled)
+		return "Lua profiling is off";
+
+	std::string out = fmt::format("Lua time over {} frames:", TheProfiler.frames);
+	const uint64_t frames = std::max<uint64_t>(TheProfiler.frames, 1);
+	for (const ModStats &stats : TheProfiler.mods) {
+		if (stats.totalUs == 0)
+			continue;
+		fmt::format_to(std::back_inserter(out), "\n  {}: {} us/frame, max {} us, total {} ms",
+		    stats.name, stats.totalUs / frames, stats.maxFrameUs, stats.totalUs / 1000);
+	}
+
+	std::vector<const FunctionStats *> functions;
+	functions.reserve(TheProfiler.functions.size());
+	for (const auto &[key, function] : TheProfiler.functions)
+		functions.push_back(&function);
+	const size_t count = std::min(topFunctions, functions.size());
+	std::partial_sort(functions.begin(), functions.begin() + static_cast<std::ptrdiff_t>(count), functions.end(),
+	    [](const FunctionStats *a, const FunctionStats *b) { return a->samples > b->samples; });
+
+	fmt::format_to(std::back_inserter(out), "\nTop functions of {} samples:", TheProfiler.totalSamples);
+	for (size_t i = 0; i < count; ++i) {
+		const FunctionStats &function = *functions[i];
+		fmt::format_to(std::back_inserter(out), "\n  {:5.1f}% {} [{}]",
+		    100.0 * static_cast<double>(function.samples) / static_cast<double>(TheProfiler.totalSamples),
+		    function.location, TheProfiler.mods[function.mod].name);
+	}
+	return out;
+}
+
+} // namespace lua
+} // namespace devilution
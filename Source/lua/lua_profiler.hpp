@@ -0,0 +1,57 @@
+/**
+ * @file lua_profiler.hpp
+ *
+ * Time spent in the event handlers of each mod, sampled with a Lua count hook.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace devilution {
+namespace lua {
+
+/**
+ * @brief Times the outermost Lua call made by the engine, e.g. an event trigger.
+ *
+ * Does nothing unless profiling or the budget is enabled.
+ */
+class ProfiledLuaCall {
+public:
+	ProfiledLuaCall();
+	~ProfiledLuaCall();
+
+	ProfiledLuaCall(const ProfiledLuaCall &) = delete;
+	ProfiledLuaCall &operator=(const ProfiledLuaCall &) = delete;
+
+private:
+	bool active_;
+};
+
+bool IsLuaProfilingEnabled();
+
+/** @brief Starts or stops sampling, starting resets the collected samples. */
+void SetLuaProfilingEnabled(bool enabled);
+
+/**
+ * @brief Limits the time each mod can spend in Lua per frame, 0 disables the budget.
+ *
+ * A mod going over the budget is logged. With `throttle`, the handler that goes over the budget
+ * is stopped with a Lua error, which also skips the remaining handlers of that event.
+ */
+void SetLuaFrameBudget(uint32_t microseconds, bool throttle);
+
+/** @brief Ends the per-frame accounting, called once per frame. */
+void LuaProfilerEndFrame();
+
+/** @brief Forgets the functions of the previous mods, called when the mods are reloaded. */
+void ResetLuaProfiler();
+
+/**
+ * @brief Describes the time spent by each mod and the functions that were sampled the most.
+ */
+std::string LuaProfilerReport(size_t topFunctions);
+
+} // namespace lua
+} // namespace devilution
@@ -7,10 +7,14 @@
 #include "lua/modules/dev/display.hpp"
 #include "lua/modules/dev/items.hpp"
 #include "lua/modules/dev/level.hpp"
+#include "lua/modules/dev/memory.hpp"
+#include "lua/modules/dev/mods.hpp"
 #include "lua/modules/dev/monsters.hpp"
+#include "lua/modules/dev/net.hpp"
 #include "lua/modules/dev/player.hpp"
 #include "lua/modules/dev/quests.hpp"
 #include "lua/modules/dev/search.hpp"
+#include "lua/modules/dev/stress.hpp"
 #include "lua/modules/dev/towners.hpp"
 
 namespace devilution {
@@ -21,10 +25,14 @@ sol::table LuaDevModule(sol::state_view &lua)
 	LuaSetDoc(table, "display", "", "Debugging HUD and rendering commands.", LuaDevDisplayModule(lua));
 	LuaSetDoc(table, "items", "", "Item-related commands.", LuaDevItemsModule(lua));
 	LuaSetDoc(table, "level", "", "Level-related commands.", LuaDevLevelModule(lua));
+	LuaSetDoc(table, "memory", "", "Memory held per subsystem.", LuaDevMemoryModule(lua));
+	LuaSetDoc(table, "mods", "", "Lua mod profiling.", LuaDevModsModule(lua));
 	LuaSetDoc(table, "monsters", "", "Monster-related commands.", LuaDevMonstersModule(lua));
+	LuaSetDoc(table, "net", "", "Network traffic statistics.", LuaDevNetModule(lua));
 	LuaSetDoc(table, "player", "", "Player-related commands.", LuaDevPlayerModule(lua));
 	LuaSetDoc(table, "quests", "", "Quest-related commands.", LuaDevQuestsModule(lua));
 	LuaSetDoc(table, "search", "", "Search the map for monsters / items / objects.", LuaDevSearchModule(lua));
+	LuaSetDoc(table, "stress", "", "Reproducible heavy loads for performance testing.", LuaDevStressModule(lua));
 	LuaSetDoc(table, "towners", "", "Town NPC commands.", LuaDevTownersModule(lua));
 	return table;
 }
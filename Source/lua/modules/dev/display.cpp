@@ -22,6 +22,12 @@ std::string DebugCmdShowGrid(std::optional<bool> on)
 	return StrCat("Tile grid highlighting: ", DebugGrid ? "On" : "Off");
 }
 
+std::string DebugCmdDirtyRegions(std::optional<bool> on)
+{
+	DebugDirtyRegions = on.value_or(!DebugDirtyRegions);
+	return StrCat("Dirty region highlighting: ", DebugDirtyRegions ? "On" : "Off");
+}
+
 std::string DebugCmdVision(std::optional<bool> on)
 {
 	DebugVision = on.value_or(!DebugVision);
@@ -121,6 +127,7 @@ std::string DebugCmdToggleFPS(std::optional<bool> on)
 sol::table LuaDevDisplayModule(sol::state_view &lua)
 {
 	sol::table table = lua.create_table();
+	LuaSetDocFn(table, "dirtyRegions", "(on: boolean = nil)", "Toggle highlighting the redrawn part of the viewport (needs incremental redraw).", &DebugCmdDirtyRegions);
 	LuaSetDocFn(table, "fps", "(name: string = nil)", "Toggle FPS display.", &DebugCmdToggleFPS);
 	LuaSetDocFn(table, "fullbright", "(on: boolean = nil)", "Toggle light shading.", &DebugCmdFullbright);
 	LuaSetDocFn(table, "grid", "(on: boolean = nil)", "Toggle showing the grid.", &DebugCmdShowGrid);
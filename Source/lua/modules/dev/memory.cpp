@@ -0,0 +1,29 @@
+#ifdef _DEBUG
+#include "lua/modules/dev/memory.hpp"
+
+#include <string>
+
+#include <sol/sol.hpp>
+
+#include "lua/metadoc.hpp"
+#include "utils/memory_stats.hpp"
+
+namespace devilution {
+namespace {
+
+std::string DebugCmdMemoryStats()
+{
+	return MemoryStatsReport();
+}
+
+} // namespace
+
+sol::table LuaDevMemoryModule(sol::state_view &lua)
+{
+	sol::table table = lua.create_table();
+	LuaSetDocFn(table, "stats", "()", "Show the memory held by sprites, fonts, dungeon CELs, sounds, Lua, save buffers and network queues, and the peak of each.", &DebugCmdMemoryStats);
+	return table;
+}
+
+} // namespace devilution
+#endif // _DEBUG
@@ -0,0 +1,51 @@
+#ifdef _DEBUG
+#include "lua/modules/dev/mods.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <sol/sol.hpp>
+
+#include "lua/lua_profiler.hpp"
+#include "lua/metadoc.hpp"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+namespace {
+
+std::string DebugCmdModsProfile(std::optional<bool> on)
+{
+	lua::SetLuaProfilingEnabled(on.value_or(!lua::IsLuaProfilingEnabled()));
+	return StrCat("Lua profiling: ", lua::IsLuaProfilingEnabled() ? "On" : "Off");
+}
+
+std::string DebugCmdModsReport(std::optional<int> count)
+{
+	return lua::LuaProfilerReport(static_cast<size_t>(std::max(count.value_or(10), 0)));
+}
+
+std::string DebugCmdModsBudget(std::optional<int> milliseconds, std::optional<bool> throttle)
+{
+	const int budgetMs = std::max(milliseconds.value_or(0), 0);
+	lua::SetLuaFrameBudget(static_cast<uint32_t>(budgetMs) * 1000, throttle.value_or(false));
+	if (budgetMs == 0)
+		return "Lua budget: Off";
+	return StrCat("Lua budget: ", budgetMs, " ms per mod and frame", throttle.value_or(false) ? ", throttled" : "");
+}
+
+} // namespace
+
+sol::table LuaDevModsModule(sol::state_view &lua)
+{
+	sol::table table = lua.create_table();
+	LuaSetDocFn(table, "budget", "(ms: number = 0, throttle: boolean = false)", "Warn when a mod spends more than `ms` in Lua in one frame, 0 turns it off. With `throttle`, the handler going over the budget is stopped.", &DebugCmdModsBudget);
+	LuaSetDocFn(table, "profile", "(on: boolean = nil)", "Toggle sampling the time each mod spends in event handlers.", &DebugCmdModsProfile);
+	LuaSetDocFn(table, "report", "(count: number = 10)", "Show the time spent by each mod and the most sampled functions.", &DebugCmdModsReport);
+	return table;
+}
+
+} // namespace devilution
+#endif // _DEBUG
@@ -4,6 +4,7 @@
 #include <optional>
 #include <string>
 
+#include <magic_enum/magic_enum.hpp>
 #include <sol/sol.hpp>
 
 #include "crawl.hpp"
@@ -12,6 +13,7 @@
 #include "lighting.h"
 #include "lua/metadoc.hpp"
 #include "monster.h"
+#include "monsters/player_flow_field.hpp"
 #include "player.h"
 #include "tables/monstdat.h"
 #include "utils/str_case.hpp"
@@ -167,6 +169,21 @@ std::string DebugCmdSpawnMonster(std::string name, std::optional<unsigned> count
 	return StrCat("Spawned ", spawnedMonster, " monsters.");
 }
 
+std::string DebugCmdUsePlayerFlowField(std::string aiName, std::optional<bool> enabledOpt)
+{
+	const bool enabled = enabledOpt.value_or(true);
+	const std::string_view verb = enabled ? "use" : "don't use";
+	if (aiName == "all") {
+		for (const MonsterAIID ai : magic_enum::enum_values<MonsterAIID>())
+			SetUsesPlayerFlowField(ai, enabled);
+		return StrCat("All monsters ", verb, " the flow field.");
+	}
+	const std::optional<MonsterAIID> ai = magic_enum::enum_cast<MonsterAIID>(aiName);
+	if (!ai.has_value() || *ai == MonsterAIID::Invalid) return "AI not found";
+	SetUsesPlayerFlowField(*ai, enabled);
+	return StrCat("Monsters with ", aiName, " AI ", verb, " the flow field.");
+}
+
 } // namespace
 
 sol::table LuaDevMonstersModule(sol::state_view &lua)
@@ -174,6 +191,7 @@ sol::table LuaDevMonstersModule(sol::state_view &lua)
 	sol::table table = lua.create_table();
 	LuaSetDocFn(table, "spawn", "(name: string, count: number = 1)", "Spawn monster(s)", &DebugCmdSpawnMonster);
 	LuaSetDocFn(table, "spawnUnique", "(name: string, count: number = 1)", "Spawn unique monster(s)", &DebugCmdSpawnUniqueMonster);
+	LuaSetDocFn(table, "flowField", "(ai: string, enabled: boolean = true)", "Let monsters with the given AI (or \"all\") chase players using the flow field", &DebugCmdUsePlayerFlowField);
 	return table;
 }
 
@@ -0,0 +1,46 @@
+#ifdef _DEBUG
+#include "lua/modules/dev/net.hpp"
+
+#include <optional>
+#include <string>
+
+#include <sol/sol.hpp>
+
+#include "lua/metadoc.hpp"
+#include "net_stats.hpp"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+namespace {
+
+std::string DebugCmdNetStats()
+{
+	return NetStatsReport();
+}
+
+std::string DebugCmdNetStatsEnable(std::optional<bool> on)
+{
+	SetNetStatsEnabled(on.value_or(!IsNetStatsEnabled()));
+	return StrCat("Network stats: ", IsNetStatsEnabled() ? "On" : "Off");
+}
+
+std::string DebugCmdNetStatsCsv(std::optional<bool> on)
+{
+	if (!SetNetStatsCsvLog(on.value_or(true)))
+		return "Failed to open net_stats.csv";
+	return StrCat("Network stats CSV log: ", on.value_or(true) ? "On" : "Off");
+}
+
+} // namespace
+
+sol::table LuaDevNetModule(sol::state_view &lua)
+{
+	sol::table table = lua.create_table();
+	LuaSetDocFn(table, "csv", "(on: boolean = true)", "Log the traffic of every second to net_stats.csv in the pref path.", &DebugCmdNetStatsCsv);
+	LuaSetDocFn(table, "enable", "(on: boolean = nil)", "Toggle counting network traffic per command and peer.", &DebugCmdNetStatsEnable);
+	LuaSetDocFn(table, "stats", "()", "Show the network traffic of the last second and since counting started.", &DebugCmdNetStats);
+	return table;
+}
+
+} // namespace devilution
+#endif // _DEBUG
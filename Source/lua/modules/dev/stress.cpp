@@ -0,0 +1,34 @@
+#ifdef _DEBUG
+#include "lua/modules/dev/stress.hpp"
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <sol/sol.hpp>
+
+#include "engine/stress_bench.hpp"
+#include "lua/metadoc.hpp"
+
+namespace devilution {
+namespace {
+
+std::string DebugCmdBuildStressScenario(std::string_view name)
+{
+	const std::optional<StressScenario> scenario = ParseStressScenario(name);
+	if (!scenario.has_value())
+		return "Unknown scenario, try monsters, missiles, lights or items";
+	return BuildStressScenario(*scenario);
+}
+
+} // namespace
+
+sol::table LuaDevStressModule(sol::state_view &lua)
+{
+	sol::table table = lua.create_table();
+	LuaSetDocFn(table, "build", "(scenario: 'monsters'|'missiles'|'lights'|'items')", "Build the same heavy load around the hero as `--stress` does.", &DebugCmdBuildStressScenario);
+	return table;
+}
+
+} // namespace devilution
+#endif // _DEBUG
@@ -0,0 +1,10 @@
+#pragma once
+#ifdef _DEBUG
+#include <sol/sol.hpp>
+
+namespace devilution {
+
+sol::table LuaDevStressModule(sol::state_view &lua);
+
+} // namespace devilution
+#endif // _DEBUG
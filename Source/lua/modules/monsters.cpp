@@ -1,5 +1,6 @@
 #include "lua/modules/monsters.hpp"
 
+#include <optional>
 #include <string_view>
 
 #include <fmt/format.h>
@@ -7,6 +8,7 @@
 
 #include "data/file.hpp"
 #include "engine/point.hpp"
+#include "lua/lua_event.hpp"
 #include "lua/metadoc.hpp"
 #include "monster.h"
 #include "tables/monstdat.h"
@@ -44,11 +46,44 @@ void InitMonsterUserType(sol::state_view &lua)
 	    });
 }
 
+const lua::MonsterDamageRecord *GetDamageRecord(const lua::MonsterDamageBatch &batch, size_t index)
+{
+	if (index < 1 || index > batch.records.size()) return nullptr;
+	return &batch.records[index - 1];
+}
+
+void InitMonsterDamageBatchUserType(sol::state_view &lua)
+{
+	sol::usertype<lua::MonsterDamageBatch> batchType = lua.new_usertype<lua::MonsterDamageBatch>(sol::no_constructor,
+	    sol::meta_function::length, [](const lua::MonsterDamageBatch &batch) { return batch.records.size(); });
+	LuaSetDocFn(batchType, "monster", "(index: integer) -> Monster",
+	    "The monster that took the damage, indices start at 1",
+	    [](const lua::MonsterDamageBatch &batch, size_t index) -> const Monster * {
+		    const lua::MonsterDamageRecord *record = GetDamageRecord(batch, index);
+		    return record != nullptr ? record->monster : nullptr;
+	    });
+	LuaSetDocFn(batchType, "damage", "(index: integer) -> integer",
+	    "The amount of damage",
+	    [](const lua::MonsterDamageBatch &batch, size_t index) -> std::optional<int> {
+		    const lua::MonsterDamageRecord *record = GetDamageRecord(batch, index);
+		    if (record == nullptr) return std::nullopt;
+		    return record->damage;
+	    });
+	LuaSetDocFn(batchType, "damageType", "(index: integer) -> integer",
+	    "The type of damage",
+	    [](const lua::MonsterDamageBatch &batch, size_t index) -> std::optional<int> {
+		    const lua::MonsterDamageRecord *record = GetDamageRecord(batch, index);
+		    if (record == nullptr) return std::nullopt;
+		    return record->damageType;
+	    });
+}
+
 } // namespace
 
 sol::table LuaMonstersModule(sol::state_view &lua)
 {
 	InitMonsterUserType(lua);
+	InitMonsterDamageBatchUserType(lua);
 	sol::table table = lua.create_table();
 	LuaSetDocFn(table, "addMonsterDataFromTsv", "(path: string)", AddMonsterDataFromTsv);
 	LuaSetDocFn(table, "addUniqueMonsterDataFromTsv", "(path: string)", AddUniqueMonsterDataFromTsv);
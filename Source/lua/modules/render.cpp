@@ -1,21 +1,88 @@
 #include "lua/modules/render.hpp"
 
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include <sol/sol.hpp>
 
 #include "DiabloUI/ui_flags.hpp"
 #include "engine/dx.h"
+#include "engine/point.hpp"
 #include "engine/render/text_render.hpp"
 #include "lua/metadoc.hpp"
+#include "utils/algorithm/container.hpp"
 #include "utils/display.h"
 
 namespace devilution {
 
+namespace {
+
+/** @brief A string that the engine draws every frame until the mod removes it, so that HUD mods don't call into C++ for each string of each frame. */
+struct RetainedString {
+	int handle;
+	std::string text;
+	Point position;
+	UiFlags flags;
+};
+
+std::vector<RetainedString> RetainedStrings;
+int NextRetainedStringHandle = 1;
+
+RetainedString *FindRetainedString(int handle)
+{
+	const auto it = c_find_if(RetainedStrings, [handle](const RetainedString &string) { return string.handle == handle; });
+	return it != RetainedStrings.end() ? &*it : nullptr;
+}
+
+} // namespace
+
+void DrawLuaRetainedStrings()
+{
+	if (RetainedStrings.empty())
+		return;
+	const Surface &out = GlobalBackBuffer();
+	for (const RetainedString &string : RetainedStrings)
+		DrawString(out, string.text, string.position, { .flags = string.flags });
+}
+
+void ClearLuaRetainedStrings()
+{
+	RetainedStrings.clear();
+}
+
 sol::table LuaRenderModule(sol::state_view &lua)
 {
 	sol::table table = lua.create_table();
 	LuaSetDocFn(table, "string", "(text: string, x: integer, y: integer)",
 	    "Renders a string at the given coordinates",
 	    [](std::string_view text, int x, int y) { DrawString(GlobalBackBuffer(), text, { x, y }); });
+	LuaSetDocFn(table, "add_string", "(text: string, x: integer, y: integer, flags: UiFlags = UiFlags.None)",
+	    "Adds a string that is drawn every frame until it is removed, returns its handle",
+	    [](std::string_view text, int x, int y, std::optional<UiFlags> flags) {
+		    const int handle = NextRetainedStringHandle++;
+		    RetainedStrings.push_back({ handle, std::string(text), { x, y }, flags.value_or(UiFlags::None) });
+		    return handle;
+	    });
+	LuaSetDocFn(table, "set_string", "(handle: integer, text: string, x: integer, y: integer, flags: UiFlags = UiFlags.None)",
+	    "Changes a string added with add_string, returns false if there is none with the handle",
+	    [](int handle, std::string_view text, int x, int y, std::optional<UiFlags> flags) {
+		    RetainedString *string = FindRetainedString(handle);
+		    if (string == nullptr)
+			    return false;
+		    string->text = text;
+		    string->position = { x, y };
+		    string->flags = flags.value_or(UiFlags::None);
+		    return true;
+	    });
+	LuaSetDocFn(table, "remove_string", "(handle: integer)",
+	    "Stops drawing a string added with add_string",
+	    [](int handle) {
+		    std::erase_if(RetainedStrings, [handle](const RetainedString &string) { return string.handle == handle; });
+	    });
+	LuaSetDocFn(table, "clear_strings", "()",
+	    "Stops drawing all strings added with add_string", []() { ClearLuaRetainedStrings(); });
 	LuaSetDocFn(table, "screen_width", "()",
 	    "Returns the screen width", []() { return gnScreenWidth; });
 	LuaSetDocFn(table, "screen_height", "()",
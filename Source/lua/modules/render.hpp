@@ -6,4 +6,10 @@ namespace devilution {
 
 sol::table LuaRenderModule(sol::state_view &lua);
 
+/** @brief Draws the strings that mods added with `render.add_string`, once per frame after the `GameDrawComplete` event. */
+void DrawLuaRetainedStrings();
+
+/** @brief Drops the strings that mods added, e.g. when the mods are unloaded. */
+void ClearLuaRetainedStrings();
+
 } // namespace devilution
@@ -10,6 +10,7 @@
 #include <sol/sol.hpp>
 #include <sol/utility/to_string.hpp>
 
+#include "lua/autocomplete.hpp"
 #include "lua/lua_global.hpp"
 #include "panels/console.hpp"
 #include "utils/str_cat.hpp"
@@ -90,6 +91,7 @@ sol::environment &GetLuaReplEnvironment()
 tl::expected<std::string, std::string> RunLuaReplLine(std::string_view code)
 {
 	const sol::protected_function_result result = TryRunLuaAsExpressionThenStatement(code);
+	ClearLuaAutocompleteIndex();
 	if (!result.valid()) {
 		if (result.get_type() == sol::type::string) {
 			return tl::make_unexpected(result.get<std::string>());
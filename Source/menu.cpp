@@ -17,6 +17,8 @@
 #include "DiabloUI/settingsmenu.h"
 #include "engine/assets.hpp"
 #include "engine/demomode.h"
+#include "engine/stress_bench.hpp"
+#include "engine/transition_bench.hpp"
 #include "game_mode.hpp"
 #include "init.hpp"
 #include "movie.h"
@@ -108,6 +110,10 @@ bool mainmenu_select_hero_dialog(GameData *gameData)
 	if (demo::IsRunning()) {
 		pfile_ui_set_hero_infos(DummyGetHeroInfo);
 		gbLoadGame = true;
+	} else if (IsTransitionBenchRunning() || IsStressBenchRunning()) {
+		gSaveNumber = gbIsHellfire ? *GetOptions().Hellfire.lastSinglePlayerHero : *GetOptions().Diablo.lastSinglePlayerHero;
+		pfile_ui_set_hero_infos(DummyGetHeroInfo);
+		gbLoadGame = true;
 	} else if (!gbIsMultiplayer) {
 		pSaveNumberFromOptions = gbIsHellfire ? &GetOptions().Hellfire.lastSinglePlayerHero : &GetOptions().Diablo.lastSinglePlayerHero;
 		gSaveNumber = **pSaveNumberFromOptions;
@@ -158,7 +164,7 @@ void mainmenu_loop()
 
 	do {
 		_mainmenu_selections menu = MAINMENU_NONE;
-		if (demo::IsRunning())
+		if (demo::IsRunning() || IsTransitionBenchRunning() || IsStressBenchRunning())
 			menu = MAINMENU_SINGLE_PLAYER;
 		else if (!UiMainMenuDialog(gszProductName, &menu, 30))
 			app_fatal(_("Unable to display mainmenu"));
@@ -13,7 +13,6 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
-#include <list>
 #include <optional>
 #include <type_traits>
 #include <utility>
@@ -51,6 +50,7 @@
 #include "tables/playerdat.hpp"
 #include "tables/spelldat.h"
 #include "utils/enum_traits.h"
+#include "utils/frame_profiler.hpp"
 #ifdef _DEBUG
 #include "debug.h"
 #endif
@@ -70,7 +70,7 @@
 
 namespace devilution {
 
-std::list<Missile> Missiles;
+PooledList<Missile, MissilePoolChunkSize> Missiles;
 bool MissilePreFlag;
 
 void Missile::setAnimation(MissileGraphicID animtype)
@@ -4219,6 +4219,7 @@ void ProcessManaShield()
 
 void ProcessMissiles()
 {
+	DVL_PROFILE_ZONE("ProcessMissiles");
 	for (auto &missile : Missiles) {
 		const auto &position = missile.position.tile;
 		if (InDungeonBounds(position)) {
@@ -4232,6 +4233,8 @@ void ProcessMissiles()
 
 	MissilePreFlag = false;
 
+	// The missiles must be processed in list order, they draw from the game RNG and collide with each other,
+	// and missiles added by the ones processed here run in this pass too.
 	for (auto &missile : Missiles) {
 		const MissileData &missileData = GetMissileData(missile._mitype);
 		if (missileData.processFn != nullptr)
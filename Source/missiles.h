@@ -5,8 +5,8 @@
  */
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
-#include <list>
 #include <optional>
 
 #include "engine/displacement.hpp"
@@ -17,6 +17,7 @@
 #include "tables/misdat.h"
 #include "tables/spelldat.h"
 #include "utils/is_of.hpp"
+#include "utils/pooled_list.hpp"
 
 namespace devilution {
 
@@ -235,7 +236,10 @@ public:
 	}
 };
 
-extern std::list<Missile> Missiles;
+/** @brief Number of missiles allocated at once when the missile pool has to grow. */
+constexpr size_t MissilePoolChunkSize = 128;
+
+extern PooledList<Missile, MissilePoolChunkSize> Missiles;
 extern bool MissilePreFlag;
 
 struct DamageRange {
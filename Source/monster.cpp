@@ -19,6 +19,7 @@
 #include <memory>
 #include <numeric>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -30,6 +31,7 @@
 #include <SDL.h>
 #endif
 
+#include <ankerl/unordered_dense.h>
 #include <expected.hpp>
 #include <fmt/core.h>
 
@@ -49,6 +51,7 @@
 #include "engine/load_cl2.hpp"
 #include "engine/load_file.hpp"
 #include "engine/path.h"
+#include "engine/path_impl.hpp"
 #include "engine/point.hpp"
 #include "engine/points_in_rectangle_range.hpp"
 #include "engine/random.hpp"
@@ -73,6 +76,7 @@
 #include "lua/lua_event.hpp"
 #include "minitext.h"
 #include "missiles.h"
+#include "monsters/player_flow_field.hpp"
 #include "movie.h"
 #include "msg.h"
 #include "multi.h"
@@ -95,6 +99,7 @@
 #include "utils/endian_swap.hpp"
 #include "utils/enum_traits.h"
 #include "utils/file_name_generator.hpp"
+#include "utils/frame_profiler.hpp"
 #include "utils/is_of.hpp"
 #include "utils/language.h"
 #include "utils/log.hpp"
@@ -102,6 +107,7 @@
 #include "utils/static_vector.hpp"
 #include "utils/status_macros.hpp"
 #include "utils/str_cat.hpp"
+#include "utils/task_graph.hpp"
 
 #ifdef _DEBUG
 #include "debug.h"
@@ -152,6 +158,164 @@ constexpr const std::array<_monster_id, 12> SkeletonTypes {
 /** Maps from monster action to monster animation letter. */
 constexpr char Animletter[7] = "nwahds";
 
+#ifdef DEVILUTIONX_MONSTER_GFX_BUDGET
+/** @brief How much memory the monster graphics that are not used by the current level may take up. */
+constexpr size_t MonsterSpritesBudget = DEVILUTIONX_MONSTER_GFX_BUDGET;
+#else
+constexpr size_t MonsterSpritesBudget = 32 * 1024 * 1024;
+#endif
+
+/** @brief Monster graphics with their TRN applied, kept across levels. */
+struct MonsterSpritesCacheEntry {
+	std::shared_ptr<std::byte[]> data;
+	std::array<uint32_t, MonsterSpritesData::MaxAnims + 1> offsets;
+	size_t size;
+	uint32_t lastUsed;
+};
+
+/** @brief Keyed by the sprite path and the TRN file. */
+ankerl::unordered_dense::map<std::string, MonsterSpritesCacheEntry> MonsterSpritesCache;
+uint32_t MonsterSpritesUseCounter;
+
+std::string GetMonsterSpritesCacheKey(const MonsterData &monsterData)
+{
+	return StrCat(monsterData.spritePath(), "|", monsterData.trnFile);
+}
+
+/**
+ * @brief Unloads the least recently used graphics until the unused ones fit the budget.
+ */
+void TrimMonsterSpritesCache()
+{
+	size_t unusedSize = 0;
+	for (const auto &[key, entry] : MonsterSpritesCache) {
+		if (entry.data.use_count() == 1)
+			unusedSize += entry.size;
+	}
+	while (unusedSize > MonsterSpritesBudget) {
+		auto oldest = MonsterSpritesCache.end();
+		for (auto it = MonsterSpritesCache.begin(); it != MonsterSpritesCache.end(); ++it) {
+			if (it->second.data.use_count() == 1 && (oldest == MonsterSpritesCache.end() || it->second.lastUsed < oldest->second.lastUsed))
+				oldest = it;
+		}
+		unusedSize -= oldest->second.size;
+		MonsterSpritesCache.erase(oldest);
+	}
+}
+
+/**
+ * @brief Monsters that regular monsters can pick as their enemy, collected once per `ProcessMonsters` tick.
+ *
+ * Regular monsters only ever go after golems (berserked monsters count as golems),
+ * so `UpdateEnemy` can skip the scan over all active monsters for them.
+ */
+struct MonsterEnemyCandidates {
+	/** @brief Cleared whenever the active monsters or their golem flags may have changed. */
+	bool valid = false;
+	/** @brief Golems in `ActiveMonsters` order, the order decides ties. */
+	StaticVector<unsigned, MaxMonsters> golems;
+};
+
+MonsterEnemyCandidates EnemyCandidates;
+
+void InvalidateEnemyCandidates()
+{
+	EnemyCandidates.valid = false;
+}
+
+void CollectEnemyCandidates()
+{
+	EnemyCandidates.golems.clear();
+	for (size_t i = 0; i < ActiveMonsterCount; i++) {
+		const unsigned monsterId = ActiveMonsters[i];
+		if ((Monsters[monsterId].flags & MFLAG_GOLEM) != 0)
+			EnemyCandidates.golems.push_back(monsterId);
+	}
+	EnemyCandidates.valid = true;
+}
+
+/**
+ * @brief The minions of every leader, collected once per tick by `ProcessMonsters`.
+ *
+ * Lets `DirOK` count the leashed minions around a leader by looking at its own pack,
+ * instead of scanning the monsters on the tiles around it.
+ */
+struct MonsterPacks {
+	static_assert(MaxMonsters <= UINT8_MAX);
+
+	/** @brief Cleared whenever monsters may have been added or removed. */
+	bool valid = false;
+	/** @brief The members of the leader with id `i` are `members[first[i]]` up to `members[first[i + 1]]`. */
+	std::array<uint8_t, MaxMonsters + 1> first;
+	/** @brief Ids of the minions that are or can become leashed again, grouped by leader. */
+	std::array<uint8_t, MaxMonsters> members;
+
+	[[nodiscard]] std::span<const uint8_t> of(const Monster &leader) const
+	{
+		const size_t leaderId = leader.getId();
+		return { &members[first[leaderId]], static_cast<size_t>(first[leaderId + 1] - first[leaderId]) };
+	}
+};
+
+MonsterPacks Packs;
+
+void InvalidateMonsterPacks()
+{
+	Packs.valid = false;
+}
+
+void CollectMonsterPacks()
+{
+	std::array<uint8_t, MaxMonsters> sizes {};
+	for (size_t i = 0; i < ActiveMonsterCount; i++) {
+		const Monster &monster = Monsters[ActiveMonsters[i]];
+		// A minion that lost its leader never rejoins a pack
+		if (monster.leaderRelation != LeaderRelation::None)
+			sizes[monster.leader]++;
+	}
+	Packs.first[0] = 0;
+	for (size_t i = 0; i < MaxMonsters; i++)
+		Packs.first[i + 1] = static_cast<uint8_t>(Packs.first[i] + sizes[i]);
+
+	std::array<uint8_t, MaxMonsters> next;
+	std::copy_n(Packs.first.begin(), MaxMonsters, next.begin());
+	for (size_t i = 0; i < ActiveMonsterCount; i++) {
+		const unsigned monsterId = ActiveMonsters[i];
+		const Monster &monster = Monsters[monsterId];
+		if (monster.leaderRelation != LeaderRelation::None)
+			Packs.members[next[monster.leader]++] = static_cast<uint8_t>(monsterId);
+	}
+	Packs.valid = true;
+}
+
+/**
+ * @brief Counts the leashed minions of `leader` within 3 tiles of `position`.
+ *
+ * Gives the same count as looking up the monster on each of these tiles, while
+ * only visiting the pack of the leader.
+ */
+int CountLeashedMinionsAround(const Monster &leader, Point position)
+{
+	int count = 0;
+	for (const uint8_t minionId : Packs.of(leader)) {
+		const Monster &minion = Monsters[minionId];
+		if (minion.leaderRelation != LeaderRelation::Leashed || minion.getLeader() != &leader)
+			continue;
+		// A monster is found on the tiles it occupies without moving, which are among these
+		const std::array<Point, 3> tiles { minion.position.tile, minion.position.old, minion.position.future };
+		for (size_t i = 0; i < tiles.size(); i++) {
+			const Point tile = tiles[i];
+			if (std::find(tiles.begin(), tiles.begin() + i, tile) != tiles.begin() + i)
+				continue;
+			if (std::abs(tile.x - position.x) > 3 || std::abs(tile.y - position.y) > 3 || !InDungeonBounds(tile))
+				continue;
+			if (dMonster[tile.x][tile.y] == minionId + 1)
+				count++;
+		}
+	}
+	return count;
+}
+
 size_t GetNumAnims(const MonsterData &monsterData)
 {
 	return monsterData.hasSpecial ? 6 : 5;
@@ -195,6 +359,8 @@ void InitMonsterTRN(CMonster &monst)
 
 void InitMonster(Monster &monster, Direction rd, size_t typeIndex, Point position)
 {
+	InvalidateEnemyCandidates();
+	InvalidateMonsterPacks();
 	monster.direction = rd;
 	monster.position.tile = position;
 	monster.position.future = position;
@@ -546,24 +712,24 @@ tl::expected<void, std::string> PlaceQuestMonsters()
 		}
 
 		if (Quests[Q_LTBANNER].IsAvailable()) {
-			auto dunData = LoadFileInMem<uint16_t>("levels\\l1data\\banner1.dun");
-			RETURN_IF_ERROR(SetMapMonsters(dunData.get(), SetPiece.position.megaToWorld()));
+			const uint16_t *dunData = LoadFileInArena<uint16_t>("levels\\l1data\\banner1.dun", LevelArena);
+			RETURN_IF_ERROR(SetMapMonsters(dunData, SetPiece.position.megaToWorld()));
 		}
 		if (Quests[Q_BLOOD].IsAvailable()) {
-			auto dunData = LoadFileInMem<uint16_t>("levels\\l2data\\blood2.dun");
-			RETURN_IF_ERROR(SetMapMonsters(dunData.get(), SetPiece.position.megaToWorld()));
+			const uint16_t *dunData = LoadFileInArena<uint16_t>("levels\\l2data\\blood2.dun", LevelArena);
+			RETURN_IF_ERROR(SetMapMonsters(dunData, SetPiece.position.megaToWorld()));
 		}
 		if (Quests[Q_BLIND].IsAvailable()) {
-			auto dunData = LoadFileInMem<uint16_t>("levels\\l2data\\blind2.dun");
-			RETURN_IF_ERROR(SetMapMonsters(dunData.get(), SetPiece.position.megaToWorld()));
+			const uint16_t *dunData = LoadFileInArena<uint16_t>("levels\\l2data\\blind2.dun", LevelArena);
+			RETURN_IF_ERROR(SetMapMonsters(dunData, SetPiece.position.megaToWorld()));
 		}
 		if (Quests[Q_ANVIL].IsAvailable()) {
-			auto dunData = LoadFileInMem<uint16_t>("levels\\l3data\\anvil.dun");
-			RETURN_IF_ERROR(SetMapMonsters(dunData.get(), SetPiece.position.megaToWorld() + Displacement { 2, 2 }));
+			const uint16_t *dunData = LoadFileInArena<uint16_t>("levels\\l3data\\anvil.dun", LevelArena);
+			RETURN_IF_ERROR(SetMapMonsters(dunData, SetPiece.position.megaToWorld() + Displacement { 2, 2 }));
 		}
 		if (Quests[Q_WARLORD].IsAvailable()) {
-			auto dunData = LoadFileInMem<uint16_t>("levels\\l4data\\warlord.dun");
-			RETURN_IF_ERROR(SetMapMonsters(dunData.get(), SetPiece.position.megaToWorld()));
+			const uint16_t *dunData = LoadFileInArena<uint16_t>("levels\\l4data\\warlord.dun", LevelArena);
+			RETURN_IF_ERROR(SetMapMonsters(dunData, SetPiece.position.megaToWorld()));
 			RETURN_IF_ERROR(AddMonsterType(UniqueMonsterType::WarlordOfBlood, PLACE_SCATTER));
 		}
 		if (Quests[Q_VEIL].IsAvailable()) {
@@ -579,8 +745,8 @@ tl::expected<void, std::string> PlaceQuestMonsters()
 			RETURN_IF_ERROR(PlaceUniqueMonst(UniqueMonsterType::Lazarus, 0, 0));
 			RETURN_IF_ERROR(PlaceUniqueMonst(UniqueMonsterType::RedVex, 0, 0));
 			RETURN_IF_ERROR(PlaceUniqueMonst(UniqueMonsterType::BlackJade, 0, 0));
-			auto dunData = LoadFileInMem<uint16_t>("levels\\l4data\\vile1.dun");
-			RETURN_IF_ERROR(SetMapMonsters(dunData.get(), SetPiece.position.megaToWorld()));
+			const uint16_t *dunData = LoadFileInArena<uint16_t>("levels\\l4data\\vile1.dun", LevelArena);
+			RETURN_IF_ERROR(SetMapMonsters(dunData, SetPiece.position.megaToWorld()));
 		}
 
 		if (currlevel == 24) {
@@ -641,6 +807,8 @@ void DeleteMonster(size_t activeIndex)
 	}
 
 	ActiveMonsterCount--;
+	InvalidateEnemyCandidates();
+	InvalidateMonsterPacks();
 	std::swap(ActiveMonsters[activeIndex], ActiveMonsters[ActiveMonsterCount]); // This ensures alive monsters are before ActiveMonsterCount in the array and any deleted monster after
 
 	for (size_t i = 0; i < ActiveMonsterCount; i++) {
@@ -704,19 +872,18 @@ void UpdateEnemy(Monster &monster)
 			}
 		}
 	}
-	for (size_t i = 0; i < ActiveMonsterCount; i++) {
-		const unsigned monsterId = ActiveMonsters[i];
+	const auto considerMonster = [&](unsigned monsterId) {
 		Monster &otherMonster = Monsters[monsterId];
 		if (&otherMonster == &monster)
-			continue;
+			return;
 		if (otherMonster.hasNoLife())
-			continue;
+			return;
 		if (otherMonster.position.tile == GolemHoldingCell)
-			continue;
+			return;
 		if (otherMonster.talkMsg != TEXT_NONE && M_Talker(otherMonster))
-			continue;
+			return;
 		if (isPlayerMinion && otherMonster.isPlayerMinion()) // prevent golems from fighting each other
-			continue;
+			return;
 
 		const int dist = otherMonster.position.tile.WalkingDistance(position);
 		if (((monster.flags & MFLAG_GOLEM) == 0
@@ -726,7 +893,7 @@ void UpdateEnemy(Monster &monster)
 		    || ((monster.flags & MFLAG_GOLEM) == 0
 		        && (monster.flags & MFLAG_BERSERK) == 0
 		        && (otherMonster.flags & MFLAG_GOLEM) == 0)) {
-			continue;
+			return;
 		}
 		const bool sameroom = dTransVal[position.x][position.y] == dTransVal[otherMonster.position.tile.x][otherMonster.position.tile.y];
 		if ((sameroom && !bestsameroom)
@@ -738,6 +905,13 @@ void UpdateEnemy(Monster &monster)
 			bestDist = dist;
 			bestsameroom = sameroom;
 		}
+	};
+	if ((monster.flags & (MFLAG_GOLEM | MFLAG_BERSERK)) == 0 && EnemyCandidates.valid) {
+		for (const unsigned monsterId : EnemyCandidates.golems)
+			considerMonster(monsterId);
+	} else {
+		for (size_t i = 0; i < ActiveMonsterCount; i++)
+			considerMonster(ActiveMonsters[i]);
 	}
 	if (menemy != -1) {
 		monster.flags &= ~MFLAG_NO_ENEMY;
@@ -1667,9 +1841,59 @@ bool LineClear(tl::function_ref<bool(Point)> clear, Point startPoint, Point endP
 	return position == endPoint;
 }
 
+enum class LineOfSightKind : uint8_t {
+	NotSolid,
+	Missile,
+	MovingMissile,
+};
+
+struct LineOfSightEntry {
+	uint32_t generation;
+	uint32_t key;
+	bool clear;
+};
+
+constexpr unsigned LineOfSightCacheBits = 12;
+
+/**
+ * @brief Direct-mapped cache of `LineClear` results for the callbacks that only depend on the map and objects.
+ *
+ * Entries from an older generation are stale, see `InvalidateLineOfSightCache`.
+ */
+std::array<LineOfSightEntry, 1 << LineOfSightCacheBits> LineOfSightCache;
+uint32_t LineOfSightGeneration = 1;
+
+bool CachedLineClear(LineOfSightKind kind, tl::function_ref<bool(Point)> clear, Point startPoint, Point endPoint)
+{
+	if (!InDungeonBounds(startPoint) || !InDungeonBounds(endPoint))
+		return LineClear(clear, startPoint, endPoint);
+
+	static_assert(MAXDUNX <= 128 && MAXDUNY <= 128, "Coordinates must fit in 7 bits");
+	const uint32_t key = (static_cast<uint32_t>(kind) << 28)
+	    | (static_cast<uint32_t>(startPoint.x) << 21) | (static_cast<uint32_t>(startPoint.y) << 14)
+	    | (static_cast<uint32_t>(endPoint.x) << 7) | static_cast<uint32_t>(endPoint.y);
+	LineOfSightEntry &entry = LineOfSightCache[(key * 0x9E3779B1U) >> (32 - LineOfSightCacheBits)];
+	if (entry.generation == LineOfSightGeneration && entry.key == key)
+		return entry.clear;
+
+	const bool result = LineClear(clear, startPoint, endPoint);
+	entry = LineOfSightEntry { LineOfSightGeneration, key, result };
+	return result;
+}
+
 bool IsLineNotSolid(Point startPoint, Point endPoint)
 {
-	return LineClear(IsTileNotSolid, startPoint, endPoint);
+	return CachedLineClear(LineOfSightKind::NotSolid, IsTileNotSolid, startPoint, endPoint);
+}
+
+void RegenerateHitPoints(Monster &monster)
+{
+	if (monster.hitPoints >= monster.maxHitPoints || monster.hasNoLife())
+		return;
+
+	const unsigned level = monster.level(sgGameInitInfo.nDifficulty);
+	monster.hitPoints += static_cast<int>(level > 1 ? level / 2 : level);
+	monster.hitPoints = std::min(monster.hitPoints, monster.maxHitPoints); // prevent going over max HP with part of a single regen tick
 }
 
 void FollowTheLeader(Monster &monster)
@@ -1694,6 +1918,31 @@ void FollowTheLeader(Monster &monster)
 	monster.mode = MonsterMode::SpecialMeleeAttack;
 }
 
+/**
+ * @brief Plays the greeting of a unique monster and picks its first enemy, when an inactive monster is seen.
+ *
+ * Kept out of line, as it happens once per encounter and not on every tick of `ProcessMonsters`.
+ */
+DVL_NO_INLINE void StartEncounter(Monster &monster)
+{
+	if (monster.type().type == MT_CLEAVER) {
+		PlaySFX(SfxID::ButcherGreeting);
+	}
+	if (monster.type().type == MT_NAKRUL) {
+		if (sgGameInitInfo.bCowQuest != 0) {
+			PlaySFX(SfxID::NaKrul6);
+		} else {
+			if (IsUberRoomOpened)
+				PlaySFX(SfxID::NaKrul4);
+			else
+				PlaySFX(SfxID::NaKrul5);
+		}
+	}
+	if (monster.type().type == MT_DEFILER)
+		PlaySFX(SfxID::Defiler8);
+	UpdateEnemy(monster);
+}
+
 void GroupUnity(Monster &monster)
 {
 	if (monster.leaderRelation == LeaderRelation::None)
@@ -1813,6 +2062,16 @@ bool IsTileAccessible(const Monster &monster, Point position)
 	return IsTileSafe(monster, position);
 }
 
+/** @brief `IsTileAccessible` as a function object, so that the path search monsters walk with inlines it. */
+struct MonsterPosOk {
+	const Monster &monster;
+
+	bool operator()(Point position) const
+	{
+		return IsTileAccessible(monster, position);
+	}
+};
+
 bool AiPlanWalk(Monster &monster)
 {
 	int8_t path[MaxPathLengthMonsters];
@@ -1820,7 +2079,18 @@ bool AiPlanWalk(Monster &monster)
 	/** Maps from walking path step to facing direction. */
 	const Direction plr2monst[9] = { Direction::South, Direction::NorthEast, Direction::NorthWest, Direction::SouthEast, Direction::SouthWest, Direction::North, Direction::East, Direction::South, Direction::West };
 
-	if (FindPath(CanStep, [&monster](Point position) { return IsTileAccessible(monster, position); }, monster.position.tile, monster.enemyPosition, path, MaxPathLengthMonsters) == 0) {
+	if (UsesPlayerFlowField(monster.ai) && (monster.flags & MFLAG_TARGETS_MONSTER) == 0) {
+		const Player &player = Players[monster.enemy];
+		if (monster.enemyPosition == player.position.future) {
+			const std::optional<Direction> direction = GetPlayerFlowFieldDirection(monster, player, MaxPathLengthMonsters);
+			if (!direction)
+				return false;
+			RandomWalk(monster, *direction);
+			return true;
+		}
+	}
+
+	if (FindPathT(CanStepPredicate {}, MonsterPosOk { monster }, monster.position.tile, monster.enemyPosition, path, MaxPathLengthMonsters) == 0) {
 		return false;
 	}
 
@@ -3220,20 +3490,18 @@ MonsterSpritesData LoadMonsterSpritesData(const MonsterData &monsterData)
 	    [&monsterData](size_t index) { return monsterData.hasAnim(index); });
 
 #ifndef UNPACKED_MPQS
-	// Convert CL2 to CLX:
-	std::vector<std::vector<uint8_t>> clxData;
-	size_t accumulatedSize = 0;
-	for (size_t i = 0, j = 0; i < numAnims; ++i) {
-		if (!monsterData.hasAnim(i))
-			continue;
+	// Convert CL2 to CLX, the animations on different threads:
+	std::vector<std::vector<uint8_t>> clxData(GetNumAnimsWithGraphics(monsterData));
+	ParallelFor("Cl2ToClx", clxData.size(), [&](size_t j) {
 		const uint32_t begin = result.offsets[j];
 		const uint32_t end = result.offsets[j + 1];
-		clxData.emplace_back();
 		Cl2ToClx(reinterpret_cast<uint8_t *>(&result.data[begin]), end - begin,
-		    PointerOrValue<uint16_t> { monsterData.width }, clxData.back());
+		    PointerOrValue<uint16_t> { monsterData.width }, clxData[j]);
+	});
+	size_t accumulatedSize = 0;
+	for (size_t j = 0; j < clxData.size(); ++j) {
 		result.offsets[j] = static_cast<uint32_t>(accumulatedSize);
-		accumulatedSize += clxData.back().size();
-		++j;
+		accumulatedSize += clxData[j].size();
 	}
 	result.offsets[clxData.size()] = static_cast<uint32_t>(accumulatedSize);
 	result.data = nullptr;
@@ -3258,12 +3526,15 @@ void EnsureMonsterIndexIsActive(size_t monsterId)
 		ActiveMonsters[ActiveMonsterCount] = static_cast<unsigned>(monsterId);
 		ActiveMonsters[index] = oldId;
 		ActiveMonsterCount += 1;
+		InvalidateEnemyCandidates();
+		InvalidateMonsterPacks();
 	}
 }
 
 void InitGolem(devilution::Monster &monster, uint8_t golemOwnerPlayerId, int16_t golemSpellLevel)
 {
 	monster.flags |= MFLAG_GOLEM;
+	InvalidateEnemyCandidates();
 	monster.goalVar3 = static_cast<int8_t>(golemOwnerPlayerId);
 	const Player &player = Players[golemOwnerPlayerId];
 	monster.maxHitPoints = 2 * (320 * golemSpellLevel + player._pMaxMana / 3);
@@ -3425,6 +3696,8 @@ void InitLevelMonsters()
 	ClrAllMonsters();
 	ActiveMonsterCount = 0;
 	totalmonsters = MaxMonsters;
+	InvalidatePlayerFlowFields();
+	InvalidateLineOfSightCache();
 
 	std::iota(std::begin(ActiveMonsters), std::end(ActiveMonsters), 0U);
 	uniquetrans = 0;
@@ -3530,16 +3803,19 @@ tl::expected<void, std::string> InitMonsterSND(CMonster &monsterType)
 
 	const MonsterData &data = MonstersData[monsterType.type];
 	const std::string_view soundSuffix = data.soundPath();
+	const int numSounds = data.hasSpecialSound ? 4 : 3;
 
-	for (int i = 0; i < 4; i++) {
-		const std::string_view prefix = prefixes[i];
-		if (prefix == "s" && !data.hasSpecialSound)
-			continue;
-
+	char paths[4][2][64];
+	for (int i = 0; i < numSounds; i++) {
+		for (int j = 0; j < 2; j++) {
+			*BufCopy(paths[i][j], "monsters\\", soundSuffix, prefixes[i], j + 1, ".wav") = '\0';
+			// Read in the background while the ones before are decoded
+			PrefetchSoundFile(paths[i][j]);
+		}
+	}
+	for (int i = 0; i < numSounds; i++) {
 		for (int j = 0; j < 2; j++) {
-			char path[64];
-			*BufCopy(path, "monsters\\", soundSuffix, prefix, j + 1, ".wav") = '\0';
-			ASSIGN_OR_RETURN(monsterType.sounds[i][j], SoundFileLoadWithStatus(path));
+			ASSIGN_OR_RETURN(monsterType.sounds[i][j], SoundFileLoadWithStatus(paths[i][j]));
 		}
 	}
 	return {};
@@ -3552,9 +3828,18 @@ tl::expected<void, std::string> InitMonsterGFX(CMonster &monsterType, MonsterSpr
 
 	const _monster_id mtype = monsterType.type;
 	const MonsterData &monsterData = MonstersData[mtype];
-	if (spritesData.data == nullptr)
-		spritesData = LoadMonsterSpritesData(monsterData);
-	monsterType.animData = std::move(spritesData.data);
+	std::string cacheKey = GetMonsterSpritesCacheKey(monsterData);
+	const auto cached = MonsterSpritesCache.find(cacheKey);
+	const bool isCached = cached != MonsterSpritesCache.end();
+	if (isCached) {
+		cached->second.lastUsed = ++MonsterSpritesUseCounter;
+		monsterType.animData = cached->second.data;
+		spritesData.offsets = cached->second.offsets;
+	} else {
+		if (spritesData.data == nullptr)
+			spritesData = LoadMonsterSpritesData(monsterData);
+		monsterType.animData = std::move(spritesData.data);
+	}
 
 	const size_t numAnims = GetNumAnims(monsterData);
 	for (size_t i = 0, j = 0; i < numAnims; ++i) {
@@ -3570,8 +3855,12 @@ tl::expected<void, std::string> InitMonsterGFX(CMonster &monsterType, MonsterSpr
 		++j;
 	}
 
-	if (!monsterData.trnFile.empty()) {
-		InitMonsterTRN(monsterType);
+	if (!isCached) {
+		if (!monsterData.trnFile.empty()) {
+			InitMonsterTRN(monsterType);
+		}
+		MonsterSpritesCache.emplace(std::move(cacheKey),
+		    MonsterSpritesCacheEntry { monsterType.animData, spritesData.offsets, spritesData.offsets[GetNumAnimsWithGraphics(monsterData)], ++MonsterSpritesUseCounter });
 	}
 
 	if (IsAnyOf(mtype, MT_NMAGMA, MT_YMAGMA, MT_BMAGMA, MT_WMAGMA))
@@ -3631,27 +3920,45 @@ tl::expected<void, std::string> InitAllMonsterGFX()
 	}
 	size_t totalUniqueBytes = 0;
 	size_t totalBytes = 0;
+	bool initializedAny = false;
 	for (const LevelMonsterTypeIndices &monsterTypes : monstersBySprite) {
 		if (monsterTypes.empty())
 			continue;
-		CMonster &firstMonster = LevelMonsterTypes[monsterTypes[0]];
+		const CMonster &firstMonster = LevelMonsterTypes[monsterTypes[0]];
 		if (firstMonster.animData != nullptr)
 			continue;
+		initializedAny = true;
+
+		// Types whose graphics are still cached from an earlier level don't need the sprites loaded again.
+		LevelMonsterTypeIndices missingTypes;
+		for (const size_t typeIndex : monsterTypes) {
+			CMonster &monsterType = LevelMonsterTypes[typeIndex];
+			if (MonsterSpritesCache.contains(GetMonsterSpritesCacheKey(monsterType.data()))) {
+				RETURN_IF_ERROR(InitMonsterGFX(monsterType));
+			} else {
+				missingTypes.emplace_back(typeIndex);
+			}
+		}
+		if (missingTypes.empty()) {
+			LogVerbose("Reused monster graphics: {:15s}", firstMonster.data().spritePath());
+			continue;
+		}
+
 		MonsterSpritesData spritesData = LoadMonsterSpritesData(firstMonster.data());
 		const size_t spritesDataSize = spritesData.offsets[GetNumAnimsWithGraphics(firstMonster.data())];
-		for (size_t i = 1; i < monsterTypes.size(); ++i) {
+		for (size_t i = 1; i < missingTypes.size(); ++i) {
 			MonsterSpritesData spritesDataCopy { std::unique_ptr<std::byte[]> { new std::byte[spritesDataSize] }, spritesData.offsets };
 			memcpy(spritesDataCopy.data.get(), spritesData.data.get(), spritesDataSize);
-			RETURN_IF_ERROR(InitMonsterGFX(LevelMonsterTypes[monsterTypes[i]], std::move(spritesDataCopy)));
+			RETURN_IF_ERROR(InitMonsterGFX(LevelMonsterTypes[missingTypes[i]], std::move(spritesDataCopy)));
 		}
-		LogVerbose("Loaded monster graphics: {:15s} {:>4d} KiB   x{:d}", firstMonster.data().spritePath(), spritesDataSize / 1024, monsterTypes.size());
+		LogVerbose("Loaded monster graphics: {:15s} {:>4d} KiB   x{:d}", firstMonster.data().spritePath(), spritesDataSize / 1024, missingTypes.size());
 		totalUniqueBytes += spritesDataSize;
-		totalBytes += spritesDataSize * monsterTypes.size();
-		RETURN_IF_ERROR(InitMonsterGFX(firstMonster, std::move(spritesData)));
+		totalBytes += spritesDataSize * missingTypes.size();
+		RETURN_IF_ERROR(InitMonsterGFX(LevelMonsterTypes[missingTypes[0]], std::move(spritesData)));
 	}
 	LogVerbose(" Total monster graphics:                 {:>4d} KiB {:>4d} KiB", totalUniqueBytes / 1024, totalBytes / 1024);
 
-	if (totalUniqueBytes > 0) {
+	if (initializedAny) {
 		// we loaded new sprites, check if we need to update existing monsters
 		for (size_t i = 0; i < ActiveMonsterCount; i++) {
 			Monster &monster = Monsters[ActiveMonsters[i]];
@@ -4256,7 +4563,10 @@ void RemoveEnemyReferences(const Player &player)
 
 void ProcessMonsters()
 {
+	DVL_PROFILE_ZONE("ProcessMonsters");
 	DeleteMonsterList();
+	CollectEnemyCandidates();
+	CollectMonsterPacks();
 
 	assert(ActiveMonsterCount <= MaxMonsters);
 	for (size_t i = 0; i < ActiveMonsterCount; i++) {
@@ -4266,33 +4576,11 @@ void ProcessMonsters()
 			SetRndSeed(monster.aiSeed);
 			monster.aiSeed = AdvanceRndSeed();
 		}
-		if (monster.hitPoints < monster.maxHitPoints && !monster.hasNoLife()) {
-			if (monster.level(sgGameInitInfo.nDifficulty) > 1) {
-				monster.hitPoints += monster.level(sgGameInitInfo.nDifficulty) / 2;
-			} else {
-				monster.hitPoints += monster.level(sgGameInitInfo.nDifficulty);
-			}
-			monster.hitPoints = std::min(monster.hitPoints, monster.maxHitPoints); // prevent going over max HP with part of a single regen tick
-		}
+		RegenerateHitPoints(monster);
 
 		const bool isMonsterVisible = IsTileVisible(monster.position.tile);
-		if (isMonsterVisible && monster.activeForTicks == 0) {
-			if (monster.type().type == MT_CLEAVER) {
-				PlaySFX(SfxID::ButcherGreeting);
-			}
-			if (monster.type().type == MT_NAKRUL) {
-				if (sgGameInitInfo.bCowQuest != 0) {
-					PlaySFX(SfxID::NaKrul6);
-				} else {
-					if (IsUberRoomOpened)
-						PlaySFX(SfxID::NaKrul4);
-					else
-						PlaySFX(SfxID::NaKrul5);
-				}
-			}
-			if (monster.type().type == MT_DEFILER)
-				PlaySFX(SfxID::Defiler8);
-			UpdateEnemy(monster);
+		if (DVL_PREDICT_FALSE(isMonsterVisible && monster.activeForTicks == 0)) {
+			StartEncounter(monster);
 		}
 
 		if ((monster.flags & MFLAG_NO_ENEMY) == 0) {
@@ -4333,6 +4621,9 @@ void ProcessMonsters()
 		}
 	}
 
+	// Monster flags can also change between ticks, e.g. from a player's berserk spell.
+	InvalidateEnemyCandidates();
+	InvalidateMonsterPacks();
 	DeleteMonsterList();
 }
 
@@ -4351,6 +4642,14 @@ void FreeMonsters()
 			}
 		}
 	}
+
+	// The graphics of this level's monsters are now unused and may be unloaded to make room.
+	TrimMonsterSpritesCache();
+}
+
+void ClearMonsterSpritesCache()
+{
+	MonsterSpritesCache.clear();
 }
 
 bool DirOK(const Monster &monster, Direction mdir)
@@ -4364,6 +4663,8 @@ bool DirOK(const Monster &monster, Direction mdir)
 	}
 	if (!monster.hasLeashedMinions())
 		return true;
+	if (Packs.valid)
+		return CountLeashedMinionsAround(monster, futurePosition) == monster.packSize;
 	int mcount = 0;
 	for (int x = futurePosition.x - 3; x <= futurePosition.x + 3; x++) {
 		for (int y = futurePosition.y - 3; y <= futurePosition.y + 3; y++) {
@@ -4383,12 +4684,22 @@ bool DirOK(const Monster &monster, Direction mdir)
 
 bool LineClearMissile(Point startPoint, Point endPoint)
 {
-	return LineClear(PosOkMissile, startPoint, endPoint);
+	return CachedLineClear(LineOfSightKind::Missile, PosOkMissile, startPoint, endPoint);
 }
 
 bool LineClearMovingMissile(Point startPoint, Point endPoint)
 {
-	return LineClear(PosOkMovingMissile, startPoint, endPoint);
+	return CachedLineClear(LineOfSightKind::MovingMissile, PosOkMovingMissile, startPoint, endPoint);
+}
+
+void InvalidateLineOfSightCache()
+{
+	if (++LineOfSightGeneration != 0)
+		return;
+	// The generation wrapped around, old entries could look current again.
+	for (LineOfSightEntry &entry : LineOfSightCache)
+		entry.generation = 0;
+	LineOfSightGeneration = 1;
 }
 
 tl::expected<void, std::string> SyncMonsterAnim(Monster &monster)
@@ -4848,7 +5159,7 @@ bool CanTalkToMonst(const Monster &monster)
 	return IsAnyOf(monster.goal, MonsterGoal::Inquiring, MonsterGoal::Talking);
 }
 
-uint8_t encode_enemy(Monster &monster)
+uint8_t encode_enemy(const Monster &monster)
 {
 	if ((monster.flags & MFLAG_TARGETS_MONSTER) != 0)
 		return monster.enemy;
@@ -184,7 +184,8 @@ struct MonsterSpritesData {
 };
 
 struct CMonster {
-	std::unique_ptr<std::byte[]> animData;
+	/** @brief Shared with the monster sprites cache and other monster types with the same graphics and TRN. */
+	std::shared_ptr<std::byte[]> animData;
 	AnimStruct anims[6];
 	std::unique_ptr<TSnd> sounds[4][2];
 
@@ -549,12 +550,23 @@ void DeleteMonsterList();
 void RemoveEnemyReferences(const Player &player);
 void ProcessMonsters();
 void FreeMonsters();
+
+/**
+ * @brief Unloads the monster graphics that were kept for later levels.
+ */
+void ClearMonsterSpritesCache();
 bool DirOK(const Monster &monster, Direction mdir);
 bool LineClearMissile(Point startPoint, Point endPoint);
 /**
  * @brief Checks for same missile obstructions as CheckMissileCol() for missiles that move along a path between two points
  */
 bool LineClearMovingMissile(Point startPoint, Point endPoint);
+/**
+ * @brief Drops the cached results of `LineClearMissile`, `LineClearMovingMissile` and `IsLineNotSolid`.
+ *
+ * Must be called whenever tiles or objects change whether they block movement or missiles.
+ */
+void InvalidateLineOfSightCache();
 tl::expected<void, std::string> SyncMonsterAnim(Monster &monster);
 void M_FallenFear(Point position);
 void PrintMonstHistory(int mt);
@@ -582,7 +594,7 @@ Monster *PreSpawnSkeleton();
 void TalktoMonster(Player &player, Monster &monster);
 void SpawnGolem(const Player &player, Point position, uint8_t spellLevel);
 bool CanTalkToMonst(const Monster &monster);
-uint8_t encode_enemy(Monster &monster);
+uint8_t encode_enemy(const Monster &monster);
 void decode_enemy(Monster &monster, uint8_t enemyId);
 
 } // namespace devilution
@@ -0,0 +1,143 @@
+/**
+ * @file monsters/player_flow_field.cpp
+ *
+ * Implementation of the walking distance maps monsters can use to chase players.
+ */
+#include "monsters/player_flow_field.hpp"
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "engine/path.h"
+#include "engine/point.hpp"
+#include "levels/gendung.h"
+#include "levels/tile_properties.hpp"
+#include "monster.h"
+#include "multi.h"
+#include "player.h"
+
+namespace devilution {
+
+namespace {
+
+constexpr size_t NumMonsterAIs = static_cast<size_t>(MonsterAIID::BoneDemon) + 1;
+constexpr uint16_t Unreachable = std::numeric_limits<uint16_t>::max();
+
+std::bitset<NumMonsterAIs> FlowFieldAIs;
+
+struct PlayerFlowField {
+	/** @brief Walking distance from the player for each tile, in steps. */
+	std::array<std::array<uint16_t, MAXDUNY>, MAXDUNX> distances;
+	Point source;
+	bool valid = false;
+};
+
+struct PlayerFlowFields {
+	/** @brief Indexed by player, then by whether closed doors can be walked through. */
+	std::array<std::array<PlayerFlowField, 2>, MAX_PLRS> fields;
+	std::vector<Point> queue;
+};
+
+/** @brief Only allocated while an AI uses the flow fields, they take up a few hundred KiB. */
+std::unique_ptr<PlayerFlowFields> FlowFields;
+
+void ComputeFlowField(PlayerFlowField &field, std::vector<Point> &queue, Point source, bool ignoreDoors)
+{
+	for (auto &column : field.distances)
+		column.fill(Unreachable);
+	field.source = source;
+	field.valid = true;
+	if (!InDungeonBounds(source))
+		return;
+
+	// Breadth-first search, each step costs the same since walking diagonally takes as long as walking straight.
+	queue.clear();
+	field.distances[source.x][source.y] = 0;
+	queue.push_back(source);
+	for (size_t head = 0; head < queue.size(); ++head) {
+		const Point position = queue[head];
+		const uint16_t distance = field.distances[position.x][position.y];
+		for (const Displacement d : PathDirs) {
+			// Work backwards from the player, so the monster's step is from `next` to `position`.
+			const Point next = position + d;
+			if (!InDungeonBounds(next) || field.distances[next.x][next.y] != Unreachable)
+				continue;
+			if (!IsTileWalkable(next, ignoreDoors) || !CanStep(next, position))
+				continue;
+			field.distances[next.x][next.y] = distance + 1;
+			queue.push_back(next);
+		}
+	}
+}
+
+const PlayerFlowField &GetFlowField(const Player &player, bool ignoreDoors)
+{
+	if (FlowFields == nullptr)
+		FlowFields = std::make_unique<PlayerFlowFields>();
+	PlayerFlowField &field = FlowFields->fields[player.getId()][ignoreDoors ? 1 : 0];
+	const Point source = player.position.future;
+	if (!field.valid || field.source != source)
+		ComputeFlowField(field, FlowFields->queue, source, ignoreDoors);
+	return field;
+}
+
+} // namespace
+
+bool UsesPlayerFlowField(MonsterAIID ai)
+{
+	const auto index = static_cast<size_t>(ai);
+	return index < NumMonsterAIs && FlowFieldAIs.test(index);
+}
+
+void SetUsesPlayerFlowField(MonsterAIID ai, bool enabled)
+{
+	const auto index = static_cast<size_t>(ai);
+	if (index < NumMonsterAIs)
+		FlowFieldAIs.set(index, enabled);
+	if (FlowFieldAIs.none())
+		FlowFields = nullptr;
+}
+
+void InvalidatePlayerFlowFields()
+{
+	if (FlowFields == nullptr)
+		return;
+	for (auto &playerFields : FlowFields->fields) {
+		for (PlayerFlowField &field : playerFields)
+			field.valid = false;
+	}
+}
+
+std::optional<Direction> GetPlayerFlowFieldDirection(const Monster &monster, const Player &player, size_t maxDistance)
+{
+	const Point position = monster.position.tile;
+	if (!InDungeonBounds(position))
+		return std::nullopt;
+
+	const bool ignoreDoors = (monster.flags & MFLAG_CAN_OPEN_DOOR) != 0;
+	const PlayerFlowField &field = GetFlowField(player, ignoreDoors);
+	uint16_t bestDistance = field.distances[position.x][position.y];
+	if (bestDistance <= 1 || bestDistance > maxDistance)
+		return std::nullopt;
+
+	std::optional<Direction> best;
+	for (int i = 0; i < 8; i++) {
+		const auto direction = static_cast<Direction>(i);
+		const Point next = position + direction;
+		if (!InDungeonBounds(next) || field.distances[next.x][next.y] >= bestDistance)
+			continue;
+		if (!IsTileWalkable(next, ignoreDoors) || !CanStep(position, next))
+			continue;
+		bestDistance = field.distances[next.x][next.y];
+		best = direction;
+	}
+	return best;
+}
+
+} // namespace devilution
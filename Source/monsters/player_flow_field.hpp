@@ -0,0 +1,51 @@
+/**
+ * @file monsters/player_flow_field.hpp
+ *
+ * Interface of the walking distance maps monsters can use to chase players.
+ */
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include "engine/direction.hpp"
+#include "tables/monstdat.h"
+
+namespace devilution {
+
+struct Monster;
+struct Player;
+
+/**
+ * @brief Whether monsters with the given AI chase players using the flow field instead of `FindPath`.
+ *
+ * The flow field finds walks as short as `FindPath`, but often picks a different one among equally short walks.
+ * No AI uses it by default, which keeps vanilla games and demos bit-exact.
+ */
+[[nodiscard]] bool UsesPlayerFlowField(MonsterAIID ai);
+
+/**
+ * @brief Lets monsters with the given AI chase players using the flow field.
+ *
+ * The flow fields are allocated when first used and freed once no AI uses them anymore.
+ */
+void SetUsesPlayerFlowField(MonsterAIID ai, bool enabled);
+
+/**
+ * @brief Marks all flow fields as outdated, must be called whenever the solidity of tiles changes (e.g. doors or a new level).
+ */
+void InvalidatePlayerFlowFields();
+
+/**
+ * @brief Returns the direction of the first step on a shortest walk from the monster to the player.
+ *
+ * The walking distances from the player are only recomputed when the player moved to another tile
+ * or after `InvalidatePlayerFlowFields`. Only solid tiles and (for monsters that can't open them) doors are
+ * considered, other monsters, players and hazards have to be checked by the caller.
+ *
+ * @param maxDistance Players that are more steps away are treated as unreachable.
+ * @return `std::nullopt` if the monster can't reach the player or is already next to them.
+ */
+[[nodiscard]] std::optional<Direction> GetPlayerFlowFieldDirection(const Monster &monster, const Player &player, size_t maxDistance);
+
+} // namespace devilution
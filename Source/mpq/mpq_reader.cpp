@@ -1,14 +1,247 @@
 #include "mpq/mpq_reader.hpp"
 
+#include <array>
+#include <atomic>
+#include <cstdio>
 #include <cstring>
+#include <mutex>
 #include <utility>
+#include <vector>
 
 #include <mpqfs/mpqfs.h>
 
+#include "utils/endian_read.hpp"
 #include "utils/file_util.h"
+#include "utils/mapped_file.hpp"
+#include "utils/sdl_mutex.h"
 
 namespace devilution {
 
+struct MpqHashEntry {
+	uint32_t hashA;
+	uint32_t hashB;
+	uint32_t blockIndex;
+};
+
+struct MpqBlockEntry {
+	uint32_t filePos;
+	uint32_t compressedSize;
+	uint32_t fileSize;
+	uint32_t flags;
+};
+
+struct MpqTables {
+	std::vector<MpqHashEntry> hashTable;
+	std::vector<MpqBlockEntry> blockTable;
+};
+
+struct MpqMappedArchive {
+	MappedFile file;
+	/** @brief The archive header, file positions are relative to it. */
+	std::span<const std::byte> archive;
+	MpqTables tables;
+};
+
+namespace {
+
+constexpr uint32_t MpqHeaderSignature = 0x1A51504D; // "MPQ\x1A"
+constexpr uint32_t MpqHeaderSize = 32;
+constexpr uint32_t MpqHashEntryEmpty = 0xFFFFFFFF;
+constexpr uint32_t MpqHashEntryDeleted = 0xFFFFFFFE;
+
+constexpr uint32_t MpqFileImplode = 0x00000100;
+constexpr uint32_t MpqFileCompress = 0x00000200;
+constexpr uint32_t MpqFileEncrypted = 0x00010000;
+constexpr uint32_t MpqFileExists = 0x80000000;
+
+enum class MpqHashType : uint8_t {
+	TableOffset = 0,
+	NameA = 1,
+	NameB = 2,
+	FileKey = 3,
+};
+
+constexpr std::array<uint32_t, 0x500> MpqCryptTable = [] {
+	std::array<uint32_t, 0x500> table {};
+	uint32_t seed = 0x00100001;
+	for (uint32_t index1 = 0; index1 < 0x100; index1++) {
+		for (uint32_t i = 0, index2 = index1; i < 5; i++, index2 += 0x100) {
+			seed = (seed * 125 + 3) % 0x2AAAAB;
+			const uint32_t temp1 = (seed & 0xFFFF) << 0x10;
+			seed = (seed * 125 + 3) % 0x2AAAAB;
+			const uint32_t temp2 = (seed & 0xFFFF);
+			table[index2] = temp1 | temp2;
+		}
+	}
+	return table;
+}();
+
+uint32_t MpqHashString(std::string_view str, MpqHashType type)
+{
+	uint32_t seed1 = 0x7FED7FED;
+	uint32_t seed2 = 0xEEEEEEEE;
+	for (char c : str) {
+		if (c == '/') c = '\\';
+		if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+		const auto ch = static_cast<uint8_t>(c);
+		seed1 = MpqCryptTable[(static_cast<uint32_t>(type) << 8) + ch] ^ (seed1 + seed2);
+		seed2 = ch + seed1 + seed2 + (seed2 << 5) + 3;
+	}
+	return seed1;
+}
+
+void MpqDecryptBlock(uint32_t *data, size_t count, uint32_t key)
+{
+	uint32_t seed = 0xEEEEEEEE;
+	for (size_t i = 0; i < count; i++) {
+		seed += MpqCryptTable[0x400 + (key & 0xFF)];
+		const uint32_t ch = data[i] ^ (key + seed);
+		key = ((~key << 0x15) + 0x11111111) | (key >> 0x0B);
+		seed = ch + seed + (seed << 5) + 3;
+		data[i] = ch;
+	}
+}
+
+/**
+ * @brief Reads and decrypts one of the archive tables.
+ *
+ * @param readAt `bool(uint64_t offset, std::byte *out, size_t size)`
+ * @return false if the table is out of bounds.
+ */
+template <typename ReadAt>
+bool ReadMpqTable(ReadAt &&readAt, uint64_t archiveOffset, uint64_t archiveSize, uint32_t position, uint32_t entries, std::string_view key, std::vector<uint32_t> &out)
+{
+	const size_t size = static_cast<size_t>(entries) * 4 * sizeof(uint32_t);
+	if (position > archiveSize || size > archiveSize - position)
+		return false;
+	std::vector<std::byte> bytes(size);
+	if (size != 0 && !readAt(archiveOffset + position, bytes.data(), size))
+		return false;
+	out.resize(static_cast<size_t>(entries) * 4);
+	for (size_t i = 0; i < out.size(); i++)
+		out[i] = LoadLE32(&bytes[i * sizeof(uint32_t)]);
+	MpqDecryptBlock(out.data(), out.size(), MpqHashString(key, MpqHashType::FileKey));
+	return true;
+}
+
+/**
+ * @brief Locates the archive header and reads the hash and block tables.
+ *
+ * @param readAt `bool(uint64_t offset, std::byte *out, size_t size)`
+ * @param archiveOffset Set to the position of the header in the file.
+ */
+template <typename ReadAt>
+std::optional<MpqTables> ReadMpqTables(ReadAt &&readAt, uint64_t fileSize, uint64_t &archiveOffset)
+{
+	// The header can be preceded by other data, it is always aligned to 512 bytes.
+	std::array<std::byte, MpqHeaderSize> header;
+	bool found = false;
+	for (uint64_t offset = 0; offset + MpqHeaderSize <= fileSize; offset += 512) {
+		if (!readAt(offset, header.data(), header.size()))
+			return std::nullopt;
+		if (LoadLE32(header.data()) == MpqHeaderSignature) {
+			archiveOffset = offset;
+			found = true;
+			break;
+		}
+	}
+	if (!found)
+		return std::nullopt;
+
+	// Only the original format is supported: 32-bit file positions without extended tables.
+	const uint16_t formatVersion = LoadLE16(&header[12]);
+	if (formatVersion != 0)
+		return std::nullopt;
+
+	const uint32_t hashTablePos = LoadLE32(&header[16]);
+	const uint32_t blockTablePos = LoadLE32(&header[20]);
+	const uint32_t hashTableEntries = LoadLE32(&header[24]);
+	const uint32_t blockTableEntries = LoadLE32(&header[28]);
+	if (hashTableEntries == 0 || (hashTableEntries & (hashTableEntries - 1)) != 0)
+		return std::nullopt;
+
+	const uint64_t archiveSize = fileSize - archiveOffset;
+	MpqTables tables;
+	std::vector<uint32_t> table;
+	if (!ReadMpqTable(readAt, archiveOffset, archiveSize, hashTablePos, hashTableEntries, "(hash table)", table))
+		return std::nullopt;
+	tables.hashTable.reserve(hashTableEntries);
+	for (size_t i = 0; i < table.size(); i += 4)
+		tables.hashTable.push_back(MpqHashEntry { table[i], table[i + 1], table[i + 3] });
+
+	if (!ReadMpqTable(readAt, archiveOffset, archiveSize, blockTablePos, blockTableEntries, "(block table)", table))
+		return std::nullopt;
+	tables.blockTable.reserve(blockTableEntries);
+	for (size_t i = 0; i < table.size(); i += 4)
+		tables.blockTable.push_back(MpqBlockEntry { table[i], table[i + 1], table[i + 2], table[i + 3] });
+
+	return tables;
+}
+
+std::shared_ptr<const MpqMappedArchive> MapMpqArchive(const char *path)
+{
+	std::optional<MappedFile> file = MappedFile::Open(path);
+	if (!file)
+		return nullptr;
+	const std::span<const std::byte> data = file->data();
+
+	uint64_t archiveOffset;
+	std::optional<MpqTables> tables = ReadMpqTables(
+	    [data](uint64_t offset, std::byte *out, size_t size) {
+		    std::memcpy(out, &data[static_cast<size_t>(offset)], size);
+		    return true;
+	    },
+	    data.size(), archiveOffset);
+	if (!tables)
+		return nullptr;
+
+	const std::span<const std::byte> archive = data.subspan(static_cast<size_t>(archiveOffset));
+	return std::make_shared<MpqMappedArchive>(MpqMappedArchive { std::move(*file), archive, *std::move(tables) });
+}
+
+std::optional<MpqTables> ReadMpqTablesFromFile(const char *path)
+{
+	std::uintmax_t fileSize;
+	if (!GetFileSize(path, &fileSize))
+		return std::nullopt;
+	FILE *file = OpenFile(path, "rb");
+	if (file == nullptr)
+		return std::nullopt;
+
+	uint64_t archiveOffset;
+	std::optional<MpqTables> tables = ReadMpqTables(
+	    [file](uint64_t offset, std::byte *out, size_t size) {
+		    return std::fseek(file, static_cast<long>(offset), SEEK_SET) == 0
+		        && std::fread(out, size, 1, file) == 1;
+	    },
+	    fileSize, archiveOffset);
+	std::fclose(file);
+	return tables;
+}
+
+const MpqBlockEntry *FindMpqBlock(const MpqTables &tables, std::string_view filename)
+{
+	const size_t mask = tables.hashTable.size() - 1;
+	const uint32_t hashA = MpqHashString(filename, MpqHashType::NameA);
+	const uint32_t hashB = MpqHashString(filename, MpqHashType::NameB);
+	const size_t start = MpqHashString(filename, MpqHashType::TableOffset) & mask;
+	for (size_t i = start;;) {
+		const MpqHashEntry &entry = tables.hashTable[i];
+		if (entry.blockIndex == MpqHashEntryEmpty)
+			return nullptr;
+		if (entry.blockIndex != MpqHashEntryDeleted && entry.hashA == hashA && entry.hashB == hashB) {
+			if (entry.blockIndex >= tables.blockTable.size())
+				return nullptr;
+			return &tables.blockTable[entry.blockIndex];
+		}
+		i = (i + 1) & mask;
+		if (i == start)
+			return nullptr;
+	}
+}
+
+} // namespace
+
 // Helper: NUL-terminate a string_view into a stack buffer.
 // Returns false if the name doesn't fit.
 static bool CopyToPathBuf(std::string_view sv, char *buf, size_t bufSize)
@@ -19,15 +252,81 @@ static bool CopyToPathBuf(std::string_view sv, char *buf, size_t bufSize)
 	return true;
 }
 
-MpqArchive::MpqArchive(std::string path, mpqfs_archive_t *archive)
+/**
+ * @brief Handles of an archive that no reader holds, kept so that the next reader
+ * doesn't have to open the archive and read its tables again.
+ */
+struct MpqHandlePool {
+	/** @brief Enough for the prefetch workers and the audio streams that play at once. */
+	static constexpr size_t MaxIdleHandles = 4;
+
+	SdlMutex mutex;
+	std::vector<mpqfs_archive_t *> idle;
+
+	~MpqHandlePool()
+	{
+		for (mpqfs_archive_t *handle : idle)
+			mpqfs_close(handle);
+	}
+};
+
+MpqArchive::PooledHandle::PooledHandle(std::shared_ptr<MpqHandlePool> pool, mpqfs_archive_t *handle)
+    : pool_(std::move(pool))
+    , handle_(handle)
+{
+}
+
+MpqArchive::PooledHandle::PooledHandle(PooledHandle &&other) noexcept
+    : pool_(std::move(other.pool_))
+    , handle_(std::exchange(other.handle_, nullptr))
+{
+}
+
+MpqArchive::PooledHandle &MpqArchive::PooledHandle::operator=(PooledHandle &&other) noexcept
+{
+	if (this != &other) {
+		release();
+		pool_ = std::move(other.pool_);
+		handle_ = std::exchange(other.handle_, nullptr);
+	}
+	return *this;
+}
+
+MpqArchive::PooledHandle::~PooledHandle()
+{
+	release();
+}
+
+void MpqArchive::PooledHandle::release()
+{
+	mpqfs_archive_t *handle = std::exchange(handle_, nullptr);
+	const std::shared_ptr<MpqHandlePool> pool = std::move(pool_);
+	if (handle == nullptr)
+		return;
+	if (pool != nullptr) {
+		const std::lock_guard lock { pool->mutex };
+		if (pool->idle.size() < MpqHandlePool::MaxIdleHandles) {
+			pool->idle.push_back(handle);
+			return;
+		}
+	}
+	mpqfs_close(handle);
+}
+
+MpqArchive::MpqArchive(std::string path, mpqfs_archive_t *archive, uint32_t id)
     : path_(std::move(path))
     , archive_(archive)
+    , id_(id)
+    , handlePool_(std::make_shared<MpqHandlePool>())
 {
 }
 
 MpqArchive::MpqArchive(MpqArchive &&other) noexcept
     : path_(std::move(other.path_))
     , archive_(other.archive_)
+    , id_(other.id_)
+    , mapped_(std::move(other.mapped_))
+    , handlePool_(std::move(other.handlePool_))
 {
 	other.archive_ = nullptr;
 }
@@ -38,11 +337,27 @@ MpqArchive &MpqArchive::operator=(MpqArchive &&other) noexcept
 		mpqfs_close(archive_);
 		path_ = std::move(other.path_);
 		archive_ = other.archive_;
+		id_ = other.id_;
+		mapped_ = std::move(other.mapped_);
+		handlePool_ = std::move(other.handlePool_);
 		other.archive_ = nullptr;
 	}
 	return *this;
 }
 
+MpqArchive::PooledHandle MpqArchive::AcquireHandle()
+{
+	{
+		const std::lock_guard lock { handlePool_->mutex };
+		if (!handlePool_->idle.empty()) {
+			mpqfs_archive_t *handle = handlePool_->idle.back();
+			handlePool_->idle.pop_back();
+			return PooledHandle(handlePool_, handle);
+		}
+	}
+	return PooledHandle(handlePool_, mpqfs_clone(archive_));
+}
+
 MpqArchive::~MpqArchive()
 {
 	mpqfs_close(archive_);
@@ -60,7 +375,8 @@ std::optional<MpqArchive> MpqArchive::Open(const char *path, int32_t &error)
 		return std::nullopt;
 	}
 	error = 0;
-	return MpqArchive(path, handle);
+	static std::atomic<uint32_t> NextId { 0 };
+	return MpqArchive(path, handle, NextId++);
 }
 
 std::optional<MpqArchive> MpqArchive::Clone(int32_t &error)
@@ -71,7 +387,9 @@ std::optional<MpqArchive> MpqArchive::Clone(int32_t &error)
 		return std::nullopt;
 	}
 	error = 0;
-	return MpqArchive(path_, clone);
+	MpqArchive result(path_, clone, id_);
+	result.mapped_ = mapped_;
+	return result;
 }
 
 const char *MpqArchive::ErrorMessage()
@@ -142,4 +460,70 @@ std::unique_ptr<std::byte[]> MpqArchive::ReadFile(
 	return result;
 }
 
+bool MpqArchive::MapIntoMemory()
+{
+	// DIABDAT.MPQ alone would take up a large part of a 32-bit address space.
+	if constexpr (sizeof(void *) < 8)
+		return false;
+	if (mapped_ == nullptr)
+		mapped_ = MapMpqArchive(path_.c_str());
+	return mapped_ != nullptr;
+}
+
+std::optional<std::span<const std::byte>> MpqArchive::FindUncompressedFile(std::string_view filename) const
+{
+	if (mapped_ == nullptr)
+		return std::nullopt;
+	const MpqBlockEntry *block = FindMpqBlock(mapped_->tables, filename);
+	if (block == nullptr || (block->flags & MpqFileExists) == 0)
+		return std::nullopt;
+	if ((block->flags & (MpqFileImplode | MpqFileCompress | MpqFileEncrypted)) != 0 || block->compressedSize != block->fileSize)
+		return std::nullopt;
+	const std::span<const std::byte> archive = mapped_->archive;
+	if (block->filePos > archive.size() || block->fileSize > archive.size() - block->filePos)
+		return std::nullopt;
+	return archive.subspan(block->filePos, block->fileSize);
+}
+
+MpqArchive::FileView MpqArchive::ReadFileView(std::string_view filename, int32_t &error)
+{
+	if (const std::optional<std::span<const std::byte>> data = FindUncompressedFile(filename); data && !data->empty()) {
+		error = 0;
+		return FileView { *data, nullptr };
+	}
+	size_t fileSize;
+	std::unique_ptr<std::byte[]> owned = ReadFile(filename, fileSize, error);
+	if (owned == nullptr)
+		return {};
+	const std::span<const std::byte> data { owned.get(), fileSize };
+	return FileView { data, std::move(owned) };
+}
+
+MpqArchive::FileNameHash MpqArchive::HashFileName(std::string_view filename)
+{
+	return FileNameHash { MpqHashString(filename, MpqHashType::NameA), MpqHashString(filename, MpqHashType::NameB) };
+}
+
+bool MpqArchive::ReadHashTable(std::vector<HashTableEntry> &out) const
+{
+	std::optional<MpqTables> fromFile;
+	if (mapped_ == nullptr) {
+		fromFile = ReadMpqTablesFromFile(path_.c_str());
+		if (!fromFile)
+			return false;
+	}
+	const MpqTables &tables = mapped_ != nullptr ? mapped_->tables : *fromFile;
+
+	out.clear();
+	for (size_t i = 0; i < tables.hashTable.size(); ++i) {
+		const MpqHashEntry &entry = tables.hashTable[i];
+		if (entry.blockIndex >= tables.blockTable.size())
+			continue;
+		if ((tables.blockTable[entry.blockIndex].flags & MpqFileExists) == 0)
+			continue;
+		out.push_back(HashTableEntry { { entry.hashA, entry.hashB }, static_cast<uint32_t>(i) });
+	}
+	return true;
+}
+
 } // namespace devilution
@@ -4,8 +4,10 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
+#include <vector>
 
 // Forward-declare so that we can avoid exposing mpqfs.h to all consumers.
 struct mpqfs_archive;
@@ -13,12 +15,50 @@ typedef struct mpqfs_archive mpqfs_archive_t;
 
 namespace devilution {
 
+struct MpqMappedArchive;
+struct MpqHandlePool;
+
 class MpqArchive {
 public:
 	static std::optional<MpqArchive> Open(const char *path, int32_t &error);
 	std::optional<MpqArchive> Clone(int32_t &error);
 	static const char *ErrorMessage();
 
+	/**
+	 * @brief A handle of the archive for a single reader, which may be on another thread.
+	 *
+	 * Given back to the archive's pool when destroyed, for the next reader to reuse.
+	 */
+	class PooledHandle {
+	public:
+		PooledHandle() = default;
+		PooledHandle(std::shared_ptr<MpqHandlePool> pool, mpqfs_archive_t *handle);
+		PooledHandle(PooledHandle &&other) noexcept;
+		PooledHandle &operator=(PooledHandle &&other) noexcept;
+		~PooledHandle();
+
+		PooledHandle(const PooledHandle &) = delete;
+		PooledHandle &operator=(const PooledHandle &) = delete;
+
+		[[nodiscard]] mpqfs_archive_t *get() const { return handle_; }
+
+	private:
+		void release();
+
+		std::shared_ptr<MpqHandlePool> pool_;
+		mpqfs_archive_t *handle_ = nullptr;
+	};
+
+	/**
+	 * @brief A handle that doesn't share its file position with any other reader, safe to use from any thread.
+	 *
+	 * Reuses an idle handle of the pool if there is one, so that the archive is only opened
+	 * and its tables read again when all of them are in use.
+	 *
+	 * @return A handle whose `get()` is null if the archive couldn't be opened again.
+	 */
+	PooledHandle AcquireHandle();
+
 	MpqArchive(MpqArchive &&other) noexcept;
 	MpqArchive &operator=(MpqArchive &&other) noexcept;
 	~MpqArchive();
@@ -39,13 +79,77 @@ public:
 	    std::size_t &fileSize,
 	    int32_t &error);
 
+	/**
+	 * @brief Maps the whole archive into memory, so that uncompressed files can be read without copying.
+	 *
+	 * Only for archives that are not modified while open.
+	 *
+	 * @return false if memory mapping is not supported here or the archive layout is not understood.
+	 */
+	bool MapIntoMemory();
+
+	[[nodiscard]] bool IsMappedIntoMemory() const { return mapped_ != nullptr; }
+
+	/**
+	 * @brief Contents of an uncompressed and unencrypted file in a memory-mapped archive.
+	 *
+	 * The span stays valid for as long as the archive is open.
+	 */
+	[[nodiscard]] std::optional<std::span<const std::byte>> FindUncompressedFile(std::string_view filename) const;
+
+	struct FileView {
+		/** @brief The file contents, borrowed from the memory mapping or pointing to `owned`. */
+		std::span<const std::byte> data;
+		/** @brief The decompressed file if it couldn't be borrowed from the memory mapping. */
+		std::unique_ptr<std::byte[]> owned;
+	};
+
+	/**
+	 * @brief Reads a file, borrowing uncompressed files from the memory mapping
+	 * and decompressing everything else into a new buffer.
+	 */
+	FileView ReadFileView(std::string_view filename, int32_t &error);
+
+	/** @brief The two name hashes that identify a file in the hash table. */
+	struct FileNameHash {
+		uint32_t a;
+		uint32_t b;
+
+		bool operator==(const FileNameHash &other) const = default;
+	};
+
+	static FileNameHash HashFileName(std::string_view filename);
+
+	struct HashTableEntry {
+		FileNameHash name;
+		/** @brief Can be passed to `HasFileHash`, `GetFileSizeFromHash` etc. */
+		uint32_t hashIndex;
+	};
+
+	/**
+	 * @brief Lists all files in the archive by their name hashes.
+	 *
+	 * Reads the tables from disk unless the archive is memory-mapped.
+	 *
+	 * @return false if the archive layout is not understood.
+	 */
+	bool ReadHashTable(std::vector<HashTableEntry> &out) const;
+
 	mpqfs_archive_t *handle() const { return archive_; }
 
+	/** @brief Identifies the archive's contents, shared with its clones and never reused. */
+	[[nodiscard]] uint32_t id() const { return id_; }
+
 private:
-	MpqArchive(std::string path, mpqfs_archive_t *archive);
+	MpqArchive(std::string path, mpqfs_archive_t *archive, uint32_t id);
 
 	std::string path_;
 	mpqfs_archive_t *archive_ = nullptr;
+	uint32_t id_;
+	/** @brief Shared with clones, the mapping is read-only. */
+	std::shared_ptr<const MpqMappedArchive> mapped_;
+	/** @brief Shared with the handles handed out, which may outlive the archive. */
+	std::shared_ptr<MpqHandlePool> handlePool_;
 };
 
 } // namespace devilution
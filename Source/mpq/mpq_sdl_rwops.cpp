@@ -1,7 +1,17 @@
 #include "mpq/mpq_sdl_rwops.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
 
 #include <mpqfs/mpqfs.h>
 
@@ -16,53 +26,84 @@
 #include "utils/sdl_compat.h"
 #endif
 
+#include "mpq/mpq_sector_cache.hpp"
+
+#ifndef __DJGPP__
+#include "utils/sdl_mutex.h"
+#include "utils/sdl_semaphore.h"
+#include "utils/sdl_thread.h"
+#endif
+
 namespace devilution {
 
 namespace {
 
 constexpr size_t MaxMpqPathSize = 256;
 
+#ifdef DEVILUTIONX_STREAM_READ_AHEAD_SIZE
+constexpr size_t ReadAheadSize = DEVILUTIONX_STREAM_READ_AHEAD_SIZE;
+#else
+constexpr size_t ReadAheadSize = 128 * 1024;
+#endif
+
+/** @brief Read-ahead buffers are filled in chunks of this size, so that a waiting reader gets its data early. */
+constexpr size_t ReadAheadChunkSize = 16 * 1024;
+static_assert(ReadAheadSize >= ReadAheadChunkSize, "DEVILUTIONX_STREAM_READ_AHEAD_SIZE must be at least 16 KiB");
+
+struct ReadAheadBuffer;
+
 /* -----------------------------------------------------------------------
  * Context structure shared by both SDL2 and SDL3 implementations.
  *
  * Wraps an mpqfs_stream_t (sector-based, on-demand decompression) and,
- * for the threadsafe variant, an independently cloned archive so that
- * reads don't race with the main thread's archive FILE*.
+ * for the threadsafe variant, an archive handle leased from the archive's
+ * pool so that reads don't race with the main thread's archive FILE*.
  * ----------------------------------------------------------------------- */
 
 struct MpqStreamCtx {
-	mpqfs_stream_t *stream;      /* Sector-based stream (owned)           */
-	mpqfs_archive_t *ownedClone; /* Non-null if we cloned for threadsafe  */
+	mpqfs_stream_t *stream;              /* Sector-based stream (owned)   */
+	MpqArchive::PooledHandle ownedClone; /* Non-null for threadsafe       */
+	ReadAheadBuffer *readAhead;          /* Non-null if reads go via one  */
+	int64_t size;                        /* Size of the file              */
+	int64_t position;                    /* The reader's position         */
+	int64_t sourcePosition;              /* Position of the mpqfs stream  */
+	MpqSectorCacheKey cacheKey;          /* Of the block at `position`    */
 };
 
+static void CloseReadAhead(MpqStreamCtx *ctx);
+
 static void DestroyCtx(MpqStreamCtx *ctx)
 {
 	if (ctx == nullptr)
 		return;
+	if (ctx->readAhead != nullptr) {
+		/* Destroyed by the read-ahead thread if it is reading from it. */
+		CloseReadAhead(ctx);
+		return;
+	}
+	/* The stream is closed before its handle goes back to the pool. */
 	mpqfs_stream_close(ctx->stream);
-	if (ctx->ownedClone != nullptr)
-		mpqfs_close(ctx->ownedClone);
 	delete ctx;
 }
 
 /* -----------------------------------------------------------------------
- * Helper: create the MpqStreamCtx, optionally cloning the archive for
- * thread-safety.  Tries hash-based open first, falls back to filename.
+ * Helper: create the MpqStreamCtx, optionally on a pooled handle of the
+ * archive for thread-safety.  Tries hash-based open first, falls back to filename.
  * ----------------------------------------------------------------------- */
 
-static MpqStreamCtx *CreateCtx(mpqfs_archive_t *archive,
+static MpqStreamCtx *CreateCtx(MpqArchive &archive,
     uint32_t hashIndex,
     const char *filename,
     bool threadsafe)
 {
-	mpqfs_archive_t *target = archive;
-	mpqfs_archive_t *clone = nullptr;
+	mpqfs_archive_t *target = archive.handle();
+	MpqArchive::PooledHandle clone;
 
 	if (threadsafe) {
-		clone = mpqfs_clone(archive);
-		if (clone == nullptr)
+		clone = archive.AcquireHandle();
+		if (clone.get() == nullptr)
 			return nullptr;
-		target = clone;
+		target = clone.get();
 	}
 
 	mpqfs_stream_t *stream = nullptr;
@@ -76,23 +117,370 @@ static MpqStreamCtx *CreateCtx(mpqfs_archive_t *archive,
 	if (stream == nullptr)
 		stream = mpqfs_stream_open(target, filename);
 
-	if (stream == nullptr) {
-		if (clone != nullptr)
-			mpqfs_close(clone);
+	if (stream == nullptr)
 		return nullptr;
-	}
 
-	auto *ctx = new (std::nothrow) MpqStreamCtx { stream, clone };
+	const auto size = static_cast<int64_t>(mpqfs_stream_size(stream));
+	auto *ctx = new (std::nothrow) MpqStreamCtx { stream, std::move(clone), nullptr, size, 0, 0, {} };
 	if (ctx == nullptr) {
 		mpqfs_stream_close(stream);
-		if (clone != nullptr)
-			mpqfs_close(clone);
 		return nullptr;
 	}
 
 	return ctx;
 }
 
+/* -----------------------------------------------------------------------
+ * Read-ahead for streams that are decoded on the audio thread.
+ *
+ * A single background thread keeps a ring buffer per stream filled, so
+ * that the decoder rarely waits for the archive to be read and
+ * decompressed. Once a stream has a read-ahead buffer, its mpqfs stream
+ * is only read by that thread, or by the reader after `ShutdownMpqReadAhead`.
+ * ----------------------------------------------------------------------- */
+
+struct ReadAheadBuffer {
+	std::unique_ptr<std::byte[]> data;
+	int64_t size;     /* Size of the file                          */
+	int64_t position; /* The reader's position, stored at `head`   */
+	size_t head = 0;
+	size_t filled = 0;
+	/* Bumped when a seek drops the buffered data, so that a chunk that is
+	 * being read for the old position is dropped as well. */
+	uint32_t generation = 0;
+	bool failed = false;
+	bool fetching = false;
+	bool closing = false;
+	bool readerWaiting = false;
+#ifndef __DJGPP__
+	SdlSemaphore dataReady;
+#endif
+
+	[[nodiscard]] bool needsData() const
+	{
+		return !failed && !closing && filled < ReadAheadSize && position + static_cast<int64_t>(filled) < size;
+	}
+};
+
+#ifndef __DJGPP__
+struct ReadAheadService {
+	/* Guards the buffers and the list of streams. */
+	SdlMutex mutex;
+	SdlSemaphore wakeup;
+	std::vector<MpqStreamCtx *> streams;
+	std::atomic<bool> stopping { false };
+	bool stopped = false;
+	SdlThread thread;
+};
+
+std::optional<ReadAheadService> ReadAheadServiceInstance;
+#endif
+
+static void DestroyReadAheadCtx(MpqStreamCtx *ctx)
+{
+	delete ctx->readAhead;
+	ctx->readAhead = nullptr;
+	DestroyCtx(ctx);
+}
+
+/**
+ * @brief Reads from the mpqfs stream, seeking it first if it isn't at `position`.
+ * @return The number of bytes read, 0 on failure.
+ */
+static size_t ReadFromSource(MpqStreamCtx &ctx, int64_t position, std::byte *dst, size_t length)
+{
+	if (ctx.sourcePosition != position) {
+		if (mpqfs_stream_seek(ctx.stream, position, SEEK_SET) < 0)
+			return 0;
+		ctx.sourcePosition = position;
+	}
+	const size_t n = mpqfs_stream_read(ctx.stream, dst, length);
+	if (n == static_cast<size_t>(-1))
+		return 0;
+	ctx.sourcePosition += static_cast<int64_t>(n);
+	return n;
+}
+
+/* -----------------------------------------------------------------------
+ * Reads of streams without read-ahead go through the shared sector cache,
+ * so that seeking back and forth within a file doesn't decompress the
+ * same sectors over and over.
+ * ----------------------------------------------------------------------- */
+
+/**
+ * @return The number of bytes read, less than `size` only at the end of the file, or -1 on failure.
+ */
+static size_t CachedRead(MpqStreamCtx &ctx, void *ptr, size_t size)
+{
+	MpqSectorCache &cache = GetMpqSectorCache();
+	auto *out = static_cast<std::byte *>(ptr);
+	size_t total = 0;
+	while (total < size && ctx.position < ctx.size) {
+		const size_t offset = static_cast<size_t>(ctx.position) % MpqSectorCacheBlockSize;
+		const size_t available = std::min(size - total, static_cast<size_t>(ctx.size - ctx.position));
+
+		if (offset == 0 && available >= MpqSectorCacheBlockSize) {
+			// Whole blocks are read directly, so that loading a whole file doesn't flush the cache.
+			const size_t length = available - (available % MpqSectorCacheBlockSize);
+			const size_t n = ReadFromSource(ctx, ctx.position, out + total, length);
+			if (n != length)
+				return total != 0 ? total : static_cast<size_t>(-1);
+			ctx.position += static_cast<int64_t>(n);
+			total += n;
+			continue;
+		}
+
+		const size_t length = std::min(available, MpqSectorCacheBlockSize - offset);
+		ctx.cacheKey.block = static_cast<uint32_t>(ctx.position / MpqSectorCacheBlockSize);
+		if (!cache.read(ctx.cacheKey, offset, { out + total, length })) {
+			std::array<std::byte, MpqSectorCacheBlockSize> block;
+			const int64_t blockPosition = ctx.position - static_cast<int64_t>(offset);
+			const size_t blockSize = std::min(MpqSectorCacheBlockSize, static_cast<size_t>(ctx.size - blockPosition));
+			if (ReadFromSource(ctx, blockPosition, block.data(), blockSize) != blockSize)
+				return total != 0 ? total : static_cast<size_t>(-1);
+			cache.insert(ctx.cacheKey, { block.data(), blockSize });
+			std::memcpy(out + total, &block[offset], length);
+		}
+		ctx.position += static_cast<int64_t>(length);
+		total += length;
+	}
+	return total;
+}
+
+static int64_t CachedSeek(MpqStreamCtx &ctx, int64_t offset, int whence)
+{
+	int64_t target;
+	switch (whence) {
+	case SEEK_SET: target = offset; break;
+	case SEEK_CUR: target = ctx.position + offset; break;
+	case SEEK_END: target = ctx.size + offset; break;
+	default: return -1;
+	}
+	if (target < 0 || target > ctx.size)
+		return -1;
+	// The mpqfs stream is only seeked once it is read from.
+	ctx.position = target;
+	return target;
+}
+
+/** @brief Reserves the free part of the ring buffer that follows the buffered data, up to `maxLength`. */
+static size_t NextChunk(const ReadAheadBuffer &buffer, size_t maxLength, size_t &tail)
+{
+	tail = (buffer.head + buffer.filled) % ReadAheadSize;
+	const int64_t remaining = buffer.size - (buffer.position + static_cast<int64_t>(buffer.filled));
+	return std::min({ maxLength, ReadAheadSize - buffer.filled, ReadAheadSize - tail, static_cast<size_t>(remaining) });
+}
+
+/** @brief Adds a chunk that was read at `tail` to the buffered data. */
+static void CommitChunk(ReadAheadBuffer &buffer, size_t length)
+{
+	if (length == 0) {
+		buffer.failed = true;
+		return;
+	}
+	buffer.filled += length;
+}
+
+#ifndef __DJGPP__
+/**
+ * @brief Fills a chunk of the stream that needs it the most.
+ * @return false if no stream needs data.
+ */
+static bool FetchNextChunk(ReadAheadService &service)
+{
+	std::unique_lock lock { service.mutex };
+	MpqStreamCtx *ctx = nullptr;
+	for (MpqStreamCtx *candidate : service.streams) {
+		const ReadAheadBuffer &buffer = *candidate->readAhead;
+		if (!buffer.needsData())
+			continue;
+		if (ctx == nullptr || buffer.readerWaiting || buffer.filled < ctx->readAhead->filled)
+			ctx = candidate;
+		if (buffer.readerWaiting)
+			break;
+	}
+	if (ctx == nullptr)
+		return false;
+
+	ReadAheadBuffer &buffer = *ctx->readAhead;
+	size_t tail;
+	const size_t length = NextChunk(buffer, ReadAheadChunkSize, tail);
+	const int64_t position = buffer.position + static_cast<int64_t>(buffer.filled);
+	const uint32_t generation = buffer.generation;
+	buffer.fetching = true;
+	lock.unlock();
+
+	const size_t n = ReadFromSource(*ctx, position, &buffer.data[tail], length);
+
+	lock.lock();
+	buffer.fetching = false;
+	if (buffer.closing) {
+		lock.unlock();
+		DestroyReadAheadCtx(ctx);
+		return true;
+	}
+	if (buffer.generation == generation)
+		CommitChunk(buffer, n);
+	if (buffer.readerWaiting) {
+		buffer.readerWaiting = false;
+		buffer.dataReady.post();
+	}
+	return true;
+}
+
+int SDLCALL ReadAheadWorker(void *data)
+{
+	auto &service = *static_cast<ReadAheadService *>(data);
+	while (!service.stopping.load(std::memory_order_acquire)) {
+		if (!FetchNextChunk(service))
+			service.wakeup.wait();
+	}
+	return 0;
+}
+
+ReadAheadService *GetReadAheadService()
+{
+	if (!ReadAheadServiceInstance) {
+		ReadAheadServiceInstance.emplace();
+		ReadAheadServiceInstance->thread = SdlThread { ReadAheadWorker, &*ReadAheadServiceInstance };
+	}
+	if (ReadAheadServiceInstance->stopped)
+		return nullptr;
+	return &*ReadAheadServiceInstance;
+}
+#endif
+
+/** @return false if the stream is to be read directly. */
+static bool StartReadAhead(MpqStreamCtx *ctx)
+{
+#ifdef __DJGPP__
+	return false;
+#else
+	ReadAheadService *service = GetReadAheadService();
+	if (service == nullptr)
+		return false;
+
+	auto *buffer = new (std::nothrow) ReadAheadBuffer {};
+	if (buffer == nullptr)
+		return false;
+	buffer->data = std::unique_ptr<std::byte[]> { new (std::nothrow) std::byte[ReadAheadSize] };
+	if (buffer->data == nullptr) {
+		delete buffer;
+		return false;
+	}
+	buffer->size = ctx->size;
+	buffer->position = 0;
+	ctx->readAhead = buffer;
+
+	const std::lock_guard lock { service->mutex };
+	service->streams.push_back(ctx);
+	service->wakeup.post();
+	return true;
+#endif
+}
+
+static void CloseReadAhead(MpqStreamCtx *ctx)
+{
+#ifndef __DJGPP__
+	ReadAheadService &service = *ReadAheadServiceInstance;
+	{
+		const std::lock_guard lock { service.mutex };
+		service.streams.erase(std::find(service.streams.begin(), service.streams.end(), ctx));
+		if (ctx->readAhead->fetching) {
+			ctx->readAhead->closing = true;
+			return;
+		}
+	}
+#endif
+	DestroyReadAheadCtx(ctx);
+}
+
+/**
+ * @brief Copies the next bytes of the stream, waiting for the read-ahead thread if they haven't been read yet.
+ * @return The number of bytes read, less than `size` only at the end of the file, or -1 on failure.
+ */
+static size_t ReadAheadRead(MpqStreamCtx *ctx, void *ptr, size_t size)
+{
+#ifdef __DJGPP__
+	return 0;
+#else
+	ReadAheadService &service = *ReadAheadServiceInstance;
+	ReadAheadBuffer &buffer = *ctx->readAhead;
+	auto *out = static_cast<std::byte *>(ptr);
+	size_t total = 0;
+	std::unique_lock lock { service.mutex };
+	while (total < size && buffer.position < buffer.size) {
+		if (buffer.filled == 0) {
+			if (buffer.failed)
+				return static_cast<size_t>(-1);
+			if (service.stopped) {
+				size_t tail;
+				const size_t length = NextChunk(buffer, ReadAheadChunkSize, tail);
+				CommitChunk(buffer, ReadFromSource(*ctx, buffer.position, &buffer.data[tail], length));
+				continue;
+			}
+			buffer.readerWaiting = true;
+			service.wakeup.post();
+			lock.unlock();
+			buffer.dataReady.wait();
+			lock.lock();
+			continue;
+		}
+		const bool wasFull = buffer.filled == ReadAheadSize;
+		const size_t n = std::min({ size - total, buffer.filled, ReadAheadSize - buffer.head });
+		std::memcpy(out + total, &buffer.data[buffer.head], n);
+		buffer.head = (buffer.head + n) % ReadAheadSize;
+		buffer.filled -= n;
+		buffer.position += static_cast<int64_t>(n);
+		total += n;
+		// The read-ahead thread only looks at streams that have room.
+		if (wasFull)
+			service.wakeup.post();
+	}
+	return total;
+#endif
+}
+
+static int64_t ReadAheadSeek(MpqStreamCtx *ctx, int64_t offset, int whence)
+{
+#ifdef __DJGPP__
+	return -1;
+#else
+	ReadAheadService &service = *ReadAheadServiceInstance;
+	ReadAheadBuffer &buffer = *ctx->readAhead;
+	const std::lock_guard lock { service.mutex };
+	int64_t target;
+	switch (whence) {
+	case SEEK_SET: target = offset; break;
+	case SEEK_CUR: target = buffer.position + offset; break;
+	case SEEK_END: target = buffer.size + offset; break;
+	default: return -1;
+	}
+	if (target < 0 || target > buffer.size)
+		return -1;
+
+	if (target >= buffer.position && target <= buffer.position + static_cast<int64_t>(buffer.filled)) {
+		// Skipping ahead within the buffered data, e.g. over a chunk the decoder doesn't need.
+		const auto skip = static_cast<size_t>(target - buffer.position);
+		const bool wasFull = buffer.filled == ReadAheadSize;
+		buffer.head = (buffer.head + skip) % ReadAheadSize;
+		buffer.filled -= skip;
+		buffer.position = target;
+		if (wasFull && skip != 0)
+			service.wakeup.post();
+		return target;
+	}
+
+	buffer.head = 0;
+	buffer.filled = 0;
+	buffer.position = target;
+	buffer.failed = false;
+	++buffer.generation;
+	service.wakeup.post();
+	return target;
+#endif
+}
+
 /* =======================================================================
  * SDL3 implementation
  * ======================================================================= */
@@ -117,7 +505,7 @@ static Sint64 SDLCALL MpqStream_Seek(void *userdata, Sint64 offset, SDL_IOWhence
 		SDL_SetError("MpqStream_Seek: unknown whence");
 		return -1;
 	}
-	int64_t pos = mpqfs_stream_seek(ctx->stream, offset, w);
+	int64_t pos = ctx->readAhead != nullptr ? ReadAheadSeek(ctx, offset, w) : CachedSeek(*ctx, offset, w);
 	if (pos < 0) {
 		SDL_SetError("MpqStream_Seek: seek failed");
 		return -1;
@@ -128,7 +516,7 @@ static Sint64 SDLCALL MpqStream_Seek(void *userdata, Sint64 offset, SDL_IOWhence
 static size_t SDLCALL MpqStream_Read(void *userdata, void *ptr, size_t size, SDL_IOStatus *status)
 {
 	auto *ctx = static_cast<MpqStreamCtx *>(userdata);
-	size_t n = mpqfs_stream_read(ctx->stream, ptr, size);
+	size_t n = ctx->readAhead != nullptr ? ReadAheadRead(ctx, ptr, size) : CachedRead(*ctx, ptr, size);
 	if (n == static_cast<size_t>(-1)) {
 		if (status != nullptr)
 			*status = SDL_IO_STATUS_ERROR;
@@ -201,7 +589,7 @@ static OffsetType SDLCALL MpqStream_Seek(SDL_RWops *rw, OffsetType offset, int w
 		return -1;
 	}
 
-	int64_t pos = mpqfs_stream_seek(ctx->stream, offset, w);
+	int64_t pos = ctx->readAhead != nullptr ? ReadAheadSeek(ctx, offset, w) : CachedSeek(*ctx, offset, w);
 	if (pos < 0) {
 		SDL_SetError("MpqStream_Seek: seek failed");
 		return -1;
@@ -216,7 +604,7 @@ static SizeType SDLCALL MpqStream_Read(SDL_RWops *rw, void *ptr,
 	auto *ctx = static_cast<MpqStreamCtx *>(rw->hidden.unknown.data1);
 
 	size_t totalBytes = static_cast<size_t>(size) * static_cast<size_t>(maxnum);
-	size_t n = mpqfs_stream_read(ctx->stream, ptr, totalBytes);
+	size_t n = ctx->readAhead != nullptr ? ReadAheadRead(ctx, ptr, totalBytes) : CachedRead(*ctx, ptr, totalBytes);
 	if (n == static_cast<size_t>(-1))
 		return 0;
 
@@ -243,13 +631,22 @@ static int SDLCALL MpqStream_Close(SDL_RWops *rw)
 
 #endif /* !USE_SDL3 */
 
-} // namespace
-
-SdlRwopsType *SDL_RWops_FromMpqFile(MpqArchive &archive,
+SdlRwopsType *OpenMpqRwops(MpqArchive &archive,
     uint32_t hashIndex,
     std::string_view filename,
-    bool threadsafe)
+    bool threadsafe,
+    bool readAhead)
 {
+	/* Uncompressed files in a memory-mapped archive are read in place.
+	 * The mapping is read-only, so this is safe from any thread. */
+	if (const std::optional<std::span<const std::byte>> view = archive.FindUncompressedFile(filename); view && !view->empty()) {
+#ifdef USE_SDL3
+		return SDL_IOFromConstMem(view->data(), view->size());
+#else
+		return SDL_IOFromConstMem(view->data(), static_cast<int>(view->size()));
+#endif
+	}
+
 	/* NUL-terminate the filename for the C API. */
 	char pathBuf[MaxMpqPathSize];
 	if (filename.size() >= sizeof(pathBuf))
@@ -257,9 +654,13 @@ SdlRwopsType *SDL_RWops_FromMpqFile(MpqArchive &archive,
 	std::memcpy(pathBuf, filename.data(), filename.size());
 	pathBuf[filename.size()] = '\0';
 
-	MpqStreamCtx *ctx = CreateCtx(archive.handle(), hashIndex, pathBuf, threadsafe);
+	MpqStreamCtx *ctx = CreateCtx(archive, hashIndex, pathBuf, threadsafe);
 	if (ctx == nullptr)
 		return nullptr;
+	const MpqArchive::FileNameHash nameHash = MpqArchive::HashFileName(filename);
+	ctx->cacheKey = MpqSectorCacheKey { archive.id(), nameHash.a, nameHash.b, 0 };
+	if (readAhead)
+		StartReadAhead(ctx);
 
 #ifdef USE_SDL3
 	SDL_IOStreamInterface iface = {};
@@ -300,4 +701,43 @@ SdlRwopsType *SDL_RWops_FromMpqFile(MpqArchive &archive,
 #endif
 }
 
+} // namespace
+
+SdlRwopsType *SDL_RWops_FromMpqFile(MpqArchive &archive,
+    uint32_t hashIndex,
+    std::string_view filename,
+    bool threadsafe)
+{
+	return OpenMpqRwops(archive, hashIndex, filename, threadsafe, /*readAhead=*/false);
+}
+
+SdlRwopsType *SDL_RWops_FromMpqFileWithReadAhead(MpqArchive &archive,
+    uint32_t hashIndex,
+    std::string_view filename)
+{
+	return OpenMpqRwops(archive, hashIndex, filename, /*threadsafe=*/true, /*readAhead=*/true);
+}
+
+void ShutdownMpqReadAhead()
+{
+#ifndef __DJGPP__
+	if (!ReadAheadServiceInstance)
+		return;
+	ReadAheadService &service = *ReadAheadServiceInstance;
+	service.stopping.store(true, std::memory_order_release);
+	service.wakeup.post();
+	service.thread.join();
+
+	// Streams that are still open are read directly from now on.
+	const std::lock_guard lock { service.mutex };
+	service.stopped = true;
+	for (MpqStreamCtx *ctx : service.streams) {
+		if (ctx->readAhead->readerWaiting) {
+			ctx->readAhead->readerWaiting = false;
+			ctx->readAhead->dataReady.post();
+		}
+	}
+#endif
+}
+
 } // namespace devilution
\ No newline at end of file
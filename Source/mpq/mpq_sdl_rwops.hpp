@@ -20,4 +20,21 @@ SdlRwopsType *SDL_RWops_FromMpqFile(MpqArchive &archive,
     std::string_view filename,
     bool threadsafe);
 
+/**
+ * @brief Same as `SDL_RWops_FromMpqFile` with `threadsafe`, for files that are streamed while they play.
+ *
+ * A background thread reads ahead of the decoder into a buffer of `DEVILUTIONX_STREAM_READ_AHEAD_SIZE` bytes,
+ * so that it doesn't wait for the archive to be read and decompressed.
+ */
+SdlRwopsType *SDL_RWops_FromMpqFileWithReadAhead(MpqArchive &archive,
+    uint32_t hashIndex,
+    std::string_view filename);
+
+/**
+ * @brief Stops the read-ahead thread, streams that are still open are read directly from then on.
+ *
+ * Must be called before the archives are unloaded.
+ */
+void ShutdownMpqReadAhead();
+
 } // namespace devilution
@@ -0,0 +1,83 @@
+#include "mpq/mpq_sector_cache.hpp"
+
+#include <cstring>
+#include <iterator>
+#include <mutex>
+
+namespace devilution {
+
+namespace {
+
+#ifdef DEVILUTIONX_MPQ_SECTOR_CACHE_SIZE
+/** @brief How much memory the cache may take up, 0 disables it. */
+constexpr size_t MpqSectorCacheSize = DEVILUTIONX_MPQ_SECTOR_CACHE_SIZE;
+#else
+constexpr size_t MpqSectorCacheSize = 256 * 1024;
+#endif
+
+} // namespace
+
+MpqSectorCache::MpqSectorCache(size_t maxBlocks)
+    : maxBlocks_(maxBlocks)
+{
+}
+
+bool MpqSectorCache::read(const MpqSectorCacheKey &key, size_t offset, std::span<std::byte> out)
+{
+	if (maxBlocks_ == 0)
+		return false;
+	const std::lock_guard lock { mutex_ };
+	const auto it = index_.find(key);
+	if (it == index_.end() || offset + out.size() > it->second->size) {
+		++stats_.misses;
+		return false;
+	}
+	++stats_.hits;
+	entries_.splice(entries_.begin(), entries_, it->second);
+	std::memcpy(out.data(), &it->second->data[offset], out.size());
+	return true;
+}
+
+void MpqSectorCache::insert(const MpqSectorCacheKey &key, std::span<const std::byte> data)
+{
+	if (maxBlocks_ == 0 || data.size() > MpqSectorCacheBlockSize)
+		return;
+	const std::lock_guard lock { mutex_ };
+	auto it = index_.find(key);
+	if (it != index_.end()) {
+		entries_.splice(entries_.begin(), entries_, it->second);
+	} else if (entries_.size() < maxBlocks_) {
+		entries_.emplace_front();
+		it = index_.emplace(key, entries_.begin()).first;
+	} else {
+		// Reuses the least recently used entry rather than allocating a new one.
+		index_.erase(entries_.back().key);
+		entries_.splice(entries_.begin(), entries_, std::prev(entries_.end()));
+		it = index_.emplace(key, entries_.begin()).first;
+	}
+	Entry &entry = *it->second;
+	entry.key = key;
+	entry.size = data.size();
+	std::memcpy(entry.data.data(), data.data(), data.size());
+}
+
+void MpqSectorCache::clear()
+{
+	const std::lock_guard lock { mutex_ };
+	entries_.clear();
+	index_.clear();
+}
+
+MpqSectorCacheStats MpqSectorCache::stats()
+{
+	const std::lock_guard lock { mutex_ };
+	return stats_;
+}
+
+MpqSectorCache &GetMpqSectorCache()
+{
+	static MpqSectorCache Cache { MpqSectorCacheSize / MpqSectorCacheBlockSize };
+	return Cache;
+}
+
+} // namespace devilution
@@ -0,0 +1,100 @@
+/**
+ * @file mpq_sector_cache.hpp
+ *
+ * A shared cache of decompressed file blocks, for random-access reads of compressed files in MPQ archives.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <span>
+#include <string_view>
+
+#include <ankerl/unordered_dense.h>
+
+#include "utils/sdl_mutex.h"
+
+namespace devilution {
+
+/**
+ * @brief The sector size of the Diablo and Hellfire archives.
+ *
+ * Blocks are aligned to it, so that a miss decompresses a single sector.
+ */
+constexpr size_t MpqSectorCacheBlockSize = 4096;
+
+struct MpqSectorCacheKey {
+	/** @brief See `MpqArchive::id`. */
+	uint32_t archiveId;
+	/** @brief The name hashes of the file, see `MpqArchive::HashFileName`. */
+	uint32_t fileA;
+	uint32_t fileB;
+	/** @brief The offset in the file divided by `MpqSectorCacheBlockSize`. */
+	uint32_t block;
+
+	bool operator==(const MpqSectorCacheKey &other) const = default;
+};
+
+struct MpqSectorCacheStats {
+	size_t hits;
+	size_t misses;
+};
+
+/**
+ * @brief LRU cache of decompressed file blocks, safe to use from any thread.
+ */
+class MpqSectorCache {
+public:
+	/** @param maxBlocks 0 disables the cache. */
+	explicit MpqSectorCache(size_t maxBlocks);
+
+	MpqSectorCache(const MpqSectorCache &) = delete;
+	MpqSectorCache &operator=(const MpqSectorCache &) = delete;
+
+	/**
+	 * @brief Copies `out.size()` bytes at `offset` in the block, if the block is cached.
+	 * @return false if the block is not cached.
+	 */
+	bool read(const MpqSectorCacheKey &key, size_t offset, std::span<std::byte> out);
+
+	/**
+	 * @brief Adds a block, evicting the least recently used one if the cache is full.
+	 * @param data At most `MpqSectorCacheBlockSize` bytes, less only for the last block of a file.
+	 */
+	void insert(const MpqSectorCacheKey &key, std::span<const std::byte> data);
+
+	void clear();
+
+	[[nodiscard]] MpqSectorCacheStats stats();
+
+private:
+	struct Entry {
+		MpqSectorCacheKey key;
+		size_t size;
+		std::array<std::byte, MpqSectorCacheBlockSize> data;
+	};
+
+	struct KeyHash {
+		using is_avalanching = void;
+
+		[[nodiscard]] uint64_t operator()(const MpqSectorCacheKey &key) const noexcept
+		{
+			return ankerl::unordered_dense::hash<std::string_view> {}(
+			    std::string_view { reinterpret_cast<const char *>(&key), sizeof(key) });
+		}
+	};
+
+	SdlMutex mutex_;
+	size_t maxBlocks_;
+	/** @brief Most recently used first. */
+	std::list<Entry> entries_;
+	ankerl::unordered_dense::map<MpqSectorCacheKey, std::list<Entry>::iterator, KeyHash> index_;
+	MpqSectorCacheStats stats_ {};
+};
+
+/** @brief The cache shared by all MPQ streams. */
+MpqSectorCache &GetMpqSectorCache();
+
+} // namespace devilution
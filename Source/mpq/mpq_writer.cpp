@@ -13,35 +13,50 @@ namespace devilution {
 
 MpqWriter::MpqWriter(const char *path, bool carryForward)
     : path_(path)
+    , carryForward_(carryForward)
 {
+	Open(carryForward);
+}
+
+MpqWriter MpqWriter::Deferred(const std::string &path, bool carryForward)
+{
+	MpqWriter writer;
+	writer.path_ = path;
+	writer.deferred_ = true;
+	writer.carryForward_ = carryForward;
+	return writer;
+}
+
+void MpqWriter::Open(bool carryForward)
+{
+	const char *path = path_.c_str();
 	const std::string dir = std::string(Dirname(path));
 	if (!dir.empty()) {
 		RecursivelyCreateDir(dir.c_str());
 	}
 	LogVerbose("Opening {}", path);
 
-	// If the file already exists and we need to preserve its contents,
-	// rename it to a temp path so we can read from it after the writer
-	// truncates the original path.
-	std::string tmpPath;
+	// Older versions moved the archive to the temp path while writing, recover it if that was interrupted.
+	const std::string tmpPath = path_ + ".tmp";
+	if (!FileExists(path) && FileExists(tmpPath.c_str()))
+		::devilution::RenameFile(tmpPath.c_str(), path);
+
+	// The new archive is written to its own path and only replaces the old one once it is complete.
+	const std::string newPath = path_ + ".new";
+	::devilution::RemoveFile(newPath.c_str());
+
 	mpqfs_archive_t *oldArchive = nullptr;
 	if (carryForward && FileExists(path)) {
-		tmpPath = std::string(path) + ".tmp";
-		// Remove any stale temp file, then rename old → tmp.
-		::devilution::RemoveFile(tmpPath.c_str());
-		::devilution::RenameFile(path, tmpPath.c_str());
-		oldArchive = mpqfs_open(tmpPath.c_str());
+		oldArchive = mpqfs_open(path);
 		// If it fails to open (e.g. corrupt), we proceed without
 		// carry-forward — the file will be recreated from scratch.
 	}
 
-	writer_ = mpqfs_writer_create(path, MpqWriterHashTableSize);
+	writer_ = mpqfs_writer_create(newPath.c_str(), MpqWriterHashTableSize);
 	if (writer_ == nullptr) {
 		LogError("Failed to create MPQ archive: {}", mpqfs_last_error());
 		if (oldArchive != nullptr)
 			mpqfs_close(oldArchive);
-		if (!tmpPath.empty())
-			::devilution::RemoveFile(tmpPath.c_str());
 		return;
 	}
 
@@ -51,16 +66,35 @@ MpqWriter::MpqWriter(const char *path, bool carryForward)
 		}
 		mpqfs_close(oldArchive);
 	}
+}
+
+void MpqWriter::Close()
+{
+	if (writer_ == nullptr)
+		return;
+
+	LogVerbose("Closing {}", path_);
 
-	if (!tmpPath.empty())
-		::devilution::RemoveFile(tmpPath.c_str());
+	const std::string newPath = path_ + ".new";
+	const bool closed = mpqfs_writer_close(writer_);
+	writer_ = nullptr;
+	if (!closed) {
+		LogError("Failed to close MPQ archive: {}", mpqfs_last_error());
+		::devilution::RemoveFile(newPath.c_str());
+		return;
+	}
+	::devilution::RenameFile(newPath.c_str(), path_.c_str());
 }
 
 MpqWriter::MpqWriter(MpqWriter &&other) noexcept
     : path_(std::move(other.path_))
     , writer_(other.writer_)
+    , deferred_(other.deferred_)
+    , carryForward_(other.carryForward_)
+    , pending_(std::move(other.pending_))
 {
 	other.writer_ = nullptr;
+	other.deferred_ = false;
 }
 
 MpqWriter &MpqWriter::operator=(MpqWriter &&other) noexcept
@@ -70,21 +104,20 @@ MpqWriter &MpqWriter::operator=(MpqWriter &&other) noexcept
 			mpqfs_writer_discard(writer_);
 		path_ = std::move(other.path_);
 		writer_ = other.writer_;
+		deferred_ = other.deferred_;
+		carryForward_ = other.carryForward_;
+		pending_ = std::move(other.pending_);
 		other.writer_ = nullptr;
+		other.deferred_ = false;
 	}
 	return *this;
 }
 
 MpqWriter::~MpqWriter()
 {
-	if (writer_ == nullptr)
-		return;
-
-	LogVerbose("Closing {}", path_);
-
-	if (!mpqfs_writer_close(writer_)) {
-		LogError("Failed to close MPQ archive: {}", mpqfs_last_error());
-	}
+	// A deferred writer that was never committed still writes its changes
+	Commit();
+	Close();
 }
 
 bool MpqWriter::HasFile(std::string_view name) const
@@ -103,6 +136,10 @@ bool MpqWriter::HasFile(std::string_view name) const
 
 void MpqWriter::RemoveHashEntry(std::string_view filename)
 {
+	if (deferred_) {
+		pending_.push_back({ .kind = PendingChange::Kind::RemoveFile, .name = std::string(filename) });
+		return;
+	}
 	if (writer_ == nullptr)
 		return;
 
@@ -117,6 +154,10 @@ void MpqWriter::RemoveHashEntry(std::string_view filename)
 
 void MpqWriter::RemoveHashEntries(bool (*fnGetName)(uint8_t, char *))
 {
+	if (deferred_) {
+		pending_.push_back({ .kind = PendingChange::Kind::RemoveFiles, .fnGetName = fnGetName });
+		return;
+	}
 	char pszFileName[MaxMpqPathSize];
 	for (uint8_t i = 0; fnGetName(i, pszFileName); i++) {
 		RemoveHashEntry(pszFileName);
@@ -125,6 +166,12 @@ void MpqWriter::RemoveHashEntries(bool (*fnGetName)(uint8_t, char *))
 
 bool MpqWriter::WriteFile(std::string_view filename, const std::byte *data, size_t size)
 {
+	if (deferred_) {
+		std::unique_ptr<std::byte[]> copy { new std::byte[size] };
+		std::memcpy(copy.get(), data, size);
+		pending_.push_back({ .kind = PendingChange::Kind::WriteFile, .name = std::string(filename), .data = std::move(copy), .size = size });
+		return true;
+	}
 	if (writer_ == nullptr)
 		return false;
 
@@ -147,6 +194,10 @@ bool MpqWriter::WriteFile(std::string_view filename, const std::byte *data, size
 
 void MpqWriter::RenameFile(std::string_view name, std::string_view newName)
 {
+	if (deferred_) {
+		pending_.push_back({ .kind = PendingChange::Kind::RenameFile, .name = std::string(name), .newName = std::string(newName) });
+		return;
+	}
 	if (writer_ == nullptr)
 		return;
 
@@ -162,4 +213,47 @@ void MpqWriter::RenameFile(std::string_view name, std::string_view newName)
 	mpqfs_writer_rename_file(writer_, oldBuf, newBuf);
 }
 
+void MpqWriter::Defer(void (*fn)(MpqWriter &))
+{
+	if (deferred_) {
+		pending_.push_back({ .kind = PendingChange::Kind::Call, .fn = fn });
+		return;
+	}
+	fn(*this);
+}
+
+void MpqWriter::Commit()
+{
+	if (!deferred_)
+		return;
+	deferred_ = false;
+	// Nothing changed, the archive on disk is already up to date
+	if (pending_.empty())
+		return;
+	Open(carryForward_);
+	for (PendingChange &change : pending_) {
+		switch (change.kind) {
+		case PendingChange::Kind::WriteFile:
+			WriteFile(change.name, change.data.get(), change.size);
+			break;
+		case PendingChange::Kind::RemoveFile:
+			RemoveHashEntry(change.name);
+			break;
+		case PendingChange::Kind::RemoveFiles:
+			RemoveHashEntries(change.fnGetName);
+			break;
+		case PendingChange::Kind::RenameFile:
+			RenameFile(change.name, change.newName);
+			break;
+		case PendingChange::Kind::Call:
+			change.fn(*this);
+			break;
+		}
+		// Release the data as we go, the compressed copy is all that is needed now
+		change.data = nullptr;
+	}
+	pending_.clear();
+	Close();
+}
+
 } // namespace devilution
\ No newline at end of file
@@ -7,8 +7,10 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
 // Forward-declare so that we can avoid exposing mpqfs.h to all consumers.
 struct mpqfs_writer;
@@ -18,6 +20,12 @@ namespace devilution {
 
 constexpr uint32_t MpqWriterHashTableSize = 2048;
 
+/**
+ * @brief Writes an MPQ archive, the changes become visible when the writer is destroyed.
+ *
+ * The new archive is written next to the old one and then renamed over it,
+ * so a crash while writing leaves the old archive intact.
+ */
 class MpqWriter {
 public:
 	explicit MpqWriter(const char *path, bool carryForward = true);
@@ -25,6 +33,14 @@ public:
 	    : MpqWriter(path.c_str(), carryForward)
 	{
 	}
+
+	/**
+	 * @brief Creates a writer that only records the changes, the archive is opened and written by `Commit`.
+	 *
+	 * This lets the slow part of saving, compressing and writing the files, run on another thread.
+	 * `HasFile` always returns false until then, use `Defer` for changes that depend on the archive contents.
+	 */
+	static MpqWriter Deferred(const std::string &path, bool carryForward = true);
 	MpqWriter(MpqWriter &&other) noexcept;
 	MpqWriter &operator=(MpqWriter &&other) noexcept;
 	~MpqWriter();
@@ -38,9 +54,43 @@ public:
 	bool WriteFile(std::string_view filename, const std::byte *data, size_t size);
 	void RenameFile(std::string_view name, std::string_view newName);
 
+	/**
+	 * @brief Calls `fn` with the open archive, or records it for `Commit` if the writer is deferred.
+	 */
+	void Defer(void (*fn)(MpqWriter &));
+
+	/**
+	 * @brief Applies the recorded changes of a deferred writer and writes the archive.
+	 */
+	void Commit();
+
 private:
+	struct PendingChange {
+		enum class Kind : uint8_t {
+			WriteFile,
+			RemoveFile,
+			RemoveFiles,
+			RenameFile,
+			Call,
+		};
+		Kind kind;
+		std::string name;
+		std::string newName;
+		std::unique_ptr<std::byte[]> data;
+		size_t size = 0;
+		bool (*fnGetName)(uint8_t, char *) = nullptr;
+		void (*fn)(MpqWriter &) = nullptr;
+	};
+
+	MpqWriter() = default;
+	void Open(bool carryForward);
+	void Close();
+
 	std::string path_;
 	mpqfs_writer_t *writer_ = nullptr;
+	bool deferred_ = false;
+	bool carryForward_ = true;
+	std::vector<PendingChange> pending_;
 };
 
 } // namespace devilution
\ No newline at end of file
@@ -5,11 +5,13 @@
  */
 #include "msg.h"
 
+#include <bitset>
 #include <climits>
 #include <cmath>
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <vector>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_timer.h>
@@ -42,6 +44,7 @@
 #include "missiles.h"
 #include "monster.h"
 #include "monsters/validation.hpp"
+#include "net_stats.hpp"
 #include "nthread.h"
 #include "objects.h"
 #include "options.h"
@@ -57,6 +60,7 @@
 #include "sync.h"
 #include "tmsg.h"
 #include "towners.h"
+#include "utils/algorithm/container.hpp"
 #include "utils/endian_swap.hpp"
 #include "utils/is_of.hpp"
 #include "utils/language.h"
@@ -196,6 +200,7 @@ std::string_view CmdIdString(_cmd_id cmd)
 	case CMD_SPAWNMONSTER: return "CMD_SPAWNMONSTER";
 	case FAKE_CMD_SETID: return "FAKE_CMD_SETID";
 	case FAKE_CMD_DROPID: return "FAKE_CMD_DROPID";
+	case CMD_STATEHASH: return "CMD_STATEHASH";
 	case CMD_INVALID: return "CMD_INVALID";
 	default: return "";
 	}
@@ -298,11 +303,35 @@ ankerl::unordered_dense::map<uint8_t, LocalLevel> LocalLevels;
 DJunk sgJunk;
 uint8_t sgbDeltaChunks;
 std::list<TMegaPkt> MegaPktList;
+/** @brief Packets released by `FreePackets`, reused by `GetNextPacket` instead of allocating new ones. */
+std::list<TMegaPkt> FreeMegaPktList;
 Item ItemLimbo;
 
 /** @brief Last sent player command for the local player. */
 TCmdLocParam5 lastSentPlayerCmd;
 
+/** @brief Remote players whose equipment changed since their stats were last calculated, see CalcChangedPlayerEquipment. */
+std::bitset<MAX_PLRS> PlayersWithChangedEquipment;
+/** @brief Whether the graphics of the remote players with changed equipment should be updated as well. */
+std::bitset<MAX_PLRS> PlayersWithChangedEquipmentGfx;
+
+/**
+ * @brief Defers recalculating a remote player's stats after an equipment change, so that a series of changes is only calculated once.
+ */
+void QueueEquipmentChange(const Player &player, bool loadgfx)
+{
+	const uint8_t pnum = player.getId();
+	PlayersWithChangedEquipment.set(pnum);
+	if (loadgfx)
+		PlayersWithChangedEquipmentGfx.set(pnum);
+}
+
+/** @brief Whether the message only changes a remote player's items, without reading the stats they give. */
+bool IsEquipmentChangeCmd(_cmd_id cmd)
+{
+	return IsAnyOf(cmd, CMD_CHANGEPLRITEMS, CMD_DELPLRITEMS, CMD_CHANGEINVITEMS, CMD_DELINVITEMS, CMD_CHANGEBELTITEMS, CMD_DELBELTITEMS);
+}
+
 void RecreateItem(const Player &player, const TCmdPItem &message, Item &item);
 
 bool IsMonsterDeltaValid(const DMonsterStr &monster)
@@ -415,12 +444,17 @@ bool WasPlayerCmdAlreadyRequested(_cmd_id bCmd, Point position = {}, uint16_t wP
 
 void GetNextPacket()
 {
-	MegaPktList.emplace_back();
+	if (FreeMegaPktList.empty()) {
+		MegaPktList.emplace_back();
+		return;
+	}
+	MegaPktList.splice(MegaPktList.end(), FreeMegaPktList, FreeMegaPktList.begin());
+	MegaPktList.back().spaceLeft = sizeof(TMegaPkt::data);
 }
 
 void FreePackets()
 {
-	MegaPktList.clear();
+	FreeMegaPktList.splice(FreeMegaPktList.end(), MegaPktList);
 }
 
 void PrePacket()
@@ -463,12 +497,14 @@ void PrePacket()
 			const size_t size = ParseCmd(playerId, reinterpret_cast<TCmd *>(data), remainingBytes);
 			if (size == 0) {
 				Log("Discarding bad network message");
+				CalcChangedPlayerEquipment();
 				return;
 			}
 			data += size;
 			remainingBytes -= size;
 		}
 	}
+	CalcChangedPlayerEquipment();
 }
 
 void BufferMessage(const void *message, size_t messageSize)
@@ -778,6 +814,18 @@ uint32_t CompressData(std::byte *buffer, std::byte *end)
 #endif
 }
 
+size_t GetDeltaLevelExportSize(const DLevel &deltaLevel)
+{
+	return 1U                                                                                 /* marker byte, always 0 */
+	    + sizeof(uint8_t)                                                                     /* level id */
+	    + sizeof(deltaLevel.item)                                                             /* items spawned during dungeon generation which have been picked up, and items dropped by a player during a game */
+	    + sizeof(uint8_t)                                                                     /* count of object interactions which caused a state change since dungeon generation */
+	    + ((sizeof(WorldTilePosition) + sizeof(DObjectStr)) * deltaLevel.object.size())       /* location/action pairs for the object interactions */
+	    + sizeof(deltaLevel.monster)                                                          /* latest monster state */
+	    + sizeof(uint16_t)                                                                    /* spawned monster count */
+	    + ((sizeof(uint16_t) + sizeof(DSpawnedMonster)) * deltaLevel.spawnedMonsters.size()); /* spawned monsters */
+}
+
 void DeltaImportData(_cmd_id cmd, uint32_t recvOffset, int pnum)
 {
 	size_t deltaSize = recvOffset;
@@ -2151,8 +2199,12 @@ size_t OnChangePlayerItems(const TCmdChItem &message, Player &player)
 		item = {};
 		RecreateItem(player, message, item);
 		CheckInvSwap(player, bodyLocation);
+		QueueEquipmentChange(player, true);
 	}
 
+	// Whether the spell of a staff can be readied depends on the player meeting its requirements
+	if (player.InvBody[bodyLocation]._itype == ItemType::Staff)
+		CalcChangedPlayerEquipment();
 	player.ReadySpellFromEquipment(bodyLocation, message.forceSpell);
 
 	return sizeof(message);
@@ -2161,8 +2213,10 @@ size_t OnChangePlayerItems(const TCmdChItem &message, Player &player)
 size_t OnDeletePlayerItems(const TCmdDelItem &message, Player &player)
 {
 	if (gbBufferMsgs != 1) {
-		if (&player != MyPlayer && message.bLoc < NUM_INVLOC)
+		if (&player != MyPlayer && message.bLoc < NUM_INVLOC) {
 			inv_update_rem_item(player, static_cast<inv_body_loc>(message.bLoc));
+			QueueEquipmentChange(player, player._pmode != PM_DEATH);
+		}
 	} else {
 		BufferMessage(player, &message, sizeof(message));
 	}
@@ -2633,6 +2687,18 @@ size_t OnSpawnMonster(const TCmdSpawnMonster &message, const Player &player)
 	return sizeof(message);
 }
 
+size_t OnStateHash(const TCmdStateHash &message, const Player &player)
+{
+	if (gbBufferMsgs == 1 || &player == MyPlayer)
+		return sizeof(message);
+
+	StateHash hash;
+	for (size_t i = 0; i < NumStateHashClasses; i++)
+		hash.classes[i] = Swap64LE(message.hashes[i]);
+	CompareStateHash(player, Swap32LE(message.gameLoop), hash);
+	return sizeof(message);
+}
+
 template <typename TCmdImpl>
 size_t HandleCmd(size_t (*handler)(const TCmdImpl &, size_t, Player &), Player &player, const TCmd *pCmd, size_t maxCmdSize)
 {
@@ -2772,17 +2838,20 @@ void run_delta_info()
 
 void DeltaExportData(uint8_t pnum)
 {
+	// Send the levels in order, starting with the town that joining players enter first
+	std::vector<uint8_t> levels;
+	levels.reserve(DeltaLevels.size());
+	size_t bufferSize = 0;
 	for (const auto &[levelNum, deltaLevel] : DeltaLevels) {
-		const size_t bufferSize = 1U                                                              /* marker byte, always 0 */
-		    + sizeof(uint8_t)                                                                     /* level id */
-		    + sizeof(deltaLevel.item)                                                             /* items spawned during dungeon generation which have been picked up, and items dropped by a player during a game */
-		    + sizeof(uint8_t)                                                                     /* count of object interactions which caused a state change since dungeon generation */
-		    + ((sizeof(WorldTilePosition) + sizeof(DObjectStr)) * deltaLevel.object.size())       /* location/action pairs for the object interactions */
-		    + sizeof(deltaLevel.monster)                                                          /* latest monster state */
-		    + sizeof(uint16_t)                                                                    /* spawned monster count */
-		    + ((sizeof(uint16_t) + sizeof(DSpawnedMonster)) * deltaLevel.spawnedMonsters.size()); /* spawned monsters */
-		const std::unique_ptr<std::byte[]> dst { new std::byte[bufferSize] };
+		levels.push_back(levelNum);
+		bufferSize = std::max(bufferSize, GetDeltaLevelExportSize(deltaLevel));
+	}
+	c_sort(levels);
 
+	// All levels are exported into the same buffer, they are copied into packets right away
+	const std::unique_ptr<std::byte[]> dst { new std::byte[bufferSize] };
+	for (const uint8_t levelNum : levels) {
+		const DLevel &deltaLevel = DeltaLevels.find(levelNum)->second;
 		std::byte *dstEnd = &dst.get()[1];
 		*dstEnd = static_cast<std::byte>(levelNum);
 		dstEnd += sizeof(uint8_t);
@@ -2794,11 +2863,11 @@ void DeltaExportData(uint8_t pnum)
 		multi_send_zero_packet(pnum, CMD_DLEVEL, dst.get(), size);
 	}
 
-	std::byte dst[sizeof(DJunk) + 1];
-	std::byte *dstEnd = &dst[1];
-	dstEnd = DeltaExportJunk(dstEnd);
-	const uint32_t size = CompressData(dst, dstEnd);
-	multi_send_zero_packet(pnum, CMD_DLEVEL_JUNK, dst, size);
+	std::byte junk[sizeof(DJunk) + 1];
+	std::byte *junkEnd = &junk[1];
+	junkEnd = DeltaExportJunk(junkEnd);
+	const uint32_t size = CompressData(junk, junkEnd);
+	multi_send_zero_packet(pnum, CMD_DLEVEL_JUNK, junk, size);
 
 	std::byte src[1] = { static_cast<std::byte>(0) };
 	multi_send_zero_packet(pnum, CMD_DLEVEL_END, src, 1);
@@ -2811,6 +2880,55 @@ void delta_init()
 	LocalLevels.clear();
 }
 
+uint64_t ComputeDeltaHash()
+{
+	StateHasher hasher;
+	for (const DPortal &portal : sgJunk.portal) {
+		hasher.add(Point { portal.x, portal.y });
+		hasher.add(portal.level);
+		hasher.add(portal.ltype);
+		hasher.add(portal.setlvl);
+	}
+
+	for (size_t level = 0; level < MaxMultiplayerLevels; level++) {
+		auto it = DeltaLevels.find(static_cast<uint8_t>(level));
+		if (it == DeltaLevels.end())
+			continue;
+		const DLevel &deltaLevel = it->second;
+
+		// Which slot or map entry a change ends up in depends on the order the commands arrived in, so the entries are summed
+		uint64_t entries = 0;
+		for (const TCmdPItem &item : deltaLevel.item) {
+			if (item.bCmd == CMD_INVALID)
+				continue;
+			StateHasher entry;
+			entry.add(item.bCmd);
+			entry.add(Point { item.x, item.y });
+			entry.add(Swap16LE(static_cast<uint16_t>(item.def.wIndx)));
+			entry.add(Swap16LE(item.def.wCI));
+			entry.add(Swap32LE(item.def.dwSeed));
+			entries += entry.value();
+		}
+		for (const auto &[position, object] : deltaLevel.object) {
+			StateHasher entry;
+			entry.add(Point(position));
+			entry.add(object.bCmd);
+			entries += entry.value();
+		}
+		for (const auto &[monsterId, monster] : deltaLevel.spawnedMonsters) {
+			StateHasher entry;
+			entry.add(monsterId);
+			entry.add(monster.typeIndex);
+			entry.add(monster.seed);
+			entries += entry.value();
+		}
+
+		hasher.add(level);
+		hasher.add(entries);
+	}
+	return hasher.value();
+}
+
 void DeltaClearLevel(uint8_t level)
 {
 	DeltaLevels.erase(level);
@@ -3005,6 +3123,17 @@ void NetSendCmdSpawnMonster(Point position, Direction dir, uint16_t typeIndex, u
 	NetSendHiPri(MyPlayerId, reinterpret_cast<std::byte *>(&cmd), sizeof(cmd));
 }
 
+void NetSendCmdStateHash(uint32_t gameLoop, const StateHash &hash)
+{
+	TCmdStateHash cmd;
+
+	cmd.bCmd = CMD_STATEHASH;
+	cmd.gameLoop = Swap32LE(gameLoop);
+	for (size_t i = 0; i < NumStateHashClasses; i++)
+		cmd.hashes[i] = Swap64LE(hash.classes[i]);
+	NetSendHiPri(MyPlayerId, reinterpret_cast<std::byte *>(&cmd), sizeof(cmd));
+}
+
 void NetSendCmdLoc(uint8_t playerId, bool bHiPri, _cmd_id bCmd, Point position)
 {
 	if (playerId == MyPlayerId && WasPlayerCmdAlreadyRequested(bCmd, position))
@@ -3337,7 +3466,9 @@ bool ValidateCmdSize(size_t requiredCmdSize, size_t maxCmdSize, size_t playerId)
 	return false;
 }
 
-size_t ParseCmd(uint8_t pnum, const TCmd *pCmd, size_t maxCmdSize)
+namespace {
+
+size_t DispatchCmd(uint8_t pnum, const TCmd *pCmd, size_t maxCmdSize)
 {
 	sbLastCmd = pCmd->bCmd;
 	if (sgwPackPlrOffsetTbl[pnum] != 0 && sbLastCmd != CMD_ACK_PLRINFO && sbLastCmd != CMD_SEND_PLRINFO)
@@ -3497,6 +3628,8 @@ size_t ParseCmd(uint8_t pnum, const TCmd *pCmd, size_t maxCmdSize)
 		return OnOpenGrave(*pCmd);
 	case CMD_SPAWNMONSTER:
 		return HandleCmd(OnSpawnMonster, player, pCmd, maxCmdSize);
+	case CMD_STATEHASH:
+		return HandleCmd(OnStateHash, player, pCmd, maxCmdSize);
 	default:
 		break;
 	}
@@ -3510,4 +3643,30 @@ size_t ParseCmd(uint8_t pnum, const TCmd *pCmd, size_t maxCmdSize)
 	return HandleCmd(OnLevelData, player, pCmd, maxCmdSize);
 }
 
+} // namespace
+
+void CalcChangedPlayerEquipment()
+{
+	if (PlayersWithChangedEquipment.none())
+		return;
+	for (size_t i = 0; i < Players.size(); i++) {
+		if (PlayersWithChangedEquipment.test(i))
+			CalcPlrInv(Players[i], PlayersWithChangedEquipmentGfx.test(i));
+	}
+	PlayersWithChangedEquipment.reset();
+	PlayersWithChangedEquipmentGfx.reset();
+}
+
+size_t ParseCmd(uint8_t pnum, const TCmd *pCmd, size_t maxCmdSize)
+{
+	const _cmd_id cmd = pCmd->bCmd;
+	// Any other message could depend on the stats of the players whose equipment changed
+	if (!IsEquipmentChangeCmd(cmd))
+		CalcChangedPlayerEquipment();
+	const size_t size = DispatchCmd(pnum, pCmd, maxCmdSize);
+	if (size != 0)
+		NetStatsCountReceivedCmd(cmd, size);
+	return size;
+}
+
 } // namespace devilution
@@ -14,6 +14,7 @@
 #include "objects.h"
 #include "portal.h"
 #include "quests.h"
+#include "state_hash.hpp"
 
 namespace devilution {
 
@@ -424,6 +425,10 @@ enum _cmd_id : uint8_t {
 	//
 	// body (TFakeDropPlr)
 	FAKE_CMD_DROPID,
+	// Hash of the world state, compared with the local one to detect desyncs.
+	//
+	// body (TCmdStateHash)
+	CMD_STATEHASH,
 	NUM_CMDS,
 	CMD_INVALID = 0xFF,
 };
@@ -515,6 +520,12 @@ struct TCmdSpawnMonster {
 	uint8_t golemSpellLevel;
 };
 
+struct TCmdStateHash {
+	_cmd_id bCmd;
+	uint32_t gameLoop;
+	uint64_t hashes[NumStateHashClasses];
+};
+
 struct TCmdQuest {
 	_cmd_id bCmd;
 	int8_t q;
@@ -726,6 +737,10 @@ void run_delta_info();
 void DeltaExportData(uint8_t pnum);
 void DeltaSyncJunk();
 void delta_init();
+/**
+ * @brief Hashes the level deltas, leaving out the monster states that sync messages update at different times for each player.
+ */
+uint64_t ComputeDeltaHash();
 void DeltaClearLevel(uint8_t level);
 void delta_kill_monster(const Monster &monster, Point position, const Player &player);
 void delta_monster_hp(const Monster &monster, const Player &player);
@@ -740,6 +755,7 @@ void DeltaLoadLevel();
 void ClearLastSentPlayerCmd();
 void NetSendCmd(bool bHiPri, _cmd_id bCmd);
 void NetSendCmdSpawnMonster(Point position, Direction dir, uint16_t typeIndex, uint16_t monsterId, uint32_t seed, uint8_t golemOwnerPlayerId, uint8_t golemSpellLevel);
+void NetSendCmdStateHash(uint32_t gameLoop, const StateHash &hash);
 void NetSendCmdLoc(uint8_t playerId, bool bHiPri, _cmd_id bCmd, Point position);
 void NetSendCmdLocParam1(bool bHiPri, _cmd_id bCmd, Point position, uint16_t wParam1);
 void NetSendCmdLocParam2(bool bHiPri, _cmd_id bCmd, Point position, uint16_t wParam1, uint16_t wParam2);
@@ -763,4 +779,11 @@ void delta_close_portal(const Player &player);
 bool ValidateCmdSize(size_t requiredCmdSize, size_t maxCmdSize, size_t playerId);
 size_t ParseCmd(uint8_t pnum, const TCmd *pCmd, size_t maxCmdSize);
 
+/**
+ * @brief Calculates the stats of the remote players whose equipment changed, must be called once the received messages are handled.
+ *
+ * Consecutive equipment changes of remote players are only calculated once, when a message that isn't an equipment change arrives or the messages run out.
+ */
+void CalcChangedPlayerEquipment();
+
 } // namespace devilution
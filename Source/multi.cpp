@@ -31,6 +31,7 @@
 #include "menu.h"
 #include "monster.h"
 #include "msg.h"
+#include "net_stats.hpp"
 #include "nthread.h"
 #include "options.h"
 #include "pfile.h"
@@ -38,6 +39,7 @@
 #include "players/validation.hpp"
 #include "plrmsg.h"
 #include "qol/chatlog.h"
+#include "state_hash.hpp"
 #include "storm/storm_net.hpp"
 #include "sync.h"
 #include "tmsg.h"
@@ -609,6 +611,7 @@ void InitGameInfo()
 	sgGameInitInfo.versionMajor = PROJECT_VERSION_MAJOR;
 	sgGameInitInfo.versionMinor = PROJECT_VERSION_MINOR;
 	sgGameInitInfo.versionPatch = PROJECT_VERSION_PATCH;
+	sgGameInitInfo.protocolVersion = NetProtocolVersion;
 	const Options &options = GetOptions();
 	sgGameInitInfo.nTickRate = *options.Gameplay.tickRate;
 	sgGameInitInfo.bRunInTown = *options.Gameplay.runInTown ? 1 : 0;
@@ -621,6 +624,7 @@ void InitGameInfo()
 void NetSendLoPri(uint8_t playerId, const std::byte *data, size_t size)
 {
 	if (data != nullptr && size != 0) {
+		NetStatsCountSentCmd(static_cast<uint8_t>(data[0]), size);
 		CopyPacket(&lowPriorityBuffer, data, size);
 		SendPacket(playerId, data, size);
 	}
@@ -629,6 +633,7 @@ void NetSendLoPri(uint8_t playerId, const std::byte *data, size_t size)
 void NetSendHiPri(uint8_t playerId, const std::byte *data, size_t size)
 {
 	if (data != nullptr && size != 0) {
+		NetStatsCountSentCmd(static_cast<uint8_t>(data[0]), size);
 		CopyPacket(&highPriorityBuffer, data, size);
 		SendPacket(playerId, data, size);
 	}
@@ -774,6 +779,7 @@ void ProcessGameMessagePackets()
 
 		HandleAllPackets(playerId, message, messageSize);
 	}
+	CalcChangedPlayerEquipment();
 	CheckPlayerInfoTimeouts();
 }
 
@@ -862,6 +868,7 @@ bool NetInit(bool bSinglePlayer)
 		nthread_start(sgbPlayerTurnBitTbl[MyPlayerId]);
 		tmsg_start();
 		sgdwGameLoops = 0;
+		ResetStateHashes();
 		sgbSentThisCycle = 0;
 		gbDeltaSender = MyPlayerId;
 		gbSomebodyWonGameKludge = false;
@@ -23,9 +23,18 @@ struct Player;
 // must be unsigned to generate unsigned comparisons with pnum
 #define MAX_PLRS 4
 
+/**
+ * @brief Version of the network commands, only games of the same version can be joined.
+ *
+ * Version 1 adds CMD_STATEHASH.
+ */
+constexpr uint8_t NetProtocolVersion = 1;
+
 struct GameData {
 	int32_t size;
-	uint8_t reserved[4];
+	/** The `NetProtocolVersion` of the host, 0 for builds from before it was introduced */
+	uint8_t protocolVersion;
+	uint8_t reserved[3];
 	uint32_t programid;
 	uint8_t versionMajor;
 	uint8_t versionMinor;
@@ -53,6 +62,8 @@ struct GameInfo {
 };
 
 extern bool gbSomebodyWonGameKludge;
+/** @brief Game loops since the start of the game, the same for all players. */
+extern uint32_t sgdwGameLoops;
 extern uint16_t sgwPackPlrOffsetTbl[MAX_PLRS];
 extern uint8_t gbActivePlayers;
 extern bool gbGameDestroyed;
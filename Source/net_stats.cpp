@@ -0,0 +1,276 @@
+/**
+ * @file net_stats.cpp
+ *
+ * Implementation of the network traffic counters.
+ */
+#include "net_stats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <string_view>
+
+#ifdef USE_SDL3
+#include <SDL3/SDL_timer.h>
+#else
+#include <SDL.h>
+#endif
+
+#include <fmt/format.h>
+#include <magic_enum/magic_enum.hpp>
+
+#include "msg.h"
+#include "multi.h"
+#include "storm/storm_net.hpp"
+#include "utils/logged_fstream.hpp"
+#include "utils/paths.h"
+#include "utils/sdl_mutex.h"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+
+namespace {
+
+/** @brief Index of the broadcast counters in `NetTraffic::sentToPeer`. */
+constexpr size_t BroadcastIndex = MAX_PLRS;
+constexpr uint32_t WindowMs = 1000;
+/** @brief Number of commands listed per direction in the report. */
+constexpr size_t ReportedCmds = 8;
+
+struct TrafficCounter {
+	uint32_t messages = 0;
+	uint64_t bytes = 0;
+
+	void Add(size_t size)
+	{
+		messages++;
+		bytes += size;
+	}
+
+	TrafficCounter &operator+=(const TrafficCounter &other)
+	{
+		messages += other.messages;
+		bytes += other.bytes;
+		return *this;
+	}
+};
+
+struct NetTraffic {
+	std::array<TrafficCounter, 256> sentCmds;
+	std::array<TrafficCounter, 256> receivedCmds;
+	std::array<TrafficCounter, MAX_PLRS + 1> sentToPeer;
+	std::array<TrafficCounter, MAX_PLRS> receivedFromPeer;
+	size_t maxQueueDepth = 0;
+	uint32_t turnWaitMs = 0;
+	uint32_t turnWaits = 0;
+
+	void Accumulate(const NetTraffic &other)
+	{
+		for (size_t i = 0; i < sentCmds.size(); i++) {
+			sentCmds[i] += other.sentCmds[i];
+			receivedCmds[i] += other.receivedCmds[i];
+		}
+		for (size_t i = 0; i < sentToPeer.size(); i++)
+			sentToPeer[i] += other.sentToPeer[i];
+		for (size_t i = 0; i < receivedFromPeer.size(); i++)
+			receivedFromPeer[i] += other.receivedFromPeer[i];
+		maxQueueDepth = std::max(maxQueueDepth, other.maxQueueDepth);
+		turnWaitMs += other.turnWaitMs;
+		turnWaits += other.turnWaits;
+	}
+};
+
+std::atomic<bool> Enabled;
+/** @brief Guards everything below, the counters are updated from both the game and the network thread. */
+SdlMutex StatsMutex;
+NetTraffic Current;
+NetTraffic LastSecond;
+NetTraffic Total;
+uint32_t WindowStart;
+uint32_t SecondsCounted;
+LoggedFStream CsvLog;
+
+std::string_view CmdName(size_t cmd)
+{
+	const std::string_view name = magic_enum::enum_name(static_cast<_cmd_id>(cmd));
+	return name.empty() ? "unknown" : name;
+}
+
+void WriteCsvHeader()
+{
+	std::string header = "second,sent_bytes,received_bytes,max_queue_depth,turn_wait_ms";
+	for (size_t i = 0; i < MAX_PLRS; i++)
+		StrAppend(header, ",sent_to_", i, ",received_from_", i);
+	StrAppend(header, ",sent_broadcast\n");
+	CsvLog.Write(header.data(), header.size());
+}
+
+template <size_t N>
+uint64_t SumBytes(const std::array<TrafficCounter, N> &counters)
+{
+	return std::accumulate(counters.begin(), counters.end(), uint64_t { 0 },
+	    [](uint64_t sum, const TrafficCounter &counter) { return sum + counter.bytes; });
+}
+
+void WriteCsvLine(const NetTraffic &traffic)
+{
+	std::string line = fmt::format("{},{},{},{},{}", SecondsCounted, SumBytes(traffic.sentToPeer), SumBytes(traffic.receivedFromPeer),
+	    traffic.maxQueueDepth, traffic.turnWaitMs);
+	for (size_t i = 0; i < MAX_PLRS; i++)
+		StrAppend(line, ",", traffic.sentToPeer[i].bytes, ",", traffic.receivedFromPeer[i].bytes);
+	StrAppend(line, ",", traffic.sentToPeer[BroadcastIndex].bytes, "\n");
+	CsvLog.Write(line.data(), line.size());
+}
+
+/**
+ * @brief Moves the counters of the current window to `LastSecond` once a second has passed.
+ */
+void RollWindow(uint32_t now)
+{
+	if (now - WindowStart < WindowMs)
+		return;
+	SecondsCounted++;
+	if (CsvLog.IsOpen())
+		WriteCsvLine(Current);
+	Total.Accumulate(Current);
+	LastSecond = Current;
+	Current = {};
+	// Restart the window at the current time, an idle stretch shows up as a single empty second
+	WindowStart = now;
+}
+
+template <typename Fn>
+void Count(Fn &&fn)
+{
+	if (!Enabled.load(std::memory_order_relaxed))
+		return;
+	const std::lock_guard<SdlMutex> lock(StatsMutex);
+	RollWindow(SDL_GetTicks());
+	fn(Current);
+}
+
+void AppendTopCmds(std::string &out, std::string_view title, const std::array<TrafficCounter, 256> &counters)
+{
+	std::array<uint8_t, 256> order;
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](uint8_t a, uint8_t b) { return counters[a].bytes > counters[b].bytes; });
+	StrAppend(out, title, ":");
+	for (size_t i = 0; i < ReportedCmds && counters[order[i]].messages != 0; i++) {
+		const TrafficCounter &counter = counters[order[i]];
+		StrAppend(out, "\n  ", CmdName(order[i]), ": ", counter.messages, " msgs, ", counter.bytes, " B");
+	}
+}
+
+void AppendTraffic(std::string &out, const NetTraffic &traffic)
+{
+	AppendTopCmds(out, "Sent commands", traffic.sentCmds);
+	StrAppend(out, "\n");
+	AppendTopCmds(out, "Received commands", traffic.receivedCmds);
+	StrAppend(out, "\nPeers:");
+	for (size_t i = 0; i < MAX_PLRS; i++) {
+		const TrafficCounter &sent = traffic.sentToPeer[i];
+		const TrafficCounter &received = traffic.receivedFromPeer[i];
+		if (sent.messages == 0 && received.messages == 0)
+			continue;
+		StrAppend(out, "\n  ", i, ": sent ", sent.bytes, " B, received ", received.bytes, " B");
+	}
+	StrAppend(out, "\n  broadcast: ", traffic.sentToPeer[BroadcastIndex].bytes, " B");
+	StrAppend(out, "\nMax queue depth: ", traffic.maxQueueDepth,
+	    "\nTurn wait: ", traffic.turnWaitMs, " ms in ", traffic.turnWaits, " waits");
+}
+
+} // namespace
+
+bool IsNetStatsEnabled()
+{
+	return Enabled;
+}
+
+void SetNetStatsEnabled(bool enabled)
+{
+	const std::lock_guard<SdlMutex> lock(StatsMutex);
+	if (enabled && !Enabled) {
+		Current = {};
+		LastSecond = {};
+		Total = {};
+		SecondsCounted = 0;
+		WindowStart = SDL_GetTicks();
+	}
+	if (!enabled)
+		CsvLog.Close();
+	Enabled = enabled;
+}
+
+void NetStatsCountSentCmd(uint8_t cmd, size_t size)
+{
+	Count([&](NetTraffic &traffic) { traffic.sentCmds[cmd].Add(size); });
+}
+
+void NetStatsCountReceivedCmd(uint8_t cmd, size_t size)
+{
+	Count([&](NetTraffic &traffic) { traffic.receivedCmds[cmd].Add(size); });
+}
+
+void NetStatsCountSentMessage(uint8_t playerId, size_t size)
+{
+	Count([&](NetTraffic &traffic) {
+		traffic.sentToPeer[playerId == SNPLAYER_OTHERS ? BroadcastIndex : std::min<size_t>(playerId, BroadcastIndex)].Add(size);
+	});
+}
+
+void NetStatsCountReceivedMessage(uint8_t playerId, size_t size, size_t queueDepth)
+{
+	if (playerId >= MAX_PLRS)
+		return;
+	Count([&](NetTraffic &traffic) {
+		traffic.receivedFromPeer[playerId].Add(size);
+		traffic.maxQueueDepth = std::max(traffic.maxQueueDepth, queueDepth);
+	});
+}
+
+void NetStatsCountTurnWait(uint32_t milliseconds)
+{
+	Count([&](NetTraffic &traffic) {
+		traffic.turnWaitMs += milliseconds;
+		traffic.turnWaits++;
+	});
+}
+
+std::string NetStatsReport()
+{
+	if (!Enabled)
+		return "Network stats are off.";
+	const std::lock_guard<SdlMutex> lock(StatsMutex);
+	RollWindow(SDL_GetTicks());
+	std::string out = "Last second\n";
+	AppendTraffic(out, LastSecond);
+	NetTraffic total = Total;
+	total.Accumulate(Current);
+	StrAppend(out, "\n\nTotal over ", SecondsCounted, " s\n");
+	AppendTraffic(out, total);
+	return out;
+}
+
+bool SetNetStatsCsvLog(bool enabled)
+{
+	if (!enabled) {
+		const std::lock_guard<SdlMutex> lock(StatsMutex);
+		CsvLog.Close();
+		return true;
+	}
+	SetNetStatsEnabled(true);
+	const std::lock_guard<SdlMutex> lock(StatsMutex);
+	if (CsvLog.IsOpen())
+		return true;
+	const std::string path = paths::PrefPath() + "net_stats.csv";
+	if (!CsvLog.Open(path.c_str(), "wb"))
+		return false;
+	WriteCsvHeader();
+	return true;
+}
+
+} // namespace devilution
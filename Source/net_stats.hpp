@@ -0,0 +1,44 @@
+/**
+ * @file net_stats.hpp
+ *
+ * Interface of the network traffic counters.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace devilution {
+
+/**
+ * @brief Whether network traffic is being counted, counting is off by default.
+ */
+bool IsNetStatsEnabled();
+void SetNetStatsEnabled(bool enabled);
+
+/** @brief Counts a command queued for sending by this client. */
+void NetStatsCountSentCmd(uint8_t cmd, size_t size);
+/** @brief Counts a command parsed from a received message. */
+void NetStatsCountReceivedCmd(uint8_t cmd, size_t size);
+/** @brief Counts a message handed to the network provider, `playerId` may be `SNPLAYER_OTHERS`. */
+void NetStatsCountSentMessage(uint8_t playerId, size_t size);
+/** @brief Counts a message taken from the receive queue, `queueDepth` is the number of messages still queued after it. */
+void NetStatsCountReceivedMessage(uint8_t playerId, size_t size, size_t queueDepth);
+/** @brief Counts the time spent waiting for the turns of the other players. */
+void NetStatsCountTurnWait(uint32_t milliseconds);
+
+/**
+ * @brief Describes the traffic of the last full second and the totals since counting was enabled.
+ */
+std::string NetStatsReport();
+
+/**
+ * @brief Appends one line per second with the traffic of that second to `net_stats.csv` in the pref path.
+ *
+ * Enables counting when turned on.
+ * @return false if the file could not be opened.
+ */
+bool SetNetStatsCsvLog(bool enabled);
+
+} // namespace devilution
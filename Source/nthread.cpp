@@ -5,6 +5,8 @@
  */
 #include "nthread.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 
@@ -19,6 +21,7 @@
 #include "engine/demomode.h"
 #include "game_mode.hpp"
 #include "gmenu.h"
+#include "net_stats.hpp"
 #include "storm/storm_net.hpp"
 #include "utils/sdl_mutex.h"
 #include "utils/sdl_thread.h"
@@ -45,6 +48,90 @@ int8_t sgbPacketCountdown;
 bool sgbThreadIsRunning;
 SdlThread Thread;
 
+/** @brief Bounds of `gdwTurnsInTransit`, the turn queue drops turns that are more than 0x7F ahead. */
+constexpr uint32_t MinTurnsInTransit = 1;
+constexpr uint32_t MaxTurnsInTransit = 8;
+/** @brief How often the peer latencies are sampled. */
+constexpr uint32_t TurnPacingIntervalMs = 1000;
+/** @brief Number of samples in a row that must allow fewer turns in transit before lowering it. */
+constexpr int TurnPacingLowerAfter = 3;
+
+uint32_t sgdwLastTurnPacingUpdate;
+/** @brief Smoothed latency and jitter in 1/8 ms. */
+uint32_t sgdwSmoothedLatency;
+uint32_t sgdwSmoothedJitter;
+int sgnTurnPacingLowerCount;
+/** @brief When the turns of the other players were first found missing, 0 while not waiting. */
+uint32_t sgdwTurnWaitStart;
+std::atomic<uint32_t> sgdwPacingLatency;
+std::atomic<uint32_t> sgdwPacingJitter;
+std::atomic<uint32_t> sgdwPacingTurns;
+
+uint32_t GetTurnPeriodMs()
+{
+	return static_cast<uint32_t>(gnTickDelay) * sgbNetUpdateRate;
+}
+
+/**
+ * @brief Adjusts the number of turns sent ahead to the echo latency of the slowest peer.
+ *
+ * Only the local send-ahead changes, the turns themselves are the same, so peers don't need to agree on it.
+ * A peer whose turns arrive later than the turns in transit cover stalls everyone,
+ * while more turns than needed add input delay for nothing.
+ */
+void UpdateTurnPacing()
+{
+	const uint32_t now = SDL_GetTicks();
+	if (now - sgdwLastTurnPacingUpdate < TurnPacingIntervalMs)
+		return;
+	sgdwLastTurnPacingUpdate = now;
+
+	uint32_t latency = 0;
+	bool hasPeers = false;
+	for (size_t i = 0; i < Players.size(); i++) {
+		if (i == MyPlayerId || (player_state[i] & PS_CONNECTED) == 0)
+			continue;
+		hasPeers = true;
+		latency = std::max(latency, DvlNet_GetLatencies(static_cast<uint8_t>(i)).echoLatency);
+	}
+	if (!hasPeers)
+		return;
+
+	// The same smoothing as TCP's round trip time estimate (RFC 6298)
+	const uint32_t sample = latency * 8;
+	if (sgdwSmoothedLatency == 0) {
+		sgdwSmoothedLatency = sample;
+		sgdwSmoothedJitter = sample / 2;
+	} else {
+		const uint32_t deviation = sample > sgdwSmoothedLatency ? sample - sgdwSmoothedLatency : sgdwSmoothedLatency - sample;
+		sgdwSmoothedJitter = (sgdwSmoothedJitter * 3 + deviation) / 4;
+		sgdwSmoothedLatency = (sgdwSmoothedLatency * 7 + sample) / 8;
+	}
+	const uint32_t latencyMs = sgdwSmoothedLatency / 8;
+	const uint32_t jitterMs = sgdwSmoothedJitter / 8;
+
+	// A turn has to reach the peers within the turns sent ahead of it, one way takes about half the round trip.
+	const uint32_t turnPeriodMs = std::max<uint32_t>(GetTurnPeriodMs(), 1);
+	const uint32_t budgetMs = latencyMs / 2 + 2 * jitterMs;
+	const uint32_t wanted = std::clamp(1 + budgetMs / turnPeriodMs, MinTurnsInTransit, MaxTurnsInTransit);
+	if (wanted > gdwTurnsInTransit) {
+		gdwTurnsInTransit = wanted;
+		sgnTurnPacingLowerCount = 0;
+	} else if (wanted < gdwTurnsInTransit) {
+		// Lower slowly, a single quiet second shouldn't make the next spike stall the game.
+		if (++sgnTurnPacingLowerCount >= TurnPacingLowerAfter) {
+			gdwTurnsInTransit--;
+			sgnTurnPacingLowerCount = 0;
+		}
+	} else {
+		sgnTurnPacingLowerCount = 0;
+	}
+
+	sgdwPacingLatency = latencyMs;
+	sgdwPacingJitter = jitterMs;
+	sgdwPacingTurns = gdwTurnsInTransit;
+}
+
 void NthreadHandler()
 {
 	if (!nthread_should_run) {
@@ -57,6 +144,7 @@ void NthreadHandler()
 			MemCrit.unlock();
 			break;
 		}
+		UpdateTurnPacing();
 		nthread_send_and_recv_turn(0, 0);
 		int delta = gnTickDelay;
 		if (nthread_recv_turns())
@@ -120,11 +208,17 @@ bool nthread_recv_turns(bool *pfSendAsync)
 		return true;
 	}
 	if (!SNetReceiveTurns(MAX_PLRS, (char **)glpMsgTbl, gdwMsgLenTbl, &player_state[0])) {
+		if (sgdwTurnWaitStart == 0)
+			sgdwTurnWaitStart = std::max<uint32_t>(SDL_GetTicks(), 1);
 		sgbTicsOutOfSync = false;
 		sgbSyncCountdown = 1;
 		sgbPacketCountdown = 1;
 		return false;
 	}
+	if (sgdwTurnWaitStart != 0) {
+		NetStatsCountTurnWait(SDL_GetTicks() - sgdwTurnWaitStart);
+		sgdwTurnWaitStart = 0;
+	}
 	if (!sgbTicsOutOfSync) {
 		sgbTicsOutOfSync = true;
 		last_tick = SDL_GetTicks();
@@ -158,6 +252,14 @@ void nthread_start(bool setTurnUpperBit)
 	gdwTurnsInTransit = caps.defaultturnsintransit;
 	if (gdwTurnsInTransit == 0)
 		gdwTurnsInTransit = 1;
+	sgdwLastTurnPacingUpdate = SDL_GetTicks();
+	sgdwSmoothedLatency = 0;
+	sgdwSmoothedJitter = 0;
+	sgnTurnPacingLowerCount = 0;
+	sgdwTurnWaitStart = 0;
+	sgdwPacingLatency = 0;
+	sgdwPacingJitter = 0;
+	sgdwPacingTurns = gdwTurnsInTransit;
 	if (caps.defaultturnssec <= 20 && caps.defaultturnssec != 0)
 		sgbNetUpdateRate = 20 / caps.defaultturnssec;
 	else
@@ -199,6 +301,17 @@ void nthread_cleanup()
 	}
 }
 
+TurnPacing nthread_get_turn_pacing()
+{
+	const uint32_t turns = sgdwPacingTurns;
+	return TurnPacing {
+		.turnsInTransit = turns,
+		.delayMs = turns * GetTurnPeriodMs(),
+		.latencyMs = sgdwPacingLatency,
+		.jitterMs = sgdwPacingJitter,
+	};
+}
+
 void nthread_ignore_mutex(bool bStart)
 {
 	if (!Thread.joinable())
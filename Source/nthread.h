@@ -22,6 +22,20 @@ extern uint32_t gdwNormalMsgSize;
 extern DVL_API_FOR_TEST uint8_t ProgressToNextGameTick;
 extern int last_tick;
 
+/**
+ * @brief State of the adaptive turn pacing, see `nthread_get_turn_pacing`.
+ */
+struct TurnPacing {
+	/** @brief Number of turns sent ahead of the turn that is being waited for. */
+	uint32_t turnsInTransit;
+	/** @brief Time covered by the turns in transit in milliseconds. */
+	uint32_t delayMs;
+	/** @brief Smoothed round trip latency to the slowest peer in milliseconds. */
+	uint32_t latencyMs;
+	/** @brief Smoothed deviation of that latency in milliseconds. */
+	uint32_t jitterMs;
+};
+
 void nthread_terminate_game(const char *pszFcn);
 uint32_t nthread_send_and_recv_turn(uint32_t curTurn, int turnDelta);
 bool nthread_recv_turns(bool *pfSendAsync = nullptr);
@@ -30,6 +44,11 @@ void nthread_start(bool setTurnUpperBit);
 void nthread_cleanup();
 void nthread_ignore_mutex(bool bStart);
 
+/**
+ * @brief Returns the current turn pacing, safe to call from any thread.
+ */
+TurnPacing nthread_get_turn_pacing();
+
 /**
  * @brief Checks if it's time for the logic to advance
  * @return True if the engine should tick
@@ -3,11 +3,13 @@
  *
  * Implementation of object functionality, interaction, spawning, loading, etc.
  */
+#include <bitset>
 #include <climits>
 #include <cmath>
 #include <cstdint>
 #include <ctime>
 #include <string>
+#include <tuple>
 
 #include <algorithm>
 
@@ -38,6 +40,7 @@
 #include "minitext.h"
 #include "missiles.h"
 #include "monster.h"
+#include "monsters/player_flow_field.hpp"
 #include "options.h"
 #include "qol/stash.h"
 #include "stores.h"
@@ -116,6 +119,14 @@ object_graphic_id ObjFileList[40];
 int leverid;
 int numobjfiles;
 
+/**
+ * @brief Objects that ProcessObjects() still has to visit.
+ *
+ * Passive objects only run their own animation, once a tick leaves them unchanged they are
+ * skipped until the next operation on any object, see WakeObjects().
+ */
+std::bitset<MAXOBJECTS> TickingObjects;
+
 /** Specifies the X-coordinate delta between barrels. */
 int bxadd[8] = { -1, 0, 1, -1, 1, -1, 0, 1 };
 /** Specifies the Y-coordinate delta between barrels. */
@@ -332,6 +343,7 @@ void ClrAllObjects()
 		AvailableObjects[i] = i;
 	}
 	memset(ActiveObjects, 0, sizeof(ActiveObjects));
+	TickingObjects.set();
 	trapdir = 0;
 	trapid = 1;
 	leverid = 1;
@@ -560,9 +572,9 @@ void LoadMapObjects(const char *path, Point start, WorldTileRectangle mapRange =
 {
 	LoadingMapObjects = true;
 
-	auto dunData = LoadFileInMem<uint16_t>(path);
+	const uint16_t *dunData = LoadFileInArena<uint16_t>(path, LevelArena);
 
-	WorldTileSize size = GetDunSize(dunData.get());
+	WorldTileSize size = GetDunSize(dunData);
 
 	const int layer2Offset = 2 + (size.width * size.height);
 
@@ -677,6 +689,15 @@ void AddCryptObject(Object &object, int a2)
 	object._oVar4 = object._oAnimFrame + 1;
 }
 
+/**
+ * @brief Drops the caches of walking distances and lines of sight after tiles or objects changed how they block movement or missiles.
+ */
+void InvalidateTileCaches()
+{
+	InvalidatePlayerFlowFields();
+	InvalidateLineOfSightCache();
+}
+
 void SetupObject(Object &object, Point position, _object_id ot)
 {
 	const ObjectData &objectData = AllObjects[ot];
@@ -714,6 +735,7 @@ void SetupObject(Object &object, Point position, _object_id ot)
 	object._oAnimWidth = objectData.animWidth;
 	object._oSolidFlag = objectData.isSolid() ? 1 : 0;
 	object._oMissFlag = objectData.missilesPassThrough() ? 1 : 0;
+	InvalidateTileCaches();
 	object.applyLighting = objectData.applyLighting();
 	object._oDelFlag = false;
 	object._oBreak = objectData.isBreakable() ? 1 : 0;
@@ -721,6 +743,7 @@ void SetupObject(Object &object, Point position, _object_id ot)
 	object._oPreFlag = false;
 	object._oTrapFlag = false;
 	object._oDoorFlag = false;
+	TickingObjects.set(object.GetId());
 }
 
 void AddCryptBook(_object_id ot, int v2, Point position)
@@ -904,6 +927,7 @@ void DeleteObject(int oi, int i)
 	const Object &object = Objects[oi];
 	const Point position = object.position;
 	dObject[position.x][position.y] = 0;
+	InvalidateTileCaches();
 	AvailableObjects[-ActiveObjectCount + MAXOBJECTS] = oi;
 	ActiveObjectCount--;
 	if (ObjectUnderCursor == &object) // Unselect object if this was highlighted by player
@@ -951,6 +975,7 @@ void AddChest(Object &chest)
 void ObjSetMicro(Point position, int pn)
 {
 	dPiece[position.x][position.y] = pn;
+	InvalidateTileCaches();
 }
 
 void DoorSet(Point position, bool isLeftDoor)
@@ -1055,6 +1080,7 @@ void SetDoorStateOpen(Object &door)
 	door._oVar4 = DOOR_OPEN;
 	door._oPreFlag = true;
 	door._oMissFlag = true;
+	InvalidateTileCaches();
 	door.selectionRegion = SelectionRegion::Middle;
 
 	switch (door._otype) {
@@ -1103,6 +1129,7 @@ void SetDoorStateClosed(Object &door)
 	door._oVar4 = DOOR_CLOSED;
 	door._oPreFlag = false;
 	door._oMissFlag = false;
+	InvalidateTileCaches();
 	door.selectionRegion = SelectionRegion::Bottom | SelectionRegion::Middle;
 
 	switch (door._otype) {
@@ -3444,6 +3471,7 @@ void BreakCrux(Object &crux, bool sendmsg)
 	crux._oAnimFrame = 1;
 	crux._oAnimDelay = 1;
 	crux._oSolidFlag = true;
+	InvalidateTileCaches();
 	crux._oMissFlag = true;
 	crux._oBreak = -1;
 	crux.selectionRegion = SelectionRegion::None;
@@ -3470,6 +3498,7 @@ void BreakBarrel(const Player &player, Object &barrel, bool forcebreak, bool sen
 	barrel._oAnimFrame = 1;
 	barrel._oAnimDelay = 1;
 	barrel._oSolidFlag = false;
+	InvalidateTileCaches();
 	barrel._oMissFlag = true;
 	barrel._oBreak = -1;
 	barrel.selectionRegion = SelectionRegion::None;
@@ -3617,6 +3646,99 @@ void UpdateState(Object &object, int frame)
 	object._oAnimFlag = false;
 }
 
+/**
+ * @brief Runs the per-tick behaviour of an object that comes on top of its animation.
+ * @return false if the object is passive, i.e. its behaviour only depends on its own animation
+ */
+bool UpdateObject(Object &object)
+{
+	switch (object._otype) {
+	case OBJ_L1LIGHT:
+	case OBJ_SKFIRE:
+	case OBJ_CANDLE1:
+	case OBJ_CANDLE2:
+	case OBJ_BOOKCANDLE:
+		UpdateObjectLight(object, 5);
+		return true;
+	case OBJ_STORYCANDLE:
+	case OBJ_L5CANDLE:
+		UpdateObjectLight(object, 3);
+		return true;
+	case OBJ_CRUX1:
+	case OBJ_CRUX2:
+	case OBJ_CRUX3:
+	case OBJ_BARREL:
+	case OBJ_BARRELEX:
+	case OBJ_POD:
+	case OBJ_PODEX:
+	case OBJ_URN:
+	case OBJ_URNEX:
+	case OBJ_SHRINEL:
+	case OBJ_SHRINER:
+		ObjectStopAnim(object);
+		return false;
+	case OBJ_L1LDOOR:
+	case OBJ_L1RDOOR:
+	case OBJ_L2LDOOR:
+	case OBJ_L2RDOOR:
+	case OBJ_L3LDOOR:
+	case OBJ_L3RDOOR:
+	case OBJ_L5LDOOR:
+	case OBJ_L5RDOOR:
+		UpdateDoor(object);
+		return true;
+	case OBJ_TORCHL:
+	case OBJ_TORCHR:
+	case OBJ_TORCHL2:
+	case OBJ_TORCHR2:
+		UpdateObjectLight(object, 8);
+		return true;
+	case OBJ_SARC:
+	case OBJ_L5SARC:
+		UpdateSarcophagus(object);
+		return false;
+	case OBJ_FLAMEHOLE:
+		UpdateFlameTrap(object);
+		return true;
+	case OBJ_TRAPL:
+	case OBJ_TRAPR:
+		OperateTrap(object);
+		return true;
+	case OBJ_MCIRCLE1:
+	case OBJ_MCIRCLE2:
+		UpdateCircle(object);
+		return true;
+	case OBJ_BCROSS:
+	case OBJ_TBCROSS:
+		UpdateObjectLight(object, 5);
+		UpdateBurningCrossDamage(object);
+		return true;
+	default:
+		return false;
+	}
+}
+
+auto GetAnimationState(const Object &object)
+{
+	return std::tuple(object._oAnimFlag, object._oAnimDelay, object._oAnimCnt, object._oAnimLen, object._oAnimFrame);
+}
+
+void UpdateObjectAnimation(Object &object)
+{
+	if (!object._oAnimFlag)
+		return;
+
+	object._oAnimCnt++;
+
+	if (object._oAnimCnt < object._oAnimDelay)
+		return;
+
+	object._oAnimCnt = 0;
+	object._oAnimFrame++;
+	if (object._oAnimFrame > object._oAnimLen)
+		object._oAnimFrame = 1;
+}
+
 } // namespace
 
 unsigned int Object::GetId() const
@@ -4194,86 +4316,25 @@ void OperateTrap(Object &trap)
 	PlaySfxLoc(SfxID::TriggerTrap, triggerPosition);
 }
 
+void WakeObjects()
+{
+	TickingObjects.set();
+}
+
 void ProcessObjects()
 {
 	for (int i = 0; i < ActiveObjectCount; ++i) {
-		Object &object = Objects[ActiveObjects[i]];
-		switch (object._otype) {
-		case OBJ_L1LIGHT:
-		case OBJ_SKFIRE:
-		case OBJ_CANDLE1:
-		case OBJ_CANDLE2:
-		case OBJ_BOOKCANDLE:
-			UpdateObjectLight(object, 5);
-			break;
-		case OBJ_STORYCANDLE:
-		case OBJ_L5CANDLE:
-			UpdateObjectLight(object, 3);
-			break;
-		case OBJ_CRUX1:
-		case OBJ_CRUX2:
-		case OBJ_CRUX3:
-		case OBJ_BARREL:
-		case OBJ_BARRELEX:
-		case OBJ_POD:
-		case OBJ_PODEX:
-		case OBJ_URN:
-		case OBJ_URNEX:
-		case OBJ_SHRINEL:
-		case OBJ_SHRINER:
-			ObjectStopAnim(object);
-			break;
-		case OBJ_L1LDOOR:
-		case OBJ_L1RDOOR:
-		case OBJ_L2LDOOR:
-		case OBJ_L2RDOOR:
-		case OBJ_L3LDOOR:
-		case OBJ_L3RDOOR:
-		case OBJ_L5LDOOR:
-		case OBJ_L5RDOOR:
-			UpdateDoor(object);
-			break;
-		case OBJ_TORCHL:
-		case OBJ_TORCHR:
-		case OBJ_TORCHL2:
-		case OBJ_TORCHR2:
-			UpdateObjectLight(object, 8);
-			break;
-		case OBJ_SARC:
-		case OBJ_L5SARC:
-			UpdateSarcophagus(object);
-			break;
-		case OBJ_FLAMEHOLE:
-			UpdateFlameTrap(object);
-			break;
-		case OBJ_TRAPL:
-		case OBJ_TRAPR:
-			OperateTrap(object);
-			break;
-		case OBJ_MCIRCLE1:
-		case OBJ_MCIRCLE2:
-			UpdateCircle(object);
-			break;
-		case OBJ_BCROSS:
-		case OBJ_TBCROSS:
-			UpdateObjectLight(object, 5);
-			UpdateBurningCrossDamage(object);
-			break;
-		default:
-			break;
-		}
-		if (!object._oAnimFlag)
-			continue;
-
-		object._oAnimCnt++;
-
-		if (object._oAnimCnt < object._oAnimDelay)
+		const int oi = ActiveObjects[i];
+		if (!TickingObjects.test(oi))
 			continue;
 
-		object._oAnimCnt = 0;
-		object._oAnimFrame++;
-		if (object._oAnimFrame > object._oAnimLen)
-			object._oAnimFrame = 1;
+		Object &object = Objects[oi];
+		const auto previousState = GetAnimationState(object);
+		const bool isActive = UpdateObject(object);
+		UpdateObjectAnimation(object);
+		// Ticking a passive object again would leave it unchanged as well
+		if (!isActive && GetAnimationState(object) == previousState)
+			TickingObjects.reset(oi);
 	}
 
 	for (int i = 0; i < ActiveObjectCount;) {
@@ -4313,6 +4374,7 @@ void MonstCheckDoors(const Monster &monster)
 
 void ObjChangeMap(int x1, int y1, int x2, int y2)
 {
+	WakeObjects();
 	for (int j = y1; j <= y2; j++) {
 		for (int i = x1; i <= x2; i++) {
 			ObjSetMini({ i, j }, pdungeon[i][j]);
@@ -4343,6 +4405,7 @@ void ObjChangeMap(int x1, int y1, int x2, int y2)
 
 void ObjChangeMapResync(int x1, int y1, int x2, int y2)
 {
+	WakeObjects();
 	for (int j = y1; j <= y2; j++) {
 		for (int i = x1; i <= x2; i++) {
 			ObjSetMini({ i, j }, pdungeon[i][j]);
@@ -4375,6 +4438,8 @@ _item_indexes ItemMiscIdIdx(item_misc_id imiscid)
 
 void OperateObject(Player &player, Object &object)
 {
+	WakeObjects();
+
 	const bool sendmsg = &player == MyPlayer;
 
 	switch (object._otype) {
@@ -4486,6 +4551,7 @@ void OperateObject(Player &player, Object &object)
 
 void DeltaSyncOpObject(Object &object)
 {
+	WakeObjects();
 	switch (object._otype) {
 	case OBJ_L1LDOOR:
 	case OBJ_L1RDOOR:
@@ -4571,6 +4637,8 @@ void DeltaSyncOpObject(Object &object)
 
 void DeltaSyncCloseObj(Object &object)
 {
+	WakeObjects();
+
 	// Object was closed.
 	// That means it was opened once, so all traps have been activated.
 	object._oTrapFlag = false;
@@ -4578,6 +4646,8 @@ void DeltaSyncCloseObj(Object &object)
 
 void SyncOpObject(Player &player, int cmd, Object &object)
 {
+	WakeObjects();
+
 	const bool sendmsg = &player == MyPlayer;
 
 	switch (object._otype) {
@@ -4688,11 +4758,13 @@ void SyncOpObject(Player &player, int cmd, Object &object)
 
 void BreakObjectMissile(Object &object)
 {
+	WakeObjects();
 	if (object.IsCrux())
 		BreakCrux(object, true);
 }
 void BreakObject(const Player &player, Object &object)
 {
+	WakeObjects();
 	if (object.IsBarrel()) {
 		BreakBarrel(player, object, false, true);
 	} else if (object.IsCrux()) {
@@ -4702,6 +4774,7 @@ void BreakObject(const Player &player, Object &object)
 
 void DeltaSyncBreakObj(Object &object)
 {
+	WakeObjects();
 	if (!object.IsBreakable() || !object.canInteractWith())
 		return;
 
@@ -4711,6 +4784,7 @@ void DeltaSyncBreakObj(Object &object)
 	object._oPreFlag = true;
 	object._oAnimFlag = false;
 	object._oAnimFrame = object._oAnimLen;
+	InvalidateTileCaches();
 
 	if (object.IsBarrel()) {
 		object._oSolidFlag = false;
@@ -4721,6 +4795,7 @@ void DeltaSyncBreakObj(Object &object)
 
 void SyncBreakObj(const Player &player, Object &object)
 {
+	WakeObjects();
 	if (object.IsBarrel()) {
 		BreakBarrel(player, object, true, false);
 	} else if (object.IsCrux()) {
@@ -4730,6 +4805,7 @@ void SyncBreakObj(const Player &player, Object &object)
 
 void SyncObjectAnim(Object &object)
 {
+	WakeObjects();
 	object_graphic_id index = AllObjects[object._otype].ofindex;
 
 	if (!HeadlessMode) {
@@ -4918,10 +4994,12 @@ void GetObjectStr(const Object &object)
 
 void SyncNakrulRoom()
 {
+	WakeObjects();
 	dPiece[UberRow][UberCol] = 297;
 	dPiece[UberRow][UberCol - 1] = 300;
 	dPiece[UberRow][UberCol - 2] = 299;
 	dPiece[UberRow][UberCol + 1] = 298;
+	InvalidateTileCaches();
 }
 
 } // namespace devilution
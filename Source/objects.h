@@ -345,6 +345,13 @@ void SetMapObjects(const uint16_t *dunData, int startx, int starty);
 Object *AddObject(_object_id objType, Point objPos);
 bool UpdateTrapState(Object &trap);
 void OperateTrap(Object &trap);
+/**
+ * @brief Makes ProcessObjects() visit all objects again on the next tick.
+ *
+ * Has to be called after changing the state of objects outside of the object functions,
+ * passive objects like barrels and chests are skipped otherwise once their animation has finished.
+ */
+void WakeObjects();
 void ProcessObjects();
 void RedoPlayerVision();
 void MonstCheckDoors(const Monster &monster);
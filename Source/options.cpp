@@ -170,16 +170,22 @@ void SaveIni()
 		RecursivelyCreateDir(paths::ConfigPath().c_str());
 	}
 	const std::string iniPath = GetIniPath();
+	// Written next to the ini and then moved over it, so that a failed write doesn't leave a truncated ini behind
+	const std::string tempPath = StrCat(iniPath, ".tmp");
 	LoggedFStream out;
-	if (!out.Open(iniPath.c_str(), "wb")) {
-		LogError("Failed to open ini file for writing at {}: {}", iniPath, std::strerror(errno));
+	if (!out.Open(tempPath.c_str(), "wb")) {
+		LogError("Failed to open ini file for writing at {}: {}", tempPath, std::strerror(errno));
 		return;
 	}
 	const std::string newContents = ini->serialize();
-	if (out.Write(newContents.data(), newContents.size())) {
-		ini->markAsUnchanged();
-	}
+	const bool written = out.Write(newContents.data(), newContents.size());
 	out.Close();
+	if (!written) {
+		RemoveFile(tempPath.c_str());
+		return;
+	}
+	RenameFile(tempPath.c_str(), iniPath.c_str());
+	ini->markAsUnchanged();
 }
 
 #if SDL_VERSION_ATLEAST(2, 0, 0)
@@ -797,6 +803,9 @@ GraphicsOptions::GraphicsOptions()
     , hardwareCursorMaxSize("Hardware Cursor Maximum Size", OptionEntryFlags::CantChangeInGame | OptionEntryFlags::RecreateUI | (HardwareCursorSupported() ? OptionEntryFlags::None : OptionEntryFlags::Invisible), N_("Hardware Cursor Maximum Size"), N_("Maximum width / height for the hardware cursor. Larger cursors fall back to software."), 128, { 0, 64, 128, 256, 512 })
 #endif
     , showFPS("Show FPS", OptionEntryFlags::None, N_("Show FPS"), N_("Displays the FPS in the upper left corner of the screen."), false)
+    , incrementalRedraw("Incremental Redraw", OptionEntryFlags::None, N_("Incremental Redraw"), N_("Only redraws the parts of the game world that changed since the previous frame. Has no effect while zoomed."), false)
+    , renderThreads("Render Threads", OptionEntryFlags::None, N_("Render Threads"), N_("Renders the game world in horizontal bands on this many threads."), 1, { 1, 2, 3, 4, 6, 8 })
+    , floorCache("Floor Cache", OptionEntryFlags::None, N_("Floor Cache"), N_("Keeps the rendered floor between frames and only redraws the tiles whose lighting changed."), false)
 {
 }
 std::vector<OptionEntryBase *> GraphicsOptions::GetEntries()
@@ -819,6 +828,9 @@ std::vector<OptionEntryBase *> GraphicsOptions::GetEntries()
 		&brightness,
 		&zoom,
 		&showFPS,
+		&incrementalRedraw,
+		&renderThreads,
+		&floorCache,
 		&perPixelLighting,
 		&colorCycling,
 		&alternateNestArt,
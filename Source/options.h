@@ -553,6 +553,12 @@ struct GraphicsOptions : OptionCategoryBase {
 #endif
 	/** @brief Show FPS, even without the -f command line flag. */
 	OptionEntryBoolean showFPS;
+	/** @brief Only redraw the parts of the game world that changed since the previous frame. */
+	OptionEntryBoolean incrementalRedraw;
+	/** @brief Number of threads the game world is rendered on, split into horizontal bands. */
+	OptionEntryInt<int> renderThreads;
+	/** @brief Keep the rendered floor tiles between frames. */
+	OptionEntryBoolean floorCache;
 };
 
 struct GameplayOptions : OptionCategoryBase {
@@ -1,5 +1,6 @@
 #include "panels/spell_book.hpp"
 
+#include <array>
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -15,6 +16,7 @@
 #include "engine/rectangle.hpp"
 #include "engine/render/clx_render.hpp"
 #include "engine/render/text_render.hpp"
+#include "engine/surface.hpp"
 #include "game_mode.hpp"
 #include "missiles.h"
 #include "panels/spell_icons.hpp"
@@ -22,7 +24,9 @@
 #include "player.h"
 #include "tables/spelldat.h"
 #include "utils/language.h"
+#include "utils/sdl_compat.h"
 #include "utils/status_macros.hpp"
+#include "utils/surface_to_clx.hpp"
 
 namespace devilution {
 
@@ -30,6 +34,8 @@ namespace {
 
 OptionalOwnedClxSpriteList spellBookButtons;
 OptionalOwnedClxSpriteList spellBookBackground;
+/** @brief The text of the open page, drawn on a transparent panel sized sprite. */
+OptionalOwnedClxSpriteList spellBookText;
 
 const size_t SpellBookPages = 6;
 const size_t SpellBookPageEntries = 7;
@@ -63,11 +69,15 @@ SpellID GetSpellFromSpellPage(size_t page, size_t entry)
 constexpr Size SpellBookDescription { 250, 43 };
 constexpr int SpellBookDescriptionPaddingHorizontal = 2;
 
+/**
+ * @brief Draws a line of a spell description.
+ * @param out The surface of the page text.
+ * @param position Where the line is, relative to the panel.
+ */
 void PrintSBookStr(const Surface &out, Point position, std::string_view text, UiFlags flags = UiFlags::None)
 {
 	DrawString(out, text,
-	    Rectangle(GetPanelPosition(UiPanels::Spell, position + Displacement { SPLICONLENGTH, 0 }),
-	        SpellBookDescription)
+	    Rectangle(position + Displacement { SPLICONLENGTH, 0 }, SpellBookDescription)
 	        .inset({ SpellBookDescriptionPaddingHorizontal, 0 }),
 	    { .flags = UiFlags::ColorWhite | flags });
 }
@@ -117,6 +127,84 @@ StringOrView GetSpellPowerText(SpellID spell, int spellLevel)
 	return fmt::format(fmt::runtime(_(/* TRANSLATORS: UI constraints, keep short please.*/ "Damage: {:d} - {:d}")), min, max);
 }
 
+/** @brief Everything the text of a spell book page shows, the text is only drawn again when this changes. */
+struct SpellBookPage {
+	struct Entry {
+		SpellID spell = SpellID::Invalid;
+		SpellType type = SpellType::Invalid;
+		int level = 0;
+		int mana = 0;
+		int charges = 0;
+
+		bool operator==(const Entry &other) const = default;
+	};
+
+	std::array<Entry, SpellBookPageEntries> entries;
+
+	bool operator==(const SpellBookPage &other) const = default;
+};
+
+std::optional<SpellBookPage> spellBookTextPage;
+
+SpellBookPage GetSpellBookPage()
+{
+	const Player &player = *InspectPlayer;
+	const uint64_t spl = player._pMemSpells | player._pISpells | player._pAblSpells;
+
+	SpellBookPage page;
+	for (size_t pageEntry = 0; pageEntry < SpellBookPageEntries; pageEntry++) {
+		const SpellID sn = GetSpellFromSpellPage(SpellbookTab, pageEntry);
+		if (!IsValidSpell(sn) || (spl & GetSpellBitmask(sn)) == 0)
+			continue;
+		SpellBookPage::Entry &entry = page.entries[pageEntry];
+		entry.spell = sn;
+		entry.type = GetSBookTrans(sn, false);
+		if (entry.type == SpellType::Charges) {
+			entry.charges = player.InvBody[INVLOC_HAND_LEFT]._iCharges;
+		} else if (entry.type != SpellType::Skill) {
+			entry.level = player.GetSpellLevel(sn);
+			entry.mana = GetManaAmount(player, sn) >> 6;
+		}
+	}
+	return page;
+}
+
+void DrawSpellBookText(const SpellBookPage &page)
+{
+	const OwnedSurface out { SidePanelSize };
+	SDL_FillSurfaceRect(out.surface, nullptr, 1);
+
+	const int lineHeight = 18;
+
+	int yp = 12;
+	const int textPaddingTop = 7;
+	for (const SpellBookPage::Entry &entry : page.entries) {
+		if (entry.spell != SpellID::Invalid) {
+			const Point line0 { 0, yp + textPaddingTop };
+			const Point line1 { 0, yp + textPaddingTop + lineHeight };
+			PrintSBookStr(out, line0, pgettext("spell", GetSpellData(entry.spell).sNameText));
+			switch (entry.type) {
+			case SpellType::Skill:
+				PrintSBookStr(out, line1, _("Skill"));
+				break;
+			case SpellType::Charges:
+				PrintSBookStr(out, line1, fmt::format(fmt::runtime(ngettext("Staff ({:d} charge)", "Staff ({:d} charges)", entry.charges)), entry.charges));
+				break;
+			default: {
+				PrintSBookStr(out, line0, fmt::format(fmt::runtime(pgettext(/* TRANSLATORS: UI constraints, keep short please.*/ "spellbook", "Level {:d}")), entry.level), UiFlags::AlignRight);
+				if (const StringOrView text = GetSpellPowerText(entry.spell, entry.level); !text.empty()) {
+					PrintSBookStr(out, line1, text, UiFlags::AlignRight);
+				}
+				PrintSBookStr(out, line1, fmt::format(fmt::runtime(pgettext(/* TRANSLATORS: UI constraints, keep short please.*/ "spellbook", "Mana: {:d}")), entry.mana));
+			} break;
+			}
+		}
+		yp += SpellBookDescription.height;
+	}
+
+	spellBookText = SurfaceToClx(out, 1, 1);
+}
+
 } // namespace
 
 tl::expected<void, std::string> InitSpellBook()
@@ -131,6 +219,8 @@ void FreeSpellBook()
 	FreeSmallSpellIcons();
 	spellBookButtons = std::nullopt;
 	spellBookBackground = std::nullopt;
+	spellBookText = std::nullopt;
+	spellBookTextPage = std::nullopt;
 }
 
 void DrawSpellBook(const Surface &out)
@@ -146,15 +236,12 @@ void DrawSpellBook(const Surface &out)
 
 	ClxDraw(out, GetPanelPosition(UiPanels::Spell, { SpellBookButtonX + buttonX, SpellBookButtonY }), (*spellBookButtons)[SpellbookTab]);
 	const Player &player = *InspectPlayer;
-	const uint64_t spl = player._pMemSpells | player._pISpells | player._pAblSpells;
-
-	const int lineHeight = 18;
 
 	int yp = 12;
-	const int textPaddingTop = 7;
-	for (size_t pageEntry = 0; pageEntry < SpellBookPageEntries; pageEntry++) {
-		const SpellID sn = GetSpellFromSpellPage(SpellbookTab, pageEntry);
-		if (IsValidSpell(sn) && (spl & GetSpellBitmask(sn)) != 0) {
+	const SpellBookPage page = GetSpellBookPage();
+	for (const SpellBookPage::Entry &entry : page.entries) {
+		if (entry.spell != SpellID::Invalid) {
+			const SpellID sn = entry.spell;
 			const SpellType st = GetSBookTrans(sn, true);
 			SetSpellTrans(st);
 			const Point spellCellPosition = GetPanelPosition(UiPanels::Spell, { 11, yp + SpellBookDescription.height });
@@ -163,31 +250,15 @@ void DrawSpellBook(const Surface &out)
 				SetSpellTrans(SpellType::Skill);
 				DrawSmallSpellIconBorder(out, spellCellPosition);
 			}
-
-			const Point line0 { 0, yp + textPaddingTop };
-			const Point line1 { 0, yp + textPaddingTop + lineHeight };
-			PrintSBookStr(out, line0, pgettext("spell", GetSpellData(sn).sNameText));
-			switch (GetSBookTrans(sn, false)) {
-			case SpellType::Skill:
-				PrintSBookStr(out, line1, _("Skill"));
-				break;
-			case SpellType::Charges: {
-				const int charges = player.InvBody[INVLOC_HAND_LEFT]._iCharges;
-				PrintSBookStr(out, line1, fmt::format(fmt::runtime(ngettext("Staff ({:d} charge)", "Staff ({:d} charges)", charges)), charges));
-			} break;
-			default: {
-				const int mana = GetManaAmount(player, sn) >> 6;
-				const int lvl = player.GetSpellLevel(sn);
-				PrintSBookStr(out, line0, fmt::format(fmt::runtime(pgettext(/* TRANSLATORS: UI constraints, keep short please.*/ "spellbook", "Level {:d}")), lvl), UiFlags::AlignRight);
-				if (const StringOrView text = GetSpellPowerText(sn, lvl); !text.empty()) {
-					PrintSBookStr(out, line1, text, UiFlags::AlignRight);
-				}
-				PrintSBookStr(out, line1, fmt::format(fmt::runtime(pgettext(/* TRANSLATORS: UI constraints, keep short please.*/ "spellbook", "Mana: {:d}")), mana));
-			} break;
-			}
 		}
 		yp += SpellBookDescription.height;
 	}
+
+	if (!spellBookText || spellBookTextPage != page) {
+		DrawSpellBookText(page);
+		spellBookTextPage = page;
+	}
+	RenderClxSprite(out, (*spellBookText)[0], GetPanelPosition(UiPanels::Spell));
 }
 
 void CheckSBook()
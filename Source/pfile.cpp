@@ -5,9 +5,17 @@
  */
 #include "pfile.h"
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include <ankerl/unordered_dense.h>
 #include <expected.hpp>
@@ -20,6 +28,7 @@
 #endif
 
 #include "codec.h"
+#include "engine/assets.hpp"
 #include "engine/load_file.hpp"
 #include "engine/render/primitive_render.hpp"
 #include "game_mode.hpp"
@@ -31,11 +40,14 @@
 #include "tables/playerdat.hpp"
 #include "utils/endian_read.hpp"
 #include "utils/endian_swap.hpp"
+#include "utils/endian_write.hpp"
 #include "utils/file_util.h"
 #include "utils/language.h"
+#include "utils/log.hpp"
 #include "utils/parse_int.hpp"
 #include "utils/paths.h"
 #include "utils/sdl_compat.h"
+#include "utils/sdl_thread.h"
 #include "utils/stdcompat/filesystem.hpp"
 #include "utils/str_cat.hpp"
 #include "utils/str_split.hpp"
@@ -162,17 +174,61 @@ void EncodeHero(SaveWriter &saveWriter, const PlayerPack *pack)
 
 SaveWriter GetSaveWriter(uint32_t saveNum, bool carryForward = true)
 {
+	WaitForPendingSave();
 	return SaveWriter(GetSavePath(saveNum), carryForward);
 }
 
 SaveWriter GetStashWriter()
 {
+	// The stash is a separate archive, it can be written while the hero is still being saved
 	return SaveWriter(GetStashSavePath(), /*carryForward=*/true);
 }
 
+/** @brief The save that is being written on `SaveThread`. */
+std::unique_ptr<SaveWriter> PendingSave;
+SdlThread SaveThread;
+
+#ifndef UNPACKED_SAVES
+int SDLCALL CommitPendingSave(void *data)
+{
+	static_cast<SaveWriter *>(data)->Commit();
+	return 0;
+}
+#endif
+
+/**
+ * @brief Returns a writer whose changes are written by `CommitSaveInBackground`.
+ *
+ * Serializing into it only touches memory, so the game state can be captured without waiting for the disk.
+ */
+SaveWriter GetDeferredSaveWriter(uint32_t saveNum, bool carryForward = true)
+{
+#ifdef UNPACKED_SAVES
+	return GetSaveWriter(saveNum, carryForward);
+#else
+	return SaveWriter::Deferred(GetSavePath(saveNum), carryForward);
+#endif
+}
+
+/**
+ * @brief Compresses and writes the archive on a worker thread, after any save that is still being written.
+ */
+void CommitSaveInBackground(SaveWriter &&saveWriter)
+{
+#ifdef UNPACKED_SAVES
+	// Files are written right away, there is nothing left to do
+	(void)saveWriter;
+#else
+	WaitForPendingSave();
+	PendingSave = std::make_unique<SaveWriter>(std::move(saveWriter));
+	SaveThread = SdlThread(CommitPendingSave, PendingSave.get());
+#endif
+}
+
 #ifndef DISABLE_DEMOMODE
 void CopySaveFile(uint32_t saveNum, std::string targetPath)
 {
+	WaitForPendingSave();
 	const std::string savePath = GetSavePath(saveNum);
 #if defined(UNPACKED_SAVES)
 #ifdef DVL_NO_FILESYSTEM
@@ -242,6 +298,7 @@ bool ArchiveContainsGame(SaveReader &hsArchive)
 
 std::optional<SaveReader> CreateSaveReader(std::string &&path)
 {
+	WaitForPendingSave();
 #ifdef UNPACKED_SAVES
 	if (!FileExists(path))
 		return std::nullopt;
@@ -509,7 +566,7 @@ void pfile_write_hero(SaveWriter &saveWriter, bool writeGameData)
 {
 	if (writeGameData) {
 		SaveGameData(saveWriter);
-		RenameTempToPerm(saveWriter);
+		saveWriter.Defer(RenameTempToPerm);
 	}
 	PlayerPack pkplr;
 	Player &myPlayer = *MyPlayer;
@@ -533,14 +590,295 @@ void RemoveAllInvalidItems(Player &player)
 	RemoveEmptyInventory(player);
 }
 
+/** @brief Size and modification time of a save file, an index entry is only used while these match. */
+struct SaveFileStamp {
+	std::uintmax_t size;
+	std::int64_t modificationTime;
+
+	bool operator==(const SaveFileStamp &other) const = default;
+};
+
+/**
+ * @brief Summary of a save slot for the hero selection screen, as found when the save was last read.
+ */
+struct HeroIndexEntry {
+	bool hasStamp;
+	SaveFileStamp stamp;
+	/** @brief Whether the save contains a hero, saves that can't be read are remembered as empty. */
+	bool hasHero;
+	char heroName[PlayerNameLength];
+	_uiheroinfo info;
+};
+
+#ifndef UNPACKED_SAVES
+constexpr uint32_t HeroIndexMagic = 0x58444844; // "DHDX"
+/** @brief Bumped whenever the file layout changes, indexes of other versions are discarded. */
+constexpr uint8_t HeroIndexVersion = 1;
+
+struct HeroIndex {
+	/** @brief Identifies the active mods, they change which items are valid and with that the hero stats. */
+	uint64_t modsKey;
+	std::array<HeroIndexEntry, MAX_CHARACTERS> entries;
+};
+
+/** @brief Flags, save size, modification time, hero name, save number, UI name, level, class, rank, 4 attributes, has saved, spawned. */
+constexpr size_t HeroIndexEntrySize = 1 + 8 + 8 + PlayerNameLength + 4 + sizeof(_uiheroinfo::name) + 3 + 4 * 2 + 2;
+/** @brief Magic, version, mods key and the entries. */
+constexpr size_t HeroIndexFileSize = 4 + 1 + 8 + MAX_CHARACTERS * HeroIndexEntrySize;
+
+/**
+ * @brief Writes the hero index in little-endian order, independent of the layout of the structs in memory.
+ */
+class HeroIndexWriter {
+public:
+	explicit HeroIndexWriter(std::byte *out)
+	    : out_(out)
+	{
+	}
+
+	void writeByte(uint8_t value)
+	{
+		*out_++ = static_cast<std::byte>(value);
+	}
+
+	void writeLE16(uint16_t value)
+	{
+		WriteLE16(out_, value);
+		out_ += 2;
+	}
+
+	void writeLE32(uint32_t value)
+	{
+		WriteLE32(out_, value);
+		out_ += 4;
+	}
+
+	void writeLE64(uint64_t value)
+	{
+		writeLE32(static_cast<uint32_t>(value));
+		writeLE32(static_cast<uint32_t>(value >> 32));
+	}
+
+	void writeBytes(const char *data, size_t size)
+	{
+		memcpy(out_, data, size);
+		out_ += size;
+	}
+
+private:
+	std::byte *out_;
+};
+
+class HeroIndexReader {
+public:
+	explicit HeroIndexReader(const std::byte *in)
+	    : in_(in)
+	{
+	}
+
+	uint8_t readByte()
+	{
+		return static_cast<uint8_t>(*in_++);
+	}
+
+	uint16_t readLE16()
+	{
+		const uint16_t value = LoadLE16(in_);
+		in_ += 2;
+		return value;
+	}
+
+	uint32_t readLE32()
+	{
+		const uint32_t value = LoadLE32(in_);
+		in_ += 4;
+		return value;
+	}
+
+	uint64_t readLE64()
+	{
+		const uint64_t low = readLE32();
+		return low | (static_cast<uint64_t>(readLE32()) << 32);
+	}
+
+	/** @brief Reads a string field, always null-terminated even if the file isn't. */
+	void readString(char *data, size_t size)
+	{
+		memcpy(data, in_, size);
+		data[size - 1] = '\0';
+		in_ += size;
+	}
+
+private:
+	const std::byte *in_;
+};
+
+void PackHeroIndexEntry(HeroIndexWriter &writer, const HeroIndexEntry &entry)
+{
+	writer.writeByte((entry.hasStamp ? 1 : 0) | (entry.hasHero ? 2 : 0));
+	writer.writeLE64(entry.stamp.size);
+	writer.writeLE64(static_cast<uint64_t>(entry.stamp.modificationTime));
+	writer.writeBytes(entry.heroName, sizeof(entry.heroName));
+	writer.writeLE32(entry.info.saveNumber);
+	writer.writeBytes(entry.info.name, sizeof(entry.info.name));
+	writer.writeByte(entry.info.level);
+	writer.writeByte(static_cast<uint8_t>(entry.info.heroclass));
+	writer.writeByte(entry.info.herorank);
+	writer.writeLE16(entry.info.strength);
+	writer.writeLE16(entry.info.magic);
+	writer.writeLE16(entry.info.dexterity);
+	writer.writeLE16(entry.info.vitality);
+	writer.writeByte(entry.info.hassaved ? 1 : 0);
+	writer.writeByte(entry.info.spawned ? 1 : 0);
+}
+
+void UnPackHeroIndexEntry(HeroIndexReader &reader, HeroIndexEntry &entry)
+{
+	const uint8_t flags = reader.readByte();
+	entry.hasStamp = (flags & 1) != 0;
+	entry.hasHero = (flags & 2) != 0;
+	entry.stamp.size = static_cast<std::uintmax_t>(reader.readLE64());
+	entry.stamp.modificationTime = static_cast<std::int64_t>(reader.readLE64());
+	reader.readString(entry.heroName, sizeof(entry.heroName));
+	entry.info.saveNumber = reader.readLE32();
+	reader.readString(entry.info.name, sizeof(entry.info.name));
+	entry.info.level = reader.readByte();
+	entry.info.heroclass = static_cast<HeroClass>(reader.readByte());
+	entry.info.herorank = reader.readByte();
+	entry.info.strength = reader.readLE16();
+	entry.info.magic = reader.readLE16();
+	entry.info.dexterity = reader.readLE16();
+	entry.info.vitality = reader.readLE16();
+	entry.info.hassaved = reader.readByte() != 0;
+	entry.info.spawned = reader.readByte() != 0;
+
+	// Read the save again rather than show a hero of a class that no longer exists
+	if (entry.hasHero && static_cast<size_t>(entry.info.heroclass) >= GetNumPlayerClasses())
+		entry.hasStamp = false;
+}
+
+std::string GetHeroIndexPath()
+{
+	return StrCat(paths::PrefPath(),
+	    gbIsSpawn
+	        ? (gbIsMultiplayer ? "share_" : "spawn_")
+	        : (gbIsMultiplayer ? "multi_" : "single_"),
+	    gbIsHellfire ? "heroes.hidx" : "heroes.idx");
+}
+
+uint64_t GetModsKey()
+{
+	std::string mods;
+	for (const std::string &overridePath : OverridePaths)
+		StrAppend(mods, overridePath, "\n");
+	return ankerl::unordered_dense::hash<std::string> {}(mods);
+}
+
+std::optional<SaveFileStamp> GetSaveFileStamp(uint32_t saveNum)
+{
+	const std::string path = GetSavePath(saveNum);
+	SaveFileStamp stamp;
+	if (!GetFileSize(path.c_str(), &stamp.size) || !GetFileModificationTime(path.c_str(), &stamp.modificationTime))
+		return std::nullopt;
+	return stamp;
+}
+
+/**
+ * @brief Reads the hero index of the current game mode, an index that is missing or outdated reads as empty.
+ */
+std::unique_ptr<HeroIndex> ReadHeroIndex()
+{
+	auto index = std::make_unique<HeroIndex>();
+	index->modsKey = GetModsKey();
+
+	const std::string path = GetHeroIndexPath();
+	FILE *file = OpenFile(path.c_str(), "rb");
+	if (file == nullptr)
+		return index;
+	std::array<std::byte, HeroIndexFileSize> data;
+	const bool ok = std::fread(data.data(), data.size(), 1, file) == 1;
+	std::fclose(file);
+	if (!ok)
+		return index;
+
+	HeroIndexReader reader { data.data() };
+	if (reader.readLE32() != HeroIndexMagic || reader.readByte() != HeroIndexVersion || reader.readLE64() != index->modsKey)
+		return index;
+	for (HeroIndexEntry &entry : index->entries)
+		UnPackHeroIndexEntry(reader, entry);
+	return index;
+}
+
+void WriteHeroIndex(const HeroIndex &index)
+{
+	// Write to a temporary file first so that an interrupted write never leaves a truncated index behind.
+	const std::string path = GetHeroIndexPath();
+	const std::string tempPath = StrCat(path, ".tmp");
+	FILE *file = OpenFile(tempPath.c_str(), "wb");
+	if (file == nullptr) {
+		LogVerbose("Failed to create hero index {}", tempPath);
+		return;
+	}
+	std::array<std::byte, HeroIndexFileSize> data;
+	HeroIndexWriter writer { data.data() };
+	writer.writeLE32(HeroIndexMagic);
+	writer.writeByte(HeroIndexVersion);
+	writer.writeLE64(index.modsKey);
+	for (const HeroIndexEntry &entry : index.entries)
+		PackHeroIndexEntry(writer, entry);
+
+	bool ok = std::fwrite(data.data(), data.size(), 1, file) == 1;
+	ok = std::fclose(file) == 0 && ok;
+	if (!ok) {
+		LogVerbose("Failed to write hero index {}", tempPath);
+		RemoveFile(tempPath.c_str());
+		return;
+	}
+	RenameFile(tempPath.c_str(), path.c_str());
+}
+#endif // !UNPACKED_SAVES
+
+/**
+ * @brief Reads the hero of a save slot the same way loading it would, to get its stats with all of its items.
+ */
+void ReadHeroIndexEntry(uint32_t saveNum, HeroIndexEntry &entry)
+{
+	entry.hasHero = false;
+	std::optional<SaveReader> archive = OpenSaveArchive(saveNum);
+	if (!archive)
+		return;
+	PlayerPack pkplr;
+	if (!ReadHero(*archive, &pkplr))
+		return;
+
+	const bool hasSaveGame = ArchiveContainsGame(*archive);
+	if (hasSaveGame)
+		pkplr.bIsHellfire = gbIsHellfireSaveGame ? 1 : 0;
+
+	Player &player = Players[0];
+
+	UnPackPlayer(pkplr, player);
+	LoadHeroItems(player);
+	RemoveAllInvalidItems(player);
+	CalcPlrInv(player, false);
+
+	entry.hasHero = true;
+	CopyUtf8(entry.heroName, pkplr.pName, sizeof(entry.heroName));
+	entry.info = {};
+	entry.info.saveNumber = saveNum;
+	Game2UiPlayer(player, &entry.info, hasSaveGame);
+}
+
 } // namespace
 
 #ifdef UNPACKED_SAVES
-std::unique_ptr<std::byte[]> SaveReader::ReadFile(const char *filename, std::size_t &fileSize, int32_t &error)
+namespace {
+
+/** @brief Reads a file of an unpacked save from before the journal. */
+std::unique_ptr<std::byte[]> ReadLooseSaveFile(const std::string &path, std::size_t &fileSize, int32_t &error)
 {
 	std::unique_ptr<std::byte[]> result;
 	error = 0;
-	const std::string path = dir_ + filename;
 	uintmax_t size;
 	if (!GetFileSize(path.c_str(), &size)) {
 		error = 1;
@@ -562,19 +900,52 @@ std::unique_ptr<std::byte[]> SaveReader::ReadFile(const char *filename, std::siz
 	return result;
 }
 
-bool SaveWriter::WriteFile(const char *filename, const std::byte *data, size_t size)
+} // namespace
+
+SaveReader::SaveReader(std::string &&dir)
+    : dir_(std::move(dir))
+    , journal_(dir_ + SaveJournalName)
+    , hasJournal_(journal_.OpenForReading())
 {
-	const std::string path = dir_ + filename;
-	FILE *file = OpenFile(path.c_str(), "wb");
-	if (file == nullptr) {
-		return false;
-	}
-	if (std::fwrite(data, size, 1, file) != 1) {
-		std::fclose(file);
-		return false;
+}
+
+std::unique_ptr<std::byte[]> SaveReader::ReadFile(const char *filename, std::size_t &fileSize, int32_t &error)
+{
+	if (!hasJournal_)
+		return ReadLooseSaveFile(dir_ + filename, fileSize, error);
+
+	std::unique_ptr<std::byte[]> result = journal_.ReadFile(filename, fileSize);
+	error = result == nullptr ? 1 : 0;
+	return result;
+}
+
+SaveWriter::SaveWriter(std::string &&dir, bool carryForward)
+    : journal_(dir + SaveJournalName)
+{
+	RecursivelyCreateDir(dir.c_str());
+	const std::string journalPath = dir + SaveJournalName;
+	if (!carryForward)
+		RemoveFile(journalPath.c_str());
+	const bool hadJournal = FileExists(journalPath);
+	if (!journal_.OpenForWriting() || hadJournal)
+		return;
+
+	// Move the loose files of a save from before the journal into it
+	std::vector<std::string> looseFiles = ListFiles(dir.c_str());
+	std::erase_if(looseFiles, [](const std::string &name) { return name.starts_with(SaveJournalName); });
+	if (carryForward) {
+		for (const std::string &name : looseFiles) {
+			size_t size;
+			int32_t error;
+			const std::unique_ptr<std::byte[]> data = ReadLooseSaveFile(dir + name, size, error);
+			if (error == 0)
+				journal_.WriteFile(name, data.get(), size);
+		}
 	}
-	std::fclose(file);
-	return true;
+	if (!journal_.Checkpoint())
+		return;
+	for (const std::string &name : looseFiles)
+		RemoveFile((dir + name).c_str());
 }
 
 void SaveWriter::RemoveHashEntries(bool (*fnGetName)(uint8_t, char *))
@@ -623,10 +994,18 @@ const char *pfile_get_password()
 	return gbIsMultiplayer ? PASSWORD_MULTI : PASSWORD_SINGLE;
 }
 
+void WaitForPendingSave()
+{
+	if (SaveThread.joinable())
+		SaveThread.join();
+	PendingSave = nullptr;
+}
+
 void pfile_write_hero(bool writeGameData)
 {
-	SaveWriter saveWriter = GetSaveWriter(gSaveNumber, /*carryForward=*/writeGameData);
+	SaveWriter saveWriter = GetDeferredSaveWriter(gSaveNumber, /*carryForward=*/writeGameData);
 	pfile_write_hero(saveWriter, writeGameData);
+	CommitSaveInBackground(std::move(saveWriter));
 }
 
 #ifndef DISABLE_DEMOMODE
@@ -671,31 +1050,47 @@ void sfile_write_stash()
 bool pfile_ui_set_hero_infos(bool (*uiAddHeroInfo)(_uiheroinfo *))
 {
 	memset(hero_names, 0, sizeof(hero_names));
+	WaitForPendingSave();
 
+#ifdef UNPACKED_SAVES
+	// The save directories don't change their size and time when the files in them change, always read them
 	for (uint32_t i = 0; i < MAX_CHARACTERS; i++) {
-		std::optional<SaveReader> archive = OpenSaveArchive(i);
-		if (archive) {
-			PlayerPack pkplr;
-			if (ReadHero(*archive, &pkplr)) {
-				_uiheroinfo uihero;
-				uihero.saveNumber = i;
-				strcpy(hero_names[i], pkplr.pName);
-				const bool hasSaveGame = ArchiveContainsGame(*archive);
-				if (hasSaveGame)
-					pkplr.bIsHellfire = gbIsHellfireSaveGame ? 1 : 0;
-
-				Player &player = Players[0];
-
-				UnPackPlayer(pkplr, player);
-				LoadHeroItems(player);
-				RemoveAllInvalidItems(player);
-				CalcPlrInv(player, false);
-
-				Game2UiPlayer(player, &uihero, hasSaveGame);
-				uiAddHeroInfo(&uihero);
+		HeroIndexEntry entry;
+		ReadHeroIndexEntry(i, entry);
+		if (entry.hasHero) {
+			strcpy(hero_names[i], entry.heroName);
+			uiAddHeroInfo(&entry.info);
+		}
+	}
+#else
+	// Only the saves that changed since the index was written are opened
+	const std::unique_ptr<HeroIndex> index = ReadHeroIndex();
+	bool indexChanged = false;
+	for (uint32_t i = 0; i < MAX_CHARACTERS; i++) {
+		HeroIndexEntry &entry = index->entries[i];
+		const std::optional<SaveFileStamp> stamp = GetSaveFileStamp(i);
+		if (!stamp) {
+			if (entry.hasStamp) {
+				entry = {};
+				indexChanged = true;
 			}
+			continue;
+		}
+		if (!entry.hasStamp || entry.stamp != *stamp) {
+			ReadHeroIndexEntry(i, entry);
+			entry.hasStamp = true;
+			entry.stamp = *stamp;
+			indexChanged = true;
+		}
+		if (entry.hasHero) {
+			strcpy(hero_names[i], entry.heroName);
+			_uiheroinfo uihero = entry.info;
+			uiAddHeroInfo(&uihero);
 		}
 	}
+	if (indexChanged)
+		WriteHeroIndex(*index);
+#endif
 
 	return true;
 }
@@ -732,6 +1127,7 @@ bool pfile_ui_save_create(_uiheroinfo *heroinfo)
 
 	SaveWriter saveWriter = GetSaveWriter(saveNum, /*carryForward=*/false);
 	saveWriter.RemoveHashEntries(GetFileName);
+	ForgetSavedLevelHashes();
 	CopyUtf8(hero_names[saveNum], heroinfo->name, sizeof(hero_names[saveNum]));
 
 	Player &player = Players[0];
@@ -753,7 +1149,12 @@ bool pfile_delete_save(_uiheroinfo *heroInfo)
 	const uint32_t saveNum = heroInfo->saveNumber;
 	if (saveNum < MAX_CHARACTERS) {
 		hero_names[saveNum][0] = '\0';
+		WaitForPendingSave();
+#ifdef UNPACKED_SAVES
+		RemoveFile((GetSavePath(saveNum) + SaveJournalName).c_str());
+#endif
 		RemoveFile(GetSavePath(saveNum).c_str());
+		ForgetSavedLevelHashes();
 	}
 	return true;
 }
@@ -781,8 +1182,9 @@ void pfile_read_player_from_save(uint32_t saveNum, Player &player)
 
 void pfile_save_level()
 {
-	SaveWriter saveWriter = GetSaveWriter(gSaveNumber);
+	SaveWriter saveWriter = GetDeferredSaveWriter(gSaveNumber);
 	SaveLevel(saveWriter);
+	CommitSaveInBackground(std::move(saveWriter));
 }
 
 tl::expected<void, std::string> pfile_convert_levels()
@@ -793,6 +1195,7 @@ tl::expected<void, std::string> pfile_convert_levels()
 
 void pfile_remove_temp_files()
 {
+	ForgetSavedLevelHashes();
 	if (gbIsMultiplayer)
 		return;
 
@@ -14,6 +14,7 @@
 #include "player.h"
 
 #ifdef UNPACKED_SAVES
+#include "utils/file_journal.hpp"
 #include "utils/file_util.h"
 #else
 #include "mpq/mpq_reader.hpp"
@@ -27,11 +28,16 @@ namespace devilution {
 extern bool gbValidSaveFile;
 
 #ifdef UNPACKED_SAVES
+/** @brief Name of the journal that holds the files of an unpacked save, in the save's directory. */
+constexpr const char *SaveJournalName = "journal";
+
+/**
+ * @brief Reads the files of an unpacked save from its journal.
+ *
+ * Saves from before the journal are read from their loose files.
+ */
 struct SaveReader {
-	explicit SaveReader(std::string &&dir)
-	    : dir_(std::move(dir))
-	{
-	}
+	explicit SaveReader(std::string &&dir);
 
 	const std::string &dir() const
 	{
@@ -42,40 +48,55 @@ struct SaveReader {
 
 	bool HasFile(const char *path)
 	{
+		if (hasJournal_)
+			return journal_.HasFile(path);
 		return ::devilution::FileExists((dir_ + path).c_str());
 	}
 
 private:
 	std::string dir_;
+	FileJournal journal_;
+	bool hasJournal_;
 };
 
+/**
+ * @brief Appends the changes to an unpacked save to its journal, they take effect together when the writer is destroyed.
+ */
 struct SaveWriter {
-	explicit SaveWriter(std::string &&dir)
-	    : dir_(std::move(dir))
+	/**
+	 * @param carryForward Whether to keep the files that are already in the save.
+	 */
+	explicit SaveWriter(std::string &&dir, bool carryForward = true);
+
+	bool WriteFile(const char *filename, const std::byte *data, size_t size)
 	{
+		return journal_.WriteFile(filename, data, size);
 	}
 
-	bool WriteFile(const char *filename, const std::byte *data, size_t size);
-
 	bool HasFile(const char *path)
 	{
-		return ::devilution::FileExists((dir_ + path).c_str());
+		return journal_.HasFile(path);
 	}
 
 	void RenameFile(const char *from, const char *to)
 	{
-		::devilution::RenameFile((dir_ + from).c_str(), (dir_ + to).c_str());
+		journal_.RenameFile(from, to);
 	}
 
 	void RemoveHashEntry(const char *path)
 	{
-		RemoveFile((dir_ + path).c_str());
+		journal_.RemoveFile(path);
 	}
 
 	void RemoveHashEntries(bool (*fnGetName)(uint8_t, char *));
 
+	void Defer(void (*fn)(SaveWriter &))
+	{
+		fn(*this);
+	}
+
 private:
-	std::string dir_;
+	FileJournal journal_;
 };
 
 #else
@@ -100,6 +121,15 @@ std::optional<SaveReader> OpenSaveArchive(uint32_t saveNum);
 std::optional<SaveReader> OpenStashArchive();
 const char *pfile_get_password();
 std::unique_ptr<std::byte[]> ReadArchive(SaveReader &archive, const char *pszName, size_t *pdwLen = nullptr);
+/**
+ * @brief Waits until the save that is being written in the background is on disk.
+ *
+ * Reading or writing a save through this file does so on its own, call it before touching save files in any other way.
+ */
+void WaitForPendingSave();
+/**
+ * @brief Saves the hero, the archive is compressed and written in the background.
+ */
 void pfile_write_hero(bool writeGameData = false);
 
 #ifndef DISABLE_DEMOMODE
@@ -27,6 +27,7 @@
 #include "engine/backbuffer_state.hpp"
 #include "engine/load_cl2.hpp"
 #include "engine/load_file.hpp"
+#include "engine/path_impl.hpp"
 #include "engine/points_in_rectangle_range.hpp"
 #include "engine/random.hpp"
 #include "engine/render/clx_render.hpp"
@@ -70,6 +71,60 @@ bool MyPlayerIsDead;
 
 namespace {
 
+#ifdef DEVILUTIONX_PLAYER_GFX_BUDGET
+/** @brief How much memory the loaded animations of all players may take up, not counting the ones currently shown. */
+constexpr size_t PlayerGraphicsBudget = DEVILUTIONX_PLAYER_GFX_BUDGET;
+#else
+constexpr size_t PlayerGraphicsBudget = 24 * 1024 * 1024;
+#endif
+
+/** @brief Incremented whenever a player animation is used. */
+uint32_t PlayerGraphicsUseCounter;
+
+bool IsShowingPlayerGraphic(const Player &player, const PlayerAnimationData &animData)
+{
+	const auto begin = reinterpret_cast<uintptr_t>(ClxSpriteSheet { *animData.sprites }.data());
+	const uintptr_t end = begin + animData.sprites->dataSize();
+	const auto contains = [&](const uint8_t *data) {
+		const auto address = reinterpret_cast<uintptr_t>(data);
+		return address >= begin && address < end;
+	};
+	return (player.AnimInfo.sprites && contains(player.AnimInfo.sprites->data()))
+	    || (player.previewCelSprite && contains(player.previewCelSprite->pixelData()));
+}
+
+/**
+ * @brief Unloads the least recently used animations of all players until they fit the budget.
+ *
+ * Animations that are shown, and the one that was just loaded, are never unloaded.
+ */
+void UnloadPlayerGraphicsOverBudget(const PlayerAnimationData &loaded)
+{
+	size_t loadedSize = 0;
+	for (const Player &player : Players) {
+		for (const PlayerAnimationData &animData : player.AnimationData) {
+			if (animData.sprites)
+				loadedSize += animData.sprites->dataSize();
+		}
+	}
+	while (loadedSize > PlayerGraphicsBudget) {
+		PlayerAnimationData *oldest = nullptr;
+		for (Player &player : Players) {
+			for (PlayerAnimationData &animData : player.AnimationData) {
+				if (!animData.sprites || &animData == &loaded || (oldest != nullptr && animData.lastUsed >= oldest->lastUsed))
+					continue;
+				if (!IsShowingPlayerGraphic(player, animData))
+					oldest = &animData;
+			}
+		}
+		if (oldest == nullptr)
+			return;
+		loadedSize -= oldest->sprites->dataSize();
+		oldest->sprites = std::nullopt;
+		ClearClxDrawCache();
+	}
+}
+
 struct DirectionSettings {
 	Direction dir;
 	PLR_MODE walkMode;
@@ -1935,7 +1990,7 @@ void Player::UpdatePreviewCelSprite(_cmd_id cmdId, Point point, uint16_t wParam1
 
 	if (minimalWalkDistance >= 0 && position.future != point) {
 		int8_t testWalkPath[MaxPathLengthPlayer];
-		const int steps = FindPath(CanStep, [this](Point tile) { return PosOkPlayer(*this, tile); }, position.future, point, testWalkPath, MaxPathLengthPlayer);
+		const int steps = FindPathT(CanStepPredicate {}, PlayerPosOk { *this }, position.future, point, testWalkPath, MaxPathLengthPlayer);
 		if (steps == 0) {
 			// Can't walk to desired location => stand still
 			return;
@@ -2104,6 +2159,7 @@ void LoadPlrGFX(Player &player, player_graphic graphic)
 		return;
 
 	auto &animationData = player.AnimationData[static_cast<size_t>(graphic)];
+	animationData.lastUsed = ++PlayerGraphicsUseCounter;
 	if (animationData.sprites)
 		return;
 
@@ -2173,6 +2229,7 @@ void LoadPlrGFX(Player &player, player_graphic graphic)
 	if (classTRN) {
 		ClxApplyTrans(*animationData.sprites, classTRN->data());
 	}
+	UnloadPlayerGraphicsOverBudget(animationData);
 }
 
 void InitPlayerGFX(Player &player)
@@ -2188,12 +2245,8 @@ void InitPlayerGFX(Player &player)
 		return;
 	}
 
-	for (size_t i = 0; i < enum_size<player_graphic>::value; i++) {
-		auto graphic = static_cast<player_graphic>(i);
-		if (graphic == player_graphic::Death)
-			continue;
-		LoadPlrGFX(player, graphic);
-	}
+	// The other animations are loaded when first used.
+	LoadPlrGFX(player, player_graphic::Stand);
 }
 
 void ResetPlayerGFX(Player &player)
@@ -2208,6 +2261,7 @@ void ResetPlayerGFX(Player &player)
 	for (PlayerAnimationData &animData : player.AnimationData) {
 		animData.sprites = std::nullopt;
 	}
+	ClearClxDrawCache();
 }
 
 void NewPlrAnim(Player &player, player_graphic graphic, Direction dir, AnimationDistributionFlags flags /*= AnimationDistributionFlags::None*/, int8_t numSkippedFrames /*= 0*/, int8_t distributeFramesBeforeFrame /*= 0*/)
@@ -3110,13 +3164,15 @@ bool PosOkPlayer(const Player &player, Point position)
 	return true;
 }
 
+template int FindPathT<CanStepPredicate, PlayerPosOk>(const CanStepPredicate &canStep, const PlayerPosOk &posOk, Point startPosition, Point destinationPosition, int8_t *path, size_t maxPathLength);
+
 void MakePlrPath(Player &player, Point targetPosition, bool endspace)
 {
 	if (player.position.future == targetPosition) {
 		return;
 	}
 
-	int path = FindPath(CanStep, [&player](Point position) { return PosOkPlayer(player, position); }, player.position.future, targetPosition, player.walkpath, MaxPathLengthPlayer);
+	int path = FindPathT(CanStepPredicate {}, PlayerPosOk { player }, player.position.future, targetPosition, player.walkpath, MaxPathLengthPlayer);
 	if (path == 0) {
 		return;
 	}
@@ -3230,6 +3286,7 @@ void CheckPlrSpell(bool isShiftHeld, SpellID spellID, SpellType spellType)
 void SyncPlrAnim(Player &player)
 {
 	const player_graphic graphic = player.getGraphic();
+	LoadPlrGFX(player, graphic);
 	if (!HeadlessMode)
 		player.AnimInfo.sprites = player.AnimationData[static_cast<size_t>(graphic)].spritesForDirection(player._pdir);
 }
@@ -25,6 +25,7 @@
 #include "items/validation.h"
 #include "levels/dun_tile.hpp"
 #include "levels/gendung.h"
+#include "levels/tile_properties.hpp"
 #include "multi.h"
 #include "tables/playerdat.hpp"
 #include "tables/spelldat.h"
@@ -192,6 +193,9 @@ struct PlayerAnimationData {
 	 */
 	OptionalOwnedClxSpriteSheet sprites;
 
+	/** @brief When the sprites were last used, least recently used sprites are unloaded first. */
+	uint32_t lastUsed = 0;
+
 	[[nodiscard]] ClxSpriteList spritesForDirection(Direction direction) const
 	{
 		return (*sprites)[static_cast<size_t>(direction)];
@@ -980,6 +984,20 @@ void StartWarpLvl(Player &player, size_t pidx);
 void ProcessPlayers();
 void ClrPlrPath(Player &player);
 bool PosOkPlayer(const Player &player, Point position);
+
+/** @brief `PosOkPlayer` as a function object, for `FindPathT`. */
+struct PlayerPosOk {
+	const Player &player;
+
+	bool operator()(Point position) const
+	{
+		return PosOkPlayer(player, position);
+	}
+};
+
+/** @brief The path search players walk with, instantiated in player.cpp. */
+extern template int FindPathT<CanStepPredicate, PlayerPosOk>(const CanStepPredicate &canStep, const PlayerPosOk &posOk, Point startPosition, Point destinationPosition, int8_t *path, size_t maxPathLength);
+
 void MakePlrPath(Player &player, Point targetPosition, bool endspace);
 void CheckPlrSpell(bool isShiftHeld, SpellID spellID = MyPlayer->_pRSpell, SpellType spellType = MyPlayer->_pRSplType);
 void SyncPlrAnim(Player &player);
@@ -185,13 +185,15 @@ void DrawChatLog(const Surface &out)
 
 	const int numLines = NumVisibleLines();
 	const int contentY = titleBottom + DividerLineMarginY() + ContentPaddingY();
+	// Lines are wrapped when they are added, drawing only needs the visible ones
+	std::vector<DrawStringFormatArg> args;
 	for (int i = 0; i < numLines; i++) {
 		if (i + SkipLines >= ChatLogLines.size())
 			break;
 		const MultiColoredText &text = ChatLogLines[ChatLogLines.size() - (i + SkipLines + 1)];
 		const std::string_view line = text.text;
 
-		std::vector<DrawStringFormatArg> args;
+		args.clear();
 		for (auto &x : text.colors) {
 			args.emplace_back(x.text, x.color);
 		}
@@ -5,6 +5,7 @@
 #include <deque>
 #include <fmt/format.h>
 #include <string>
+#include <utility>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_timer.h>
@@ -25,6 +26,8 @@ struct FloatingNumber {
 	Displacement startOffset;
 	Displacement endOffset;
 	std::string text;
+	/** @brief Width of `text` in pixels, measured when the text changes rather than every frame. */
+	int lineWidth;
 	uint32_t time;
 	uint32_t lastMerge;
 	UiFlags style;
@@ -64,39 +67,44 @@ void AddFloatingNumber(Point pos, Displacement offset, std::string text, UiFlags
 	else
 		endOffset = { 0, 140 };
 
-	for (auto &num : FloatingQueue) {
-		if (id != 0 && num.id == id && (SDL_GetTicks() - static_cast<int>(num.lastMerge)) <= 100) {
-			num.text = text;
-			num.lastMerge = SDL_GetTicks();
-			num.style = style;
-			num.startPos = pos;
-			return;
+	const uint32_t now = SDL_GetTicks();
+	if (id != 0) {
+		for (auto &num : FloatingQueue) {
+			if (num.id == id && (now - static_cast<int>(num.lastMerge)) <= 100) {
+				num.lineWidth = GetLineWidth(text, GetGameFontSize(style));
+				num.text = std::move(text);
+				num.lastMerge = now;
+				num.style = style;
+				num.startPos = pos;
+				return;
+			}
 		}
 	}
-	FloatingNumber num {
-		pos, offset, endOffset, text,
-		static_cast<uint32_t>(SDL_GetTicks() + 2500),
-		static_cast<uint32_t>(SDL_GetTicks()),
-		style | UiFlags::Outlined, id, reverseDirection
-	};
-	FloatingQueue.push_back(num);
+	const int lineWidth = GetLineWidth(text, GetGameFontSize(style));
+	FloatingQueue.push_back(FloatingNumber {
+	    pos, offset, endOffset, std::move(text), lineWidth,
+	    static_cast<uint32_t>(now + 2500),
+	    static_cast<uint32_t>(now),
+	    style | UiFlags::Outlined, id, reverseDirection });
 }
 
 void DrawFloatingNumbers(const Surface &out, Point viewPosition, Displacement offset)
 {
+	const uint32_t now = SDL_GetTicks();
+	const bool zoom = *GetOptions().Graphics.zoom;
 	for (auto &floatingNum : FloatingQueue) {
 		Displacement worldOffset = viewPosition - floatingNum.startPos;
 		worldOffset = worldOffset.worldToScreen() + offset + Displacement { TILE_WIDTH / 2, -TILE_HEIGHT / 2 } + floatingNum.startOffset;
 
-		if (*GetOptions().Graphics.zoom) {
+		if (zoom) {
 			worldOffset *= 2;
 		}
 
 		Point screenPosition { worldOffset.deltaX, worldOffset.deltaY };
 
-		const int lineWidth = GetLineWidth(floatingNum.text, GetGameFontSize(floatingNum.style));
+		const int lineWidth = floatingNum.lineWidth;
 		screenPosition.x -= lineWidth / 2;
-		const uint32_t timeLeft = floatingNum.time - SDL_GetTicks();
+		const uint32_t timeLeft = floatingNum.time - now;
 		const float mul = 1 - (timeLeft / 2500.0F);
 		screenPosition += floatingNum.endOffset * mul;
 
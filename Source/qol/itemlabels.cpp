@@ -1,6 +1,7 @@
 #include "itemlabels.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <limits>
 #include <string>
@@ -21,6 +22,7 @@
 #include "stores.h"
 #include "utils/algorithm/container.hpp"
 #include "utils/format_int.hpp"
+#include "utils/frame_profiler.hpp"
 #include "utils/language.h"
 
 namespace devilution {
@@ -35,6 +37,25 @@ struct ItemLabel {
 
 std::vector<ItemLabel> labelQueue;
 
+/** @brief The text of an item's label and its measured width, kept until the text changes. */
+struct LabelWidth {
+	std::string text;
+	int width;
+};
+
+std::array<std::optional<LabelWidth>, MAXITEMS + 1> labelWidths;
+
+/** @brief A label as the overlap resolution last saw it, relative to the first label, and how far it was moved. */
+struct ResolvedLabel {
+	int id;
+	int width;
+	Displacement offset;
+	int shiftX;
+};
+
+std::vector<ResolvedLabel> resolvedLabels;
+int resolvedLabelHeight;
+
 bool highlightKeyPressed = false;
 bool isLabelHighlighted = false;
 std::array<std::optional<int>, ITEMTYPES> labelCenterOffsets;
@@ -115,8 +136,11 @@ void AddItemToLabelQueue(int id, Point position)
 		textOnGround = item.getName();
 	}
 
-	int nameWidth = GetLineWidth(textOnGround);
-	nameWidth += MarginX * 2;
+	std::optional<LabelWidth> &cachedWidth = labelWidths[id];
+	if (!cachedWidth || cachedWidth->text != textOnGround.str()) {
+		cachedWidth = LabelWidth { std::string(textOnGround.str()), GetLineWidth(textOnGround) + (MarginX * 2) };
+	}
+	const int nameWidth = cachedWidth->width;
 	const int index = ItemCAnimTbl[item._iCurs];
 	if (!labelCenterOffsets[index]) {
 		const auto [xBegin, xEnd] = ClxMeasureSolidHorizontalBounds((*item.AnimInfo.sprites)[item.AnimInfo.currentFrame]);
@@ -145,16 +169,37 @@ bool IsMouseOverGameArea()
 	return true;
 }
 
-void DrawItemNameLabels(const Surface &out)
+namespace {
+
+/**
+ * @brief Whether the labels are the same as the last time their overlaps were resolved.
+ *
+ * The resolution only depends on where the labels are relative to each other, so moving the camera doesn't change it.
+ */
+bool CanReuseResolvedLabels(int labelHeight)
 {
-	const Surface clippedOut = out.subregionY(0, gnViewportHeight);
-	isLabelHighlighted = false;
-	if (labelQueue.empty())
-		return;
-	UsedX usedX;
-	const int labelHeight = LabelHeight();
-	const int labelMarginTop = TextMarginTop();
+	if (resolvedLabels.size() != labelQueue.size() || resolvedLabelHeight != labelHeight)
+		return false;
+	const Point origin = labelQueue[0].pos;
+	for (size_t i = 0; i < labelQueue.size(); ++i) {
+		const ItemLabel &label = labelQueue[i];
+		const ResolvedLabel &resolved = resolvedLabels[i];
+		if (resolved.id != label.id || resolved.width != label.width || resolved.offset != label.pos - origin)
+			return false;
+	}
+	return true;
+}
+
+void ResolveLabelOverlaps(int labelHeight)
+{
+	const Point origin = labelQueue[0].pos;
+	resolvedLabels.clear();
+	resolvedLabelHeight = labelHeight;
+	for (const ItemLabel &label : labelQueue) {
+		resolvedLabels.push_back(ResolvedLabel { label.id, label.width, label.pos - origin, 0 });
+	}
 
+	UsedX usedX;
 	for (unsigned i = 0; i < labelQueue.size(); ++i) {
 		usedX.clear();
 
@@ -184,6 +229,28 @@ void DrawItemNameLabels(const Surface &out)
 				}
 			}
 		} while (!canShow);
+		resolvedLabels[i].shiftX = labelQueue[i].pos.x - (origin.x + resolvedLabels[i].offset.deltaX);
+	}
+}
+
+} // namespace
+
+void DrawItemNameLabels(const Surface &out)
+{
+	DVL_PROFILE_ZONE("DrawItemNameLabels");
+	const Surface clippedOut = out.subregionY(0, gnViewportHeight);
+	isLabelHighlighted = false;
+	if (labelQueue.empty())
+		return;
+	const int labelHeight = LabelHeight();
+	const int labelMarginTop = TextMarginTop();
+
+	if (CanReuseResolvedLabels(labelHeight)) {
+		for (size_t i = 0; i < labelQueue.size(); ++i) {
+			labelQueue[i].pos.x += resolvedLabels[i].shiftX;
+		}
+	} else {
+		ResolveLabelOverlaps(labelHeight);
 	}
 
 	for (const ItemLabel &label : labelQueue) {
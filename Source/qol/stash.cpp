@@ -1,6 +1,8 @@
 #include "qol/stash.h"
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <utility>
 
@@ -75,6 +77,49 @@ void AddItemToStashGrid(unsigned page, Point position, uint16_t stashListIndex,
 	for (const Point point : PointsInRectangle(Rectangle { position, itemSize })) {
 		Stash.stashGrids[page][point.x][point.y] = stashListIndex + 1;
 	}
+	Stash.InvalidatePage(page);
+}
+
+/** @brief Occupied cells of each column of a stash page, bit y stands for the cell in row y. */
+using StashColumnMasks = std::array<uint16_t, StashGridSize.width>;
+
+StashColumnMasks GetStashOccupancyMasks(const StashStruct::StashGrid &grid)
+{
+	StashColumnMasks occupied {};
+	for (int x = 0; x < StashGridSize.width; x++) {
+		for (int y = 0; y < StashGridSize.height; y++) {
+			if (grid[x][y] != 0)
+				occupied[x] |= 1 << y;
+		}
+	}
+	return occupied;
+}
+
+/**
+ * @brief Finds the first position, in the order items are auto-placed, where an item of the given size fits.
+ */
+std::optional<Point> FindFreeStashPosition(const StashColumnMasks &occupied, Size itemSize)
+{
+	const auto columnShape = static_cast<uint16_t>((1 << itemSize.height) - 1);
+	for (auto stashPosition : PointsInRectangle(Rectangle { { 0, 0 }, Size { 10 - (itemSize.width - 1), 10 - (itemSize.height - 1) } })) {
+		// Check that all needed slots are free
+		const auto shape = static_cast<uint16_t>(columnShape << stashPosition.y);
+		bool isSpaceFree = true;
+		for (int x = stashPosition.x; x < stashPosition.x + itemSize.width; x++) {
+			if ((occupied[x] & shape) != 0) {
+				isSpaceFree = false;
+				break;
+			}
+		}
+		if (isSpaceFree)
+			return stashPosition;
+	}
+	return {};
+}
+
+size_t GetPageSummaryIndex(Size itemSize)
+{
+	return static_cast<size_t>(((itemSize.width - 1) * StashStruct::MaxSummarizedItemSize.height) + itemSize.height - 1);
 }
 
 std::optional<Point> FindTargetSlotUnderItemCursor(Point cursorPosition, Size itemSize)
@@ -553,9 +598,36 @@ void StashStruct::RemoveStashItem(StashStruct::StashCell iv)
 		}
 	}
 	stashList.pop_back();
+	Stash.InvalidatePage(GetPage());
 	Stash.dirty = true;
 }
 
+std::optional<Point> StashStruct::FindFreePosition(unsigned page, Size itemSize)
+{
+	const auto gridIt = stashGrids.find(page);
+	if (gridIt == stashGrids.end())
+		return FindFreeStashPosition({}, itemSize);
+	if (itemSize.width > MaxSummarizedItemSize.width || itemSize.height > MaxSummarizedItemSize.height)
+		return FindFreeStashPosition(GetStashOccupancyMasks(gridIt->second), itemSize);
+
+	auto [summaryIt, inserted] = pageSummaries.try_emplace(page);
+	if (inserted) {
+		const StashColumnMasks occupied = GetStashOccupancyMasks(gridIt->second);
+		for (int width = 1; width <= MaxSummarizedItemSize.width; width++) {
+			for (int height = 1; height <= MaxSummarizedItemSize.height; height++) {
+				const Size size { width, height };
+				summaryIt->second[GetPageSummaryIndex(size)] = FindFreeStashPosition(occupied, size);
+			}
+		}
+	}
+	return summaryIt->second[GetPageSummaryIndex(itemSize)];
+}
+
+void StashStruct::InvalidatePage(unsigned page)
+{
+	pageSummaries.erase(page);
+}
+
 void StashStruct::SetPage(unsigned newPage)
 {
 	page = std::min(newPage, LastStashPage);
@@ -709,28 +781,17 @@ bool AutoPlaceItemInStash(const Item &item, bool persistItem)
 		// Wrap around if needed
 		if (pageIndex >= CountStashPages)
 			pageIndex -= CountStashPages;
-		// Search all possible position in stash grid
-		for (auto stashPosition : PointsInRectangle(Rectangle { { 0, 0 }, Size { 10 - (itemSize.width - 1), 10 - (itemSize.height - 1) } })) {
-			// Check that all needed slots are free
-			bool isSpaceFree = true;
-			for (auto itemPoint : PointsInRectangle(Rectangle { stashPosition, itemSize })) {
-				const uint16_t iv = Stash.stashGrids[pageIndex][itemPoint.x][itemPoint.y];
-				if (iv != 0) {
-					isSpaceFree = false;
-					break;
-				}
-			}
-			if (!isSpaceFree)
-				continue;
-			if (persistItem) {
-				Stash.stashList.push_back(item);
-				const auto stashIndex = static_cast<uint16_t>(Stash.stashList.size() - 1);
-				Stash.stashList[stashIndex].position = stashPosition + Displacement { 0, itemSize.height - 1 };
-				AddItemToStashGrid(pageIndex, stashPosition, stashIndex, itemSize);
-				Stash.dirty = true;
-			}
-			return true;
+		const std::optional<Point> stashPosition = Stash.FindFreePosition(pageIndex, itemSize);
+		if (!stashPosition)
+			continue;
+		if (persistItem) {
+			Stash.stashList.push_back(item);
+			const auto stashIndex = static_cast<uint16_t>(Stash.stashList.size() - 1);
+			Stash.stashList[stashIndex].position = *stashPosition + Displacement { 0, itemSize.height - 1 };
+			AddItemToStashGrid(pageIndex, *stashPosition, stashIndex, itemSize);
+			Stash.dirty = true;
 		}
+		return true;
 	}
 
 	return false;
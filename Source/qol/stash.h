@@ -5,13 +5,16 @@
  */
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <optional>
 #include <vector>
 
 #include <ankerl/unordered_dense.h>
 
 #include "engine/point.hpp"
 #include "engine/points_in_rectangle_range.hpp"
+#include "engine/size.hpp"
 #include "items.h"
 #include "utils/attributes.h"
 
@@ -62,9 +65,25 @@ public:
 	/** @brief Updates _iStatFlag for all stash items. */
 	void RefreshItemStatFlags();
 
+	/**
+	 * @brief Returns the first position on the given page, in the order items are auto-placed, where an item of the given size fits.
+	 * @param page The stash page index, pages that don't exist yet are empty.
+	 * @param itemSize Size of item
+	 */
+	std::optional<Point> FindFreePosition(unsigned page, Size itemSize);
+
+	/** @brief Must be called after changing the cells of a page, so that FindFreePosition looks at the page again. */
+	void InvalidatePage(unsigned page);
+
+	/** @brief Items up to this size have their free positions kept per page, all item graphics fit in it. */
+	static constexpr Size MaxSummarizedItemSize { 2, 3 };
+
 private:
 	/** Current Page */
 	unsigned page;
+
+	/** @brief The first free position of each page for each item size up to MaxSummarizedItemSize. */
+	ankerl::unordered_dense::map<unsigned, std::array<std::optional<Point>, MaxSummarizedItemSize.width * MaxSummarizedItemSize.height>> pageSummaries;
 };
 
 constexpr Point InvalidStashPoint { -1, -1 };
@@ -226,6 +226,7 @@ void FreeVisualStoreGFX()
 
 void OpenVisualStore(VisualStoreVendor vendor)
 {
+	StockTownStores();
 	IsVisualStoreOpen = true;
 	invflag = true; // Open inventory panel alongside
 
@@ -236,12 +237,7 @@ void OpenVisualStore(VisualStoreVendor vendor)
 	pcursstoreitem = -1;
 	pcursstorebtn = -1;
 
-	// Refresh item stat flags for current player
-	std::span<Item> items = GetVisualStoreItems();
-	for (Item &item : items) {
-		item._iStatFlag = MyPlayer->CanUseItem(item);
-	}
-
+	RefreshVisualStoreItemStatFlags();
 	RefreshVisualStoreLayout();
 
 	// Initialize controller focus to the visual store grid
@@ -270,13 +266,15 @@ void SetVisualStoreTab(VisualStoreTab tab)
 	pcursstoreitem = -1;
 	pcursstorebtn = -1;
 
-	// Refresh item stat flags
-	std::span<Item> items = GetVisualStoreItems();
-	for (Item &item : items) {
+	RefreshVisualStoreItemStatFlags();
+	RefreshVisualStoreLayout();
+}
+
+void RefreshVisualStoreItemStatFlags()
+{
+	for (Item &item : GetVisualStoreItems()) {
 		item._iStatFlag = MyPlayer->CanUseItem(item);
 	}
-
-	RefreshVisualStoreLayout();
 }
 
 void VisualStoreNextPage()
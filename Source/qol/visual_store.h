@@ -82,6 +82,11 @@ void CloseVisualStore();
  */
 void SetVisualStoreTab(VisualStoreTab tab);
 
+/**
+ * @brief Updates _iStatFlag for the items on display, so that the ones the player can't use are drawn in red.
+ */
+void RefreshVisualStoreItemStatFlags();
+
 /**
  * @brief Navigate to the next page of store items.
  */
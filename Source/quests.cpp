@@ -61,6 +61,14 @@ int WaterDone;
 quest_id EncounteredQuests[MAXQUESTS];
 /** Overall number of EncounteredQuests entries */
 int EncounteredQuestCount;
+
+struct QuestLogTitle {
+	std::string_view text;
+	int width;
+};
+
+/** The translated titles of `EncounteredQuests`, laid out once when the quest log opens rather than every frame it is drawn */
+QuestLogTitle EncounteredQuestTitles[MAXQUESTS];
 /** First (nonselectable) finished quest in list */
 int FirstFinishedQuest;
 /** Currently selected quest list item */
@@ -98,29 +106,29 @@ void DrawSkelKing(quest_id q, Point position)
 
 void DrawWarLord(Point position)
 {
-	auto dunData = LoadFileInMem<uint16_t>("levels\\l4data\\warlord2.dun");
+	const uint16_t *dunData = LoadFileInArena<uint16_t>("levels\\l4data\\warlord2.dun", LevelArena);
 
-	SetPiece = { position, GetDunSize(dunData.get()) };
+	SetPiece = { position, GetDunSize(dunData) };
 
-	PlaceDunTiles(dunData.get(), position, 6);
+	PlaceDunTiles(dunData, position, 6);
 }
 
 void DrawSChamber(quest_id q, Point position)
 {
-	auto dunData = LoadFileInMem<uint16_t>("levels\\l2data\\bonestr1.dun");
+	const uint16_t *dunData = LoadFileInArena<uint16_t>("levels\\l2data\\bonestr1.dun", LevelArena);
 
-	SetPiece = { position, GetDunSize(dunData.get()) };
+	SetPiece = { position, GetDunSize(dunData) };
 
-	PlaceDunTiles(dunData.get(), position, 3);
+	PlaceDunTiles(dunData, position, 3);
 
 	Quests[q].position = position.megaToWorld() + Displacement { 6, 7 };
 }
 
 void DrawLTBanner(Point position)
 {
-	auto dunData = LoadFileInMem<uint16_t>("levels\\l1data\\banner1.dun");
+	const uint16_t *dunData = LoadFileInArena<uint16_t>("levels\\l1data\\banner1.dun", LevelArena);
 
-	const WorldTileSize size = GetDunSize(dunData.get());
+	const WorldTileSize size = GetDunSize(dunData);
 
 	SetPiece = { position, size };
 
@@ -147,11 +155,11 @@ void DrawBlind(Point position)
 
 void DrawBlood(Point position)
 {
-	auto dunData = LoadFileInMem<uint16_t>("levels\\l2data\\blood2.dun");
+	const uint16_t *dunData = LoadFileInArena<uint16_t>("levels\\l2data\\blood2.dun", LevelArena);
 
-	SetPiece = { position, GetDunSize(dunData.get()) };
+	SetPiece = { position, GetDunSize(dunData) };
 
-	PlaceDunTiles(dunData.get(), position, 0);
+	PlaceDunTiles(dunData, position, 0);
 }
 
 int QuestLogMouseToEntry()
@@ -170,9 +178,10 @@ int QuestLogMouseToEntry()
 	return -1;
 }
 
-void PrintQLString(const Surface &out, int x, int y, std::string_view str, bool marked, bool disabled = false)
+void PrintQLString(const Surface &out, int x, int y, const QuestLogTitle &title, bool marked, bool disabled = false)
 {
-	const int width = GetLineWidth(str);
+	const std::string_view str = title.text;
+	const int width = title.width;
 	x += std::max((257 - width) / 2, 0);
 	if (marked) {
 		ClxDraw(out, GetPanelPosition(UiPanels::Quest, { x - 20, y + 13 }), (*pSPentSpn2Cels)[PentSpn2Spin()]);
@@ -774,7 +783,7 @@ void DrawQuestLog(const Surface &out)
 		if (i == FirstFinishedQuest) {
 			y += FinishedQuestOffset;
 		}
-		PrintQLString(out, x, y, _(QuestsData[EncounteredQuests[i]]._qlstr), i == SelectedQuest, i >= FirstFinishedQuest);
+		PrintQLString(out, x, y, EncounteredQuestTitles[i], i == SelectedQuest, i >= FirstFinishedQuest);
 		y += LineSpacing;
 	}
 }
@@ -804,6 +813,11 @@ void StartQuestlog()
 	std::sort(&EncounteredQuests[0], &EncounteredQuests[FirstFinishedQuest], sortQuestIdx);
 	std::sort(&EncounteredQuests[FirstFinishedQuest], &EncounteredQuests[EncounteredQuestCount], sortQuestIdx);
 
+	for (int i = 0; i < EncounteredQuestCount; i++) {
+		const std::string_view title = _(QuestsData[EncounteredQuests[i]]._qlstr);
+		EncounteredQuestTitles[i] = { title, GetLineWidth(title) };
+	}
+
 	const bool twoBlocks = FirstFinishedQuest != 0 && FirstFinishedQuest < EncounteredQuestCount;
 
 	ListYOffset = 0;
@@ -0,0 +1,204 @@
+/**
+ * @file relay/main.cpp
+ *
+ * Standalone server that hosts TCP games for players that can't host them themselves.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <expected.hpp>
+
+#include "dvlnet/tcp_server.h"
+#include "utils/console.h"
+#include "utils/log.hpp"
+#include "utils/parse_int.hpp"
+
+namespace devilution {
+
+[[noreturn]] void app_fatal(std::string_view str)
+{
+	LogCritical("{}", str);
+	std::exit(1);
+}
+
+[[noreturn]] void ErrDlg(const char *title, std::string_view error, std::string_view logFilePath, int logLineNr)
+{
+	LogCritical("{}: {}\n{}:{}", title, error, logFilePath, logLineNr);
+	std::exit(1);
+}
+
+#ifdef _DEBUG
+[[noreturn]] void assert_fail(int nLineNo, const char *pszFile, const char *pszFail)
+{
+	LogCritical("Assertion failed in {}:{}: {}", pszFile, nLineNo, pszFail);
+	std::abort();
+}
+#endif
+
+namespace {
+
+struct RelayOptions {
+	std::string bindAddress = "0.0.0.0";
+	unsigned short firstPort = 6112;
+	unsigned numGames = 1;
+	unsigned numThreads = std::max(std::thread::hardware_concurrency(), 1U);
+	std::optional<std::string> password;
+};
+
+/**
+ * @brief A thread with its own io_context and the games that run on it.
+ *
+ * Games are never shared between workers, so the handlers of a game never run concurrently.
+ */
+class RelayWorker {
+public:
+	explicit RelayWorker(const std::optional<std::string> &password)
+	    : pktfty_(password ? std::make_unique<net::packet_factory>(*password) : std::make_unique<net::packet_factory>())
+	    , errorCheckTimer_(ioc_)
+	{
+	}
+
+	void AddGame(const std::string &bindAddress, unsigned short port)
+	{
+		games_.push_back({ port, std::make_unique<net::tcp_server>(ioc_, bindAddress, port, *pktfty_) });
+	}
+
+	void Start()
+	{
+		StartErrorCheck();
+		thread_ = std::thread([this]() { ioc_.run(); });
+	}
+
+	void Join()
+	{
+		thread_.join();
+	}
+
+private:
+	struct Game {
+		unsigned short port;
+		std::unique_ptr<net::tcp_server> server;
+	};
+
+	void StartErrorCheck()
+	{
+		errorCheckTimer_.expires_after(std::chrono::seconds(1));
+		errorCheckTimer_.async_wait([this](const asio::error_code &ec) {
+			if (ec)
+				return;
+			for (Game &game : games_) {
+				const tl::expected<void, net::PacketError> result = game.server->CheckIoHandlerError();
+				if (!result.has_value())
+					LogError("Game on port {}: {}", game.port, result.error().what());
+			}
+			StartErrorCheck();
+		});
+	}
+
+	asio::io_context ioc_;
+	std::unique_ptr<net::packet_factory> pktfty_;
+	std::vector<Game> games_;
+	asio::steady_timer errorCheckTimer_;
+	std::thread thread_;
+};
+
+void PrintHelp()
+{
+	printInConsole("Usage: devilutionx-relay [options]\n\n");
+	printInConsole("    --bind <address>    Address to listen on (default 0.0.0.0)\n");
+	printInConsole("    --port <port>       Port of the first game (default 6112)\n");
+	printInConsole("    --games <count>     Number of games, game N listens on port + N (default 1)\n");
+	printInConsole("    --threads <count>   Number of worker threads (default: number of cores)\n");
+	printInConsole("    --password <pw>     Password of the games, without it the games are public\n");
+}
+
+bool ParseCountFlag(std::string_view flag, const char *value, unsigned &count)
+{
+	const ParseIntResult<unsigned> parsed = ParseInt<unsigned>(value, 1, 65535);
+	if (!parsed.has_value()) {
+		printfInConsole("%.*s must be a number between 1 and 65535\n", static_cast<int>(flag.size()), flag.data());
+		return false;
+	}
+	count = *parsed;
+	return true;
+}
+
+std::optional<RelayOptions> ParseRelayFlags(int argc, char **argv)
+{
+	RelayOptions options;
+	for (int i = 1; i < argc; i++) {
+		const std::string_view arg = argv[i];
+		if (arg == "-h" || arg == "--help") {
+			PrintHelp();
+			std::exit(0);
+		}
+		if (i + 1 == argc) {
+			printfInConsole("unrecognized or incomplete option '%s'\n", argv[i]);
+			return std::nullopt;
+		}
+		const char *value = argv[++i];
+		if (arg == "--bind") {
+			options.bindAddress = value;
+		} else if (arg == "--port") {
+			unsigned port;
+			if (!ParseCountFlag(arg, value, port))
+				return std::nullopt;
+			options.firstPort = static_cast<unsigned short>(port);
+		} else if (arg == "--games") {
+			if (!ParseCountFlag(arg, value, options.numGames))
+				return std::nullopt;
+		} else if (arg == "--threads") {
+			if (!ParseCountFlag(arg, value, options.numThreads))
+				return std::nullopt;
+		} else if (arg == "--password") {
+			options.password = value;
+		} else {
+			printfInConsole("unrecognized option '%s'\n", argv[i - 1]);
+			return std::nullopt;
+		}
+	}
+	if (options.firstPort + options.numGames - 1 > 65535) {
+		printInConsole("--port + --games exceeds the highest port\n");
+		return std::nullopt;
+	}
+	return options;
+}
+
+int RelayMain(int argc, char **argv)
+{
+	const std::optional<RelayOptions> options = ParseRelayFlags(argc, argv);
+	if (!options)
+		return 64;
+
+	// The games are the lobby directory, players pick a game by connecting to its port.
+	const unsigned numWorkers = std::min(options->numThreads, options->numGames);
+	std::vector<std::unique_ptr<RelayWorker>> workers;
+	for (unsigned i = 0; i < numWorkers; i++)
+		workers.push_back(std::make_unique<RelayWorker>(options->password));
+	for (unsigned i = 0; i < options->numGames; i++)
+		workers[i % numWorkers]->AddGame(options->bindAddress, static_cast<unsigned short>(options->firstPort + i));
+
+	Log("Relaying {} {} games on {} ports {}-{} with {} threads", options->numGames, options->password ? "private" : "public",
+	    options->bindAddress, options->firstPort, options->firstPort + options->numGames - 1, numWorkers);
+	for (const std::unique_ptr<RelayWorker> &worker : workers)
+		worker->Start();
+	for (const std::unique_ptr<RelayWorker> &worker : workers)
+		worker->Join();
+	return 0;
+}
+
+} // namespace
+
+} // namespace devilution
+
+int main(int argc, char **argv)
+{
+	return devilution::RelayMain(argc, argv);
+}
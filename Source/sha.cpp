@@ -17,16 +17,15 @@ uint32_t SHA1CircularShift(uint32_t word, size_t bits)
 {
 	// The SHA-like algorithm as originally implemented treated word as a signed value and used arithmetic right shifts
 	//  (sign-extending). This results in the high 32-`bits` bits being set to 1.
-	if ((word & (1 << 31)) != 0)
-		return (0xFFFFFFFF << bits) | (word >> (32 - bits));
-	return (word << bits) | (word >> (32 - bits));
+	// Shifting the signed value does the same without a branch on the sign, which is unpredictable for hash state.
+	return (word << bits) | static_cast<uint32_t>(static_cast<int32_t>(word) >> (32 - bits));
 }
 
-void SHA1ProcessMessageBlock(SHA1Context *context)
+void SHA1ProcessMessageBlock(SHA1Context *context, const uint32_t *data)
 {
 	std::uint32_t w[80];
 
-	memcpy(w, context->buffer, BlockSize * sizeof(uint32_t));
+	memcpy(w, data, BlockSize * sizeof(uint32_t));
 	for (int i = 16; i < 80; i++) {
 		w[i] = w[i - 16] ^ w[i - 14] ^ w[i - 8] ^ w[i - 3];
 	}
@@ -89,8 +88,7 @@ void SHA1Result(SHA1Context &context, uint32_t messageDigest[SHA1HashSize])
 
 void SHA1Calculate(SHA1Context &context, const uint32_t data[BlockSize])
 {
-	memcpy(&context.buffer[0], data, BlockSize * sizeof(uint32_t));
-	SHA1ProcessMessageBlock(&context);
+	SHA1ProcessMessageBlock(&context, data);
 }
 
 } // namespace devilution
@@ -0,0 +1,158 @@
+/**
+ * @file state_hash.cpp
+ *
+ * Implementation of the world state hashes that the players compare to detect desyncs.
+ */
+#include "state_hash.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "msg.h"
+#include "multi.h"
+#include "player.h"
+#include "quests.h"
+#include "utils/log.hpp"
+
+namespace devilution {
+
+namespace {
+
+struct StateHashRecord {
+	bool valid;
+	uint32_t gameLoop;
+	StateHash hash;
+};
+
+/** @brief Local hashes of the last few exchanges, so that hashes that are delayed in transit can still be compared. */
+constexpr size_t StateHashHistorySize = 8;
+
+std::array<StateHashRecord, StateHashHistorySize> LocalHashes;
+size_t NextLocalHash;
+/** @brief The last hash of each player that arrived before the local hash of the same game loop was taken. */
+std::array<StateHashRecord, MAX_PLRS> PendingHashes;
+uint32_t Mismatches;
+
+/** @brief The first `NetProtocolVersion` that knows `CMD_STATEHASH`, older builds would drop the rest of the packet. */
+constexpr uint8_t StateHashProtocolVersion = 1;
+
+void Compare(const Player &player, const StateHashRecord &local, const StateHashRecord &remote)
+{
+	for (size_t i = 0; i < NumStateHashClasses; i++) {
+		// Compared on arrival instead, see CompareStateHash
+		if (static_cast<StateHashClass>(i) == StateHashClass::Players)
+			continue;
+		if (local.hash.classes[i] == remote.hash.classes[i])
+			continue;
+		Mismatches++;
+		LogWarn("State hash of {} differs at game loop {}, first in: {}", player.name(), local.gameLoop, StateHashClassName(static_cast<StateHashClass>(i)));
+		return;
+	}
+}
+
+} // namespace
+
+std::string_view StateHashClassName(StateHashClass hashClass)
+{
+	switch (hashClass) {
+	case StateHashClass::Players:
+		return "players";
+	case StateHashClass::Quests:
+		return "quests";
+	case StateHashClass::Deltas:
+		return "deltas";
+	}
+	return "";
+}
+
+uint64_t ComputePlayerStateHash(const Player &player)
+{
+	StateHasher hasher;
+	hasher.add(player.getId());
+	hasher.add(player.getCharacterLevel());
+	hasher.add(static_cast<uint64_t>(static_cast<uint32_t>(player._pBaseStr)));
+	hasher.add(static_cast<uint64_t>(static_cast<uint32_t>(player._pBaseMag)));
+	hasher.add(static_cast<uint64_t>(static_cast<uint32_t>(player._pBaseDex)));
+	hasher.add(static_cast<uint64_t>(static_cast<uint32_t>(player._pBaseVit)));
+	return hasher.value();
+}
+
+StateHash ComputeStateHash()
+{
+	StateHash hash;
+
+	hash.classes[static_cast<size_t>(StateHashClass::Players)] = ComputePlayerStateHash(*MyPlayer);
+
+	StateHasher quests;
+	for (const Quest &quest : Quests) {
+		quests.add(static_cast<uint64_t>(quest._qactive));
+		quests.add(quest._qlog ? 1 : 0);
+		quests.add(quest._qvar1);
+		quests.add(quest._qvar2);
+	}
+	hash.classes[static_cast<size_t>(StateHashClass::Quests)] = quests.value();
+
+	hash.classes[static_cast<size_t>(StateHashClass::Deltas)] = ComputeDeltaHash();
+
+	return hash;
+}
+
+void UpdateStateHash()
+{
+	if (!gbIsMultiplayer || sgGameInitInfo.protocolVersion < StateHashProtocolVersion || sgdwGameLoops % StateHashInterval != 0)
+		return;
+
+	const StateHashRecord &previous = LocalHashes[(NextLocalHash + LocalHashes.size() - 1) % LocalHashes.size()];
+	if (previous.valid && previous.gameLoop == sgdwGameLoops)
+		return;
+
+	StateHashRecord &local = LocalHashes[NextLocalHash];
+	NextLocalHash = (NextLocalHash + 1) % LocalHashes.size();
+	local = { true, sgdwGameLoops, ComputeStateHash() };
+	NetSendCmdStateHash(local.gameLoop, local.hash);
+
+	for (size_t playerId = 0; playerId < Players.size() && playerId < PendingHashes.size(); playerId++) {
+		StateHashRecord &pending = PendingHashes[playerId];
+		if (!pending.valid || pending.gameLoop != local.gameLoop)
+			continue;
+		Compare(Players[playerId], local, pending);
+		pending.valid = false;
+	}
+}
+
+void CompareStateHash(const Player &player, uint32_t gameLoop, const StateHash &hash)
+{
+	// The sender's level and stat changes were sent before the hash, so they have all arrived by now
+	if (hash.classes[static_cast<size_t>(StateHashClass::Players)] != ComputePlayerStateHash(player)) {
+		Mismatches++;
+		LogWarn("State hash of {} differs at game loop {}, first in: {}", player.name(), gameLoop, StateHashClassName(StateHashClass::Players));
+		return;
+	}
+
+	const StateHashRecord remote { true, gameLoop, hash };
+	for (const StateHashRecord &local : LocalHashes) {
+		if (local.valid && local.gameLoop == gameLoop) {
+			Compare(player, local, remote);
+			return;
+		}
+	}
+	if (player.getId() < PendingHashes.size())
+		PendingHashes[player.getId()] = remote;
+}
+
+uint32_t GetStateHashMismatches()
+{
+	return Mismatches;
+}
+
+void ResetStateHashes()
+{
+	LocalHashes = {};
+	NextLocalHash = 0;
+	PendingHashes = {};
+	Mismatches = 0;
+}
+
+} // namespace devilution
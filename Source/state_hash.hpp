@@ -0,0 +1,106 @@
+/**
+ * @file state_hash.hpp
+ *
+ * Interface of the world state hashes that the players compare to detect desyncs.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "engine/point.hpp"
+
+namespace devilution {
+
+struct Player;
+
+enum class StateHashClass : uint8_t {
+	Players,
+	Quests,
+	Deltas,
+};
+
+constexpr size_t NumStateHashClasses = 3;
+
+std::string_view StateHashClassName(StateHashClass hashClass);
+
+struct StateHash {
+	/**
+	 * @brief One hash per `StateHashClass`, so that a mismatch can name the kind of state that differs.
+	 *
+	 * `StateHashClass::Players` only covers the sender's own hero, see `ComputePlayerStateHash`.
+	 */
+	std::array<uint64_t, NumStateHashClasses> classes;
+};
+
+/**
+ * @brief Hash of a sequence of 64-bit values, FNV-1a over words with an extra shift to mix the high bits down.
+ */
+class StateHasher {
+public:
+	void add(uint64_t value)
+	{
+		hash_ = (hash_ ^ value) * 0x100000001B3ULL;
+		hash_ ^= hash_ >> 29;
+	}
+
+	void add(Point position)
+	{
+		add(static_cast<uint64_t>(static_cast<uint32_t>(position.x)) | (static_cast<uint64_t>(static_cast<uint32_t>(position.y)) << 32));
+	}
+
+	[[nodiscard]] uint64_t value() const
+	{
+		return hash_;
+	}
+
+private:
+	uint64_t hash_ = 0xCBF29CE484222325ULL;
+};
+
+/** @brief Game loops between two exchanges of the state hash. */
+constexpr uint32_t StateHashInterval = 64;
+
+/**
+ * @brief Hashes the level and base stats of a hero.
+ *
+ * Only the hero's own client changes these, the others learn about it through `CMD_PLRLEVEL` and `CMD_SETSTR` and co.,
+ * so each client hashes its own hero and the others compare that with their copy when the hash arrives.
+ * The experience of other players' heroes is never sent, so it isn't included.
+ */
+uint64_t ComputePlayerStateHash(const Player &player);
+
+/**
+ * @brief Hashes the state that every player keeps the same way: the local hero's level and stats, the quests and the level deltas.
+ *
+ * The positions, modes and hit points of monsters and players, or the slots entities occupy, depend on
+ * when each player received the last sync messages, so they aren't included.
+ */
+StateHash ComputeStateHash();
+
+/**
+ * @brief Hashes the world and sends the hash to the other players every `StateHashInterval` game loops.
+ *
+ * Called after every game tick, does nothing in single player games or when the host doesn't know `CMD_STATEHASH`.
+ * The game loop counter doesn't advance on every tick, each of its values is only hashed once.
+ */
+void UpdateStateHash();
+
+/**
+ * @brief Compares the state hash another player sent with the local one of the same game loop.
+ *
+ * Logs the first class of state that differs. The sender's hero is compared right away, with the local copy of it.
+ * The rest is compared with the local hash of the same game loop, hashes that arrive before
+ * that one was taken are kept until it is.
+ */
+void CompareStateHash(const Player &player, uint32_t gameLoop, const StateHash &hash);
+
+/** @brief Number of state hashes of other players that didn't match the local one. */
+uint32_t GetStateHashMismatches();
+
+/** @brief Forgets the hashes of previous game loops, e.g. when starting a new game. */
+void ResetStateHashes();
+
+} // namespace devilution
@@ -143,6 +143,18 @@ namespace {
 /** The current towner being interacted with */
 _talker_id TownerId;
 
+/** @brief What SetupTownStores stocks the stores with, kept until a store is first needed. */
+struct PendingTownStores {
+	/** State of the game RNG when the town was entered */
+	uint32_t seed;
+	/** Item level of the smith, witch and healer stock */
+	int itemLevel;
+	/** Item level of Wirt's item */
+	int boyItemLevel;
+};
+
+std::optional<PendingTownStores> PendingStores;
+
 /** Is the current dialog full size */
 bool IsTextFullSize;
 
@@ -2157,6 +2169,8 @@ void InitStores()
 
 	BoyItem.clear();
 	BoyItemLevel = 0;
+
+	PendingStores = std::nullopt;
 }
 
 void SetupTownStores()
@@ -2173,11 +2187,25 @@ void SetupTownStores()
 	}
 
 	l = std::clamp(l + 2, 6, 16);
-	SpawnSmith(l);
-	SpawnWitch(l);
-	SpawnHealer(l);
-	SpawnBoy(myPlayer.getCharacterLevel());
-	SpawnPremium(myPlayer);
+	PendingStores = PendingTownStores { GetLCGEngineState(), l, myPlayer.getCharacterLevel() };
+}
+
+void StockTownStores()
+{
+	if (!PendingStores)
+		return;
+	const PendingTownStores pending = *PendingStores;
+	PendingStores = std::nullopt;
+
+	// The stores are stocked from the RNG state the town was entered with, only the hero may have changed since, see SetupTownStores
+	const uint32_t currentSeed = GetLCGEngineState();
+	SetRndSeed(pending.seed);
+	SpawnSmith(pending.itemLevel);
+	SpawnWitch(pending.itemLevel);
+	SpawnHealer(pending.itemLevel);
+	SpawnBoy(pending.boyItemLevel);
+	SpawnPremium(*MyPlayer);
+	SetRndSeed(currentSeed);
 }
 
 void FreeStoreMem()
@@ -2297,6 +2325,7 @@ void StartStore(TalkID s)
 	CloseGoldDrop();
 	ClearSText(0, NumStoreLines);
 	ReleaseStoreBtn();
+	StockTownStores();
 
 	// Fire StoreOpened Lua event for main store entries
 	if (const char *name = TownerNameForTalkID(s); name != nullptr)
@@ -161,9 +161,18 @@ void AddStoreHoldRepair(Item *itm, int8_t i);
 /** Clears premium items sold by Griswold and Wirt. */
 void InitStores();
 
-/** Spawns items sold by vendors, including premium items sold by Griswold and Wirt. */
+/**
+ * @brief Prepares the items sold by vendors, including premium items sold by Griswold and Wirt.
+ *
+ * The items are only spawned by StockTownStores, when a store is first opened or the hero leaves the town.
+ * The RNG state and item levels are taken on entering the town. The hero's class, attributes and items,
+ * which every vendor's stock and Griswold's and Wirt's premium items depend on, are read when stocking.
+ */
 void SetupTownStores();
 
+/** @brief Spawns the items prepared by SetupTownStores, if they haven't been spawned yet. */
+void StockTownStores();
+
 void FreeStoreMem();
 
 void PrintSString(const Surface &out, int margin, int line, std::string_view text, UiFlags flags, int price = 0, int cursId = -1, bool cursIndent = false);
@@ -74,6 +74,8 @@ SmackerHandle SVidHandle;
 std::unique_ptr<uint8_t[]> SVidFrameBuffer;
 SDLPaletteUniquePtr SVidPalette;
 SDLSurfaceUniquePtr SVidSurface;
+/** @brief The frame converted to the window's format for scaling, reused for every frame of the video. */
+SDLSurfaceUniquePtr SVidConvertedSurface;
 
 // The end of the current frame (time in SMK time units from the start of the program).
 uint64_t SVidFrameEnd;
@@ -233,6 +235,7 @@ bool BlitFrame()
 			Log("{}", SDL_GetError());
 			return false;
 		}
+		OutputSurfaceUpdated();
 	} else
 #endif
 	{
@@ -278,16 +281,27 @@ bool BlitFrame()
 		} else {
 			// The source surface is always 8-bit, and the output surface is never 8-bit in this branch.
 			// We must convert to the output format before calling SDL_BlitScaled.
+			// The converted surface is only allocated for the first frame, later frames are blitted into it.
+			if (SVidConvertedSurface == nullptr) {
 #ifdef USE_SDL1
-			SDLSurfaceUniquePtr converted = SDLWrap::ConvertSurface(SVidSurface.get(), ghMainWnd->format, 0);
+				SVidConvertedSurface = SDLWrap::ConvertSurface(SVidSurface.get(), ghMainWnd->format, 0);
 #else
-			SDLSurfaceUniquePtr converted = SDLWrap::ConvertSurfaceFormat(SVidSurface.get(), wndFormat, 0);
+				SVidConvertedSurface = SDLWrap::ConvertSurfaceFormat(SVidSurface.get(), wndFormat, 0);
 #endif
+			} else if (
+#ifdef USE_SDL3
+			    !SDL_BlitSurface(SVidSurface.get(), nullptr, SVidConvertedSurface.get(), nullptr)
+#else
+			    SDL_BlitSurface(SVidSurface.get(), nullptr, SVidConvertedSurface.get(), nullptr) <= -1
+#endif
+			) {
+				ErrSdl();
+			}
 			if (
 #ifdef USE_SDL3
-			    SDL_BlitSurfaceScaled(converted.get(), nullptr, outputSurface, &outputRect, SDL_SCALEMODE_LINEAR)
+			    SDL_BlitSurfaceScaled(SVidConvertedSurface.get(), nullptr, outputSurface, &outputRect, SDL_SCALEMODE_LINEAR)
 #else
-			    SDL_BlitScaled(converted.get(), nullptr, outputSurface, &outputRect) <= -1
+			    SDL_BlitScaled(SVidConvertedSurface.get(), nullptr, outputSurface, &outputRect) <= -1
 #endif
 			) {
 				Log("{}", SDL_GetError());
@@ -430,6 +444,7 @@ bool SVidPlayBegin(const char *filename, int flags)
 
 	// Set the background to black.
 	SDL_FillSurfaceRect(GetOutputSurface(), nullptr, 0x000000);
+	OutputSurfaceUpdated();
 
 	// The buffer for the frame. It is not the same as the SDL surface because the SDL surface also has pitch padding.
 	SVidFrameBuffer = std::unique_ptr<uint8_t[]> { new uint8_t[static_cast<size_t>(SVidWidth * SVidHeight)] };
@@ -525,6 +540,7 @@ void SVidPlayEnd()
 		Smacker_Close(SVidHandle);
 
 	SVidPalette = nullptr;
+	SVidConvertedSurface = nullptr;
 	SVidSurface = nullptr;
 	SVidFrameBuffer = nullptr;
 
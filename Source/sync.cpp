@@ -5,6 +5,7 @@
  */
 #include <cstdint>
 
+#include <bitset>
 #include <limits>
 
 #include "levels/gendung.h"
@@ -25,6 +26,36 @@ uint16_t sgwLRU[MaxMonsters];
 int sgnSyncItem;
 int sgnSyncPInv;
 
+/** @brief The synced state of a monster that the other players can't tell apart from the last one sent. */
+struct MonsterSyncState {
+	Point position;
+	uint8_t enemy;
+	int32_t hitPoints;
+
+	bool operator==(const MonsterSyncState &) const = default;
+};
+
+/** @brief State of each monster as it was last sent, valid where `sgbMonsterSent` is set. */
+MonsterSyncState sgLastSentMonsters[MaxMonsters];
+std::bitset<MaxMonsters> sgbMonsterSent;
+/** @brief Monsters whose state differs from the one last sent, updated at the start of each sync. */
+std::bitset<MaxMonsters> sgbMonsterChanged;
+uint8_t sgnLastSyncLevel;
+
+/**
+ * @brief Added to the priority of monsters that haven't changed since they were last sent.
+ *
+ * They are only picked once all changed monsters are synced, but are still refreshed
+ * by the round robin in `SyncMonsterActive2` to correct monsters that drifted on other clients.
+ */
+constexpr uint32_t UnchangedMonsterPenalty = 0x10000;
+
+MonsterSyncState GetMonsterSyncState(const Monster &monster)
+{
+	// Only whole hit points are visible to the other players
+	return { monster.position.tile, encode_enemy(monster), monster.hitPoints >> 6 };
+}
+
 void SyncOneMonster()
 {
 	for (size_t i = 0; i < ActiveMonsterCount; i++) {
@@ -36,6 +67,7 @@ void SyncOneMonster()
 		} else if (sgwLRU[m] != 0) {
 			sgwLRU[m]--;
 		}
+		sgbMonsterChanged[m] = !sgbMonsterSent[m] || sgLastSentMonsters[m] != GetMonsterSyncState(monster);
 	}
 }
 
@@ -52,6 +84,8 @@ void SyncMonsterPos(TSyncMonster &monsterSync, int ndx)
 
 	sgnMonsterPriority[ndx] = 0xFFFF;
 	sgwLRU[ndx] = monster.activeForTicks == 0 ? 0xFFFF : 0xFFFE;
+	sgLastSentMonsters[ndx] = GetMonsterSyncState(monster);
+	sgbMonsterSent.set(ndx);
 }
 
 bool SyncMonsterActive(TSyncMonster &monsterSync)
@@ -61,8 +95,13 @@ bool SyncMonsterActive(TSyncMonster &monsterSync)
 
 	for (size_t i = 0; i < ActiveMonsterCount; i++) {
 		const unsigned m = ActiveMonsters[i];
-		if (sgnMonsterPriority[m] < lru && sgwLRU[m] < 0xFFFE) {
-			lru = sgnMonsterPriority[m];
+		if (sgwLRU[m] >= 0xFFFE)
+			continue;
+		uint32_t priority = sgnMonsterPriority[m];
+		if (!sgbMonsterChanged[m])
+			priority += UnchangedMonsterPenalty;
+		if (priority < lru) {
+			lru = priority;
 			ndx = ActiveMonsters[i];
 		}
 	}
@@ -249,6 +288,11 @@ size_t sync_all_monsters(std::byte *pbBuf, size_t dwMaxLen)
 	pHdr->bCmd = CMD_SYNCDATA;
 	pHdr->bLevel = GetLevelForMultiplayer(*MyPlayer);
 	pHdr->wLen = 0;
+	if (pHdr->bLevel != sgnLastSyncLevel) {
+		// Monster ids are reused on the new level
+		sgbMonsterSent.reset();
+		sgnLastSyncLevel = pHdr->bLevel;
+	}
 	SyncPlrInv(pHdr);
 	assert(dwMaxLen <= 0xffff);
 	SyncOneMonster();
@@ -321,6 +365,7 @@ void sync_init()
 {
 	sgnMonsters = static_cast<size_t>(16 * MyPlayerId);
 	memset(sgwLRU, 255, sizeof(sgwLRU));
+	sgbMonsterSent.reset();
 }
 
 } // namespace devilution
@@ -6,6 +6,10 @@
 
 #include "tables/itemdat.h"
 
+#include <array>
+#include <bit>
+#include <cassert>
+#include <span>
 #include <string_view>
 #include <vector>
 
@@ -14,6 +18,8 @@
 #include "data/file.hpp"
 #include "data/iterators.hpp"
 #include "data/record_reader.hpp"
+#include "data/table_cache.hpp"
+#include "items.h"
 #include "lua/lua_event.hpp"
 #include "tables/spelldat.h"
 #include "utils/str_cat.hpp"
@@ -35,6 +41,45 @@ std::vector<UniqueItem> UniqueItems;
 /** Contains unique item mapping IDs, with unique item indices assigned to them. This is used for loading saved games. */
 ankerl::unordered_dense::map<int32_t, int32_t> UniqueItemMappingIdsToIndices;
 
+namespace {
+
+/** The indices into `UniqueItems` grouped by `unique_base_item`, rebuilt whenever unique items are loaded. */
+std::vector<std::vector<int32_t>> UniqueItemsByBase;
+
+void IndexUniqueItemsByBase()
+{
+	UniqueItemsByBase.clear();
+	for (size_t i = 0; i < UniqueItems.size(); i++) {
+		const int baseItemId = UniqueItems[i].UIItemId;
+		if (baseItemId < 0)
+			continue;
+		if (static_cast<size_t>(baseItemId) >= UniqueItemsByBase.size())
+			UniqueItemsByBase.resize(baseItemId + 1);
+		UniqueItemsByBase[baseItemId].push_back(static_cast<int32_t>(i));
+	}
+}
+
+/** One list per `AffixItemType` flag. */
+using AffixesByItemType = std::array<std::vector<const PLStruct *>, 6>;
+
+/** The affixes of `ItemPrefixes` and `ItemSuffixes` grouped by item type, rebuilt whenever the affixes are loaded. */
+AffixesByItemType PrefixesByItemType;
+AffixesByItemType SuffixesByItemType;
+
+void IndexAffixesByItemType(const std::vector<PLStruct> &affixes, AffixesByItemType &index)
+{
+	for (size_t bit = 0; bit < index.size(); bit++) {
+		const auto type = static_cast<AffixItemType>(1 << bit);
+		index[bit].clear();
+		for (const PLStruct &affix : affixes) {
+			if (HasAnyOf(affix.PLIType, type))
+				index[bit].push_back(&affix);
+		}
+	}
+}
+
+} // namespace
+
 /** Contains the data related to each item prefix. */
 std::vector<PLStruct> ItemPrefixes;
 
@@ -605,6 +650,7 @@ void LoadItemDatFromFile(DataFile &dataFile, std::string_view filename, int32_t
 		++currentMappingId;
 	}
 	AllItemsList.shrink_to_fit();
+	InvalidateDropTables();
 }
 
 namespace {
@@ -663,6 +709,7 @@ void LoadUniqueItemDatFromFile(DataFile &dataFile, std::string_view filename, in
 		++currentMappingId;
 	}
 	UniqueItems.shrink_to_fit();
+	IndexUniqueItemsByBase();
 }
 
 namespace {
@@ -679,12 +726,21 @@ void LoadUniqueItemDat()
 	lua::UniqueItemDataLoaded();
 }
 
+constexpr auto TransferItemAffix = [](auto &stream, PLStruct &affix) {
+	stream(affix.PLName, affix.power, affix.PLMinLvl, affix.PLIType, affix.PLGOE, affix.PLChance, affix.PLOk,
+	    affix.minVal, affix.maxVal, affix.multVal);
+};
+
 void LoadItemAffixesDat(std::string_view filename, std::vector<PLStruct> &out)
 {
 	DataFile dataFile = DataFile::loadOrDie(filename);
-	dataFile.skipHeaderOrDie(filename);
 
 	out.clear();
+	const uint64_t cacheKey = GetTableCacheKey(dataFile, sizeof(PLStruct));
+	if (LoadTableFromCache(filename, cacheKey, out, TransferItemAffix))
+		return;
+
+	dataFile.skipHeaderOrDie(filename);
 	out.reserve(dataFile.numRecords());
 	for (DataFileRecord record : dataFile) {
 		RecordReader reader { record, filename };
@@ -701,16 +757,36 @@ void LoadItemAffixesDat(std::string_view filename, std::vector<PLStruct> &out)
 		reader.readInt("multVal", item.multVal);
 	}
 	out.shrink_to_fit();
+	SaveTableToCache(filename, cacheKey, std::span(out), TransferItemAffix);
 }
 
 } // namespace
 
+std::span<const int32_t> GetUniqueItemsOfBase(unique_base_item baseItemId)
+{
+	if (baseItemId < 0 || static_cast<size_t>(baseItemId) >= UniqueItemsByBase.size())
+		return {};
+	return UniqueItemsByBase[baseItemId];
+}
+
+std::span<const PLStruct *const> GetAffixesForItemType(const std::vector<PLStruct> &affixes, AffixItemType type)
+{
+	assert(std::has_single_bit(static_cast<uint8_t>(type)));
+	const AffixesByItemType &index = &affixes == &ItemPrefixes ? PrefixesByItemType : SuffixesByItemType;
+	const auto bit = static_cast<size_t>(std::countr_zero(static_cast<uint8_t>(type)));
+	if (bit >= index.size())
+		return {};
+	return index[bit];
+}
+
 void LoadItemData()
 {
 	LoadItemDat();
 	LoadUniqueItemDat();
 	LoadItemAffixesDat("txtdata\\items\\item_prefixes.tsv", ItemPrefixes);
 	LoadItemAffixesDat("txtdata\\items\\item_suffixes.tsv", ItemSuffixes);
+	IndexAffixesByItemType(ItemPrefixes, PrefixesByItemType);
+	IndexAffixesByItemType(ItemSuffixes, SuffixesByItemType);
 }
 
 std::string_view ItemTypeToString(ItemType itemType)
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 #include <string_view>
 #include <vector>
 
@@ -661,6 +662,18 @@ void LoadItemDatFromFile(DataFile &dataFile, std::string_view filename, int32_t
 void LoadUniqueItemDatFromFile(DataFile &dataFile, std::string_view filename, int32_t baseMappingId);
 void LoadItemData();
 
+/**
+ * @brief The indices into `UniqueItems` of the uniques of a base item, in the order of `UniqueItems`.
+ */
+std::span<const int32_t> GetUniqueItemsOfBase(unique_base_item baseItemId);
+
+/**
+ * @brief The affixes that can roll on items of a type, in the order of their table.
+ * @param affixes `ItemPrefixes` or `ItemSuffixes`
+ * @param type A single item type flag
+ */
+std::span<const PLStruct *const> GetAffixesForItemType(const std::vector<PLStruct> &affixes, AffixItemType type);
+
 } // namespace devilution
 
 template <>
@@ -41,6 +41,8 @@ constexpr uint16_t Uniq(_unique_items item)
 
 std::vector<std::string> MonsterSpritePaths;
 
+uint32_t MonsterDataGeneration = 1;
+
 } // namespace
 
 const char *MonsterData::spritePath() const
@@ -321,6 +323,7 @@ tl::expected<UniqueMonsterPack, std::string> ParseUniqueMonsterPack(std::string_
 void LoadMonstDatFromFile(DataFile &dataFile, const std::string_view filename, bool grow)
 {
 	dataFile.skipHeaderOrDie(filename);
+	MonsterDataGeneration++;
 
 	if (grow) {
 		MonstersData.reserve(MonstersData.size() + dataFile.numRecords());
@@ -423,6 +426,7 @@ void LoadMonstDat()
 void LoadUniqueMonstDatFromFile(DataFile &dataFile, std::string_view filename)
 {
 	dataFile.skipHeaderOrDie(filename);
+	MonsterDataGeneration++;
 
 	UniqueMonstersData.reserve(UniqueMonstersData.size() + dataFile.numRecords());
 
@@ -473,6 +477,12 @@ void LoadMonsterData()
 {
 	LoadMonstDat();
 	LoadUniqueMonstDat();
+	MonsterDataGeneration++;
+}
+
+uint32_t GetMonsterDataGeneration()
+{
+	return MonsterDataGeneration;
 }
 
 size_t GetNumMonsterSprites()
@@ -355,6 +355,9 @@ void LoadMonstDatFromFile(DataFile &dataFile, std::string_view filename, bool gr
 void LoadUniqueMonstDatFromFile(DataFile &dataFile, std::string_view filename);
 void LoadMonsterData();
 
+/** @brief Changes whenever monster or unique monster data is loaded, so that values derived from it can tell when they are out of date. */
+uint32_t GetMonsterDataGeneration();
+
 /**
  * @brief Returns the number of the monster sprite files.
  *
@@ -88,11 +88,7 @@ tl::expected<ExperienceColumn, ColumnDefinition::Error> mapExperienceColumnFromN
 void ReloadExperienceData()
 {
 	constexpr std::string_view filename = "txtdata\\Experience.tsv";
-	auto dataFileResult = DataFile::load(filename);
-	if (!dataFileResult.has_value()) {
-		DataFile::reportFatalError(dataFileResult.error(), filename);
-	}
-	DataFile &dataFile = dataFileResult.value();
+	DataFile dataFile = DataFile::loadOrDie(filename);
 
 	constexpr unsigned ExpectedColumnCount = enum_size<ExperienceColumn>::value;
 
@@ -6,6 +6,7 @@
 #include "tables/spelldat.h"
 
 #include <optional>
+#include <span>
 #include <string_view>
 
 #include <expected.hpp>
@@ -13,6 +14,7 @@
 #include "data/file.hpp"
 #include "data/iterators.hpp"
 #include "data/record_reader.hpp"
+#include "data/table_cache.hpp"
 
 namespace devilution {
 
@@ -32,6 +34,12 @@ void AddNullSpell()
 	null.sStaffMax = 80;
 }
 
+constexpr auto TransferSpellData = [](auto &stream, SpellData &spell) {
+	stream(spell.sNameText, spell.sSFX, spell.bookCost10, spell.staffCost10, spell.sManaCost, spell.flags,
+	    spell.sBookLvl, spell.sStaffLvl, spell.minInt, spell.sMissiles, spell.sManaAdj, spell.sMinMana,
+	    spell.sStaffMin, spell.sStaffMax);
+};
+
 // A temporary solution for parsing soundID until we have a more general one.
 tl::expected<SfxID, std::string> ParseSpellSoundId(std::string_view value)
 {
@@ -234,6 +242,13 @@ void LoadSpellData()
 	DataFile dataFile = DataFile::loadOrDie(filename);
 	SpellsData.reserve(dataFile.numRecords() + 1);
 	AddNullSpell();
+
+	const uint64_t cacheKey = GetTableCacheKey(dataFile, sizeof(SpellData));
+	if (LoadTableFromCache(filename, cacheKey, SpellsData, TransferSpellData)) {
+		SpellsData.shrink_to_fit();
+		return;
+	}
+
 	dataFile.skipHeaderOrDie(filename);
 	for (DataFileRecord record : dataFile) {
 		RecordReader reader { record, filename };
@@ -254,6 +269,7 @@ void LoadSpellData()
 		reader.readInt("staffMin", item.sStaffMin);
 		reader.readInt("staffMax", item.sStaffMax);
 	}
+	SaveTableToCache(filename, cacheKey, std::span(SpellsData).subspan(1), TransferSpellData);
 	SpellsData.shrink_to_fit();
 }
 
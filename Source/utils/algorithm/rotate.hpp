@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace devilution {
+
+/**
+ * @brief Moves each element one place towards the front and the first element to the back.
+ *
+ * Same as `std::rotate(range.begin(), range.begin() + 1, range.end())`, but a single `memmove`.
+ * Also works for arrays of arrays, such as the rows of a lookup table.
+ */
+template <typename T>
+void RotateLeftByOne(std::span<T> range)
+{
+	static_assert(std::is_trivially_copyable_v<T>);
+	if (range.size() < 2)
+		return;
+	std::byte first[sizeof(T)];
+	std::memcpy(first, range.data(), sizeof(T));
+	std::memmove(range.data(), range.data() + 1, (range.size() - 1) * sizeof(T));
+	std::memcpy(range.data() + range.size() - 1, first, sizeof(T));
+}
+
+/**
+ * @brief Moves each element one place towards the back and the last element to the front.
+ *
+ * Same as `std::rotate(range.begin(), range.end() - 1, range.end())`, but a single `memmove`.
+ */
+template <typename T>
+void RotateRightByOne(std::span<T> range)
+{
+	static_assert(std::is_trivially_copyable_v<T>);
+	if (range.size() < 2)
+		return;
+	std::byte last[sizeof(T)];
+	std::memcpy(last, range.data() + range.size() - 1, sizeof(T));
+	std::memmove(range.data() + 1, range.data(), (range.size() - 1) * sizeof(T));
+	std::memcpy(range.data(), last, sizeof(T));
+}
+
+} // namespace devilution
@@ -0,0 +1,104 @@
+#include "utils/allocation_tracker.hpp"
+
+#ifdef DEVILUTIONX_ALLOCATION_TRACKER
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "utils/log.hpp"
+
+namespace devilution {
+
+namespace {
+
+// Zero-initialized and trivially destructible, so this is usable from `operator new` at any point of the thread's life.
+thread_local AllocationCounts ThreadAllocations;
+
+struct TickAllocationStats {
+	uint64_t ticks;
+	uint64_t ticksWithAllocations;
+	AllocationCounts total;
+	AllocationCounts max;
+};
+
+TickAllocationStats TickStats;
+
+void *CountedAllocate(std::size_t size)
+{
+	ThreadAllocations.allocations++;
+	ThreadAllocations.bytes += size;
+	void *ptr = std::malloc(size != 0 ? size : 1);
+	if (ptr == nullptr) {
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+		throw std::bad_alloc();
+#else
+		std::abort();
+#endif
+	}
+	return ptr;
+}
+
+} // namespace
+
+AllocationCounts GetThreadAllocationCounts()
+{
+	return ThreadAllocations;
+}
+
+void AddTickAllocations(AllocationCounts tick)
+{
+	TickStats.ticks++;
+	if (tick.allocations != 0)
+		TickStats.ticksWithAllocations++;
+	TickStats.total.allocations += tick.allocations;
+	TickStats.total.bytes += tick.bytes;
+	TickStats.max.allocations = std::max(TickStats.max.allocations, tick.allocations);
+	TickStats.max.bytes = std::max(TickStats.max.bytes, tick.bytes);
+}
+
+void LogTickAllocations()
+{
+	if (TickStats.ticks == 0)
+		return;
+	LogInfo("Allocations per game tick: {:.1f} ({:.0f} bytes) on average, at most {} ({} bytes), {} of {} ticks allocated",
+	    static_cast<double>(TickStats.total.allocations) / TickStats.ticks,
+	    static_cast<double>(TickStats.total.bytes) / TickStats.ticks,
+	    TickStats.max.allocations, TickStats.max.bytes, TickStats.ticksWithAllocations, TickStats.ticks);
+	TickStats = {};
+}
+
+} // namespace devilution
+
+void *operator new(std::size_t size)
+{
+	return devilution::CountedAllocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+	return devilution::CountedAllocate(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t /*size*/) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t /*size*/) noexcept
+{
+	std::free(ptr);
+}
+
+#endif // DEVILUTIONX_ALLOCATION_TRACKER
@@ -0,0 +1,56 @@
+/**
+ * @file allocation_tracker.hpp
+ *
+ * Counts heap allocations by replacing the global `operator new`.
+ *
+ * Only built with `DEVILUTIONX_ALLOCATION_TRACKER`.
+ */
+#pragma once
+
+#ifdef DEVILUTIONX_ALLOCATION_TRACKER
+
+#include <cstdint>
+#include <utility>
+
+namespace devilution {
+
+struct AllocationCounts {
+	uint64_t allocations;
+	uint64_t bytes;
+
+	AllocationCounts operator-(const AllocationCounts &other) const
+	{
+		return AllocationCounts { allocations - other.allocations, bytes - other.bytes };
+	}
+};
+
+/**
+ * @brief The allocations made by the calling thread since it started.
+ *
+ * Frees are not subtracted, what matters for churn is how often the allocator is called.
+ * Over-aligned allocations are not counted.
+ */
+AllocationCounts GetThreadAllocationCounts();
+
+/**
+ * @brief Counts the allocations made on the calling thread while running `fn`.
+ *
+ * Meant for tests, e.g. `EXPECT_EQ(CountAllocations(ProcessMissiles).allocations, 0)`.
+ */
+template <typename Fn>
+AllocationCounts CountAllocations(Fn &&fn)
+{
+	const AllocationCounts before = GetThreadAllocationCounts();
+	std::forward<Fn>(fn)();
+	return GetThreadAllocationCounts() - before;
+}
+
+/** @brief Adds the allocations of one game tick to the per-tick statistics. */
+void AddTickAllocations(AllocationCounts tick);
+
+/** @brief Logs the per-tick statistics since the previous call and resets them. */
+void LogTickAllocations();
+
+} // namespace devilution
+
+#endif // DEVILUTIONX_ALLOCATION_TRACKER
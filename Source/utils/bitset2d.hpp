@@ -1,53 +1,171 @@
 #pragma once
 
-#include <bitset>
+#include <array>
+#include <bit>
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
 
 namespace devilution {
 
 /**
  * @brief A 2D variant of std::bitset.
  *
- * For function documentation, see `std::bitset`
+ * For the per-cell functions, see `std::bitset`.
+ * Each row starts on a 64-bit word, so that rectangles are tested and filled a word of a row at a time.
  *
  * @tparam Width
  * @tparam Height
  */
 template <size_t Width, size_t Height>
 class Bitset2d {
+	using Word = uint64_t;
+	static constexpr size_t WordBits = 64;
+	static constexpr size_t WordsPerRow = (Width + WordBits - 1) / WordBits;
+
 public:
 	bool test(size_t x, size_t y) const
 	{
-		return data_.test(index(x, y));
+		return (word(x, y) & bit(x)) != 0;
 	}
 
 	void set(size_t x, size_t y, bool value = true)
 	{
-		data_.set(index(x, y), value);
+		if (value)
+			word(x, y) |= bit(x);
+		else
+			word(x, y) &= ~bit(x);
 	}
 
 	void reset(size_t x, size_t y)
 	{
-		data_.reset(index(x, y));
+		word(x, y) &= ~bit(x);
 	}
 
 	void reset()
 	{
-		data_.reset();
+		data_.fill(0);
 	}
 
 	[[nodiscard]] size_t count() const
 	{
-		return data_.count();
+		size_t result = 0;
+		for (const Word w : data_)
+			result += std::popcount(w);
+		return result;
+	}
+
+	/** @brief Whether any cell of the rectangle is set, the rectangle must lie within the bitset. */
+	[[nodiscard]] bool anyInRect(size_t x, size_t y, size_t width, size_t height) const
+	{
+		return !forEachRectWord(data_.data(), x, y, width, height, [](const Word &w, Word mask) { return (w & mask) == 0; });
+	}
+
+	/** @brief Whether all cells of the rectangle are set, the rectangle must lie within the bitset. */
+	[[nodiscard]] bool allInRect(size_t x, size_t y, size_t width, size_t height) const
+	{
+		return forEachRectWord(data_.data(), x, y, width, height, [](const Word &w, Word mask) { return (w & mask) == mask; });
+	}
+
+	/** @brief Sets all cells of the rectangle to `value`, the rectangle must lie within the bitset. */
+	void fillRect(size_t x, size_t y, size_t width, size_t height, bool value = true)
+	{
+		forEachRectWord(data_.data(), x, y, width, height, [value](Word &w, Word mask) {
+			if (value)
+				w |= mask;
+			else
+				w &= ~mask;
+			return true;
+		});
+	}
+
+	/** @brief The number of set cells in the rectangle, which must lie within the bitset. */
+	[[nodiscard]] size_t countInRect(size_t x, size_t y, size_t width, size_t height) const
+	{
+		size_t result = 0;
+		forEachRectWord(data_.data(), x, y, width, height, [&result](const Word &w, Word mask) {
+			result += std::popcount(w & mask);
+			return true;
+		});
+		return result;
+	}
+
+	/** @brief Whether any cell of row `y` is set. */
+	[[nodiscard]] bool anyInRow(size_t y) const
+	{
+		assert(y < Height);
+		for (size_t i = 0; i < WordsPerRow; i++) {
+			if (data_[y * WordsPerRow + i] != 0)
+				return true;
+		}
+		return false;
+	}
+
+	/** @brief Calls `fn(x)` for each set cell of row `y`, from left to right. */
+	template <typename F>
+	void forEachSetInRow(size_t y, F &&fn) const
+	{
+		assert(y < Height);
+		for (size_t i = 0; i < WordsPerRow; i++) {
+			for (Word w = data_[y * WordsPerRow + i]; w != 0; w &= w - 1) {
+				fn(i * WordBits + std::countr_zero(w));
+			}
+		}
+	}
+
+	/** @brief Calls `fn(x, y)` for each set cell, row by row. */
+	template <typename F>
+	void forEachSet(F &&fn) const
+	{
+		for (size_t y = 0; y < Height; y++) {
+			forEachSetInRow(y, [&fn, y](size_t x) { fn(x, y); });
+		}
 	}
 
 private:
-	static size_t index(size_t x, size_t y)
+	static Word bit(size_t x)
+	{
+		return Word { 1 } << (x % WordBits);
+	}
+
+	Word &word(size_t x, size_t y)
+	{
+		assert(x < Width && y < Height);
+		return data_[y * WordsPerRow + x / WordBits];
+	}
+
+	const Word &word(size_t x, size_t y) const
+	{
+		assert(x < Width && y < Height);
+		return data_[y * WordsPerRow + x / WordBits];
+	}
+
+	/**
+	 * @brief Calls `fn(word, mask)` for the words covering each row of the rectangle, with `mask` selecting the rectangle's cells.
+	 * @return false as soon as `fn` returns false.
+	 */
+	template <typename WordT, typename F>
+	static bool forEachRectWord(WordT *data, size_t x, size_t y, size_t width, size_t height, F &&fn)
 	{
-		return y * Width + x;
+		if (width == 0 || height == 0)
+			return true;
+		assert(x + width <= Width && y + height <= Height);
+		const size_t firstWord = x / WordBits;
+		const size_t lastWord = (x + width - 1) / WordBits;
+		for (size_t row = y; row < y + height; row++) {
+			WordT *rowData = data + row * WordsPerRow;
+			for (size_t i = firstWord; i <= lastWord; i++) {
+				const size_t begin = i == firstWord ? x % WordBits : 0;
+				const size_t end = i == lastWord ? (x + width - 1) % WordBits + 1 : WordBits;
+				const Word mask = (end - begin == WordBits ? ~Word { 0 } : ((Word { 1 } << (end - begin)) - 1)) << begin;
+				if (!fn(rowData[i], mask))
+					return false;
+			}
+		}
+		return true;
 	}
 
-	std::bitset<Width * Height> data_;
+	std::array<Word, WordsPerRow * Height> data_ {};
 };
 
 } // namespace devilution
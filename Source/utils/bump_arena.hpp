@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace devilution {
+
+/**
+ * @brief Hands out memory from large chunks that are all released together.
+ *
+ * `reset()` makes the whole arena available again without returning its chunks to the heap, so data that is
+ * thrown away at the same time, e.g. everything loaded to generate a level, is carved out of the same few blocks
+ * every time instead of fragmenting the heap. Nothing is destroyed on reset, only trivially destructible data
+ * belongs in an arena.
+ */
+class BumpArena {
+public:
+	/** @param chunkSize Size of the chunks allocated from the heap, larger requests get a chunk of their own size. */
+	explicit BumpArena(size_t chunkSize)
+	    : chunkSize_(chunkSize)
+	{
+	}
+
+	BumpArena(const BumpArena &) = delete;
+	BumpArena &operator=(const BumpArena &) = delete;
+
+	/** @brief Uninitialized storage for `count` elements, valid until the next `reset()`. */
+	template <typename T>
+	[[nodiscard]] T *allocate(size_t count)
+	{
+		static_assert(std::is_trivially_destructible_v<T>, "Arena memory is released without destroying anything");
+		static_assert(alignof(T) <= alignof(std::max_align_t));
+		return reinterpret_cast<T *>(allocateBytes(count * sizeof(T), alignof(T)));
+	}
+
+	/** @brief Makes all memory available again, keeping the chunks. */
+	void reset()
+	{
+		for (Chunk &chunk : chunks_)
+			chunk.used = 0;
+		current_ = 0;
+	}
+
+	/** @brief Memory taken from the heap, which is only returned when the arena is destroyed. */
+	[[nodiscard]] size_t capacity() const
+	{
+		size_t total = 0;
+		for (const Chunk &chunk : chunks_)
+			total += chunk.size;
+		return total;
+	}
+
+private:
+	struct Chunk {
+		std::unique_ptr<std::byte[]> data;
+		size_t size;
+		size_t used;
+	};
+
+	std::byte *allocateBytes(size_t size, size_t alignment)
+	{
+		// Chunks are aligned for any type, so aligning the offset aligns the address
+		for (; current_ < chunks_.size(); current_++) {
+			Chunk &chunk = chunks_[current_];
+			const size_t offset = (chunk.used + alignment - 1) & ~(alignment - 1);
+			if (offset <= chunk.size && size <= chunk.size - offset) {
+				chunk.used = offset + size;
+				return chunk.data.get() + offset;
+			}
+		}
+
+		const size_t chunkSize = std::max(size, chunkSize_);
+		chunks_.push_back({ std::unique_ptr<std::byte[]> { new std::byte[chunkSize] }, chunkSize, size });
+		current_ = chunks_.size() - 1;
+		return chunks_.back().data.get();
+	}
+
+	std::vector<Chunk> chunks_;
+	/** @brief The first chunk that may have room, the ones before it are full. */
+	size_t current_ = 0;
+	size_t chunkSize_;
+};
+
+} // namespace devilution
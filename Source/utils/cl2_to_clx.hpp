@@ -12,6 +12,18 @@
 
 namespace devilution {
 
+/**
+ * @brief Appends a single CL2 sprite list, converted to CLX, to `clxData`.
+ *
+ * @param pixels Scratch space, can be reused across calls.
+ */
+void Cl2ListToClx(const uint8_t *data, PointerOrValue<uint16_t> widthOrWidths, std::vector<uint8_t> &clxData, std::vector<uint8_t> &pixels);
+
+/**
+ * @return The number of lists in the CL2 data if it is a sheet, 0 otherwise.
+ */
+uint16_t GetCl2SheetListCount(const uint8_t *data, size_t size);
+
 /**
  * @brief Converts CL2 to CLX in-place.
  *
@@ -0,0 +1,151 @@
+#include "utils/clx_cache.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include <ankerl/unordered_dense.h>
+#include <fmt/format.h>
+
+#include "utils/file_util.h"
+#include "utils/log.hpp"
+#include "utils/paths.h"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+
+namespace {
+
+/** @brief Bump this whenever a converter changes its output, so that older entries are not used. */
+constexpr uint32_t ClxCacheVersion = 1;
+
+#ifdef DEVILUTIONX_CLX_CACHE_BUDGET
+/** @brief How much disk space the cache may take up, 0 disables it. */
+constexpr uintmax_t ClxCacheBudget = DEVILUTIONX_CLX_CACHE_BUDGET;
+#else
+constexpr uintmax_t ClxCacheBudget = 256 * 1024 * 1024;
+#endif
+
+struct ClxCacheHeader {
+	char magic[4];
+	uint32_t version;
+	uint64_t keyHash;
+	uint64_t size;
+	uint64_t clxSize;
+	uint16_t numLists;
+};
+
+constexpr char ClxCacheMagic[4] = { 'D', 'X', 'C', 'C' };
+
+/** @brief The size of the cache directory, determined on first use. */
+std::optional<uintmax_t> ClxCacheSize;
+
+uint64_t HashBytes(const void *data, size_t size)
+{
+	return ankerl::unordered_dense::hash<std::string_view> {}(std::string_view { static_cast<const char *>(data), size });
+}
+
+const std::string &ClxCacheDir()
+{
+	static const std::string Dir = StrCat(paths::PrefPath(), "cache" DIRECTORY_SEPARATOR_STR "clx" DIRECTORY_SEPARATOR_STR);
+	return Dir;
+}
+
+std::string ClxCachePath(uint64_t keyHash)
+{
+	return StrCat(ClxCacheDir(), fmt::format("{:016x}", keyHash), ".clx");
+}
+
+uintmax_t GetClxCacheSize()
+{
+	if (!ClxCacheSize) {
+		uintmax_t total = 0;
+		for (const std::string &file : ListFiles(ClxCacheDir().c_str())) {
+			uintmax_t size;
+			if (GetFileSize(StrCat(ClxCacheDir(), file).c_str(), &size))
+				total += size;
+		}
+		ClxCacheSize = total;
+	}
+	return *ClxCacheSize;
+}
+
+} // namespace
+
+ClxCacheKey GetClxCacheKey(std::string_view path, const uint8_t *data, size_t size, ClxConverter converter, uint32_t params)
+{
+	const uint64_t parts[] = {
+		HashBytes(data, size),
+		HashBytes(path.data(), path.size()),
+		size,
+		(static_cast<uint64_t>(converter) << 32) | params,
+		ClxCacheVersion,
+	};
+	return ClxCacheKey { path, size, HashBytes(parts, sizeof(parts)) };
+}
+
+std::optional<OwnedClxSpriteListOrSheet> LoadCachedClx(const ClxCacheKey &key)
+{
+	if (ClxCacheBudget == 0)
+		return std::nullopt;
+
+	FILE *file = OpenFile(ClxCachePath(key.hash).c_str(), "rb");
+	if (file == nullptr)
+		return std::nullopt;
+
+	std::optional<OwnedClxSpriteListOrSheet> result;
+	ClxCacheHeader header;
+	if (std::fread(&header, sizeof(header), 1, file) == 1
+	    && std::memcmp(header.magic, ClxCacheMagic, sizeof(ClxCacheMagic)) == 0
+	    && header.version == ClxCacheVersion
+	    && header.keyHash == key.hash
+	    && header.size == key.size
+	    && header.clxSize != 0) {
+		std::unique_ptr<uint8_t[]> data { new uint8_t[header.clxSize] };
+		if (std::fread(data.get(), header.clxSize, 1, file) == 1)
+			result.emplace(std::move(data), header.numLists);
+	}
+	std::fclose(file);
+	if (!result)
+		LogVerbose("Ignoring invalid CLX cache entry for {}", key.path);
+	return result;
+}
+
+void StoreCachedClx(const ClxCacheKey &key, const OwnedClxSpriteListOrSheet &clx)
+{
+	if (ClxCacheBudget == 0)
+		return;
+	const size_t clxSize = clx.dataSize();
+	if (GetClxCacheSize() + sizeof(ClxCacheHeader) + clxSize > ClxCacheBudget)
+		return;
+
+	RecursivelyCreateDir(ClxCacheDir().c_str());
+	const std::string path = ClxCachePath(key.hash);
+	const std::string tempPath = StrCat(path, ".tmp");
+	FILE *file = OpenFile(tempPath.c_str(), "wb");
+	if (file == nullptr)
+		return;
+
+	ClxCacheHeader header {};
+	std::memcpy(header.magic, ClxCacheMagic, sizeof(ClxCacheMagic));
+	header.version = ClxCacheVersion;
+	header.keyHash = key.hash;
+	header.size = key.size;
+	header.clxSize = clxSize;
+	header.numLists = clx.numLists();
+	const uint8_t *data = clx.isSheet() ? clx.sheet().data() : clx.list().data();
+	const bool written = std::fwrite(&header, sizeof(header), 1, file) == 1
+	    && std::fwrite(data, clxSize, 1, file) == 1;
+	if (std::fclose(file) != 0 || !written) {
+		LogVerbose("Failed to write the CLX cache entry for {}", key.path);
+		RemoveFile(tempPath.c_str());
+		return;
+	}
+	// Renamed into place only once complete, so that an interrupted write is never read back.
+	RenameFile(tempPath.c_str(), path.c_str());
+	*ClxCacheSize += sizeof(header) + clxSize;
+}
+
+} // namespace devilution
@@ -0,0 +1,54 @@
+/**
+ * @file clx_cache.hpp
+ *
+ * On-disk cache of sprites converted to CLX from the legacy formats.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "engine/clx_sprite.hpp"
+
+namespace devilution {
+
+enum class ClxConverter : uint8_t {
+	Cel,
+	Cl2,
+};
+
+/**
+ * @brief Identifies the result of converting an asset to CLX.
+ */
+struct ClxCacheKey {
+	/** @brief The path of the asset, only used for logging. */
+	std::string_view path;
+
+	/** @brief The size of the asset before conversion. */
+	size_t size;
+
+	uint64_t hash;
+};
+
+/**
+ * @brief Computes the cache key of an asset, must be called before the conversion as it may modify the data in place.
+ *
+ * @param params Any converter parameter that changes the output, e.g. the frame width.
+ */
+ClxCacheKey GetClxCacheKey(std::string_view path, const uint8_t *data, size_t size, ClxConverter converter, uint32_t params);
+
+/**
+ * @brief Loads the result of an earlier conversion of the same asset.
+ */
+std::optional<OwnedClxSpriteListOrSheet> LoadCachedClx(const ClxCacheKey &key);
+
+/**
+ * @brief Stores the result of a conversion for the next time the asset is loaded.
+ *
+ * Failing to write the cache is not an error, the asset is then converted again the next time.
+ */
+void StoreCachedClx(const ClxCacheKey &key, const OwnedClxSpriteListOrSheet &clx);
+
+} // namespace devilution
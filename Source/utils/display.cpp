@@ -704,6 +704,8 @@ void ReinitializeTexture()
 		SDL_ClearError();
 	}
 	texture = SDLWrap::CreateTexture(renderer, DEVILUTIONX_DISPLAY_TEXTURE_FORMAT, SDL_TEXTUREACCESS_STREAMING, gnScreenWidth, gnScreenHeight);
+	// Recreated with the new size and scale mode on the next `BltFast`.
+	IndexedTexture = nullptr;
 #else
 	auto quality = StrCat(static_cast<int>(*GetOptions().Graphics.scaleQuality));
 	SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, quality.c_str());
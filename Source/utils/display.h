@@ -24,13 +24,16 @@
 
 namespace devilution {
 
-extern int refreshDelay; // Screen refresh rate in nanoseconds
+extern int refreshDelay; // Time between screen refreshes in microseconds
 extern SDL_Window *window;
 extern SDL_Window *ghMainWnd;
 extern SDL_Renderer *renderer;
 #ifndef USE_SDL1
 extern SDLTextureUniquePtr texture;
 #endif
+#ifdef USE_SDL3
+extern SDLTextureUniquePtr IndexedTexture;
+#endif
 
 extern SDLPaletteUniquePtr Palette;
 extern SDL_Surface *PalSurface;
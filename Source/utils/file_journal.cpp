@@ -0,0 +1,338 @@
+#include "utils/file_journal.hpp"
+
+#include <array>
+#include <cstring>
+#include <utility>
+
+#include "utils/endian_read.hpp"
+#include "utils/file_util.h"
+#include "utils/log.hpp"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+
+namespace {
+
+constexpr uint32_t JournalMagic = 0x4C4A5844; // "DXJL"
+constexpr uint32_t JournalVersion = 0;
+constexpr uint64_t JournalHeaderSize = 8;
+
+/** @brief Type, name length, target name length, padding and data size. */
+constexpr uint32_t RecordHeaderSize = 8;
+
+/** @brief Journals are only compacted once they waste at least this much, and more than their files take up. */
+constexpr uint64_t CompactionMinDeadBytes = 512 * 1024;
+
+void WriteLE32(std::byte *out, uint32_t value)
+{
+	for (int i = 0; i < 4; i++)
+		out[i] = static_cast<std::byte>(value >> (i * 8));
+}
+
+bool WriteJournalHeader(FILE *file)
+{
+	std::array<std::byte, JournalHeaderSize> header;
+	WriteLE32(&header[0], JournalMagic);
+	WriteLE32(&header[4], JournalVersion);
+	return std::fwrite(header.data(), header.size(), 1, file) == 1;
+}
+
+bool WriteRecord(FILE *file, uint8_t type, std::string_view name, std::string_view target, const std::byte *data, uint32_t size)
+{
+	std::array<std::byte, RecordHeaderSize> header {};
+	header[0] = static_cast<std::byte>(type);
+	header[1] = static_cast<std::byte>(name.size());
+	header[2] = static_cast<std::byte>(target.size());
+	WriteLE32(&header[4], size);
+	return std::fwrite(header.data(), header.size(), 1, file) == 1
+	    && (name.empty() || std::fwrite(name.data(), name.size(), 1, file) == 1)
+	    && (target.empty() || std::fwrite(target.data(), target.size(), 1, file) == 1)
+	    && (size == 0 || std::fwrite(data, size, 1, file) == 1);
+}
+
+uint32_t GetRecordSize(std::string_view name, std::string_view target, uint32_t size)
+{
+	return RecordHeaderSize + static_cast<uint32_t>(name.size() + target.size()) + size;
+}
+
+bool IsValidName(std::string_view name)
+{
+	return !name.empty() && name.size() <= 0xFF;
+}
+
+} // namespace
+
+FileJournal::FileJournal(std::string path, ReplaceFileFn replaceFile)
+    : path_(std::move(path))
+    , replaceFile_(replaceFile != nullptr ? replaceFile : &::devilution::RenameFile)
+{
+}
+
+FileJournal::~FileJournal()
+{
+	if (file_ != nullptr && writing_)
+		Checkpoint();
+}
+
+bool FileJournal::OpenForReading()
+{
+	writing_ = false;
+	file_.reset(OpenFile(path_.c_str(), "rb"));
+	if (file_ == nullptr)
+		return false;
+	if (!Replay()) {
+		file_ = nullptr;
+		return false;
+	}
+	return true;
+}
+
+bool FileJournal::OpenForWriting()
+{
+	file_.reset(OpenFile(path_.c_str(), "rb"));
+	const bool replayed = file_ != nullptr && Replay();
+	file_ = nullptr;
+
+	if (!replayed) {
+		files_.clear();
+		size_ = JournalHeaderSize;
+		liveBytes_ = JournalHeaderSize;
+		file_.reset(OpenFile(path_.c_str(), "w+b"));
+		if (file_ == nullptr || !WriteJournalHeader(file_.get())) {
+			LogError("Failed to create save journal {}", path_);
+			file_ = nullptr;
+			return false;
+		}
+	} else {
+		if (DeadBytes() >= CompactionMinDeadBytes && DeadBytes() > liveBytes_) {
+			if (!Compact())
+				LogError("Failed to compact save journal {}", path_);
+		}
+		// size_ describes the file on disk, whether it was compacted or not
+		std::uintmax_t fileSize;
+		if (GetFileSize(path_.c_str(), &fileSize) && fileSize > size_) {
+			// Drop the changes that were never checkpointed, new records have to follow the last checkpoint
+			ResizeFile(path_.c_str(), size_);
+		}
+		file_.reset(OpenFile(path_.c_str(), "r+b"));
+		if (file_ == nullptr) {
+			LogError("Failed to open save journal {}", path_);
+			return false;
+		}
+	}
+	writing_ = true;
+	dirty_ = false;
+	return true;
+}
+
+bool FileJournal::HasFile(std::string_view name) const
+{
+	return files_.contains(std::string(name));
+}
+
+std::unique_ptr<std::byte[]> FileJournal::ReadFile(std::string_view name, size_t &size)
+{
+	const auto it = files_.find(std::string(name));
+	if (it == files_.end() || file_ == nullptr)
+		return nullptr;
+	const Entry &entry = it->second;
+	if (std::fseek(file_.get(), static_cast<long>(entry.offset), SEEK_SET) != 0)
+		return nullptr;
+	std::unique_ptr<std::byte[]> data { new std::byte[entry.size] };
+	if (entry.size != 0 && std::fread(data.get(), entry.size, 1, file_.get()) != 1)
+		return nullptr;
+	size = entry.size;
+	return data;
+}
+
+bool FileJournal::WriteFile(std::string_view name, const std::byte *data, size_t size)
+{
+	if (!writing_ || file_ == nullptr || !IsValidName(name) || size > UINT32_MAX)
+		return false;
+	const auto dataSize = static_cast<uint32_t>(size);
+	if (!AppendRecord(RecordType::Write, name, {}, data, dataSize))
+		return false;
+	const uint32_t recordSize = GetRecordSize(name, {}, dataSize);
+	Apply({ RecordType::Write, std::string(name), {}, { size_ - dataSize, dataSize, recordSize } });
+	return true;
+}
+
+void FileJournal::RemoveFile(std::string_view name)
+{
+	if (!HasFile(name) || !AppendRecord(RecordType::Remove, name, {}, nullptr, 0))
+		return;
+	Apply({ RecordType::Remove, std::string(name), {}, {} });
+}
+
+void FileJournal::RenameFile(std::string_view from, std::string_view to)
+{
+	if (!HasFile(from) || !IsValidName(to) || !AppendRecord(RecordType::Rename, from, to, nullptr, 0))
+		return;
+	Apply({ RecordType::Rename, std::string(from), std::string(to), {} });
+}
+
+bool FileJournal::Checkpoint()
+{
+	if (!writing_ || file_ == nullptr || !dirty_)
+		return true;
+	if (!AppendRecord(RecordType::Checkpoint, {}, {}, nullptr, 0))
+		return false;
+	dirty_ = false;
+	if (!SyncFile(file_.get())) {
+		LogError("Failed to sync save journal {}", path_);
+		return false;
+	}
+	return true;
+}
+
+bool FileJournal::Replay()
+{
+	files_.clear();
+	size_ = JournalHeaderSize;
+	liveBytes_ = JournalHeaderSize;
+
+	FILE *file = file_.get();
+	std::uintmax_t fileSize;
+	std::array<std::byte, JournalHeaderSize> journalHeader;
+	if (!GetFileSize(path_.c_str(), &fileSize)
+	    || std::fread(journalHeader.data(), journalHeader.size(), 1, file) != 1
+	    || LoadLE32(&journalHeader[0]) != JournalMagic
+	    || LoadLE32(&journalHeader[4]) > JournalVersion) {
+		return false;
+	}
+
+	// Changes are collected until the checkpoint that makes them take effect,
+	// the ones without a checkpoint are from a write that never completed
+	std::vector<Change> pending;
+	uint64_t position = JournalHeaderSize;
+	std::array<std::byte, RecordHeaderSize> header;
+	while (std::fread(header.data(), header.size(), 1, file) == 1) {
+		const auto type = static_cast<RecordType>(header[0]);
+		const auto nameSize = static_cast<uint8_t>(header[1]);
+		const auto targetSize = static_cast<uint8_t>(header[2]);
+		const uint32_t dataSize = LoadLE32(&header[4]);
+		const uint64_t recordSize = RecordHeaderSize + nameSize + targetSize + static_cast<uint64_t>(dataSize);
+		if (position + recordSize > fileSize)
+			break;
+
+		std::string name(nameSize, '\0');
+		std::string target(targetSize, '\0');
+		if ((nameSize != 0 && std::fread(name.data(), nameSize, 1, file) != 1)
+		    || (targetSize != 0 && std::fread(target.data(), targetSize, 1, file) != 1)) {
+			break;
+		}
+
+		if (type == RecordType::Checkpoint) {
+			for (const Change &change : pending)
+				Apply(change);
+			pending.clear();
+			size_ = position + recordSize;
+		} else if (type == RecordType::Write || type == RecordType::Remove || type == RecordType::Rename) {
+			const Entry entry { position + RecordHeaderSize + nameSize + targetSize, dataSize, static_cast<uint32_t>(recordSize) };
+			pending.push_back({ type, std::move(name), std::move(target), entry });
+		} else {
+			break;
+		}
+
+		position += recordSize;
+		if (dataSize != 0 && std::fseek(file, static_cast<long>(position), SEEK_SET) != 0)
+			break;
+	}
+	return true;
+}
+
+bool FileJournal::Compact()
+{
+	const std::string tempPath = StrCat(path_, ".tmp");
+	std::unique_ptr<FILE, FileCloser> source { OpenFile(path_.c_str(), "rb") };
+	std::unique_ptr<FILE, FileCloser> target { OpenFile(tempPath.c_str(), "wb") };
+	if (source == nullptr || target == nullptr || !WriteJournalHeader(target.get()))
+		return false;
+
+	ankerl::unordered_dense::map<std::string, Entry> files;
+	uint64_t size = JournalHeaderSize;
+	std::unique_ptr<std::byte[]> data;
+	size_t capacity = 0;
+	for (const auto &[name, entry] : files_) {
+		if (entry.size > capacity) {
+			capacity = entry.size;
+			data.reset(new std::byte[capacity]);
+		}
+		if (std::fseek(source.get(), static_cast<long>(entry.offset), SEEK_SET) != 0
+		    || (entry.size != 0 && std::fread(data.get(), entry.size, 1, source.get()) != 1)
+		    || !WriteRecord(target.get(), static_cast<uint8_t>(RecordType::Write), name, {}, data.get(), entry.size)) {
+			target = nullptr;
+			::devilution::RemoveFile(tempPath.c_str());
+			return false;
+		}
+		const uint32_t recordSize = GetRecordSize(name, {}, entry.size);
+		files[name] = { size + recordSize - entry.size, entry.size, recordSize };
+		size += recordSize;
+	}
+	if (!WriteRecord(target.get(), static_cast<uint8_t>(RecordType::Checkpoint), {}, {}, nullptr, 0) || !SyncFile(target.get())) {
+		target = nullptr;
+		::devilution::RemoveFile(tempPath.c_str());
+		return false;
+	}
+	size += RecordHeaderSize;
+	target = nullptr;
+
+	// Windows can't replace a file that is still open
+	source = nullptr;
+	if (!replaceFile_(tempPath.c_str(), path_.c_str())) {
+		// The old journal is still in place, and so is the table that describes it
+		::devilution::RemoveFile(tempPath.c_str());
+		return false;
+	}
+	files_ = std::move(files);
+	size_ = size;
+	liveBytes_ = size - RecordHeaderSize;
+	return true;
+}
+
+void FileJournal::Apply(const Change &change)
+{
+	const auto remove = [this](const std::string &name) {
+		const auto it = files_.find(name);
+		if (it == files_.end())
+			return;
+		liveBytes_ -= it->second.recordSize;
+		files_.erase(it);
+	};
+
+	switch (change.type) {
+	case RecordType::Write:
+		remove(change.name);
+		files_[change.name] = change.entry;
+		liveBytes_ += change.entry.recordSize;
+		break;
+	case RecordType::Remove:
+		remove(change.name);
+		break;
+	case RecordType::Rename: {
+		const auto it = files_.find(change.name);
+		if (it == files_.end())
+			break;
+		const Entry entry = it->second;
+		files_.erase(it);
+		remove(change.target);
+		files_[change.target] = entry;
+	} break;
+	case RecordType::Checkpoint:
+		break;
+	}
+}
+
+bool FileJournal::AppendRecord(RecordType type, std::string_view name, std::string_view target, const std::byte *data, uint32_t size)
+{
+	if (std::fseek(file_.get(), static_cast<long>(size_), SEEK_SET) != 0
+	    || !WriteRecord(file_.get(), static_cast<uint8_t>(type), name, target, data, size)) {
+		LogError("Failed to write to save journal {}", path_);
+		return false;
+	}
+	size_ += GetRecordSize(name, target, size);
+	dirty_ = true;
+	return true;
+}
+
+} // namespace devilution
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <ankerl/unordered_dense.h>
+
+namespace devilution {
+
+/**
+ * @brief A set of named files stored in a single append-only file.
+ *
+ * Every change is appended to the journal as a record, so writing a file costs no file open.
+ * Changes only take effect once a checkpoint record follows them: a journal that was cut off
+ * while writing reads as of its last checkpoint, and is cut back to it when opened for writing.
+ */
+class FileJournal {
+public:
+	/** @brief Replaces the file `to` with `from`, returns false if `to` keeps its old contents. */
+	using ReplaceFileFn = bool (*)(const char *from, const char *to);
+
+	/**
+	 * @param replaceFile How a compacted journal replaces the old one, `RenameFile` if not given.
+	 */
+	explicit FileJournal(std::string path, ReplaceFileFn replaceFile = nullptr);
+
+	FileJournal(FileJournal &&) = default;
+	FileJournal &operator=(FileJournal &&) = default;
+
+	/** @brief Writes a checkpoint if anything changed since the last one. */
+	~FileJournal();
+
+	/**
+	 * @brief Reads the file table of the journal.
+	 * @return false if the journal doesn't exist or isn't valid.
+	 */
+	bool OpenForReading();
+
+	/**
+	 * @brief Reads the file table of the journal and prepares appending to it, a missing journal is created.
+	 *
+	 * If most of the journal is taken up by files that have since been replaced or removed,
+	 * it is rewritten with only the current files first.
+	 */
+	bool OpenForWriting();
+
+	[[nodiscard]] bool HasFile(std::string_view name) const;
+
+	/** @return The contents of the file, or nullptr if it doesn't exist or couldn't be read. */
+	std::unique_ptr<std::byte[]> ReadFile(std::string_view name, size_t &size);
+
+	bool WriteFile(std::string_view name, const std::byte *data, size_t size);
+	void RemoveFile(std::string_view name);
+	void RenameFile(std::string_view from, std::string_view to);
+
+	/**
+	 * @brief Makes all changes so far take effect, and waits until they are on the storage device.
+	 */
+	bool Checkpoint();
+
+	/** @brief Number of bytes in the journal that belong to replaced or removed files. */
+	[[nodiscard]] uint64_t DeadBytes() const
+	{
+		return size_ - liveBytes_;
+	}
+
+private:
+	enum class RecordType : uint8_t {
+		Write = 1,
+		Remove = 2,
+		Rename = 3,
+		Checkpoint = 4,
+	};
+
+	struct Entry {
+		/** @brief Position of the file contents in the journal. */
+		uint64_t offset;
+		uint32_t size;
+		/** @brief Size of the whole record the contents were written with. */
+		uint32_t recordSize;
+	};
+
+	struct Change {
+		RecordType type;
+		std::string name;
+		std::string target;
+		Entry entry;
+	};
+
+	struct FileCloser {
+		void operator()(FILE *file) const
+		{
+			std::fclose(file);
+		}
+	};
+
+	bool Replay();
+	bool Compact();
+	void Apply(const Change &change);
+	bool AppendRecord(RecordType type, std::string_view name, std::string_view target, const std::byte *data, uint32_t size);
+
+	std::string path_;
+	ReplaceFileFn replaceFile_;
+	std::unique_ptr<FILE, FileCloser> file_;
+	ankerl::unordered_dense::map<std::string, Entry> files_;
+	/** @brief Size of the journal up to the end of its last record. */
+	uint64_t size_ = 0;
+	/** @brief Bytes taken up by the records of the files in `files_`. */
+	uint64_t liveBytes_ = 0;
+	bool writing_ = false;
+	bool dirty_ = false;
+};
+
+} // namespace devilution
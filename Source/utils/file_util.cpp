@@ -29,6 +29,8 @@
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 
+#include <io.h>
+
 #ifndef DEVILUTIONX_WINDOWS_NO_WCHAR
 #include <shlwapi.h>
 #endif
@@ -263,6 +265,56 @@ bool GetFileSize(const char *path, std::uintmax_t *size)
 #endif
 }
 
+bool GetFileModificationTime(const char *path, std::int64_t *time)
+{
+#ifdef _WIN32
+	FILETIME lastWriteTime;
+#if defined(WINVER) && WINVER <= 0x0500 && (!defined(_WIN32_WINNT) || _WIN32_WINNT == 0)
+	HANDLE handle = ::CreateFileA(path, GENERIC_READ,
+	    FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+	    FILE_ATTRIBUTE_NORMAL, NULL);
+	if (handle == INVALID_HANDLE_VALUE)
+		return false;
+	const bool ok = ::GetFileTime(handle, NULL, NULL, &lastWriteTime) != 0;
+	::CloseHandle(handle);
+	if (!ok)
+		return false;
+#else
+	WIN32_FILE_ATTRIBUTE_DATA attr;
+#ifdef DEVILUTIONX_WINDOWS_NO_WCHAR
+	if (!GetFileAttributesExA(path, GetFileExInfoStandard, &attr)) {
+		return false;
+	}
+#else
+	const auto pathUtf16 = ToWideChar(path);
+	if (pathUtf16 == nullptr) {
+		LogError("UTF-8 -> UTF-16 conversion error code {}", ::GetLastError());
+		return false;
+	}
+	if (!GetFileAttributesExW(&pathUtf16[0], GetFileExInfoStandard, &attr)) {
+		return false;
+	}
+#endif
+	lastWriteTime = attr.ftLastWriteTime;
+#endif
+	*time = static_cast<std::int64_t>((static_cast<std::uint64_t>(lastWriteTime.dwHighDateTime) << 32) | lastWriteTime.dwLowDateTime);
+	return true;
+#else
+	struct ::stat statResult;
+	if (::stat(path, &statResult) == -1)
+		return false;
+	// Nanoseconds where the platform has them, so that two writes within the same second differ
+#if defined(__APPLE__)
+	*time = static_cast<std::int64_t>(statResult.st_mtimespec.tv_sec) * 1000000000 + statResult.st_mtimespec.tv_nsec;
+#elif defined(__linux__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__) || defined(__HAIKU__)
+	*time = static_cast<std::int64_t>(statResult.st_mtim.tv_sec) * 1000000000 + statResult.st_mtim.tv_nsec;
+#else
+	*time = static_cast<std::int64_t>(statResult.st_mtime);
+#endif
+	return true;
+#endif
+}
+
 bool CreateDir(const char *path)
 {
 #ifdef DVL_HAS_FILESYSTEM
@@ -391,25 +443,28 @@ bool ResizeFile(const char *path, std::uintmax_t size)
 #endif
 }
 
-void RenameFile(const char *from, const char *to)
+bool RenameFile(const char *from, const char *to)
 {
 #ifdef _WIN32
 #ifdef DEVILUTIONX_WINDOWS_NO_WCHAR
-	::MoveFile(from, to);
+	// MoveFileEx is not available on Windows 9x
+	::DeleteFileA(to);
+	return ::MoveFile(from, to) != 0;
 #else
 	const auto fromUtf16 = ToWideChar(from);
 	const auto toUtf16 = ToWideChar(to);
 	if (fromUtf16 == nullptr || toUtf16 == nullptr) {
 		LogError("UTF-8 -> UTF-16 conversion error code {}", ::GetLastError());
-		return;
+		return false;
 	}
-	::MoveFileW(&fromUtf16[0], &toUtf16[0]);
+	return ::MoveFileExW(&fromUtf16[0], &toUtf16[0], MOVEFILE_REPLACE_EXISTING) != 0;
 #endif // _WIN32
 #elif defined(DVL_HAS_FILESYSTEM)
 	std::error_code ec;
 	std::filesystem::rename(reinterpret_cast<const char8_t *>(from), reinterpret_cast<const char8_t *>(to), ec);
+	return !ec;
 #else
-	::rename(from, to);
+	return ::rename(from, to) == 0;
 #endif
 }
 
@@ -506,6 +561,19 @@ FILE *OpenFile(const char *path, const char *mode)
 #endif
 }
 
+bool SyncFile(FILE *file)
+{
+	if (std::fflush(file) != 0)
+		return false;
+#ifdef _WIN32
+	return ::_commit(::_fileno(file)) == 0;
+#elif defined(DVL_HAS_POSIX_2001) && !defined(DEVILUTIONX_WINDOWS_NO_WCHAR)
+	return ::fsync(::fileno(file)) == 0;
+#else
+	return true;
+#endif
+}
+
 std::vector<std::string> ListDirectories(const char *path)
 {
 	std::vector<std::string> dirs;
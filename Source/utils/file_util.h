@@ -29,6 +29,14 @@ std::string_view Dirname(std::string_view path);
 bool FileExistsAndIsWriteable(const char *path);
 bool GetFileSize(const char *path, std::uintmax_t *size);
 
+/**
+ * @brief Gets the time a file was last written to.
+ *
+ * The unit and epoch depend on the platform, the time is only meant to be compared with another one of the same file.
+ * It is as fine as the platform allows: 100 ns on Windows, nanoseconds on Linux, macOS and the BSDs, seconds elsewhere.
+ */
+bool GetFileModificationTime(const char *path, std::int64_t *time);
+
 /**
  * @brief Creates a single directory (non-recursively).
  *
@@ -38,11 +46,24 @@ bool CreateDir(const char *path);
 
 void RecursivelyCreateDir(const char *path);
 bool ResizeFile(const char *path, std::uintmax_t size);
-void RenameFile(const char *from, const char *to);
+/**
+ * @brief Renames a file, replacing `to` if it exists.
+ *
+ * The replacement is atomic where the platform supports it, so `to` is always either the old or the new file.
+ * @return false if `to` wasn't replaced, e.g. because it is open in another handle on Windows.
+ */
+bool RenameFile(const char *from, const char *to);
 void CopyFileOverwrite(const char *from, const char *to);
 void RemoveFile(const char *path);
 FILE *OpenFile(const char *path, const char *mode);
 
+/**
+ * @brief Writes out the buffered data of a file and waits until the system has passed it on to the storage device.
+ *
+ * Only the flush is done on platforms without a way to sync a single file.
+ */
+bool SyncFile(FILE *file);
+
 #if defined(_WIN32) && !defined(DEVILUTIONX_WINDOWS_NO_WCHAR)
 std::unique_ptr<wchar_t[]> ToWideChar(std::string_view path);
 #endif
@@ -0,0 +1,201 @@
+#include "utils/frame_profiler.hpp"
+
+#ifdef DEVILUTIONX_FRAME_PROFILER
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "utils/allocation_tracker.hpp"
+#include "utils/file_util.h"
+#include "utils/log.hpp"
+#include "utils/paths.h"
+#include "utils/sdl_mutex.h"
+
+namespace devilution {
+
+namespace {
+
+/** @brief Stop recording trace events past this, about 6 MiB of them. The statistics are kept up to date regardless. */
+constexpr size_t MaxTraceEvents = 1 << 18;
+
+struct TraceEvent {
+	const char *name;
+	uint32_t thread;
+	uint64_t beginUs;
+	uint32_t durationUs;
+};
+
+struct Profiler {
+	SdlMutex mutex;
+	std::vector<FrameProfilerZoneStats> zones;
+	/** @brief Microseconds spent in each zone during the current frame. */
+	std::vector<uint64_t> currentFrame;
+#ifdef DEVILUTIONX_ALLOCATION_TRACKER
+	std::vector<uint64_t> currentFrameAllocations;
+#endif
+	std::vector<TraceEvent> events;
+	size_t frame = 0;
+};
+
+Profiler &GetProfiler()
+{
+	static Profiler profiler;
+	return profiler;
+}
+
+const std::chrono::steady_clock::time_point StartTime = std::chrono::steady_clock::now();
+
+uint64_t NowUs()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - StartTime).count());
+}
+
+std::atomic<uint32_t> NextThread;
+thread_local const uint32_t CurrentThread = NextThread++;
+thread_local int CurrentDepth = 0;
+
+size_t HistogramBucket(uint64_t us)
+{
+	size_t bucket = 0;
+	while (bucket + 1 < FrameProfilerHistogramBuckets && us >= (uint64_t { 1 } << bucket))
+		++bucket;
+	return bucket;
+}
+
+} // namespace
+
+size_t RegisterFrameProfilerZone(const char *name)
+{
+	Profiler &profiler = GetProfiler();
+	const std::lock_guard<SdlMutex> lock(profiler.mutex);
+	FrameProfilerZoneStats zone {};
+	zone.name = name;
+	zone.depth = CurrentDepth;
+	profiler.zones.push_back(zone);
+	profiler.currentFrame.push_back(0);
+#ifdef DEVILUTIONX_ALLOCATION_TRACKER
+	profiler.currentFrameAllocations.push_back(0);
+#endif
+	return profiler.zones.size() - 1;
+}
+
+FrameProfilerScope::FrameProfilerScope(size_t zone)
+    : zone_(zone)
+    , beginUs_(NowUs())
+#ifdef DEVILUTIONX_ALLOCATION_TRACKER
+    , beginAllocations_(GetThreadAllocationCounts().allocations)
+#endif
+{
+	++CurrentDepth;
+}
+
+FrameProfilerScope::~FrameProfilerScope()
+{
+	const uint64_t durationUs = NowUs() - beginUs_;
+#ifdef DEVILUTIONX_ALLOCATION_TRACKER
+	const uint64_t allocations = GetThreadAllocationCounts().allocations - beginAllocations_;
+#endif
+	--CurrentDepth;
+	Profiler &profiler = GetProfiler();
+	const std::lock_guard<SdlMutex> lock(profiler.mutex);
+	profiler.currentFrame[zone_] += durationUs;
+#ifdef DEVILUTIONX_ALLOCATION_TRACKER
+	profiler.currentFrameAllocations[zone_] += allocations;
+#endif
+	if (profiler.events.size() < MaxTraceEvents) {
+		profiler.events.push_back(TraceEvent { profiler.zones[zone_].name, CurrentThread, beginUs_, static_cast<uint32_t>(durationUs) });
+	}
+}
+
+void FrameProfilerEndFrame()
+{
+	Profiler &profiler = GetProfiler();
+	const std::lock_guard<SdlMutex> lock(profiler.mutex);
+	const size_t slot = profiler.frame % FrameProfilerWindow;
+	const size_t windowSize = std::min(profiler.frame + 1, FrameProfilerWindow);
+	for (size_t i = 0; i < profiler.zones.size(); ++i) {
+		FrameProfilerZoneStats &zone = profiler.zones[i];
+		const auto us = static_cast<uint32_t>(std::min<uint64_t>(profiler.currentFrame[i], UINT32_MAX));
+		profiler.currentFrame[i] = 0;
+		zone.frameTimes[slot] = us;
+		if (us != 0)
+			++zone.histogram[HistogramBucket(us)];
+		uint64_t total = 0;
+		uint32_t max = 0;
+		for (size_t j = 0; j < windowSize; ++j) {
+			total += zone.frameTimes[j];
+			max = std::max(max, zone.frameTimes[j]);
+		}
+		zone.lastUs = us;
+		zone.averageUs = static_cast<uint32_t>(total / windowSize);
+		zone.maxUs = max;
+#ifdef DEVILUTIONX_ALLOCATION_TRACKER
+		zone.lastAllocations = static_cast<uint32_t>(std::min<uint64_t>(profiler.currentFrameAllocations[i], UINT32_MAX));
+		zone.maxAllocations = std::max(zone.maxAllocations, zone.lastAllocations);
+		profiler.currentFrameAllocations[i] = 0;
+#endif
+	}
+	++profiler.frame;
+}
+
+std::span<const FrameProfilerZoneStats> GetFrameProfilerZones()
+{
+	return GetProfiler().zones;
+}
+
+void WriteFrameProfilerTrace()
+{
+	Profiler &profiler = GetProfiler();
+	const std::lock_guard<SdlMutex> lock(profiler.mutex);
+	if (profiler.zones.empty())
+		return;
+
+	for (const FrameProfilerZoneStats &zone : profiler.zones) {
+		std::string buckets;
+		for (size_t i = 0; i < FrameProfilerHistogramBuckets; ++i) {
+			if (zone.histogram[i] == 0)
+				continue;
+			if (i + 1 == FrameProfilerHistogramBuckets)
+				buckets += fmt::format(" >={}us:{}", uint64_t { 1 } << (i - 1), zone.histogram[i]);
+			else
+				buckets += fmt::format(" <{}us:{}", uint64_t { 1 } << i, zone.histogram[i]);
+		}
+#ifdef DEVILUTIONX_ALLOCATION_TRACKER
+		buckets += fmt::format(", at most {} allocations in a frame", zone.maxAllocations);
+#endif
+		LogInfo("Frame profiler: {:<{}}{}{}", "", zone.depth * 2, zone.name, buckets);
+	}
+
+	const std::string path = paths::PrefPath() + "frame_profile.json";
+	FILE *file = OpenFile(path.c_str(), "wb");
+	if (file == nullptr) {
+		LogError("Frame profiler: failed to open {}", path);
+		return;
+	}
+	fmt::memory_buffer out;
+	fmt::format_to(std::back_inserter(out), "{{\"traceEvents\":[\n");
+	for (size_t i = 0; i < profiler.events.size(); ++i) {
+		const TraceEvent &event = profiler.events[i];
+		fmt::format_to(std::back_inserter(out), "{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{},\"dur\":{}}}{}\n",
+		    event.name, event.thread, event.beginUs, event.durationUs, i + 1 < profiler.events.size() ? "," : "");
+		if (out.size() >= 1 << 16) {
+			std::fwrite(out.data(), 1, out.size(), file);
+			out.clear();
+		}
+	}
+	fmt::format_to(std::back_inserter(out), "]}}\n");
+	std::fwrite(out.data(), 1, out.size(), file);
+	std::fclose(file);
+	LogInfo("Frame profiler: wrote {} trace events to {}", profiler.events.size(), path);
+}
+
+} // namespace devilution
+
+#endif // DEVILUTIONX_FRAME_PROFILER
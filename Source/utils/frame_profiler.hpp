@@ -0,0 +1,97 @@
+/**
+ * @file frame_profiler.hpp
+ *
+ * Scoped timers for the main parts of a frame.
+ *
+ * Only built with `DEVILUTIONX_FRAME_PROFILER`, otherwise `DVL_PROFILE_ZONE` expands to nothing.
+ * With `DEVILUTIONX_ALLOCATION_TRACKER`, the zones also count heap allocations.
+ */
+#pragma once
+
+#ifdef DEVILUTIONX_FRAME_PROFILER
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace devilution {
+
+/** @brief Number of frames that the overlay averages over. */
+constexpr size_t FrameProfilerWindow = 128;
+
+/** @brief Bucket `i` counts the frames that spent less than 2^i microseconds in the zone, the last bucket counts the rest. */
+constexpr size_t FrameProfilerHistogramBuckets = 20;
+
+struct FrameProfilerZoneStats {
+	const char *name;
+
+	/** @brief How many zones the zone was nested in when it was first entered. */
+	int depth;
+
+	/** @brief Microseconds spent in the zone during each of the last `FrameProfilerWindow` frames. */
+	std::array<uint32_t, FrameProfilerWindow> frameTimes;
+
+	/** @brief Number of frames by the time spent in the zone, frames in which the zone wasn't entered are not counted. */
+	std::array<uint32_t, FrameProfilerHistogramBuckets> histogram;
+
+	uint32_t lastUs;
+	uint32_t averageUs;
+	uint32_t maxUs;
+
+#ifdef DEVILUTIONX_ALLOCATION_TRACKER
+	/** @brief Heap allocations made in the zone during the last frame, by the threads that entered it. */
+	uint32_t lastAllocations;
+	uint32_t maxAllocations;
+#endif
+};
+
+/** @brief Registers a zone, called once for each `DVL_PROFILE_ZONE`. */
+size_t RegisterFrameProfilerZone(const char *name);
+
+/**
+ * @brief Times the enclosing scope, use `DVL_PROFILE_ZONE` rather than this directly.
+ *
+ * Zones can be entered from any thread, their times are added up.
+ */
+class FrameProfilerScope {
+public:
+	explicit FrameProfilerScope(size_t zone);
+	~FrameProfilerScope();
+
+	FrameProfilerScope(const FrameProfilerScope &) = delete;
+	FrameProfilerScope &operator=(const FrameProfilerScope &) = delete;
+
+private:
+	size_t zone_;
+	uint64_t beginUs_;
+#ifdef DEVILUTIONX_ALLOCATION_TRACKER
+	uint64_t beginAllocations_;
+#endif
+};
+
+/** @brief Adds the times of the zones since the previous call to their statistics. */
+void FrameProfilerEndFrame();
+
+/** @brief The zones in the order they were first entered. Only valid on the main thread. */
+std::span<const FrameProfilerZoneStats> GetFrameProfilerZones();
+
+/**
+ * @brief Writes the recorded zones as a Chrome trace (chrome://tracing, Perfetto) to `frame_profile.json`
+ * in the pref path, and logs the histograms.
+ */
+void WriteFrameProfilerTrace();
+
+} // namespace devilution
+
+#define DVL_PROFILE_ZONE_CONCAT_INNER(x, y) x##y
+#define DVL_PROFILE_ZONE_CONCAT(x, y) DVL_PROFILE_ZONE_CONCAT_INNER(x, y)
+#define DVL_PROFILE_ZONE(name)                                                                                                      \
+	static const size_t DVL_PROFILE_ZONE_CONCAT(frameProfilerZone, __LINE__) = ::devilution::RegisterFrameProfilerZone(name); \
+	const ::devilution::FrameProfilerScope DVL_PROFILE_ZONE_CONCAT(frameProfilerScope, __LINE__) { DVL_PROFILE_ZONE_CONCAT(frameProfilerZone, __LINE__) }
+
+#else
+
+#define DVL_PROFILE_ZONE(name)
+
+#endif
@@ -41,8 +41,12 @@ using namespace devilution;
 // and what translators use to test their work.
 constexpr std::array<const char *, 2> Extensions { ".mo", ".gmo" };
 
+/** @brief The whole catalog, when it was read in one go. The keys that are null-terminated in it point into it directly. */
+std::unique_ptr<std::byte[]> translationFile;
+/** @brief Copies of the keys that can't be used in place. */
 std::unique_ptr<char[]> translationKeys;
 std::unique_ptr<char[]> translationValues;
+size_t translationValuesSize = 0;
 
 using TranslationRef = uint32_t;
 
@@ -283,6 +287,19 @@ bool ReadEntry(const std::byte *data, size_t dataSize, const MoEntry &e, char *r
 	return true;
 }
 
+/**
+ * @brief Returns the string of an entry in place, if the catalog has the terminator that the MO format asks for.
+ * @return nullptr if the string has to be copied.
+ */
+const char *GetEntryInPlace(const std::byte *data, size_t dataSize, const MoEntry &e)
+{
+	if (data == nullptr || e.offset >= dataSize || e.length >= dataSize - e.offset)
+		return nullptr;
+	if (data[e.offset + e.length] != std::byte { 0 })
+		return nullptr;
+	return reinterpret_cast<const char *>(data + e.offset);
+}
+
 } // namespace
 
 std::string_view LanguageParticularTranslate(std::string_view context, std::string_view message)
@@ -339,6 +356,13 @@ bool HasTranslation(const std::string &locale)
 	});
 }
 
+std::string_view GetTranslatedText()
+{
+	if (translationValues == nullptr)
+		return {};
+	return { &translationValues[0], translationValuesSize };
+}
+
 std::string_view GetLanguageCode()
 {
 	if (!forceLocale.empty())
@@ -349,8 +373,10 @@ std::string_view GetLanguageCode()
 void LanguageInitialize()
 {
 	translation = { {}, {} };
+	translationFile = nullptr;
 	translationKeys = nullptr;
 	translationValues = nullptr;
+	translationValuesSize = 0;
 
 	const std::string lang(GetLanguageCode());
 
@@ -474,32 +500,43 @@ void LanguageInitialize()
 	size_t keysSize = 0;
 	size_t valuesSize = 0;
 	for (uint32_t i = 1; i < head.nbMappings; i++) {
-		keysSize += src[i].length + 1;
+		if (GetEntryInPlace(data.get(), fileSize, src[i]) == nullptr)
+			keysSize += src[i].length + 1;
 		valuesSize += dst[i].length + 1;
 	}
-	translationKeys = std::unique_ptr<char[]> { new char[keysSize] };
+	if (keysSize != 0)
+		translationKeys = std::unique_ptr<char[]> { new char[keysSize] };
 	translationValues = std::unique_ptr<char[]> { new char[valuesSize] };
+	translationValuesSize = valuesSize;
 
-	char *keyPtr = &translationKeys[0];
+	char *keyPtr = translationKeys.get();
 	char *valuePtr = &translationValues[0];
 	translation[0].reserve(head.nbMappings - 1);
 	for (uint32_t i = 1; i < head.nbMappings; i++) {
-		if (readWholeFile
-		        ? ReadEntry(data.get(), fileSize, src[i], keyPtr) && ReadEntry(data.get(), fileSize, dst[i], valuePtr)
-		        : ReadEntry(handle, src[i], keyPtr) && ReadEntry(handle, dst[i], valuePtr)) {
+		// Keys are only looked up, so they can stay in the catalog, the values are copied to keep them together for `GetTranslatedText`
+		const char *key = GetEntryInPlace(data.get(), fileSize, src[i]);
+		const bool copyKey = key == nullptr;
+		bool keyRead = true;
+		if (copyKey) {
+			key = keyPtr;
+			keyRead = readWholeFile ? ReadEntry(data.get(), fileSize, src[i], keyPtr) : ReadEntry(handle, src[i], keyPtr);
+		}
+		if (keyRead && (readWholeFile ? ReadEntry(data.get(), fileSize, dst[i], valuePtr) : ReadEntry(handle, dst[i], valuePtr))) {
 			// Plural keys also have a plural form but it does not participate in lookup.
 			// Plural values are \0-terminated.
 			std::string_view value { valuePtr, dst[i].length + 1 };
 			for (size_t j = 0; j < PluralForms && !value.empty(); j++) {
 				const size_t formValueEnd = value.find('\0');
-				translation[j].emplace(keyPtr, EncodeTranslationRef(static_cast<uint32_t>(value.data() - &translationValues[0]), static_cast<uint32_t>(formValueEnd)));
+				translation[j].emplace(key, EncodeTranslationRef(static_cast<uint32_t>(value.data() - &translationValues[0]), static_cast<uint32_t>(formValueEnd)));
 				value.remove_prefix(formValueEnd + 1);
 			}
 
-			keyPtr += src[i].length + 1;
+			if (copyKey)
+				keyPtr += src[i].length + 1;
 			valuePtr += dst[i].length + 1;
 		}
 	}
+	translationFile = std::move(data);
 
 	LogVerbose(StrCat("Loaded translations from ", translationsPath, " in ", SDL_GetTicks() - loadTranslationsStart, "ms"));
 }
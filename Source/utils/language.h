@@ -13,6 +13,11 @@ extern std::string forceLocale;
 
 std::string_view GetLanguageCode();
 
+/**
+ * @brief Returns all the translated strings of the current language, separated by null characters.
+ */
+std::string_view GetTranslatedText();
+
 bool HasTranslation(const std::string &locale);
 void LanguageInitialize();
 
@@ -0,0 +1,112 @@
+/**
+ * @file level_load_timings.cpp
+ *
+ * Implementation of the level load timings.
+ */
+#include "utils/level_load_timings.hpp"
+
+#include <chrono>
+
+#include <fmt/format.h>
+
+#include "levels/gendung.h"
+#include "utils/log.hpp"
+
+namespace devilution {
+
+namespace {
+
+constexpr std::array<const char *, NumLevelLoadPhases> PhaseNames = {
+	"saveLevel",
+	"tables",
+	"tileGraphics",
+	"dungeon",
+	"monsterTypes",
+	"sprites",
+	"objects",
+	"monsters",
+	"loadLevel",
+	"lightVision",
+	"music",
+};
+
+uint64_t NowUs()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+#ifdef DEVILUTIONX_FRAME_PROFILER
+size_t ProfilerZone(LevelLoadPhase phase)
+{
+	// Registered on first use, so that the phases come after the zones of the frame in the overlay
+	static const std::array<size_t, NumLevelLoadPhases> Zones = []() {
+		std::array<size_t, NumLevelLoadPhases> zones;
+		for (size_t i = 0; i < NumLevelLoadPhases; i++)
+			zones[i] = RegisterFrameProfilerZone(PhaseNames[i]);
+		return zones;
+	}();
+	return Zones[static_cast<size_t>(phase)];
+}
+#endif
+
+uint64_t LevelLoadBeginUs;
+LevelLoadTimings CurrentTimings;
+LevelLoadTimings LastTimings;
+
+} // namespace
+
+const char *LevelLoadPhaseName(LevelLoadPhase phase)
+{
+	return PhaseNames[static_cast<size_t>(phase)];
+}
+
+LevelLoadPhaseTimer::LevelLoadPhaseTimer(LevelLoadPhase phase)
+    : phase_(phase)
+    , beginUs_(NowUs())
+#ifdef DEVILUTIONX_FRAME_PROFILER
+    , profilerScope_(ProfilerZone(phase))
+#endif
+{
+}
+
+LevelLoadPhaseTimer::~LevelLoadPhaseTimer()
+{
+	CurrentTimings.phaseUs[static_cast<size_t>(phase_)] += static_cast<uint32_t>(NowUs() - beginUs_);
+}
+
+void BeginLevelLoadTimings()
+{
+	CurrentTimings = {};
+	LevelLoadBeginUs = NowUs();
+}
+
+void EndLevelLoadTimings()
+{
+	CurrentTimings.level = currlevel;
+	CurrentTimings.setlevel = setlevel;
+	CurrentTimings.totalUs = static_cast<uint32_t>(NowUs() - LevelLoadBeginUs);
+	LastTimings = CurrentTimings;
+
+	std::string phases;
+	for (size_t i = 0; i < NumLevelLoadPhases; i++) {
+		if (LastTimings.phaseUs[i] != 0)
+			phases += fmt::format(", {} {:.1f}", PhaseNames[i], LastTimings.phaseUs[i] / 1000.0);
+	}
+	LogVerbose("Entered {}level {} in {:.1f} ms{}", LastTimings.setlevel ? "set " : "", LastTimings.level, LastTimings.totalUs / 1000.0, phases);
+}
+
+const LevelLoadTimings &GetLastLevelLoadTimings()
+{
+	return LastTimings;
+}
+
+std::string FormatLevelLoadTimingsJson(const LevelLoadTimings &timings)
+{
+	std::string phases;
+	for (size_t i = 0; i < NumLevelLoadPhases; i++)
+		phases += fmt::format(R"({}"{}": {:.3f})", i == 0 ? "" : ", ", PhaseNames[i], timings.phaseUs[i] / 1000.0);
+	return fmt::format(R"({{"level": {}, "setlevel": {}, "totalMs": {:.3f}, "phasesMs": {{{}}}}})",
+	    timings.level, timings.setlevel, timings.totalUs / 1000.0, phases);
+}
+
+} // namespace devilution
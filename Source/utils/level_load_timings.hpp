@@ -0,0 +1,85 @@
+/**
+ * @file level_load_timings.hpp
+ *
+ * How long the steps of entering a level take, e.g. when taking the stairs.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "utils/frame_profiler.hpp"
+
+namespace devilution {
+
+enum class LevelLoadPhase : uint8_t {
+	/** @brief Saving the level that is left, or its delta in multiplayer. */
+	SaveLevel,
+	/** @brief The palette translations, light table and tile properties. */
+	Tables,
+	/** @brief The dungeon tiles. */
+	TileGraphics,
+	/** @brief Generating the level or loading the set piece. */
+	Dungeon,
+	/** @brief Picking the monster types and loading their sprites. */
+	MonsterTypes,
+	/** @brief The object and missile sprites. */
+	Sprites,
+	Objects,
+	Monsters,
+	/** @brief Restoring a level that was visited before. */
+	LoadLevel,
+	LightVision,
+	Music,
+	LAST = Music,
+};
+
+constexpr size_t NumLevelLoadPhases = static_cast<size_t>(LevelLoadPhase::LAST) + 1;
+
+struct LevelLoadTimings {
+	uint8_t level;
+	bool setlevel;
+	uint32_t totalUs;
+	/** @brief The time spent in each phase, the rest of the total is spent in steps that are too short to be worth a phase. */
+	std::array<uint32_t, NumLevelLoadPhases> phaseUs;
+};
+
+/** @brief The name of the phase in the log, the profiler overlay and JSON reports. */
+const char *LevelLoadPhaseName(LevelLoadPhase phase);
+
+/**
+ * @brief Adds the time spent in the enclosing scope to a phase of the level being entered.
+ *
+ * The phase is also a zone of the frame profiler, so that it shows up in the overlay.
+ */
+class LevelLoadPhaseTimer {
+public:
+	explicit LevelLoadPhaseTimer(LevelLoadPhase phase);
+	~LevelLoadPhaseTimer();
+
+	LevelLoadPhaseTimer(const LevelLoadPhaseTimer &) = delete;
+	LevelLoadPhaseTimer &operator=(const LevelLoadPhaseTimer &) = delete;
+
+private:
+	LevelLoadPhase phase_;
+	uint64_t beginUs_;
+#ifdef DEVILUTIONX_FRAME_PROFILER
+	FrameProfilerScope profilerScope_;
+#endif
+};
+
+/** @brief Starts timing the entry into a level, the phases timed before are dropped. */
+void BeginLevelLoadTimings();
+
+/** @brief Stops timing the entry into the current level and logs the phases. */
+void EndLevelLoadTimings();
+
+/** @brief The timings of the level entered last. */
+const LevelLoadTimings &GetLastLevelLoadTimings();
+
+/** @brief The timings as a JSON object, with the times in milliseconds. */
+std::string FormatLevelLoadTimingsJson(const LevelLoadTimings &timings);
+
+} // namespace devilution
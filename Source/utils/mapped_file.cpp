@@ -0,0 +1,115 @@
+#include "utils/mapped_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#if defined(_WIN32)
+// Suppress definitions of `min` and `max` macros by <windows.h>:
+#define NOMINMAX 1
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#include "utils/file_util.h"
+#define DVL_HAS_MAPPED_FILES
+#elif (defined(__unix__) || defined(__APPLE__)) && !defined(__DJGPP__) && !defined(__SWITCH__) && !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DVL_HAS_MAPPED_FILES
+#endif
+
+namespace devilution {
+
+namespace {
+
+#ifdef DVL_HAS_MAPPED_FILES
+void Unmap(const std::byte *data, [[maybe_unused]] size_t size)
+{
+	if (data == nullptr)
+		return;
+#ifdef _WIN32
+	::UnmapViewOfFile(data);
+#else
+	::munmap(const_cast<std::byte *>(data), size);
+#endif
+}
+#endif
+
+} // namespace
+
+std::optional<MappedFile> MappedFile::Open([[maybe_unused]] const char *path)
+{
+#if defined(_WIN32) && defined(DVL_HAS_MAPPED_FILES)
+#ifdef DEVILUTIONX_WINDOWS_NO_WCHAR
+	HANDLE file = ::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+#else
+	const auto pathUtf16 = ToWideChar(path);
+	if (pathUtf16 == nullptr)
+		return std::nullopt;
+	HANDLE file = ::CreateFileW(&pathUtf16[0], GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+#endif
+	if (file == INVALID_HANDLE_VALUE)
+		return std::nullopt;
+	LARGE_INTEGER size;
+	if (::GetFileSizeEx(file, &size) == 0 || size.QuadPart == 0 || static_cast<uint64_t>(size.QuadPart) > SIZE_MAX) {
+		::CloseHandle(file);
+		return std::nullopt;
+	}
+	HANDLE mapping = ::CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	::CloseHandle(file);
+	if (mapping == NULL)
+		return std::nullopt;
+	const void *data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	::CloseHandle(mapping);
+	if (data == nullptr)
+		return std::nullopt;
+	return MappedFile { static_cast<const std::byte *>(data), static_cast<size_t>(size.QuadPart) };
+#elif defined(DVL_HAS_MAPPED_FILES)
+	const int fd = ::open(path, O_RDONLY);
+	if (fd == -1)
+		return std::nullopt;
+	struct stat st;
+	if (::fstat(fd, &st) != 0 || st.st_size <= 0 || static_cast<uintmax_t>(st.st_size) > SIZE_MAX) {
+		::close(fd);
+		return std::nullopt;
+	}
+	const auto size = static_cast<size_t>(st.st_size);
+	void *data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (data == MAP_FAILED)
+		return std::nullopt;
+	return MappedFile { static_cast<const std::byte *>(data), size };
+#else
+	return std::nullopt;
+#endif
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+{
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+	if (this != &other) {
+#ifdef DVL_HAS_MAPPED_FILES
+		Unmap(data_, size_);
+#endif
+		data_ = std::exchange(other.data_, nullptr);
+		size_ = std::exchange(other.size_, 0);
+	}
+	return *this;
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef DVL_HAS_MAPPED_FILES
+	Unmap(data_, size_);
+#endif
+}
+
+} // namespace devilution
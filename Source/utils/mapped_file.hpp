@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+
+namespace devilution {
+
+/**
+ * @brief A read-only memory mapping of a whole file.
+ *
+ * Only available on platforms with `mmap` or `MapViewOfFile`,
+ * `Open` returns `std::nullopt` everywhere else.
+ */
+class MappedFile {
+public:
+	static std::optional<MappedFile> Open(const char *path);
+
+	MappedFile(MappedFile &&other) noexcept;
+	MappedFile &operator=(MappedFile &&other) noexcept;
+	~MappedFile();
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	[[nodiscard]] std::span<const std::byte> data() const { return { data_, size_ }; }
+
+private:
+	MappedFile(const std::byte *data, size_t size)
+	    : data_(data)
+	    , size_(size)
+	{
+	}
+
+	const std::byte *data_ = nullptr;
+	size_t size_ = 0;
+};
+
+} // namespace devilution
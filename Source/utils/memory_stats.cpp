@@ -0,0 +1,59 @@
+/**
+ * @file memory_stats.cpp
+ *
+ * Implementation of the memory reports.
+ */
+#include "utils/memory_stats.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#ifdef USE_SDL3
+#include <SDL3/SDL_timer.h>
+#else
+#include <SDL.h>
+#endif
+
+#include <fmt/format.h>
+#include <magic_enum/magic_enum.hpp>
+
+#include "utils/log.hpp"
+
+namespace devilution {
+
+namespace {
+
+constexpr uint32_t LogIntervalMs = 60 * 1000;
+
+uint32_t LastLogTime;
+
+} // namespace
+
+std::string MemoryStatsReport()
+{
+	std::string report = "Memory held (peak), in KiB:";
+	size_t total = 0;
+	for (size_t i = 0; i < MemoryTagCounters.size(); i++) {
+		const auto tag = static_cast<MemoryTag>(i);
+		const size_t current = MemoryTagCounters[i].current.load(std::memory_order_relaxed);
+		const size_t peak = MemoryTagCounters[i].peak.load(std::memory_order_relaxed);
+		// Fonts are part of the sprites
+		if (tag != MemoryTag::Fonts)
+			total += current;
+		report += fmt::format("\n{}: {} ({})", magic_enum::enum_name(tag), current / 1024, peak / 1024);
+	}
+	report += fmt::format("\nTotal: {}", total / 1024);
+	return report;
+}
+
+void LogMemoryStatsPeriodically()
+{
+	const uint32_t now = SDL_GetTicks();
+	if (LastLogTime != 0 && now - LastLogTime < LogIntervalMs)
+		return;
+	LastLogTime = now;
+	LogVerbose("{}", MemoryStatsReport());
+}
+
+} // namespace devilution
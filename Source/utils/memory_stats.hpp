@@ -0,0 +1,120 @@
+/**
+ * @file memory_stats.hpp
+ *
+ * Counters of the memory held by the larger subsystems, with their high-water marks.
+ *
+ * The counters are inline so that any library can count its memory without linking anything.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace devilution {
+
+enum class MemoryTag : uint8_t {
+	/** @brief All loaded sprite lists and sheets, including the fonts. */
+	Sprites,
+	/** @brief The font rows, these are also counted in `Sprites`. */
+	Fonts,
+	DungeonCels,
+	Sounds,
+	Lua,
+	SaveBuffers,
+	NetworkQueues,
+
+	LAST = NetworkQueues,
+};
+
+struct MemoryTagCounter {
+	std::atomic<size_t> current;
+	std::atomic<size_t> peak;
+};
+
+/** @brief Indexed by `MemoryTag`, updated from any thread. */
+inline std::array<MemoryTagCounter, static_cast<size_t>(MemoryTag::LAST) + 1> MemoryTagCounters;
+
+namespace detail {
+
+inline void RaiseMemoryPeak(MemoryTagCounter &counter, size_t current)
+{
+	size_t peak = counter.peak.load(std::memory_order_relaxed);
+	while (current > peak && !counter.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+	}
+}
+
+} // namespace detail
+
+inline void MemoryStatsAdd(MemoryTag tag, size_t bytes)
+{
+	MemoryTagCounter &counter = MemoryTagCounters[static_cast<size_t>(tag)];
+	detail::RaiseMemoryPeak(counter, counter.current.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+}
+
+inline void MemoryStatsRemove(MemoryTag tag, size_t bytes)
+{
+	MemoryTagCounters[static_cast<size_t>(tag)].current.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+/** @brief For memory that is owned in one place and replaced as a whole, e.g. the CELs of the current level. */
+inline void MemoryStatsSet(MemoryTag tag, size_t bytes)
+{
+	MemoryTagCounter &counter = MemoryTagCounters[static_cast<size_t>(tag)];
+	counter.current.store(bytes, std::memory_order_relaxed);
+	detail::RaiseMemoryPeak(counter, bytes);
+}
+
+/**
+ * @brief Counts `bytes` under `Tag` for as long as it lives, moving it moves the count along.
+ *
+ * Meant as a member next to the buffer it counts.
+ */
+template <MemoryTag Tag>
+class TrackedMemory {
+public:
+	TrackedMemory() = default;
+
+	explicit TrackedMemory(size_t bytes)
+	    : bytes_(bytes)
+	{
+		MemoryStatsAdd(Tag, bytes);
+	}
+
+	TrackedMemory(TrackedMemory &&other) noexcept
+	    : bytes_(std::exchange(other.bytes_, 0))
+	{
+	}
+
+	TrackedMemory &operator=(TrackedMemory &&other) noexcept
+	{
+		if (this != &other) {
+			MemoryStatsRemove(Tag, bytes_);
+			bytes_ = std::exchange(other.bytes_, 0);
+		}
+		return *this;
+	}
+
+	~TrackedMemory()
+	{
+		MemoryStatsRemove(Tag, bytes_);
+	}
+
+private:
+	size_t bytes_ = 0;
+};
+
+/**
+ * @brief Describes the memory held and the high-water mark of each tag.
+ */
+std::string MemoryStatsReport();
+
+/**
+ * @brief Logs the report at verbose priority once a minute, call once per game tick.
+ */
+void LogMemoryStatsPeriodically();
+
+} // namespace devilution
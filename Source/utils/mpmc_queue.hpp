@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace devilution {
+
+/**
+ * @brief A bounded lock-free multi-producer multi-consumer queue.
+ *
+ * Each slot carries a sequence number that tells producers and consumers
+ * whether it is free or holds a value for the current lap around the ring.
+ * See https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ *
+ * @tparam T element type, must be default-constructible and movable.
+ * @tparam N capacity, must be a power of two.
+ */
+template <typename T, size_t N>
+class BoundedMpmcQueue {
+	static_assert(N >= 2 && (N & (N - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	BoundedMpmcQueue()
+	{
+		for (size_t i = 0; i < N; ++i)
+			slots_[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	BoundedMpmcQueue(const BoundedMpmcQueue &) = delete;
+	BoundedMpmcQueue &operator=(const BoundedMpmcQueue &) = delete;
+
+	/**
+	 * @return false if the queue is full (the value is left untouched).
+	 */
+	bool tryPush(T &value)
+	{
+		size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+		Slot *slot;
+		for (;;) {
+			slot = &slots_[pos & (N - 1)];
+			const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+			if (diff == 0) {
+				if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			} else if (diff < 0) {
+				return false;
+			} else {
+				pos = enqueuePos_.load(std::memory_order_relaxed);
+			}
+		}
+		slot->value = std::move(value);
+		slot->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	std::optional<T> tryPop()
+	{
+		size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+		Slot *slot;
+		for (;;) {
+			slot = &slots_[pos & (N - 1)];
+			const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+			if (diff == 0) {
+				if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			} else if (diff < 0) {
+				return std::nullopt;
+			} else {
+				pos = dequeuePos_.load(std::memory_order_relaxed);
+			}
+		}
+		std::optional<T> result { std::move(slot->value) };
+		slot->value = T {};
+		slot->sequence.store(pos + N, std::memory_order_release);
+		return result;
+	}
+
+	[[nodiscard]] static constexpr size_t capacity() { return N; }
+
+private:
+	struct Slot {
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	std::array<Slot, N> slots_;
+	alignas(64) std::atomic<size_t> enqueuePos_ { 0 };
+	alignas(64) std::atomic<size_t> dequeuePos_ { 0 };
+};
+
+} // namespace devilution
@@ -1,15 +1,21 @@
 #include "utils/palette_blending.hpp"
 
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <span>
 
 #ifdef USE_SDL3
+#include <SDL3/SDL_cpuinfo.h>
 #include <SDL3/SDL_pixels.h>
 #else
 #include <SDL.h>
 #endif
 
+#include "utils/algorithm/rotate.hpp"
 #include "utils/palette_kd_tree.hpp"
+#include "utils/sdl_thread.h"
 
 namespace devilution {
 
@@ -26,6 +32,8 @@ namespace {
 
 PaletteKdTree CurrentPaletteKdTree;
 
+uint32_t BlendedLookupTableGeneration;
+
 using RGB = std::array<uint8_t, 3>;
 
 RGB BlendColors(const SDL_Color &a, const SDL_Color &b)
@@ -44,21 +52,73 @@ void SetPaletteTransparencyLookupBlack16(unsigned i, unsigned j)
 }
 #endif
 
+constexpr int MaxBlendingThreads = 8;
+
+int GetBlendingThreadCount()
+{
+#if defined(USE_SDL1) || defined(__DJGPP__)
+	return 1;
+#elif defined(USE_SDL3)
+	return std::clamp(SDL_GetNumLogicalCPUCores(), 1, MaxBlendingThreads);
+#else
+	return std::clamp(SDL_GetCPUCount(), 1, MaxBlendingThreads);
+#endif
+}
+
+struct BlendingRowsJob {
+	const SDL_Color *palette;
+	unsigned firstRow;
+	unsigned rowStep;
+};
+
+/**
+ * @brief Fills in the entries of the given rows that are above the diagonal.
+ *
+ * The rows get shorter towards the bottom, so every job takes every `rowStep`-th row to even out the work.
+ */
+void GenerateBlendedLookupTableRows(const BlendingRowsJob &job)
+{
+	std::array<RGB, 256> blended;
+	for (unsigned i = job.firstRow; i < 255; i += job.rowStep) {
+		for (unsigned j = i + 1; j < 256; j++) {
+			blended[j] = BlendColors(job.palette[i], job.palette[j]);
+		}
+		CurrentPaletteKdTree.findNearestNeighbors(std::span<const RGB>(blended).subspan(i + 1), &paletteTransparencyLookup[i][i + 1]);
+	}
+}
+
+int SDLCALL BlendingRowsThread(void *data)
+{
+	GenerateBlendedLookupTableRows(*static_cast<const BlendingRowsJob *>(data));
+	return 0;
+}
+
 } // namespace
 
 void GenerateBlendedLookupTable(const SDL_Color *palette, int skipFrom, int skipTo)
 {
 	CurrentPaletteKdTree = PaletteKdTree { palette, skipFrom, skipTo };
+	++BlendedLookupTableGeneration;
+
+	const int threads = GetBlendingThreadCount();
+	std::array<BlendingRowsJob, MaxBlendingThreads> jobs;
+	std::array<SdlThread, MaxBlendingThreads> workers;
+	for (int t = 0; t < threads; t++) {
+		jobs[t] = { palette, static_cast<unsigned>(t), static_cast<unsigned>(threads) };
+	}
+	for (int t = 1; t < threads; t++) {
+		workers[t] = SdlThread { BlendingRowsThread, &jobs[t] };
+	}
+	GenerateBlendedLookupTableRows(jobs[0]);
+	for (int t = 1; t < threads; t++) {
+		workers[t].join();
+	}
+
 	for (unsigned i = 0; i < 256; i++) {
 		paletteTransparencyLookup[i][i] = i;
-		unsigned j = 0;
-		for (; j < i; j++) {
+		for (unsigned j = 0; j < i; j++) {
 			paletteTransparencyLookup[i][j] = paletteTransparencyLookup[j][i];
 		}
-		++j;
-		for (; j < 256; j++) {
-			paletteTransparencyLookup[i][j] = CurrentPaletteKdTree.findNearestNeighbor(BlendColors(palette[i], palette[j]));
-		}
 	}
 
 #if DEVILUTIONX_PALETTE_TRANSPARENCY_BLACK_16_LUT
@@ -74,13 +134,16 @@ void GenerateBlendedLookupTable(const SDL_Color *palette, int skipFrom, int skip
 
 void UpdateBlendedLookupTableSingleColor(const SDL_Color *palette, unsigned i)
 {
+	std::array<RGB, 256> blended;
 	for (unsigned j = 0; j < 256; j++) {
-		if (i == j) { // No need to calculate transparency between 2 identical colors
-			paletteTransparencyLookup[i][j] = j;
-			continue;
-		}
-		const uint8_t best = CurrentPaletteKdTree.findNearestNeighbor(BlendColors(palette[i], palette[j]));
-		paletteTransparencyLookup[i][j] = paletteTransparencyLookup[j][i] = best;
+		blended[j] = BlendColors(palette[i], palette[j]);
+	}
+	CurrentPaletteKdTree.findNearestNeighbors(blended, paletteTransparencyLookup[i]);
+	++BlendedLookupTableGeneration;
+	// No need to calculate transparency between 2 identical colors
+	paletteTransparencyLookup[i][i] = i;
+	for (unsigned j = 0; j < 256; j++) {
+		paletteTransparencyLookup[j][i] = paletteTransparencyLookup[i][j];
 	}
 
 #if DEVILUTIONX_PALETTE_TRANSPARENCY_BLACK_16_LUT
@@ -88,6 +151,41 @@ void UpdateBlendedLookupTableSingleColor(const SDL_Color *palette, unsigned i)
 #endif
 }
 
+void CycleBlendedLookupTable(unsigned from, unsigned to, bool reverse)
+{
+	const size_t count = to - from + 1;
+	const auto rotate = [reverse](auto range) {
+		if (reverse)
+			RotateRightByOne(range);
+		else
+			RotateLeftByOne(range);
+	};
+
+	++BlendedLookupTableGeneration;
+	for (auto &row : paletteTransparencyLookup) {
+		rotate(std::span(row).subspan(from, count));
+	}
+	rotate(std::span(paletteTransparencyLookup).subspan(from, count));
+	// The diagonal is the only place where the cycled colors themselves are the result
+	for (unsigned i = from; i <= to; i++) {
+		paletteTransparencyLookup[i][i] = i;
+	}
+
+#if DEVILUTIONX_PALETTE_TRANSPARENCY_BLACK_16_LUT
+	// Both colors of an entry are permuted alike, so the table is rotated just like the one above
+	auto *black16Rows = reinterpret_cast<uint16_t(*)[256]>(paletteTransparencyLookupBlack16);
+	for (unsigned j = 0; j < 256; j++) {
+		rotate(std::span(black16Rows[j]).subspan(from, count));
+	}
+	rotate(std::span(black16Rows, 256).subspan(from, count));
+#endif
+}
+
+uint32_t GetBlendedLookupTableGeneration()
+{
+	return BlendedLookupTableGeneration;
+}
+
 #if DEVILUTIONX_PALETTE_TRANSPARENCY_BLACK_16_LUT
 void UpdateTransparencyLookupBlack16(unsigned from, unsigned to)
 {
@@ -33,6 +33,23 @@ void GenerateBlendedLookupTable(const SDL_Color *palette, int skipFrom = -1, int
  */
 void UpdateBlendedLookupTableSingleColor(const SDL_Color *palette, unsigned i);
 
+/**
+ * @brief Updates the lookup tables for the palette colors `from` to `to` having been rotated by one.
+ *
+ * The colors are only moved around, so are the entries of the tables, without any nearest color searches.
+ * Assumes that the colors were skipped when the table was generated, so that no other entry refers to them.
+ *
+ * @param reverse Whether the last color became the first, rather than the first becoming the last.
+ */
+void CycleBlendedLookupTable(unsigned from, unsigned to, bool reverse);
+
+/**
+ * @brief Changes whenever `paletteTransparencyLookup` is generated, updated or cycled.
+ *
+ * The palette cycling of some levels changes the table every few frames, anything that keeps blended pixels around is outdated then.
+ */
+uint32_t GetBlendedLookupTableGeneration();
+
 #if DEVILUTIONX_PALETTE_TRANSPARENCY_BLACK_16_LUT
 /**
  * A lookup table from black for a pair of colors in `logical_palette`.
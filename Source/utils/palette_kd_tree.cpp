@@ -1,5 +1,6 @@
 #include "utils/palette_kd_tree.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
@@ -7,6 +8,14 @@
 #include <string>
 #include <utility>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DEVILUTIONX_PALETTE_KD_TREE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define DEVILUTIONX_PALETTE_KD_TREE_NEON
+#include <arm_neon.h>
+#endif
+
 #ifdef USE_SDL3
 #include <SDL3/SDL_pixels.h>
 #elif defined(USE_SDL1)
@@ -33,6 +42,8 @@ template <>
 inline uint8_t GetColorComponent<1>(const SDL_Color &c) { return c.g; }
 template <>
 inline uint8_t GetColorComponent<2>(const SDL_Color &c) { return c.b; }
+template <size_t N>
+uint8_t GetColorComponent(const std::array<uint8_t, 3> &c) { return c[N]; }
 
 template <size_t RemainingDepth>
 [[nodiscard]] PaletteKdTreeNode<0> &LeafByIndex(PaletteKdTreeNode<RemainingDepth> &node, uint8_t index)
@@ -44,8 +55,8 @@ template <size_t RemainingDepth>
 	}
 }
 
-template <size_t RemainingDepth>
-[[nodiscard]] uint8_t LeafIndexForColor(const PaletteKdTreeNode<RemainingDepth> &node, const SDL_Color &color, uint8_t result = 0)
+template <size_t RemainingDepth, typename Color>
+[[nodiscard]] uint8_t LeafIndexForColor(const PaletteKdTreeNode<RemainingDepth> &node, const Color &color, uint8_t result = 0)
 {
 	const bool isLeft = GetColorComponent<PaletteKdTreeNode<RemainingDepth>::Coord>(color) < node.pivot;
 	if constexpr (RemainingDepth == 1) {
@@ -155,6 +166,9 @@ PaletteKdTree::PaletteKdTree(const SDL_Color palette[256], int skipFrom, int ski
 	for (uint8_t leafIndex = 0; leafIndex < NumLeaves; ++leafIndex) {
 		PaletteKdTreeNode<0> &leaf = LeafByIndex(tree_, leafIndex);
 		const std::span<const uint8_t> values = leafValues[leafIndex];
+		LeafBounds &bounds = leaves_[leafIndex];
+		bounds.min = { 255, 255, 255 };
+		bounds.max = { 0, 0, 0 };
 		if (values.empty()) {
 			leaf.valuesBegin = 1;
 			leaf.valuesEndInclusive = 0;
@@ -164,10 +178,17 @@ PaletteKdTree::PaletteKdTree(const SDL_Color palette[256], int skipFrom, int ski
 
 			for (size_t i = 0; i < values.size(); ++i) {
 				const uint8_t value = values[i];
-				values_[totalLen + i] = std::make_pair(RGB { palette[value].r, palette[value].g, palette[value].b }, value);
+				const RGB rgb { palette[value].r, palette[value].g, palette[value].b };
+				values_[totalLen + i] = std::make_pair(rgb, value);
+				for (size_t c = 0; c < 3; ++c) {
+					bounds.min[c] = std::min(bounds.min[c], rgb[c]);
+					bounds.max[c] = std::max(bounds.max[c], rgb[c]);
+				}
 			}
 			totalLen += values.size();
 		}
+		bounds.valuesBegin = leaf.valuesBegin;
+		bounds.valuesEndInclusive = leaf.valuesEndInclusive;
 	}
 
 #if DEVILUTIONX_PRINT_PALETTE_BLENDING_TREE_GRAPHVIZ
@@ -180,6 +201,195 @@ PaletteKdTree::PaletteKdTree(const SDL_Color palette[256], int skipFrom, int ski
 #endif
 }
 
+#if defined(DEVILUTIONX_PALETTE_KD_TREE_SSE2) || defined(DEVILUTIONX_PALETTE_KD_TREE_NEON)
+namespace {
+
+/** @brief The number of colors searched at once, in two vectors of 4. */
+constexpr size_t NearestNeighborsBatchSize = 8;
+
+#ifdef DEVILUTIONX_PALETTE_KD_TREE_SSE2
+/**
+ * @brief Colors as pairs of 16-bit lanes, so that `_mm_madd_epi16` squares and sums two components at once.
+ *
+ * `rg` holds the red and green components of 4 colors and `b` their blue components next to zeroes.
+ */
+struct ColorLanes {
+	__m128i rg;
+	__m128i b;
+};
+
+ColorLanes LoadColorLanes(const std::array<uint8_t, 3> *colors)
+{
+	ColorLanes lanes;
+	lanes.rg = _mm_setr_epi16(colors[0][0], colors[0][1], colors[1][0], colors[1][1], colors[2][0], colors[2][1], colors[3][0], colors[3][1]);
+	lanes.b = _mm_setr_epi32(colors[0][2], colors[1][2], colors[2][2], colors[3][2]);
+	return lanes;
+}
+
+ColorLanes BroadcastColor(const std::array<uint8_t, 3> &color)
+{
+	return { _mm_set1_epi32(color[0] | (color[1] << 16)), _mm_set1_epi32(color[2]) };
+}
+
+__m128i SquaredDistance(const ColorLanes &a, const ColorLanes &b)
+{
+	const __m128i rg = _mm_sub_epi16(a.rg, b.rg);
+	const __m128i blue = _mm_sub_epi16(a.b, b.b);
+	return _mm_add_epi32(_mm_madd_epi16(rg, rg), _mm_madd_epi16(blue, blue));
+}
+
+/** @brief The squared distance from each color to a box, 0 for colors inside of it. */
+__m128i SquaredDistanceToBox(const ColorLanes &colors, const ColorLanes &min, const ColorLanes &max)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i rg = _mm_max_epi16(_mm_max_epi16(_mm_sub_epi16(min.rg, colors.rg), _mm_sub_epi16(colors.rg, max.rg)), zero);
+	const __m128i blue = _mm_max_epi16(_mm_max_epi16(_mm_sub_epi16(min.b, colors.b), _mm_sub_epi16(colors.b, max.b)), zero);
+	return _mm_add_epi32(_mm_madd_epi16(rg, rg), _mm_madd_epi16(blue, blue));
+}
+
+__m128i MinKey(__m128i a, __m128i b)
+{
+	// The keys are less than 2^31, so a signed comparison works.
+	const __m128i lt = _mm_cmplt_epi32(a, b);
+	return _mm_or_si128(_mm_and_si128(lt, a), _mm_andnot_si128(lt, b));
+}
+
+__m128i KeyFromDistance(__m128i distance, __m128i index)
+{
+	return _mm_or_si128(_mm_slli_epi32(distance, 8), index);
+}
+
+bool AnyLessThan(__m128i a, __m128i b)
+{
+	return _mm_movemask_epi8(_mm_cmplt_epi32(a, b)) != 0;
+}
+
+__m128i InitialKeys() { return _mm_set1_epi32(0x7FFFFFFF); }
+
+__m128i BroadcastIndex(uint8_t index) { return _mm_set1_epi32(index); }
+
+void StoreKeys(__m128i keys, uint32_t *out) { _mm_storeu_si128(reinterpret_cast<__m128i *>(out), keys); }
+#else
+struct ColorLanes {
+	int32x4_t r;
+	int32x4_t g;
+	int32x4_t b;
+};
+
+ColorLanes LoadColorLanes(const std::array<uint8_t, 3> *colors)
+{
+	const int32_t r[4] = { colors[0][0], colors[1][0], colors[2][0], colors[3][0] };
+	const int32_t g[4] = { colors[0][1], colors[1][1], colors[2][1], colors[3][1] };
+	const int32_t b[4] = { colors[0][2], colors[1][2], colors[2][2], colors[3][2] };
+	return { vld1q_s32(r), vld1q_s32(g), vld1q_s32(b) };
+}
+
+ColorLanes BroadcastColor(const std::array<uint8_t, 3> &color)
+{
+	return { vdupq_n_s32(color[0]), vdupq_n_s32(color[1]), vdupq_n_s32(color[2]) };
+}
+
+uint32x4_t SquaredDistance(const ColorLanes &a, const ColorLanes &b)
+{
+	const int32x4_t r = vsubq_s32(a.r, b.r);
+	const int32x4_t g = vsubq_s32(a.g, b.g);
+	const int32x4_t blue = vsubq_s32(a.b, b.b);
+	return vreinterpretq_u32_s32(vmlaq_s32(vmlaq_s32(vmulq_s32(r, r), g, g), blue, blue));
+}
+
+int32x4_t DistanceToRange(int32x4_t x, int32x4_t min, int32x4_t max)
+{
+	return vmaxq_s32(vmaxq_s32(vsubq_s32(min, x), vsubq_s32(x, max)), vdupq_n_s32(0));
+}
+
+uint32x4_t SquaredDistanceToBox(const ColorLanes &colors, const ColorLanes &min, const ColorLanes &max)
+{
+	const int32x4_t r = DistanceToRange(colors.r, min.r, max.r);
+	const int32x4_t g = DistanceToRange(colors.g, min.g, max.g);
+	const int32x4_t blue = DistanceToRange(colors.b, min.b, max.b);
+	return vreinterpretq_u32_s32(vmlaq_s32(vmlaq_s32(vmulq_s32(r, r), g, g), blue, blue));
+}
+
+uint32x4_t MinKey(uint32x4_t a, uint32x4_t b) { return vminq_u32(a, b); }
+
+uint32x4_t KeyFromDistance(uint32x4_t distance, uint32x4_t index)
+{
+	return vorrq_u32(vshlq_n_u32(distance, 8), index);
+}
+
+bool AnyLessThan(uint32x4_t a, uint32x4_t b)
+{
+	const uint32x4_t lt = vcltq_u32(a, b);
+	const uint32x2_t halves = vorr_u32(vget_low_u32(lt), vget_high_u32(lt));
+	return (vget_lane_u32(halves, 0) | vget_lane_u32(halves, 1)) != 0;
+}
+
+uint32x4_t InitialKeys() { return vdupq_n_u32(0xFFFFFFFF); }
+
+uint32x4_t BroadcastIndex(uint8_t index) { return vdupq_n_u32(index); }
+
+void StoreKeys(uint32x4_t keys, uint32_t *out) { vst1q_u32(out, keys); }
+#endif
+
+} // namespace
+#endif
+
+void PaletteKdTree::findNearestNeighbors(std::span<const RGB> colors, uint8_t *out) const
+{
+	size_t i = 0;
+#if defined(DEVILUTIONX_PALETTE_KD_TREE_SSE2) || defined(DEVILUTIONX_PALETTE_KD_TREE_NEON)
+	for (; i + NearestNeighborsBatchSize <= colors.size(); i += NearestNeighborsBatchSize) {
+		const RGB *batch = &colors[i];
+		const ColorLanes queries[2] = { LoadColorLanes(batch), LoadColorLanes(batch + 4) };
+		auto best0 = InitialKeys();
+		auto best1 = InitialKeys();
+
+		const auto visitLeaf = [&](const LeafBounds &leaf) {
+			for (unsigned v = leaf.valuesBegin; v <= leaf.valuesEndInclusive; ++v) {
+				const auto &[paletteColor, paletteIndex] = values_[v];
+				const ColorLanes candidate = BroadcastColor(paletteColor);
+				const auto index = BroadcastIndex(paletteIndex);
+				best0 = MinKey(best0, KeyFromDistance(SquaredDistance(candidate, queries[0]), index));
+				best1 = MinKey(best1, KeyFromDistance(SquaredDistance(candidate, queries[1]), index));
+			}
+		};
+
+		// The leaves that contain the colors usually have the nearest neighbors,
+		// visiting them first lets the bounds checks skip most of the other leaves.
+		uint32_t visited = 0;
+		for (size_t j = 0; j < NearestNeighborsBatchSize; ++j) {
+			const uint8_t leafIndex = LeafIndexForColor(tree_, batch[j]);
+			if ((visited & (1U << leafIndex)) != 0)
+				continue;
+			visited |= 1U << leafIndex;
+			visitLeaf(leaves_[leafIndex]);
+		}
+		for (uint8_t leafIndex = 0; leafIndex < NumLeaves; ++leafIndex) {
+			const LeafBounds &leaf = leaves_[leafIndex];
+			if ((visited & (1U << leafIndex)) != 0 || leaf.valuesBegin > leaf.valuesEndInclusive)
+				continue;
+			const ColorLanes min = BroadcastColor(leaf.min);
+			const ColorLanes max = BroadcastColor(leaf.max);
+			const auto zero = BroadcastIndex(0);
+			if (AnyLessThan(KeyFromDistance(SquaredDistanceToBox(queries[0], min, max), zero), best0)
+			    || AnyLessThan(KeyFromDistance(SquaredDistanceToBox(queries[1], min, max), zero), best1)) {
+				visitLeaf(leaf);
+			}
+		}
+
+		uint32_t keys[NearestNeighborsBatchSize];
+		StoreKeys(best0, keys);
+		StoreKeys(best1, keys + 4);
+		for (size_t j = 0; j < NearestNeighborsBatchSize; ++j) {
+			out[i + j] = static_cast<uint8_t>(keys[j]);
+		}
+	}
+#endif
+	for (; i < colors.size(); ++i) {
+		out[i] = findNearestNeighbor(colors[i]);
+	}
+}
+
 std::string PaletteKdTree::toGraphvizDot() const
 {
 	std::string dot = "graph palette_tree {\n  rankdir=LR\n";
@@ -100,18 +100,31 @@ public:
 	PaletteKdTree(const SDL_Color palette[256], int skipFrom, int skipTo);
 
 	struct VisitState {
-		uint8_t best;
-		uint32_t bestDiff;
+		/**
+		 * @brief The squared distance to the best candidate, shifted left by 8, and its palette index.
+		 *
+		 * Comparing these keys prefers the lowest palette index among equally distant colors,
+		 * so the result does not depend on the order the candidates are visited in.
+		 */
+		uint32_t bestKey;
 	};
 
 	[[nodiscard]] uint8_t findNearestNeighbor(const RGB &rgb) const
 	{
 		VisitState visitState;
-		visitState.bestDiff = std::numeric_limits<uint32_t>::max();
+		visitState.bestKey = std::numeric_limits<uint32_t>::max();
 		findNearestNeighborVisit(tree_, rgb, visitState);
-		return visitState.best;
+		return static_cast<uint8_t>(visitState.bestKey);
 	}
 
+	/**
+	 * @brief Finds the nearest neighbor of each of the given colors.
+	 *
+	 * Same as calling `findNearestNeighbor` for each color, but with SIMD several colors
+	 * are searched at once, sharing a single pass over the leaf buckets.
+	 */
+	void findNearestNeighbors(std::span<const RGB> colors, uint8_t *out) const;
+
 	[[maybe_unused]] [[nodiscard]] std::string toGraphvizDot() const;
 
 private:
@@ -141,7 +154,7 @@ private:
 		// To see if we need to check a node's subtree, we compare the distance from the query
 		// to the current best candidate vs the distance to the edge of the half-space represented
 		// by the node.
-		if (getColorDistanceToPlane(node.pivot, coord) < visitState.bestDiff) {
+		if ((getColorDistanceToPlane(node.pivot, coord) << 8) < visitState.bestKey) {
 			findNearestNeighborVisit(node.child(coord >= node.pivot), rgb, visitState);
 		}
 	}
@@ -158,16 +171,26 @@ private:
 		const std::pair<RGB, uint8_t> *const end = values_.data() + node.valuesEndInclusive;
 		do {
 			const auto &[paletteColor, paletteIndex] = *it++;
-			const uint32_t diff = getColorDistance(paletteColor, rgb);
-			if (diff < visitState.bestDiff) {
-				visitState.best = paletteIndex;
-				visitState.bestDiff = diff;
+			const uint32_t key = (getColorDistance(paletteColor, rgb) << 8) | paletteIndex;
+			if (key < visitState.bestKey) {
+				visitState.bestKey = key;
 			}
 		} while (it <= end);
 	}
 
+	/**
+	 * @brief The values of a leaf and their bounding box, used to skip the leaf when searching several colors at once.
+	 */
+	struct LeafBounds {
+		uint8_t valuesBegin;
+		uint8_t valuesEndInclusive;
+		RGB min;
+		RGB max;
+	};
+
 	PaletteKdTreeNode<PaletteKdTreeDepth> tree_;
 	std::array<std::pair<RGB, uint8_t>, 256> values_;
+	std::array<LeafBounds, NumLeaves> leaves_;
 };
 
 } // namespace devilution
@@ -7,6 +7,7 @@
 #include <array>
 #include <memory>
 #include <optional>
+#include <utility>
 #include <vector>
 
 #ifdef USE_SDL3
@@ -46,28 +47,39 @@ size_t GetReservationSize(size_t pcxSize)
 	}
 }
 
-bool LoadPcxMeta(AssetHandle &handle, int &width, int &height, uint8_t &bpp)
+void LoadPcxMeta(const PCXHeader &pcxhdr, int &width, int &height, uint8_t &bpp)
 {
-	PCXHeader pcxhdr;
-	if (!handle.read(&pcxhdr, PcxHeaderSize)) {
-		return false;
-	}
 	width = Swap16LE(pcxhdr.Xmax) - Swap16LE(pcxhdr.Xmin) + 1;
 	height = Swap16LE(pcxhdr.Ymax) - Swap16LE(pcxhdr.Ymin) + 1;
 	bpp = pcxhdr.BitsPerPixel;
-	return true;
 }
 
 } // namespace
 
 OptionalOwnedClxSpriteList PcxToClx(AssetHandle &handle, size_t fileSize, int numFramesOrFrameHeight, std::optional<uint8_t> transparentColor, SDL_Color *outPalette)
 {
+	if (fileSize <= PcxHeaderSize) {
+		return std::nullopt;
+	}
+	AssetData file { std::unique_ptr<char[]> { new char[fileSize] }, fileSize };
+	if (!handle.read(file.data.get(), fileSize)) {
+		return std::nullopt;
+	}
+	return PcxToClx(std::move(file), numFramesOrFrameHeight, transparentColor, outPalette);
+}
+
+OptionalOwnedClxSpriteList PcxToClx(AssetData &&file, int numFramesOrFrameHeight, std::optional<uint8_t> transparentColor, SDL_Color *outPalette)
+{
+	if (file.size <= PcxHeaderSize) {
+		return std::nullopt;
+	}
+	PCXHeader pcxhdr;
+	std::memcpy(&pcxhdr, file.data.get(), PcxHeaderSize);
+
 	int width;
 	int height;
 	uint8_t bpp;
-	if (!LoadPcxMeta(handle, width, height, bpp)) {
-		return std::nullopt;
-	}
+	LoadPcxMeta(pcxhdr, width, height, bpp);
 	assert(bpp == 8);
 
 	unsigned numFrames;
@@ -80,16 +92,7 @@ OptionalOwnedClxSpriteList PcxToClx(AssetHandle &handle, size_t fileSize, int nu
 		numFrames = height / frameHeight;
 	}
 
-	size_t pixelDataSize = fileSize;
-	if (pixelDataSize <= PcxHeaderSize) {
-		return std::nullopt;
-	}
-	pixelDataSize -= PcxHeaderSize;
-
-	std::unique_ptr<uint8_t[]> fileBuffer { new uint8_t[pixelDataSize] };
-	if (handle.read(fileBuffer.get(), pixelDataSize) == 0) {
-		return std::nullopt;
-	}
+	const size_t pixelDataSize = file.size - PcxHeaderSize;
 
 	// CLX header: frame count, frame offset for each frame, file size
 	std::vector<uint8_t> cl2Data;
@@ -101,7 +104,7 @@ OptionalOwnedClxSpriteList PcxToClx(AssetHandle &handle, size_t fileSize, int nu
 	auto frameBuffer = std::unique_ptr<uint8_t[]>(new uint8_t[static_cast<size_t>(frameHeight) * width]);
 
 	const unsigned srcSkip = width % 2;
-	uint8_t *dataPtr = fileBuffer.get();
+	const uint8_t *dataPtr = reinterpret_cast<const uint8_t *>(file.data.get()) + PcxHeaderSize;
 	for (unsigned frame = 1; frame <= numFrames; ++frame) {
 		WriteLE32(&cl2Data[4 * static_cast<size_t>(frame)], static_cast<uint32_t>(cl2Data.size()));
 
@@ -182,7 +185,7 @@ OptionalOwnedClxSpriteList PcxToClx(AssetHandle &handle, size_t fileSize, int nu
 
 	// Release buffers before allocating the result array to reduce peak memory use.
 	frameBuffer = nullptr;
-	fileBuffer = nullptr;
+	file.data = nullptr;
 
 	auto out = std::unique_ptr<uint8_t[]>(new uint8_t[cl2Data.size()]);
 	memcpy(&out[0], cl2Data.data(), cl2Data.size());
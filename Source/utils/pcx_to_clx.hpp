@@ -23,4 +23,11 @@ namespace devilution {
  */
 OptionalOwnedClxSpriteList PcxToClx(AssetHandle &handle, size_t fileSize, int numFramesOrFrameHeight = 1, std::optional<uint8_t> transparentColor = std::nullopt, SDL_Color *outPalette = nullptr);
 
+/**
+ * @brief Same as above, for a PCX file that has already been read into memory, e.g. by `TakePrefetchedAsset`.
+ *
+ * The file contents are released before the CLX sprite is allocated.
+ */
+OptionalOwnedClxSpriteList PcxToClx(AssetData &&file, int numFramesOrFrameHeight = 1, std::optional<uint8_t> transparentColor = std::nullopt, SDL_Color *outPalette = nullptr);
+
 } // namespace devilution
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace devilution {
+
+/**
+ * @brief A list of objects that live in pooled, address-stable slots.
+ *
+ * Elements are kept in insertion order like in a `std::list`, but their storage is
+ * allocated in chunks of `ChunkSize` slots that are never released until the list is destroyed.
+ * Removed slots are put on a free list and reused, so once the pool has grown to the
+ * peak element count adding and removing elements does not touch the heap.
+ *
+ * References to elements stay valid until the element is removed, even while other elements are added.
+ * Iterators also stay valid while adding elements, and a loop over the list visits the elements
+ * that were added during the loop.
+ *
+ * @tparam T element type.
+ * @tparam ChunkSize number of slots allocated at once.
+ */
+template <typename T, size_t ChunkSize>
+class PooledList {
+	static_assert(ChunkSize > 0);
+
+	template <typename Element, typename Slots>
+	class Iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Element *;
+		using reference = Element &;
+
+		Iterator() = default;
+
+		Iterator(Slots *order, size_t index)
+		    : order_(order)
+		    , index_(index)
+		{
+		}
+
+		reference operator*() const { return *(*order_)[index_]; }
+		pointer operator->() const { return (*order_)[index_]; }
+
+		Iterator &operator++()
+		{
+			++index_;
+			return *this;
+		}
+
+		Iterator operator++(int)
+		{
+			Iterator copy = *this;
+			++index_;
+			return copy;
+		}
+
+		bool operator==(const Iterator &other) const
+		{
+			// The end iterator compares equal to any iterator that has run past the last element,
+			// so that elements added while iterating are still visited.
+			const bool atEnd = isAtEnd();
+			if (atEnd || other.isAtEnd())
+				return atEnd == other.isAtEnd();
+			return index_ == other.index_;
+		}
+
+	private:
+		[[nodiscard]] bool isAtEnd() const
+		{
+			return order_ == nullptr || index_ >= order_->size();
+		}
+
+		Slots *order_ = nullptr;
+		size_t index_ = 0;
+	};
+
+public:
+	using value_type = T;
+	using reference = T &;
+	using const_reference = const T &;
+	using size_type = size_t;
+	using iterator = Iterator<T, const std::vector<T *>>;
+	using const_iterator = Iterator<const T, const std::vector<T *>>;
+
+	PooledList() = default;
+
+	PooledList(const PooledList &) = delete;
+	PooledList &operator=(const PooledList &) = delete;
+
+	~PooledList()
+	{
+		clear();
+	}
+
+	[[nodiscard]] iterator begin() { return { &order_, 0 }; }
+	[[nodiscard]] iterator end() { return { &order_, static_cast<size_t>(-1) }; }
+	[[nodiscard]] const_iterator begin() const { return { &order_, 0 }; }
+	[[nodiscard]] const_iterator end() const { return { &order_, static_cast<size_t>(-1) }; }
+	[[nodiscard]] const_iterator cbegin() const { return begin(); }
+	[[nodiscard]] const_iterator cend() const { return end(); }
+
+	[[nodiscard]] size_t size() const { return order_.size(); }
+	[[nodiscard]] bool empty() const { return order_.empty(); }
+	[[nodiscard]] size_t max_size() const { return order_.max_size(); } // NOLINT(readability-identifier-naming)
+
+	[[nodiscard]] T &back() { return *order_.back(); }
+	[[nodiscard]] const T &back() const { return *order_.back(); }
+
+	template <typename... Args>
+	T &emplace_back(Args &&...args) // NOLINT(readability-identifier-naming)
+	{
+		T *element = ::new (allocateSlot()) T(std::forward<Args>(args)...);
+		order_.push_back(element);
+		return *element;
+	}
+
+	void push_back(const T &value) // NOLINT(readability-identifier-naming)
+	{
+		emplace_back(value);
+	}
+
+	/**
+	 * @brief Removes all elements matching the predicate, the remaining elements keep their order.
+	 */
+	template <typename Predicate>
+	size_t remove_if(Predicate &&predicate) // NOLINT(readability-identifier-naming)
+	{
+		auto out = order_.begin();
+		for (auto it = order_.begin(); it != order_.end(); ++it) {
+			T *element = *it;
+			if (predicate(*element)) {
+				releaseSlot(element);
+			} else {
+				*out++ = element;
+			}
+		}
+		const auto removed = static_cast<size_t>(order_.end() - out);
+		order_.erase(out, order_.end());
+		return removed;
+	}
+
+	/**
+	 * @brief Removes all elements, the allocated slots are kept for reuse.
+	 */
+	void clear()
+	{
+		for (T *element : order_)
+			std::destroy_at(element);
+		order_.clear();
+		freeSlots_.clear();
+		usedSlots_ = 0;
+	}
+
+private:
+	struct Slot {
+		alignas(alignof(T)) std::byte data[sizeof(T)];
+	};
+	using Chunk = std::array<Slot, ChunkSize>;
+
+	void *allocateSlot()
+	{
+		if (!freeSlots_.empty()) {
+			void *slot = freeSlots_.back();
+			freeSlots_.pop_back();
+			return slot;
+		}
+		// Fill the chunks front to back, so elements added in a row end up next to each other.
+		const size_t chunkIndex = usedSlots_ / ChunkSize;
+		if (chunkIndex == chunks_.size())
+			chunks_.push_back(std::make_unique<Chunk>());
+		return (*chunks_[chunkIndex])[usedSlots_++ % ChunkSize].data;
+	}
+
+	void releaseSlot(T *element)
+	{
+		std::destroy_at(element);
+		freeSlots_.push_back(element);
+	}
+
+	std::vector<std::unique_ptr<Chunk>> chunks_;
+	/** @brief Number of slots in `chunks_` that have been handed out at least once since the last `clear()`. */
+	size_t usedSlots_ = 0;
+	/** @brief Released slots below `usedSlots_`, reused most recently released first. */
+	std::vector<void *> freeSlots_;
+	/** @brief The elements in insertion order. */
+	std::vector<T *> order_;
+};
+
+} // namespace devilution
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 
 #ifdef USE_SDL3
@@ -13,6 +14,15 @@
 #endif
 
 #include "appfat.h"
+#include "utils/attributes.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DEVILUTIONX_BILINEAR_SCALE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define DEVILUTIONX_BILINEAR_SCALE_NEON
+#include <arm_neon.h>
+#endif
 
 // Performs bilinear scaling using fixed-width integer math.
 
@@ -42,6 +52,33 @@ std::unique_ptr<int[]> CreateMixFactors(unsigned srcSize, unsigned dstSize)
 	return result;
 };
 
+/** @brief The byte offset of the source pixel left of a destination column and the ratio to mix it with its right neighbour. */
+struct ColumnMix {
+	unsigned offset;
+	int ratio;
+};
+
+/**
+ * @brief Precomputes where each destination column samples the source row.
+ */
+std::unique_ptr<ColumnMix[]> CreateColumnMixes(unsigned srcWidth, unsigned dstWidth)
+{
+	const std::unique_ptr<int[]> mixXs = CreateMixFactors(srcWidth, dstWidth);
+	std::unique_ptr<ColumnMix[]> result { new ColumnMix[dstWidth] };
+	unsigned srcX = 0;
+	unsigned offset = 0;
+	for (unsigned x = 0; x < dstWidth; ++x) {
+		result[x] = ColumnMix { offset, Frac(mixXs[x]) };
+		if (mixXs[x + 1] > 0) {
+			const unsigned step = ToInt(mixXs[x + 1]);
+			srcX += step;
+			if (srcX <= srcWidth)
+				offset += step * 4;
+		}
+	}
+	return result;
+}
+
 uint8_t MixColors(uint8_t first, uint8_t second, int ratio)
 {
 	return ToInt((second - first) * ratio) + first;
@@ -73,11 +110,123 @@ uint8_t MixColorsWithAlpha(uint8_t first, uint8_t firstAlpha,
 	return ToInt((secondWithAlpha - firstWithAlpha) * ((ratio + (mixedAlpha - 1)) / mixedAlpha)) + ((firstWithAlpha + (mixedAlpha - 1)) / mixedAlpha);
 }
 
+/**
+ * @brief Mixes the 2x2 source pixels starting at `topLeft` into `dstPixels`.
+ */
+void MixPixel(const uint8_t *topLeft, int pitch, int mixX, int mixY, uint8_t *dstPixels)
+{
+	const uint8_t *s[4] = {
+		topLeft,            // Self
+		topLeft + 4,        // Right
+		topLeft + pitch,    // Bottom
+		topLeft + pitch + 4 // Bottom right
+	};
+
+	const uint8_t alpha0 = MixColors(s[0][3], s[1][3], mixX);
+	const uint8_t alpha1 = MixColors(s[2][3], s[3][3], mixX);
+	const uint8_t finalAlpha = MixColors(alpha0, alpha1, mixY);
+
+	if (finalAlpha == 0) {
+		dstPixels[0] = 0;
+		dstPixels[1] = 0;
+		dstPixels[2] = 0;
+		dstPixels[3] = 0;
+	} else if (finalAlpha == 255) {
+		for (unsigned channel = 0; channel < 3; ++channel) {
+			dstPixels[channel] = MixColors(
+			    MixColors(s[0][channel], s[1][channel], mixX),
+			    MixColors(s[2][channel], s[3][channel], mixX),
+			    mixY);
+		}
+		dstPixels[3] = 255;
+	} else {
+		for (unsigned channel = 0; channel < 3; ++channel) {
+			dstPixels[channel] = MixColorsWithAlpha(
+			    MixColorsWithAlpha(s[0][channel], s[0][3], s[1][channel], s[1][3], alpha0, mixX),
+			    alpha0,
+			    MixColorsWithAlpha(s[2][channel], s[2][3], s[3][channel], s[3][3], alpha1, mixX),
+			    alpha1,
+			    finalAlpha,
+			    mixY);
+		}
+		dstPixels[3] = finalAlpha;
+	}
+}
+
+#if defined(DEVILUTIONX_BILINEAR_SCALE_SSE2)
+/**
+ * @brief Mixes all 4 channels of `first` and `second`, held in 16-bit lanes, the same way as `MixColors`.
+ */
+DVL_ALWAYS_INLINE __m128i MixChannels(__m128i first, __m128i second, int ratio)
+{
+	// `_mm_mulhi_epi16` is signed, so a ratio of 0x8000 or more is taken as `ratio - 0x10000`, which is off by exactly `diff`.
+	const __m128i diff = _mm_sub_epi16(second, first);
+	__m128i product = _mm_mulhi_epi16(diff, _mm_set1_epi16(static_cast<int16_t>(ratio)));
+	if (ratio >= 0x8000)
+		product = _mm_add_epi16(product, diff);
+	return _mm_add_epi16(product, first);
+}
+
+/**
+ * @brief Mixes all channels of the 2x2 source pixels at once.
+ * @return false if the result is partially transparent, which has to be mixed by `MixPixel` instead.
+ */
+DVL_ALWAYS_INLINE bool MixPixelFast(const uint8_t *topLeft, int pitch, int mixX, int mixY, uint8_t *dstPixels)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i top = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(topLeft)), zero);
+	const __m128i bottom = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(topLeft + pitch)), zero);
+	// The left pixels of both rows are mixed with the right pixels of both rows at once.
+	const __m128i rows = MixChannels(_mm_unpacklo_epi64(top, bottom), _mm_unpackhi_epi64(top, bottom), mixX);
+	const __m128i mixed = MixChannels(rows, _mm_srli_si128(rows, 8), mixY);
+	const int alpha = _mm_extract_epi16(mixed, 3);
+	if (alpha != 0 && alpha != 255)
+		return false;
+	const uint32_t pixel = alpha == 0 ? 0 : static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(mixed, mixed)));
+	std::memcpy(dstPixels, &pixel, 4);
+	return true;
+}
+#elif defined(DEVILUTIONX_BILINEAR_SCALE_NEON)
+/**
+ * @brief Mixes all 4 channels of `first` and `second` the same way as `MixColors`.
+ */
+DVL_ALWAYS_INLINE int32x4_t MixChannels(int32x4_t first, int32x4_t second, int ratio)
+{
+	return vaddq_s32(vshrq_n_s32(vmulq_n_s32(vsubq_s32(second, first), ratio), 16), first);
+}
+
+DVL_ALWAYS_INLINE int32x4_t Widen(uint16x4_t channels)
+{
+	return vreinterpretq_s32_u32(vmovl_u16(channels));
+}
+
+/**
+ * @brief Mixes all channels of the 2x2 source pixels at once.
+ * @return false if the result is partially transparent, which has to be mixed by `MixPixel` instead.
+ */
+DVL_ALWAYS_INLINE bool MixPixelFast(const uint8_t *topLeft, int pitch, int mixX, int mixY, uint8_t *dstPixels)
+{
+	const uint16x8_t top = vmovl_u8(vld1_u8(topLeft));
+	const uint16x8_t bottom = vmovl_u8(vld1_u8(topLeft + pitch));
+	const int32x4_t mixed = MixChannels(
+	    MixChannels(Widen(vget_low_u16(top)), Widen(vget_high_u16(top)), mixX),
+	    MixChannels(Widen(vget_low_u16(bottom)), Widen(vget_high_u16(bottom)), mixX),
+	    mixY);
+	const int alpha = vgetq_lane_s32(mixed, 3);
+	if (alpha != 0 && alpha != 255)
+		return false;
+	const uint8x8_t bytes = vmovn_u16(vcombine_u16(vmovn_u32(vreinterpretq_u32_s32(mixed)), vdup_n_u16(0)));
+	const uint32_t pixel = alpha == 0 ? 0 : vget_lane_u32(vreinterpret_u32_u8(bytes), 0);
+	std::memcpy(dstPixels, &pixel, 4);
+	return true;
+}
+#endif
+
 } // namespace
 
 void BilinearScale32(SDL_Surface *src, SDL_Surface *dst)
 {
-	const std::unique_ptr<int[]> mixXs = CreateMixFactors(src->w, dst->w);
+	const std::unique_ptr<ColumnMix[]> columns = CreateColumnMixes(src->w, dst->w);
 	const std::unique_ptr<int[]> mixYs = CreateMixFactors(src->h, dst->h);
 
 	const unsigned dgap = dst->pitch - (dst->w * 4);
@@ -88,61 +237,13 @@ void BilinearScale32(SDL_Surface *src, SDL_Surface *dst)
 	int *curMixY = &mixYs[0];
 	unsigned srcY = 0;
 	for (unsigned y = 0; y < static_cast<unsigned>(dst->h); ++y) {
-		uint8_t *s[4] = {
-			srcPixels,                 // Self
-			srcPixels + 4,             // Right
-			srcPixels + src->pitch,    // Bottom
-			srcPixels + src->pitch + 4 // Bottom right
-		};
-
-		int *curMixX = &mixXs[0];
-		unsigned srcX = 0;
+		const int mixY = Frac(*curMixY);
 		for (unsigned x = 0; x < static_cast<unsigned>(dst->w); ++x) {
-			const int mixX = Frac(*curMixX);
-			const int mixY = Frac(*curMixY);
-
-			const uint8_t alpha0 = MixColors(s[0][3], s[1][3], mixX);
-			const uint8_t alpha1 = MixColors(s[2][3], s[3][3], mixX);
-			const uint8_t finalAlpha = MixColors(alpha0, alpha1, mixY);
-
-			if (finalAlpha == 0) {
-				dstPixels[0] = 0;
-				dstPixels[1] = 0;
-				dstPixels[2] = 0;
-				dstPixels[3] = 0;
-			} else if (finalAlpha == 255) {
-				for (unsigned channel = 0; channel < 3; ++channel) {
-					dstPixels[channel] = MixColors(
-					    MixColors(s[0][channel], s[1][channel], mixX),
-					    MixColors(s[2][channel], s[3][channel], mixX),
-					    mixY);
-				}
-				dstPixels[3] = 255;
-			} else {
-				for (unsigned channel = 0; channel < 3; ++channel) {
-					dstPixels[channel] = MixColorsWithAlpha(
-					    MixColorsWithAlpha(s[0][channel], s[0][3], s[1][channel], s[1][3], alpha0, mixX),
-					    alpha0,
-					    MixColorsWithAlpha(s[2][channel], s[2][3], s[3][channel], s[3][3], alpha1, mixX),
-					    alpha1,
-					    finalAlpha,
-					    mixY);
-				}
-				dstPixels[3] = finalAlpha;
-			}
-
-			++curMixX;
-			if (*curMixX > 0) {
-				unsigned step = ToInt(*curMixX);
-				srcX += step;
-				if (srcX <= static_cast<unsigned>(src->w)) {
-					step *= 4;
-					for (auto &v : s) {
-						v += step;
-					}
-				}
-			}
-
+			const uint8_t *topLeft = srcPixels + columns[x].offset;
+#if defined(DEVILUTIONX_BILINEAR_SCALE_SSE2) || defined(DEVILUTIONX_BILINEAR_SCALE_NEON)
+			if (!MixPixelFast(topLeft, src->pitch, columns[x].ratio, mixY, dstPixels))
+#endif
+				MixPixel(topLeft, src->pitch, columns[x].ratio, mixY, dstPixels);
 			dstPixels += 4;
 		}
 
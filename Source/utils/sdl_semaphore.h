@@ -0,0 +1,59 @@
+#pragma once
+
+#ifdef USE_SDL3
+#include <SDL3/SDL_mutex.h>
+#else
+#include <SDL_mutex.h>
+#endif
+
+#include "appfat.h"
+
+namespace devilution {
+
+/*
+ * RAII wrapper for SDL_sem.
+ */
+class SdlSemaphore final {
+public:
+	SdlSemaphore()
+	    : semaphore_(SDL_CreateSemaphore(0))
+	{
+		if (semaphore_ == nullptr)
+			ErrSdl();
+	}
+
+	~SdlSemaphore()
+	{
+		SDL_DestroySemaphore(semaphore_);
+	}
+
+	SdlSemaphore(const SdlSemaphore &) = delete;
+	SdlSemaphore &operator=(const SdlSemaphore &) = delete;
+
+	void post()
+	{
+#ifdef USE_SDL3
+		SDL_SignalSemaphore(semaphore_);
+#else
+		SDL_SemPost(semaphore_);
+#endif
+	}
+
+	void wait()
+	{
+#ifdef USE_SDL3
+		SDL_WaitSemaphore(semaphore_);
+#else
+		SDL_SemWait(semaphore_);
+#endif
+	}
+
+private:
+#ifdef USE_SDL3
+	SDL_Semaphore *semaphore_;
+#else
+	SDL_sem *semaphore_;
+#endif
+};
+
+} // namespace devilution
@@ -1,18 +1,24 @@
 #include "utils/soundsample.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <utility>
+#include <vector>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_error.h>
 #include <SDL3/SDL_iostream.h>
 #include <SDL3_mixer/SDL_mixer.h>
 #else
+#include <Aulib/Decoder.h>
 #include <Aulib/DecoderDrmp3.h>
 #include <Aulib/DecoderDrwav.h>
 #include <Aulib/Stream.h>
+#include <aulib.h>
 
 #include <SDL.h>
 #ifdef USE_SDL1
@@ -30,6 +36,7 @@
 #include "options.h"
 #include "utils/log.hpp"
 #include "utils/math.h"
+#include "utils/memory_stats.hpp"
 #include "utils/stubs.h"
 
 namespace devilution {
@@ -128,6 +135,157 @@ std::unique_ptr<Aulib::Stream> CreateStream(SDL_IOStream *handle, bool isMp3)
 	auto resampler = CreateAulibResampler(decoder->getRate());
 	return std::make_unique<Aulib::Stream>(handle, std::move(decoder), std::move(resampler), /*closeRw=*/true);
 }
+
+/**
+ * @brief How much memory the decoded samples of all sounds may take.
+ *
+ * The decoded samples are larger than the files, sounds beyond this are decoded while playing them.
+ */
+constexpr size_t MaxDecodedBytes = 64 * 1024 * 1024;
+
+std::atomic<size_t> DecodedBytes;
+
+ArraySharedPtr<int16_t> AllocateDecoded(size_t numSamples)
+{
+	const size_t bytes = numSamples * sizeof(int16_t);
+	if (DecodedBytes.fetch_add(bytes) + bytes > MaxDecodedBytes) {
+		DecodedBytes -= bytes;
+		return nullptr;
+	}
+	MemoryStatsAdd(MemoryTag::Sounds, bytes);
+	return ArraySharedPtr<int16_t>(new int16_t[numSamples], [bytes](int16_t *samples) {
+		DecodedBytes -= bytes;
+		MemoryStatsRemove(MemoryTag::Sounds, bytes);
+		delete[] samples;
+	});
+}
+
+/**
+ * @brief Decodes the whole file.
+ * @return The interleaved samples, empty on failure.
+ */
+std::vector<float> DecodeAll(const std::uint8_t *data, std::size_t size, bool isMp3, int &numChannels, int &sampleRate)
+{
+	std::vector<float> samples;
+	SDL_IOStream *handle = SDL_IOFromConstMem(data, static_cast<int>(size));
+	if (handle == nullptr)
+		return samples;
+	const std::unique_ptr<Aulib::Decoder> decoder = CreateDecoder(isMp3);
+	if (decoder->open(handle)) {
+		numChannels = decoder->getChannels();
+		sampleRate = decoder->getRate();
+		constexpr int ChunkSize = 4096;
+		while (true) {
+			const size_t offset = samples.size();
+			samples.resize(offset + ChunkSize);
+			bool callAgain = false;
+			const int decoded = decoder->decode(&samples[offset], ChunkSize, callAgain);
+			samples.resize(offset + std::max(decoded, 0));
+			if (decoded <= 0 && !callAgain)
+				break;
+		}
+	}
+	SDL_CloseIO(handle);
+	return samples;
+}
+
+int16_t FloatToSample(float sample)
+{
+	return static_cast<int16_t>(std::clamp(sample * 32768.F, -32768.F, 32767.F));
+}
+
+/**
+ * @brief Converts interleaved samples to another rate with cubic Hermite interpolation.
+ */
+void Resample(const std::vector<float> &in, int numChannels, int inRate, int16_t *out, size_t outFrames, int outRate)
+{
+	const size_t inFrames = in.size() / numChannels;
+	const auto at = [&](ptrdiff_t frame, int channel) {
+		frame = std::clamp<ptrdiff_t>(frame, 0, static_cast<ptrdiff_t>(inFrames) - 1);
+		return in[(frame * numChannels) + channel];
+	};
+	const double step = static_cast<double>(inRate) / outRate;
+	for (size_t frame = 0; frame < outFrames; frame++) {
+		const double position = frame * step;
+		const auto index = static_cast<ptrdiff_t>(position);
+		const auto t = static_cast<float>(position - index);
+		for (int channel = 0; channel < numChannels; channel++) {
+			const float p0 = at(index - 1, channel);
+			const float p1 = at(index, channel);
+			const float p2 = at(index + 1, channel);
+			const float p3 = at(index + 2, channel);
+			const float a = (-p0 + 3 * p1 - 3 * p2 + p3) / 2;
+			const float b = p0 - (5 * p1) / 2 + 2 * p2 - p3 / 2;
+			const float c = (p2 - p0) / 2;
+			*out++ = FloatToSample(((a * t + b) * t + c) * t + p1);
+		}
+	}
+}
+
+/**
+ * @brief Plays samples that have already been decoded at the output rate.
+ */
+class PcmAulibDecoder final : public Aulib::Decoder {
+public:
+	PcmAulibDecoder(ArraySharedPtr<int16_t> samples, size_t numSamples, int numChannels)
+	    : samples_(std::move(samples))
+	    , numSamples_(numSamples)
+	    , numChannels_(numChannels)
+	{
+	}
+
+	bool open([[maybe_unused]] SDL_IOStream *rwops) override
+	{
+		return true;
+	}
+
+	[[nodiscard]] int getChannels() const override
+	{
+		return numChannels_;
+	}
+
+	[[nodiscard]] int getRate() const override
+	{
+		return Aulib::sampleRate();
+	}
+
+	bool rewind() override
+	{
+		position_ = 0;
+		return true;
+	}
+
+	[[nodiscard]] std::chrono::microseconds duration() const override
+	{
+		return std::chrono::microseconds { static_cast<int64_t>(numSamples_ / numChannels_) * 1000000 / getRate() };
+	}
+
+	bool seekToTime(std::chrono::microseconds pos) override
+	{
+		const size_t frame = static_cast<size_t>(pos.count()) * getRate() / 1000000;
+		position_ = std::min(frame * numChannels_, numSamples_);
+		return true;
+	}
+
+protected:
+	int doDecoding(float buf[], int len, bool &callAgain) override
+	{
+		callAgain = false;
+		constexpr float Factor = 1.0F / 32768;
+		const size_t count = std::min(static_cast<size_t>(len), numSamples_ - position_);
+		const int16_t *samples = &samples_[position_];
+		for (size_t i = 0; i < count; i++)
+			buf[i] = samples[i] * Factor;
+		position_ += count;
+		return static_cast<int>(count);
+	}
+
+private:
+	ArraySharedPtr<int16_t> samples_;
+	size_t numSamples_;
+	int numChannels_;
+	size_t position_ = 0;
+};
 #endif // USE_SDL3
 
 } // namespace
@@ -148,6 +306,9 @@ SoundSample::SoundSample(SoundSample &&other) noexcept
     , leftGain_(other.leftGain_)
     , rightGain_(other.rightGain_)
 #else
+    , pcm_(std::move(other.pcm_))
+    , pcm_size_(other.pcm_size_)
+    , pcm_channels_(other.pcm_channels_)
     , stream_(std::move(other.stream_))
 #endif
 {
@@ -177,6 +338,9 @@ SoundSample &SoundSample::operator=(SoundSample &&other) noexcept
 		other.audio_ = nullptr;
 		other.track_ = nullptr;
 #else
+		pcm_ = std::move(other.pcm_);
+		pcm_size_ = other.pcm_size_;
+		pcm_channels_ = other.pcm_channels_;
 		stream_ = std::move(other.stream_);
 #endif
 		other.file_data_size_ = 0;
@@ -244,6 +408,8 @@ void SoundSample::Release()
 	}
 #else
 	stream_ = nullptr;
+	pcm_ = nullptr;
+	pcm_size_ = 0;
 #endif
 	file_data_ = nullptr;
 	file_data_size_ = 0;
@@ -321,7 +487,7 @@ bool SoundSample::Play(int numIterations)
 int SoundSample::SetChunkStream(std::string filePath, bool isMp3, bool logErrors)
 {
 #ifdef USE_SDL3
-	SDL_IOStream *handle = OpenAssetAsSdlRwOps(filePath.c_str(), /*threadsafe=*/true);
+	SDL_IOStream *handle = OpenAssetAsStreamingSdlRwOps(filePath.c_str());
 	if (handle == nullptr) {
 		if (logErrors)
 			LogError(LogCategory::Audio, "OpenAsset failed (from SoundSample::SetChunkStream) for {}: {}", filePath, SDL_GetError());
@@ -342,7 +508,7 @@ int SoundSample::SetChunkStream(std::string filePath, bool isMp3, bool logErrors
 
 	return 0;
 #else
-	SDL_IOStream *handle = OpenAssetAsSdlRwOps(filePath.c_str(), /*threadsafe=*/true);
+	SDL_IOStream *handle = OpenAssetAsStreamingSdlRwOps(filePath.c_str());
 	if (handle == nullptr) {
 		if (logErrors)
 			LogError(LogCategory::Audio, "OpenAsset failed (from SoundSample::SetChunkStream) for {}: {}", filePath, SDL_GetError());
@@ -405,6 +571,53 @@ int SoundSample::SetChunk(ArraySharedPtr<std::uint8_t> fileData, std::size_t dwB
 #endif
 }
 
+int SoundSample::SetChunkDecoded(ArraySharedPtr<std::uint8_t> fileData, std::size_t dwBytes, bool isMp3)
+{
+#ifndef USE_SDL3
+	int numChannels = 0;
+	int sampleRate = 0;
+	const std::vector<float> decoded = DecodeAll(fileData.get(), dwBytes, isMp3, numChannels, sampleRate);
+	if (!decoded.empty() && numChannels > 0 && sampleRate > 0) {
+		const int outRate = Aulib::sampleRate();
+		const size_t inFrames = decoded.size() / numChannels;
+		const size_t outFrames = static_cast<size_t>(static_cast<uint64_t>(inFrames) * outRate / sampleRate);
+		const size_t numSamples = outFrames * numChannels;
+		ArraySharedPtr<int16_t> samples = AllocateDecoded(numSamples);
+		if (samples != nullptr) {
+			if (outRate == sampleRate) {
+				std::transform(decoded.begin(), decoded.begin() + numSamples, samples.get(), FloatToSample);
+			} else {
+				Resample(decoded, numChannels, sampleRate, samples.get(), outFrames, outRate);
+			}
+			isMp3_ = isMp3;
+			return SetPcm(std::move(samples), numSamples, numChannels);
+		}
+	}
+#endif
+	// SDL_mixer decodes the whole sample in SetChunk
+	return SetChunk(std::move(fileData), dwBytes, isMp3);
+}
+
+#ifndef USE_SDL3
+int SoundSample::SetPcm(ArraySharedPtr<std::int16_t> samples, std::size_t numSamples, int numChannels)
+{
+	pcm_ = std::move(samples);
+	pcm_size_ = numSamples;
+	pcm_channels_ = numChannels;
+
+	// The samples are already at the output rate, the stream needs no resampler
+	stream_ = std::make_unique<Aulib::Stream>(/*rwops=*/nullptr, std::make_unique<PcmAulibDecoder>(pcm_, pcm_size_, pcm_channels_), /*resampler=*/nullptr, /*closeRw=*/false);
+	if (!stream_->open()) {
+		stream_ = nullptr;
+		pcm_ = nullptr;
+		pcm_size_ = 0;
+		LogError(LogCategory::Audio, "Aulib::Stream::open (from SoundSample::SetPcm): {}", SDL_GetError());
+		return -1;
+	}
+	return 0;
+}
+#endif
+
 void SoundSample::SetVolume(int logVolume, int logMin, int logMax)
 {
 #ifdef USE_SDL3
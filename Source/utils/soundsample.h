@@ -58,13 +58,29 @@ public:
 	 */
 	int SetChunk(ArraySharedPtr<std::uint8_t> fileData, std::size_t dwBytes, bool isMp3);
 
+	/**
+	 * @brief Like `SetChunk`, but decodes the whole sample and converts it to the output rate once,
+	 * so that playing it needs neither.
+	 *
+	 * Falls back to `SetChunk` if the decoded samples of all sounds would take too much memory.
+	 */
+	int SetChunkDecoded(ArraySharedPtr<std::uint8_t> fileData, std::size_t dwBytes, bool isMp3);
+
 	[[nodiscard]] bool IsStreaming() const
 	{
+#ifndef USE_SDL3
+		if (pcm_ != nullptr)
+			return false;
+#endif
 		return file_data_ == nullptr;
 	}
 
 	int DuplicateFrom(const SoundSample &other)
 	{
+#ifndef USE_SDL3
+		if (other.pcm_ != nullptr)
+			return SetPcm(other.pcm_, other.pcm_size_, other.pcm_channels_);
+#endif
 		if (other.IsStreaming())
 			return SetChunkStream(other.file_path_, other.isMp3_);
 		return SetChunk(other.file_data_, other.file_data_size_, other.isMp3_);
@@ -120,6 +136,13 @@ private:
 	float leftGain_ = 1.0f;
 	float rightGain_ = 1.0f;
 #else
+	int SetPcm(ArraySharedPtr<std::int16_t> samples, std::size_t numSamples, int numChannels);
+
+	// Decoded audio at the output rate, shared with the duplicates of this sample:
+	ArraySharedPtr<std::int16_t> pcm_;
+	std::size_t pcm_size_ = 0;
+	int pcm_channels_ = 0;
+
 	std::unique_ptr<Aulib::Stream> stream_;
 #endif
 };
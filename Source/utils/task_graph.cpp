@@ -0,0 +1,233 @@
+#include "utils/task_graph.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#ifdef USE_SDL3
+#include <SDL3/SDL_cpuinfo.h>
+#include <SDL3/SDL_timer.h>
+#else
+#include <SDL.h>
+#endif
+
+#include "utils/log.hpp"
+#include "utils/sdl_semaphore.h"
+#include "utils/sdl_thread.h"
+
+namespace devilution {
+
+namespace {
+
+constexpr size_t MaxTaskGraphThreads = 8;
+
+size_t GetTaskGraphThreadCount()
+{
+#if defined(USE_SDL1) || defined(__DJGPP__)
+	return 1;
+#elif defined(USE_SDL3)
+	return static_cast<size_t>(std::clamp(SDL_GetNumLogicalCPUCores(), 1, static_cast<int>(MaxTaskGraphThreads)));
+#else
+	return static_cast<size_t>(std::clamp(SDL_GetCPUCount(), 1, static_cast<int>(MaxTaskGraphThreads)));
+#endif
+}
+
+uint64_t NowUs()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Threads that are kept between `ParallelFor` calls, so that work done every frame doesn't create threads.
+ */
+class ParallelForPool {
+public:
+	ParallelForPool() = default;
+	ParallelForPool(const ParallelForPool &) = delete;
+	ParallelForPool &operator=(const ParallelForPool &) = delete;
+
+	~ParallelForPool()
+	{
+		quit_ = true;
+		for (size_t i = 0; i < threads_.size(); ++i)
+			wakeup_.post();
+		for (SdlThread &thread : threads_)
+			thread.join();
+	}
+
+	/**
+	 * @brief Calls `fn` with each index below `count` on the calling thread and `numThreads - 1` pool threads.
+	 * @return false if the pool is already in use, e.g. by a `ParallelFor` nested in another one.
+	 */
+	bool run(size_t count, size_t numThreads, tl::function_ref<void(size_t)> fn)
+	{
+		bool expected = false;
+		if (!busy_.compare_exchange_strong(expected, true, std::memory_order_acquire))
+			return false;
+		while (threads_.size() < numThreads - 1)
+			threads_.emplace_back(WorkerThread, this);
+
+		fn_ = &fn;
+		count_ = count;
+		next_.store(0, std::memory_order_relaxed);
+		for (size_t i = 1; i < numThreads; ++i)
+			wakeup_.post();
+		runIndices();
+		for (size_t i = 1; i < numThreads; ++i)
+			done_.wait();
+		fn_ = nullptr;
+
+		busy_.store(false, std::memory_order_release);
+		return true;
+	}
+
+private:
+	static int SDLCALL WorkerThread(void *data)
+	{
+		ParallelForPool &pool = *static_cast<ParallelForPool *>(data);
+		while (true) {
+			pool.wakeup_.wait();
+			if (pool.quit_)
+				return 0;
+			pool.runIndices();
+			pool.done_.post();
+		}
+	}
+
+	void runIndices()
+	{
+		for (size_t i = next_.fetch_add(1, std::memory_order_relaxed); i < count_; i = next_.fetch_add(1, std::memory_order_relaxed))
+			(*fn_)(i);
+	}
+
+	std::vector<SdlThread> threads_;
+	/** @brief Posted once per thread that takes part in a call. */
+	SdlSemaphore wakeup_;
+	/** @brief Posted by each thread that took part once there are no indices left. */
+	SdlSemaphore done_;
+	std::atomic<bool> busy_ = false;
+	bool quit_ = false;
+	const tl::function_ref<void(size_t)> *fn_ = nullptr;
+	size_t count_ = 0;
+	std::atomic<size_t> next_ = 0;
+};
+
+} // namespace
+
+TaskGraph::TaskId TaskGraph::add(const char *name, std::function<void()> fn, std::initializer_list<TaskId> dependencies, TaskAffinity affinity)
+{
+	const TaskId id = tasks_.size();
+	for ([[maybe_unused]] const TaskId dependency : dependencies)
+		assert(dependency < id);
+	tasks_.push_back(Task { std::move(fn), dependencies, affinity, TaskState::Pending });
+	timings_.push_back(TaskTiming { name, 0, 0, 0 });
+	return id;
+}
+
+bool TaskGraph::isReady(const Task &task) const
+{
+	return task.state == TaskState::Pending
+	    && std::all_of(task.dependencies.begin(), task.dependencies.end(),
+	        [this](TaskId dependency) { return tasks_[dependency].state == TaskState::Done; });
+}
+
+TaskGraph::StepResult TaskGraph::runNext(uint32_t thread)
+{
+	TaskId next = tasks_.size();
+	{
+		const std::lock_guard<SdlMutex> lock(mutex_);
+		if (numDone_ == tasks_.size())
+			return StepResult::Finished;
+		for (TaskId id = 0; id < tasks_.size(); ++id) {
+			const Task &task = tasks_[id];
+			if ((thread == 0 || task.affinity == TaskAffinity::AnyThread) && isReady(task)) {
+				// The main thread prefers the steps only it can run, so that the others don't wait on it.
+				if (next == tasks_.size() || task.affinity == TaskAffinity::MainThread)
+					next = id;
+				if (thread != 0 || task.affinity == TaskAffinity::MainThread)
+					break;
+			}
+		}
+		if (next == tasks_.size())
+			return StepResult::Waiting;
+		tasks_[next].state = TaskState::Running;
+	}
+
+	const uint64_t beginUs = NowUs();
+	tasks_[next].fn();
+	const uint64_t endUs = NowUs();
+
+	const std::lock_guard<SdlMutex> lock(mutex_);
+	tasks_[next].state = TaskState::Done;
+	timings_[next].thread = thread;
+	timings_[next].beginUs = beginUs - beginUs_;
+	timings_[next].endUs = endUs - beginUs_;
+	++numDone_;
+	return StepResult::Ran;
+}
+
+int SDLCALL TaskGraph::WorkerThread(void *data)
+{
+	const Worker &worker = *static_cast<const Worker *>(data);
+	StepResult result;
+	while ((result = worker.graph->runNext(worker.thread)) != StepResult::Finished) {
+		// Steps take milliseconds, polling keeps this simple.
+		if (result == StepResult::Waiting)
+			SDL_Delay(1);
+	}
+	return 0;
+}
+
+void TaskGraph::run(size_t maxThreads)
+{
+	beginUs_ = NowUs();
+	const size_t numThreads = std::min({ maxThreads != 0 ? maxThreads : GetTaskGraphThreadCount(), GetTaskGraphThreadCount(), std::max<size_t>(tasks_.size(), 1) });
+	std::vector<Worker> workers;
+	workers.reserve(numThreads - 1);
+	std::vector<SdlThread> threads;
+	threads.reserve(numThreads - 1);
+	for (size_t i = 1; i < numThreads; ++i) {
+		workers.push_back(Worker { this, static_cast<uint32_t>(i) });
+		threads.emplace_back(WorkerThread, &workers.back());
+	}
+	Worker mainWorker { this, 0 };
+	WorkerThread(&mainWorker);
+	for (SdlThread &thread : threads)
+		thread.join();
+	endUs_ = NowUs();
+}
+
+void TaskGraph::logTimeline(std::string_view title) const
+{
+	uint64_t totalUs = 0;
+	for (const TaskTiming &timing : timings_) {
+		LogVerbose("{}: {:<24} {:>7.1f} - {:>7.1f} ms on thread {}", title, timing.name,
+		    static_cast<double>(timing.beginUs) / 1000, static_cast<double>(timing.endUs) / 1000, timing.thread);
+		totalUs += timing.endUs - timing.beginUs;
+	}
+	LogVerbose("{}: {:.1f} ms, {:.1f} ms if run one after another", title,
+	    static_cast<double>(endUs_ - beginUs_) / 1000, static_cast<double>(totalUs) / 1000);
+}
+
+void ParallelFor([[maybe_unused]] const char *name, size_t count, tl::function_ref<void(size_t)> fn)
+{
+	const size_t numThreads = std::min(count, GetTaskGraphThreadCount());
+	if (numThreads > 1) {
+		static ParallelForPool pool;
+		if (pool.run(count, numThreads, fn))
+			return;
+	}
+	for (size_t i = 0; i < count; ++i)
+		fn(i);
+}
+
+size_t GetParallelForThreadCount()
+{
+	return GetTaskGraphThreadCount();
+}
+
+} // namespace devilution
@@ -0,0 +1,117 @@
+/**
+ * @file task_graph.hpp
+ *
+ * Runs a set of startup steps with dependencies between them on a few threads.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <function_ref.hpp>
+
+#include "utils/sdl_mutex.h"
+
+namespace devilution {
+
+enum class TaskAffinity : uint8_t {
+	AnyThread,
+	/** @brief For steps that use the window, the renderer or Lua. */
+	MainThread,
+};
+
+struct TaskTiming {
+	const char *name;
+	/** @brief 0 is the thread that called `TaskGraph::run`. */
+	uint32_t thread;
+	uint64_t beginUs;
+	uint64_t endUs;
+};
+
+class TaskGraph {
+public:
+	using TaskId = size_t;
+
+	/**
+	 * @brief Adds a step that runs once all of its dependencies are done.
+	 *
+	 * Dependencies must have been added before, which also rules out cycles.
+	 */
+	TaskId add(const char *name, std::function<void()> fn, std::initializer_list<TaskId> dependencies = {}, TaskAffinity affinity = TaskAffinity::AnyThread);
+
+	/**
+	 * @brief Runs all the steps and returns once they are done.
+	 *
+	 * The calling thread takes part in running the steps, it is the only one running `TaskAffinity::MainThread` steps.
+	 *
+	 * @param maxThreads Including the calling thread, 0 picks one thread per CPU core.
+	 */
+	void run(size_t maxThreads = 0);
+
+	/** @brief When each step ran, in the order they were added. */
+	[[nodiscard]] std::span<const TaskTiming> timeline() const
+	{
+		return timings_;
+	}
+
+	/** @brief Logs when each step ran and how much time running them in parallel saved. */
+	void logTimeline(std::string_view title) const;
+
+private:
+	enum class TaskState : uint8_t {
+		Pending,
+		Running,
+		Done,
+	};
+
+	struct Task {
+		std::function<void()> fn;
+		std::vector<TaskId> dependencies;
+		TaskAffinity affinity;
+		TaskState state;
+	};
+
+	enum class StepResult : uint8_t {
+		Ran,
+		Waiting,
+		Finished,
+	};
+
+	struct Worker {
+		TaskGraph *graph;
+		uint32_t thread;
+	};
+
+	static int SDLCALL WorkerThread(void *data);
+
+	/** @brief Runs one step that is ready, if there is one this thread may run. */
+	StepResult runNext(uint32_t thread);
+
+	[[nodiscard]] bool isReady(const Task &task) const;
+
+	std::vector<Task> tasks_;
+	std::vector<TaskTiming> timings_;
+	size_t numDone_ = 0;
+	uint64_t beginUs_ = 0;
+	uint64_t endUs_ = 0;
+	SdlMutex mutex_;
+};
+
+/**
+ * @brief Calls `fn` with each index below `count`, spread over as many threads as a `TaskGraph` would use.
+ *
+ * The threads are kept between calls, so this is cheap enough to use every frame.
+ * Runs everything on the calling thread if there is only one index or only one thread,
+ * or if another `ParallelFor` is using the threads.
+ */
+void ParallelFor(const char *name, size_t count, tl::function_ref<void(size_t)> fn);
+
+/** @brief The number of threads `ParallelFor` spreads the indices over at most, including the calling thread. */
+size_t GetParallelForThreadCount();
+
+} // namespace devilution
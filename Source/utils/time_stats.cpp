@@ -0,0 +1,36 @@
+/**
+ * @file time_stats.cpp
+ *
+ * Implementation of the summaries of frame and game tick times.
+ */
+#include "utils/time_stats.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+#include <fmt/format.h>
+
+namespace devilution {
+
+TimeStats ComputeTimeStats(std::vector<uint32_t> us)
+{
+	if (us.empty())
+		return {};
+	std::sort(us.begin(), us.end());
+	const auto percentile = [&us](unsigned p) {
+		const size_t rank = (p * us.size() + 99) / 100;
+		return us[std::max<size_t>(rank, 1) - 1] / 1000.0;
+	};
+	uint64_t total = 0;
+	for (const uint32_t value : us)
+		total += value;
+	return TimeStats { static_cast<double>(total) / us.size() / 1000.0, percentile(50), percentile(95), percentile(99), us.back() / 1000.0 };
+}
+
+std::string FormatTimeStatsJson(const TimeStats &stats)
+{
+	return fmt::format(R"({{"mean": {:.3f}, "p50": {:.3f}, "p95": {:.3f}, "p99": {:.3f}, "max": {:.3f}}})",
+	    stats.mean, stats.p50, stats.p95, stats.p99, stats.max);
+}
+
+} // namespace devilution
@@ -0,0 +1,28 @@
+/**
+ * @file time_stats.hpp
+ *
+ * Summaries of the time taken by each of a series of frames or game ticks.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace devilution {
+
+struct TimeStats {
+	double mean;
+	double p50;
+	double p95;
+	double p99;
+	double max;
+};
+
+/** @brief Statistics in milliseconds, percentiles use the nearest rank. */
+TimeStats ComputeTimeStats(std::vector<uint32_t> us);
+
+/** @brief The statistics as a JSON object, e.g. `{"mean": 1.000, "p50": ...}`. */
+std::string FormatTimeStatsJson(const TimeStats &stats);
+
+} // namespace devilution
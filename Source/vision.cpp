@@ -1,25 +1,15 @@
 #include "vision.hpp"
 
 #include <cstdint>
-#include <iterator>
 
 #include <function_ref.hpp>
 
-#include "engine/displacement.hpp"
 #include "engine/point.hpp"
 
 namespace devilution {
-namespace {
-/*
- * XY points of vision rays are cast to trace the visibility of the
- * surrounding environment. The table represents N rays of M points in
- * one quadrant (0°-90°) of a circle, so rays for other quadrants will
- * be created by mirroring. Zero points at the end will be trimmed and
- * ignored. A similar table can be recreated using Bresenham's line
- * drawing algorithm, which is suitable for integer arithmetic:
- * https://en.wikipedia.org/wiki/Bresenham's_line_algorithm
- */
-const DisplacementOf<int8_t> VisionRays[23][15] = {
+namespace detail {
+
+const DisplacementOf<int8_t> VisionRays[NumVisionRays][MaxVisionRayLength] = {
 	// clang-format off
 	{ { 1, 0 }, { 2, 0 }, { 3, 0 }, { 4, 0 }, { 5, 0 }, { 6, 0 }, { 7, 0 }, { 8, 0 }, { 9, 0 }, { 10,  0 }, { 11,  0 }, { 12,  0 }, { 13,  0 }, { 14,  0 }, { 15,  0 } },
 	{ { 1, 0 }, { 2, 0 }, { 3, 0 }, { 4, 0 }, { 5, 0 }, { 6, 0 }, { 7, 0 }, { 8, 1 }, { 9, 1 }, { 10,  1 }, { 11,  1 }, { 12,  1 }, { 13,  1 }, { 14,  1 }, { 15,  1 } },
@@ -46,7 +36,10 @@ const DisplacementOf<int8_t> VisionRays[23][15] = {
 	{ { 0, 1 }, { 0, 2 }, { 0, 3 }, { 0, 4 }, { 0, 5 }, { 0, 6 }, { 0, 7 }, { 0, 8 }, { 0, 9 }, {  0, 10 }, {  0, 11 }, {  0, 12 }, {  0, 13 }, {  0, 14 }, {  0, 15 } },
 	// clang-format on
 };
-} // namespace
+
+const uint8_t RayLenAdj[NumVisionRays] = { 0, 0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 4, 3, 2, 2, 2, 1, 1, 1, 0, 0, 0, 0 };
+
+} // namespace detail
 
 void DoVision(Point position, uint8_t radius,
     tl::function_ref<void(Point)> markVisibleFn,
@@ -56,67 +49,8 @@ void DoVision(Point position, uint8_t radius,
 {
 	markVisibleFn(position);
 
-	// Adjustment to a ray length to ensure all rays lie on an
-	// accurate circle
-	constexpr uint8_t RayLenAdj[23] = { 0, 0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 4, 3, 2, 2, 2, 1, 1, 1, 0, 0, 0, 0 };
-	static_assert(std::size(RayLenAdj) == std::size(VisionRays));
-
-	// Four quadrants on a circle
-	constexpr Displacement Quadrants[] = { { 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 } };
-
-	// Loop over quadrants and mirror rays for each one
-	for (const auto &quadrant : Quadrants) {
-		// Cast a ray for a quadrant
-		for (unsigned int j = 0; j < std::size(VisionRays); j++) {
-			const int rayLen = radius - RayLenAdj[j];
-			for (int k = 0; k < rayLen; k++) {
-				const auto &relRayPoint = VisionRays[j][k];
-				// Calculate the next point on a ray in the quadrant
-				const Point rayPoint = position + relRayPoint * quadrant;
-				if (!inBoundsFn(rayPoint)) break;
-
-				// We've cast an approximated ray on an integer 2D
-				// grid, so we need to check if a ray can pass through
-				// the diagonally adjacent tiles. For example, consider
-				// this case:
-				//
-				//        #?
-				//       ↗ #
-				//     x
-				//
-				// The ray is cast from the observer 'x', and reaches
-				// the '?', but diagonally adjacent tiles '#' do not
-				// pass the light, so the '?' should not be visible
-				// for the 2D observer.
-				//
-				// The trick is to perform two additional visibility
-				// checks for the diagonally adjacent tiles, but only
-				// for the rays that are not parallel to the X or Y
-				// coordinate lines. Parallel rays, which have a 0 in
-				// one of their coordinate components, do not require
-				// any additional adjacent visibility checks, and the
-				// tile, hit by the ray, is always considered visible.
-				//
-				if (relRayPoint.deltaX > 0 && relRayPoint.deltaY > 0) {
-					const Displacement adjacent1 = { -quadrant.deltaX, 0 };
-					const Displacement adjacent2 = { 0, -quadrant.deltaY };
-
-					// If diagonally adjacent tiles do not pass the
-					// light further, we are done with this ray.
-					const bool passesLight = (passesLightFn(rayPoint + adjacent1) || passesLightFn(rayPoint + adjacent2));
-					if (!passesLight) break;
-				}
-				markVisibleFn(rayPoint);
-
-				// If the tile does not pass the light further, we are
-				// done with this ray.
-				const bool passesLight = passesLightFn(rayPoint);
-				if (!passesLight) break;
-
-				markTransparentFn(rayPoint);
-			}
-		}
-	}
+	for (int octant = 0; octant < NumVisionOctants; octant++)
+		DoVisionOctant(position, radius, octant, markVisibleFn, markTransparentFn, passesLightFn, inBoundsFn);
 }
 
 } // namespace devilution
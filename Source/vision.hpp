@@ -4,10 +4,114 @@
 
 #include <function_ref.hpp>
 
+#include "engine/displacement.hpp"
 #include "engine/point.hpp"
 
 namespace devilution {
 
+namespace detail {
+
+constexpr unsigned NumVisionRays = 23;
+constexpr unsigned MaxVisionRayLength = 15;
+
+/*
+ * XY points of vision rays are cast to trace the visibility of the
+ * surrounding environment. The table represents N rays of M points in
+ * one quadrant (0°-90°) of a circle, so rays for other quadrants will
+ * be created by mirroring. Zero points at the end will be trimmed and
+ * ignored. A similar table can be recreated using Bresenham's line
+ * drawing algorithm, which is suitable for integer arithmetic:
+ * https://en.wikipedia.org/wiki/Bresenham's_line_algorithm
+ */
+extern const DisplacementOf<int8_t> VisionRays[NumVisionRays][MaxVisionRayLength];
+
+// Adjustment to a ray length to ensure all rays lie on an
+// accurate circle
+extern const uint8_t RayLenAdj[NumVisionRays];
+
+} // namespace detail
+
+/**
+ * @brief Number of parts `DoVisionOctant` splits the circle of vision into.
+ *
+ * Each quadrant is split at its diagonal, the rays up to and including the diagonal form the first octant.
+ */
+constexpr int NumVisionOctants = 8;
+
+/**
+ * @brief Casts the vision rays of a single octant, see `DoVision`.
+ *
+ * Octants don't depend on each other, calling this for octants 0 to 7 after marking the observer's
+ * own tile visible is exactly what `DoVision` does. The callbacks are taken by value so that callers
+ * passing lambdas get them inlined into the ray walk.
+ */
+template <typename MarkVisibleFn, typename MarkTransparentFn, typename PassesLightFn, typename InBoundsFn>
+void DoVisionOctant(Point position, uint8_t radius, int octant,
+    MarkVisibleFn markVisibleFn,
+    MarkTransparentFn markTransparentFn,
+    PassesLightFn passesLightFn,
+    InBoundsFn inBoundsFn)
+{
+	// Four quadrants on a circle
+	constexpr Displacement Quadrants[] = { { 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 } };
+	constexpr unsigned DiagonalRay = detail::NumVisionRays / 2;
+
+	const Displacement quadrant = Quadrants[octant / 2];
+	const unsigned firstRay = octant % 2 == 0 ? 0 : DiagonalRay + 1;
+	const unsigned lastRay = octant % 2 == 0 ? DiagonalRay : detail::NumVisionRays - 1;
+
+	// Cast the rays of the octant, mirrored into its quadrant
+	for (unsigned int j = firstRay; j <= lastRay; j++) {
+		const int rayLen = radius - detail::RayLenAdj[j];
+		for (int k = 0; k < rayLen; k++) {
+			const auto &relRayPoint = detail::VisionRays[j][k];
+			// Calculate the next point on a ray in the quadrant
+			const Point rayPoint = position + relRayPoint * quadrant;
+			if (!inBoundsFn(rayPoint)) break;
+
+			// We've cast an approximated ray on an integer 2D
+			// grid, so we need to check if a ray can pass through
+			// the diagonally adjacent tiles. For example, consider
+			// this case:
+			//
+			//        #?
+			//       ↗ #
+			//     x
+			//
+			// The ray is cast from the observer 'x', and reaches
+			// the '?', but diagonally adjacent tiles '#' do not
+			// pass the light, so the '?' should not be visible
+			// for the 2D observer.
+			//
+			// The trick is to perform two additional visibility
+			// checks for the diagonally adjacent tiles, but only
+			// for the rays that are not parallel to the X or Y
+			// coordinate lines. Parallel rays, which have a 0 in
+			// one of their coordinate components, do not require
+			// any additional adjacent visibility checks, and the
+			// tile, hit by the ray, is always considered visible.
+			//
+			if (relRayPoint.deltaX > 0 && relRayPoint.deltaY > 0) {
+				const Displacement adjacent1 = { -quadrant.deltaX, 0 };
+				const Displacement adjacent2 = { 0, -quadrant.deltaY };
+
+				// If diagonally adjacent tiles do not pass the
+				// light further, we are done with this ray.
+				const bool passesLight = (passesLightFn(rayPoint + adjacent1) || passesLightFn(rayPoint + adjacent2));
+				if (!passesLight) break;
+			}
+			markVisibleFn(rayPoint);
+
+			// If the tile does not pass the light further, we are
+			// done with this ray.
+			const bool passesLight = passesLightFn(rayPoint);
+			if (!passesLight) break;
+
+			markTransparentFn(rayPoint);
+		}
+	}
+}
+
 void DoVision(Point position, uint8_t radius,
     tl::function_ref<void(Point)> markVisibleFn,
     tl::function_ref<void(Point)> markTransparentFn,
@@ -1,3 +1,12 @@
+local events
+
+---Lets the engine know that it has to look up the event triggers again.
+local function Changed()
+  if events.__onChanged ~= nil then
+    events.__onChanged()
+  end
+end
+
 local function CreateEvent()
   local functions = {}
   return {
@@ -7,6 +16,7 @@ local function CreateEvent()
     ---@param func function
     add = function(func)
       table.insert(functions, func)
+      Changed()
     end,
 
     ---Removes the event handler.
@@ -15,6 +25,7 @@ local function CreateEvent()
       for i, f in ipairs(functions) do
         if f == func then
           table.remove(functions, i)
+          Changed()
           break
         end
       end
@@ -33,10 +44,13 @@ local function CreateEvent()
       return result
     end,
     __sig_trigger = "(...)",
+
+    ---The engine skips triggering events without handlers.
+    __handlers = functions,
   }
 end
 
-local events = {
+events = {
   ---Called after all mods have been loaded.
   LoadModsComplete = CreateEvent(),
   __doc_LoadModsComplete = "Called after all mods have been loaded.",
@@ -73,6 +87,11 @@ local events = {
   OnMonsterTakeDamage = CreateEvent(),
   __doc_OnMonsterTakeDamage = "Called when a Monster takes damage.",
 
+  ---Called once at the end of each game tick in which monsters took damage.
+  ---Passes a MonsterDamageBatch with all the damage of that tick, only valid during the call.
+  OnMonsterTakeDamageBatch = CreateEvent(),
+  __doc_OnMonsterTakeDamageBatch = "Called once at the end of each game tick in which monsters took damage, with all the damage of that tick.",
+
   ---Called when Player takes damage.
   OnPlayerTakeDamage = CreateEvent(),
   __doc_OnPlayerTakeDamage = "Called when Player takes damage.",
@@ -86,6 +105,7 @@ local events = {
 ---@param name string
 function events.registerCustom(name)
   events[name] = CreateEvent()
+  Changed()
 end
 
 events.__sig_registerCustom = "(name: string)"
@@ -51,22 +51,38 @@ end
 local accumulated_damage = {}
 local MERGE_WINDOW_MS = 100
 
-events.OnMonsterTakeDamage.add(function(monster, damage, damage_type)
-    local id = monster.id
+events.OnMonsterTakeDamageBatch.add(function(batch)
     local now = system.get_ticks()
-    
-    local entry = accumulated_damage[id]
-    if entry and (now - entry.time) < MERGE_WINDOW_MS then
-        entry.damage = entry.damage + damage
-    else
-        entry = { damage = damage, time = now }
-        accumulated_damage[id] = entry
+    local hit = {}
+    local hit_order = {}
+
+    for i = 1, #batch do
+        local monster = batch:monster(i)
+        local damage = batch:damage(i)
+        local id = monster.id
+
+        local entry = accumulated_damage[id]
+        if entry and (now - entry.time) < MERGE_WINDOW_MS then
+            entry.damage = entry.damage + damage
+        else
+            entry = { damage = damage, time = now }
+            accumulated_damage[id] = entry
+        end
+        entry.time = now
+
+        if not hit[id] then
+            hit_order[#hit_order + 1] = id
+        end
+        hit[id] = { monster = monster, damage_type = batch:damageType(i) }
     end
-    entry.time = now
 
-    local text = format_damage(entry.damage)
-    local style = get_damage_style(entry.damage, damage_type)
-    floatingnumbers.add(text, monster.position, style, id, false) 
+    -- One number per monster and tick, with the type of the last hit
+    for _, id in ipairs(hit_order) do
+        local entry = accumulated_damage[id]
+        local text = format_damage(entry.damage)
+        local style = get_damage_style(entry.damage, hit[id].damage_type)
+        floatingnumbers.add(text, hit[id].monster.position, style, id, false)
+    end
 end)
 
 events.OnPlayerTakeDamage.add(function(_player, damage, damage_type)
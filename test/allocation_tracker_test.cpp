@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "utils/allocation_tracker.hpp"
+
+using namespace devilution;
+
+namespace {
+
+TEST(AllocationTracker, CountsAllocationsAndBytes)
+{
+	const AllocationCounts counts = CountAllocations([]() {
+		const std::unique_ptr<int> one = std::make_unique<int>(1);
+		const std::unique_ptr<char[]> many = std::make_unique<char[]>(100);
+	});
+	EXPECT_EQ(counts.allocations, 2U);
+	EXPECT_EQ(counts.bytes, sizeof(int) + 100);
+}
+
+TEST(AllocationTracker, ReusedStorageDoesNotAllocate)
+{
+	std::vector<int> values;
+	values.reserve(64);
+	const AllocationCounts counts = CountAllocations([&values]() {
+		for (int tick = 0; tick < 10; tick++) {
+			values.clear();
+			for (int i = 0; i < 64; i++)
+				values.push_back(i);
+		}
+	});
+	EXPECT_EQ(counts.allocations, 0U);
+	EXPECT_EQ(counts.bytes, 0U);
+}
+
+TEST(AllocationTracker, OnlyCountsTheCallingThread)
+{
+	const AllocationCounts counts = CountAllocations([]() {
+		std::thread thread([]() {
+			const std::vector<int> values(1000);
+		});
+		thread.join();
+	});
+	// Starting the thread may allocate on this thread, but not the 4000 bytes of the vector.
+	EXPECT_LT(counts.bytes, 1000 * sizeof(int));
+}
+
+} // namespace
@@ -0,0 +1,84 @@
+#include "utils/sdl_bilinear_scale.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef USE_SDL3
+#include <SDL3/SDL_pixels.h>
+#include <SDL3/SDL_surface.h>
+#else
+#include <SDL.h>
+#endif
+
+#include <benchmark/benchmark.h>
+
+#include "utils/sdl_wrap.h"
+
+namespace devilution {
+namespace {
+
+uint8_t BlendingTable[256][256];
+
+/**
+ * @brief Fills the surface with a pattern of opaque, transparent and translucent runs, like a cursor sprite.
+ */
+void FillPattern(SDL_Surface *surface, unsigned bytesPerPixel)
+{
+	auto *pixels = static_cast<uint8_t *>(surface->pixels);
+	for (int y = 0; y < surface->h; ++y) {
+		uint8_t *row = pixels + static_cast<ptrdiff_t>(y * surface->pitch);
+		for (int x = 0; x < surface->w * static_cast<int>(bytesPerPixel); ++x) {
+			row[x] = static_cast<uint8_t>((x * 7) + (y * 13));
+		}
+		if (bytesPerPixel != 4)
+			continue;
+		for (int x = 0; x < surface->w; ++x) {
+			const int edge = (x + y) % 32;
+			row[(x * 4) + 3] = edge < 4 ? 0 : (edge < 6 ? 128 : 255);
+		}
+	}
+}
+
+void BM_BilinearScale32(benchmark::State &state)
+{
+	const auto srcSize = static_cast<int>(state.range(0));
+	const auto dstSize = static_cast<int>(state.range(1));
+	const SDLSurfaceUniquePtr src = SDLWrap::CreateRGBSurfaceWithFormat(
+	    /*flags=*/0, srcSize, srcSize, /*depth=*/32, SDL_PIXELFORMAT_ARGB8888);
+	const SDLSurfaceUniquePtr dst = SDLWrap::CreateRGBSurfaceWithFormat(
+	    /*flags=*/0, dstSize, dstSize, /*depth=*/32, SDL_PIXELFORMAT_ARGB8888);
+	FillPattern(src.get(), 4);
+	for (auto _ : state) {
+		BilinearScale32(src.get(), dst.get());
+		benchmark::DoNotOptimize(dst->pixels);
+	}
+	state.SetItemsProcessed(state.iterations() * dstSize * dstSize);
+}
+
+void BM_BilinearDownscaleByHalf8(benchmark::State &state)
+{
+	for (unsigned i = 0; i < 256; ++i) {
+		for (unsigned j = 0; j < 256; ++j) {
+			BlendingTable[i][j] = static_cast<uint8_t>((i + j) / 2);
+		}
+	}
+	const auto dstSize = static_cast<int>(state.range(0));
+	const SDLSurfaceUniquePtr src = SDLWrap::CreateRGBSurfaceWithFormat(
+	    /*flags=*/0, dstSize * 2, dstSize * 2, /*depth=*/8, SDL_PIXELFORMAT_INDEX8);
+	const SDLSurfaceUniquePtr dst = SDLWrap::CreateRGBSurfaceWithFormat(
+	    /*flags=*/0, dstSize, dstSize, /*depth=*/8, SDL_PIXELFORMAT_INDEX8);
+	FillPattern(src.get(), 1);
+	for (auto _ : state) {
+		BilinearDownscaleByHalf8(src.get(), BlendingTable, dst.get(), 1);
+		benchmark::DoNotOptimize(dst->pixels);
+	}
+	state.SetItemsProcessed(state.iterations() * dstSize * dstSize);
+}
+
+// Hardware cursor sizes: a 28x28 item cursor scaled up by 1.5x, 2x and 4x.
+BENCHMARK(BM_BilinearScale32)->Args({ 28, 42 })->Args({ 28, 56 })->Args({ 28, 112 });
+// Item graphics halved for the inventory.
+BENCHMARK(BM_BilinearDownscaleByHalf8)->Arg(28)->Arg(56);
+
+} // namespace
+} // namespace devilution
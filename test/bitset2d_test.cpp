@@ -0,0 +1,109 @@
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utils/bitset2d.hpp"
+
+using namespace devilution;
+
+namespace {
+
+// Wider than a word, so that rectangles can span two words of a row.
+constexpr size_t Width = 70;
+constexpr size_t Height = 20;
+
+TEST(Bitset2dTest, SetTestReset)
+{
+	Bitset2d<Width, Height> bits;
+	EXPECT_EQ(bits.count(), 0);
+	bits.set(0, 0);
+	bits.set(63, 1);
+	bits.set(64, 1);
+	bits.set(Width - 1, Height - 1);
+	EXPECT_TRUE(bits.test(0, 0));
+	EXPECT_TRUE(bits.test(63, 1));
+	EXPECT_TRUE(bits.test(64, 1));
+	EXPECT_TRUE(bits.test(Width - 1, Height - 1));
+	EXPECT_FALSE(bits.test(1, 0));
+	EXPECT_FALSE(bits.test(0, 1));
+	EXPECT_EQ(bits.count(), 4);
+
+	bits.reset(63, 1);
+	bits.set(64, 1, false);
+	EXPECT_FALSE(bits.test(63, 1));
+	EXPECT_FALSE(bits.test(64, 1));
+	EXPECT_EQ(bits.count(), 2);
+
+	bits.reset();
+	EXPECT_EQ(bits.count(), 0);
+}
+
+TEST(Bitset2dTest, RectQueriesMatchCellQueries)
+{
+	std::mt19937 rng(testing::UnitTest::GetInstance()->random_seed());
+	Bitset2d<Width, Height> bits;
+	for (int i = 0; i < 200; i++) {
+		const size_t x = rng() % Width;
+		const size_t y = rng() % Height;
+		const size_t width = rng() % (Width - x + 1);
+		const size_t height = rng() % (Height - y + 1);
+		if (i % 4 == 0) {
+			bits.fillRect(x, y, width, height, rng() % 3 != 0);
+			continue;
+		}
+
+		size_t count = 0;
+		for (size_t yy = y; yy < y + height; yy++) {
+			for (size_t xx = x; xx < x + width; xx++) {
+				if (bits.test(xx, yy))
+					count++;
+			}
+		}
+		const size_t area = width * height;
+		EXPECT_EQ(bits.countInRect(x, y, width, height), count) << x << "," << y << " " << width << "x" << height;
+		EXPECT_EQ(bits.anyInRect(x, y, width, height), count != 0) << x << "," << y << " " << width << "x" << height;
+		EXPECT_EQ(bits.allInRect(x, y, width, height), count == area) << x << "," << y << " " << width << "x" << height;
+	}
+}
+
+TEST(Bitset2dTest, FillRectOnlyChangesTheRect)
+{
+	Bitset2d<Width, Height> bits;
+	bits.fillRect(60, 3, 8, 2);
+	EXPECT_EQ(bits.count(), 16);
+	EXPECT_TRUE(bits.allInRect(60, 3, 8, 2));
+	EXPECT_FALSE(bits.test(59, 3));
+	EXPECT_FALSE(bits.test(68, 3));
+	EXPECT_FALSE(bits.test(60, 2));
+	EXPECT_FALSE(bits.test(60, 5));
+
+	bits.fillRect(62, 3, 4, 1, false);
+	EXPECT_EQ(bits.count(), 12);
+	EXPECT_FALSE(bits.anyInRect(62, 3, 4, 1));
+	EXPECT_TRUE(bits.anyInRect(0, 0, Width, Height));
+}
+
+TEST(Bitset2dTest, ForEachSetVisitsRowByRow)
+{
+	Bitset2d<Width, Height> bits;
+	bits.set(65, 2);
+	bits.set(3, 2);
+	bits.set(7, 0);
+	bits.set(Width - 1, Height - 1);
+
+	std::vector<std::pair<size_t, size_t>> visited;
+	bits.forEachSet([&](size_t x, size_t y) { visited.emplace_back(x, y); });
+	const std::vector<std::pair<size_t, size_t>> expected { { 7, 0 }, { 3, 2 }, { 65, 2 }, { Width - 1, Height - 1 } };
+	EXPECT_EQ(visited, expected);
+
+	EXPECT_TRUE(bits.anyInRow(2));
+	EXPECT_FALSE(bits.anyInRow(1));
+	std::vector<size_t> row;
+	bits.forEachSetInRow(2, [&](size_t x) { row.push_back(x); });
+	EXPECT_EQ(row, (std::vector<size_t> { 3, 65 }));
+}
+
+} // namespace
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "utils/bump_arena.hpp"
+
+using namespace devilution;
+
+namespace {
+
+TEST(BumpArena, AlignsAllocations)
+{
+	BumpArena arena { 64 };
+	[[maybe_unused]] uint8_t *byte = arena.allocate<uint8_t>(1);
+	const uint32_t *word = arena.allocate<uint32_t>(2);
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(word) % alignof(uint32_t), 0);
+	const uint64_t *quad = arena.allocate<uint64_t>(1);
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(quad) % alignof(uint64_t), 0);
+	EXPECT_EQ(arena.capacity(), 64);
+}
+
+TEST(BumpArena, AllocationsDontOverlap)
+{
+	BumpArena arena { 16 };
+	uint16_t *a = arena.allocate<uint16_t>(6);
+	uint16_t *b = arena.allocate<uint16_t>(6);
+	for (int i = 0; i < 6; i++) {
+		a[i] = 1;
+		b[i] = 2;
+	}
+	for (int i = 0; i < 6; i++) {
+		EXPECT_EQ(a[i], 1);
+		EXPECT_EQ(b[i], 2);
+	}
+	EXPECT_EQ(arena.capacity(), 32);
+}
+
+TEST(BumpArena, LargeRequestsGetTheirOwnChunk)
+{
+	BumpArena arena { 16 };
+	[[maybe_unused]] std::byte *data = arena.allocate<std::byte>(100);
+	EXPECT_EQ(arena.capacity(), 100);
+}
+
+TEST(BumpArena, ResetReusesTheChunks)
+{
+	BumpArena arena { 16 };
+	uint8_t *first = arena.allocate<uint8_t>(16);
+	[[maybe_unused]] uint8_t *second = arena.allocate<uint8_t>(100);
+	arena.reset();
+	EXPECT_EQ(arena.allocate<uint8_t>(16), first);
+	[[maybe_unused]] uint8_t *third = arena.allocate<uint8_t>(50);
+	EXPECT_EQ(arena.capacity(), 116);
+}
+
+} // namespace
@@ -1,4 +1,6 @@
+#include <array>
 #include <cstddef>
+#include <cstdint>
 
 #include <benchmark/benchmark.h>
 
@@ -13,8 +15,18 @@
 namespace devilution {
 namespace {
 
+void SetRunCacheCounters(benchmark::State &state)
+{
+	const ClxRunCacheStats stats = GetClxRunCacheStats();
+	const size_t lookups = stats.hits + stats.misses;
+	state.counters["cache_bytes"] = static_cast<double>(stats.bytes);
+	state.counters["cache_entries"] = static_cast<double>(stats.entries);
+	state.counters["cache_hit_rate"] = lookups == 0 ? 0.0 : static_cast<double>(stats.hits) / static_cast<double>(lookups);
+}
+
 void BM_RenderSmallClx(benchmark::State &state)
 {
+	SetClxRunCacheBudget(static_cast<size_t>(state.range(0)));
 	const SDLSurfaceUniquePtr sdl_surface = SDLWrap::CreateRGBSurfaceWithFormat(
 	    /*flags=*/0, /*width=*/640, /*height=*/480, /*depth=*/8, SDL_PIXELFORMAT_INDEX8);
 	if (sdl_surface == nullptr) {
@@ -34,10 +46,13 @@ void BM_RenderSmallClx(benchmark::State &state)
 	}
 	state.SetBytesProcessed(state.iterations() * sprites.dataSize());
 	state.SetItemsProcessed(state.iterations() * numSprites);
+	SetRunCacheCounters(state);
+	ClearClxDrawCache();
 }
 
 void BM_RenderLargeClx(benchmark::State &state)
 {
+	SetClxRunCacheBudget(static_cast<size_t>(state.range(0)));
 	const SDLSurfaceUniquePtr sdl_surface = SDLWrap::CreateRGBSurfaceWithFormat(
 	    /*flags=*/0, /*width=*/640, /*height=*/480, /*depth=*/8, SDL_PIXELFORMAT_INDEX8);
 	if (sdl_surface == nullptr) {
@@ -54,10 +69,78 @@ void BM_RenderLargeClx(benchmark::State &state)
 	}
 	state.SetBytesProcessed(state.iterations() * sprites.dataSize());
 	state.SetItemsProcessed(state.iterations());
+	SetRunCacheCounters(state);
+	ClearClxDrawCache();
+}
+
+void BM_RenderClxTRN(benchmark::State &state)
+{
+	SetClxTrnCacheBudget(static_cast<size_t>(state.range(0)));
+	const SDLSurfaceUniquePtr sdl_surface = SDLWrap::CreateRGBSurfaceWithFormat(
+	    /*flags=*/0, /*width=*/640, /*height=*/480, /*depth=*/8, SDL_PIXELFORMAT_INDEX8);
+	if (sdl_surface == nullptr) {
+		LogError("Failed to create SDL Surface: {}", SDL_GetError());
+		exit(1);
+	}
+	const Surface out = Surface(sdl_surface.get());
+	const OwnedClxSpriteList sprites = LoadClx("data\\resistance.clx");
+	std::array<uint8_t, 256> trn;
+	for (size_t i = 0; i < trn.size(); ++i)
+		trn[i] = static_cast<uint8_t>(255 - i);
+
+	const size_t numSprites = sprites.numSprites();
+	for (auto _ : state) {
+		for (size_t i = 0; i < numSprites; ++i) {
+			ClxDrawTRN(out, Point { static_cast<int>(i * 100), static_cast<int>(i * 60) + 100 }, sprites[i], trn.data());
+		}
+		uint8_t color = out[Point { 120, 120 }];
+		benchmark::DoNotOptimize(color);
+	}
+	state.SetBytesProcessed(state.iterations() * sprites.dataSize());
+	state.SetItemsProcessed(state.iterations() * numSprites);
+	const ClxTrnCacheStats stats = GetClxTrnCacheStats();
+	const size_t lookups = stats.hits + stats.misses;
+	state.counters["cache_bytes"] = static_cast<double>(stats.bytes);
+	state.counters["cache_hit_rate"] = lookups == 0 ? 0.0 : static_cast<double>(stats.hits) / static_cast<double>(lookups);
+	ClearClxDrawCache();
+}
+
+void BM_RenderClxOutline(benchmark::State &state)
+{
+	SetClxOutlineCacheBudget(static_cast<size_t>(state.range(0)));
+	const SDLSurfaceUniquePtr sdl_surface = SDLWrap::CreateRGBSurfaceWithFormat(
+	    /*flags=*/0, /*width=*/640, /*height=*/480, /*depth=*/8, SDL_PIXELFORMAT_INDEX8);
+	if (sdl_surface == nullptr) {
+		LogError("Failed to create SDL Surface: {}", SDL_GetError());
+		exit(1);
+	}
+	const Surface out = Surface(sdl_surface.get());
+	const OwnedClxSpriteList sprites = LoadClx("data\\resistance.clx");
+
+	// Several outlines a frame, like a hovered item next to a highlighted monster.
+	const size_t numSprites = sprites.numSprites();
+	for (auto _ : state) {
+		for (size_t i = 0; i < numSprites; ++i) {
+			ClxDrawOutlineSkipColorZero(out, 130, Point { static_cast<int>(i * 100) + 1, static_cast<int>(i * 60) + 100 }, sprites[i]);
+		}
+		uint8_t color = out[Point { 120, 120 }];
+		benchmark::DoNotOptimize(color);
+	}
+	state.SetItemsProcessed(state.iterations() * numSprites);
+	const ClxOutlineCacheStats stats = GetClxOutlineCacheStats();
+	const size_t lookups = stats.hits + stats.misses;
+	state.counters["cache_bytes"] = static_cast<double>(stats.bytes);
+	state.counters["cache_hit_rate"] = lookups == 0 ? 0.0 : static_cast<double>(stats.hits) / static_cast<double>(lookups);
+	ClearClxDrawCache();
 }
 
-BENCHMARK(BM_RenderSmallClx);
-BENCHMARK(BM_RenderLargeClx);
+// The argument is the decoded-run cache budget in bytes (0 = disabled).
+BENCHMARK(BM_RenderSmallClx)->Arg(0)->Arg(1 << 20);
+BENCHMARK(BM_RenderLargeClx)->Arg(0)->Arg(1 << 20);
+// The argument is the TRN cache budget in bytes (0 = disabled).
+BENCHMARK(BM_RenderClxTRN)->Arg(0)->Arg(1 << 20);
+// The argument is the outline cache budget in bytes (0 = only the last outline is kept).
+BENCHMARK(BM_RenderClxOutline)->Arg(0)->Arg(1 << 20);
 
 } // namespace
 } // namespace devilution
@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
 #include "codec.h"
 
 using namespace devilution;
@@ -13,3 +17,34 @@ TEST(Codec, codec_get_encoded_len_eq)
 {
 	EXPECT_EQ(codec_get_encoded_len(128), 136);
 }
+
+TEST(Codec, EncodesTheSaveFormat)
+{
+	// Encoded with the original implementation, any change to the hashing must keep these bytes.
+	constexpr uint8_t Expected[] = {
+	    0x69, 0x5d, 0xa1, 0x51, 0xd1, 0x20, 0xca, 0x9a, 0xe1, 0xe6, 0xb6, 0x35,
+	    0xde, 0xf9, 0x5e, 0x5a, 0x6d, 0xd7, 0xb6, 0xe9, 0x8d, 0x79, 0xcd, 0x75,
+	    0xcd, 0x4c, 0xee, 0x66, 0xc5, 0x82, 0xaa, 0x11, 0xb2, 0xc5, 0xba, 0x76,
+	    0x09, 0x33, 0x9a, 0x8d, 0xb1, 0x95, 0xe9, 0x69, 0x29, 0x68, 0x92, 0x42,
+	    0x29, 0x9e, 0x8e, 0xfd, 0x96, 0xa1, 0x96, 0x92, 0x15, 0x1f, 0x7e, 0xb1,
+	    0xd5, 0xb1, 0xf5, 0x0d, 0xb4, 0xa1, 0xfc, 0xa0, 0xe2, 0x50, 0x63, 0xe8,
+	    0xb5, 0x21, 0x14, 0x88, 0x11, 0x67, 0x86, 0x0e, 0xb7, 0xfa, 0x4f, 0x22,
+	    0xd0, 0x85, 0x10, 0x84, 0xfe, 0xbc, 0x47, 0x94, 0x91, 0xc5, 0x08, 0xac,
+	    0xfd, 0x5b, 0xe2, 0x22, 0x2c, 0x3a, 0xaa, 0x28, 0xff, 0xd1, 0x69, 0x1a,
+	    0x3d, 0x54, 0x4a, 0xa6, 0xc6, 0xb9, 0xa9, 0x6a, 0x16, 0x4b, 0xd7, 0x78,
+	    0x2c, 0x3a, 0xaa, 0x28, 0xff, 0xd1, 0x69, 0x1a, 0x0c, 0x51, 0x9e, 0x69,
+	    0x00, 0x24, 0x00, 0x00
+	};
+	std::array<std::byte, sizeof(Expected)> buffer {};
+	for (size_t i = 0; i < 100; i++)
+		buffer[i] = static_cast<std::byte>(i * 37 + 11);
+	ASSERT_EQ(codec_get_encoded_len(100), buffer.size());
+
+	codec_encode(buffer.data(), 100, buffer.size(), "xrgyrkj1");
+	for (size_t i = 0; i < buffer.size(); i++)
+		ASSERT_EQ(static_cast<uint8_t>(buffer[i]), Expected[i]) << i;
+
+	ASSERT_EQ(codec_decode(buffer.data(), buffer.size(), "xrgyrkj1"), 100);
+	for (size_t i = 0; i < 100; i++)
+		ASSERT_EQ(buffer[i], static_cast<std::byte>(i * 37 + 11)) << i;
+}
@@ -2,6 +2,8 @@
 
 #include "crawl.hpp"
 #include "engine/displacement.hpp"
+#include "engine/point.hpp"
+#include "vision.hpp"
 
 namespace devilution {
 namespace {
@@ -19,7 +21,79 @@ void BM_Crawl(benchmark::State &state)
 	}
 }
 
+/** @brief The same crawl through the `tl::function_ref` visitor of `DoCrawl`, which `Crawl` only uses past the table. */
+void BM_DoCrawl(benchmark::State &state)
+{
+	const int radius = static_cast<int>(state.range(0));
+	for (auto _ : state) {
+		int sum;
+		DoCrawl(0, radius, [&sum](Displacement d) {
+			sum += d.deltaX + d.deltaY;
+			return true;
+		});
+		benchmark::DoNotOptimize(sum);
+	}
+}
+
 BENCHMARK(BM_Crawl)->RangeMultiplier(4)->Range(1, 20);
+BENCHMARK(BM_DoCrawl)->RangeMultiplier(4)->Range(1, 20);
+
+constexpr int VisionMapSize = 64;
+bool VisionMapWalls[VisionMapSize][VisionMapSize];
+bool VisionMapVisible[VisionMapSize][VisionMapSize];
+
+void InitVisionMap()
+{
+	// A room with some pillars in it, so most rays travel a while before they hit anything.
+	for (int x = 0; x < VisionMapSize; x++) {
+		for (int y = 0; y < VisionMapSize; y++) {
+			const bool border = x == 8 || y == 8 || x == VisionMapSize - 8 || y == VisionMapSize - 8;
+			VisionMapWalls[x][y] = border || (x % 7 == 0 && y % 5 == 0);
+		}
+	}
+}
+
+bool VisionMapInBounds(Point p)
+{
+	return p.x >= 0 && p.y >= 0 && p.x < VisionMapSize && p.y < VisionMapSize;
+}
+
+void BM_Vision(benchmark::State &state)
+{
+	InitVisionMap();
+	const uint8_t radius = static_cast<uint8_t>(state.range(0));
+	for (auto _ : state) {
+		DoVision(
+		    { VisionMapSize / 2, VisionMapSize / 2 }, radius,
+		    [](Point p) { VisionMapVisible[p.x][p.y] = true; },
+		    [](Point) {},
+		    [](Point p) { return VisionMapInBounds(p) && !VisionMapWalls[p.x][p.y]; },
+		    VisionMapInBounds);
+		benchmark::DoNotOptimize(VisionMapVisible);
+	}
+}
+
+void BM_VisionOctants(benchmark::State &state)
+{
+	InitVisionMap();
+	const uint8_t radius = static_cast<uint8_t>(state.range(0));
+	const Point position { VisionMapSize / 2, VisionMapSize / 2 };
+	for (auto _ : state) {
+		VisionMapVisible[position.x][position.y] = true;
+		for (int octant = 0; octant < NumVisionOctants; octant++) {
+			DoVisionOctant(
+			    position, radius, octant,
+			    [](Point p) { VisionMapVisible[p.x][p.y] = true; },
+			    [](Point) {},
+			    [](Point p) { return VisionMapInBounds(p) && !VisionMapWalls[p.x][p.y]; },
+			    VisionMapInBounds);
+		}
+		benchmark::DoNotOptimize(VisionMapVisible);
+	}
+}
+
+BENCHMARK(BM_Vision)->Arg(10)->Arg(15);
+BENCHMARK(BM_VisionOctants)->Arg(10)->Arg(15);
 
 } // namespace
 } // namespace devilution
@@ -1,4 +1,6 @@
 #include <cmath>
+#include <optional>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -58,5 +60,37 @@ TEST(CrawlTest, VisitationOrderTest)
 	        Displacement(2, 1), Displacement(-2, -1), Displacement(2, -1)));
 }
 
+TEST(CrawlTest, TableMatchesDoCrawl)
+{
+	for (unsigned minRadius = 0; minRadius <= detail::MaxCrawlTableRadius + 2; minRadius++) {
+		for (unsigned maxRadius = minRadius; maxRadius <= detail::MaxCrawlTableRadius + 2; maxRadius++) {
+			std::vector<Displacement> expected;
+			DoCrawl(minRadius, maxRadius, [&](Displacement displacement) {
+				expected.push_back(displacement);
+				return true;
+			});
+			std::vector<Displacement> order;
+			Crawl(minRadius, maxRadius, [&](Displacement displacement) {
+				order.push_back(displacement);
+				return false;
+			});
+			EXPECT_EQ(order, expected) << "radius " << minRadius << " to " << maxRadius;
+		}
+	}
+}
+
+TEST(CrawlTest, StopsAtFirstResult)
+{
+	int visited = 0;
+	const std::optional<Displacement> result = Crawl(0, 3, [&](Displacement displacement) -> std::optional<Displacement> {
+		visited++;
+		if (displacement.deltaX == -1 && displacement.deltaY == 2)
+			return displacement;
+		return std::nullopt;
+	});
+	EXPECT_EQ(result, Displacement(-1, 2));
+	EXPECT_EQ(visited, 8);
+}
+
 } // namespace
 } // namespace devilution
@@ -2,7 +2,10 @@
 
 #include "data/file.hpp"
 #include "data/parser.hpp"
+#include "data/table_cache.hpp"
 
+#include <span>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -451,6 +454,39 @@ TEST(DataFileTest, DiscardAllUpToLastField)
 	EXPECT_EQ(row, expectedFields.size()) << "Parsing returned fewer records than expected";
 }
 
+TEST(DataFileTest, DiscardFieldsInLongRecords)
+{
+	// Records longer than the scanner's block size, with separators at every offset within a block
+	std::string content;
+	for (int field = 0; field < 40; field++) {
+		content.append(static_cast<size_t>(field % 7), 'x');
+		content += '\t';
+	}
+	content += "last\r\n";
+	content.append(37, 'y');
+	content += "\tend";
+	const char *const end = content.data() + content.size();
+
+	for (unsigned skip = 1; skip <= 42; skip++) {
+		unsigned fieldsSkipped = 0;
+		GetFieldResult result = DiscardMultipleFields(content.data(), end, skip, &fieldsSkipped);
+		if (skip <= 40) {
+			EXPECT_EQ(fieldsSkipped, skip);
+			EXPECT_EQ(result.status, GetFieldResult::Status::EndOfField) << "Skipping " << skip << " fields";
+			EXPECT_EQ(GetNextField(result.next, end).value, skip == 40 ? "last" : std::string(skip % 7, 'x')) << "Skipping " << skip << " fields";
+		} else {
+			EXPECT_EQ(fieldsSkipped, 41U) << "Skipping should stop at the end of the record";
+			EXPECT_EQ(result.status, GetFieldResult::Status::EndOfRecord);
+			EXPECT_EQ(GetNextField(result.next, end).value, std::string(37, 'y'));
+		}
+	}
+
+	GetFieldResult result = DiscardRemainingFields(content.data(), end);
+	EXPECT_EQ(result.status, GetFieldResult::Status::EndOfRecord);
+	result = DiscardMultipleFields(result.next, end, 3);
+	EXPECT_EQ(result.status, GetFieldResult::Status::NoFinalTerminator);
+}
+
 TEST(DataFileTest, SkipFieldIterator)
 {
 	auto loadDataResult = LoadDataFile("txtdata\\lf.tsv");
@@ -529,4 +565,67 @@ TEST(DataFileTest, SkipRowIterator)
 	EXPECT_EQ(row, expectedFields.size()) << "Parsing returned fewer records than expected";
 }
 
+namespace {
+
+struct CachedRecord {
+	std::string name;
+	uint16_t value;
+	int8_t values[2];
+};
+
+constexpr auto TransferCachedRecord = [](auto &stream, CachedRecord &record) {
+	stream(record.name, record.value, record.values);
+};
+
+} // namespace
+
+TEST(DataFileTest, TableCacheRoundTrip)
+{
+	std::vector<CachedRecord> records { { "first", 1, { -1, 2 } }, { "", 65535, { 0, 0 } }, { "third", 3, { 127, -128 } } };
+	TableCacheWriter writer;
+	for (CachedRecord &record : records)
+		TransferCachedRecord(writer, record);
+
+	TableCacheReader reader { writer.data() };
+	for (const CachedRecord &expected : records) {
+		CachedRecord record {};
+		TransferCachedRecord(reader, record);
+		ASSERT_TRUE(reader.ok());
+		EXPECT_EQ(record.name, expected.name);
+		EXPECT_EQ(record.value, expected.value);
+		EXPECT_EQ(record.values[0], expected.values[0]);
+		EXPECT_EQ(record.values[1], expected.values[1]);
+	}
+	EXPECT_TRUE(reader.atEnd());
+
+	TableCacheReader truncated { writer.data().first(writer.data().size() - 1) };
+	for (size_t i = 0; i < records.size(); ++i) {
+		CachedRecord record {};
+		TransferCachedRecord(truncated, record);
+	}
+	EXPECT_FALSE(truncated.ok());
+}
+
+TEST(DataFileTest, TableCacheFile)
+{
+	paths::SetConfigPath(paths::BasePath() + "/test_table_cache/");
+	auto result = LoadDataFile("txtdata\\lf.tsv");
+	ASSERT_TRUE(result.has_value());
+	const uint64_t key = GetTableCacheKey(*result, sizeof(CachedRecord));
+	EXPECT_NE(key, GetTableCacheKey(*result, sizeof(CachedRecord) + 1));
+
+	std::vector<CachedRecord> records { { "cached", 42, { 1, 2 } } };
+	SaveTableToCache("txtdata\\lf.tsv", key, std::span(records), TransferCachedRecord);
+
+	std::vector<CachedRecord> loaded;
+	ASSERT_TRUE(LoadTableFromCache("txtdata\\lf.tsv", key, loaded, TransferCachedRecord));
+	ASSERT_EQ(loaded.size(), 1U);
+	EXPECT_EQ(loaded[0].name, "cached");
+	EXPECT_EQ(loaded[0].value, 42);
+
+	loaded.clear();
+	EXPECT_FALSE(LoadTableFromCache("txtdata\\lf.tsv", key + 1, loaded, TransferCachedRecord));
+	EXPECT_TRUE(loaded.empty());
+}
+
 } // namespace devilution
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+
+#include "engine/demo_stream.hpp"
+
+using namespace devilution;
+
+namespace {
+
+struct TmpFile {
+	FILE *file = std::tmpfile();
+	~TmpFile()
+	{
+		if (file != nullptr)
+			std::fclose(file);
+	}
+};
+
+long FileSize(FILE *file)
+{
+	std::fseek(file, 0, SEEK_END);
+	const long size = std::ftell(file);
+	std::rewind(file);
+	return size;
+}
+
+TEST(DemoStream, ReadsBackWhatWasWritten)
+{
+	const TmpFile tmp;
+	ASSERT_NE(tmp.file, nullptr);
+	{
+		DemoStreamWriter writer { tmp.file };
+		writer.writeByte(0x81);
+		for (const uint32_t value : { 0U, 1U, 127U, 128U, 300U, 16384U, std::numeric_limits<uint32_t>::max() })
+			writer.writeVarint(value);
+		for (const int32_t value : { 0, 1, -1, 63, -64, 64, -65, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max() })
+			writer.writeSignedVarint(value);
+		writer.flush();
+	}
+	std::rewind(tmp.file);
+
+	DemoStreamReader reader { tmp.file };
+	EXPECT_EQ(reader.readByte(), 0x81);
+	for (const uint32_t value : { 0U, 1U, 127U, 128U, 300U, 16384U, std::numeric_limits<uint32_t>::max() })
+		EXPECT_EQ(reader.readVarint(), value);
+	for (const int32_t value : { 0, 1, -1, 63, -64, 64, -65, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max() })
+		EXPECT_EQ(reader.readSignedVarint(), value);
+	EXPECT_TRUE(reader.atEnd());
+	EXPECT_FALSE(reader.isCorrupt());
+	EXPECT_EQ(reader.readByte(), 0);
+}
+
+TEST(DemoStream, SmallValuesTakeOneByte)
+{
+	const TmpFile tmp;
+	ASSERT_NE(tmp.file, nullptr);
+	DemoStreamWriter writer { tmp.file };
+	for (int i = 0; i < 100; i++) {
+		writer.writeVarint(127);
+		writer.writeSignedVarint(-64);
+	}
+	writer.flush();
+	// Block header, then at most a byte per value.
+	EXPECT_LE(FileSize(tmp.file), 8 + 200);
+}
+
+TEST(DemoStream, ValuesCanSpanBlocks)
+{
+	const TmpFile tmp;
+	ASSERT_NE(tmp.file, nullptr);
+	constexpr uint32_t Count = 3 * DemoStreamBlockSize;
+	{
+		DemoStreamWriter writer { tmp.file };
+		for (uint32_t i = 0; i < Count; i++)
+			writer.writeVarint(i * 7919);
+		writer.flush();
+	}
+	std::rewind(tmp.file);
+
+	DemoStreamReader reader { tmp.file };
+	for (uint32_t i = 0; i < Count; i++) {
+		ASSERT_FALSE(reader.atEnd()) << i;
+		ASSERT_EQ(reader.readVarint(), i * 7919) << i;
+	}
+	EXPECT_TRUE(reader.atEnd());
+	EXPECT_FALSE(reader.isCorrupt());
+}
+
+TEST(DemoStream, EmptyStreamIsAtEnd)
+{
+	const TmpFile tmp;
+	ASSERT_NE(tmp.file, nullptr);
+	DemoStreamReader reader { tmp.file };
+	EXPECT_TRUE(reader.atEnd());
+	EXPECT_FALSE(reader.isCorrupt());
+}
+
+TEST(DemoStream, DetectsTruncatedBlocks)
+{
+	const TmpFile tmp;
+	ASSERT_NE(tmp.file, nullptr);
+	{
+		DemoStreamWriter writer { tmp.file };
+		for (int i = 0; i < 1000; i++)
+			writer.writeVarint(i);
+		writer.flush();
+	}
+	const long size = FileSize(tmp.file);
+
+	// Copy all but the last byte into a second file.
+	const TmpFile truncated;
+	ASSERT_NE(truncated.file, nullptr);
+	for (long i = 0; i + 1 < size; i++)
+		std::fputc(std::fgetc(tmp.file), truncated.file);
+	std::rewind(truncated.file);
+
+	DemoStreamReader reader { truncated.file };
+	EXPECT_TRUE(reader.atEnd());
+	EXPECT_TRUE(reader.isCorrupt());
+}
+
+} // namespace
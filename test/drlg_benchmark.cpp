@@ -0,0 +1,57 @@
+#include <cstdint>
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "engine/assets.hpp"
+#include "levels/gendung.h"
+#include "multi.h"
+#include "player.h"
+#include "quests.h"
+#include "utils/paths.h"
+
+namespace devilution {
+namespace {
+
+void InitOnce()
+{
+	[[maybe_unused]] static const bool GlobalInitDone = []() {
+		// The set pieces are loaded from the level fixtures
+		paths::SetPrefPath(paths::BasePath() + "test/fixtures/");
+		Players.resize(1);
+		MyPlayer = &Players[0];
+		MyPlayer->pOriginalCathedral = true;
+		sgGameInitInfo.fullQuests = 1;
+		gbIsMultiplayer = false;
+		LoadCoreArchives();
+		LoadQuestData();
+		LoadModArchives({});
+		InitQuests();
+		pMegaTiles = std::make_unique<MegaTile[]>(MAXTILES);
+		return true;
+	}();
+}
+
+/**
+ * @brief Generates a level with a new seed on every iteration, the first level of each tileset is given as the argument.
+ *
+ * As the seeds differ, this also finds seeds that the generators fail on.
+ */
+void BM_CreateDungeon(benchmark::State &state)
+{
+	InitOnce();
+	currlevel = static_cast<uint8_t>(state.range(0));
+	leveltype = GetLevelType(currlevel);
+	uint32_t seed = 1;
+	for (auto _ : state) {
+		CreateDungeon(seed++, ENTRY_MAIN);
+		benchmark::DoNotOptimize(dungeon);
+	}
+	state.counters["levels"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+
+// Cathedral, catacombs, caves and hell
+BENCHMARK(BM_CreateDungeon)->Arg(1)->Arg(5)->Arg(9)->Arg(13)->Iterations(2000);
+
+} // namespace
+} // namespace devilution
@@ -1,6 +1,10 @@
+#include <array>
+#include <cstring>
+
 #include <gtest/gtest.h>
 
 #include "drlg_test.hpp"
+#include "engine/random.hpp"
 
 using namespace devilution;
 
@@ -249,4 +253,77 @@ TEST(Drlg_l1, CreateL5Dungeon_crypt_4_1324803725)
 	EXPECT_EQ(ViewPosition, Point(79, 47));
 }
 
+/** @brief The parts of a generated level that CreateDungeonCached has to restore. */
+struct GeneratedLevel {
+	uint8_t dungeon[DMAXX][DMAXY];
+	uint16_t dPiece[MAXDUNX][MAXDUNY];
+	int8_t dTransVal[MAXDUNX][MAXDUNY];
+	DungeonFlag dFlags[MAXDUNX][MAXDUNY];
+	std::array<Point, MAXQUESTS> questPositions;
+	Point viewPosition;
+
+	static std::unique_ptr<GeneratedLevel> Capture()
+	{
+		auto level = std::make_unique<GeneratedLevel>();
+		memcpy(level->dungeon, ::devilution::dungeon, sizeof(level->dungeon));
+		memcpy(level->dPiece, ::devilution::dPiece, sizeof(level->dPiece));
+		memcpy(level->dTransVal, ::devilution::dTransVal, sizeof(level->dTransVal));
+		memcpy(level->dFlags, ::devilution::dFlags, sizeof(level->dFlags));
+		for (size_t i = 0; i < MAXQUESTS; i++)
+			level->questPositions[i] = Quests[i].position;
+		level->viewPosition = ViewPosition;
+		return level;
+	}
+
+	void ExpectEqualToCurrent() const
+	{
+		for (int x = 0; x < DMAXX; x++) {
+			for (int y = 0; y < DMAXY; y++)
+				ASSERT_EQ(dungeon[x][y], ::devilution::dungeon[x][y]) << "Tiles don't match at " << x << "x" << y;
+		}
+		for (int x = 0; x < MAXDUNX; x++) {
+			for (int y = 0; y < MAXDUNY; y++) {
+				ASSERT_EQ(dPiece[x][y], ::devilution::dPiece[x][y]) << "Pieces don't match at " << x << "x" << y;
+				ASSERT_EQ(dTransVal[x][y], ::devilution::dTransVal[x][y]) << "Room/region indexes don't match at " << x << "x" << y;
+				ASSERT_EQ(dFlags[x][y], ::devilution::dFlags[x][y]) << "Flags don't match at " << x << "x" << y;
+			}
+		}
+		for (size_t i = 0; i < MAXQUESTS; i++)
+			EXPECT_EQ(questPositions[i], Quests[i].position) << "Quest " << i << " is at another position";
+		EXPECT_EQ(viewPosition, ViewPosition);
+	}
+};
+
+TEST(Drlg_l1, CreateDungeonCached_RestoresLevelAndRngState)
+{
+	LoadExpectedLevelData("diablo/1-2588.dun");
+
+	TestInitGame();
+	ClearDungeonCache();
+
+	currlevel = 1;
+	leveltype = GetLevelType(currlevel);
+	pMegaTiles = std::make_unique<MegaTile[]>(GetTileCount(leveltype));
+
+	// What generating the level without the cache yields
+	CreateDungeon(2588, ENTRY_MAIN);
+	const std::unique_ptr<GeneratedLevel> generated = GeneratedLevel::Capture();
+
+	CreateDungeonCached(2588, ENTRY_MAIN);
+	const uint32_t rngState = GetLCGEngineState();
+	const int paletteIndex = RandomIntBetween(1, 4);
+	generated->ExpectEqualToCurrent();
+
+	CreateDungeonCached(743271966, ENTRY_MAIN);
+	EXPECT_NE(GetLCGEngineState(), rngState);
+
+	// Coming back is served from the cache, the palette must still be rolled from the same state
+	CreateDungeonCached(2588, ENTRY_MAIN);
+	EXPECT_EQ(GetLCGEngineState(), rngState);
+	EXPECT_EQ(RandomIntBetween(1, 4), paletteIndex);
+	generated->ExpectEqualToCurrent();
+
+	ClearDungeonCache();
+}
+
 } // namespace
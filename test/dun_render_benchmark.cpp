@@ -11,6 +11,7 @@
 #include "engine/displacement.hpp"
 #include "engine/lighting_defs.hpp"
 #include "engine/load_file.hpp"
+#include "engine/render/blit_kernels.hpp"
 #include "engine/render/dun_render.hpp"
 #include "engine/surface.hpp"
 #include "levels/dun_tile.hpp"
@@ -89,11 +90,17 @@ const uint8_t *FullyLit() { return LightTables[0].data(); }
 const uint8_t *FullyDark() { return LightTables.back().data(); }
 const uint8_t *PartiallyLit() { return LightTables[5].data(); }
 
-template <TileType TileT, MaskType MaskT, GetLightTableFn GetLightTableFnT>
+template <TileType TileT, MaskType MaskT, GetLightTableFn GetLightTableFnT, BlitIsa IsaT>
 void Render(benchmark::State &state)
 {
 	InitOnce();
+	const BlitIsa prevIsa = GetBlitIsa();
+	if (!SetBlitIsa(IsaT)) {
+		state.SkipWithError("ISA not supported on this CPU");
+		return;
+	}
 	RunForTileMaskLight(state, TileT, MaskT, GetLightTableFnT());
+	SetBlitIsa(prevIsa);
 }
 
 // Define aliases in order to have shorter benchmark names.
@@ -105,11 +112,19 @@ constexpr auto LeftTrapezoid = TileType::LeftTrapezoid;
 constexpr auto RightTrapezoid = TileType::RightTrapezoid;
 constexpr auto Transparent = MaskType::Transparent;
 constexpr auto Solid = MaskType::Solid;
-
-#define DEFINE_FOR_TILE_AND_MASK_TYPE(TILE_TYPE, MASK_TYPE)      \
-	BENCHMARK_TEMPLATE(Render, TILE_TYPE, MASK_TYPE, FullyLit);  \
-	BENCHMARK_TEMPLATE(Render, TILE_TYPE, MASK_TYPE, FullyDark); \
-	BENCHMARK_TEMPLATE(Render, TILE_TYPE, MASK_TYPE, PartiallyLit);
+constexpr auto Scalar = BlitIsa::Scalar;
+constexpr auto AVX2 = BlitIsa::AVX2;
+constexpr auto NEON = BlitIsa::NEON;
+
+#define DEFINE_FOR_TILE_MASK_AND_ISA(TILE_TYPE, MASK_TYPE, ISA)       \
+	BENCHMARK_TEMPLATE(Render, TILE_TYPE, MASK_TYPE, FullyLit, ISA);  \
+	BENCHMARK_TEMPLATE(Render, TILE_TYPE, MASK_TYPE, FullyDark, ISA); \
+	BENCHMARK_TEMPLATE(Render, TILE_TYPE, MASK_TYPE, PartiallyLit, ISA);
+
+#define DEFINE_FOR_TILE_AND_MASK_TYPE(TILE_TYPE, MASK_TYPE)        \
+	DEFINE_FOR_TILE_MASK_AND_ISA(TILE_TYPE, MASK_TYPE, Scalar) \
+	DEFINE_FOR_TILE_MASK_AND_ISA(TILE_TYPE, MASK_TYPE, AVX2)   \
+	DEFINE_FOR_TILE_MASK_AND_ISA(TILE_TYPE, MASK_TYPE, NEON)
 
 #define DEFINE_FOR_TILE_TYPE(TILE_TYPE)             \
 	DEFINE_FOR_TILE_AND_MASK_TYPE(TILE_TYPE, Solid) \
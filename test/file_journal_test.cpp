@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "utils/file_journal.hpp"
+#include "utils/file_util.h"
+
+using namespace devilution;
+
+namespace {
+
+std::string GetTmpPathName()
+{
+	const auto *currentTest = ::testing::UnitTest::GetInstance()->current_test_info();
+	std::string result = "Test_";
+	result.append(currentTest->test_case_name());
+	result += '_';
+	result.append(currentTest->name());
+	result.append(".journal");
+	RemoveFile(result.c_str());
+	return result;
+}
+
+void Write(FileJournal &journal, std::string_view name, std::string_view contents)
+{
+	ASSERT_TRUE(journal.WriteFile(name, reinterpret_cast<const std::byte *>(contents.data()), contents.size()));
+}
+
+std::string Read(FileJournal &journal, std::string_view name)
+{
+	size_t size = 0;
+	const std::unique_ptr<std::byte[]> data = journal.ReadFile(name, size);
+	if (data == nullptr)
+		return "<missing>";
+	return std::string(reinterpret_cast<const char *>(data.get()), size);
+}
+
+TEST(FileJournal, ReadsBackCheckpointedChanges)
+{
+	const std::string path = GetTmpPathName();
+	{
+		FileJournal journal { path };
+		ASSERT_TRUE(journal.OpenForWriting());
+		Write(journal, "hero", "first");
+		Write(journal, "game", "state");
+		Write(journal, "hero", "second");
+		journal.RenameFile("game", "perm");
+		Write(journal, "temp", "level");
+		journal.RemoveFile("temp");
+		EXPECT_EQ(Read(journal, "hero"), "second");
+	}
+
+	FileJournal journal { path };
+	ASSERT_TRUE(journal.OpenForReading());
+	EXPECT_EQ(Read(journal, "hero"), "second");
+	EXPECT_EQ(Read(journal, "perm"), "state");
+	EXPECT_FALSE(journal.HasFile("game"));
+	EXPECT_FALSE(journal.HasFile("temp"));
+}
+
+TEST(FileJournal, IgnoresChangesAfterLastCheckpoint)
+{
+	const std::string path = GetTmpPathName();
+	{
+		FileJournal journal { path };
+		ASSERT_TRUE(journal.OpenForWriting());
+		Write(journal, "hero", "saved");
+		ASSERT_TRUE(journal.Checkpoint());
+	}
+	std::uintmax_t checkpointedSize;
+	ASSERT_TRUE(GetFileSize(path.c_str(), &checkpointedSize));
+	{
+		FileJournal journal { path };
+		ASSERT_TRUE(journal.OpenForWriting());
+		Write(journal, "hero", "interrupted");
+		ASSERT_TRUE(journal.Checkpoint());
+	}
+	// Cut off the checkpoint of the second write, as if the game had been closed while saving
+	std::uintmax_t size;
+	ASSERT_TRUE(GetFileSize(path.c_str(), &size));
+	ASSERT_TRUE(ResizeFile(path.c_str(), size - 1));
+
+	{
+		FileJournal journal { path };
+		ASSERT_TRUE(journal.OpenForReading());
+		EXPECT_EQ(Read(journal, "hero"), "saved");
+	}
+	{
+		// Writing again continues after the last checkpoint
+		FileJournal journal { path };
+		ASSERT_TRUE(journal.OpenForWriting());
+		EXPECT_EQ(Read(journal, "hero"), "saved");
+		Write(journal, "game", "new");
+	}
+	ASSERT_TRUE(GetFileSize(path.c_str(), &size));
+	EXPECT_GT(size, checkpointedSize);
+
+	FileJournal journal { path };
+	ASSERT_TRUE(journal.OpenForReading());
+	EXPECT_EQ(Read(journal, "hero"), "saved");
+	EXPECT_EQ(Read(journal, "game"), "new");
+}
+
+TEST(FileJournal, CompactsReplacedFiles)
+{
+	const std::string path = GetTmpPathName();
+	const std::string level(64 * 1024, 'x');
+	for (int i = 0; i < 20; i++) {
+		FileJournal journal { path };
+		ASSERT_TRUE(journal.OpenForWriting());
+		Write(journal, "level", level);
+		Write(journal, "hero", std::to_string(i));
+	}
+
+	std::uintmax_t size;
+	ASSERT_TRUE(GetFileSize(path.c_str(), &size));
+	EXPECT_LT(size, 20 * level.size());
+
+	FileJournal journal { path };
+	ASSERT_TRUE(journal.OpenForWriting());
+	EXPECT_LT(journal.DeadBytes(), 10 * level.size());
+	EXPECT_EQ(Read(journal, "level"), level);
+	EXPECT_EQ(Read(journal, "hero"), "19");
+}
+
+TEST(FileJournal, KeepsJournalWhenCompactionCannotReplaceIt)
+{
+	const std::string path = GetTmpPathName();
+	const std::string level(64 * 1024, 'x');
+	const auto failReplace = [](const char *, const char *) { return false; };
+	for (int i = 0; i < 20; i++) {
+		FileJournal journal { path, failReplace };
+		ASSERT_TRUE(journal.OpenForWriting());
+		EXPECT_EQ(Read(journal, "hero"), i == 0 ? "<missing>" : std::to_string(i - 1));
+		Write(journal, "level", level);
+		Write(journal, "hero", std::to_string(i));
+	}
+
+	std::uintmax_t size;
+	ASSERT_TRUE(GetFileSize(path.c_str(), &size));
+	EXPECT_GE(size, 20 * level.size());
+	EXPECT_FALSE(FileExists(path + ".tmp"));
+
+	FileJournal journal { path };
+	ASSERT_TRUE(journal.OpenForWriting());
+	EXPECT_LT(journal.DeadBytes(), 10 * level.size());
+	EXPECT_EQ(Read(journal, "level"), level);
+	EXPECT_EQ(Read(journal, "hero"), "19");
+}
+
+TEST(FileJournal, MissingJournal)
+{
+	const std::string path = GetTmpPathName();
+	FileJournal journal { path };
+	EXPECT_FALSE(journal.OpenForReading());
+	EXPECT_FALSE(journal.HasFile("hero"));
+	EXPECT_EQ(Read(journal, "hero"), "<missing>");
+}
+
+} // namespace
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "dvlnet/frame_queue.h"
+
+using namespace devilution::net;
+
+namespace {
+
+buffer_t MakePayload(size_t size, unsigned char seed)
+{
+	buffer_t payload(size);
+	for (size_t i = 0; i < size; i++)
+		payload[i] = static_cast<unsigned char>(seed + i);
+	return payload;
+}
+
+buffer_t ReadFrame(frame_queue &queue)
+{
+	tl::expected<bool, PacketError> ready = queue.PacketReady();
+	EXPECT_TRUE(ready.has_value() && *ready);
+	tl::expected<buffer_t, PacketError> packet = queue.ReadPacket();
+	EXPECT_TRUE(packet.has_value());
+	return packet.value_or(buffer_t {});
+}
+
+TEST(FrameQueue, ReassemblesSplitFrames)
+{
+	const buffer_t payload = MakePayload(100, 1);
+	const buffer_t frame = *frame_queue::MakeFrame(payload, 0x1234);
+
+	frame_queue queue;
+	queue.Write({ frame.data(), 3 });
+	EXPECT_EQ(queue.PacketReady(), false);
+	queue.Write({ frame.data() + 3, 50 });
+	EXPECT_EQ(queue.PacketReady(), false);
+	EXPECT_EQ(queue.ReadPacketFlags(), 0x1234);
+	queue.Write({ frame.data() + 53, frame.size() - 53 });
+	EXPECT_EQ(ReadFrame(queue), payload);
+	EXPECT_EQ(queue.PacketReady(), false);
+}
+
+TEST(FrameQueue, ReadsFramesAcrossTheWrapPoint)
+{
+	frame_queue queue;
+	// Keep part of a frame queued, so the head moves through the ring and the frames wrap around its end.
+	const buffer_t first = *frame_queue::MakeFrame(MakePayload(1000, 0));
+	queue.Write({ first.data(), 10 });
+	buffer_t pending(first.begin() + 10, first.end());
+	for (unsigned char i = 1; i < 20; i++) {
+		const buffer_t payload = MakePayload(1500 + i * 37, i);
+		const buffer_t frame = *frame_queue::MakeFrame(payload);
+		queue.Write(pending);
+		queue.Write({ frame.data(), 10 });
+		pending.assign(frame.begin() + 10, frame.end());
+		EXPECT_EQ(ReadFrame(queue), MakePayload(i == 1 ? 1000 : 1500 + (i - 1) * 37, i - 1));
+	}
+}
+
+TEST(FrameQueue, GrowsForLargeBursts)
+{
+	std::vector<buffer_t> payloads;
+	buffer_t stream;
+	for (unsigned char i = 0; i < 8; i++) {
+		payloads.push_back(MakePayload(frame_queue::max_frame_size, i));
+		const buffer_t frame = *frame_queue::MakeFrame(payloads.back());
+		stream.insert(stream.end(), frame.begin(), frame.end());
+	}
+
+	frame_queue queue;
+	queue.Write(stream);
+	for (const buffer_t &payload : payloads)
+		EXPECT_EQ(ReadFrame(queue), payload);
+	EXPECT_EQ(queue.PacketReady(), false);
+}
+
+TEST(FrameQueue, RejectsEmptyFrames)
+{
+	const unsigned char header[4] = {};
+	frame_queue queue;
+	queue.Write(header);
+	EXPECT_FALSE(queue.PacketReady().has_value());
+}
+
+} // namespace
@@ -1,9 +1,13 @@
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdio>
+#include <cstring>
+#include <string>
 
 #include <benchmark/benchmark.h>
 
+#include "engine/displacement.hpp"
 #include "engine/lighting_defs.hpp"
 #include "engine/render/light_render.hpp"
 #include "engine/surface.hpp"
@@ -15,52 +19,112 @@
 namespace devilution {
 namespace {
 
-void BM_BuildLightmap(benchmark::State &state)
-{
-	const std::string benchmarkDataPath = paths::BasePath() + "test/fixtures/light_render_benchmark/dLight.dmp";
-	FILE *lightFile = std::fopen(benchmarkDataPath.c_str(), "rb");
+struct LightmapBenchmarkData {
 	uint8_t dLight[MAXDUNX][MAXDUNY];
 	std::array<std::array<uint8_t, LightTableSize>, NumLightingLevels> lightTables;
-	if (lightFile != nullptr) {
-		if (std::fread(&dLight[0][0], sizeof(uint8_t) * MAXDUNX * MAXDUNY, 1, lightFile) != 1) {
-			std::perror("Failed to read dLight.dmp");
-			exit(1);
+	SDLSurfaceUniquePtr sdlSurface;
+
+	LightmapBenchmarkData()
+	{
+		const std::string benchmarkDataPath = paths::BasePath() + "test/fixtures/light_render_benchmark/dLight.dmp";
+		FILE *lightFile = std::fopen(benchmarkDataPath.c_str(), "rb");
+		if (lightFile != nullptr) {
+			if (std::fread(&dLight[0][0], sizeof(uint8_t) * MAXDUNX * MAXDUNY, 1, lightFile) != 1) {
+				std::perror("Failed to read dLight.dmp");
+				exit(1);
+			}
+			std::fclose(lightFile);
 		}
-		std::fclose(lightFile);
-	}
 
-	const SDLSurfaceUniquePtr sdl_surface = SDLWrap::CreateRGBSurfaceWithFormat(
-	    /*flags=*/0, /*width=*/640, /*height=*/480, /*depth=*/8, SDL_PIXELFORMAT_INDEX8);
-	if (sdl_surface == nullptr) {
-		std::fprintf(stderr, "Failed to create SDL Surface: %s\n", SDL_GetError());
-		exit(1);
+		sdlSurface = SDLWrap::CreateRGBSurfaceWithFormat(
+		    /*flags=*/0, /*width=*/640, /*height=*/480, /*depth=*/8, SDL_PIXELFORMAT_INDEX8);
+		if (sdlSurface == nullptr) {
+			std::fprintf(stderr, "Failed to create SDL Surface: %s\n", SDL_GetError());
+			exit(1);
+		}
 	}
-	const Surface out = Surface(sdl_surface.get());
-
-	const Point tilePosition { 48, 44 };
-	const Point targetBufferPosition { 0, -17 };
-	const int viewportWidth = 640;
-	const int viewportHeight = 352;
-	const int rows = 25;
-	const int columns = 10;
-	const uint8_t *outBuffer = out.at(0, 0);
-	const uint16_t outPitch = out.pitch();
 
-	for (auto _ : state) {
+	uint8_t build(Point tilePosition, Point targetBufferPosition)
+	{
+		const Surface out = Surface(sdlSurface.get());
+		const uint8_t *outBuffer = out.at(0, 0);
+		const uint16_t outPitch = out.pitch();
 		const Lightmap lightmap = Lightmap::build(/*perPixelLighting=*/true,
 		    tilePosition, targetBufferPosition,
-		    viewportWidth, viewportHeight, rows, columns,
+		    ViewportWidth, ViewportHeight, Rows, Columns,
 		    outBuffer, outPitch, lightTables, lightTables[0].data(), lightTables.back().data(),
 		    dLight, /*microTileLen=*/10);
+		return *lightmap.getLightingAt(outBuffer + outPitch * 120 + 120);
+	}
+
+	static constexpr int ViewportWidth = 640;
+	static constexpr int ViewportHeight = 352;
+	static constexpr int Rows = 25;
+	static constexpr int Columns = 10;
+};
+
+constexpr Point BenchmarkTilePosition { 48, 44 };
+constexpr Point BenchmarkTargetBufferPosition { 0, -17 };
 
-		uint8_t lightLevel = *lightmap.getLightingAt(outBuffer + outPitch * 120 + 120);
+void SetLightmapCounters(benchmark::State &state)
+{
+	state.SetBytesProcessed(state.iterations() * LightmapBenchmarkData::ViewportWidth * LightmapBenchmarkData::ViewportHeight);
+	state.SetItemsProcessed(state.iterations() * LightmapBenchmarkData::Rows * LightmapBenchmarkData::Columns);
+}
+
+/** @brief Nothing changes between frames. */
+void BM_BuildLightmap(benchmark::State &state)
+{
+	LightmapBenchmarkData data;
+	for (auto _ : state) {
+		uint8_t lightLevel = data.build(BenchmarkTilePosition, BenchmarkTargetBufferPosition);
+		benchmark::DoNotOptimize(lightLevel);
+	}
+	SetLightmapCounters(state);
+}
+
+/** @brief The view scrolls a few pixels every frame, as when the player is walking. */
+void BM_BuildLightmapWalk(benchmark::State &state)
+{
+	LightmapBenchmarkData data;
+	int frame = 0;
+	for (auto _ : state) {
+		const int step = frame % 16;
+		const int tiles = (frame / 16) % 4;
+		const Point tilePosition = BenchmarkTilePosition + Displacement { tiles, -tiles };
+		const Point targetBufferPosition = BenchmarkTargetBufferPosition + Displacement { -step * 4, 0 };
+		uint8_t lightLevel = data.build(tilePosition, targetBufferPosition);
+		benchmark::DoNotOptimize(lightLevel);
+		frame++;
+	}
+	SetLightmapCounters(state);
+}
+
+/** @brief Light levels flicker all over the view every frame. */
+void BM_BuildLightmapManyLights(benchmark::State &state)
+{
+	LightmapBenchmarkData data;
+	uint8_t original[MAXDUNX][MAXDUNY];
+	memcpy(original, data.dLight, sizeof(original));
+	const int numLights = static_cast<int>(state.range(0));
+	int frame = 0;
+	for (auto _ : state) {
+		for (int i = 0; i < numLights; i++) {
+			const int x = BenchmarkTilePosition.x - 12 + (i * 7) % 24;
+			const int y = BenchmarkTilePosition.y - 6 + (i * 11) % 24;
+			const uint8_t light = original[x][y];
+			data.dLight[x][y] = ((frame + i) & 1) != 0 ? light : std::max(light - 2, 0);
+		}
+		uint8_t lightLevel = data.build(BenchmarkTilePosition, BenchmarkTargetBufferPosition);
 		benchmark::DoNotOptimize(lightLevel);
+		frame++;
 	}
-	state.SetBytesProcessed(state.iterations() * viewportWidth * viewportHeight);
-	state.SetItemsProcessed(state.iterations() * rows * columns);
+	SetLightmapCounters(state);
 }
 
 BENCHMARK(BM_BuildLightmap);
+BENCHMARK(BM_BuildLightmapWalk);
+BENCHMARK(BM_BuildLightmapManyLights)->Arg(4)->Arg(16)->Arg(64);
 
 } // namespace
 } // namespace devilution
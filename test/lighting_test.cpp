@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "levels/gendung.h"
+#include "lighting.h"
+
+namespace devilution {
+namespace {
+
+/** @brief What `dLight` has to hold after `ProcessLightList`: every active light applied to `dPreLight`. */
+void RelightAll(uint8_t (&expected)[MAXDUNX][MAXDUNY])
+{
+	uint8_t incremental[MAXDUNX][MAXDUNY];
+	memcpy(incremental, dLight, sizeof(incremental));
+
+	memcpy(dLight, dPreLight, sizeof(dLight));
+	for (int i = 0; i < ActiveLightCount; i++) {
+		const Light &light = Lights[ActiveLights[i]];
+		if (!TileHasAny(light.position.tile, TileProperties::Solid))
+			DoLighting(light.position.tile, light.radius, light.position.offset);
+	}
+	memcpy(expected, dLight, sizeof(expected));
+
+	memcpy(dLight, incremental, sizeof(dLight));
+}
+
+class LightingTest : public ::testing::TestWithParam<dungeon_type> {
+protected:
+	void SetUp() override
+	{
+		leveltype = GetParam();
+		MakeLightTable();
+		InitLighting();
+
+		std::mt19937 rng(GetParam());
+		std::uniform_int_distribution<int> preLight(0, LightsMax);
+		std::uniform_int_distribution<int> solid(0, 9);
+		SOLData[0] = TileProperties::None;
+		SOLData[1] = TileProperties::Solid;
+		for (int x = 0; x < MAXDUNX; x++) {
+			for (int y = 0; y < MAXDUNY; y++) {
+				dPreLight[x][y] = static_cast<uint8_t>(preLight(rng));
+				dPiece[x][y] = solid(rng) == 0 ? 1 : 0;
+			}
+		}
+		memcpy(dLight, dPreLight, sizeof(dLight));
+	}
+};
+
+TEST_P(LightingTest, IncrementalUpdatesMatchFullRelight)
+{
+	std::mt19937 rng(1234);
+	// Keep a tile of margin, lights with a negative offset are drawn from the tile before
+	std::uniform_int_distribution<int> coordinate(1, MAXDUNX - 2);
+	std::uniform_int_distribution<int> nearby(-3, 3);
+	std::uniform_int_distribution<int> radius(1, 15);
+	std::uniform_int_distribution<int> offset(-7, 7);
+	std::uniform_int_distribution<int> action(0, 5);
+
+	const auto randomPosition = [&]() { return Point { coordinate(rng), coordinate(rng) }; };
+	const auto clampPosition = [](Point position) {
+		return Point { std::clamp(position.x, 1, MAXDUNX - 2), std::clamp(position.y, 1, MAXDUNY - 2) };
+	};
+
+	std::vector<int> lights;
+	uint8_t expected[MAXDUNX][MAXDUNY];
+	for (int step = 0; step < 500; step++) {
+		// Several changes between updates, like a game tick with many moving monsters and missiles.
+		// A light only changes once per update, a second change would forget the position that has to be unlit.
+		std::vector<int> changed;
+		const int changes = std::uniform_int_distribution<int>(1, 4)(rng);
+		for (int change = 0; change < changes; change++) {
+			const int act = lights.empty() ? 0 : action(rng);
+			const size_t index = lights.empty() ? 0 : std::uniform_int_distribution<size_t>(0, lights.size() - 1)(rng);
+			if (act != 0) {
+				if (std::find(changed.begin(), changed.end(), lights[index]) != changed.end())
+					continue;
+				changed.push_back(lights[index]);
+			}
+			switch (act) {
+			case 0: {
+				const int lid = AddLight(randomPosition(), static_cast<uint8_t>(radius(rng)));
+				if (lid != NO_LIGHT)
+					lights.push_back(lid);
+			} break;
+			case 1:
+				AddUnLight(lights[index]);
+				lights.erase(lights.begin() + index);
+				break;
+			case 2: {
+				// Walking lights move a tile at a time
+				const Point position = Lights[lights[index]].position.tile;
+				ChangeLightXY(lights[index], clampPosition(position + Displacement { nearby(rng), nearby(rng) }));
+			} break;
+			case 3:
+				ChangeLightRadius(lights[index], static_cast<uint8_t>(radius(rng)));
+				break;
+			case 4:
+				ChangeLightOffset(lights[index], { static_cast<int8_t>(offset(rng)), static_cast<int8_t>(offset(rng)) });
+				break;
+			case 5:
+				ChangeLight(lights[index], randomPosition(), static_cast<uint8_t>(radius(rng)));
+				break;
+			}
+		}
+
+		ProcessLightList();
+		ASSERT_EQ(ActiveLightCount, static_cast<int>(lights.size()));
+
+		RelightAll(expected);
+		for (int x = 0; x < MAXDUNX; x++) {
+			for (int y = 0; y < MAXDUNY; y++)
+				ASSERT_EQ(dLight[x][y], expected[x][y]) << "Light doesn't match at " << x << "x" << y << " after step " << step;
+		}
+	}
+}
+
+INSTANTIATE_TEST_SUITE_P(LevelTypes, LightingTest, ::testing::Values(DTYPE_CATHEDRAL, DTYPE_CRYPT));
+
+} // namespace
+} // namespace devilution
@@ -0,0 +1,204 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "automap.h"
+#include "codec.h"
+#include "game_mode.hpp"
+#include "levels/gendung.h"
+#include "lighting.h"
+#include "loadsave.h"
+#include "menu.h"
+#include "monster.h"
+#include "objects.h"
+#include "pfile.h"
+#include "player.h"
+#include "utils/endian_read.hpp"
+#include "utils/paths.h"
+
+using namespace devilution;
+
+namespace {
+
+std::string GetTestSavePath()
+{
+#ifdef UNPACKED_SAVES
+	return paths::PrefPath() + "single_0_sv" DIRECTORY_SEPARATOR_STR;
+#else
+	return paths::PrefPath() + "single_0.sv";
+#endif
+}
+
+void ClearLevelLayers()
+{
+	memset(dCorpse, 0, sizeof(dCorpse));
+	memset(dFlags, 0, sizeof(dFlags));
+	memset(dMonster, 0, sizeof(dMonster));
+	memset(dObject, 0, sizeof(dObject));
+	memset(dPreLight, 0, sizeof(dPreLight));
+	memset(AutomapView, 0, sizeof(AutomapView));
+}
+
+void InitEmptyLevel()
+{
+	paths::SetPrefPath(paths::BasePath());
+	gbIsSpawn = false;
+	gbIsHellfire = false;
+	gbIsMultiplayer = false;
+	giNumberOfLevels = 17;
+	gSaveNumber = 0;
+
+	Players.resize(1);
+	MyPlayerId = 0;
+	MyPlayer = &Players[MyPlayerId];
+	*MyPlayer = {};
+
+	setlevel = false;
+	currlevel = 1;
+	leveltype = DTYPE_CATHEDRAL;
+	ActiveMonsterCount = 0;
+	ActiveItemCount = 0;
+	ActiveObjectCount = 0;
+	ClearLevelLayers();
+	ForgetSavedLevelHashes();
+}
+
+void SetTestLayers()
+{
+	dCorpse[20][30] = 3;
+	dFlags[40][41] = DungeonFlag::Explored | DungeonFlag::Lit;
+	dMonster[50][51] = 7;
+	dObject[60][61] = 2;
+	dPreLight[70][71] = 5;
+	AutomapView[10][12] = MAP_EXP_SELF;
+}
+
+void ExpectTestLayers()
+{
+	EXPECT_EQ(dCorpse[20][30], 3);
+	EXPECT_EQ(dFlags[40][41], DungeonFlag::Explored | DungeonFlag::Lit);
+	EXPECT_EQ(dFlags[41][40], DungeonFlag::None);
+	EXPECT_EQ(dMonster[50][51], 7);
+	EXPECT_EQ(dObject[60][61], 2);
+	EXPECT_EQ(dPreLight[70][71], 5);
+	EXPECT_EQ(AutomapView[10][12], MAP_EXP_SELF);
+	EXPECT_EQ(AutomapView[12][10], MAP_EXP_NONE);
+}
+
+/**
+ * @brief Writes a level file of the vanilla format, as an older build would have saved it.
+ */
+void WriteVanillaLevel(const char *name, const std::vector<std::byte> &contents)
+{
+	const size_t encodedLen = codec_get_encoded_len(contents.size());
+	const std::unique_ptr<std::byte[]> encoded { new std::byte[encodedLen] };
+	memcpy(encoded.get(), contents.data(), contents.size());
+	codec_encode(encoded.get(), contents.size(), encodedLen, pfile_get_password());
+
+	SaveWriter saveWriter(GetTestSavePath(), /*carryForward=*/false);
+	saveWriter.WriteFile(name, encoded.get(), encodedLen);
+}
+
+template <typename T, size_t Width, size_t Height>
+void AppendLayer(std::vector<std::byte> &out, const T (&layer)[Width][Height])
+{
+	for (size_t j = 0; j < Height; j++) {
+		for (size_t i = 0; i < Width; i++)
+			out.push_back(static_cast<std::byte>(layer[i][j]));
+	}
+}
+
+void AppendBE32(std::vector<std::byte> &out, uint32_t value)
+{
+	for (int shift = 24; shift >= 0; shift -= 8)
+		out.push_back(static_cast<std::byte>(value >> shift));
+}
+
+TEST(LoadSave, LevelRoundTrip)
+{
+	InitEmptyLevel();
+	SetTestLayers();
+	{
+		SaveWriter saveWriter(GetTestSavePath(), /*carryForward=*/false);
+		SaveLevel(saveWriter);
+	}
+
+	{
+		std::optional<SaveReader> archive = OpenSaveArchive(gSaveNumber);
+		ASSERT_TRUE(archive);
+		size_t size = 0;
+		const std::unique_ptr<std::byte[]> level = ReadArchive(*archive, "templ01", &size);
+		ASSERT_GE(size, 4U);
+		EXPECT_EQ(LoadLE32(level.get()), LoadLE32("DLVL"));
+	}
+
+	// Read the level back from the save rather than from memory
+	ForgetSavedLevelHashes();
+	ClearLevelLayers();
+	ASSERT_TRUE(LoadLevel().has_value());
+
+	ExpectTestLayers();
+}
+
+TEST(LoadSave, LoadVanillaLevel)
+{
+	InitEmptyLevel();
+	SetTestLayers();
+	dLight[80][81] = 4;
+
+	std::vector<std::byte> contents;
+	AppendLayer(contents, dCorpse);
+	AppendBE32(contents, 0); // ActiveMonsterCount
+	AppendBE32(contents, 0); // ActiveItemCount
+	AppendBE32(contents, 0); // ActiveObjectCount
+	for (size_t i = 0; i < MaxMonsters; i++)
+		AppendBE32(contents, static_cast<uint32_t>(i));
+	contents.resize(contents.size() + MAXOBJECTS * 2);
+	contents.resize(contents.size() + MAXITEMS * 2);
+	AppendLayer(contents, dFlags);
+	contents.resize(contents.size() + MAXDUNX * MAXDUNY); // dItem
+	for (int j = 0; j < MAXDUNY; j++) {
+		for (int i = 0; i < MAXDUNX; i++)
+			AppendBE32(contents, static_cast<uint32_t>(dMonster[i][j]));
+	}
+	AppendLayer(contents, dObject);
+	AppendLayer(contents, dLight);
+	AppendLayer(contents, dPreLight);
+	AppendLayer(contents, AutomapView);
+	WriteVanillaLevel("perml01", contents);
+
+	ClearLevelLayers();
+	ASSERT_TRUE(LoadLevel().has_value());
+
+	ExpectTestLayers();
+}
+
+TEST(LoadSave, HeaderVersion)
+{
+	gbIsSpawn = false;
+
+	EXPECT_TRUE(IsHeaderValid(LoadLE32("RETL")));
+	EXPECT_FALSE(gbIsHellfireSaveGame);
+	EXPECT_TRUE(IsHeaderValid(LoadLE32("HELF")));
+	EXPECT_TRUE(gbIsHellfireSaveGame);
+
+	// Saves that may have level files in the compact format
+	EXPECT_TRUE(IsHeaderValid(LoadLE32("RET1")));
+	EXPECT_FALSE(gbIsHellfireSaveGame);
+	EXPECT_TRUE(IsHeaderValid(LoadLE32("HEL1")));
+	EXPECT_TRUE(gbIsHellfireSaveGame);
+	EXPECT_TRUE(IsHeaderValid(LoadLE32("SHA1")));
+	EXPECT_TRUE(IsHeaderValid(LoadLE32("SHL1")));
+
+	// Saves of a later version are rejected
+	EXPECT_FALSE(IsHeaderValid(LoadLE32("RET2")));
+	EXPECT_FALSE(IsHeaderValid(LoadLE32("HEL9")));
+}
+
+} // namespace
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef USE_SDL3
+#include <SDL3/SDL_iostream.h>
+#else
+#include <SDL.h>
+#endif
+
+#include "mpq/mpq_reader.hpp"
+#include "mpq/mpq_sdl_rwops.hpp"
+#include "mpq/mpq_writer.hpp"
+#include "utils/paths.h"
+#include "utils/sdl_compat.h"
+
+using namespace devilution;
+
+namespace {
+
+constexpr std::string_view StreamName = "music\\readahead.wav";
+
+/** @brief Larger than the read-ahead buffer, so that streams wrap around it. */
+constexpr size_t StreamSize = 300 * 1024 + 123;
+
+class MpqReadAheadTest : public ::testing::Test {
+protected:
+	static void SetUpTestSuite()
+	{
+		Contents = new std::vector<std::byte>(StreamSize);
+		uint32_t state = 12345;
+		for (std::byte &b : *Contents) {
+			state = state * 1103515245 + 12345;
+			b = static_cast<std::byte>(state >> 24);
+		}
+
+		const std::string path = paths::PrefPath() + "mpq_read_ahead_test.mpq";
+		{
+			MpqWriter writer(path, /*carryForward=*/false);
+			writer.WriteFile(StreamName, Contents->data(), Contents->size());
+		}
+		int32_t error = 0;
+		Archive = new std::optional<MpqArchive>(MpqArchive::Open(path.c_str(), error));
+	}
+
+	static void TearDownTestSuite()
+	{
+		ShutdownMpqReadAhead();
+		delete Archive;
+		delete Contents;
+	}
+
+	static SDL_IOStream *OpenStream()
+	{
+		MpqArchive &archive = **Archive;
+		return SDL_RWops_FromMpqFileWithReadAhead(archive, archive.FindHash(StreamName), StreamName);
+	}
+
+	/** @brief Reads from the stream's position and checks the bytes, returns false on a mismatch. */
+	static bool ReadAndCompare(SDL_IOStream *stream, size_t position, size_t length)
+	{
+		std::vector<std::byte> buffer(length);
+		const size_t expected = std::min(length, StreamSize - position);
+		if (SDL_ReadIO(stream, buffer.data(), length) != expected)
+			return false;
+		return std::equal(buffer.begin(), buffer.begin() + expected, Contents->begin() + position);
+	}
+
+	static std::vector<std::byte> *Contents;
+	static std::optional<MpqArchive> *Archive;
+};
+
+std::vector<std::byte> *MpqReadAheadTest::Contents;
+std::optional<MpqArchive> *MpqReadAheadTest::Archive;
+
+TEST_F(MpqReadAheadTest, ReadsWholeStream)
+{
+	ASSERT_TRUE(Archive->has_value());
+	SDL_IOStream *stream = OpenStream();
+	ASSERT_NE(stream, nullptr);
+	size_t position = 0;
+	while (position < StreamSize) {
+		// Odd sizes, so that reads cross the chunks of the read-ahead thread
+		const size_t length = 7919;
+		EXPECT_TRUE(ReadAndCompare(stream, position, length)) << "at " << position;
+		position += length;
+	}
+	SDL_CloseIO(stream);
+}
+
+TEST_F(MpqReadAheadTest, ConcurrentReadsAndSeeks)
+{
+	ASSERT_TRUE(Archive->has_value());
+	constexpr int NumStreams = 8;
+	std::vector<SDL_IOStream *> streams;
+	for (int i = 0; i < NumStreams; i++) {
+		streams.push_back(OpenStream());
+		ASSERT_NE(streams.back(), nullptr);
+	}
+
+	std::vector<int> mismatches(NumStreams);
+	std::vector<std::thread> readers;
+	for (int i = 0; i < NumStreams; i++) {
+		readers.emplace_back([&, i]() {
+			std::mt19937 rng(i);
+			size_t position = 0;
+			for (int op = 0; op < 200; op++) {
+				if (rng() % 4 == 0) {
+					// Both short skips within the buffered data and jumps that drop it
+					position = rng() % 2 == 0 ? std::min(StreamSize, position + rng() % 4096) : rng() % StreamSize;
+					if (SDL_SeekIO(streams[i], static_cast<int64_t>(position), SDL_IO_SEEK_SET) != static_cast<int64_t>(position))
+						mismatches[i]++;
+					continue;
+				}
+				const size_t length = 1 + rng() % 40000;
+				if (!ReadAndCompare(streams[i], position, length))
+					mismatches[i]++;
+				position = std::min(StreamSize, position + length);
+			}
+		});
+	}
+	for (std::thread &reader : readers)
+		reader.join();
+	for (SDL_IOStream *stream : streams)
+		SDL_CloseIO(stream);
+
+	for (int i = 0; i < NumStreams; i++)
+		EXPECT_EQ(mismatches[i], 0) << "stream " << i;
+}
+
+TEST_F(MpqReadAheadTest, CloseWhileFetching)
+{
+	ASSERT_TRUE(Archive->has_value());
+	for (int round = 0; round < 50; round++) {
+		std::vector<SDL_IOStream *> streams;
+		for (int i = 0; i < 4; i++) {
+			SDL_IOStream *stream = OpenStream();
+			ASSERT_NE(stream, nullptr);
+			// Lets the read-ahead thread start on the stream, which is then closed while it reads
+			std::byte first;
+			EXPECT_EQ(SDL_ReadIO(stream, &first, 1), 1U);
+			streams.push_back(stream);
+		}
+		for (SDL_IOStream *stream : streams)
+			SDL_CloseIO(stream);
+	}
+}
+
+// Shuts down the read-ahead thread, so must be the last test.
+TEST_F(MpqReadAheadTest, ReadsContinueAfterShutdown)
+{
+	ASSERT_TRUE(Archive->has_value());
+	SDL_IOStream *stream = OpenStream();
+	ASSERT_NE(stream, nullptr);
+	EXPECT_TRUE(ReadAndCompare(stream, 0, StreamSize / 2));
+
+	ShutdownMpqReadAhead();
+	EXPECT_TRUE(ReadAndCompare(stream, StreamSize / 2, StreamSize));
+	SDL_CloseIO(stream);
+
+	SDL_IOStream *direct = OpenStream();
+	ASSERT_NE(direct, nullptr);
+	EXPECT_TRUE(ReadAndCompare(direct, 0, StreamSize));
+	SDL_CloseIO(direct);
+}
+
+} // namespace
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "mpq/mpq_sector_cache.hpp"
+
+using namespace devilution;
+
+namespace {
+
+std::array<std::byte, MpqSectorCacheBlockSize> MakeBlock(uint8_t seed)
+{
+	std::array<std::byte, MpqSectorCacheBlockSize> block;
+	for (size_t i = 0; i < block.size(); ++i)
+		block[i] = static_cast<std::byte>(seed + i);
+	return block;
+}
+
+MpqSectorCacheKey Key(uint32_t block, uint32_t archiveId = 0)
+{
+	return MpqSectorCacheKey { archiveId, 0x1234, 0x5678, block };
+}
+
+TEST(MpqSectorCache, ReadsBackPartsOfBlocks)
+{
+	MpqSectorCache cache { 4 };
+	const auto block = MakeBlock(3);
+	cache.insert(Key(0), block);
+
+	std::array<std::byte, 10> out;
+	ASSERT_TRUE(cache.read(Key(0), 100, out));
+	for (size_t i = 0; i < out.size(); ++i)
+		EXPECT_EQ(out[i], block[100 + i]);
+	EXPECT_FALSE(cache.read(Key(1), 0, out));
+	EXPECT_FALSE(cache.read(Key(0, /*archiveId=*/1), 0, out));
+	EXPECT_EQ(cache.stats().hits, 1U);
+	EXPECT_EQ(cache.stats().misses, 2U);
+}
+
+TEST(MpqSectorCache, DoesNotReadPastTheEndOfAShortBlock)
+{
+	MpqSectorCache cache { 4 };
+	const auto block = MakeBlock(7);
+	cache.insert(Key(0), std::span<const std::byte>(block).first(20));
+
+	std::array<std::byte, 10> out;
+	EXPECT_TRUE(cache.read(Key(0), 10, out));
+	EXPECT_FALSE(cache.read(Key(0), 11, out));
+}
+
+TEST(MpqSectorCache, EvictsTheLeastRecentlyUsedBlock)
+{
+	MpqSectorCache cache { 2 };
+	cache.insert(Key(0), MakeBlock(0));
+	cache.insert(Key(1), MakeBlock(1));
+
+	std::array<std::byte, 1> out;
+	ASSERT_TRUE(cache.read(Key(0), 0, out));
+	cache.insert(Key(2), MakeBlock(2));
+
+	EXPECT_TRUE(cache.read(Key(0), 0, out));
+	EXPECT_EQ(out[0], std::byte { 0 });
+	EXPECT_FALSE(cache.read(Key(1), 0, out));
+	EXPECT_TRUE(cache.read(Key(2), 0, out));
+	EXPECT_EQ(out[0], std::byte { 2 });
+}
+
+TEST(MpqSectorCache, DisabledWithoutBlocks)
+{
+	MpqSectorCache cache { 0 };
+	cache.insert(Key(0), MakeBlock(0));
+	std::array<std::byte, 1> out;
+	EXPECT_FALSE(cache.read(Key(0), 0, out));
+}
+
+} // namespace
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "dvlnet/packet.h"
+
+using namespace devilution::net;
+
+namespace {
+
+TEST(Packet, UnencryptedMessageRoundTrip)
+{
+	packet_factory factory;
+	const buffer_t message { 1, 2, 3, 4, 5 };
+	tl::expected<std::unique_ptr<packet>, PacketError> sent = factory.make_packet<PT_MESSAGE>(plr_t { 1 }, PLR_BROADCAST, message);
+	ASSERT_TRUE(sent.has_value());
+	const buffer_t wire = (*sent)->Data();
+
+	tl::expected<std::unique_ptr<packet>, PacketError> received = factory.make_packet(wire);
+	ASSERT_TRUE(received.has_value());
+	packet &pkt = **received;
+	EXPECT_EQ(pkt.Type(), PT_MESSAGE);
+	EXPECT_EQ(pkt.Source(), 1);
+	EXPECT_EQ(pkt.Destination(), PLR_BROADCAST);
+	tl::expected<const buffer_t *, PacketError> receivedMessage = pkt.Message();
+	ASSERT_TRUE(receivedMessage.has_value());
+	EXPECT_EQ(**receivedMessage, message);
+	// The relay server forwards the bytes it received
+	EXPECT_EQ(pkt.Data(), wire);
+}
+
+TEST(Packet, UnencryptedEchoRoundTrip)
+{
+	packet_factory factory;
+	tl::expected<std::unique_ptr<packet>, PacketError> sent = factory.make_packet<PT_ECHO_REQUEST>(plr_t { 2 }, PLR_MASTER, timestamp_t { 0x12345678 });
+	ASSERT_TRUE(sent.has_value());
+
+	tl::expected<std::unique_ptr<packet>, PacketError> received = factory.make_packet((*sent)->Data());
+	ASSERT_TRUE(received.has_value());
+	EXPECT_EQ((*received)->Type(), PT_ECHO_REQUEST);
+	EXPECT_EQ((*received)->Time(), timestamp_t { 0x12345678 });
+}
+
+TEST(Packet, TruncatedPacketsAreRejected)
+{
+	packet_factory factory;
+	tl::expected<std::unique_ptr<packet>, PacketError> sent = factory.make_packet<PT_ECHO_REQUEST>(plr_t { 2 }, PLR_MASTER, timestamp_t { 0x12345678 });
+	ASSERT_TRUE(sent.has_value());
+	buffer_t wire = (*sent)->Data();
+
+	wire.pop_back();
+	EXPECT_FALSE(factory.make_packet(wire).has_value());
+	wire.resize(2);
+	EXPECT_FALSE(factory.make_packet(wire).has_value());
+}
+
+} // namespace
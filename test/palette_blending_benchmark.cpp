@@ -71,9 +71,47 @@ void BM_FindNearestNeighbor(benchmark::State &state)
 	state.SetItemsProcessed(state.iterations() * 256 * 256 * 256);
 }
 
+void BM_FindNearestNeighbors(benchmark::State &state)
+{
+	std::array<SDL_Color, 256> palette;
+	GeneratePalette(palette.data());
+	const PaletteKdTree tree(palette.data(), -1, -1);
+
+	std::array<std::array<uint8_t, 3>, 256> colors;
+	std::array<uint8_t, 256> result;
+	for (auto _ : state) {
+		for (int r = 0; r < 256; ++r) {
+			for (int g = 0; g < 256; ++g) {
+				for (int b = 0; b < 256; ++b) {
+					colors[b] = { static_cast<uint8_t>(r), static_cast<uint8_t>(g), static_cast<uint8_t>(b) };
+				}
+				tree.findNearestNeighbors(colors, result.data());
+				benchmark::DoNotOptimize(result);
+			}
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * 256 * 256 * 256);
+}
+
+void BM_UpdateBlendedLookupTableSingleColor(benchmark::State &state)
+{
+	std::array<SDL_Color, 256> palette;
+	GeneratePalette(palette.data());
+	GenerateBlendedLookupTable(palette.data());
+	unsigned i = 0;
+	for (auto _ : state) {
+		UpdateBlendedLookupTableSingleColor(palette.data(), i);
+		i = (i + 1) % 256;
+		int result = paletteTransparencyLookup[17][98];
+		benchmark::DoNotOptimize(result);
+	}
+}
+
 BENCHMARK(BM_GenerateBlendedLookupTable);
+BENCHMARK(BM_UpdateBlendedLookupTableSingleColor);
 BENCHMARK(BM_BuildTree);
 BENCHMARK(BM_FindNearestNeighbor);
+BENCHMARK(BM_FindNearestNeighbors);
 
 } // namespace
 } // namespace devilution
@@ -2,6 +2,8 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 
 #ifdef USE_SDL3
@@ -85,5 +87,37 @@ TEST(GenerateBlendedLookupTableTest, BasicTest)
 #endif
 }
 
+TEST(CycleBlendedLookupTableTest, SameAsGeneratingForTheCycledPalette)
+{
+	std::array<SDL_Color, 256> palette;
+	GeneratePalette(palette.data());
+	GenerateBlendedLookupTable(palette.data(), /*skipFrom=*/1, /*skipTo=*/31);
+
+	for (const bool reverse : { false, true }) {
+		if (reverse)
+			std::rotate(palette.begin() + 1, palette.begin() + 31, palette.begin() + 32);
+		else
+			std::rotate(palette.begin() + 1, palette.begin() + 2, palette.begin() + 32);
+		CycleBlendedLookupTable(1, 31, reverse);
+
+		std::array<std::array<uint8_t, 256>, 256> cycled;
+		std::memcpy(cycled.data(), paletteTransparencyLookup, sizeof(paletteTransparencyLookup));
+#if DEVILUTIONX_PALETTE_TRANSPARENCY_BLACK_16_LUT
+		std::array<uint16_t, 65536> cycledBlack16;
+		std::memcpy(cycledBlack16.data(), paletteTransparencyLookupBlack16, sizeof(paletteTransparencyLookupBlack16));
+#endif
+
+		GenerateBlendedLookupTable(palette.data(), /*skipFrom=*/1, /*skipTo=*/31);
+		for (unsigned i = 0; i < 256; i++) {
+			for (unsigned j = 0; j < 256; j++) {
+				ASSERT_EQ(cycled[i][j], paletteTransparencyLookup[i][j]) << "reverse " << reverse << " at " << i << ", " << j;
+			}
+		}
+#if DEVILUTIONX_PALETTE_TRANSPARENCY_BLACK_16_LUT
+		EXPECT_EQ(std::memcmp(cycledBlack16.data(), paletteTransparencyLookupBlack16, sizeof(paletteTransparencyLookupBlack16)), 0) << "reverse " << reverse;
+#endif
+	}
+}
+
 } // namespace
 } // namespace devilution
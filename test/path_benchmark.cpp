@@ -3,8 +3,10 @@
 
 #include <benchmark/benchmark.h>
 #include <utility>
+#include <vector>
 
 #include "engine/path.h"
+#include "engine/path_impl.hpp"
 #include "engine/point.hpp"
 #include "engine/points_in_rectangle_range.hpp"
 #include "engine/size.hpp"
@@ -34,19 +36,104 @@ std::pair<Point, Point> FindStartDest(const Map &m)
 	return { start, dest };
 }
 
+/**
+ * @brief Searches through the `tl::function_ref` overload, or with the predicates inlined into `FindPathT` if the
+ * benchmark's argument is 1.
+ */
+int FindPathForBenchmark(const benchmark::State &state, Point start, Point dest, const Map &map, int8_t *path, size_t maxPathLength)
+{
+	const auto canStep = [](Point, Point) { return true; };
+	const auto posOk = [&map](Point p) { return map[p] != '#'; };
+	if (state.range(0) != 0)
+		return FindPathT(canStep, posOk, start, dest, path, maxPathLength);
+	return FindPath(canStep, posOk, start, dest, path, maxPathLength);
+}
+
 void BenchmarkMap(const Map &map, benchmark::State &state)
 {
 	const auto [start, dest] = FindStartDest(map);
-	const auto posOk = /*posOk=*/[&map](Point p) { return map[p] != '#'; };
 	constexpr size_t MaxPathLength = 25;
 	for (auto _ : state) {
 		int8_t path[MaxPathLength];
-		int result = FindPath(/*canStep=*/[](Point, Point) { return true; },
-		    posOk, start, dest, path, MaxPathLength);
+		int result = FindPathForBenchmark(state, start, dest, map, path, MaxPathLength);
 		benchmark::DoNotOptimize(result);
 	}
 }
 
+std::vector<Point> FindStarts(const Map &m)
+{
+	std::vector<Point> starts;
+	for (const Point p : PointsInRectangle(Rectangle(Point { 0, 0 }, m.size))) {
+		if (m[p] == 'S')
+			starts.push_back(p);
+	}
+	return starts;
+}
+
+// Many monsters chasing the same player.
+const Map Crowd {
+	Size { 30, 30 },
+	"##############################"
+	"#.S....S....S....S....S....S.#"
+	"#............................#"
+	"#..S....S....S....S....S.....#"
+	"#............................#"
+	"#######.########.#######.#####"
+	"#............................#"
+	"#.S....S....S....S....S....S.#"
+	"#............................#"
+	"#............................#"
+	"#####.#######.########.#######"
+	"#............................#"
+	"#............................#"
+	"#.....###########............#"
+	"#.....#.........#............#"
+	"#.....#....E....#............#"
+	"#.....#.........#............#"
+	"#.....####.######............#"
+	"#............................#"
+	"#............................#"
+	"#............................#"
+	"#............................#"
+	"#............................#"
+	"#............................#"
+	"#............................#"
+	"#............................#"
+	"#............................#"
+	"#............................#"
+	"#............................#"
+	"##############################"
+};
+
+void BM_CrowdSequential(benchmark::State &state)
+{
+	const std::vector<Point> starts = FindStarts(Crowd);
+	const Point dest = FindStartDest(Crowd).second;
+	constexpr size_t MaxPathLength = 25;
+	for (auto _ : state) {
+		for (const Point start : starts) {
+			int8_t path[MaxPathLength];
+			int result = FindPathForBenchmark(state, start, dest, Crowd, path, MaxPathLength);
+			benchmark::DoNotOptimize(result);
+		}
+	}
+}
+
+void BM_CrowdBatch(benchmark::State &state)
+{
+	const std::vector<Point> starts = FindStarts(Crowd);
+	const Point dest = FindStartDest(Crowd).second;
+	const auto posOk = /*posOk=*/[](Point p) { return Crowd[p] != '#'; };
+	constexpr size_t MaxPathLength = 25;
+	std::vector<int8_t> paths(starts.size() * MaxPathLength);
+	std::vector<int> pathLengths(starts.size());
+	for (auto _ : state) {
+		FindPaths(/*canStep=*/[](Point, Point) { return true; },
+		    posOk, starts, dest, paths.data(), pathLengths.data(), MaxPathLength);
+		benchmark::DoNotOptimize(pathLengths.data());
+	}
+}
+
 void BM_SinglePath(benchmark::State &state)
 {
 	BenchmarkMap(
@@ -154,10 +241,13 @@ void BM_NoPathBig(benchmark::State &state)
 	    state);
 }
 
-BENCHMARK(BM_SinglePath);
-BENCHMARK(BM_Bridges);
-BENCHMARK(BM_NoPath);
-BENCHMARK(BM_NoPathBig);
+// The argument is whether the predicates are inlined into `FindPathT`.
+BENCHMARK(BM_SinglePath)->ArgName("inlined")->Arg(0)->Arg(1);
+BENCHMARK(BM_Bridges)->ArgName("inlined")->Arg(0)->Arg(1);
+BENCHMARK(BM_NoPath)->ArgName("inlined")->Arg(0)->Arg(1);
+BENCHMARK(BM_NoPathBig)->ArgName("inlined")->Arg(0)->Arg(1);
+BENCHMARK(BM_CrowdSequential)->ArgName("inlined")->Arg(0)->Arg(1);
+BENCHMARK(BM_CrowdBatch);
 
 } // namespace
 } // namespace devilution
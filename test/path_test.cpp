@@ -162,6 +162,70 @@ TEST(PathTest, LongPaths)
 	CheckPath(startingPosition, startingPosition + Displacement { 25, 25 }, {});
 }
 
+// Offsets for the steps returned by `GetPathDirection`, in the order of `Dir`.
+constexpr std::array<Displacement, 9> StepDisplacements = { {
+	{ 0, 0 }, { 0, -1 }, { -1, 0 }, { 1, 0 }, { 0, 1 }, { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 },
+} };
+
+int GetPathCost(std::span<const int8_t> path)
+{
+	int cost = 0;
+	for (const int8_t step : path) {
+		const Displacement d = StepDisplacements[step];
+		cost += (d.deltaX != 0 && d.deltaY != 0) ? PathDiagonalStepCost : PathAxisAlignedStepCost;
+	}
+	return cost;
+}
+
+Point GetPathEnd(Point startPosition, std::span<const int8_t> path)
+{
+	Point position = startPosition;
+	for (const int8_t step : path)
+		position += StepDisplacements[step];
+	return position;
+}
+
+TEST(PathTest, FindPathsMatchesFindPath)
+{
+	// A wall with a single gap between the start positions and the destination.
+	const auto posOk = [](Point position) { return position.x != 20 || position.y == 5; };
+	const auto canStep = [](Point, Point) { return true; };
+	constexpr size_t MaxPathLength = 24;
+	constexpr Point Destination { 26, 12 };
+	const std::array<Point, 5> startPositions { Point { 14, 8 }, Point { 16, 16 }, Point { 26, 12 }, Point { 22, 4 }, Point { 14, 8 } };
+
+	std::array<int8_t, startPositions.size() * MaxPathLength> paths;
+	std::array<int, startPositions.size()> pathLengths;
+	FindPaths(canStep, posOk, startPositions, Destination, paths.data(), pathLengths.data(), MaxPathLength);
+
+	for (size_t i = 0; i < startPositions.size(); i++) {
+		int8_t expectedPath[MaxPathLength];
+		const int expectedLength = FindPath(canStep, posOk, startPositions[i], Destination, expectedPath, MaxPathLength);
+		const std::span<const int8_t> path { paths.data() + (i * MaxPathLength), static_cast<size_t>(pathLengths[i]) };
+		EXPECT_EQ(GetPathCost(path), GetPathCost({ expectedPath, static_cast<size_t>(expectedLength) }))
+		    << "Path from " << startPositions[i] << " is not the shortest";
+		EXPECT_EQ(GetPathEnd(startPositions[i], path), Destination) << "Path from " << startPositions[i] << " doesn't reach the destination";
+	}
+}
+
+TEST(PathTest, FindPathsLongPaths)
+{
+	constexpr size_t MaxPathLength = 24;
+	const Point destination { 56, 56 };
+	const std::array<Point, 3> startPositions { destination + Displacement { 24, 24 }, destination + Displacement { 25, 25 }, Point { 0, 0 } };
+
+	std::array<int8_t, startPositions.size() * MaxPathLength> paths;
+	std::array<int, startPositions.size()> pathLengths;
+	FindPaths(
+	    /*canStep=*/[](Point, Point) { return true; },
+	    /*posOk=*/[](Point) { return true; },
+	    startPositions, destination, paths.data(), pathLengths.data(), MaxPathLength);
+
+	EXPECT_THAT(ToSyms(std::span<const int8_t>(paths.data(), pathLengths[0])), ElementsAreArray(ToSyms(std::vector<std::string>(24, "↖"))));
+	EXPECT_EQ(pathLengths[1], 0) << "Destinations more than the maximum path length away should not be reachable";
+	EXPECT_EQ(pathLengths[2], 0) << "Destinations more than the maximum path length away should not be reachable";
+}
+
 TEST(PathTest, FindClosest)
 {
 	{
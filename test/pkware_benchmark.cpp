@@ -0,0 +1,64 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "encrypt.h"
+
+namespace devilution {
+namespace {
+
+constexpr size_t RecordSize = 22;
+
+/**
+ * @brief Builds data shaped like the delta of a visited level: fixed size tables of
+ * records where unused entries are 0xFF and only every 8th entry is filled in.
+ */
+std::vector<std::byte> MakeDeltaPayload(size_t size)
+{
+	std::vector<std::byte> data(size, std::byte { 0xFF });
+	uint32_t seed = 1;
+	for (size_t record = 0; record + RecordSize <= size; record += RecordSize * 8) {
+		for (size_t i = 0; i < RecordSize; i++) {
+			seed = seed * 1103515245 + 12345;
+			data[record + i] = static_cast<std::byte>(seed >> 16);
+		}
+	}
+	return data;
+}
+
+void BM_PkwareCompress(benchmark::State &state)
+{
+	const std::vector<std::byte> payload = MakeDeltaPayload(static_cast<size_t>(state.range(0)));
+	std::vector<std::byte> buffer(payload.size());
+	uint32_t compressedSize = 0;
+	for (auto _ : state) {
+		std::memcpy(buffer.data(), payload.data(), payload.size());
+		compressedSize = PkwareCompress(buffer.data(), static_cast<uint32_t>(buffer.size()));
+		benchmark::DoNotOptimize(compressedSize);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * payload.size()));
+	state.counters["ratio"] = static_cast<double>(compressedSize) / static_cast<double>(payload.size());
+}
+
+void BM_PkwareDecompress(benchmark::State &state)
+{
+	const std::vector<std::byte> payload = MakeDeltaPayload(static_cast<size_t>(state.range(0)));
+	std::vector<std::byte> compressed = payload;
+	const uint32_t compressedSize = PkwareCompress(compressed.data(), static_cast<uint32_t>(compressed.size()));
+	std::vector<std::byte> buffer(payload.size());
+	for (auto _ : state) {
+		std::memcpy(buffer.data(), compressed.data(), compressedSize);
+		benchmark::DoNotOptimize(PkwareDecompress(buffer.data(), compressedSize, buffer.size()));
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * payload.size()));
+}
+
+// An MPQ sector and about the size of a level delta
+BENCHMARK(BM_PkwareCompress)->Arg(4096)->Arg(16384);
+BENCHMARK(BM_PkwareDecompress)->Arg(4096)->Arg(16384);
+
+} // namespace
+} // namespace devilution
@@ -0,0 +1,127 @@
+#include "monsters/player_flow_field.hpp"
+
+#include <cstring>
+#include <optional>
+
+#include <gtest/gtest.h>
+
+#include "engine/direction.hpp"
+#include "engine/point.hpp"
+#include "levels/gendung.h"
+#include "monster.h"
+#include "player.h"
+
+namespace devilution {
+namespace {
+
+constexpr size_t MaxDistance = 25;
+
+class PlayerFlowFieldTest : public ::testing::Test {
+protected:
+	void SetUp() override
+	{
+		std::memset(dPiece, 0, sizeof(dPiece));
+		std::memset(dObject, 0, sizeof(dObject));
+		SOLData[0] = TileProperties::None;
+		SOLData[1] = TileProperties::Solid;
+		InvalidatePlayerFlowFields();
+
+		Players.resize(1);
+		MyPlayerId = 0;
+		MyPlayer = &Players[MyPlayerId];
+		*MyPlayer = {};
+		MyPlayer->position.future = { 15, 15 };
+
+		monster_ = {};
+		monster_.position.tile = { 10, 10 };
+	}
+
+	static void SetSolid(Point position)
+	{
+		dPiece[position.x][position.y] = 1;
+	}
+
+	/** @brief Surrounds the tile with solid tiles. */
+	static void WallIn(Point position)
+	{
+		for (int x = -1; x <= 1; x++) {
+			for (int y = -1; y <= 1; y++) {
+				if (x != 0 || y != 0)
+					SetSolid(position + Displacement { x, y });
+			}
+		}
+	}
+
+	std::optional<Direction> GetDirection(size_t maxDistance = MaxDistance)
+	{
+		return GetPlayerFlowFieldDirection(monster_, *MyPlayer, maxDistance);
+	}
+
+	Monster monster_;
+};
+
+TEST_F(PlayerFlowFieldTest, StepsTowardsThePlayer)
+{
+	EXPECT_EQ(GetDirection(), Direction::South);
+
+	MyPlayer->position.future = { 5, 5 };
+	EXPECT_EQ(GetDirection(), Direction::North);
+}
+
+TEST_F(PlayerFlowFieldTest, WalksAroundWalls)
+{
+	// A wall between monster and player that is only open towards the north
+	MyPlayer->position.future = { 14, 10 };
+	for (int y = 5; y < 30; y++)
+		SetSolid({ 12, y });
+
+	const std::optional<Direction> direction = GetDirection();
+	ASSERT_TRUE(direction.has_value());
+	EXPECT_LT((monster_.position.tile + *direction).y, monster_.position.tile.y);
+}
+
+TEST_F(PlayerFlowFieldTest, NoDirectionWhenAdjacent)
+{
+	MyPlayer->position.future = { 11, 11 };
+	EXPECT_EQ(GetDirection(), std::nullopt);
+}
+
+TEST_F(PlayerFlowFieldTest, NoDirectionWhenUnreachable)
+{
+	WallIn(MyPlayer->position.future);
+	EXPECT_EQ(GetDirection(), std::nullopt);
+}
+
+TEST_F(PlayerFlowFieldTest, NoDirectionWhenTooFarAway)
+{
+	EXPECT_EQ(GetDirection(4), std::nullopt);
+	EXPECT_EQ(GetDirection(5), Direction::South);
+}
+
+TEST_F(PlayerFlowFieldTest, RecomputedWhenPlayerMoves)
+{
+	EXPECT_EQ(GetDirection(), Direction::South);
+
+	// No invalidation, the walls are only picked up because the field is rebuilt for each new position
+	WallIn({ 15, 15 });
+	MyPlayer->position.future = { 5, 15 };
+	EXPECT_EQ(GetDirection(), Direction::West);
+
+	MyPlayer->position.future = { 15, 15 };
+	EXPECT_EQ(GetDirection(), std::nullopt);
+}
+
+TEST_F(PlayerFlowFieldTest, RecomputedWhenInvalidated)
+{
+	EXPECT_EQ(GetDirection(), Direction::South);
+
+	// A new level (or a door closing) changes the tiles without the player moving
+	WallIn(MyPlayer->position.future);
+	EXPECT_EQ(GetDirection(), Direction::South) << "The field is kept until it is invalidated";
+
+	InvalidatePlayerFlowFields();
+	EXPECT_EQ(GetDirection(), std::nullopt);
+}
+
+} // namespace
+} // namespace devilution
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "utils/pooled_list.hpp"
+
+using namespace devilution;
+
+namespace {
+
+constexpr size_t ChunkSize = 4;
+
+std::vector<int> ToVector(const PooledList<int, ChunkSize> &list)
+{
+	std::vector<int> result;
+	for (const int value : list)
+		result.push_back(value);
+	return result;
+}
+
+TEST(PooledList, KeepsInsertionOrder)
+{
+	PooledList<int, ChunkSize> list;
+	for (int i = 0; i < 10; i++)
+		list.emplace_back(i);
+
+	EXPECT_EQ(list.size(), 10);
+	EXPECT_EQ(list.back(), 9);
+	EXPECT_EQ(ToVector(list), (std::vector<int> { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+}
+
+TEST(PooledList, RemoveIfKeepsOrderOfRemainingElements)
+{
+	PooledList<int, ChunkSize> list;
+	for (int i = 0; i < 10; i++)
+		list.push_back(i);
+
+	EXPECT_EQ(list.remove_if([](int value) { return value % 3 == 0; }), 4);
+	EXPECT_EQ(ToVector(list), (std::vector<int> { 1, 2, 4, 5, 7, 8 }));
+
+	// Reused slots must not change the order, new elements always go to the back.
+	list.push_back(10);
+	list.push_back(11);
+	EXPECT_EQ(ToVector(list), (std::vector<int> { 1, 2, 4, 5, 7, 8, 10, 11 }));
+}
+
+TEST(PooledList, ReusesReleasedSlots)
+{
+	PooledList<int, ChunkSize> list;
+	int &first = list.emplace_back(1);
+	int *const firstSlot = &first;
+	list.emplace_back(2);
+
+	list.remove_if([](int value) { return value == 1; });
+	EXPECT_EQ(&list.emplace_back(3), firstSlot);
+	EXPECT_EQ(ToVector(list), (std::vector<int> { 2, 3 }));
+}
+
+TEST(PooledList, ReferencesStayValidWhileGrowing)
+{
+	PooledList<int, ChunkSize> list;
+	int &first = list.emplace_back(42);
+	for (int i = 0; i < 100; i++)
+		list.emplace_back(i);
+
+	EXPECT_EQ(first, 42);
+	EXPECT_EQ(&*list.begin(), &first);
+}
+
+TEST(PooledList, VisitsElementsAddedWhileIterating)
+{
+	PooledList<int, ChunkSize> list;
+	list.emplace_back(0);
+
+	std::vector<int> visited;
+	for (int &value : list) {
+		visited.push_back(value);
+		if (value < 9)
+			list.emplace_back(value + 1);
+	}
+
+	EXPECT_EQ(visited, (std::vector<int> { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+}
+
+TEST(PooledList, Clear)
+{
+	PooledList<int, ChunkSize> list;
+	for (int i = 0; i < 10; i++)
+		list.emplace_back(i);
+	int *const firstSlot = &*list.begin();
+
+	list.clear();
+	EXPECT_TRUE(list.empty());
+	EXPECT_EQ(list.begin(), list.end());
+
+	EXPECT_EQ(&list.emplace_back(5), firstSlot);
+	EXPECT_EQ(ToVector(list), (std::vector<int> { 5 }));
+}
+
+} // namespace
@@ -0,0 +1,148 @@
+#include "engine/render/primitive_render.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <benchmark/benchmark.h>
+
+#include "engine/render/blit_kernels.hpp"
+#include "engine/surface.hpp"
+#include "utils/palette_blending.hpp"
+#include "utils/sdl_wrap.h"
+
+namespace devilution {
+namespace {
+
+SDLSurfaceUniquePtr SdlSurface;
+
+void InitOnce()
+{
+	[[maybe_unused]] static const bool GlobalInitDone = []() {
+		std::array<SDL_Color, 256> palette;
+		for (unsigned j = 0; j < 4; ++j) {
+			for (unsigned i = 0; i < 64; ++i) {
+				palette[j * 64 + i].r = i * std::max(j, 1U);
+				palette[j * 64 + i].g = i * j;
+				palette[j * 64 + i].b = i * 2;
+#ifndef USE_SDL1
+				palette[j * 64 + i].a = SDL_ALPHA_OPAQUE;
+#endif
+			}
+		}
+		GenerateBlendedLookupTable(palette.data());
+
+		SdlSurface = SDLWrap::CreateRGBSurfaceWithFormat(
+		    /*flags=*/0, /*width=*/640, /*height=*/480, /*depth=*/8, SDL_PIXELFORMAT_INDEX8);
+		if (SdlSurface == nullptr) {
+			std::fprintf(stderr, "Failed to create SDL Surface: %s\n", SDL_GetError());
+			exit(1);
+		}
+		const Surface out = Surface(SdlSurface.get());
+		for (int y = 0; y < out.h(); ++y) {
+			for (int x = 0; x < out.w(); ++x) {
+				out[Point { x, y }] = static_cast<uint8_t>(x ^ y);
+			}
+		}
+		return true;
+	}();
+}
+
+/**
+ * @brief Runs `fn` with the kernels of the given ISA, skipping the benchmark if the CPU doesn't support it.
+ */
+template <typename Fn>
+void RunWithIsa(benchmark::State &state, BlitIsa isa, Fn &&fn)
+{
+	InitOnce();
+	const BlitIsa prevIsa = GetBlitIsa();
+	if (!SetBlitIsa(isa)) {
+		state.SkipWithError("ISA not supported on this CPU");
+		return;
+	}
+	const Surface out = Surface(SdlSurface.get());
+	for (auto _ : state) {
+		fn(out);
+		uint8_t color = out[Point { 310, 200 }];
+		benchmark::DoNotOptimize(color);
+	}
+	SetBlitIsa(prevIsa);
+}
+
+// The size of the quest dialog box, at an unaligned position.
+constexpr int RectX = 25;
+constexpr int RectY = 30;
+constexpr int RectWidth = 591;
+constexpr int RectHeight = 303;
+
+template <BlitIsa IsaT>
+void BM_DrawHalfTransparentRect(benchmark::State &state)
+{
+	RunWithIsa(state, IsaT, [](const Surface &out) {
+		DrawHalfTransparentRectTo(out, RectX, RectY, RectWidth, RectHeight);
+	});
+	state.SetBytesProcessed(state.iterations() * RectWidth * RectHeight);
+}
+
+template <BlitIsa IsaT>
+void BM_DrawHalfTransparentColoredRect(benchmark::State &state)
+{
+	RunWithIsa(state, IsaT, [](const Surface &out) {
+		DrawHalfTransparentRectTo(out, RectX, RectY, RectWidth, RectHeight, 165);
+	});
+	state.SetBytesProcessed(state.iterations() * RectWidth * RectHeight);
+}
+
+template <BlitIsa IsaT>
+void BM_DrawHalfTransparentHorizontalLine(benchmark::State &state)
+{
+	RunWithIsa(state, IsaT, [](const Surface &out) {
+		DrawHalfTransparentHorizontalLine(out, { RectX, RectY }, RectWidth, 165);
+	});
+	state.SetBytesProcessed(state.iterations() * RectWidth);
+}
+
+void BM_FillRect(benchmark::State &state)
+{
+	InitOnce();
+	const Surface out = Surface(SdlSurface.get());
+	for (auto _ : state) {
+		FillRect(out, RectX, RectY, RectWidth, RectHeight, 0);
+		uint8_t color = out[Point { 310, 200 }];
+		benchmark::DoNotOptimize(color);
+	}
+	state.SetBytesProcessed(state.iterations() * RectWidth * RectHeight);
+}
+
+void BM_FillRectWholeSurface(benchmark::State &state)
+{
+	InitOnce();
+	const Surface out = Surface(SdlSurface.get());
+	for (auto _ : state) {
+		FillRect(out, 0, 0, out.w(), out.h(), 0);
+		uint8_t color = out[Point { 310, 200 }];
+		benchmark::DoNotOptimize(color);
+	}
+	state.SetBytesProcessed(state.iterations() * out.w() * out.h());
+}
+
+// Define aliases in order to have shorter benchmark names.
+constexpr auto Scalar = BlitIsa::Scalar;
+constexpr auto AVX2 = BlitIsa::AVX2;
+constexpr auto NEON = BlitIsa::NEON;
+
+#define DEFINE_FOR_ISA(BENCHMARK_FN)         \
+	BENCHMARK_TEMPLATE(BENCHMARK_FN, Scalar); \
+	BENCHMARK_TEMPLATE(BENCHMARK_FN, AVX2);   \
+	BENCHMARK_TEMPLATE(BENCHMARK_FN, NEON);
+
+DEFINE_FOR_ISA(BM_DrawHalfTransparentRect)
+DEFINE_FOR_ISA(BM_DrawHalfTransparentColoredRect)
+DEFINE_FOR_ISA(BM_DrawHalfTransparentHorizontalLine)
+BENCHMARK(BM_FillRect);
+BENCHMARK(BM_FillRectWholeSurface);
+
+} // namespace
+} // namespace devilution
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "codec.h"
+#include "encrypt.h"
+#include "game_mode.hpp"
+#include "multi.h"
+#include "pfile.h"
+#include "utils/log.hpp"
+#include "utils/paths.h"
+
+namespace devilution {
+namespace {
+
+/** @brief The save archive compresses its files in sectors of this size. */
+constexpr size_t SectorSize = 4096;
+
+std::optional<SaveReader> FixtureSave;
+
+SaveReader &GetFixtureSave()
+{
+	[[maybe_unused]] static const bool GlobalInitDone = []() {
+		// The hero of the timedemo fixture, a spawn single player save
+		paths::SetPrefPath(paths::BasePath() + "test/fixtures/timedemo/WarriorLevel1to2/");
+		gbIsSpawn = true;
+		gbIsHellfire = false;
+		gbIsMultiplayer = false;
+		FixtureSave = OpenSaveArchive(0);
+		if (!FixtureSave) {
+			LogError("This benchmark needs the save in test/fixtures/timedemo/WarriorLevel1to2");
+			exit(1);
+		}
+		return true;
+	}();
+	return *FixtureSave;
+}
+
+std::vector<std::byte> ReadSection(const char *name)
+{
+	size_t size = 0;
+	const std::unique_ptr<std::byte[]> data = ReadArchive(GetFixtureSave(), name, &size);
+	if (data == nullptr)
+		return {};
+	return { data.get(), data.get() + size };
+}
+
+/**
+ * @brief Encodes and compresses a section the way it is written to the save archive.
+ * @return The size of the section in the archive.
+ */
+size_t EncodeSection(const std::vector<std::byte> &section, std::byte *buffer, size_t encodedSize)
+{
+	std::memcpy(buffer, section.data(), section.size());
+	codec_encode(buffer, section.size(), encodedSize, pfile_get_password());
+	size_t compressedSize = 0;
+	for (size_t offset = 0; offset < encodedSize; offset += SectorSize) {
+		const size_t sectorSize = std::min(SectorSize, encodedSize - offset);
+		compressedSize += PkwareCompress(buffer + offset, static_cast<uint32_t>(sectorSize));
+	}
+	return compressedSize;
+}
+
+/**
+ * @brief Reads a file of the save, which decompresses and decodes it.
+ */
+void BM_ReadSection(benchmark::State &state, const char *name)
+{
+	SaveReader &save = GetFixtureSave();
+	size_t size = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(ReadArchive(save, name, &size));
+	}
+	if (size == 0) {
+		state.SkipWithError("The fixture save has no such file");
+		return;
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+	state.counters["bytes"] = static_cast<double>(size);
+}
+
+/**
+ * @brief Encodes and compresses a file of the save, reports its size and how well it compresses.
+ */
+void BM_WriteSection(benchmark::State &state, const char *name)
+{
+	const std::vector<std::byte> section = ReadSection(name);
+	if (section.empty()) {
+		state.SkipWithError("The fixture save has no such file");
+		return;
+	}
+	const size_t encodedSize = codec_get_encoded_len(section.size());
+	const std::unique_ptr<std::byte[]> buffer { new std::byte[encodedSize] };
+	size_t compressedSize = 0;
+	for (auto _ : state) {
+		compressedSize = EncodeSection(section, buffer.get(), encodedSize);
+		benchmark::DoNotOptimize(compressedSize);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * section.size()));
+	state.counters["bytes"] = static_cast<double>(section.size());
+	state.counters["compressed"] = static_cast<double>(compressedSize);
+	state.counters["ratio"] = static_cast<double>(compressedSize) / static_cast<double>(section.size());
+}
+
+// The files of a hero that went from town to dungeon level 2
+BENCHMARK_CAPTURE(BM_ReadSection, hero, "hero");
+BENCHMARK_CAPTURE(BM_ReadSection, game, "game");
+BENCHMARK_CAPTURE(BM_ReadSection, town, "perml00");
+BENCHMARK_CAPTURE(BM_ReadSection, level1, "perml01");
+BENCHMARK_CAPTURE(BM_ReadSection, level2, "perml02");
+BENCHMARK_CAPTURE(BM_WriteSection, hero, "hero");
+BENCHMARK_CAPTURE(BM_WriteSection, game, "game");
+BENCHMARK_CAPTURE(BM_WriteSection, town, "perml00");
+BENCHMARK_CAPTURE(BM_WriteSection, level1, "perml01");
+BENCHMARK_CAPTURE(BM_WriteSection, level2, "perml02");
+
+} // namespace
+} // namespace devilution
@@ -0,0 +1,285 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <expected.hpp>
+
+#include "crawl.hpp"
+#include "diablo.h"
+#include "engine/assets.hpp"
+#include "engine/point.hpp"
+#include "engine/sound.h"
+#include "game_mode.hpp"
+#include "headless_mode.hpp"
+#include "items.h"
+#include "levels/gendung.h"
+#include "levels/tile_properties.hpp"
+#include "lighting.h"
+#include "loadsave.h"
+#include "lua/lua_global.hpp"
+#include "menu.h"
+#include "missiles.h"
+#include "monster.h"
+#include "msg.h"
+#include "multi.h"
+#include "nthread.h"
+#include "player.h"
+#include "quests.h"
+#include "storm/storm_net.hpp"
+#include "sync.h"
+#include "tables/itemdat.h"
+#include "tables/misdat.h"
+#include "tables/monstdat.h"
+#include "tables/objdat.h"
+#include "tables/playerdat.hpp"
+#include "tables/spelldat.h"
+#include "tables/textdat.h"
+#include "utils/log.hpp"
+#include "utils/paths.h"
+#include "utils/static_vector.hpp"
+
+namespace devilution {
+namespace {
+
+/** @brief The level the benchmarks run on, the deepest one that spawn.mpq has. */
+constexpr uint8_t BenchmarkLevel = 2;
+
+/**
+ * @brief Loads the hero of the timedemo fixture and enters a freshly generated dungeon level with them.
+ *
+ * The save is copied first, as loading a game writes to the save archive.
+ */
+void InitOnce()
+{
+	[[maybe_unused]] static const bool GlobalInitDone = []() {
+		LoadCoreArchives();
+		LoadGameArchives();
+		if (!HaveMainData()) {
+			LogError("This benchmark needs spawn.mpq or DIABDAT.MPQ");
+			exit(1);
+		}
+
+		const std::filesystem::path saveDir = std::filesystem::temp_directory_path() / "devilutionx_simulation_benchmark";
+		std::error_code error;
+		std::filesystem::create_directories(saveDir, error);
+		std::filesystem::copy_file(std::filesystem::path(paths::BasePath()) / "test/fixtures/timedemo/WarriorLevel1to2/spawn_0.sv",
+		    saveDir / "spawn_0.sv", std::filesystem::copy_options::overwrite_existing, error);
+		if (error) {
+			LogError("This benchmark needs the save in test/fixtures/timedemo/WarriorLevel1to2: {}", error.message());
+			exit(1);
+		}
+		paths::SetPrefPath(saveDir.string() + "/");
+
+		gbIsSpawn = true;
+		gbIsHellfire = false;
+		gbIsMultiplayer = false;
+		gbMusicOn = false;
+		gbSoundOn = false;
+		HeadlessMode = true;
+		Players.resize(1);
+		MyPlayerId = 0;
+		MyPlayer = &Players[MyPlayerId];
+		*MyPlayer = {};
+
+		LuaInitialize();
+		LoadTextData();
+		LoadSpellData();
+		LoadPlayerDataFiles();
+		LoadMissileData();
+		LoadMonsterData();
+		LoadItemData();
+		LoadObjectData();
+		LoadQuestData();
+
+		gSaveNumber = 0;
+		if (const tl::expected<void, std::string> result = LoadGame(true); !result.has_value()) {
+			LogError("Failed to load the fixture save: {}", result.error());
+			exit(1);
+		}
+
+		// The same steps as taking the stairs down, except that the level is always generated
+		FreeGameMem();
+		setlevel = false;
+		currlevel = BenchmarkLevel;
+		leveltype = GetLevelType(currlevel);
+		MyPlayer->setLevel(currlevel);
+		MyPlayer->_pLvlVisited[currlevel] = false;
+		if (const tl::expected<void, std::string> result = LoadGameLevel(false, ENTRY_MAIN); !result.has_value()) {
+			LogError("Failed to generate level {}: {}", currlevel, result.error());
+			exit(1);
+		}
+
+		// Keeps the hero alive however long the monsters attack
+		MyPlayer->_pInvincible = true;
+		return true;
+	}();
+}
+
+/**
+ * @brief Replaces the monsters of the level with `count` monsters of the level's types, packed around the hero.
+ * @return The number of monsters that found a free tile.
+ */
+size_t SpawnMonsters(size_t count)
+{
+	StaticVector<size_t, MaxLvlMTypes> scatterTypes;
+	for (size_t i = 0; i < LevelMonsterTypeCount; i++) {
+		if ((LevelMonsterTypes[i].placeFlags & PLACE_SCATTER) != 0)
+			scatterTypes.push_back(i);
+	}
+
+	// Keeps the loaded monster types, only the monsters are replaced
+	const size_t typeCount = LevelMonsterTypeCount;
+	InitLevelMonsters();
+	LevelMonsterTypeCount = typeCount;
+	memset(dMonster, 0, sizeof(dMonster));
+	InitGolems();
+
+	const Point center = MyPlayer->position.tile;
+	size_t spawned = 0;
+	Crawl(1, MaxCrawlRadius, [&](Displacement displacement) {
+		if (spawned == count || scatterTypes.empty())
+			return true;
+		const Point position = center + displacement;
+		if (IsTileOccupied(position))
+			return false;
+		if (AddMonster(position, GetDirection(position, center), scatterTypes[spawned % scatterTypes.size()], true) == nullptr)
+			return true;
+		spawned++;
+		return false;
+	});
+	return spawned;
+}
+
+/**
+ * @brief Casts spells from the hero in all directions until `count` missiles are in flight.
+ */
+void AddMissiles(size_t count)
+{
+	const Point source = MyPlayer->position.tile;
+	for (size_t i = Missiles.size(); i < count; i++) {
+		const auto direction = static_cast<Direction>(i % 8);
+		const MissileID type = i % 2 == 0 ? MissileID::Firebolt : MissileID::LightningControl;
+		AddMissile(source, source + Displacement(direction) * 8, direction, type, TARGET_MONSTERS, *MyPlayer, 1, 1);
+	}
+}
+
+/**
+ * @brief Lets the missiles in flight run their course, so that the lights they carry are freed.
+ */
+void ClearMissiles()
+{
+	while (!Missiles.empty())
+		ProcessMissiles();
+}
+
+void BM_ProcessMonsters(benchmark::State &state)
+{
+	InitOnce();
+	const size_t monsters = SpawnMonsters(static_cast<size_t>(state.range(0)));
+	for (auto _ : state) {
+		ProcessMonsters();
+		benchmark::DoNotOptimize(Monsters);
+	}
+	state.counters["monsters"] = static_cast<double>(monsters);
+}
+
+void BM_ProcessMissiles(benchmark::State &state)
+{
+	InitOnce();
+	SpawnMonsters(50);
+	const auto count = static_cast<size_t>(state.range(0));
+	for (auto _ : state) {
+		// Missiles that hit something are gone, the load is kept up like a group of casters would
+		state.PauseTiming();
+		AddMissiles(count);
+		state.ResumeTiming();
+		ProcessMissiles();
+		benchmark::DoNotOptimize(Missiles);
+	}
+	ClearMissiles();
+}
+
+void BM_CalcPlrItemVals(benchmark::State &state)
+{
+	InitOnce();
+	for (auto _ : state) {
+		CalcPlrItemVals(*MyPlayer, false);
+		benchmark::DoNotOptimize(MyPlayer);
+	}
+}
+
+void BM_ProcessLightList(benchmark::State &state)
+{
+	InitOnce();
+	const Point center = MyPlayer->position.tile;
+	std::array<int, MAXLIGHTS> lights;
+	size_t count = 0;
+	for (int i = 0; i < state.range(0); i++) {
+		const int id = AddLight(center + Displacement { (i % 6) * 3 - 8, (i / 6) * 3 - 8 }, 6);
+		if (id == NO_LIGHT)
+			break;
+		lights[count++] = id;
+	}
+	ProcessLightList();
+
+	int step = 1;
+	for (auto _ : state) {
+		// Every light moves, as monsters and missiles carrying a light do
+		for (size_t i = 0; i < count; i++)
+			ChangeLightXY(lights[i], Lights[lights[i]].position.tile + Displacement { step, 0 });
+		step = -step;
+		ProcessLightList();
+		benchmark::DoNotOptimize(dLight);
+	}
+	state.counters["lights"] = static_cast<double>(count);
+
+	for (size_t i = 0; i < count; i++)
+		AddUnLight(lights[i]);
+	ProcessLightList();
+}
+
+/**
+ * @brief Exports the level delta to a joining player, loopback drops the messages to anyone but the local player.
+ */
+void BM_DeltaExportData(benchmark::State &state)
+{
+	InitOnce();
+	SpawnMonsters(static_cast<size_t>(state.range(0)));
+	SNetInitializeProvider(SELCONN_LOOPBACK, nullptr);
+	// Normally set from the provider's caps when the game starts
+	gdwLargestMsgSize = 512;
+	gbIsMultiplayer = true;
+	delta_init();
+	DeltaSaveLevel();
+	for (auto _ : state) {
+		DeltaExportData(1);
+	}
+	gbIsMultiplayer = false;
+}
+
+void BM_SyncAllMonsters(benchmark::State &state)
+{
+	InitOnce();
+	const size_t monsters = SpawnMonsters(static_cast<size_t>(state.range(0)));
+	std::array<std::byte, 512> buffer;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(sync_all_monsters(buffer.data(), buffer.size()));
+		benchmark::DoNotOptimize(buffer);
+	}
+	state.counters["monsters"] = static_cast<double>(monsters);
+}
+
+BENCHMARK(BM_ProcessMonsters)->Arg(10)->Arg(50)->Arg(150);
+BENCHMARK(BM_ProcessMissiles)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(BM_CalcPlrItemVals);
+BENCHMARK(BM_ProcessLightList)->Arg(8)->Arg(24);
+BENCHMARK(BM_DeltaExportData)->Arg(50)->Arg(150);
+BENCHMARK(BM_SyncAllMonsters)->Arg(10)->Arg(150);
+
+} // namespace
+} // namespace devilution
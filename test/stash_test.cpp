@@ -186,6 +186,23 @@ TEST_F(StashTest, PlaceItem_SwordOccupiesCorrectArea)
 	    << "Sword should occupy exactly " << swordSize.width << "×" << swordSize.height << " cells";
 }
 
+TEST_F(StashTest, PlaceItem_ReusesSpaceFreedOnFullPage)
+{
+	FillStashPage(0);
+	Stash.SetPage(0);
+
+	// Free a cell in the middle of the full page, the next item should go there rather than on page 1.
+	const StashStruct::StashCell removedId = Stash.GetItemIdAtPosition({ 4, 5 });
+	ASSERT_NE(removedId, StashStruct::EmptyCell);
+	Stash.RemoveStashItem(removedId);
+
+	Item item = MakeSmallItem();
+	EXPECT_TRUE(AutoPlaceItemInStash(item, true));
+
+	EXPECT_EQ(CountOccupiedCells(Stash.stashGrids[0]), 100);
+	EXPECT_EQ(Stash.stashGrids.count(1), 0u) << "Page 1 should not have been created";
+}
+
 // ---------------------------------------------------------------------------
 // Gold in stash
 // ---------------------------------------------------------------------------
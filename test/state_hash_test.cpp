@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+
+#include "items.h"
+#include "monster.h"
+#include "msg.h"
+#include "multi.h"
+#include "player.h"
+#include "quests.h"
+#include "state_hash.hpp"
+
+namespace devilution {
+namespace {
+
+void InitStateHashTest()
+{
+	gbIsMultiplayer = true;
+	Players.resize(1);
+	MyPlayerId = 0;
+	MyPlayer = &Players[MyPlayerId];
+	*MyPlayer = {};
+	MyPlayer->plractive = true;
+	MyPlayer->plrlevel = 1;
+	MyPlayer->_pExperience = 2000;
+	for (Quest &quest : Quests)
+		quest = {};
+	delta_init();
+
+	ActiveMonsterCount = 1;
+	ActiveMonsters[0] = 0;
+	Monsters[0] = {};
+	Monsters[0].position.tile = { 10, 10 };
+	Monsters[0].hitPoints = 100 << 6;
+
+	for (int i = 0; i < 2; i++) {
+		Items[i] = {};
+		Items[i].IDidx = IDI_HEAL;
+		Items[i]._iSeed = 1000 + i;
+		Items[i].position = { 20 + i, 20 };
+	}
+}
+
+/** @brief Adds the hero of another player, as this client's copy of it. */
+Player &AddRemotePlayer()
+{
+	Players.resize(2);
+	MyPlayer = &Players[MyPlayerId];
+	Player &remote = Players[1];
+	remote = {};
+	remote.plractive = true;
+	remote.plrlevel = 1;
+	ResetStateHashes();
+	return remote;
+}
+
+/** @brief Computes the hash the other player's client sends, with `change` applied to its hero only while hashing. */
+template <typename F>
+StateHash ComputeRemoteStateHash(Player &remote, F &&change)
+{
+	const Player &local = *MyPlayer;
+	MyPlayerId = remote.getId();
+	MyPlayer = &remote;
+	change(remote, +1);
+	const StateHash hash = ComputeStateHash();
+	change(remote, -1);
+	MyPlayerId = local.getId();
+	MyPlayer = &Players[MyPlayerId];
+	return hash;
+}
+
+void ExpectOnlyClassChanged(const StateHash &before, const StateHash &after, StateHashClass changed)
+{
+	for (size_t i = 0; i < NumStateHashClasses; i++) {
+		const auto hashClass = static_cast<StateHashClass>(i);
+		if (hashClass == changed)
+			EXPECT_NE(before.classes[i], after.classes[i]) << StateHashClassName(hashClass);
+		else
+			EXPECT_EQ(before.classes[i], after.classes[i]) << StateHashClassName(hashClass);
+	}
+}
+
+TEST(StateHash, SameStateSameHash)
+{
+	InitStateHashTest();
+	EXPECT_EQ(ComputeStateHash().classes, ComputeStateHash().classes);
+}
+
+TEST(StateHash, MonsterStateDoesNotChangeHash)
+{
+	InitStateHashTest();
+	const StateHash before = ComputeStateHash();
+	Monsters[0].position.tile = { 11, 10 };
+	Monsters[0].hitPoints -= 1 << 6;
+	EXPECT_EQ(before.classes, ComputeStateHash().classes);
+}
+
+TEST(StateHash, PlayerPositionDoesNotChangeHash)
+{
+	InitStateHashTest();
+	const StateHash before = ComputeStateHash();
+	MyPlayer->position.tile = { 30, 30 };
+	EXPECT_EQ(before.classes, ComputeStateHash().classes);
+}
+
+TEST(StateHash, PlayerStatsChangeOnlyPlayerHash)
+{
+	InitStateHashTest();
+	const StateHash before = ComputeStateHash();
+	MyPlayer->_pBaseStr += 1;
+	ExpectOnlyClassChanged(before, ComputeStateHash(), StateHashClass::Players);
+}
+
+TEST(StateHash, PlayerExperienceDoesNotChangeHash)
+{
+	InitStateHashTest();
+	const StateHash before = ComputeStateHash();
+	MyPlayer->_pExperience += 500;
+	EXPECT_EQ(before.classes, ComputeStateHash().classes);
+}
+
+TEST(StateHash, RemotePlayerExperienceDoesNotCauseMismatch)
+{
+	InitStateHashTest();
+	Player &remote = AddRemotePlayer();
+
+	// The kill is only credited on the remote client, this client never learns about the experience
+	const StateHash remoteHash = ComputeRemoteStateHash(remote, [](Player &player, int sign) { player._pExperience += sign * 500; });
+	CompareStateHash(remote, StateHashInterval, remoteHash);
+	EXPECT_EQ(GetStateHashMismatches(), 0U);
+
+	const StateHash localHash = ComputeStateHash();
+	for (size_t i = 0; i < NumStateHashClasses; i++) {
+		const auto hashClass = static_cast<StateHashClass>(i);
+		if (hashClass != StateHashClass::Players)
+			EXPECT_EQ(localHash.classes[i], remoteHash.classes[i]) << StateHashClassName(hashClass);
+	}
+}
+
+TEST(StateHash, RemotePlayerStatsAreComparedWithTheLocalCopy)
+{
+	InitStateHashTest();
+	Player &remote = AddRemotePlayer();
+	const auto drinkElixir = [](Player &player, int sign) { player._pBaseStr += sign; };
+
+	// CMD_SETSTR arrived before the hash
+	drinkElixir(remote, +1);
+	CompareStateHash(remote, StateHashInterval, ComputeRemoteStateHash(remote, [](Player &, int) {}));
+	EXPECT_EQ(GetStateHashMismatches(), 0U);
+
+	// The local copy missed the change
+	drinkElixir(remote, -1);
+	CompareStateHash(remote, 2 * StateHashInterval, ComputeRemoteStateHash(remote, drinkElixir));
+	EXPECT_EQ(GetStateHashMismatches(), 1U);
+}
+
+TEST(StateHash, QuestChangesOnlyQuestHash)
+{
+	InitStateHashTest();
+	const StateHash before = ComputeStateHash();
+	Quests[Q_BUTCHER]._qactive = QUEST_ACTIVE;
+	ExpectOnlyClassChanged(before, ComputeStateHash(), StateHashClass::Quests);
+}
+
+TEST(StateHash, DeltaItemChangesOnlyDeltaHash)
+{
+	InitStateHashTest();
+	const StateHash before = ComputeStateHash();
+	DeltaAddItem(0);
+	ExpectOnlyClassChanged(before, ComputeStateHash(), StateHashClass::Deltas);
+}
+
+TEST(StateHash, DeltaHashIgnoresSlotOrder)
+{
+	InitStateHashTest();
+	DeltaAddItem(0);
+	DeltaAddItem(1);
+	const uint64_t inOrder = ComputeDeltaHash();
+
+	delta_init();
+	DeltaAddItem(1);
+	DeltaAddItem(0);
+	EXPECT_EQ(ComputeDeltaHash(), inOrder);
+}
+
+} // namespace
+} // namespace devilution
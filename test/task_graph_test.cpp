@@ -0,0 +1,85 @@
+#include <atomic>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utils/task_graph.hpp"
+
+using namespace devilution;
+
+namespace {
+
+TEST(TaskGraphTest, RunsEveryTaskOnce)
+{
+	TaskGraph graph;
+	std::atomic<int> runs[16] {};
+	for (std::atomic<int> &count : runs)
+		graph.add("task", [&count] { ++count; });
+	graph.run(4);
+	for (const std::atomic<int> &count : runs)
+		EXPECT_EQ(count, 1);
+}
+
+TEST(TaskGraphTest, RunsDependenciesFirst)
+{
+	TaskGraph graph;
+	const TaskGraph::TaskId a = graph.add("a", [] {});
+	const TaskGraph::TaskId b = graph.add("b", [] {});
+	const TaskGraph::TaskId c = graph.add("c", [] {}, { a, b });
+	graph.add("d", [] {}, { c });
+	graph.run(4);
+
+	const auto timeline = graph.timeline();
+	ASSERT_EQ(timeline.size(), 4U);
+	EXPECT_LE(timeline[a].endUs, timeline[c].beginUs);
+	EXPECT_LE(timeline[b].endUs, timeline[c].beginUs);
+	EXPECT_LE(timeline[c].endUs, timeline[3].beginUs);
+}
+
+TEST(TaskGraphTest, RunsMainThreadTasksOnTheCallingThread)
+{
+	TaskGraph graph;
+	for (int i = 0; i < 8; ++i)
+		graph.add("main", [] {}, {}, TaskAffinity::MainThread);
+	graph.run(4);
+	for (const TaskTiming &timing : graph.timeline())
+		EXPECT_EQ(timing.thread, 0U);
+}
+
+TEST(TaskGraphTest, RunsOnASingleThread)
+{
+	TaskGraph graph;
+	std::vector<int> order;
+	const TaskGraph::TaskId first = graph.add("first", [&order] { order.push_back(1); });
+	graph.add("second", [&order] { order.push_back(2); }, { first }, TaskAffinity::MainThread);
+	graph.run(1);
+	EXPECT_EQ(order, (std::vector<int> { 1, 2 }));
+}
+
+TEST(TaskGraphTest, ParallelForCallsEachIndexOnce)
+{
+	std::atomic<int> calls[16] {};
+	ParallelFor("index", 16, [&calls](size_t i) { ++calls[i]; });
+	for (const std::atomic<int> &count : calls)
+		EXPECT_EQ(count, 1);
+
+	int single = 0;
+	ParallelFor("single", 1, [&single](size_t i) { single += static_cast<int>(i) + 1; });
+	EXPECT_EQ(single, 1);
+}
+
+TEST(TaskGraphTest, ParallelForReusesThreadsAndNests)
+{
+	for (int round = 0; round < 4; round++) {
+		std::atomic<int> calls[8][8] {};
+		ParallelFor("outer", 8, [&calls](size_t i) {
+			ParallelFor("inner", 8, [&calls, i](size_t j) { ++calls[i][j]; });
+		});
+		for (const auto &inner : calls) {
+			for (const std::atomic<int> &count : inner)
+				EXPECT_EQ(count, 1);
+		}
+	}
+}
+
+} // namespace
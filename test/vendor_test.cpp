@@ -1,3 +1,6 @@
+#include <cstdint>
+#include <vector>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -503,5 +506,70 @@ TEST_F(VendorTest, HealerGenHf)
 	}
 }
 
+TEST_F(VendorTest, TownStoresAreStockedWhenFirstNeeded)
+{
+	InitStores();
+	SetupTownStores();
+	EXPECT_TRUE(SmithItems.empty());
+	EXPECT_TRUE(PremiumItems.empty());
+
+	SetRndSeed(SEED + 1);
+	StockTownStores();
+	EXPECT_EQ(GetLCGEngineState(), SEED + 1) << "Stocking the stores must not disturb the game RNG";
+	std::vector<uint32_t> smithSeeds;
+	for (const Item &item : SmithItems)
+		smithSeeds.push_back(item._iSeed);
+	std::vector<uint32_t> premiumSeeds;
+	for (const Item &item : PremiumItems)
+		premiumSeeds.push_back(item._iSeed);
+
+	// The same items as spawning them from the RNG state of town entry, a level 1 hero who hasn't visited the dungeon gets item level 6
+	InitStores();
+	SetRndSeed(SEED);
+	SpawnSmith(6);
+	SpawnWitch(6);
+	SpawnHealer(6);
+	SpawnBoy(1);
+	SpawnPremium(*MyPlayer);
+	ASSERT_EQ(SmithItems.size(), smithSeeds.size());
+	for (size_t i = 0; i < SmithItems.size(); i++)
+		EXPECT_EQ(SmithItems[i]._iSeed, smithSeeds[i]) << "Index: " << i;
+	ASSERT_EQ(PremiumItems.size(), premiumSeeds.size());
+	for (size_t i = 0; i < PremiumItems.size(); i++)
+		EXPECT_EQ(PremiumItems[i]._iSeed, premiumSeeds[i]) << "Index: " << i;
+}
+
+TEST_F(VendorTest, PremiumItemsAreRolledForTheHeroWhenStocked)
+{
+	InitStores();
+	SetupTownStores();
+	// The hero changes between entering the town and opening a store
+	CreatePlayer(*MyPlayer, HeroClass::Sorcerer);
+	StockTownStores();
+	ASSERT_EQ(PremiumItems.size(), NumSmithItems);
+	std::vector<Item> premiumItems(PremiumItems.begin(), PremiumItems.end());
+
+	InitStores();
+	SetRndSeed(SEED);
+	SpawnSmith(6);
+	SpawnWitch(6);
+	SpawnHealer(6);
+	SpawnBoy(1);
+	SpawnPremium(*MyPlayer);
+	ASSERT_EQ(PremiumItems.size(), premiumItems.size());
+	for (size_t i = 0; i < PremiumItems.size(); i++) {
+		EXPECT_EQ(PremiumItems[i]._iSeed, premiumItems[i]._iSeed) << "Index: " << i;
+		EXPECT_EQ(PremiumItems[i].IDidx, premiumItems[i].IDidx) << "Index: " << i;
+		EXPECT_EQ(PremiumItems[i]._iCreateInfo & CF_LEVEL, premiumItems[i]._iCreateInfo & CF_LEVEL) << "Index: " << i;
+	}
+
+	// Premium items carry over to the next visit if the hero's level didn't change
+	SetupTownStores();
+	StockTownStores();
+	ASSERT_EQ(PremiumItems.size(), premiumItems.size());
+	for (size_t i = 0; i < PremiumItems.size(); i++)
+		EXPECT_EQ(PremiumItems[i]._iSeed, premiumItems[i]._iSeed) << "Index: " << i;
+}
+
 } // namespace
 } // namespace devilution
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <random>
+
 #include "vision.hpp"
 
 namespace devilution {
@@ -182,5 +184,36 @@ TEST(VisionTest, NoVisibilityThroughAdjacentTiles)
 	}
 }
 
+// This test case checks that the octants can be cast in any order and
+// still give the same result as casting the full circle at once
+TEST(VisionTest, OctantsMatchFullVision)
+{
+	std::mt19937 rng(1);
+	for (int iteration = 0; iteration < 20; iteration++) {
+		for (auto &column : env) {
+			for (char &tile : column)
+				tile = rng() % 4 == 0 ? '#' : ' ';
+		}
+
+		auto passesLightFn = [](Point p) { return env[p.x][p.y] != '#'; };
+		auto inBoundsFn = [](Point p) { return p.x >= 0 && p.y >= 0 && p.x < ENV_WIDTH && p.y < ENV_HEIGHT; };
+
+		char expected[ENV_WIDTH][ENV_HEIGHT];
+		memset(expected, 0, sizeof(expected));
+		DoVision(
+		    pos, 15, [&expected](Point p) { expected[p.x][p.y] |= 1; }, [&expected](Point p) { expected[p.x][p.y] |= 2; }, passesLightFn, inBoundsFn);
+
+		char actual[ENV_WIDTH][ENV_HEIGHT];
+		memset(actual, 0, sizeof(actual));
+		actual[pos.x][pos.y] |= 1;
+		for (int octant = NumVisionOctants - 1; octant >= 0; octant--) {
+			DoVisionOctant(
+			    pos, 15, octant, [&actual](Point p) { actual[p.x][p.y] |= 1; }, [&actual](Point p) { actual[p.x][p.y] |= 2; }, passesLightFn, inBoundsFn);
+		}
+
+		EXPECT_EQ(memcmp(expected, actual, sizeof(expected)), 0) << "Expect the same tiles to be visible in iteration " << iteration;
+	}
+}
+
 } // namespace
 } // namespace devilution
@@ -1,43 +1,129 @@
 #!/usr/bin/env python
 
 import argparse
+import json
+import os
 import re
+import shutil
 import sys
 import statistics
 import subprocess
-from typing import NamedTuple
+import tempfile
+from concurrent.futures import ThreadPoolExecutor, as_completed
+from typing import NamedTuple, Optional
 
-_TIME_AND_FPS_REGEX = re.compile(rb'\d+ frames, (\d+(?:\.\d+)?) seconds: (\d+(?:\.\d+)?) fps')
+_TIME_AND_FPS_REGEX = re.compile(rb'\d+ (?:frames|ticks), (\d+(?:\.\d+)?) seconds: (\d+(?:\.\d+)?) (?:fps|ticks/s)')
 
 class RunMetrics(NamedTuple):
 	time: float
 	fps: float
+	report: dict
 
-def measure(binary: str) -> RunMetrics:
-	result: subprocess.CompletedProcess = subprocess.run(
-		[binary, '--diablo', '--spawn', '--lang', 'en', '--demo', '0', '--timedemo'], capture_output=True)
-	match = _TIME_AND_FPS_REGEX.search(result.stderr)
-	if not match:
-		raise Exception(f"Failed to parse output in:\n{result.stderr}")
-	return RunMetrics(float(match.group(1)), float(match.group(2)))
+def measure(binary: str, fixture: Optional[str], warmup: int, headless: bool) -> RunMetrics:
+	with tempfile.TemporaryDirectory() as tmp_dir:
+		report_path = os.path.join(tmp_dir, 'timedemo.json')
+		command = [binary, '--diablo', '--spawn', '--lang', 'en', '--demo', '0', '--timedemo',
+			'--timedemo-report', report_path, '--timedemo-warmup', str(warmup)]
+		if fixture is not None:
+			# Playing a demo back writes to its save, runs in parallel each get their own copy.
+			save_dir = os.path.join(tmp_dir, 'save')
+			shutil.copytree(fixture, save_dir)
+			command += ['--save-dir', save_dir, '--config-dir', save_dir]
+		if headless:
+			command.append('--headless')
+		result: subprocess.CompletedProcess = subprocess.run(command, capture_output=True)
+		if result.returncode != 0:
+			raise Exception(f"Run failed with exit status {result.returncode}:\n{result.stderr}")
+		match = _TIME_AND_FPS_REGEX.search(result.stderr)
+		if not match or not os.path.exists(report_path):
+			raise Exception(f"Failed to parse output in:\n{result.stderr}")
+		with open(report_path) as report_file:
+			report = json.load(report_file)
+	return RunMetrics(float(match.group(1)), float(match.group(2)), report)
 
+def summarize(metrics: list) -> dict:
+	summary = {
+		'runs': len(metrics),
+		'seconds': {'mean': statistics.mean(m.time for m in metrics), 'stdev': statistics.stdev(m.time for m in metrics)},
+		'fps': {'mean': statistics.mean(m.fps for m in metrics), 'stdev': statistics.stdev(m.fps for m in metrics)},
+		'outcomes': sorted({m.report['outcome'] for m in metrics}),
+	}
+	# The median over the runs of each run's percentiles, so that a single noisy run doesn't dominate.
+	for phase in ('frameMs', 'simulationMs', 'renderMs'):
+		summary[phase] = {stat: statistics.median(m.report[phase][stat] for m in metrics) for stat in ('mean', 'p50', 'p95', 'p99', 'max')}
+	return summary
+
+def find_fixtures(suite_dir: str) -> list:
+	"""The folders in suite_dir with a demo to play back, e.g. test/fixtures/timedemo."""
+	return sorted(entry.path for entry in os.scandir(suite_dir)
+		if entry.is_dir() and os.path.exists(os.path.join(entry.path, 'demo_0.dmo')))
 
 def main():
 	parser = argparse.ArgumentParser()
 	parser.add_argument('--binary', help='Path to the devilutionx binary', required=True)
 	parser.add_argument('-n', '--num-runs', type=int, default=16, metavar='N')
+	parser.add_argument('--fixture', action='append', metavar='DIR',
+		help='Folder with demo_0.dmo and its save, e.g. test/fixtures/timedemo/WarriorLevel1to2. Can be given several times. Defaults to the save folder.')
+	parser.add_argument('--demo-suite', metavar='DIR',
+		help='Also run every fixture in this folder, e.g. test/fixtures/timedemo')
+	parser.add_argument('-j', '--jobs', type=int, default=1, metavar='N',
+		help='Number of runs to play back at the same time, 0 for one per core. Best combined with --simulation-only, '
+			'as runs that draw compete for the GPU')
+	parser.add_argument('--warmup', type=int, default=0, metavar='TICKS', help='Game ticks at the start of each run to leave out of the frame time statistics')
+	parser.add_argument('--json', metavar='PATH', help='Write the results as JSON')
+	parser.add_argument('--simulation-only', action='store_true',
+		help='Run headless, so that only the game simulation is measured and FPS are game ticks per second')
 	args = parser.parse_args()
 
 	num_runs = args.num_runs
-	metrics = []
-	for i in range(1, num_runs + 1):
-		print(f"Run {i:>2} of {num_runs}: ", end='', file=sys.stderr, flush=True)
-		run_metrics = measure(args.binary)
-		print(f"\t{run_metrics.time:>5.2f} seconds\t{run_metrics.fps:>5.1f} FPS", file=sys.stderr, flush=True)
-		metrics.append(run_metrics)
-
-	mean = RunMetrics(statistics.mean(m.time for m in metrics), statistics.mean(m.fps for m in metrics))
-	stdev = RunMetrics(statistics.stdev((m.time for m in metrics), mean.time), statistics.stdev((m.fps for m in metrics), mean.fps))
-	print(f"{mean.time:.3f} ± {stdev.time:.3f} seconds, {mean.fps:.3f} ± {stdev.fps:.3f} FPS")
+	if num_runs < 2:
+		parser.error('--num-runs must be at least 2')
+	fixtures = list(args.fixture or [])
+	if args.demo_suite:
+		fixtures += find_fixtures(args.demo_suite)
+		if not fixtures:
+			parser.error(f'--demo-suite: no folder with a demo_0.dmo in {args.demo_suite}')
+	named_fixtures = {}
+	for fixture in fixtures or [None]:
+		name = os.path.basename(os.path.normpath(fixture)) if fixture is not None else 'default'
+		named_fixtures[name] = fixture
+	jobs = args.jobs if args.jobs > 0 else os.cpu_count() or 1
+
+	# Each run is its own process, so runs of all fixtures are spread over the jobs together.
+	metrics = {name: [] for name in named_fixtures}
+	failures = {}
+	with ThreadPoolExecutor(max_workers=jobs) as executor:
+		runs = {executor.submit(measure, args.binary, fixture, args.warmup, args.simulation_only): name
+			for name, fixture in named_fixtures.items() for _ in range(num_runs)}
+		for future in as_completed(runs):
+			name = runs[future]
+			try:
+				run_metrics = future.result()
+			except Exception as e:
+				failures.setdefault(name, str(e))
+				print(f"{name}: Run failed: {e}", file=sys.stderr, flush=True)
+				continue
+			metrics[name].append(run_metrics)
+			frame = run_metrics.report['frameMs']
+			print(f"{name}: Run {len(metrics[name]):>2} of {num_runs}:\t{run_metrics.time:>5.2f} seconds\t{run_metrics.fps:>5.1f} FPS\tp99 {frame['p99']:>6.2f} ms", file=sys.stderr, flush=True)
+
+	results = {}
+	for name in named_fixtures:
+		if name in failures:
+			results[name] = {'error': failures[name]}
+			continue
+		summary = summarize(metrics[name])
+		results[name] = summary
+		frame = summary['frameMs']
+		print(f"{name}: {summary['seconds']['mean']:.3f} ± {summary['seconds']['stdev']:.3f} seconds, {summary['fps']['mean']:.3f} ± {summary['fps']['stdev']:.3f} FPS, "
+			f"frame p50 {frame['p50']:.2f} ms, p95 {frame['p95']:.2f} ms, p99 {frame['p99']:.2f} ms "
+			f"(simulation p50 {summary['simulationMs']['p50']:.2f} ms, render p50 {summary['renderMs']['p50']:.2f} ms)")
+
+	if args.json:
+		with open(args.json, 'w') as out:
+			json.dump(results, out, indent=2)
+	if failures:
+		print(f"Failed: {', '.join(sorted(failures))}", file=sys.stderr)
+		sys.exit(1)
 
 main()